@@ -19,6 +19,9 @@
 #define CONFIG_MBEDTLS_KEY_EXCHANGE_RSA 1
 #define CONFIG_UDP_RECVMBOX_SIZE 6
 #define CONFIG_FREERTOS_QUEUE_REGISTRY_SIZE 0
+#define CONFIG_FREERTOS_USE_TRACE_FACILITY 1
+#define CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS 1
+#define CONFIG_FREERTOS_RUN_TIME_STATS_USING_ESP_TIMER 1
 #define CONFIG_MBEDTLS_AES_C 1
 #define CONFIG_MBEDTLS_ECP_DP_SECP521R1_ENABLED 1
 #define CONFIG_MBEDTLS_GCM_C 1
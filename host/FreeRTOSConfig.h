@@ -0,0 +1,120 @@
+/*********************************************************************************************
+PROJECT : LoRaWAN ESP32 Gateway V1.x
+
+FILE    : FreeRTOSConfig.h
+
+AUTHOR  : F.Fargon
+
+PURPOSE : RTOS configuration for the Linux host build (FreeRTOS POSIX port 'GCC_POSIX').
+
+COMMENTS: This file is used only by the CMake host build (see CMakeLists.txt at root). The
+          ESP32 firmware uses the RTOS configuration of ESP-IDF (i.e. sdkconfig).
+          The values follow the ESP32 configuration used by the gateway:
+           - Tick rate = 'CONFIG_FREERTOS_HZ' in sdkconfig
+           - Priorities up to 14 (see 'g_TaskPlacementTable' in Configuration.h)
+           - Mutexes, counting semaphores, event groups and task notifications
+*********************************************************************************************/
+
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+#include <limits.h>
+#include <assert.h>
+
+/*********************************************************************************************
+  Scheduler
+*********************************************************************************************/
+
+#define configUSE_PREEMPTION                      1
+#define configUSE_PORT_OPTIMISED_TASK_SELECTION   0
+#define configUSE_TICKLESS_IDLE                   0
+#define configTICK_RATE_HZ                        ((TickType_t) 100)
+#define configMAX_PRIORITIES                      (16)
+#define configMINIMAL_STACK_SIZE                  ((unsigned short) PTHREAD_STACK_MIN)
+#define configMAX_TASK_NAME_LEN                   (16)
+#define configTICK_TYPE_WIDTH_IN_BITS             TICK_TYPE_WIDTH_32_BITS
+#define configIDLE_SHOULD_YIELD                   1
+#define configSTACK_DEPTH_TYPE                    uint32_t
+#define configENABLE_BACKWARD_COMPATIBILITY       1
+
+// Note: The tick counter starts 5 seconds before the 32 bits overflow (i.e. the host process and
+//       the tests run across the tick wrap, see 'test_semtech_timer_wheel')
+#define configINITIAL_TICK_COUNT                  ((TickType_t) (0 - (5 * configTICK_RATE_HZ)))
+
+// Note: The POSIX port runs one RTOS task at a time (i.e. single core)
+#define configNUMBER_OF_CORES                     1
+
+
+/*********************************************************************************************
+  Synchronization objects
+*********************************************************************************************/
+
+#define configUSE_MUTEXES                         1
+#define configUSE_RECURSIVE_MUTEXES               1
+#define configUSE_COUNTING_SEMAPHORES             1
+#define configUSE_TASK_NOTIFICATIONS              1
+#define configQUEUE_REGISTRY_SIZE                 20
+#define configUSE_QUEUE_SETS                      0
+
+
+/*********************************************************************************************
+  Memory allocation
+  Note: The host build uses 'heap_3' (i.e. 'malloc' and 'free' of the process)
+*********************************************************************************************/
+
+#define configSUPPORT_DYNAMIC_ALLOCATION          1
+#define configSUPPORT_STATIC_ALLOCATION           0
+#define configTOTAL_HEAP_SIZE                     ((size_t) (4 * 1024 * 1024))
+#define configAPPLICATION_ALLOCATED_HEAP          0
+
+
+/*********************************************************************************************
+  Hooks, trace and run time stats
+  Note: The POSIX port provides the run time counter (i.e. 'portGET_RUN_TIME_COUNTER_VALUE')
+*********************************************************************************************/
+
+#define configUSE_IDLE_HOOK                       0
+#define configUSE_TICK_HOOK                       0
+#define configUSE_MALLOC_FAILED_HOOK              0
+#define configCHECK_FOR_STACK_OVERFLOW            0
+#define configUSE_TRACE_FACILITY                  1
+#define configGENERATE_RUN_TIME_STATS             1
+#define configUSE_STATS_FORMATTING_FUNCTIONS      0
+
+
+/*********************************************************************************************
+  Software timers
+*********************************************************************************************/
+
+#define configUSE_TIMERS                          1
+#define configTIMER_TASK_PRIORITY                 (configMAX_PRIORITIES - 1)
+#define configTIMER_QUEUE_LENGTH                  20
+#define configTIMER_TASK_STACK_DEPTH              (configMINIMAL_STACK_SIZE * 2)
+
+
+/*********************************************************************************************
+  Optional functions
+*********************************************************************************************/
+
+#define INCLUDE_vTaskPrioritySet                  1
+#define INCLUDE_uxTaskPriorityGet                 1
+#define INCLUDE_vTaskDelete                       1
+#define INCLUDE_vTaskSuspend                      1
+#define INCLUDE_vTaskDelayUntil                   1
+#define INCLUDE_xTaskDelayUntil                   1
+#define INCLUDE_vTaskDelay                        1
+#define INCLUDE_xTaskGetSchedulerState            1
+#define INCLUDE_xTaskGetCurrentTaskHandle         1
+#define INCLUDE_xTaskGetIdleTaskHandle            1
+#define INCLUDE_uxTaskGetStackHighWaterMark       1
+#define INCLUDE_eTaskGetState                     1
+#define INCLUDE_xTimerPendFunctionCall            1
+
+
+/*********************************************************************************************
+  Assertions
+*********************************************************************************************/
+
+#define configASSERT(x)                           assert(x)
+
+#endif
@@ -0,0 +1,225 @@
+/*****************************************************************************************//**
+ * @file     HostDrivers.c
+ *
+ * @author   F.Fargon
+ *
+ * @version  V1.0
+ *
+ * @date     16/10/2026
+ *
+ * @brief    ESP-IDF drivers for the Linux host build.
+ *
+ * @details  This file implements the subset of the ESP-IDF 'gpio' and 'spi_master' drivers
+ *           used by the 'CSX1276' object:\n
+ *            - The GPIO pins are simulated (i.e. ISR handlers called on simulated IRQ edge
+ *              with 'HostGpio_RaiseInterrupt')
+ *            - There is no SPI bus (i.e. a 'CSX1276' object must use the mock SPI backend of
+ *              'CSX1276MockSpi')
+*********************************************************************************************/
+
+#include <stdbool.h>
+#include <pthread.h>
+
+#include "driver/gpio.h"
+#include "driver/spi_master.h"
+
+
+/*********************************************************************************************
+  GPIO driver
+*********************************************************************************************/
+
+// Simulated pins
+typedef struct _CHostGpioPin
+{
+  gpio_isr_t m_pIsrHandler;
+  void *m_pIsrArgs;
+  bool m_bIntrEnabled;
+
+} CHostGpioPinOb;
+
+static CHostGpioPinOb g_HostGpioPins[GPIO_PIN_COUNT];
+static bool g_bHostGpioIsrService = false;
+static pthread_mutex_t g_hHostGpioMutex = PTHREAD_MUTEX_INITIALIZER;
+
+
+esp_err_t gpio_set_direction(gpio_num_t nPin, gpio_mode_t nMode)
+{
+  return ((nPin >= 0) && (nPin < GPIO_PIN_COUNT)) ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+
+esp_err_t gpio_set_pull_mode(gpio_num_t nPin, gpio_pull_mode_t nPull)
+{
+  return ((nPin >= 0) && (nPin < GPIO_PIN_COUNT)) ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+
+esp_err_t gpio_set_intr_type(gpio_num_t nPin, gpio_int_type_t nIntrType)
+{
+  return ((nPin >= 0) && (nPin < GPIO_PIN_COUNT)) ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+
+esp_err_t gpio_intr_enable(gpio_num_t nPin)
+{
+  if ((nPin < 0) || (nPin >= GPIO_PIN_COUNT))
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  pthread_mutex_lock(&g_hHostGpioMutex);
+  g_HostGpioPins[nPin].m_bIntrEnabled = true;
+  pthread_mutex_unlock(&g_hHostGpioMutex);
+  return ESP_OK;
+}
+
+
+esp_err_t gpio_intr_disable(gpio_num_t nPin)
+{
+  if ((nPin < 0) || (nPin >= GPIO_PIN_COUNT))
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  pthread_mutex_lock(&g_hHostGpioMutex);
+  g_HostGpioPins[nPin].m_bIntrEnabled = false;
+  pthread_mutex_unlock(&g_hHostGpioMutex);
+  return ESP_OK;
+}
+
+
+esp_err_t gpio_install_isr_service(int nIntrAllocFlags)
+{
+  esp_err_t nResult;
+
+  pthread_mutex_lock(&g_hHostGpioMutex);
+  nResult = g_bHostGpioIsrService ? ESP_ERR_INVALID_STATE : ESP_OK;
+  g_bHostGpioIsrService = true;
+  pthread_mutex_unlock(&g_hHostGpioMutex);
+  return nResult;
+}
+
+
+void gpio_uninstall_isr_service(void)
+{
+  pthread_mutex_lock(&g_hHostGpioMutex);
+  g_bHostGpioIsrService = false;
+  pthread_mutex_unlock(&g_hHostGpioMutex);
+}
+
+
+esp_err_t gpio_isr_handler_add(gpio_num_t nPin, gpio_isr_t pIsrHandler, void *pArgs)
+{
+  if ((nPin < 0) || (nPin >= GPIO_PIN_COUNT))
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (!g_bHostGpioIsrService)
+  {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  pthread_mutex_lock(&g_hHostGpioMutex);
+  g_HostGpioPins[nPin].m_pIsrHandler = pIsrHandler;
+  g_HostGpioPins[nPin].m_pIsrArgs = pArgs;
+  pthread_mutex_unlock(&g_hHostGpioMutex);
+  return ESP_OK;
+}
+
+
+esp_err_t gpio_isr_handler_remove(gpio_num_t nPin)
+{
+  if ((nPin < 0) || (nPin >= GPIO_PIN_COUNT))
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  pthread_mutex_lock(&g_hHostGpioMutex);
+  g_HostGpioPins[nPin].m_pIsrHandler = NULL;
+  g_HostGpioPins[nPin].m_pIsrArgs = NULL;
+  pthread_mutex_unlock(&g_hHostGpioMutex);
+  return ESP_OK;
+}
+
+
+/*****************************************************************************************//**
+ * @fn         void HostGpio_RaiseInterrupt(gpio_num_t nPin)
+ *
+ * @brief      Simulates an IRQ edge on a pin.
+ *
+ * @details    The ISR handler of the pin is called in the context of the caller (i.e. only if
+ *             the interrupt of the pin is enabled).
+ *
+ * @param      nPin
+ *             The GPIO pin.
+*********************************************************************************************/
+void HostGpio_RaiseInterrupt(gpio_num_t nPin)
+{
+  gpio_isr_t pIsrHandler = NULL;
+  void *pIsrArgs = NULL;
+
+  if ((nPin < 0) || (nPin >= GPIO_PIN_COUNT))
+  {
+    return;
+  }
+
+  pthread_mutex_lock(&g_hHostGpioMutex);
+  if (g_HostGpioPins[nPin].m_bIntrEnabled)
+  {
+    pIsrHandler = g_HostGpioPins[nPin].m_pIsrHandler;
+    pIsrArgs = g_HostGpioPins[nPin].m_pIsrArgs;
+  }
+  pthread_mutex_unlock(&g_hHostGpioMutex);
+
+  if (pIsrHandler != NULL)
+  {
+    pIsrHandler(pIsrArgs);
+  }
+}
+
+
+/*********************************************************************************************
+  SPI master driver (no SPI bus on host)
+*********************************************************************************************/
+
+esp_err_t spi_bus_initialize(spi_host_device_t nHost, const spi_bus_config_t *pBusConfig, int nDmaChannel)
+{
+  return ESP_ERR_NOT_FOUND;
+}
+
+
+esp_err_t spi_bus_free(spi_host_device_t nHost)
+{
+  return ESP_ERR_INVALID_STATE;
+}
+
+
+esp_err_t spi_bus_add_device(spi_host_device_t nHost, const spi_device_interface_config_t *pDevConfig, spi_device_handle_t *pHandle)
+{
+  return ESP_ERR_INVALID_STATE;
+}
+
+
+esp_err_t spi_bus_remove_device(spi_device_handle_t hDevice)
+{
+  return ESP_ERR_INVALID_STATE;
+}
+
+
+esp_err_t spi_device_transmit(spi_device_handle_t hDevice, spi_transaction_t *pTrans)
+{
+  return ESP_ERR_INVALID_STATE;
+}
+
+
+esp_err_t spi_device_queue_trans(spi_device_handle_t hDevice, spi_transaction_t *pTrans, uint32_t dwTicksToWait)
+{
+  return ESP_ERR_INVALID_STATE;
+}
+
+
+esp_err_t spi_device_get_trans_result(spi_device_handle_t hDevice, spi_transaction_t **ppTrans, uint32_t dwTicksToWait)
+{
+  return ESP_ERR_INVALID_STATE;
+}
@@ -0,0 +1,76 @@
+/*********************************************************************************************
+PROJECT : LoRaWAN ESP32 Gateway V1.x
+
+FILE    : driver/gpio.h
+
+AUTHOR  : F.Fargon
+
+PURPOSE : ESP-IDF GPIO driver for the Linux host build (subset used by 'CSX1276').
+
+COMMENTS: The pins are simulated (see HostDrivers.c):
+           - The ISR handler added on a pin is called by 'HostGpio_RaiseInterrupt' when the
+             interrupt of the pin is enabled (i.e. simulated IRQ edge, e.g. on 'DIO0' of a
+             mock SX1276)
+           - Other functions only check the pin number
+*********************************************************************************************/
+
+#ifndef DRIVER_GPIO_H_
+#define DRIVER_GPIO_H_
+
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "esp_attr.h"
+#include "esp_intr_alloc.h"
+
+#define GPIO_PIN_COUNT            40
+
+typedef int gpio_num_t;
+
+typedef enum
+{
+  GPIO_MODE_DISABLE = 0,
+  GPIO_MODE_INPUT = 1,
+  GPIO_MODE_OUTPUT = 2,
+  GPIO_MODE_INPUT_OUTPUT = 3
+
+} gpio_mode_t;
+
+typedef enum
+{
+  GPIO_PULLUP_ONLY = 0,
+  GPIO_PULLDOWN_ONLY = 1,
+  GPIO_PULLUP_PULLDOWN = 2,
+  GPIO_FLOATING = 3
+
+} gpio_pull_mode_t;
+
+#define GPIO_PULLDOWN_ENABLE      GPIO_PULLDOWN_ONLY
+
+typedef enum
+{
+  GPIO_INTR_DISABLE = 0,
+  GPIO_INTR_POSEDGE = 1,
+  GPIO_INTR_NEGEDGE = 2,
+  GPIO_INTR_ANYEDGE = 3
+
+} gpio_int_type_t;
+
+typedef void (*gpio_isr_t)(void *pArg);
+
+
+esp_err_t gpio_set_direction(gpio_num_t nPin, gpio_mode_t nMode);
+esp_err_t gpio_set_pull_mode(gpio_num_t nPin, gpio_pull_mode_t nPull);
+esp_err_t gpio_set_intr_type(gpio_num_t nPin, gpio_int_type_t nIntrType);
+esp_err_t gpio_intr_enable(gpio_num_t nPin);
+esp_err_t gpio_intr_disable(gpio_num_t nPin);
+
+esp_err_t gpio_install_isr_service(int nIntrAllocFlags);
+void gpio_uninstall_isr_service(void);
+esp_err_t gpio_isr_handler_add(gpio_num_t nPin, gpio_isr_t pIsrHandler, void *pArgs);
+esp_err_t gpio_isr_handler_remove(gpio_num_t nPin);
+
+// Linux host only: simulated IRQ edge
+void HostGpio_RaiseInterrupt(gpio_num_t nPin);
+
+#endif
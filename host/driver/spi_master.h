@@ -0,0 +1,101 @@
+/*********************************************************************************************
+PROJECT : LoRaWAN ESP32 Gateway V1.x
+
+FILE    : driver/spi_master.h
+
+AUTHOR  : F.Fargon
+
+PURPOSE : ESP-IDF SPI master driver for the Linux host build (subset used by 'CSX1276').
+
+COMMENTS: There is no SPI bus on host (see HostDrivers.c). The device functions fail and the
+          'CSX1276' objects must use another SPI backend (i.e. 'g_SX1276MockSpiBackendOb' set
+          with 'CSX1276_SetSpiBackend').
+*********************************************************************************************/
+
+#ifndef DRIVER_SPI_MASTER_H_
+#define DRIVER_SPI_MASTER_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "esp_err.h"
+#include "driver/gpio.h"
+
+typedef enum
+{
+  SPI_HOST = 0,
+  HSPI_HOST = 1,
+  VSPI_HOST = 2
+
+} spi_host_device_t;
+
+#define SPI_TRANS_USE_RXDATA      (1 << 2)
+#define SPI_TRANS_USE_TXDATA      (1 << 3)
+
+typedef struct spi_transaction_t
+{
+  uint32_t flags;
+  uint16_t cmd;
+  uint64_t addr;
+  size_t length;
+  size_t rxlength;
+  void *user;
+  union
+  {
+    const void *tx_buffer;
+    uint8_t tx_data[4];
+  };
+  union
+  {
+    void *rx_buffer;
+    uint8_t rx_data[4];
+  };
+
+} spi_transaction_t;
+
+typedef struct spi_device_t * spi_device_handle_t;
+
+typedef void (*transaction_cb_t)(spi_transaction_t *pTrans);
+
+typedef struct
+{
+  int mosi_io_num;
+  int miso_io_num;
+  int sclk_io_num;
+  int quadwp_io_num;
+  int quadhd_io_num;
+  int max_transfer_sz;
+  uint32_t flags;
+
+} spi_bus_config_t;
+
+typedef struct
+{
+  uint8_t command_bits;
+  uint8_t address_bits;
+  uint8_t dummy_bits;
+  uint8_t mode;
+  uint8_t duty_cycle_pos;
+  uint8_t cs_ena_pretrans;
+  uint8_t cs_ena_posttrans;
+  int clock_speed_hz;
+  int input_delay_ns;
+  int spics_io_num;
+  uint32_t flags;
+  int queue_size;
+  transaction_cb_t pre_cb;
+  transaction_cb_t post_cb;
+
+} spi_device_interface_config_t;
+
+
+esp_err_t spi_bus_initialize(spi_host_device_t nHost, const spi_bus_config_t *pBusConfig, int nDmaChannel);
+esp_err_t spi_bus_free(spi_host_device_t nHost);
+esp_err_t spi_bus_add_device(spi_host_device_t nHost, const spi_device_interface_config_t *pDevConfig, spi_device_handle_t *pHandle);
+esp_err_t spi_bus_remove_device(spi_device_handle_t hDevice);
+
+esp_err_t spi_device_transmit(spi_device_handle_t hDevice, spi_transaction_t *pTrans);
+esp_err_t spi_device_queue_trans(spi_device_handle_t hDevice, spi_transaction_t *pTrans, uint32_t dwTicksToWait);
+esp_err_t spi_device_get_trans_result(spi_device_handle_t hDevice, spi_transaction_t **ppTrans, uint32_t dwTicksToWait);
+
+#endif
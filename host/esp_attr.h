@@ -0,0 +1,17 @@
+/*********************************************************************************************
+PROJECT : LoRaWAN ESP32 Gateway V1.x
+
+FILE    : esp_attr.h
+
+AUTHOR  : F.Fargon
+
+PURPOSE : ESP-IDF placement attributes for the Linux host build (no effect on host).
+*********************************************************************************************/
+
+#ifndef ESP_ATTR_H_
+#define ESP_ATTR_H_
+
+#define IRAM_ATTR
+#define DRAM_ATTR
+
+#endif
@@ -0,0 +1,27 @@
+/*********************************************************************************************
+PROJECT : LoRaWAN ESP32 Gateway V1.x
+
+FILE    : esp_err.h
+
+AUTHOR  : F.Fargon
+
+PURPOSE : ESP-IDF error codes for the Linux host build (subset used by the gateway).
+*********************************************************************************************/
+
+#ifndef ESP_ERR_H_
+#define ESP_ERR_H_
+
+#include <stdint.h>
+
+typedef int32_t esp_err_t;
+
+#define ESP_OK                    0
+#define ESP_FAIL                  -1
+
+#define ESP_ERR_NO_MEM            0x101
+#define ESP_ERR_INVALID_ARG       0x102
+#define ESP_ERR_INVALID_STATE     0x103
+#define ESP_ERR_NOT_FOUND         0x105
+#define ESP_ERR_TIMEOUT           0x107
+
+#endif
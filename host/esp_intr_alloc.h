@@ -0,0 +1,18 @@
+/*********************************************************************************************
+PROJECT : LoRaWAN ESP32 Gateway V1.x
+
+FILE    : esp_intr_alloc.h
+
+AUTHOR  : F.Fargon
+
+PURPOSE : ESP-IDF interrupt allocation for the Linux host build (subset used by 'CSX1276').
+*********************************************************************************************/
+
+#ifndef ESP_INTR_ALLOC_H_
+#define ESP_INTR_ALLOC_H_
+
+#define ESP_INTR_FLAG_IRAM        (1 << 10)
+
+typedef void * intr_handle_t;
+
+#endif
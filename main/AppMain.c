@@ -29,10 +29,17 @@ COMMENTS : This program is designed for execution on ESP32 Module (Dev.C kit).
 *********************************************************************************************/
 
 #include "Version.h"
-#include "esp_spi_flash.h"
+#ifdef ESP_PLATFORM
+  #include "esp_spi_flash.h"
+#else
+  #include "LoraNodeSwarmItf.h"
+#endif
 //#include "SX1276Itf.h"
 #include "LoraNodeManagerItf.h"
 #include "LoraServerManagerItf.h"
+#include "TaskPlacement.h"
+#include "TraceRing.h"
+#include "Configuration.h"
 
 /****************************************************************************** 
   Forward declaration
@@ -62,8 +69,9 @@ TaskHandle_t g_PacketForwarderTask = NULL;
 // This task simulates the PacketForwarder task receiving uplink packets
 void test_task(void *pvParameter)
 {
-  CServerManagerItf_LoraSessionPacket pLoraSessionPacket;
-  CTransceiverManagerItf_SessionEventOb SessionEvent;
+  DWORD dwNotifiedValue;
+//CServerManagerItf_LoraSessionPacket pLoraSessionPacket;
+//CTransceiverManagerItf_SessionEventOb SessionEvent;
 
 
 
@@ -103,7 +111,7 @@ void test_task(void *pvParameter)
   while(1) 
   {
     // Wait for notification from LoraNodeManager (packet received)
-    if (xTaskNotifyWait(0, 0xFFFFFFFF, &pLoraSessionPacket, pdMS_TO_TICKS(100)) == pdTRUE)
+    if (xTaskNotifyWait(0, 0xFFFFFFFF, &dwNotifiedValue, pdMS_TO_TICKS(100)) == pdTRUE)
     {
       printf("Test Task : Packet received\n");
 
@@ -122,6 +130,7 @@ void test_task(void *pvParameter)
   // Set continuous receive mode and wait for packets
   CLoraTransceiverItf_ReceiveParamsOb ReceiveParams;
   ReceiveParams.m_bForce = false;
+  ReceiveParams.m_pScanParams = NULL;
   ILoraTransceiver_Receive(g_pLoraTransceiverItf, &ReceiveParams);
 
   // Back to standby
@@ -143,7 +152,7 @@ void test_task(void *pvParameter)
         printf("Test Task : Packet received, length: %d\n", ((CLoraTransceiverItf_LoraPacket) (g_Event.m_pEventData))->m_dwDataSize);
 
         pPacketToSend = pvPortMalloc(sizeof(CLoraTransceiverItf_LoraPacketOb) + ((CLoraTransceiverItf_LoraPacket) (g_Event.m_pEventData))->m_dwDataSize);
-        pPacketToSend->m_dwTimestamp = 0;
+        pPacketToSend->m_qwTimestamp = 0;
         pPacketToSend->m_dwDataSize = ((CLoraTransceiverItf_LoraPacket) (g_Event.m_pEventData))->m_dwDataSize;
         for (int i = 0; i < pPacketToSend->m_dwDataSize; i++)
         {
@@ -229,6 +238,7 @@ void app_main()
   printf("LoRaWAN Gateway version:%s\n", g_szVersionString);
 
   /* Print chip information */
+#ifdef ESP_PLATFORM
   esp_chip_info_t chip_info;
   esp_chip_info(&chip_info);
   printf("This is ESP32 chip with %d CPU cores, WiFi%s%s, ",
@@ -240,6 +250,9 @@ void app_main()
 
   printf("%dMB %s flash\n", spi_flash_get_chip_size() / (1024 * 1024),
           (chip_info.features & CHIP_FEATURE_EMB_FLASH) ? "embedded" : "external");
+#else
+  printf("Running on Linux host (FreeRTOS POSIX port)\n");
+#endif
 
 
 
@@ -251,7 +264,7 @@ void app_main()
 
   printf("Calling CLoraNodeManager_CreateInstance\n");
 
-  g_pTransceiverManagerItf = CLoraNodeManager_CreateInstance(1);
+  g_pTransceiverManagerItf = CLoraNodeManager_CreateInstance(CONFIG_LORA_TRANSCEIVER_NUMBER);
 
   printf("Return from CLoraNodeManager_CreateInstance\n");
 
@@ -341,6 +354,9 @@ void app_main()
   CLoraTransceiverItf_InitializeParamsOb InitializeParams;
 
   InitializeParams.m_hEventNotifyQueue = g_hEventQueue;
+  InitializeParams.m_pLoraPacketPool = NULL;
+  InitializeParams.m_pReceiveRing = NULL;
+  InitializeParams.m_usSpiSlaveID = 0;
   InitializeParams.pLoraMAC = NULL;
   InitializeParams.pLoraMode = NULL;
   InitializeParams.pPowerMode = NULL;
@@ -381,4 +397,48 @@ void app_main()
   // Start task to process events
   xTaskCreate(&test_task, "test_task", 3072, NULL, 5, &g_PacketForwarderTask);
 
+  // Start the trace of core utilisation and task latency
+  #if (CONFIG_TASK_MONITOR_PERIOD > 0)
+    CTaskPlacement_StartMonitor(CONFIG_TASK_MONITOR_PERIOD);
+  #endif
+
+  // Start the rendering of binary trace records
+  #if (TRACERING_ENABLE)
+    CTraceRing_StartDrain();
+  #endif
+
+}
+
+
+#ifndef ESP_PLATFORM
+
+/*********************************************************************************************
+FUNCTION  : int main(void)
+
+ARGUMENTS : None.
+
+RETURN    : Never returns (RTOS scheduler).
+
+PURPOSE   : Linux host entry point (FreeRTOS POSIX port). 
+            The function creates a task executing 'app_main' (i.e. same as ESP-IDF main task)
+            and starts the RTOS scheduler.
+ 
+COMMENTS  : The 'LoraTransceiver' objects are simulated swarms of LoRaWAN devices (i.e. 
+            'CLoraNodeSwarm' factory set before 'app_main' is executed, see 
+            'g_LoraNodeSwarmConfig' in Configuration.h). 
+*********************************************************************************************/
+static void app_main_task(void *pvParameter)
+{
+  app_main();
+  vTaskDelete(NULL);
 }
+
+int main(void)
+{
+  CLoraNodeManager_SetTransceiverFactory(CLoraNodeSwarm_CreateInstance);
+  xTaskCreate(app_main_task, "app_main", 8192, NULL, 1, NULL);
+  vTaskStartScheduler();
+  return 0;
+}
+
+#endif
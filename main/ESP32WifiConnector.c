@@ -45,6 +45,7 @@
 #include "ServerManagerItf.h"
 #include "ServerConnectorItf.h"
 #include "ESP32WifiConnectorItf.h"
+#include "TaskPlacement.h"
 
 // Object's definitions and methods
 #include "ESP32WifiConnector.h"
@@ -637,9 +638,10 @@ CESP32WifiConnector * CESP32WifiConnector_New()
     this->m_dwConnectionState = ESP32WIFICONNECTOR_CONNECTION_STATE_DISCONNECTED;
 
     // Embedded objects are not defined (i.e. created below)
-    this->m_pServerMessageArray = this->m_hCommandMutex = this->m_hCommandDone = this->m_hWifiConnectorTask = 
-      this->m_hWifiConnectorQueue = this->m_hWifiEventGroup = this->m_hConnectionStateMutex = 
-      this->m_hReceiveTask = NULL;
+    this->m_pServerMessageArray = NULL;
+    this->m_hCommandMutex = this->m_hCommandDone = this->m_hWifiConnectorQueue = this->m_hConnectionStateMutex = NULL;
+    this->m_hWifiConnectorTask = this->m_hReceiveTask = NULL;
+    this->m_hWifiEventGroup = NULL;
 
 
     #if (ESP32WIFICONNECTOR_DEBUG_LEVEL2)
@@ -658,8 +660,8 @@ CESP32WifiConnector * CESP32WifiConnector_New()
     #endif
 
     // Create WifiConnector automaton task
-    if (xTaskCreate((TaskFunction_t) CESP32WifiConnector_WifiConnectorAutomaton, "CESP32WifiConnector_WifiConnectorAutomaton", 
-        2048, this, 5, &(this->m_hWifiConnectorTask)) == pdFAIL)
+    if (CTaskPlacement_CreateTask(TASKPLACEMENT_TASK_WIFICONNECTOR_MAIN, (TaskFunction_t) CESP32WifiConnector_WifiConnectorAutomaton, 
+        this, &(this->m_hWifiConnectorTask)) == false)
     {
       CESP32WifiConnector_Delete(this);
       return NULL;
@@ -723,8 +725,8 @@ CESP32WifiConnector * CESP32WifiConnector_New()
     #endif
     
     // Create the task used to receive downlink messages
-    if (xTaskCreate((TaskFunction_t) CESP32WifiConnector_ReceiveAutomaton, "CESP32WifiConnector_ReceiveAutomaton", 
-        2048, this, 5, &(this->m_hReceiveTask)) == pdFAIL)
+    if (CTaskPlacement_CreateTask(TASKPLACEMENT_TASK_WIFICONNECTOR_RECEIVE, (TaskFunction_t) CESP32WifiConnector_ReceiveAutomaton, 
+        this, &(this->m_hReceiveTask)) == false)
     {
       CESP32WifiConnector_Delete(this);
       return NULL;
@@ -946,7 +948,7 @@ bool CESP32WifiConnector_ProcessInitialize(CESP32WifiConnector *this, CESP32Wifi
   // DEBUG
   #if (ESP32WIFICONNECTOR_DEBUG_LEVEL0)
     DEBUG_PRINT("[INFO] 'CESP32WifiConnector_ProcessInitialize' - Event group before config copy:");
-    DEBUG_PRINT_HEX(this->m_hWifiEventGroup);
+    DEBUG_PRINT_PTR(this->m_hWifiEventGroup);
     DEBUG_PRINT_CR;
   #endif
 
@@ -959,12 +961,13 @@ bool CESP32WifiConnector_ProcessInitialize(CESP32WifiConnector *this, CESP32Wifi
   // DEBUG
   #if (ESP32WIFICONNECTOR_DEBUG_LEVEL0)
     DEBUG_PRINT("[INFO] 'CESP32WifiConnector_ProcessInitialize' - Event group after config copy:");
-    DEBUG_PRINT_HEX(this->m_hWifiEventGroup);
+    DEBUG_PRINT_PTR(this->m_hWifiEventGroup);
     DEBUG_PRINT_CR;
   #endif
 
   // Step 2: Initialize ESP-IDF Wifi module for 'Station' mode
   //
+  #ifdef ESP_PLATFORM
   nvs_flash_init();            // Required for Wifi firmware
 
   // Gateway MAC Address is explicitly set (i.e. checked in UDP packet by Network Server) 
@@ -990,6 +993,7 @@ bool CESP32WifiConnector_ProcessInitialize(CESP32WifiConnector *this, CESP32Wifi
     this->m_dwCurrentState = ESP32WIFICONNECTOR_AUTOMATON_STATE_TERMINATED;
     return false;
   }
+  #endif
 
   // Step 3: Connect the Wifi station to network
   //
@@ -1269,7 +1273,7 @@ bool CESP32WifiConnector_ProcessSend(CESP32WifiConnector *this, CESP32WifiConnec
   pServerMessageEvent->m_wEventType = bResult == true ? SERVERMANAGER_MESSAGEEVENT_UPLINK_SENT: 
                                                         SERVERMANAGER_MESSAGEEVENT_UPLINK_SEND_FAILED;
   pServerMessageEvent->m_pMessage = ((CServerConnectorItf_SendParams) pParams)->m_pMessage;
-  pServerMessageEvent->m_dwParam = NULL;
+  pServerMessageEvent->m_dwParam = 0;
 //ServerMessageEvent.m_dwMessageId = ((CServerConnectorItf_SendParams) pParams)->m_dwMessageId;
 
   #if (ESP32WIFICONNECTOR_DEBUG_LEVEL0)
@@ -1477,6 +1481,8 @@ bool CESP32WifiConnector_ProcessDownlinkReceived(CESP32WifiConnector *this, CESP
   Event handler for ESP Wifi (static method)
 *********************************************************************************************/
 
+#ifdef ESP_PLATFORM
+
 static esp_err_t CESP32WifiConnector_WifiEventHandler(void *this, system_event_t *pEvent)
 {
   switch(pEvent->event_id)
@@ -1522,6 +1528,8 @@ static esp_err_t CESP32WifiConnector_WifiEventHandler(void *this, system_event_t
   return ESP_OK;
 }
 
+#endif
+
 bool CESP32WifiConnector_UpdateConnectionState(CESP32WifiConnector *this, DWORD dwConnectionEvent)
 {
   #if (ESP32WIFICONNECTOR_DEBUG_LEVEL0)
@@ -1582,6 +1590,14 @@ bool CESP32WifiConnector_JoinWifi(CESP32WifiConnector *this, bool bReconnect)
     DEBUG_PRINT_LN("[INFO] Entering 'CESP32WifiConnector_JoinWifi'");
   #endif
 
+  #ifndef ESP_PLATFORM
+    // Linux host: the network interface is managed by the host (i.e. always connected)
+    CESP32WifiConnector_UpdateConnectionState(this, ESP32WIFICONNECTOR_CONNECTION_EVENT_WIFI_CONNECTED);
+    xEventGroupClearBits(this->m_hWifiEventGroup, WIFI_EVENT_GROUP_DISCONNECTED_BIT);
+    xEventGroupSetBits(this->m_hWifiEventGroup, WIFI_EVENT_GROUP_CONNECTED_BIT);
+    return true;
+  #else
+
   // The caller can ask for reconnection to Wifi network
   if (bReconnect == true)
   {
@@ -1653,6 +1669,7 @@ bool CESP32WifiConnector_JoinWifi(CESP32WifiConnector *this, bool bReconnect)
     DEBUG_PRINT_LN("[INFO] 'CESP32WifiConnector_JoinWifi' - Station connected to Wifi");
   #endif
   return true;
+  #endif
 }
 
 
@@ -1731,7 +1748,7 @@ bool CESP32WifiConnector_BindNetworkServer(CESP32WifiConnector *this)
 
   this->m_ServerSockAddr.sin_family = AF_INET;
   this->m_ServerSockAddr.sin_port = htons(this->m_dwNetworkServerPort);
-  this->m_ServerSockAddr.sin_addr.s_addr = ipaddr_addr(this->m_szNetworkServerIP);
+  this->m_ServerSockAddr.sin_addr.s_addr = inet_addr(this->m_szNetworkServerIP);
 
   #if (ESP32WIFICONNECTOR_DEBUG_LEVEL0)
     DEBUG_PRINT("[INFO] 'CESP32WifiConnector_BindNetworkServer' - Server network address is ");
@@ -1759,6 +1776,11 @@ bool CESP32WifiConnector_ConnectSNTPServer(CESP32WifiConnector *this, char *pSNT
     DEBUG_PRINT_LN("[INFO] Entering 'CESP32WifiConnector_ConnectSNTPServer'");
   #endif
 
+  #ifndef ESP_PLATFORM
+    // Linux host: the system time is synchronized by the host
+    return true;
+  #else
+
   // Initialize SNTP utility
   sntp_setoperatingmode(SNTP_OPMODE_POLL);
   sntp_setservername(0, pSNTPServerUrl);
@@ -1790,5 +1812,6 @@ bool CESP32WifiConnector_ConnectSNTPServer(CESP32WifiConnector *this, char *pSNT
   #endif
 
   return nRetryCount < 10 ? true : false;
+  #endif
 }
 
@@ -0,0 +1,337 @@
+/*****************************************************************************************//**
+ * @file     LoraDutyCycle.c
+ *
+ * @author   F.Fargon
+ *
+ * @version  V1.0
+ *
+ * @date     16/10/2026
+ *
+ * @brief    Time-on-air and duty-cycle accounting for downlink transmissions.
+ *
+ * @details  This file implements the following classes or functions:\n
+ *            - CLoraDutyCycle = Sliding window ledger of transmission time for each EU868
+ *              sub-band
+ *            - Time-on-air of LoRa packets and sub-band of frequency channels
+*********************************************************************************************/
+
+
+/*********************************************************************************************
+  Espressif framework includes
+*********************************************************************************************/
+
+#include <Common.h>
+
+
+/*********************************************************************************************
+  Includes for objects implementation
+*********************************************************************************************/
+
+#include "LoraTransceiverItf.h"
+#include "LoraDutyCycle.h"
+
+
+/*********************************************************************************************
+ LoraDutyCycle Class
+
+ Duty-cycle ledger of a gateway
+
+ Notes:
+  - The object is not thread safe (used only by 'ScheduleSendNodePacket' of 'LoraRealtimeSender')
+  - See LoraDutyCycle.h for description of sliding window
+
+ WARNING: This object cannot be static. It MUST always be allocated by with the construction
+          method ('CLoraDutyCycle_New')
+*********************************************************************************************/
+
+// Transmission time allowed for each sub-band (microseconds)
+static const DWORD g_dwLoraDutyCycleBudgets[LORADUTYCYCLE_SUBBAND_NUMBER] = LORADUTYCYCLE_SUBBAND_BUDGETS;
+
+// Symbol time for SF6 and each bandwidth (i.e. 'LORATRANSCEIVERITF_BANDWIDTH_xxx' index, microseconds)
+// Note: The symbol time is doubled for each SF step
+static const DWORD g_dwLoraDutyCycleSymbolTimeSF6[LORATRANSCEIVERITF_BANDWIDTH_500 + 1] =
+  { 8192, 6144, 4096, 3072, 2048, 1536, 1024, 512, 256, 128 };
+
+// Private helpers
+static void CLoraDutyCycle_Advance(CLoraDutyCycleSubBand pSubBand, QWORD qwBucket);
+
+
+CLoraDutyCycle CLoraDutyCycle_New()
+{
+  CLoraDutyCycle this;
+
+  if ((this = (void *) pvPortMalloc(sizeof(CLoraDutyCycleOb))) != NULL)
+  {
+    memset(this, 0, sizeof(CLoraDutyCycleOb));
+    for (BYTE i = 0; i < LORADUTYCYCLE_SUBBAND_NUMBER; i++)
+    {
+      this->m_SubBands[i].m_dwBudget = g_dwLoraDutyCycleBudgets[i];
+    }
+  }
+
+  return this;
+}
+
+void CLoraDutyCycle_Delete(CLoraDutyCycle this)
+{
+  vPortFree(this);
+}
+
+
+/*****************************************************************************************//**
+ * @fn         bool CLoraDutyCycle_Check(CLoraDutyCycle this, BYTE usSubBand, QWORD qwTimestamp,
+ *                                       DWORD dwAirtime)
+ *
+ * @brief      Checks if a transmission is allowed by the duty-cycle limit of a sub-band.
+ *
+ * @details    The ledger of the sub-band is advanced to the bucket of 'qwTimestamp' (i.e.
+ *             transmissions older than the observation period are forgotten) and the
+ *             transmission is allowed if the transmission time of the window, including the
+ *             new transmission, does not exceed the budget of the sub-band.\n
+ *             The transmission is not reserved (see 'CLoraDutyCycle_Reserve').
+ *
+ * @param      this
+ *             The pointer to CLoraDutyCycle object.
+ *
+ * @param      usSubBand
+ *             The sub-band used for the transmission ('LORADUTYCYCLE_SUBBAND_xxx').
+ *
+ * @param      qwTimestamp
+ *             The start time of the transmission (gateway clock in microseconds).
+ *
+ * @param      dwAirtime
+ *             The time-on-air of the transmission (microseconds).
+ *
+ * @return     The 'true' value is returned if the transmission is allowed.
+*********************************************************************************************/
+bool CLoraDutyCycle_Check(CLoraDutyCycle this, BYTE usSubBand, QWORD qwTimestamp, DWORD dwAirtime)
+{
+  CLoraDutyCycleSubBand pSubBand;
+
+  if (usSubBand >= LORADUTYCYCLE_SUBBAND_NUMBER)
+  {
+    return false;
+  }
+
+  pSubBand = &(this->m_SubBands[usSubBand]);
+  CLoraDutyCycle_Advance(pSubBand, qwTimestamp / LORADUTYCYCLE_BUCKET_TIME);
+
+  if ((QWORD) pSubBand->m_dwWindowAirtime + dwAirtime > pSubBand->m_dwBudget)
+  {
+    ++this->m_dwRejectedNumber;
+
+    #if (LORADUTYCYCLE_DEBUG_LEVEL1)
+      DEBUG_PRINT("[INFO] CLoraDutyCycle_Check, budget exhausted for sub-band: ");
+      DEBUG_PRINT_DEC(usSubBand);
+      DEBUG_PRINT(", window airtime: ");
+      DEBUG_PRINT_DEC(pSubBand->m_dwWindowAirtime);
+      DEBUG_PRINT_CR;
+    #endif
+    return false;
+  }
+
+  return true;
+}
+
+
+/*****************************************************************************************//**
+ * @fn         void CLoraDutyCycle_Reserve(CLoraDutyCycle this, BYTE usSubBand, QWORD qwTimestamp,
+ *                                         DWORD dwAirtime)
+ *
+ * @brief      Records a transmission in the ledger of a sub-band.
+ *
+ * @details    The transmission time is added to the bucket of its start time. A transmission
+ *             older than the observation period is ignored.
+ *
+ * @param      this
+ *             The pointer to CLoraDutyCycle object.
+ *
+ * @param      usSubBand
+ *             The sub-band used for the transmission ('LORADUTYCYCLE_SUBBAND_xxx').
+ *
+ * @param      qwTimestamp
+ *             The start time of the transmission (gateway clock in microseconds).
+ *
+ * @param      dwAirtime
+ *             The time-on-air of the transmission (microseconds).
+ *
+ * @return     None.
+ *
+ * @note       The transmission is typically checked with 'CLoraDutyCycle_Check' before.
+*********************************************************************************************/
+void CLoraDutyCycle_Reserve(CLoraDutyCycle this, BYTE usSubBand, QWORD qwTimestamp, DWORD dwAirtime)
+{
+  CLoraDutyCycleSubBand pSubBand;
+  QWORD qwBucket;
+
+  if (usSubBand >= LORADUTYCYCLE_SUBBAND_NUMBER)
+  {
+    return;
+  }
+
+  pSubBand = &(this->m_SubBands[usSubBand]);
+  qwBucket = qwTimestamp / LORADUTYCYCLE_BUCKET_TIME;
+  CLoraDutyCycle_Advance(pSubBand, qwBucket);
+
+  if (qwBucket + LORADUTYCYCLE_BUCKET_NUMBER > pSubBand->m_qwHeadBucket)
+  {
+    pSubBand->m_dwBuckets[qwBucket % LORADUTYCYCLE_BUCKET_NUMBER] += dwAirtime;
+    pSubBand->m_dwWindowAirtime += dwAirtime;
+  }
+}
+
+
+DWORD CLoraDutyCycle_GetWindowAirtime(CLoraDutyCycle this, BYTE usSubBand)
+{
+  return usSubBand < LORADUTYCYCLE_SUBBAND_NUMBER ? this->m_SubBands[usSubBand].m_dwWindowAirtime : 0;
+}
+
+
+DWORD CLoraDutyCycle_GetRejectedNumber(CLoraDutyCycle this)
+{
+  return this->m_dwRejectedNumber;
+}
+
+
+/*****************************************************************************************//**
+ * @fn         DWORD CLoraDutyCycle_GetTimeOnAir(BYTE usSpreadingFactor, BYTE usBandwidth,
+ *                                 BYTE usCodingRate, WORD wPreambleLength, bool bHeader,
+ *                                 bool bCRC, DWORD dwPayloadLength)
+ *
+ * @brief      Computes the time-on-air of a LoRa packet.
+ *
+ * @details    The time-on-air is the sum of preamble time and payload time (SX1276 datasheet,
+ *             section 4.1.1.7):\n
+ *              - Preamble = (preamble length + 4.25) symbols\n
+ *              - Payload = 8 + max(ceil((8.PL - 4.SF + 28 + 16.CRC - 20.IH) / (4.(SF - 2.DE)))
+ *                .(CR + 4), 0) symbols\n
+ *             The low data rate optimization (DE) is assumed when the symbol time exceeds 16 ms
+ *             (i.e. mandatory for SF11 and SF12 at 125 kHz).
+ *
+ * @param      usSpreadingFactor
+ *             The spreading factor ('LORATRANSCEIVERITF_SF_xxx').
+ *
+ * @param      usBandwidth
+ *             The bandwidth ('LORATRANSCEIVERITF_BANDWIDTH_xxx').
+ *
+ * @param      usCodingRate
+ *             The coding rate ('LORATRANSCEIVERITF_CR_xxx').
+ *
+ * @param      wPreambleLength
+ *             The number of programmed preamble symbols.
+ *
+ * @param      bHeader
+ *             Explicit header mode.
+ *
+ * @param      bCRC
+ *             Payload CRC.
+ *
+ * @param      dwPayloadLength
+ *             The payload length (bytes).
+ *
+ * @return     The time-on-air in microseconds (0 if radio settings are not valid).
+*********************************************************************************************/
+DWORD CLoraDutyCycle_GetTimeOnAir(BYTE usSpreadingFactor, BYTE usBandwidth, BYTE usCodingRate, WORD wPreambleLength,
+                                  bool bHeader, bool bCRC, DWORD dwPayloadLength)
+{
+  DWORD dwSymbolTime;
+  DWORD dwLowDataRate;
+  DWORD dwPayloadSymbols;
+  int32_t nNumerator;
+  int32_t nDenominator;
+  QWORD qwTimeOnAir;
+
+  if ((usSpreadingFactor < LORATRANSCEIVERITF_SF_6) || (usSpreadingFactor > LORATRANSCEIVERITF_SF_12) ||
+      (usBandwidth > LORATRANSCEIVERITF_BANDWIDTH_500) ||
+      (usCodingRate < LORATRANSCEIVERITF_CR_5) || (usCodingRate > LORATRANSCEIVERITF_CR_8))
+  {
+    return 0;
+  }
+
+  dwSymbolTime = g_dwLoraDutyCycleSymbolTimeSF6[usBandwidth] << (usSpreadingFactor - LORATRANSCEIVERITF_SF_6);
+  dwLowDataRate = (dwSymbolTime >= 16000) ? 1 : 0;
+
+  // Payload symbols (the 8 first symbols are sent with CR = 4/8)
+  nNumerator = (int32_t) (8 * dwPayloadLength) - (4 * usSpreadingFactor) + 28 + (bCRC == true ? 16 : 0) -
+               (bHeader == true ? 0 : 20);
+  nDenominator = 4 * (usSpreadingFactor - 2 * dwLowDataRate);
+  dwPayloadSymbols = 8;
+  if (nNumerator > 0)
+  {
+    dwPayloadSymbols += ((nNumerator + nDenominator - 1) / nDenominator) * (usCodingRate + 4);
+  }
+
+  // Preamble time is (n + 4.25) symbols (i.e. symbol time is a multiple of 4 microseconds)
+  qwTimeOnAir = ((QWORD) (4 * wPreambleLength + 17) * dwSymbolTime) / 4 + (QWORD) dwPayloadSymbols * dwSymbolTime;
+
+  return qwTimeOnAir > 0xFFFFFFFF ? 0xFFFFFFFF : (DWORD) qwTimeOnAir;
+}
+
+
+// Returns the EU868 sub-band of a frequency channel ('LORATRANSCEIVERITF_FREQUENCY_xxx')
+BYTE CLoraDutyCycle_GetSubBand(BYTE usFreqChannel)
+{
+  switch (usFreqChannel)
+  {
+    case LORATRANSCEIVERITF_FREQUENCY_CHANNEL_10:
+    case LORATRANSCEIVERITF_FREQUENCY_CHANNEL_11:
+    case LORATRANSCEIVERITF_FREQUENCY_CHANNEL_12:
+    case LORATRANSCEIVERITF_FREQUENCY_CHANNEL_13:
+    case LORATRANSCEIVERITF_FREQUENCY_CHANNEL_14:
+    case LORATRANSCEIVERITF_FREQUENCY_CHANNEL_15:
+    case LORATRANSCEIVERITF_FREQUENCY_CHANNEL_16:
+      return LORADUTYCYCLE_SUBBAND_G;
+
+    case LORATRANSCEIVERITF_FREQUENCY_CHANNEL_00:
+    case LORATRANSCEIVERITF_FREQUENCY_CHANNEL_01:
+    case LORATRANSCEIVERITF_FREQUENCY_CHANNEL_02:
+    case LORATRANSCEIVERITF_FREQUENCY_CHANNEL_17:
+    case LORATRANSCEIVERITF_FREQUENCY_CHANNEL_18:
+      return LORADUTYCYCLE_SUBBAND_G1;
+
+    case LORATRANSCEIVERITF_FREQUENCY_CHANNEL_03:
+    case LORATRANSCEIVERITF_FREQUENCY_CHANNEL_04:
+      return LORADUTYCYCLE_SUBBAND_G2;
+
+    case LORATRANSCEIVERITF_FREQUENCY_CHANNEL_05:
+    case LORATRANSCEIVERITF_FREQUENCY_RX2:
+      return LORADUTYCYCLE_SUBBAND_G3;
+
+    default:
+      return LORADUTYCYCLE_SUBBAND_NONE;
+  }
+}
+
+
+/*********************************************************************************************
+  Private methods (implementation)
+*********************************************************************************************/
+
+// Moves the most recent bucket of a sub-band ledger (i.e. clears the buckets leaving the window)
+// Note: Nothing is done if 'qwBucket' is not more recent than the current head
+static void CLoraDutyCycle_Advance(CLoraDutyCycleSubBand pSubBand, QWORD qwBucket)
+{
+  WORD wIndex;
+
+  if (qwBucket <= pSubBand->m_qwHeadBucket)
+  {
+    return;
+  }
+
+  if (qwBucket - pSubBand->m_qwHeadBucket >= LORADUTYCYCLE_BUCKET_NUMBER)
+  {
+    // No transmission in the new window
+    memset(pSubBand->m_dwBuckets, 0, sizeof(pSubBand->m_dwBuckets));
+    pSubBand->m_dwWindowAirtime = 0;
+    pSubBand->m_qwHeadBucket = qwBucket;
+    return;
+  }
+
+  while (pSubBand->m_qwHeadBucket < qwBucket)
+  {
+    ++pSubBand->m_qwHeadBucket;
+    wIndex = pSubBand->m_qwHeadBucket % LORADUTYCYCLE_BUCKET_NUMBER;
+    pSubBand->m_dwWindowAirtime -= pSubBand->m_dwBuckets[wIndex];
+    pSubBand->m_dwBuckets[wIndex] = 0;
+  }
+}
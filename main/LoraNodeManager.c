@@ -39,6 +39,9 @@
 #include "TransceiverManagerItf.h"
 #include "ServerManagerItf.h"
 #include "LoraRealtimeSenderItf.h"
+#include "LoraNodeManagerItf.h"
+#include "TaskPlacement.h"
+#include "TraceRing.h"
 
 // Object's definitions and methods
 #include "LoraNodeManager.h"
@@ -55,13 +58,38 @@ CTransceiverManagerItfImplOb g_TransceiverManagerItfImplOb = { .m_pAddRef = CLor
                                                                .m_pAttach = CLoraNodeManager_Attach,
                                                                .m_pStart = CLoraNodeManager_Start,
                                                                .m_pStop = CLoraNodeManager_Stop,
-                                                               .m_pSessionEvent = CLoraNodeManager_SessionEvent
+                                                               .m_pSessionEvent = CLoraNodeManager_SessionEvent,
+                                                               .m_pSendDownlink = CLoraNodeManager_SendDownlink
                                                              };
 
 // The CLoraNodeManager object implements the global configuration object
 #define NODEMANAGERCONFIG_IMPL
 #include "Configuration.h"
 
+// Factory of 'LoraTransceiver' objects (see 'CLoraNodeManager_SetTransceiverFactory')
+static CLoraNodeManager_TransceiverFactory g_pLoraNodeManagerTransceiverFactory = NULL;
+
+// Central frequency in kHz for predefined channel No. (see 'LoraTransceiverItf.h')
+// Note: Used to convert the frequency requested by the Network Server ('CHANNEL_00' is the 'NONE'
+//       value, the same frequency is provided by 'CHANNEL_18')
+static const DWORD g_dwLoraNodeManagerChannelFreq[LORATRANSCEIVERITF_FREQUENCY_CHANNEL_18 + 1] =
+  {
+    [LORATRANSCEIVERITF_FREQUENCY_CHANNEL_01] = 868300,
+    [LORATRANSCEIVERITF_FREQUENCY_CHANNEL_02] = 868500,
+    [LORATRANSCEIVERITF_FREQUENCY_CHANNEL_03] = 868850,
+    [LORATRANSCEIVERITF_FREQUENCY_CHANNEL_04] = 869050,
+    [LORATRANSCEIVERITF_FREQUENCY_CHANNEL_05] = 869525,
+    [LORATRANSCEIVERITF_FREQUENCY_CHANNEL_10] = 865200,
+    [LORATRANSCEIVERITF_FREQUENCY_CHANNEL_11] = 865500,
+    [LORATRANSCEIVERITF_FREQUENCY_CHANNEL_12] = 865800,
+    [LORATRANSCEIVERITF_FREQUENCY_CHANNEL_13] = 866100,
+    [LORATRANSCEIVERITF_FREQUENCY_CHANNEL_14] = 866400,
+    [LORATRANSCEIVERITF_FREQUENCY_CHANNEL_15] = 866700,
+    [LORATRANSCEIVERITF_FREQUENCY_CHANNEL_16] = 867000,
+    [LORATRANSCEIVERITF_FREQUENCY_CHANNEL_17] = 868000,
+    [LORATRANSCEIVERITF_FREQUENCY_CHANNEL_18] = 868100
+  };
+
 
 /*  To delete -> now in Configuration.h
 
@@ -184,8 +212,9 @@ CTransceiverManagerItf_InitializeParamsOb g_LoraNodeManagerSettings =
  *
  * @param      usTransceiverNumber
  *             The number of 'LoraTransceiver' in the gateway (i.e. hardware configuration).
+ *             The maximum value is 'GATEWAY_MAX_LORATRANSCEIVERS'.
  * 
- * @return     A 'ITransceiverManager' interface object.\n
+ * @return     A 'ITransceiverManager' interface object (NULL if error).\n
  *             The reference count for returned 'ILoraTransceiver' interface is set to 1.
  *
  * @note       The CLoraNodeManager object and associated 'LoraTransceiver' objects are
@@ -197,20 +226,39 @@ CTransceiverManagerItf_InitializeParamsOb g_LoraNodeManagerSettings =
  *             'ITransceiverManager' is released (i.e. call to 'ITransceiverManager_ReleaseItf' 
  *             method).
  * 
- * @note       The 'LoraTransceiver' is assumed to be implemented by a 'CSX1276' object.
+ * @note       The 'LoraTransceiver' is implemented by a 'CSX1276' object unless a factory is
+ *             set with 'CLoraNodeManager_SetTransceiverFactory' (i.e. simulated transceivers).
 *********************************************************************************************/
 ITransceiverManager CLoraNodeManager_CreateInstance(BYTE usTransceiverNumber)
 {
   CLoraNodeManager * pLoraNodeManager;
   ILoraTransceiver pLoraTransceiverItf;
+
+  if ((usTransceiverNumber == 0) || (usTransceiverNumber > GATEWAY_MAX_LORATRANSCEIVERS))
+  {
+    return NULL;
+  }
      
   // Create the object
   if ((pLoraNodeManager = CLoraNodeManager_New()) != NULL)
   {
-    // Create 'LoraTransceiver' ojects (implemented by 'CSX1276' object)
+    // Create 'LoraTransceiver' ojects (implemented by 'CSX1276' object or by factory)
     for (BYTE i = 0; i < usTransceiverNumber; i++)
     {
-      if ((pLoraTransceiverItf = CSX1276_CreateInstance()) == NULL)
+      if (g_pLoraNodeManagerTransceiverFactory != NULL)
+      {
+        pLoraTransceiverItf = g_pLoraNodeManagerTransceiverFactory(i);
+      }
+      else
+      {
+        #ifdef ESP_PLATFORM
+          pLoraTransceiverItf = CSX1276_CreateInstance();
+        #else
+          pLoraTransceiverItf = NULL;
+        #endif
+      }
+
+      if (pLoraTransceiverItf == NULL)
       {
         CLoraNodeManager_Delete(pLoraNodeManager);
         return NULL;
@@ -238,6 +286,13 @@ ITransceiverManager CLoraNodeManager_CreateInstance(BYTE usTransceiverNumber)
   return NULL;
 }
 
+// Sets the factory of 'LoraTransceiver' objects used by next 'CreateInstance' calls
+// Note: Typically the simulated transceivers of Linux host (NULL = 'CSX1276' objects)
+void CLoraNodeManager_SetTransceiverFactory(CLoraNodeManager_TransceiverFactory pTransceiverFactory)
+{
+  g_pLoraNodeManagerTransceiverFactory = pTransceiverFactory;
+}
+
 /*********************************************************************************************
   Public methods exposed on 'ITransceiverManager' interface
  
@@ -320,7 +375,7 @@ bool CLoraNodeManager_Initialize(void *this, void *pParams)
   DEBUG_PRINT_LN("[INFO] CLoraNodeManager_Initialize, calling CLoraNodeManager_NotifyAndProcessCommand");
 
   CLoraNodeManager_NotifyAndProcessCommand((CLoraNodeManager *) this, 
-                                           LORANODEMANAGER_AUTOMATON_CMD_INITIALIZE, pParams);
+                                           LORANODEMANAGER_AUTOMATON_CMD_INITIALIZE, 0, pParams);
 
   DEBUG_PRINT_LN("[INFO] CLoraNodeManager_Initialize, return from CLoraNodeManager_NotifyAndProcessCommand");
 
@@ -330,19 +385,19 @@ bool CLoraNodeManager_Initialize(void *this, void *pParams)
 bool CLoraNodeManager_Attach(void *this, void *pParams)
 {
   return CLoraNodeManager_NotifyAndProcessCommand((CLoraNodeManager *) this, 
-                                                  LORANODEMANAGER_AUTOMATON_CMD_ATTACH, pParams);
+                                                  LORANODEMANAGER_AUTOMATON_CMD_ATTACH, 0, pParams);
 }
 
 bool CLoraNodeManager_Start(void *this, void *pParams)
 {
   return CLoraNodeManager_NotifyAndProcessCommand((CLoraNodeManager *) this, 
-                                                  LORANODEMANAGER_AUTOMATON_CMD_START, pParams);
+                                                  LORANODEMANAGER_AUTOMATON_CMD_START, 0, pParams);
 }
 
 bool CLoraNodeManager_Stop(void *this, void *pParams)
 {
   return CLoraNodeManager_NotifyAndProcessCommand((CLoraNodeManager *) this, 
-                                                  LORANODEMANAGER_AUTOMATON_CMD_STOP, pParams);
+                                                  LORANODEMANAGER_AUTOMATON_CMD_STOP, 0, pParams);
 }
 
 bool CLoraNodeManager_SessionEvent(void *this, void *pEvent)
@@ -353,7 +408,7 @@ bool CLoraNodeManager_SessionEvent(void *this, void *pEvent)
   // Note: The 'CLoraNodeManager_MessageOb' object inserted in queue is a 
   //       'CTransceiverManagerItf_SessionEventOb' object
   QueueMessage.m_wMessageType = ((CTransceiverManagerItf_SessionEvent) pEvent)->m_wEventType;
-  QueueMessage.m_dwMessageData = (DWORD)((CTransceiverManagerItf_SessionEvent) pEvent)->m_pSession;
+  QueueMessage.m_dwMessageData = (uintptr_t)((CTransceiverManagerItf_SessionEvent) pEvent)->m_pSession;
   QueueMessage.m_dwMessageData2 = ((CTransceiverManagerItf_SessionEvent) pEvent)->m_dwSessionId;
 
   if (xQueueSend(((CLoraNodeManager *)this)->m_hSessionManagerQueue, &QueueMessage, 
@@ -369,6 +424,21 @@ bool CLoraNodeManager_SessionEvent(void *this, void *pEvent)
   return true;
 }
 
+bool CLoraNodeManager_SendDownlink(void *this, void *pParams)
+{
+  // The packet is scheduled by the 'SessionManager' task (i.e. 'ScheduleSendNodePacket' method of
+  // 'LoraRealtimeSender' is not reentrant)
+  // Note: The caller is blocked at most 'TRANSCEIVERMANAGER_SENDDOWNLINK_MAX_DURATION' (i.e. 
+  //       'TOO_LATE' result if the automaton is busy with another command)
+  ((CTransceiverManagerItf_SendDownlinkParams) pParams)->m_dwResult = TRANSCEIVERMANAGER_SENDDOWNLINK_TOO_LATE;
+  if (CLoraNodeManager_NotifyAndProcessCommand((CLoraNodeManager *) this, LORANODEMANAGER_AUTOMATON_CMD_SENDDOWNLINK, 
+                                               TRANSCEIVERMANAGER_SENDDOWNLINK_MAX_DURATION, pParams) == false)
+  {
+    return false;
+  }
+  return ((CTransceiverManagerItf_SendDownlinkParams) pParams)->m_dwResult == TRANSCEIVERMANAGER_SENDDOWNLINK_NONE;
+}
+
 /********************************************************************************************* 
   Private methods of CLoraNodeManager object
  
@@ -376,8 +446,8 @@ bool CLoraNodeManager_SessionEvent(void *this, void *pEvent)
 *********************************************************************************************/
 
 /*****************************************************************************************//**
- * @fn         bool CLoraNodeManager_NotifyAndProcessCommand(CLoraNodeManager *this, 
- *                                                           DWORD dwCommand, void *pCmdParams)
+ * @fn         bool CLoraNodeManager_NotifyAndProcessCommand(CLoraNodeManager *this, DWORD dwCommand,
+ *                                                           DWORD dwTimeout, void *pCmdParams)
  * 
  * @brief      Process a command issued by a method of 'ILoraNodeManager' interface.
  * 
@@ -394,6 +464,10 @@ bool CLoraNodeManager_SessionEvent(void *this, void *pEvent)
  *             'ILoraNodeManager' interface. See 'LORANODEMANAGER_AUTOMATON_CMD_xxx' in 
  *             LoraNodeManager.h.
  *  
+ * @param      dwTimeout
+ *             Maximum duration of the call in milliseconds (i.e. including the wait for a
+ *             pending command). If the value is 0, the standard timeout is used.
+ *
  * @param      pCmdParams
  *             A pointer to command parameters. The object pointed by 'pCmdParams' depends
  *             on method invoked on 'ILoraTransmiter' interface. 
@@ -406,14 +480,25 @@ bool CLoraNodeManager_SessionEvent(void *this, void *pEvent)
  *             The maximum execution time can be configured and a mechanism is implemented in
  *             order to ignore client commands sent when a previous command is still pending.
 *********************************************************************************************/
-bool CLoraNodeManager_NotifyAndProcessCommand(CLoraNodeManager *this, DWORD dwCommand, void *pCmdParams)
+bool CLoraNodeManager_NotifyAndProcessCommand(CLoraNodeManager *this, DWORD dwCommand, DWORD dwTimeout, void *pCmdParams)
 {
+  DWORD dwMutexTimeout;
+  DWORD dwQueueTimeout;
+  DWORD dwDoneTimeout;
+
+  // Standard timeout: each wait is limited (i.e. no global limit)
+  // Specific timeout: shared between the waits (i.e. call duration limited)
+  dwMutexTimeout = dwTimeout == 0 ? LORANODEMANAGER_AUTOMATON_MAX_CMD_DURATION : dwTimeout / 4;
+  dwQueueTimeout = dwTimeout == 0 ? LORANODEMANAGER_AUTOMATON_MAX_CMD_DURATION / 2 : dwTimeout / 4;
+  dwDoneTimeout = dwTimeout == 0 ? LORANODEMANAGER_AUTOMATON_MAX_CMD_DURATION - (LORANODEMANAGER_AUTOMATON_MAX_CMD_DURATION / 5) :
+                                   dwTimeout / 2;
+
   // Automaton commands are serialized (and should be quickly processed)
-  // Note: In current design, there is only one client object for a single CLoraNodeManager
-  //       instance (the main task on program startup and for operation control). In other 
-  //       words, commands are serialized here and there is no concurrency on the 
-  //       'CLoraNodeManager_NotifyAndProcessCommand' method.
-  if (xSemaphoreTake(this->m_hCommandMutex, pdMS_TO_TICKS(LORANODEMANAGER_AUTOMATON_MAX_CMD_DURATION)) == pdFAIL)
+  // Note: In current design, there are two client objects for a single CLoraNodeManager
+  //       instance (the main task on program startup and for operation control, the 
+  //       'ServerManager' connector task for downlink packets). The commands are serialized
+  //       here by the mutex.
+  if (xSemaphoreTake(this->m_hCommandMutex, pdMS_TO_TICKS(dwMutexTimeout)) == pdFAIL)
   {
     #if (LORANODEMANAGER_DEBUG_LEVEL0)
       DEBUG_PRINT_LN("[ERROR] CLoraNodeManager_NotifyAndProcessCommand - Failed to take mutex");
@@ -445,7 +530,7 @@ bool CLoraNodeManager_NotifyAndProcessCommand(CLoraNodeManager *this, DWORD dwCo
   CLoraNodeManager_MessageOb QueueMessage;
   QueueMessage.m_wMessageType = LORANODEMANAGER_AUTOMATON_MSG_COMMAND;
 
-  if (xQueueSend(this->m_hSessionManagerQueue, &QueueMessage, pdMS_TO_TICKS(LORANODEMANAGER_AUTOMATON_MAX_CMD_DURATION / 2)) != pdPASS)
+  if (xQueueSend(this->m_hSessionManagerQueue, &QueueMessage, pdMS_TO_TICKS(dwQueueTimeout)) != pdPASS)
   {
     // Message queue is full
     #if (LORANODEMANAGER_DEBUG_LEVEL0)
@@ -457,8 +542,7 @@ bool CLoraNodeManager_NotifyAndProcessCommand(CLoraNodeManager *this, DWORD dwCo
   }
 
   // Wait for command execution by main automaton
-  BaseType_t nCommandDone = xSemaphoreTake(this->m_hCommandDone, pdMS_TO_TICKS(LORANODEMANAGER_AUTOMATON_MAX_CMD_DURATION -
-                                           (LORANODEMANAGER_AUTOMATON_MAX_CMD_DURATION / 5)));
+  BaseType_t nCommandDone = xSemaphoreTake(this->m_hCommandDone, pdMS_TO_TICKS(dwDoneTimeout));
 
   // If the command has been processed, clear 'm_dwCommand' attribute
   if (nCommandDone == pdPASS)
@@ -524,10 +608,10 @@ bool CLoraNodeManager_NotifyAndProcessCommand(CLoraNodeManager *this, DWORD dwCo
 void CLoraNodeManager_SessionManagerAutomaton(CLoraNodeManager *this)
 {
   CLoraNodeManager_MessageOb QueueMessage;
-  BYTE i;
-  CMemoryBlockArray pSessionArray = this->m_pLoraPacketSessionArray;
+  WORD i;
+  CWideMemoryBlockArray pSessionArray = this->m_pLoraPacketSessionArray;
   CLoraPacketSession pLoraPacketSession;
-  DWORD dwSessionEndTime;
+  QWORD qwSessionEndTime;
   bool bReleaseSession;
 
   while (this->m_dwCurrentState != LORANODEMANAGER_AUTOMATON_STATE_TERMINATED)
@@ -605,9 +689,9 @@ void CLoraNodeManager_SessionManagerAutomaton(CLoraNodeManager *this)
         // The 'LoraPacketSession' objects MUST be destroyed only by code below
         //  - The 'LoraPacketSession' cannot be destroyed while enumerated by the loop (i.e. no task synchronization required)
         //  - Some 'LoraPacketSession' may be missed if they become 'ready' during the loop (not an issue, checked on next iteration)
-        for (i = 0; i < pSessionArray->m_usArraySize; i++)
+        for (i = 0; i < pSessionArray->m_wArraySize; i++)
         {
-          if (CMemoryBlockArray_IsBlockReady(pSessionArray, i) == true)
+          if (CWideMemoryBlockArray_IsBlockReady(pSessionArray, i) == true)
           {
             #if (LORANODEMANAGER_DEBUG_LEVEL2)
               DEBUG_PRINT("[DEBUG] CLoraNodeManager_SessionManagerAutomaton, Enumerator, session block ready, index: ");
@@ -616,7 +700,7 @@ void CLoraNodeManager_SessionManagerAutomaton(CLoraNodeManager *this)
             #endif
 
             bReleaseSession = false;
-            pLoraPacketSession = (CLoraPacketSession) CMemoryBlockArray_BlockPtrFromIndex(pSessionArray, i);
+            pLoraPacketSession = (CLoraPacketSession) CWideMemoryBlockArray_BlockPtrFromIndex(pSessionArray, i);
 
             // Session can be released if terminated
             if ((pLoraPacketSession->m_dwSessionState == LORANODEMANAGER_SESSION_STATE_UPLINK_SENT) ||
@@ -636,22 +720,24 @@ void CLoraNodeManager_SessionManagerAutomaton(CLoraNodeManager *this)
               if ((pLoraPacketSession->m_usMessageType == LORANODEMANAGER_MSG_TYPE_UNCONF_UPLINK) ||
                   (pLoraPacketSession->m_usMessageType == LORANODEMANAGER_MSG_TYPE_CONF_UPLINK))
               {
-                dwSessionEndTime = pLoraPacketSession->m_dwTimestamp + LORANODEMANAGER_LORAWAN_RECEIVE_DELAY2 +
-                                     LORANODEMANAGER_LORAWAN_RX_WINDOW_LENGTH;
+                qwSessionEndTime = pLoraPacketSession->m_qwTimestamp + 
+                                     GATEWAY_CLOCK_MS_TO_US(LORANODEMANAGER_LORAWAN_RECEIVE_DELAY2 +
+                                                            LORANODEMANAGER_LORAWAN_RX_WINDOW_LENGTH);
               }
               else if (pLoraPacketSession->m_usMessageType == LORANODEMANAGER_MSG_TYPE_JOIN_REQUEST)
               {
-                dwSessionEndTime = pLoraPacketSession->m_dwTimestamp + LORANODEMANAGER_LORAWAN_JOIN_ACCEPT_DELAY2 +
-                                    LORANODEMANAGER_LORAWAN_RX_WINDOW_LENGTH;
+                qwSessionEndTime = pLoraPacketSession->m_qwTimestamp + 
+                                     GATEWAY_CLOCK_MS_TO_US(LORANODEMANAGER_LORAWAN_JOIN_ACCEPT_DELAY2 +
+                                                            LORANODEMANAGER_LORAWAN_RX_WINDOW_LENGTH);
               }
               else
               {
                 // Sessions created by other packet types are not supported in this version
-                dwSessionEndTime = 0;
+                qwSessionEndTime = 0;
               }
 
               // Session can be released at the end of 'Node' receive period in some cases 
-              if ((dwSessionEndTime != 0) && (dwSessionEndTime <= xTaskGetTickCount() * portTICK_RATE_MS))
+              if ((qwSessionEndTime != 0) && (qwSessionEndTime <= GATEWAY_CLOCK_MICROSEC()))
               {
                 // Session can be destroyed only if: 
                 //  - 'PacketForwarder' does not need 'LoraPacket' (i.e. it has encoded data)
@@ -683,7 +769,7 @@ void CLoraNodeManager_SessionManagerAutomaton(CLoraNodeManager *this)
               // Destroy 'CLoraPacket' if still allocated
               if (pLoraPacketSession->m_LoraPacketEntry.m_pDataBlock != NULL)
               {
-                CMemoryBlockArray_ReleaseBlock(this->m_pLoraPacketArray, pLoraPacketSession->m_LoraPacketEntry.m_usBlockIndex);
+                CWideMemoryBlockArray_ReleaseRef(this->m_pLoraPacketArray, pLoraPacketSession->m_LoraPacketEntry.m_wBlockIndex);
 
                 #if (LORANODEMANAGER_DEBUG_LEVEL2)
                   DEBUG_PRINT_LN("[DEBUG] CLoraNodeManager_SessionManagerAutomaton, LoraPacket destroyed");
@@ -691,7 +777,7 @@ void CLoraNodeManager_SessionManagerAutomaton(CLoraNodeManager *this)
               }
 
               // Destroy 'CLoraPacketSession'
-              CMemoryBlockArray_ReleaseBlock(pSessionArray, i);
+              CWideMemoryBlockArray_ReleaseBlock(pSessionArray, i);
 
               #if (LORANODEMANAGER_DEBUG_LEVEL2)
                 DEBUG_PRINT_LN("[DEBUG] CLoraNodeManager_SessionManagerAutomaton, LoraPacketSession destroyed");
@@ -789,7 +875,7 @@ void CLoraNodeManager_TransceiverAutomaton(CLoraNodeManager *this)
         switch (QueueMessage.m_wEventType)
         {
           case LORATRANSCEIVERITF_EVENT_PACKETRECEIVED:
-            CLoraNodeManager_ProcessTransceiverUplinkReceived(this, &QueueMessage);
+            CLoraNodeManager_ProcessTransceiverReceiveRing(this, &QueueMessage);
             break;
   
           case LORATRANSCEIVERITF_EVENT_PACKETSENT:
@@ -932,11 +1018,14 @@ CLoraNodeManager * CLoraNodeManager_New()
 
     // Embedded objects are not defined (i.e. created below)
     this->m_pLoraPacketArray = this->m_pLoraPacketSessionArray = this->m_pLoraDownPacketSessionArray = NULL;
-    this->m_hCommandMutex = this->m_hCommandDone = this->m_hSessionManagerTask = 
-      this->m_hTransceiverTask = this->m_hSessionManagerQueue = 
-      this->m_hTransceiverNotifQueue = this->m_hServerNotifQueue = 
-      this->m_hPacketForwarderTask = NULL;
+    this->m_hCommandMutex = this->m_hCommandDone = this->m_hSessionManagerQueue = 
+      this->m_hTransceiverNotifQueue = this->m_hServerNotifQueue = NULL;
+    this->m_hSessionManagerTask = this->m_hTransceiverTask = this->m_hPacketForwarderTask = NULL;
     this->m_pRealtimeSenderItf = NULL;
+    for (BYTE i = 0; i < GATEWAY_MAX_LORATRANSCEIVERS; i++)
+    {
+      this->m_TransceiverDescrArray[i].m_pReceiveRing = NULL;
+    }
 
 
     #if (LORANODEMANAGER_DEBUG_LEVEL2)
@@ -944,8 +1033,9 @@ CLoraNodeManager * CLoraNodeManager_New()
     #endif
 
     // Allocate memory blocks for internal collections
-    if ((this->m_pLoraPacketArray = CMemoryBlockArray_New(sizeof(CLoraTransceiverItf_LoraPacketOb) + 
-        LORA_MAX_PAYLOAD_LENGTH - 1, LORANODEMANAGER_MAX_LORAPACKETS)) == NULL)
+    // Note: Shared packet buffers (i.e. used by 'LoraTransceivers' and 'ServerManager')
+    if ((this->m_pLoraPacketArray = CWideMemoryBlockArray_NewShared(LORANODEMANAGER_LORAPACKET_BLOCK_SIZE,
+        LORANODEMANAGER_MAX_LORAPACKETS)) == NULL)
     {
       CLoraNodeManager_Delete(this);
       return NULL;
@@ -955,7 +1045,7 @@ CLoraNodeManager * CLoraNodeManager_New()
       DEBUG_PRINT_LN("[DEBUG] CLoraNodeManager_New Entering: create object 2");
     #endif
 
-    if ((this->m_pLoraPacketSessionArray = CMemoryBlockArray_New(sizeof(CLoraPacketSessionOb),
+    if ((this->m_pLoraPacketSessionArray = CWideMemoryBlockArray_New(sizeof(CLoraPacketSessionOb),
         LORANODEMANAGER_MAX_UP_LORASESSIONS)) == NULL)
     {
       CLoraNodeManager_Delete(this);
@@ -966,7 +1056,7 @@ CLoraNodeManager * CLoraNodeManager_New()
       DEBUG_PRINT_LN("[DEBUG] CLoraNodeManager_New Entering: create object 3");
     #endif
 
-    if ((this->m_pLoraDownPacketSessionArray = CMemoryBlockArray_New(sizeof(CLoraDownPacketSessionOb),
+    if ((this->m_pLoraDownPacketSessionArray = CWideMemoryBlockArray_New(sizeof(CLoraDownPacketSessionOb),
         LORANODEMANAGER_MAX_DOWN_LORASESSIONS)) == NULL)
     {
       CLoraNodeManager_Delete(this);
@@ -978,8 +1068,8 @@ CLoraNodeManager * CLoraNodeManager_New()
     #endif
 
     // Create SessionManager automaton task
-    if (xTaskCreate((TaskFunction_t) CLoraNodeManager_SessionManagerAutomaton, "CLoraNodeManager_SessionManagerAutomaton", 
-        2048, this, 5, &(this->m_hSessionManagerTask)) == pdFAIL)
+    if (CTaskPlacement_CreateTask(TASKPLACEMENT_TASK_NODEMANAGER_SESSION, (TaskFunction_t) CLoraNodeManager_SessionManagerAutomaton, 
+        this, &(this->m_hSessionManagerTask)) == false)
     {
       CLoraNodeManager_Delete(this);
       return NULL;
@@ -1011,8 +1101,8 @@ CLoraNodeManager * CLoraNodeManager_New()
     #endif
 
     // Create Transceiver automaton task
-    if (xTaskCreate((TaskFunction_t) CLoraNodeManager_TransceiverAutomaton, "CLoraNodeManager_TransceiverAutomaton", 
-        2048, this, 5, &(this->m_hTransceiverTask)) == pdFAIL)
+    if (CTaskPlacement_CreateTask(TASKPLACEMENT_TASK_NODEMANAGER_TRANSCEIVER, (TaskFunction_t) CLoraNodeManager_TransceiverAutomaton, 
+        this, &(this->m_hTransceiverTask)) == false)
     {
       CLoraNodeManager_Delete(this);
       return NULL;
@@ -1024,8 +1114,8 @@ CLoraNodeManager * CLoraNodeManager_New()
     #endif
 
     // Create Forwarder automaton task
-    if (xTaskCreate((TaskFunction_t) CLoraNodeManager_ServerAutomaton, "CLoraNodeManager_ServerAutomaton", 
-        2048, this, 5, &(this->m_hServerTask)) == pdFAIL)
+    if (CTaskPlacement_CreateTask(TASKPLACEMENT_TASK_NODEMANAGER_SERVER, (TaskFunction_t) CLoraNodeManager_ServerAutomaton, 
+        this, &(this->m_hServerTask)) == false)
     {
       CLoraNodeManager_Delete(this);
       return NULL;
@@ -1078,9 +1168,7 @@ CLoraNodeManager * CLoraNodeManager_New()
     this->m_usTransceiverNumber = 0;
     this->m_dwMissedUplinkPacketdNumber = 0;
 
-    this->m_ForwardedUplinkPacket.m_pLoraPacket = NULL;
-    this->m_ForwardedUplinkPacket.m_pSession = NULL;
-    this->m_ForwardedUplinkPacket.m_dwSessionId = 0;
+    this->m_pUplinkQueue = NULL;
     this->m_dwLastUpSessionId = 0;
     this->m_dwLastDownSessionId = 0;
 
@@ -1114,15 +1202,22 @@ void CLoraNodeManager_Delete(CLoraNodeManager *this)
   // Free memory
   if (this->m_pLoraPacketArray != NULL)
   {
-    CMemoryBlockArray_Delete(this->m_pLoraPacketArray);
+    CWideMemoryBlockArray_Delete(this->m_pLoraPacketArray);
   }
   if (this->m_pLoraPacketSessionArray != NULL)
   {
-    CMemoryBlockArray_Delete(this->m_pLoraPacketSessionArray);
+    CWideMemoryBlockArray_Delete(this->m_pLoraPacketSessionArray);
   }
   if (this->m_pLoraDownPacketSessionArray != NULL)
   {
-    CMemoryBlockArray_Delete(this->m_pLoraDownPacketSessionArray);
+    CWideMemoryBlockArray_Delete(this->m_pLoraDownPacketSessionArray);
+  }
+  for (BYTE i = 0; i < GATEWAY_MAX_LORATRANSCEIVERS; i++)
+  {
+    if (this->m_TransceiverDescrArray[i].m_pReceiveRing != NULL)
+    {
+      CSpscRing_Delete(this->m_TransceiverDescrArray[i].m_pReceiveRing);
+    }
   }
 
 
@@ -1196,6 +1291,10 @@ bool CLoraNodeManager_ProcessAutomatonNotifyCommand(CLoraNodeManager *this)
       bResult = CLoraNodeManager_ProcessStop(this, (CTransceiverManagerItf_StopParams) this->m_pCommandParams);
       break;
 
+    case LORANODEMANAGER_AUTOMATON_CMD_SENDDOWNLINK:
+      bResult = CLoraNodeManager_ProcessSendDownlink(this, (CTransceiverManagerItf_SendDownlinkParams) this->m_pCommandParams);
+      break;
+
     default:
       #if (LORANODEMANAGER_DEBUG_LEVEL0)
         DEBUG_PRINT_LN("[ERROR] CLoraNodeManager_ProcessAutomatonNotifyCommand, unknown command");
@@ -1244,6 +1343,8 @@ bool CLoraNodeManager_ProcessAutomatonNotifyCommand(CLoraNodeManager *this)
 bool CLoraNodeManager_ProcessInitialize(CLoraNodeManager *this, CTransceiverManagerItf_InitializeParams pParams)
 {
   CLoraTransceiverItf_InitializeParamsOb LoraTransceiverInitializeParams;
+  CTransceiverManagerItf_LoraTransceiverSettings pSettings;
+  CLoraRealtimeSenderItf_RadioParams pDownlinkRadio;
 
   #if (LORANODEMANAGER_DEBUG_LEVEL0)
     DEBUG_PRINT_CR;
@@ -1275,14 +1376,68 @@ bool CLoraNodeManager_ProcessInitialize(CLoraNodeManager *this, CTransceiverMana
   // 
   // The number of 'LoraTransceiver' present in the gateway was indicated on object's construction.
   // The specified configuration must contain settings for at least this number of 'LoraTransceivers'.
+  // Each 'LoraTransceiver' listens on its own channel (i.e. uplink packets received on several
+  // channels at the same time) and is attached to the shared SPI bus with its own slave ID.
   LoraTransceiverInitializeParams.m_hEventNotifyQueue = this->m_hTransceiverNotifQueue;
+  LoraTransceiverInitializeParams.m_pLoraPacketPool = this->m_pLoraPacketArray;
   for (BYTE i = 0; i < this->m_usTransceiverNumber; i++)
   {
+    for (BYTE j = 0; j < i; j++)
+    {
+      if ((g_LoraNodeManagerSettings.pLoraTransceiverSettings[j].FreqChannel.m_usFreqChannel == 
+           g_LoraNodeManagerSettings.pLoraTransceiverSettings[i].FreqChannel.m_usFreqChannel) ||
+          (g_LoraNodeManagerSettings.pLoraTransceiverSettings[j].m_usSpiSlaveID == 
+           g_LoraNodeManagerSettings.pLoraTransceiverSettings[i].m_usSpiSlaveID))
+      {
+        this->m_dwCurrentState = LORANODEMANAGER_AUTOMATON_STATE_ERROR;
+        #if (LORANODEMANAGER_DEBUG_LEVEL0)
+          DEBUG_PRINT_LN("[ERROR] CLoraNodeManager_ProcessInitialize, same channel or SPI slave ID for two transceivers");
+        #endif
+        return false;
+      }
+    }
+
     // Early version: configuration not provided use builtin settings (i.e. statically defined in firmware) 
     LoraTransceiverInitializeParams.pLoraMAC = &(g_LoraNodeManagerSettings.pLoraTransceiverSettings[i].LoraMAC);
     LoraTransceiverInitializeParams.pLoraMode = &(g_LoraNodeManagerSettings.pLoraTransceiverSettings[i].LoraMode);
     LoraTransceiverInitializeParams.pPowerMode = &(g_LoraNodeManagerSettings.pLoraTransceiverSettings[i].PowerMode);
     LoraTransceiverInitializeParams.pFreqChannel = &(g_LoraNodeManagerSettings.pLoraTransceiverSettings[i].FreqChannel);
+    LoraTransceiverInitializeParams.m_usSpiSlaveID = g_LoraNodeManagerSettings.pLoraTransceiverSettings[i].m_usSpiSlaveID;
+
+    // Receive ring for this 'LoraTransceiver' (depth defined by transceiver settings)
+    if ((this->m_TransceiverDescrArray[i].m_pReceiveRing == NULL) &&
+        ((this->m_TransceiverDescrArray[i].m_pReceiveRing = CSpscRing_New(sizeof(CLoraTransceiverItf_ReceiveSlotOb), 
+          g_LoraNodeManagerSettings.pLoraTransceiverSettings[i].m_wReceiveRingDepth)) == NULL))
+    {
+      this->m_dwCurrentState = LORANODEMANAGER_AUTOMATON_STATE_ERROR;
+      #if (LORANODEMANAGER_DEBUG_LEVEL0)
+        DEBUG_PRINT_LN("[ERROR] CLoraNodeManager_ProcessInitialize, failed to create receive ring");
+      #endif
+      return false;
+    }
+    LoraTransceiverInitializeParams.m_pReceiveRing = this->m_TransceiverDescrArray[i].m_pReceiveRing;
+
+    // Scanner mode (statistics cumulated for the lifetime of 'CLoraNodeManager')
+    memcpy(&(this->m_TransceiverDescrArray[i].m_ScanParams), &(g_LoraNodeManagerSettings.pLoraTransceiverSettings[i].Scan),
+           sizeof(CLoraTransceiverItf_ScanParamsOb));
+    memset(this->m_TransceiverDescrArray[i].m_ScanStatistics, 0, sizeof(this->m_TransceiverDescrArray[i].m_ScanStatistics));
+    this->m_TransceiverDescrArray[i].m_ScanParams.m_pStatistics = this->m_TransceiverDescrArray[i].m_ScanStatistics;
+
+    // Downlink radio settings (i.e. defaults of 'LoraTransceiver' for LoRaWAN public networks
+    // when not configured)
+    pSettings = &(g_LoraNodeManagerSettings.pLoraTransceiverSettings[i]);
+    pDownlinkRadio = &(this->m_TransceiverDescrArray[i].m_DownlinkRadio);
+    pDownlinkRadio->m_usFreqChannel = pSettings->FreqChannel.m_usFreqChannel;
+    pDownlinkRadio->m_usSpreadingFactor = pSettings->LoraMode.m_usSpreadingFactor;
+    pDownlinkRadio->m_usBandwidth = pSettings->LoraMode.m_usBandwidth;
+    pDownlinkRadio->m_usCodingRate = pSettings->LoraMode.m_usCodingRate;
+    pDownlinkRadio->m_usPowerLevel = LORATRANSCEIVERITF_POWER_LEVEL_NONE;
+    pDownlinkRadio->m_wPreambleLength = pSettings->LoraMAC.m_wPreambleLength != LORATRANSCEIVERITF_PREAMBLE_LENGTH_NONE ?
+                                        pSettings->LoraMAC.m_wPreambleLength : LORATRANSCEIVERITF_PREAMBLE_LENGTH_LORA;
+    pDownlinkRadio->m_usHeader = pSettings->LoraMAC.m_usHeader != LORATRANSCEIVERITF_HEADER_NONE ?
+                                 pSettings->LoraMAC.m_usHeader : LORATRANSCEIVERITF_HEADER_ON;
+    pDownlinkRadio->m_usCRC = pSettings->LoraMAC.m_usCRC != LORATRANSCEIVERITF_CRC_NONE ?
+                              pSettings->LoraMAC.m_usCRC : LORATRANSCEIVERITF_CRC_ON;
 
     if (ILoraTransceiver_Initialize(this->m_TransceiverDescrArray[i].m_pLoraTransceiverItf, &LoraTransceiverInitializeParams) == false)
     {
@@ -1301,6 +1456,8 @@ bool CLoraNodeManager_ProcessInitialize(CLoraNodeManager *this, CTransceiverMana
   // ITransceiverManager' interface
   CLoraRealtimeSenderItf_InitializeParamsOb SenderInitParams;
   SenderInitParams.m_pTransceiverManagerItf = this->m_pTransceiverManagerItf;
+  memset(this->m_TxStatistics, 0, sizeof(this->m_TxStatistics));
+  SenderInitParams.m_pTxStatistics = this->m_TxStatistics;
   ILoraRealtimeSender_Initialize(this->m_pRealtimeSenderItf, &SenderInitParams);
 
   
@@ -1377,7 +1534,10 @@ bool CLoraNodeManager_ProcessAttach(CLoraNodeManager *this, CTransceiverManagerI
     return false;
   }
 
-  // Note: Task in 'CServerManager' object
+  // Note: Task and uplink queue in 'CServerManager' object
+  //       The Transceiver task is notified when the 'ServerManager' frees space in a full queue
+  this->m_pUplinkQueue = (CMpscRing) pParams->m_pUplinkQueue;
+  CMpscRing_SetSpaceCallback(this->m_pUplinkQueue, CLoraNodeManager_UplinkQueueSpaceAvailable, this);
   this->m_hPacketForwarderTask = pParams->m_hPacketForwarderTask;
 
   // Enter the 'IDLE' state if current state is 'INITIALIZED' 
@@ -1421,6 +1581,9 @@ bool CLoraNodeManager_ProcessStart(CLoraNodeManager *this, CTransceiverManagerIt
   ReceiveParams.m_bForce = false;
   for (BYTE i = 0; i < this->m_usTransceiverNumber; i++)
   {
+    // Scanner mode if a scan list is defined in transceiver settings
+    ReceiveParams.m_pScanParams = (this->m_TransceiverDescrArray[i].m_ScanParams.m_usChannelNumber != 0) ?
+                                  &(this->m_TransceiverDescrArray[i].m_ScanParams) : NULL;
     if (ILoraTransceiver_Receive(this->m_TransceiverDescrArray[i].m_pLoraTransceiverItf, &ReceiveParams) == false)
     {
       // By design, should never occur
@@ -1487,6 +1650,164 @@ bool CLoraNodeManager_ProcessStop(CLoraNodeManager *this, CTransceiverManagerItf
   return true;
 }
 
+// Creates a downlink session for a LoRa packet provided by the Network Server
+// Note: The destination node is identified by the 'DevAddr' field of data packets. The 'Join Accept'
+//       packets are encrypted (i.e. no 'DevAddr'), they are sent in the RX windows of a 'Join Request'
+//       including the send time
+bool CLoraNodeManager_ProcessSendDownlink(CLoraNodeManager *this, CTransceiverManagerItf_SendDownlinkParams pParams)
+{
+  CLoraNodeManager_ProcessServerDownlinkReceivedParamsOb DownlinkReceivedParams;
+  BYTE usMessageType;
+
+  #if (LORANODEMANAGER_DEBUG_LEVEL0)
+    DEBUG_PRINT_LN("[INFO] Entering 'CLoraNodeManager_ProcessSendDownlink'");
+  #endif
+
+  pParams->m_dwResult = TRANSCEIVERMANAGER_SENDDOWNLINK_TOO_LATE;
+
+  // Downlink sessions are created only in 'RUNNING' automaton state
+  if (this->m_dwCurrentState != LORANODEMANAGER_AUTOMATON_STATE_RUNNING)
+  {
+    #if (LORANODEMANAGER_DEBUG_LEVEL0)
+      DEBUG_PRINT_LN("[WARNING] CLoraNodeManager_ProcessSendDownlink, downlink ignored (not running)");
+    #endif
+    return false;
+  }
+
+  // Supported messages:
+  //  - Data downlink (MHDR + DevAddr in clear)
+  //  - Join Accept (MHDR + 16 or 32 bytes encrypted, i.e. with or without 'CFList')
+  // Note: The size is checked before reading the MHDR
+  usMessageType = LORANODEMANAGER_MSG_TYPE_RFU;
+  if ((pParams->m_wPayloadSize != 0) && (pParams->m_wPayloadSize <= LORA_MAX_PAYLOAD_LENGTH))
+  {
+    usMessageType = LORANODEMANAGER_MSG_TYPE_BASE + (pParams->m_pPayload[0] >> 5);
+  }
+  if (((usMessageType == LORANODEMANAGER_MSG_TYPE_UNCONF_DOWNLINK) || (usMessageType == LORANODEMANAGER_MSG_TYPE_CONF_DOWNLINK)) ?
+      (pParams->m_wPayloadSize < 5) :
+      ((usMessageType != LORANODEMANAGER_MSG_TYPE_JOIN_ACCEPT) || ((pParams->m_wPayloadSize != 17) && (pParams->m_wPayloadSize != 33))))
+  {
+    #if (LORANODEMANAGER_DEBUG_LEVEL0)
+      DEBUG_PRINT("[WARNING] CLoraNodeManager_ProcessSendDownlink, unsupported downlink message, type: ");
+      DEBUG_PRINT_DEC((DWORD) usMessageType);
+      DEBUG_PRINT(", size: ");
+      DEBUG_PRINT_DEC((DWORD) pParams->m_wPayloadSize);
+      DEBUG_PRINT_CR;
+    #endif
+    return false;
+  }
+
+  // Radio settings requested by Network Server
+  if ((pParams->m_dwResult = CLoraNodeManager_GetServerRadio(this, pParams, &(DownlinkReceivedParams.m_ServerRadio))) != 
+      TRANSCEIVERMANAGER_SENDDOWNLINK_NONE)
+  {
+    #if (LORANODEMANAGER_DEBUG_LEVEL0)
+      DEBUG_PRINT("[WARNING] CLoraNodeManager_ProcessSendDownlink, unsupported radio settings, result: ");
+      DEBUG_PRINT_DEC(pParams->m_dwResult);
+      DEBUG_PRINT_CR;
+    #endif
+    return false;
+  }
+
+  DownlinkReceivedParams.m_dwSessionType = LORANODEMANAGER_DOWNSESSION_TYPE_DATA;
+  DownlinkReceivedParams.m_dwPayloadSize = pParams->m_wPayloadSize;
+  DownlinkReceivedParams.m_pPayload = pParams->m_pPayload;
+  DownlinkReceivedParams.m_bJoinAccept = usMessageType == LORANODEMANAGER_MSG_TYPE_JOIN_ACCEPT;
+  DownlinkReceivedParams.m_dwDeviceAddr = DownlinkReceivedParams.m_bJoinAccept == true ? 0 : *((DWORD *)(pParams->m_pPayload + 1));
+  DownlinkReceivedParams.m_pLoraTransceiverItf = NULL;
+  DownlinkReceivedParams.m_qwTimestamp = GATEWAY_CLOCK_MICROSEC();
+  DownlinkReceivedParams.m_bServerTiming = true;
+  DownlinkReceivedParams.m_bImmediate = pParams->m_bImmediate;
+  DownlinkReceivedParams.m_dwSendTimestamp = pParams->m_dwTimestamp;
+  DownlinkReceivedParams.m_dwResult = LORAREALTIMESENDER_SCHEDULESEND_TOO_LATE;
+
+  // Invoke the generic method for scheduling of a new downlink session
+  // Note: The 'TRANSCEIVERMANAGER_SENDDOWNLINK_xxx' codes have the same values as
+  //       'LORAREALTIMESENDER_SCHEDULESEND_xxx' codes
+  CLoraNodeManager_ProcessServerDownlinkReceived(this, &DownlinkReceivedParams);
+  pParams->m_dwResult = DownlinkReceivedParams.m_dwResult;
+
+  return pParams->m_dwResult == TRANSCEIVERMANAGER_SENDDOWNLINK_NONE;
+}
+
+// Converts the radio settings requested by the Network Server to 'LoraTransceiver' values
+// Returns a 'TRANSCEIVERMANAGER_SENDDOWNLINK_xxx' code:
+//  - 'TX_FREQ' if the frequency or modulation is not supported by the transceivers
+//  - 'TX_POWER' if the output power exceeds the maximum power level
+// Note: A zero value (i.e. not provided) is converted to 'NONE' (i.e. setting of the node RX window)
+DWORD CLoraNodeManager_GetServerRadio(CLoraNodeManager *this, CTransceiverManagerItf_SendDownlinkParams pParams,
+                                      CLoraRealtimeSenderItf_RadioParams pServerRadio)
+{
+  BYTE usChannel;
+
+  pServerRadio->m_usFreqChannel = LORATRANSCEIVERITF_FREQUENCY_CHANNEL_NONE;
+  pServerRadio->m_usSpreadingFactor = LORATRANSCEIVERITF_SF_NONE;
+  pServerRadio->m_usBandwidth = LORATRANSCEIVERITF_BANDWIDTH_NONE;
+  pServerRadio->m_usCodingRate = LORATRANSCEIVERITF_CR_NONE;
+  pServerRadio->m_usPowerLevel = LORATRANSCEIVERITF_POWER_LEVEL_NONE;
+
+  // Frequency: only predefined channels (kHz precision)
+  if (pParams->m_dwFrequency != 0)
+  {
+    for (usChannel = LORATRANSCEIVERITF_FREQUENCY_CHANNEL_18; usChannel != LORATRANSCEIVERITF_FREQUENCY_CHANNEL_NONE; usChannel--)
+    {
+      if ((g_dwLoraNodeManagerChannelFreq[usChannel] != 0) && 
+          (g_dwLoraNodeManagerChannelFreq[usChannel] * 1000 == pParams->m_dwFrequency))
+      {
+        break;
+      }
+    }
+    if (usChannel == LORATRANSCEIVERITF_FREQUENCY_CHANNEL_NONE)
+    {
+      return TRANSCEIVERMANAGER_SENDDOWNLINK_TX_FREQ;
+    }
+    pServerRadio->m_usFreqChannel = usChannel;
+  }
+
+  // Modulation
+  if (pParams->m_usSpreadingFactor != 0)
+  {
+    if ((pParams->m_usSpreadingFactor < LORATRANSCEIVERITF_SF_7) || (pParams->m_usSpreadingFactor > LORATRANSCEIVERITF_SF_12))
+    {
+      return TRANSCEIVERMANAGER_SENDDOWNLINK_TX_FREQ;
+    }
+    pServerRadio->m_usSpreadingFactor = pParams->m_usSpreadingFactor;
+  }
+  switch (pParams->m_wBandwidth)
+  {
+    case 0:
+      break;
+    case 125:
+      pServerRadio->m_usBandwidth = LORATRANSCEIVERITF_BANDWIDTH_125;
+      break;
+    case 250:
+      pServerRadio->m_usBandwidth = LORATRANSCEIVERITF_BANDWIDTH_250;
+      break;
+    case 500:
+      pServerRadio->m_usBandwidth = LORATRANSCEIVERITF_BANDWIDTH_500;
+      break;
+    default:
+      return TRANSCEIVERMANAGER_SENDDOWNLINK_TX_FREQ;
+  }
+  if (pParams->m_usCodingRate != 0)
+  {
+    if ((pParams->m_usCodingRate < 5) || (pParams->m_usCodingRate > 8))
+    {
+      return TRANSCEIVERMANAGER_SENDDOWNLINK_TX_FREQ;
+    }
+    pServerRadio->m_usCodingRate = LORATRANSCEIVERITF_CR_5 + (pParams->m_usCodingRate - 5);
+  }
+
+  // Output power (i.e. power level of transceiver in dBm)
+  if (pParams->m_usPower > LORATRANSCEIVERITF_POWER_LEVEL_MAX)
+  {
+    return TRANSCEIVERMANAGER_SENDDOWNLINK_TX_POWER;
+  }
+  pServerRadio->m_usPowerLevel = pParams->m_usPower;
+
+  return TRANSCEIVERMANAGER_SENDDOWNLINK_NONE;
+}
+
 
 /*********************************************************************************************
   Private methods (implementation)
@@ -1502,8 +1823,7 @@ bool CLoraNodeManager_ProcessStop(CLoraNodeManager *this, CTransceiverManagerItf
 *********************************************************************************************/
 
 // The 'ServerManager' has copied the 'CLoraPacket' and 'CLoraPacketSession' references
-// The exchange buffer used for notification can be released (i.e. allows notification of 
-// next uplink LoRa packet)
+// The exchange object used for notification is no more used
 void CLoraNodeManager_ProcessSessionEventUplinkAccepted(CLoraNodeManager *this, 
                                                         CTransceiverManagerItf_SessionEvent pEvent)
 {
@@ -1517,15 +1837,14 @@ void CLoraNodeManager_ProcessSessionEventUplinkAccepted(CLoraNodeManager *this,
   // Access Session
   pLoraPacketSession = (CLoraPacketSession) pEvent->m_pSession;
 
-  // Make sure that message is for the last packet transmitted to 'ServerManager' and allow
-  // next transmission (i.e. exchange buffer for only one 'LoraPacket')
-  if (this->m_ForwardedUplinkPacket.m_pSession == pLoraPacketSession)
+  // Make sure that message is for the packet transmitted with the session
+  if (pLoraPacketSession->m_ForwardedPacket.m_dwSessionId == pEvent->m_dwSessionId)
   {
-    this->m_ForwardedUplinkPacket.m_pLoraPacket = NULL;
+    pLoraPacketSession->m_ForwardedPacket.m_pLoraPacket = NULL;
   }
   else
   {
-    // By design shoud never occur (i.e. events are serialized)
+    // By design shoud never occur (i.e. session alive until end of uplink processing)
     #if (LORANODEMANAGER_DEBUG_LEVEL0)
       DEBUG_PRINT_LN("[ERROR] CLoraNodeManager_ProcessSessionEventUplinkAccepted - Wrong session");
     #endif
@@ -1533,7 +1852,7 @@ void CLoraNodeManager_ProcessSessionEventUplinkAccepted(CLoraNodeManager *this,
 }
 
 // The 'ServerManager' cannot process the 'CLoraPacket' (typically message queue full)
-// Release the exchange buffer used for notification and destroy the 'CLoraPacketSession'
+// Release the exchange object used for notification and destroy the 'CLoraPacketSession'
 void CLoraNodeManager_ProcessSessionEventUplinkRejected(CLoraNodeManager *this, 
                                                         CTransceiverManagerItf_SessionEvent pEvent)
 {
@@ -1548,15 +1867,14 @@ void CLoraNodeManager_ProcessSessionEventUplinkRejected(CLoraNodeManager *this,
   // Access Session
   pLoraPacketSession = (CLoraPacketSession) pEvent->m_pSession;
 
-  // Step 1: Make sure that message is for the last packet transmitted to 'ServerManager' and allow
-  //         next transmission (i.e. exchange buffer for only one 'LoraPacket')
-  if (this->m_ForwardedUplinkPacket.m_pSession == pLoraPacketSession)
+  // Step 1: Make sure that message is for the packet transmitted with the session
+  if (pLoraPacketSession->m_ForwardedPacket.m_dwSessionId == pEvent->m_dwSessionId)
   {
-    this->m_ForwardedUplinkPacket.m_pLoraPacket = NULL;
+    pLoraPacketSession->m_ForwardedPacket.m_pLoraPacket = NULL;
   }
   else
   {
-    // By design shoud never occur (i.e. events are serialized)
+    // By design shoud never occur (i.e. session alive until end of uplink processing)
     #if (LORANODEMANAGER_DEBUG_LEVEL0)
       DEBUG_PRINT_LN("[ERROR] CLoraNodeManager_ProcessSessionEventUplinkRejected - Wrong session");
     #endif
@@ -1567,15 +1885,15 @@ void CLoraNodeManager_ProcessSessionEventUplinkRejected(CLoraNodeManager *this,
   // By design the 'REJECTED' event occurs before session has expired
   // Check for consistency
 
-  pSessionCheck = (CLoraPacketSession) CMemoryBlockArray_BlockPtrFromIndex(this->m_pLoraPacketSessionArray, 
-                                         pLoraPacketSession->m_LoraSessionEntry.m_usBlockIndex);
+  pSessionCheck = (CLoraPacketSession) CWideMemoryBlockArray_BlockPtrFromIndex(this->m_pLoraPacketSessionArray, 
+                                         pLoraPacketSession->m_LoraSessionEntry.m_wBlockIndex);
 
   if (pSessionCheck->m_dwSessionId == pLoraPacketSession->m_dwSessionId)
   {
     // MemoryBlock still associated to the session, make sure it is valid (i.e. the 'ready'
     // flag is set only when session is alive)
-    if (CMemoryBlockArray_IsBlockReady(this->m_pLoraPacketSessionArray, 
-        pLoraPacketSession->m_LoraSessionEntry.m_usBlockIndex) == true)
+    if (CWideMemoryBlockArray_IsBlockReady(this->m_pLoraPacketSessionArray, 
+        pLoraPacketSession->m_LoraSessionEntry.m_wBlockIndex) == true)
     {
       #if (LORANODEMANAGER_DEBUG_LEVEL0)
         DEBUG_PRINT("[INFO] CLoraNodeManager_ProcessSessionEventUplinkRejected, LoraPacketSession destroying session, SessionId: ");
@@ -1585,7 +1903,7 @@ void CLoraNodeManager_ProcessSessionEventUplinkRejected(CLoraNodeManager *this,
 
       if (pLoraPacketSession->m_LoraPacketEntry.m_pDataBlock != NULL)
       {
-        CMemoryBlockArray_ReleaseBlock(this->m_pLoraPacketArray, pLoraPacketSession->m_LoraPacketEntry.m_usBlockIndex);
+        CWideMemoryBlockArray_ReleaseRef(this->m_pLoraPacketArray, pLoraPacketSession->m_LoraPacketEntry.m_wBlockIndex);
 
         #if (LORANODEMANAGER_DEBUG_LEVEL2)
           DEBUG_PRINT_LN("[DEBUG] CLoraNodeManager_ProcessSessionEventUplinkRejected, LoraPacket destroyed");
@@ -1593,7 +1911,7 @@ void CLoraNodeManager_ProcessSessionEventUplinkRejected(CLoraNodeManager *this,
       }
 
       // Destroy 'CLoraPacketSession'
-      CMemoryBlockArray_ReleaseBlock(this->m_pLoraPacketSessionArray, pLoraPacketSession->m_LoraSessionEntry.m_usBlockIndex);
+      CWideMemoryBlockArray_ReleaseBlock(this->m_pLoraPacketSessionArray, pLoraPacketSession->m_LoraSessionEntry.m_wBlockIndex);
 
       #if (LORANODEMANAGER_DEBUG_LEVEL2)
         DEBUG_PRINT_LN("[DEBUG] CLoraNodeManager_ProcessSessionEventUplinkRejected, LoraPacketSession destroyed");
@@ -1635,15 +1953,15 @@ void CLoraNodeManager_ProcessSessionEventUplinkProgressing(CLoraNodeManager *thi
   // The preparation of Network Server message with 'CLoraPacket' may take a significant duration
   // Normally, the session is still alive but it is necessary to check
 
-  pSessionCheck = (CLoraPacketSession) CMemoryBlockArray_BlockPtrFromIndex(this->m_pLoraPacketSessionArray, 
-                                         pLoraPacketSession->m_LoraSessionEntry.m_usBlockIndex);
+  pSessionCheck = (CLoraPacketSession) CWideMemoryBlockArray_BlockPtrFromIndex(this->m_pLoraPacketSessionArray, 
+                                         pLoraPacketSession->m_LoraSessionEntry.m_wBlockIndex);
 
   if (pSessionCheck->m_dwSessionId == pLoraPacketSession->m_dwSessionId)
   {
     // MemoryBlock still associated to the session, make sure it is valid (i.e. the 'ready'
     // flag is set only when session is alive)
-    if (CMemoryBlockArray_IsBlockReady(this->m_pLoraPacketSessionArray, 
-        pLoraPacketSession->m_LoraSessionEntry.m_usBlockIndex) == true)
+    if (CWideMemoryBlockArray_IsBlockReady(this->m_pLoraPacketSessionArray, 
+        pLoraPacketSession->m_LoraSessionEntry.m_wBlockIndex) == true)
     {
       #if (LORANODEMANAGER_DEBUG_LEVEL0)
         DEBUG_PRINT("[INFO] CLoraNodeManager_ProcessSessionEventUplinkProgressing, LoraPacketSession releasing LoRa packet, SessionId: ");
@@ -1653,7 +1971,7 @@ void CLoraNodeManager_ProcessSessionEventUplinkProgressing(CLoraNodeManager *thi
 
       if (pLoraPacketSession->m_LoraPacketEntry.m_pDataBlock != NULL)
       {
-        CMemoryBlockArray_ReleaseBlock(this->m_pLoraPacketArray, pLoraPacketSession->m_LoraPacketEntry.m_usBlockIndex);
+        CWideMemoryBlockArray_ReleaseRef(this->m_pLoraPacketArray, pLoraPacketSession->m_LoraPacketEntry.m_wBlockIndex);
         pLoraPacketSession->m_LoraPacketEntry.m_pDataBlock = NULL;
 
         #if (LORANODEMANAGER_DEBUG_LEVEL2)
@@ -1720,8 +2038,8 @@ void CLoraNodeManager_ProcessSessionEventUplinkSent(CLoraNodeManager *this,
   {
     // MemoryBlock still associated to the session, make sure it is valid (i.e. the 'ready'
     // flag is set only when session is alive)
-    if (CMemoryBlockArray_IsBlockReady(this->m_pLoraPacketSessionArray, 
-        pLoraPacketSession->m_LoraSessionEntry.m_usBlockIndex) == true)
+    if (CWideMemoryBlockArray_IsBlockReady(this->m_pLoraPacketSessionArray, 
+        pLoraPacketSession->m_LoraSessionEntry.m_wBlockIndex) == true)
     {
       // The session is alive
       bSessionAlive = true;
@@ -1772,7 +2090,12 @@ void CLoraNodeManager_ProcessSessionEventUplinkSent(CLoraNodeManager *this,
       DownlinkReceivedParams.m_pPayload = usAckPayload;
       DownlinkReceivedParams.m_dwDeviceAddr = pLoraPacketSession->m_dwDeviceAddr;
       DownlinkReceivedParams.m_pLoraTransceiverItf = pLoraPacketSession->m_pLoraTransceiverItf;
-      DownlinkReceivedParams.m_dwTimestamp = xTaskGetTickCount() * portTICK_RATE_MS;
+      DownlinkReceivedParams.m_qwTimestamp = GATEWAY_CLOCK_MICROSEC();
+      DownlinkReceivedParams.m_bServerTiming = false;
+      DownlinkReceivedParams.m_bImmediate = false;
+      DownlinkReceivedParams.m_dwSendTimestamp = 0;
+      DownlinkReceivedParams.m_bJoinAccept = false;
+      memset(&(DownlinkReceivedParams.m_ServerRadio), 0, sizeof(DownlinkReceivedParams.m_ServerRadio));
 
       // Invoke the generic method for scheduling of a new downlink session
       if (CLoraNodeManager_ProcessServerDownlinkReceived(this, &DownlinkReceivedParams) == true)
@@ -1831,8 +2154,8 @@ void CLoraNodeManager_ProcessSessionEventUplinkFailed(CLoraNodeManager *this,
   {
     // MemoryBlock still associated to the session, make sure it is valid (i.e. the 'ready'
     // flag is set only when session is alive)
-    if (CMemoryBlockArray_IsBlockReady(this->m_pLoraPacketSessionArray, 
-        pLoraPacketSession->m_LoraSessionEntry.m_usBlockIndex) == true)
+    if (CWideMemoryBlockArray_IsBlockReady(this->m_pLoraPacketSessionArray, 
+        pLoraPacketSession->m_LoraSessionEntry.m_wBlockIndex) == true)
     {
       // The session is alive, update state in 'LoraPacketSession' object
       // Note: The 'NodeManager' main automaton will terminate the session immediatly (i.e. if the uplink 
@@ -1893,15 +2216,15 @@ void CLoraNodeManager_ProcessSessionEventDownlinkScheduled(CLoraNodeManager *thi
   pLoraPacketSession = (CLoraDownPacketSession) pEvent->m_pSession;
 
   // Normally, the session is still alive but it is necessary to check
-  pSessionCheck = (CLoraDownPacketSession) CMemoryBlockArray_BlockPtrFromIndex(this->m_pLoraDownPacketSessionArray, 
-                                            pLoraPacketSession->m_LoraSessionEntry.m_usBlockIndex);
+  pSessionCheck = (CLoraDownPacketSession) CWideMemoryBlockArray_BlockPtrFromIndex(this->m_pLoraDownPacketSessionArray, 
+                                            pLoraPacketSession->m_LoraSessionEntry.m_wBlockIndex);
                     
   if (pSessionCheck->m_dwSessionId == pLoraPacketSession->m_dwSessionId)
   {
     // MemoryBlock still associated to the session, make sure it is valid (i.e. the 'ready'
     // flag is set only when session is alive)
-    if (CMemoryBlockArray_IsBlockReady(this->m_pLoraDownPacketSessionArray, 
-        pLoraPacketSession->m_LoraSessionEntry.m_usBlockIndex) == true)
+    if (CWideMemoryBlockArray_IsBlockReady(this->m_pLoraDownPacketSessionArray, 
+        pLoraPacketSession->m_LoraSessionEntry.m_wBlockIndex) == true)
     {
 
       // Check if a notification may be required by Network Server protocol
@@ -1941,15 +2264,15 @@ void CLoraNodeManager_ProcessSessionEventDownlinkSending(CLoraNodeManager *this,
   pLoraPacketSession = (CLoraDownPacketSession) pEvent->m_pSession;
 
   // Normally, the session is still alive but it is necessary to check
-  pSessionCheck = (CLoraDownPacketSession) CMemoryBlockArray_BlockPtrFromIndex(this->m_pLoraDownPacketSessionArray, 
-                                            pLoraPacketSession->m_LoraSessionEntry.m_usBlockIndex);
+  pSessionCheck = (CLoraDownPacketSession) CWideMemoryBlockArray_BlockPtrFromIndex(this->m_pLoraDownPacketSessionArray, 
+                                            pLoraPacketSession->m_LoraSessionEntry.m_wBlockIndex);
                     
   if (pSessionCheck->m_dwSessionId == pLoraPacketSession->m_dwSessionId)
   {
     // MemoryBlock still associated to the session, make sure it is valid (i.e. the 'ready'
     // flag is set only when session is alive)
-    if (CMemoryBlockArray_IsBlockReady(this->m_pLoraDownPacketSessionArray, 
-        pLoraPacketSession->m_LoraSessionEntry.m_usBlockIndex) == true)
+    if (CWideMemoryBlockArray_IsBlockReady(this->m_pLoraDownPacketSessionArray, 
+        pLoraPacketSession->m_LoraSessionEntry.m_wBlockIndex) == true)
     {
       // Adjust session state
       pLoraPacketSession->m_dwSessionState = LORANODEMANAGER_DOWNSESSION_STATE_SENDING;
@@ -1979,15 +2302,15 @@ void CLoraNodeManager_ProcessSessionEventDownlinkSent(CLoraNodeManager *this,
   pLoraPacketSession = (CLoraDownPacketSession) pEvent->m_pSession;
 
   // Normally, the session is still alive but it is necessary to check
-  pSessionCheck = (CLoraDownPacketSession) CMemoryBlockArray_BlockPtrFromIndex(this->m_pLoraDownPacketSessionArray, 
-                                            pLoraPacketSession->m_LoraSessionEntry.m_usBlockIndex);
+  pSessionCheck = (CLoraDownPacketSession) CWideMemoryBlockArray_BlockPtrFromIndex(this->m_pLoraDownPacketSessionArray, 
+                                            pLoraPacketSession->m_LoraSessionEntry.m_wBlockIndex);
  
   if (pSessionCheck->m_dwSessionId == pLoraPacketSession->m_dwSessionId)
   {
     // MemoryBlock still associated to the session, make sure it is valid (i.e. the 'ready'
     // flag is set only when session is alive)
-    if (CMemoryBlockArray_IsBlockReady(this->m_pLoraDownPacketSessionArray, 
-        pLoraPacketSession->m_LoraSessionEntry.m_usBlockIndex) == true)
+    if (CWideMemoryBlockArray_IsBlockReady(this->m_pLoraDownPacketSessionArray, 
+        pLoraPacketSession->m_LoraSessionEntry.m_wBlockIndex) == true)
     {
       // Release the 'CLoraDownPacketSession' object
       CLoraNodeManager_ReleaseDownlinkSession(this, pLoraPacketSession);
@@ -2028,15 +2351,15 @@ void CLoraNodeManager_ProcessSessionEventDownlinkFailed(CLoraNodeManager *this,
   pLoraPacketSession = (CLoraDownPacketSession) pEvent->m_pSession;
 
   // Normally, the session is still alive but it is necessary to check
-  pSessionCheck = (CLoraDownPacketSession) CMemoryBlockArray_BlockPtrFromIndex(this->m_pLoraDownPacketSessionArray, 
-                                            pLoraPacketSession->m_LoraSessionEntry.m_usBlockIndex);
+  pSessionCheck = (CLoraDownPacketSession) CWideMemoryBlockArray_BlockPtrFromIndex(this->m_pLoraDownPacketSessionArray, 
+                                            pLoraPacketSession->m_LoraSessionEntry.m_wBlockIndex);
                     
   if (pSessionCheck->m_dwSessionId == pLoraPacketSession->m_dwSessionId)
   {
     // MemoryBlock still associated to the session, make sure it is valid (i.e. the 'ready'
     // flag is set only when session is alive)
-    if (CMemoryBlockArray_IsBlockReady(this->m_pLoraDownPacketSessionArray, 
-        pLoraPacketSession->m_LoraSessionEntry.m_usBlockIndex) == true)
+    if (CWideMemoryBlockArray_IsBlockReady(this->m_pLoraDownPacketSessionArray, 
+        pLoraPacketSession->m_LoraSessionEntry.m_wBlockIndex) == true)
     {
       // Check if a notification may be required by Network Server protocol
       if ((dwErrorCode != LORAREALTIMESENDER_SCHEDULESEND_NONE) &&
@@ -2078,17 +2401,122 @@ void CLoraNodeManager_ProcessSessionEventDownlinkFailed(CLoraNodeManager *this,
 *********************************************************************************************/
 
 
-bool CLoraNodeManager_ProcessTransceiverUplinkReceived(CLoraNodeManager *this, CLoraTransceiverItf_Event pEvent)
+// Note: A 'PACKETRECEIVED' event without 'LoraTransceiver' (i.e. 'm_pLoraTransceiverItf' is NULL) is
+//       posted when uplink queue has space again. The receive rings of all 'LoraTransceivers' are
+//       processed (i.e. packets left in rings by backpressure)
+bool CLoraNodeManager_ProcessTransceiverReceiveRing(CLoraNodeManager *this, CLoraTransceiverItf_Event pEvent)
 {
-  CMemoryBlockArrayEntryOb MemBlockEntry;
-  BYTE *pMemBlock;
+  if (pEvent->m_pLoraTransceiverItf == NULL)
+  {
+    for (BYTE i = 0; i < this->m_usTransceiverNumber; i++)
+    {
+      if (CLoraNodeManager_ProcessReceiveRing(this, &(this->m_TransceiverDescrArray[i])) == false)
+      {
+        // Uplink queue full again
+        break;
+      }
+    }
+    return true;
+  }
+
+  // Retrieve the receive ring of 'LoraTransceiver'
+  for (BYTE i = 0; i < this->m_usTransceiverNumber; i++)
+  {
+    if (this->m_TransceiverDescrArray[i].m_pLoraTransceiverItf == pEvent->m_pLoraTransceiverItf)
+    {
+      CLoraNodeManager_ProcessReceiveRing(this, &(this->m_TransceiverDescrArray[i]));
+      return true;
+    }
+  }
+
+  // Should never occur
+  #if (LORANODEMANAGER_DEBUG_LEVEL0)
+    DEBUG_PRINT_LN("[ERROR] CLoraNodeManager_ProcessTransceiverReceiveRing: Unknown LoraTransceiver");
+  #endif
+  return false;
+}
+
+// Processes the packets waiting in the receive ring of a 'LoraTransceiver'
+// Returns false if processing is stopped because the uplink queue is full (backpressure)
+bool CLoraNodeManager_ProcessReceiveRing(CLoraNodeManager *this, CTransceiverDescr pTransceiverDescr)
+{
+  CSpscRing pReceiveRing = pTransceiverDescr->m_pReceiveRing;
+  CLoraTransceiverItf_ReceiveSlot pReceiveSlot;
+  CLoraTransceiverItf_ReceivedLoraPacketInfoOb PacketInfo;
+  CLoraTransceiverItf_EventOb PacketEvent;
+
+  // Process all packets waiting in the ring
+  // Note: The event may find an empty ring (i.e. packets already processed with previous event)
+  PacketEvent.m_wEventType = LORATRANSCEIVERITF_EVENT_PACKETRECEIVED;
+  PacketEvent.m_pLoraTransceiverItf = pTransceiverDescr->m_pLoraTransceiverItf;
+  while ((pReceiveSlot = (CLoraTransceiverItf_ReceiveSlot) CSpscRing_GetReadSlot(pReceiveRing)) != NULL)
+  {
+    // Backpressure: the packet is left in the receive ring if the uplink queue of 'ServerManager' is full
+    // The 'LoraTransceiver' drops the next received packets when its ring is full (i.e. loss counted
+    // at the radio). The rings are processed again when the 'ServerManager' frees space in the queue
+    if ((this->m_pUplinkQueue != NULL) && (CMpscRing_HasSpace(this->m_pUplinkQueue) == false))
+    {
+      #if (LORANODEMANAGER_DEBUG_LEVEL1)
+        DEBUG_PRINT("[WARNING] CLoraNodeManager_ProcessReceiveRing: uplink queue full, packets waiting in ring: ");
+        DEBUG_PRINT_DEC((unsigned int) CSpscRing_GetOccupancy(pReceiveRing));
+        DEBUG_PRINT_CR;
+      #endif
+      return false;
+    }
+
+    // Free the slot before processing (i.e. the reference on packet block is now owned by 'LoraNodeManager')
+    PacketEvent.m_pEventData = pReceiveSlot->m_pPacket;
+    memcpy(&PacketInfo, &pReceiveSlot->m_PacketInfo, sizeof(CLoraTransceiverItf_ReceivedLoraPacketInfoOb));
+    CSpscRing_ReleaseRead(pReceiveRing);
+
+    CTaskPlacement_RecordLatency(TASKPLACEMENT_TASK_NODEMANAGER_TRANSCEIVER,
+                                 ((CLoraTransceiverItf_LoraPacket) PacketEvent.m_pEventData)->m_qwTimestamp);
+    CLoraNodeManager_ProcessTransceiverUplinkReceived(this, &PacketEvent, &PacketInfo);
+  }
+
+  #if (LORANODEMANAGER_DEBUG_LEVEL2)
+    DEBUG_PRINT("[DEBUG] CLoraNodeManager_ProcessReceiveRing: high watermark: ");
+    DEBUG_PRINT_DEC((unsigned int) CSpscRing_GetHighWatermark(pReceiveRing));
+    DEBUG_PRINT(", dropped: ");
+    DEBUG_PRINT_DEC((unsigned int) CSpscRing_GetDroppedNumber(pReceiveRing));
+    DEBUG_PRINT_CR;
+  #endif
+
+  return true;
+}
+
+// Callback of uplink queue (invoked by 'ServerManager' task when space is freed in a full queue)
+// Resumes the processing of receive rings in Transceiver task
+void CLoraNodeManager_UplinkQueueSpaceAvailable(void *pContext)
+{
+  CLoraNodeManager *this = (CLoraNodeManager *) pContext;
+  CLoraTransceiverItf_EventOb QueueMessage;
+
+  QueueMessage.m_wEventType = LORATRANSCEIVERITF_EVENT_PACKETRECEIVED;
+  QueueMessage.m_pLoraTransceiverItf = NULL;
+  QueueMessage.m_pEventData = NULL;
+
+  if (xQueueSend(this->m_hTransceiverNotifQueue, &QueueMessage, 0) != pdPASS)
+  {
+    // The queue is full of events, the rings will be processed anyway
+    #if (LORANODEMANAGER_DEBUG_LEVEL0)
+      DEBUG_PRINT_LN("[WARNING] CLoraNodeManager_UplinkQueueSpaceAvailable: Transceiver queue full");
+    #endif
+  }
+}
+
+bool CLoraNodeManager_ProcessTransceiverUplinkReceived(CLoraNodeManager *this, CLoraTransceiverItf_Event pEvent,
+                                                       CLoraTransceiverItf_ReceivedLoraPacketInfo pPacketInfo)
+{
+  CWideMemoryBlockArrayEntryOb MemBlockEntry;
   CLoraTransceiverItf_LoraPacket pReceivedPacket;
   CLoraPacketSession pLoraPacketSession;
   BYTE *pPayload;
-  CLoraTransceiverItf_GetReceivedPacketInfoParamsOb PacketInfoParams;
   CLoraRealtimeSenderItf_RegisterNodeRxWindowsParamsOb RegisterWindowsParams;
 
   // Received packet
+  // Note: The packet is received by the 'LoraTransceiver' in a shared packet buffer of
+  //       'm_pLoraPacketArray' and the reference on this block is now owned by 'LoraNodeManager'
   pReceivedPacket = (CLoraTransceiverItf_LoraPacket) (pEvent->m_pEventData);
 
   // New uplink 'LoraPacket' allowed only in 'RUNNING' automaton state
@@ -2100,14 +2528,15 @@ bool CLoraNodeManager_ProcessTransceiverUplinkReceived(CLoraNodeManager *this, C
       DEBUG_PRINT_CR;
     #endif
 
-    // Release packet in source 'LoraTransceiver' (i.e.set packet read semaphore)
-    pReceivedPacket->m_dwDataSize = 0;
+    // Release packet buffer
+    CWideMemoryBlockArray_ReleaseRef(this->m_pLoraPacketArray, 
+      CWideMemoryBlockArray_BlockIndexFromPtr(this->m_pLoraPacketArray, pReceivedPacket));
     return false;
   }
 
   // Step 1 - Obtain a 'MemoryBlock' to store the new 'LoraSession' associated with this uplink packet
 
-  if ((pLoraPacketSession = CMemoryBlockArray_GetBlock(this->m_pLoraPacketSessionArray, &MemBlockEntry)) == NULL)
+  if ((pLoraPacketSession = CWideMemoryBlockArray_GetBlock(this->m_pLoraPacketSessionArray, &MemBlockEntry)) == NULL)
   {
     // Should never occur. Buffer for 'LoraPacketSession'exhausted
     // Note: No recovery mechanism = for stress test in current version
@@ -2116,136 +2545,121 @@ bool CLoraNodeManager_ProcessTransceiverUplinkReceived(CLoraNodeManager *this, C
       this->m_dwCurrentState = LORANODEMANAGER_AUTOMATON_STATE_ERROR;
     #endif
 
-    // Release packet in source 'LoraTransceiver' (i.e.set packet read semaphore)
-    pReceivedPacket->m_dwDataSize = 0;
+    // Release packet buffer
+    CWideMemoryBlockArray_ReleaseRef(this->m_pLoraPacketArray, 
+      CWideMemoryBlockArray_BlockIndexFromPtr(this->m_pLoraPacketArray, pReceivedPacket));
     return false;
   }
 
   #if (LORANODEMANAGER_DEBUG_LEVEL2)
     DEBUG_PRINT("[DEBUG] CLoraNodeManager_ProcessTransceiverUplinkReceived: LoraPacketSession MemBlock, index: ");
-    DEBUG_PRINT_HEX((unsigned int) MemBlockEntry.m_usBlockIndex);
+    DEBUG_PRINT_HEX((unsigned int) MemBlockEntry.m_wBlockIndex);
     DEBUG_PRINT(", ptr: ");
-    DEBUG_PRINT_HEX((unsigned int) MemBlockEntry.m_pDataBlock);
+    DEBUG_PRINT_PTR(MemBlockEntry.m_pDataBlock);
     DEBUG_PRINT_CR;
   #endif
 
   pLoraPacketSession->m_LoraSessionEntry.m_pDataBlock = MemBlockEntry.m_pDataBlock;
-  pLoraPacketSession->m_LoraSessionEntry.m_usBlockIndex = MemBlockEntry.m_usBlockIndex;
+  pLoraPacketSession->m_LoraSessionEntry.m_wBlockIndex = MemBlockEntry.m_wBlockIndex;
   pLoraPacketSession->m_dwSessionState = LORANODEMANAGER_SESSION_STATE_CREATED;
   pLoraPacketSession->m_dwSessionId = ++this->m_dwLastUpSessionId;
   pLoraPacketSession->m_pLoraTransceiverItf = pEvent->m_pLoraTransceiverItf;
 
-  // Step 2 - Store the 'CLoraPacket' in 'MemoryBlock' buffer
-  //          This will allow to the 'LoraTransceiver' to receive a new packet
-
-  if ((pMemBlock = CMemoryBlockArray_GetBlock(this->m_pLoraPacketArray, &(pLoraPacketSession->m_LoraPacketEntry))) == NULL)
-  {
-    // Should never occur. Buffer for 'LoraPacket' exhausted
-    // Note: No recovery mechanism = for stress test in current version
-    #if (LORANODEMANAGER_DEBUG_LEVEL0)
-      DEBUG_PRINT_LN("[ERROR] LoraPacket buffer exhausted. Entering 'ERROR' state");
-      this->m_dwCurrentState = LORANODEMANAGER_AUTOMATON_STATE_ERROR;
-    #endif
-
-    // Release packet in source 'LoraTransceiver' (i.e.set packet read semaphore)
-    pReceivedPacket->m_dwDataSize = 0;
+  // Step 2 - Attach the received 'CLoraPacket' to the session
+  //          The session owns the reference on the shared packet buffer (i.e. no copy)
 
-    // Release 'MemoryBlock' of 'LoraPacketSession'
-    CMemoryBlockArray_ReleaseBlock(this->m_pLoraPacketSessionArray, pLoraPacketSession->m_LoraSessionEntry.m_usBlockIndex);
-
-    #if (LORANODEMANAGER_DEBUG_LEVEL2)
-      DEBUG_PRINT_LN("[DEBUG] CLoraNodeManager_ProcessTransceiverUplinkReceived, LoraPacketSession destroyed");
-    #endif
-
-    return false;
-  }
+  pLoraPacketSession->m_LoraPacketEntry.m_pDataBlock = (BYTE *) pReceivedPacket;
+  pLoraPacketSession->m_LoraPacketEntry.m_wBlockIndex = 
+    CWideMemoryBlockArray_BlockIndexFromPtr(this->m_pLoraPacketArray, pReceivedPacket);
 
   #if (LORANODEMANAGER_DEBUG_LEVEL2)
     DEBUG_PRINT("[DEBUG] CLoraNodeManager_ProcessTransceiverUplinkReceived: LoraPacket MemBlock, index: ");
-    DEBUG_PRINT_HEX((unsigned int) pLoraPacketSession->m_LoraPacketEntry.m_usBlockIndex);
+    DEBUG_PRINT_HEX((unsigned int) pLoraPacketSession->m_LoraPacketEntry.m_wBlockIndex);
     DEBUG_PRINT(", ptr: ");
-    DEBUG_PRINT_HEX((unsigned int) pLoraPacketSession->m_LoraPacketEntry.m_pDataBlock);
+    DEBUG_PRINT_PTR(pLoraPacketSession->m_LoraPacketEntry.m_pDataBlock);
     DEBUG_PRINT_CR;
   #endif
 
-
-  #if (LORANODEMANAGER_DEBUG_LEVEL2)
-    DEBUG_PRINT_LN("[DEBUG] CLoraNodeManager_ProcessTransceiverUplinkReceived: Copying packet to MemBlock");
-  #endif
-
-  memcpy(pMemBlock, pReceivedPacket, sizeof(CLoraTransceiverItf_LoraPacketOb) + LORA_MAX_PAYLOAD_LENGTH - 1);
-
-  // Retrieve addtional information for received packet (SNR, RSSI...)
-  PacketInfoParams.m_pPacketInfo = &pLoraPacketSession->m_ReceivedPacketInfo;
-  ILoraTransceiver_GetReceivedPacketInfo(pLoraPacketSession->m_pLoraTransceiverItf, &PacketInfoParams);
+  // Addtional information for received packet (SNR, RSSI...) stored with packet in receive ring
+  memcpy(&pLoraPacketSession->m_ReceivedPacketInfo, pPacketInfo, sizeof(CLoraTransceiverItf_ReceivedLoraPacketInfoOb));
                   
-  // Release packet in source 'LoraTransceiver' (i.e.set packet read semaphore)
-  // Note: From now, use 'ReceivedPacket' copy in MemoryBlock
-  pReceivedPacket->m_dwDataSize = 0;
-  pReceivedPacket = (CLoraTransceiverItf_LoraPacket) pMemBlock;
-
   // Store some properties of 'LoraPacket' in 'LoraPacketSession' (i.e. required to manage session life cycle later)
-  pLoraPacketSession->m_dwTimestamp = ((CLoraTransceiverItf_LoraPacket) pMemBlock)->m_dwTimestamp;
-  pPayload = (BYTE *) &(((CLoraTransceiverItf_LoraPacket) pMemBlock)->m_usData);
+  pLoraPacketSession->m_qwTimestamp = pReceivedPacket->m_qwTimestamp;
+  pPayload = (BYTE *) &(pReceivedPacket->m_usData);
   pLoraPacketSession->m_usMHDR = *pPayload;
   pLoraPacketSession->m_usMessageType = LORANODEMANAGER_MSG_TYPE_BASE + (*pPayload >> 5);
   pLoraPacketSession->m_dwDeviceAddr = *((DWORD *)(pPayload + 1));
   pLoraPacketSession->m_dwFrameCounter = *((WORD *)(pPayload + 6));
   
   #if (LORANODEMANAGER_DEBUG_LEVEL2)
-    DEBUG_PRINT("[DEBUG] CLoraNodeManager_ProcessTransceiverUplinkReceived: Packet session created, SessionId: ");
-    DEBUG_PRINT_HEX(pLoraPacketSession->m_dwSessionId);
-    DEBUG_PRINT(", Timestamp: ");
-    DEBUG_PRINT_HEX(pLoraPacketSession->m_dwTimestamp);
-    DEBUG_PRINT(", DeviceAddr: ");
-    DEBUG_PRINT_HEX(pLoraPacketSession->m_dwDeviceAddr);
-    DEBUG_PRINT(", FrameCounter: ");
-    DEBUG_PRINT_HEX(pLoraPacketSession->m_dwFrameCounter);
-    DEBUG_PRINT(", MessageType: ");
-    DEBUG_PRINT_HEX((DWORD) pLoraPacketSession->m_usMessageType);
-    DEBUG_PRINT(", Packet length: ");
-    DEBUG_PRINT_HEX(pReceivedPacket->m_dwDataSize);
-    DEBUG_PRINT_CR;
+    TRACERING_EVENT(TRACERING_ID_NODEMANAGER_SESSION, pLoraPacketSession->m_dwSessionId, pLoraPacketSession->m_dwDeviceAddr,
+                    pLoraPacketSession->m_dwFrameCounter, pLoraPacketSession->m_usMessageType);
   #endif
 
   // The 'LoraPacketSession' object is fully defined in MemoryBlocks (i.e. it is 'CREATED')
   // Set the 'Ready' flag to allow other tasks to use it
-  CMemoryBlockArray_SetBlockReady(this->m_pLoraPacketSessionArray, pLoraPacketSession->m_LoraSessionEntry.m_usBlockIndex);
+  CWideMemoryBlockArray_SetBlockReady(this->m_pLoraPacketSessionArray, pLoraPacketSession->m_LoraSessionEntry.m_wBlockIndex);
 
-  // Step 3 - Transmit the received packed to 'PacketForward' for send to network server
+  // Step 3 - Register the received uplink packet for downlink processing
+  // Note: The registration is done before transmission to 'ForwarderTask' (i.e. the ACK or downlink
+  //       of Network Server may be received before the return of 'xTaskNotify' when the roundtrip
+  //       is very short, typically Network Server on local network)
+  RegisterWindowsParams.m_dwDeviceAddr = pLoraPacketSession->m_dwDeviceAddr;
+  RegisterWindowsParams.m_usDeviceClass = LORAREALTIMESENDER_DEVICECLASS_A;
+  RegisterWindowsParams.m_pLoraTransceiverItf = pLoraPacketSession->m_pLoraTransceiverItf;
+  RegisterWindowsParams.m_qwRXTimestamp = pReceivedPacket->m_qwTimestamp;
+  RegisterWindowsParams.m_bJoinRequest = pLoraPacketSession->m_usMessageType == LORANODEMANAGER_MSG_TYPE_JOIN_REQUEST;
+
+  // Downlink sent by the receiving transceiver with its radio settings in both RX windows
+  // Note: In current version, the RX2 settings of LoRaWAN specification are not used
+  for (BYTE i = 0; i < this->m_usTransceiverNumber; i++)
+  {
+    if (this->m_TransceiverDescrArray[i].m_pLoraTransceiverItf == pLoraPacketSession->m_pLoraTransceiverItf)
+    {
+      RegisterWindowsParams.m_RxRadio[LORAREALTIMESENDER_RXWINDOW_RX1] = this->m_TransceiverDescrArray[i].m_DownlinkRadio;
+      RegisterWindowsParams.m_RxRadio[LORAREALTIMESENDER_RXWINDOW_RX2] = this->m_TransceiverDescrArray[i].m_DownlinkRadio;
+      break;
+    }
+  }
+  if (ILoraRealtimeSender_RegisterNodeRxWindows(this->m_pRealtimeSenderItf, &RegisterWindowsParams) == false)
+  {
+    // Should never occur
+    #if (LORANODEMANAGER_DEBUG_LEVEL0)
+      DEBUG_PRINT_LN("[ERROR] CLoraNodeManager_ProcessTransceiverUplinkReceived: Unable to register node RX windows");
+    #endif
+  }
+
+  // Step 4 - Transmit the received packed to 'PacketForward' for send to network server
 
   #if (LORANODEMANAGER_DEBUG_LEVEL2)
     DEBUG_PRINT_LN("[DEBUG] CLoraNodeManager_ProcessTransceiverUplinkReceived: Transmitting packet to Forwarder");
   #endif
 
-  // The 'CLoraNodeManager' uses a single dedicated 'CServerManagerItf_LoraSessionPacketOb' for exchange
-  // with 'CServerManager'.
-  // Check that there is no pending operation on this object
-  if (this->m_ForwardedUplinkPacket.m_pLoraPacket != NULL)
-  {
-    // Previous notification to 'CServerManager' still processing
-    // Wait a bit (but not too much)
-    #if (LORANODEMANAGER_DEBUG_LEVEL0)
-      DEBUG_PRINT_LN("[WARNING] CLoraNodeManager_ProcessTransceiverUplinkReceived: Previous packet still in buffer");
-    #endif
+  // The exchange object is embedded in the 'LoraPacketSession' (i.e. several uplink packets may wait
+  // in the queue of 'CServerManager')
+  pLoraPacketSession->m_ForwardedPacket.m_dwSessionId = pLoraPacketSession->m_dwSessionId;
+  pLoraPacketSession->m_ForwardedPacket.m_pSession = pLoraPacketSession;
+  pLoraPacketSession->m_ForwardedPacket.m_pLoraPacket = pReceivedPacket;
+  pLoraPacketSession->m_ForwardedPacket.m_pLoraPacketPool = this->m_pLoraPacketArray;
+  pLoraPacketSession->m_ForwardedPacket.m_pLoraPacketInfo = &pLoraPacketSession->m_ReceivedPacketInfo;
 
-    vTaskDelay(pdMS_TO_TICKS(50));
-  }
+  pLoraPacketSession->m_dwSessionState = LORANODEMANAGER_SESSION_STATE_SENDING_UPLINK;
 
-  if (this->m_ForwardedUplinkPacket.m_pLoraPacket != NULL)
+  if (CMpscRing_Push(this->m_pUplinkQueue, &(pLoraPacketSession->m_ForwardedPacket)) == false)
   {
     // Miss this packet
+    // Note: By design, should never occur (i.e. space checked before reading the receive ring)
     ++this->m_dwMissedUplinkPacketdNumber;
 
     #if (LORANODEMANAGER_DEBUG_LEVEL0)
-      DEBUG_PRINT("[ERROR] CLoraNodeManager_ProcessTransceiverUplinkReceived: Previous packet still in buffer, total missed: ");
+      DEBUG_PRINT("[ERROR] CLoraNodeManager_ProcessTransceiverUplinkReceived: Uplink queue full, total missed: ");
       DEBUG_PRINT_DEC(this->m_dwMissedUplinkPacketdNumber);
       DEBUG_PRINT_CR;
     #endif
 
     // Release 'MemoryBlock' used for 'LoraPacket' and 'LoraPacketSession'
-    CMemoryBlockArray_ReleaseBlock(this->m_pLoraPacketArray, pLoraPacketSession->m_LoraPacketEntry.m_usBlockIndex);
-    CMemoryBlockArray_ReleaseBlock(this->m_pLoraPacketSessionArray, pLoraPacketSession->m_LoraSessionEntry.m_usBlockIndex);
+    CWideMemoryBlockArray_ReleaseRef(this->m_pLoraPacketArray, pLoraPacketSession->m_LoraPacketEntry.m_wBlockIndex);
+    CWideMemoryBlockArray_ReleaseBlock(this->m_pLoraPacketSessionArray, pLoraPacketSession->m_LoraSessionEntry.m_wBlockIndex);
 
     #if (LORANODEMANAGER_DEBUG_LEVEL2)
       DEBUG_PRINT_LN("[DEBUG] CLoraNodeManager_ProcessTransceiverUplinkReceived, LoraPacket destroyed");
@@ -2255,39 +2669,14 @@ bool CLoraNodeManager_ProcessTransceiverUplinkReceived(CLoraNodeManager *this, C
     return false;
   }
 
-  // Send buffer available
-  this->m_ForwardedUplinkPacket.m_dwSessionId = pLoraPacketSession->m_dwSessionId;
-  this->m_ForwardedUplinkPacket.m_pSession = pLoraPacketSession;
-  this->m_ForwardedUplinkPacket.m_pLoraPacket = pReceivedPacket;
-  this->m_ForwardedUplinkPacket.m_pLoraPacketInfo = &pLoraPacketSession->m_ReceivedPacketInfo;
-
-  pLoraPacketSession->m_dwSessionState = LORANODEMANAGER_SESSION_STATE_SENDING_UPLINK;
-
   #if (LORANODEMANAGER_DEBUG_LEVEL2)
     DEBUG_PRINT("[DEBUG] CLoraNodeManager_ProcessTransceiverUplinkReceived: Notifying task: ");
-    DEBUG_PRINT_HEX((unsigned int) this->m_hPacketForwarderTask);
+    DEBUG_PRINT_PTR(this->m_hPacketForwarderTask);
     DEBUG_PRINT_CR;
   #endif
 
-  xTaskNotify(this->m_hPacketForwarderTask, (uint32_t) &(this->m_ForwardedUplinkPacket), eSetValueWithOverwrite);
+  xTaskNotify(this->m_hPacketForwarderTask, 0, eNoAction);
   
-  // Register the received uplink packet for downlink processing
-  // Note:
-  //  - For a quick processing of received packet, the registration is done after notification to 'ForwarderTask'
-  //  - The duration required for packet roundtrip to Network Server is large enough to allow registration processing
-  //    before an eventual downlink packet is received
-  RegisterWindowsParams.m_dwDeviceAddr = pLoraPacketSession->m_dwDeviceAddr;
-  RegisterWindowsParams.m_usDeviceClass = LORAREALTIMESENDER_DEVICECLASS_A;
-  RegisterWindowsParams.m_pLoraTransceiverItf = pLoraPacketSession->m_pLoraTransceiverItf;
-  RegisterWindowsParams.m_dwRXTimestamp = pReceivedPacket->m_dwTimestamp;
-  if (ILoraRealtimeSender_RegisterNodeRxWindows(this->m_pRealtimeSenderItf, &RegisterWindowsParams) == false)
-  {
-    // Should never occur
-    #if (LORANODEMANAGER_DEBUG_LEVEL0)
-      DEBUG_PRINT_LN("[ERROR] CLoraNodeManager_ProcessTransceiverUplinkReceived: Unable to register node RX windows");
-    #endif
-  }
-
   return true;
 }
 
@@ -2296,41 +2685,42 @@ bool CLoraNodeManager_ProcessTransceiverUplinkReceived(CLoraNodeManager *this, C
 bool CLoraNodeManager_ProcessTransceiverDownlinkSent(CLoraNodeManager *this, CLoraTransceiverItf_Event pEvent)
 {
   CTransceiverManagerItf_SessionEventOb SessionEvent;
-  CLoraDownPacketSessionOb LoraPacketSession;
-  CMemoryBlockArrayEnumItemOb EnumItem;
+  CLoraDownPacketSession pLoraPacketSession;
+  CWideMemoryBlockArraySnapshotOb Snapshot;
   bool bEntryFound;
 
   // Retrieve the downlink session associated to sent LoRa packet
-  EnumItem.m_bByValue = true;
-  EnumItem.m_pItemData = (void*) &LoraPacketSession;
+  // Note: Sessions are accessed in place (i.e. only packet reference is read for not matching entries)
   
   #if (LORANODEMANAGER_DEBUG_LEVEL2)
     DEBUG_PRINT_LN("[DEBUG] CLoraNodeManager_ProcessTransceiverDownlinkSent: Enumerator loop:");
   #endif
 
-  bEntryFound = CMemoryBlockArray_EnumStart(this->m_pLoraDownPacketSessionArray, &EnumItem);
+  bEntryFound = CWideMemoryBlockArray_SnapshotStart(this->m_pLoraDownPacketSessionArray, &Snapshot);
   while (bEntryFound == true)
   {
+    pLoraPacketSession = (CLoraDownPacketSession) Snapshot.m_pItemData;
+
     // The 'm_pEventData' variable of 'pEvent' is the 'CLoraTransceiverItf_LoraPacket' sent
     // This packet is referenced by the 'CLoraDownPacketSession' and is stored in the 
     // 'm_pLoraDownPacketSessionArray' array
 
     #if (LORANODEMANAGER_DEBUG_LEVEL2)
       DEBUG_PRINT("Event packet: ");
-      DEBUG_PRINT_HEX(pEvent->m_pEventData);
+      DEBUG_PRINT_PTR(pEvent->m_pEventData);
       DEBUG_PRINT(", Session packet: ");
-      DEBUG_PRINT_HEX(LoraPacketSession.m_LoraPacketEntry.m_pDataBlock);
+      DEBUG_PRINT_PTR(pLoraPacketSession->m_LoraPacketEntry.m_pDataBlock);
       DEBUG_PRINT_CR;
     #endif
 
-    if (LoraPacketSession.m_LoraPacketEntry.m_pDataBlock == pEvent->m_pEventData)
+    if (pLoraPacketSession->m_LoraPacketEntry.m_pDataBlock == pEvent->m_pEventData)
     {
       // Downlink session retrieved
       // Sanity check: by design MemoryBlock used for LoraPacket cannot be released before end of session
       #if (LORANODEMANAGER_DEBUG_LEVEL1)
         CLoraTransceiverItf_LoraPacket pSendLoraPacket = (CLoraTransceiverItf_LoraPacket) pEvent->m_pEventData;
-        CLoraTransceiverItf_LoraPacket pSessionLoraPacket = (CLoraTransceiverItf_LoraPacket) LoraPacketSession.m_LoraPacketEntry.m_pDataBlock;
-        if ((pSessionLoraPacket->m_dwTimestamp != pSendLoraPacket->m_dwTimestamp) ||
+        CLoraTransceiverItf_LoraPacket pSessionLoraPacket = (CLoraTransceiverItf_LoraPacket) pLoraPacketSession->m_LoraPacketEntry.m_pDataBlock;
+        if ((pSessionLoraPacket->m_qwTimestamp != pSendLoraPacket->m_qwTimestamp) ||
             (pSessionLoraPacket->m_dwDataSize != pSendLoraPacket->m_dwDataSize))
         {
           DEBUG_PRINT_LN("[ERROR] CLoraNodeManager_ProcessTransceiverDownlinkSent: Invalid LoRa packet found for session");
@@ -2340,13 +2730,13 @@ bool CLoraNodeManager_ProcessTransceiverDownlinkSent(CLoraNodeManager *this, CLo
 
       // Notify the parent 'LoraNodeManager'
       // Note: A session event is required for correct automaton state sequence of downlink session
-      SessionEvent.m_pSession = LoraPacketSession.m_LoraSessionEntry.m_pDataBlock;
-      SessionEvent.m_dwSessionId = LoraPacketSession.m_dwSessionId;
+      SessionEvent.m_pSession = pLoraPacketSession->m_LoraSessionEntry.m_pDataBlock;
+      SessionEvent.m_dwSessionId = pLoraPacketSession->m_dwSessionId;
       SessionEvent.m_wEventType = TRANSCEIVERMANAGER_SESSIONEVENT_DOWNLINK_SENT;
       ITransceiverManager_SessionEvent(this->m_pTransceiverManagerItf, &SessionEvent);
       return true;
     }
-    bEntryFound = CMemoryBlockArray_EnumNext(this->m_pLoraDownPacketSessionArray, &EnumItem);
+    bEntryFound = CWideMemoryBlockArray_SnapshotNext(this->m_pLoraDownPacketSessionArray, &Snapshot);
   }
 
   // Should never occur: downlink session must be alive until packet is sent by transceiver
@@ -2370,7 +2760,7 @@ bool CLoraNodeManager_ProcessTransceiverDownlinkSent(CLoraNodeManager *this, CLo
 bool CLoraNodeManager_ProcessServerDownlinkReceived(CLoraNodeManager *this,
                                                     CLoraNodeManager_ProcessServerDownlinkReceivedParams pParams)
 {
-  CMemoryBlockArrayEntryOb MemBlockEntry;
+  CWideMemoryBlockArrayEntryOb MemBlockEntry;
   BYTE *pMemBlock;
   CLoraDownPacketSession pLoraPacketSession;
   DWORD dwResult;
@@ -2379,7 +2769,7 @@ bool CLoraNodeManager_ProcessServerDownlinkReceived(CLoraNodeManager *this,
 
   // Step 1 - Obtain a 'MemoryBlock' to store the new 'DownLoraSession' to manage send of downlink packet
 
-  if ((pLoraPacketSession = CMemoryBlockArray_GetBlock(this->m_pLoraDownPacketSessionArray, &MemBlockEntry)) == NULL)
+  if ((pLoraPacketSession = CWideMemoryBlockArray_GetBlock(this->m_pLoraDownPacketSessionArray, &MemBlockEntry)) == NULL)
   {
     // Should never occur. Buffer for 'LoraDownPacketSession'exhausted
     // Note: No recovery mechanism = for stress test in current version
@@ -2393,14 +2783,14 @@ bool CLoraNodeManager_ProcessServerDownlinkReceived(CLoraNodeManager *this,
 
   #if (LORANODEMANAGER_DEBUG_LEVEL2)
     DEBUG_PRINT("[DEBUG] CLoraNodeManager_ProcessServerDownlinkReceived: LoraPacketSession MemBlock, index: ");
-    DEBUG_PRINT_HEX((unsigned int) MemBlockEntry.m_usBlockIndex);
+    DEBUG_PRINT_HEX((unsigned int) MemBlockEntry.m_wBlockIndex);
     DEBUG_PRINT(", ptr: ");
-    DEBUG_PRINT_HEX((unsigned int) MemBlockEntry.m_pDataBlock);
+    DEBUG_PRINT_PTR(MemBlockEntry.m_pDataBlock);
     DEBUG_PRINT_CR;
   #endif
 
   pLoraPacketSession->m_LoraSessionEntry.m_pDataBlock = MemBlockEntry.m_pDataBlock;
-  pLoraPacketSession->m_LoraSessionEntry.m_usBlockIndex = MemBlockEntry.m_usBlockIndex;
+  pLoraPacketSession->m_LoraSessionEntry.m_wBlockIndex = MemBlockEntry.m_wBlockIndex;
   pLoraPacketSession->m_dwSessionState = LORANODEMANAGER_DOWNSESSION_STATE_CREATED;
   pLoraPacketSession->m_dwSessionId = ++this->m_dwLastDownSessionId;
   pLoraPacketSession->m_usMessageType = (BYTE) pParams->m_dwSessionType;
@@ -2408,7 +2798,7 @@ bool CLoraNodeManager_ProcessServerDownlinkReceived(CLoraNodeManager *this,
   // Step 2 - Build the 'CLoraPacket' to send in a 'MemoryBlock' buffer
   //          The payload data are copied from memory provided in params
 
-  if ((pMemBlock = CMemoryBlockArray_GetBlock(this->m_pLoraPacketArray, &(pLoraPacketSession->m_LoraPacketEntry))) == NULL)
+  if ((pMemBlock = CWideMemoryBlockArray_GetBlock(this->m_pLoraPacketArray, &(pLoraPacketSession->m_LoraPacketEntry))) == NULL)
   {
     // Should never occur. Buffer for 'LoraPacket' exhausted
     // Note: No recovery mechanism = for stress test in current version
@@ -2418,7 +2808,7 @@ bool CLoraNodeManager_ProcessServerDownlinkReceived(CLoraNodeManager *this,
     #endif
 
     // Release 'MemoryBlock' of 'LoraPacketSession'
-    CMemoryBlockArray_ReleaseBlock(this->m_pLoraPacketSessionArray, pLoraPacketSession->m_LoraSessionEntry.m_usBlockIndex);
+    CWideMemoryBlockArray_ReleaseBlock(this->m_pLoraPacketSessionArray, pLoraPacketSession->m_LoraSessionEntry.m_wBlockIndex);
 
     #if (LORANODEMANAGER_DEBUG_LEVEL2)
       DEBUG_PRINT_LN("[DEBUG] CLoraNodeManager_ProcessServerDownlinkReceived, LoraDownPacketSession destroyed");
@@ -2429,9 +2819,9 @@ bool CLoraNodeManager_ProcessServerDownlinkReceived(CLoraNodeManager *this,
 
   #if (LORANODEMANAGER_DEBUG_LEVEL2)
     DEBUG_PRINT("[DEBUG] CLoraNodeManager_ProcessServerDownlinkReceived: LoraPacket MemBlock, index: ");
-    DEBUG_PRINT_HEX((unsigned int) pLoraPacketSession->m_LoraPacketEntry.m_usBlockIndex);
+    DEBUG_PRINT_HEX((unsigned int) pLoraPacketSession->m_LoraPacketEntry.m_wBlockIndex);
     DEBUG_PRINT(", ptr: ");
-    DEBUG_PRINT_HEX((unsigned int) pLoraPacketSession->m_LoraPacketEntry.m_pDataBlock);
+    DEBUG_PRINT_PTR(pLoraPacketSession->m_LoraPacketEntry.m_pDataBlock);
     DEBUG_PRINT_CR;
   #endif
 
@@ -2442,7 +2832,7 @@ bool CLoraNodeManager_ProcessServerDownlinkReceived(CLoraNodeManager *this,
 
   // The 'MemoryBlock' is used to store the received packet (i.e. 'CLoraTransceiverItf_LoraPacketOb' object)
   ((CLoraTransceiverItf_LoraPacket) pMemBlock)->m_dwDataSize = pParams->m_dwPayloadSize;
-  ((CLoraTransceiverItf_LoraPacket) pMemBlock)->m_dwTimestamp = pParams->m_dwTimestamp;
+  ((CLoraTransceiverItf_LoraPacket) pMemBlock)->m_qwTimestamp = pParams->m_qwTimestamp;
   memcpy(((CLoraTransceiverItf_LoraPacket) pMemBlock)->m_usData, pParams->m_pPayload, pParams->m_dwPayloadSize);
 
   pLoraPacketSession->m_pLoraTransceiverItf = pParams->m_pLoraTransceiverItf;
@@ -2459,7 +2849,7 @@ bool CLoraNodeManager_ProcessServerDownlinkReceived(CLoraNodeManager *this,
 
   // The 'LoraPacketSession' object is fully defined in MemoryBlocks (i.e. it is 'CREATED')
   // Set the 'Ready' flag to allow other tasks to use it
-  CMemoryBlockArray_SetBlockReady(this->m_pLoraDownPacketSessionArray, pLoraPacketSession->m_LoraSessionEntry.m_usBlockIndex);
+  CWideMemoryBlockArray_SetBlockReady(this->m_pLoraDownPacketSessionArray, pLoraPacketSession->m_LoraSessionEntry.m_wBlockIndex);
 
   // Step 3 - Transmit the received packed to 'PacketForward' for send to network server
 
@@ -2474,7 +2864,13 @@ bool CLoraNodeManager_ProcessServerDownlinkReceived(CLoraNodeManager *this,
   ScheduleSendParams.m_dwDownlinkSessionId = pLoraPacketSession->m_dwSessionId;
   ScheduleSendParams.m_pDownlinkSession = pLoraPacketSession;
   ScheduleSendParams.m_pPacketToSend = (CLoraTransceiverItf_LoraPacket) pMemBlock;
+  ScheduleSendParams.m_bServerTiming = pParams->m_bServerTiming;
+  ScheduleSendParams.m_bImmediate = pParams->m_bImmediate;
+  ScheduleSendParams.m_dwSendTimestamp = pParams->m_dwSendTimestamp;
+  ScheduleSendParams.m_ServerRadio = pParams->m_ServerRadio;
+  ScheduleSendParams.m_bJoinAccept = pParams->m_bJoinAccept;
   dwResult = ILoraRealtimeSender_ScheduleSendNodePacket(this->m_pRealtimeSenderItf, &ScheduleSendParams);
+  pParams->m_dwResult = dwResult;
 
   // An error code is returned if the packet cannot be scheduled
   // Note: If the packet is scheduled, a notification is sent (for correct serialization of session events)
@@ -2503,10 +2899,10 @@ void CLoraNodeManager_ReleaseDownlinkSession(CLoraNodeManager *this, CLoraDownPa
   #endif
 
   // Release 'MemoryBlock' of 'CLoraTransceiverItf_LoraPacketOb'
-  CMemoryBlockArray_ReleaseBlock(this->m_pLoraPacketArray, pLoraPacketSession->m_LoraPacketEntry.m_usBlockIndex);
+  CWideMemoryBlockArray_ReleaseRef(this->m_pLoraPacketArray, pLoraPacketSession->m_LoraPacketEntry.m_wBlockIndex);
 
   // Release 'MemoryBlock' of 'LoraPacketSession'
-  CMemoryBlockArray_ReleaseBlock(this->m_pLoraDownPacketSessionArray, pLoraPacketSession->m_LoraSessionEntry.m_usBlockIndex);
+  CWideMemoryBlockArray_ReleaseBlock(this->m_pLoraDownPacketSessionArray, pLoraPacketSession->m_LoraSessionEntry.m_wBlockIndex);
 
   #if (LORANODEMANAGER_DEBUG_LEVEL2)
     DEBUG_PRINT("[DEBUG] 'CLoraNodeManager_ReleaseDownlinkSession' - Released - ticks: ");
@@ -0,0 +1,1275 @@
+/*****************************************************************************************//**
+ * @file     LoraNodeSwarm.c
+ *
+ * @author   F.Fargon
+ *
+ * @version  V1.0
+ *
+ * @date     16/10/2026
+ *
+ * @brief    Simulated LoRaWAN class A devices exposed as a 'LoraTransceiver'.
+ *
+ * @details  This file implements the following classes or functions:\n
+ *            - CLoraNodeSwarm = 'ILoraTransceiver' interface generating the uplink traffic of
+ *              simulated devices and recording the downlinks sent to them (i.e. load generator
+ *              used on Linux host with 'CLoraNodeManager_SetTransceiverFactory')
+*********************************************************************************************/
+
+
+/*********************************************************************************************
+  Espressif framework includes
+*********************************************************************************************/
+
+#include <Common.h>
+
+#ifndef ESP_PLATFORM
+
+
+/*********************************************************************************************
+  Includes for object implementation
+*********************************************************************************************/
+
+// The CLoraNodeSwarm object implements the 'ILoraTransceiver' interface
+#define LORATRANSCEIVERITF_IMPL
+
+#include "LoraTransceiverItf.h"
+#include "LoraNodeSwarmItf.h"
+#include "LoraDutyCycle.h"
+#include "TaskPlacement.h"
+#include "Utilities.h"
+
+// Object's definitions and methods
+#include "LoraNodeSwarm.h"
+
+// The CLoraNodeSwarm object implements the swarm configuration object
+#define LORANODESWARMCONFIG_IMPL
+#include "Configuration.h"
+
+
+/*********************************************************************************************
+  Instantiate global static objects used by module implementation
+*********************************************************************************************/
+
+// 'ILoraTransceiver' interface function pointers
+CLoraTransceiverItfImplOb g_LoraNodeSwarmItfImplOb = { .m_pAddRef = CLoraNodeSwarm_AddRef,
+                                                       .m_pReleaseItf = CLoraNodeSwarm_ReleaseItf,
+                                                       .m_pInitialize = CLoraNodeSwarm_Initialize,
+                                                       .m_pSetLoraMAC = CLoraNodeSwarm_SetLoraMAC,
+                                                       .m_pSetLoraMode = CLoraNodeSwarm_SetLoraMode,
+                                                       .m_pSetPowerMode = CLoraNodeSwarm_SetPowerMode,
+                                                       .m_pSetFreqChannel = CLoraNodeSwarm_SetFreqChannel,
+                                                       .m_pStandBy = CLoraNodeSwarm_StandBy,
+                                                       .m_pReceive = CLoraNodeSwarm_Receive,
+                                                       .m_pSend = CLoraNodeSwarm_Send,
+                                                       .m_pArmSend = CLoraNodeSwarm_ArmSend,
+                                                       .m_pFireSend = CLoraNodeSwarm_FireSend,
+                                                       .m_pGetReceivedPacketInfo = CLoraNodeSwarm_GetReceivedPacketInfo
+                                                     };
+
+// CLoraNodeSwarm objects (indexed by transceiver, see 'CLoraNodeSwarm_GetStatistics')
+static CLoraNodeSwarm g_pLoraNodeSwarms[GATEWAY_MAX_LORATRANSCEIVERS] = { NULL };
+
+// Frequency in text format for predefined channel No. (see 'LoraTransceiverItf.h')
+static const char * const g_szLoraNodeSwarmFreqText[LORATRANSCEIVERITF_FREQUENCY_CHANNEL_18 + 1] =
+  {
+    [LORATRANSCEIVERITF_FREQUENCY_CHANNEL_00] = "868.100",
+    [LORATRANSCEIVERITF_FREQUENCY_CHANNEL_01] = "868.300",
+    [LORATRANSCEIVERITF_FREQUENCY_CHANNEL_02] = "868.500",
+    [LORATRANSCEIVERITF_FREQUENCY_CHANNEL_03] = "868.850",
+    [LORATRANSCEIVERITF_FREQUENCY_CHANNEL_04] = "869.050",
+    [LORATRANSCEIVERITF_FREQUENCY_CHANNEL_05] = "869.525",
+    [LORATRANSCEIVERITF_FREQUENCY_RX2] =        "869.525",
+    [LORATRANSCEIVERITF_FREQUENCY_CHANNEL_10] = "865.200",
+    [LORATRANSCEIVERITF_FREQUENCY_CHANNEL_11] = "865.500",
+    [LORATRANSCEIVERITF_FREQUENCY_CHANNEL_12] = "865.800",
+    [LORATRANSCEIVERITF_FREQUENCY_CHANNEL_13] = "866.100",
+    [LORATRANSCEIVERITF_FREQUENCY_CHANNEL_14] = "866.400",
+    [LORATRANSCEIVERITF_FREQUENCY_CHANNEL_15] = "866.700",
+    [LORATRANSCEIVERITF_FREQUENCY_CHANNEL_16] = "867.000",
+    [LORATRANSCEIVERITF_FREQUENCY_CHANNEL_17] = "868.000",
+    [LORATRANSCEIVERITF_FREQUENCY_CHANNEL_18] = "868.100"
+  };
+
+
+/*********************************************************************************************
+  Public methods of CLoraNodeSwarm object
+
+  These methods are exposed on object's public interfaces
+*********************************************************************************************/
+
+/*********************************************************************************************
+  Object instance factory
+
+  The factory contains one method used to create a new object instance.
+  This method provides the 'ILoraTransceiver' interface object for object's use and destruction.
+*********************************************************************************************/
+
+/*****************************************************************************************//**
+ * @fn         ILoraTransceiver CLoraNodeSwarm_CreateInstance(BYTE usTransceiverIndex)
+ *
+ * @brief      Creates a new instance of CLoraNodeSwarm object.
+ *
+ * @details    A new instance of CLoraNodeSwarm object is created and its 'ILoraTransceiver'
+ *             interface is returned. The object simulates the devices of the swarm
+ *             configuration assigned to the transceiver (i.e. device index modulo
+ *             'CONFIG_LORA_TRANSCEIVER_NUMBER').
+ *
+ * @param      usTransceiverIndex
+ *             The index of the 'LoraTransceiver' in 'CLoraNodeManager'.
+ *
+ * @return     A 'ILoraTransceiver' interface object or NULL if error.\n
+ *             The reference count for returned 'ILoraTransceiver' interface is set to 1.
+ *
+ * @note       The simulated devices start to transmit when the receive mode is entered for
+ *             the first time (i.e. 'ILoraTransceiver_Receive' method).
+*********************************************************************************************/
+ILoraTransceiver CLoraNodeSwarm_CreateInstance(BYTE usTransceiverIndex)
+{
+  CLoraNodeSwarm pLoraNodeSwarm;
+
+  if ((usTransceiverIndex >= GATEWAY_MAX_LORATRANSCEIVERS) || (g_pLoraNodeSwarms[usTransceiverIndex] != NULL))
+  {
+    return NULL;
+  }
+
+  // Create the object
+  if ((pLoraNodeSwarm = CLoraNodeSwarm_New(usTransceiverIndex)) != NULL)
+  {
+    // Create the 'ILoraTransceiver' interface object
+    if ((pLoraNodeSwarm->m_pLoraTransceiverItf = ILoraTransceiver_New(pLoraNodeSwarm, &g_LoraNodeSwarmItfImplOb)) == NULL)
+    {
+      CLoraNodeSwarm_Delete(pLoraNodeSwarm);
+      return NULL;
+    }
+
+    ++(pLoraNodeSwarm->m_nRefCount);
+    g_pLoraNodeSwarms[usTransceiverIndex] = pLoraNodeSwarm;
+    return pLoraNodeSwarm->m_pLoraTransceiverItf;
+  }
+
+  return NULL;
+}
+
+
+// Copies the statistics of the CLoraNodeSwarm object of a transceiver
+// Returns false if there is no CLoraNodeSwarm for this transceiver
+bool CLoraNodeSwarm_GetStatistics(BYTE usTransceiverIndex, CLoraNodeSwarmStatistics pStatistics)
+{
+  CLoraNodeSwarm pLoraNodeSwarm;
+
+  if ((usTransceiverIndex >= GATEWAY_MAX_LORATRANSCEIVERS) || ((pLoraNodeSwarm = g_pLoraNodeSwarms[usTransceiverIndex]) == NULL))
+  {
+    return false;
+  }
+
+  xSemaphoreTake(pLoraNodeSwarm->m_hMutex, portMAX_DELAY);
+  memcpy(pStatistics, &(pLoraNodeSwarm->m_Statistics), sizeof(CLoraNodeSwarmStatisticsOb));
+  xSemaphoreGive(pLoraNodeSwarm->m_hMutex);
+  return true;
+}
+
+
+/*********************************************************************************************
+  Public methods exposed on 'ILoraTransceiver' interface
+
+  The static 'CLoraTransceiverItfImplOb' object is initialized with pointers to these functions.
+  The static 'CLoraTransceiverItfImplOb' object is referenced in the 'ILoraTransceiver'
+  interface provided by 'CreateInstance' method (object factory).
+
+  Note: The methods are directly executed by the calling task (i.e. no automaton command)
+*********************************************************************************************/
+
+uint32_t CLoraNodeSwarm_AddRef(void *this)
+{
+  return ++((CLoraNodeSwarm) this)->m_nRefCount;
+}
+
+
+uint32_t CLoraNodeSwarm_ReleaseItf(void *this)
+{
+  // Delete the object if its interface reference count reaches zero
+  if (((CLoraNodeSwarm) this)->m_nRefCount == 1)
+  {
+    CLoraNodeSwarm_Delete((CLoraNodeSwarm) this);
+    return 0;
+  }
+  return --((CLoraNodeSwarm) this)->m_nRefCount;
+}
+
+
+/*****************************************************************************************//**
+ * @fn         bool CLoraNodeSwarm_Initialize(void *this, void *pParams)
+ *
+ * @brief      Initializes the simulated transceiver.
+ *
+ * @details    This function stores the event queue, the shared packet pool and the receive
+ *             ring of the owner object and applies the radio settings.\n
+ *             The transceiver is ready in 'StandBy' mode.
+ *
+ * @param      this
+ *             The pointer to CLoraNodeSwarm object.
+ *
+ * @param      pParams
+ *             The method parameters (see 'LoraTransceiverItf.h' for details).
+ *
+ * @return     The returned value is 'true' if the transceiver is initialized or 'false' if
+ *             the object is already initialized or if no shared packet pool is provided.
+*********************************************************************************************/
+bool CLoraNodeSwarm_Initialize(void *this, void *pParams)
+{
+  CLoraNodeSwarm pThis = (CLoraNodeSwarm) this;
+  CLoraTransceiverItf_InitializeParams pInitParams = (CLoraTransceiverItf_InitializeParams) pParams;
+
+  // The simulated packets are always received in shared packet buffers
+  if ((pThis->m_dwCurrentState != LORANODESWARM_STATE_CREATED) || (pInitParams->m_pLoraPacketPool == NULL))
+  {
+    #if (LORANODESWARM_DEBUG_LEVEL0)
+      DEBUG_PRINT_LN("[ERROR] CLoraNodeSwarm_Initialize, invalid state or no shared packet pool");
+    #endif
+    return false;
+  }
+
+  xSemaphoreTake(pThis->m_hMutex, portMAX_DELAY);
+  pThis->m_hEventNotifyQueue = pInitParams->m_hEventNotifyQueue;
+  pThis->m_pLoraPacketPool = (CWideMemoryBlockArray) pInitParams->m_pLoraPacketPool;
+  pThis->m_pReceiveRing = (CSpscRing) pInitParams->m_pReceiveRing;
+  xSemaphoreGive(pThis->m_hMutex);
+
+  if (((pInitParams->pLoraMAC != NULL) && (CLoraNodeSwarm_SetLoraMAC(this, pInitParams->pLoraMAC) == false)) ||
+      ((pInitParams->pLoraMode != NULL) && (CLoraNodeSwarm_SetLoraMode(this, pInitParams->pLoraMode) == false)) ||
+      ((pInitParams->pFreqChannel != NULL) && (CLoraNodeSwarm_SetFreqChannel(this, pInitParams->pFreqChannel) == false)))
+  {
+    return false;
+  }
+
+  xSemaphoreTake(pThis->m_hMutex, portMAX_DELAY);
+  pThis->m_dwCurrentState = LORANODESWARM_STATE_STANDBY;
+  xSemaphoreGive(pThis->m_hMutex);
+
+  #if (LORANODESWARM_DEBUG_LEVEL0)
+    DEBUG_PRINT("[INFO] CLoraNodeSwarm initialized, transceiver: ");
+    DEBUG_PRINT_DEC(pThis->m_usTransceiverIndex);
+    DEBUG_PRINT(", simulated devices: ");
+    DEBUG_PRINT_DEC(pThis->m_wDeviceNumber);
+    DEBUG_PRINT_CR;
+  #endif
+  return true;
+}
+
+
+// LoRa MAC settings (used for time-on-air of downlinks, the sync word is ignored)
+bool CLoraNodeSwarm_SetLoraMAC(void *this, void *pParams)
+{
+  CLoraNodeSwarm pThis = (CLoraNodeSwarm) this;
+  CLoraTransceiverItf_SetLoraMACParams pMACParams = (CLoraTransceiverItf_SetLoraMACParams) pParams;
+
+  xSemaphoreTake(pThis->m_hMutex, portMAX_DELAY);
+  if (pMACParams->m_wPreambleLength != LORATRANSCEIVERITF_PREAMBLE_LENGTH_NONE)
+  {
+    pThis->m_wPreambleLength = pMACParams->m_wPreambleLength;
+  }
+  if (pMACParams->m_usHeader != LORATRANSCEIVERITF_HEADER_NONE)
+  {
+    pThis->m_bHeader = (pMACParams->m_usHeader == LORATRANSCEIVERITF_HEADER_ON);
+  }
+  if (pMACParams->m_usCRC != LORATRANSCEIVERITF_CRC_NONE)
+  {
+    pThis->m_bCRC = (pMACParams->m_usCRC == LORATRANSCEIVERITF_CRC_ON);
+  }
+  xSemaphoreGive(pThis->m_hMutex);
+  return true;
+}
+
+
+// LoRa modulation settings (used for time-on-air of downlinks)
+// Note: The predefined LoRa modes ('m_usLoraMode') are not supported
+bool CLoraNodeSwarm_SetLoraMode(void *this, void *pParams)
+{
+  CLoraNodeSwarm pThis = (CLoraNodeSwarm) this;
+  CLoraTransceiverItf_SetLoraModeParams pModeParams = (CLoraTransceiverItf_SetLoraModeParams) pParams;
+
+  if ((pModeParams->m_usLoraMode != LORATRANSCEIVERITF_LORAMODE_NONE) ||
+      ((pModeParams->m_usSpreadingFactor != LORATRANSCEIVERITF_SF_NONE) &&
+       ((pModeParams->m_usSpreadingFactor < LORATRANSCEIVERITF_SF_7) || (pModeParams->m_usSpreadingFactor > LORATRANSCEIVERITF_SF_12))) ||
+      (pModeParams->m_usBandwidth > LORATRANSCEIVERITF_BANDWIDTH_500) ||
+      (pModeParams->m_usCodingRate > LORATRANSCEIVERITF_CR_8))
+  {
+    return false;
+  }
+
+  xSemaphoreTake(pThis->m_hMutex, portMAX_DELAY);
+  if (pModeParams->m_usSpreadingFactor != LORATRANSCEIVERITF_SF_NONE)
+  {
+    pThis->m_usSpreadingFactor = pModeParams->m_usSpreadingFactor;
+  }
+  if (pModeParams->m_usBandwidth != LORATRANSCEIVERITF_BANDWIDTH_NONE)
+  {
+    pThis->m_usBandwidth = pModeParams->m_usBandwidth;
+  }
+  if (pModeParams->m_usCodingRate != LORATRANSCEIVERITF_CR_NONE)
+  {
+    pThis->m_usCodingRate = pModeParams->m_usCodingRate;
+  }
+  xSemaphoreGive(pThis->m_hMutex);
+  return true;
+}
+
+
+// Power settings (no effect on simulated devices)
+bool CLoraNodeSwarm_SetPowerMode(void *this, void *pParams)
+{
+  return true;
+}
+
+
+// Frequency channel (used for packet information of received packets)
+bool CLoraNodeSwarm_SetFreqChannel(void *this, void *pParams)
+{
+  CLoraNodeSwarm pThis = (CLoraNodeSwarm) this;
+  BYTE usFreqChannel = ((CLoraTransceiverItf_SetFreqChannelParams) pParams)->m_usFreqChannel;
+
+  if ((usFreqChannel > LORATRANSCEIVERITF_FREQUENCY_CHANNEL_18) || (g_szLoraNodeSwarmFreqText[usFreqChannel] == NULL))
+  {
+    return false;
+  }
+
+  xSemaphoreTake(pThis->m_hMutex, portMAX_DELAY);
+  pThis->m_usFreqChannel = usFreqChannel;
+  xSemaphoreGive(pThis->m_hMutex);
+  return true;
+}
+
+
+// Enters the 'StandBy' mode (i.e. uplinks not received, armed packet cancelled)
+// Note: A cancelled armed packet leaves the object in the same mode as the end of a transmission
+//       (i.e. receive mode resumed with 'm_bResumeReceive')
+bool CLoraNodeSwarm_StandBy(void *this, void *pParams)
+{
+  CLoraNodeSwarm pThis = (CLoraNodeSwarm) this;
+  bool bResult = false;
+
+  xSemaphoreTake(pThis->m_hMutex, portMAX_DELAY);
+  if ((pThis->m_dwCurrentState != LORANODESWARM_STATE_CREATED) && (pThis->m_dwCurrentState != LORANODESWARM_STATE_SENDING))
+  {
+    pThis->m_pPacketToSend = NULL;
+    pThis->m_dwCurrentState = (pThis->m_dwCurrentState == LORANODESWARM_STATE_ARMED) && (g_LoraNodeSwarmConfig.m_bResumeReceive == true) ?
+                              LORANODESWARM_STATE_RECEIVING : LORANODESWARM_STATE_STANDBY;
+    bResult = true;
+  }
+  xSemaphoreGive(pThis->m_hMutex);
+
+  // The swarm task computes its next wake-up time
+  xTaskNotifyGive(pThis->m_hSwarmTask);
+  return bResult;
+}
+
+
+/*****************************************************************************************//**
+ * @fn         bool CLoraNodeSwarm_Receive(void *this, void *pParams)
+ *
+ * @brief      Enters the continuous receive mode.
+ *
+ * @details    The uplinks of simulated devices are notified to owner object while the object
+ *             is in receive mode. The armed packet is cancelled.\n
+ *             The uplinks of simulated devices are scheduled when the receive mode is entered
+ *             for the first time.
+ *
+ * @param      this
+ *             The pointer to CLoraNodeSwarm object.
+ *
+ * @param      pParams
+ *             The method parameters (see 'LoraTransceiverItf.h' for details).
+ *
+ * @return     The returned value is 'true' if the receive mode is entered or 'false' if the
+ *             object is not initialized or a packet is being sent.
+ *
+ * @note       The scanner mode ('m_pScanParams') is ignored (i.e. all channels and spreading
+ *             factors are received).
+*********************************************************************************************/
+bool CLoraNodeSwarm_Receive(void *this, void *pParams)
+{
+  CLoraNodeSwarm pThis = (CLoraNodeSwarm) this;
+  bool bResult = false;
+
+  xSemaphoreTake(pThis->m_hMutex, portMAX_DELAY);
+  if ((pThis->m_dwCurrentState != LORANODESWARM_STATE_CREATED) && (pThis->m_dwCurrentState != LORANODESWARM_STATE_SENDING))
+  {
+    pThis->m_pPacketToSend = NULL;
+    pThis->m_dwCurrentState = LORANODESWARM_STATE_RECEIVING;
+    if (pThis->m_bStarted == false)
+    {
+      CLoraNodeSwarm_StartDevices(pThis, GATEWAY_CLOCK_MICROSEC());
+    }
+    bResult = true;
+  }
+  xSemaphoreGive(pThis->m_hMutex);
+
+  // The swarm task computes its next wake-up time
+  xTaskNotifyGive(pThis->m_hSwarmTask);
+  return bResult;
+}
+
+
+// Sends a packet immediately (i.e. 'ArmSend' followed by 'FireSend')
+bool CLoraNodeSwarm_Send(void *this, void *pParams)
+{
+  CLoraNodeSwarm pThis = (CLoraNodeSwarm) this;
+  bool bResult = false;
+
+  xSemaphoreTake(pThis->m_hMutex, portMAX_DELAY);
+  if ((pThis->m_dwCurrentState != LORANODESWARM_STATE_CREATED) && (pThis->m_dwCurrentState != LORANODESWARM_STATE_SENDING))
+  {
+    pThis->m_pPacketToSend = ((CLoraTransceiverItf_SendParams) pParams)->m_pPacketToSend;
+    CLoraNodeSwarm_FireArmedPacket(pThis, GATEWAY_CLOCK_MICROSEC());
+    bResult = true;
+  }
+  xSemaphoreGive(pThis->m_hMutex);
+
+  // End of transmission notified by swarm task
+  xTaskNotifyGive(pThis->m_hSwarmTask);
+  return bResult;
+}
+
+
+// Prepares a packet for 'FireSend' (i.e. uplinks not received until end of transmission)
+bool CLoraNodeSwarm_ArmSend(void *this, void *pParams)
+{
+  CLoraNodeSwarm pThis = (CLoraNodeSwarm) this;
+  bool bResult = false;
+
+  xSemaphoreTake(pThis->m_hMutex, portMAX_DELAY);
+  if ((pThis->m_dwCurrentState != LORANODESWARM_STATE_CREATED) && (pThis->m_dwCurrentState != LORANODESWARM_STATE_SENDING))
+  {
+    pThis->m_pPacketToSend = ((CLoraTransceiverItf_ArmSendParams) pParams)->m_pPacketToSend;
+    pThis->m_dwCurrentState = LORANODESWARM_STATE_ARMED;
+    bResult = true;
+  }
+  xSemaphoreGive(pThis->m_hMutex);
+  return bResult;
+}
+
+
+/*****************************************************************************************//**
+ * @fn         bool CLoraNodeSwarm_FireSend(void *this, void *pParams)
+ *
+ * @brief      Starts the transmission of the packet prepared by 'ArmSend' method.
+ *
+ * @details    The fire timestamp is the gateway clock when the function is called. The
+ *             downlink is recorded with its timing error relative to the RX windows of the
+ *             destination device.\n
+ *             The end of transmission is notified by the swarm task ('PACKETSENT' event).
+ *
+ * @param      this
+ *             The pointer to CLoraNodeSwarm object.
+ *
+ * @param      pParams
+ *             The method parameters (see 'LoraTransceiverItf.h' for details).
+ *
+ * @return     The returned value is 'true' if the packet is being sent or 'false' if no
+ *             packet is armed.
+*********************************************************************************************/
+bool CLoraNodeSwarm_FireSend(void *this, void *pParams)
+{
+  CLoraNodeSwarm pThis = (CLoraNodeSwarm) this;
+  QWORD qwFireTimestamp;
+
+  // Timestamp taken before the mutex (i.e. same latency as 'CSX1276' SPI transaction)
+  qwFireTimestamp = GATEWAY_CLOCK_MICROSEC();
+
+  xSemaphoreTake(pThis->m_hMutex, portMAX_DELAY);
+  if (pThis->m_dwCurrentState != LORANODESWARM_STATE_ARMED)
+  {
+    xSemaphoreGive(pThis->m_hMutex);
+    return false;
+  }
+
+  CLoraNodeSwarm_FireArmedPacket(pThis, qwFireTimestamp);
+  ((CLoraTransceiverItf_FireSendParams) pParams)->m_qwFireTimestamp = qwFireTimestamp;
+  xSemaphoreGive(pThis->m_hMutex);
+
+  // End of transmission notified by swarm task
+  xTaskNotifyGive(pThis->m_hSwarmTask);
+  return true;
+}
+
+
+// Information of last received packet (when packets are not notified with a receive ring)
+bool CLoraNodeSwarm_GetReceivedPacketInfo(void *this, void *pParams)
+{
+  CLoraNodeSwarm pThis = (CLoraNodeSwarm) this;
+
+  xSemaphoreTake(pThis->m_hMutex, portMAX_DELAY);
+  memcpy(((CLoraTransceiverItf_GetReceivedPacketInfoParams) pParams)->m_pPacketInfo,
+         &(pThis->m_ReceivedPacketInfo), sizeof(CLoraTransceiverItf_ReceivedLoraPacketInfoOb));
+  xSemaphoreGive(pThis->m_hMutex);
+  return true;
+}
+
+
+/*********************************************************************************************
+  Construction
+
+  Protected methods : must be called only object factory and 'ILoraTransceiver' interface
+*********************************************************************************************/
+
+/*****************************************************************************************//**
+ * @fn         CLoraNodeSwarm CLoraNodeSwarm_New(BYTE usTransceiverIndex)
+ *
+ * @brief      Object construction.
+ *
+ * @details    The simulated devices assigned to the transceiver are created with their
+ *             DevAddr, first FCnt, spreading factor and signal. The swarm task is started.
+ *
+ * @param      usTransceiverIndex
+ *             The index of the 'LoraTransceiver' in 'CLoraNodeManager'.
+ *
+ * @return     The function returns the pointer to the CLoraNodeSwarm instance or NULL if
+ *             error.
+*********************************************************************************************/
+CLoraNodeSwarm CLoraNodeSwarm_New(BYTE usTransceiverIndex)
+{
+  CLoraNodeSwarm this;
+  CLoraNodeSwarmDevice pDevice;
+  WORD wDeviceIndex = 0;
+  DWORD dwWeightSum = 0;
+  DWORD dwWeight;
+
+  if ((this = (CLoraNodeSwarm) pvPortMalloc(sizeof(CLoraNodeSwarmOb))) == NULL)
+  {
+    return NULL;
+  }
+  memset(this, 0, sizeof(CLoraNodeSwarmOb));
+
+  this->m_usTransceiverIndex = usTransceiverIndex;
+  this->m_dwCurrentState = LORANODESWARM_STATE_CREATED;
+
+  // Default radio settings of 'LoraTransceiver' (LoRaWAN public network)
+  this->m_usFreqChannel = LORATRANSCEIVERITF_FREQUENCY_CHANNEL_00;
+  this->m_usSpreadingFactor = LORATRANSCEIVERITF_SF_7;
+  this->m_usBandwidth = LORATRANSCEIVERITF_BANDWIDTH_125;
+  this->m_usCodingRate = LORATRANSCEIVERITF_CR_5;
+  this->m_wPreambleLength = LORATRANSCEIVERITF_PREAMBLE_LENGTH_LORA;
+  this->m_bHeader = true;
+  this->m_bCRC = true;
+
+  this->m_Statistics.m_nMinTimingError = INT32_MAX;
+  this->m_Statistics.m_nMaxTimingError = INT32_MIN;
+
+  // Pseudo-random generator (different sequence for each transceiver, never 0)
+  this->m_dwRandomState = (g_LoraNodeSwarmConfig.m_dwSeed ^ ((usTransceiverIndex + 1) * 0x9E3779B9)) | 1;
+
+  // Simulated devices assigned to this transceiver
+  for (BYTE i = 0; i < g_LoraNodeSwarmConfig.m_usDevAddrRangeNumber; i++)
+  {
+    this->m_wDeviceNumber += g_LoraNodeSwarmConfig.m_DevAddrRanges[i].m_wNodeNumber;
+  }
+  this->m_wDeviceNumber = (this->m_wDeviceNumber / CONFIG_LORA_TRANSCEIVER_NUMBER) +
+                          ((this->m_wDeviceNumber % CONFIG_LORA_TRANSCEIVER_NUMBER) > usTransceiverIndex ? 1 : 0);
+
+  if ((this->m_wDeviceNumber > 0) &&
+      ((this->m_pDevices = (CLoraNodeSwarmDevice) pvPortMalloc(this->m_wDeviceNumber * sizeof(CLoraNodeSwarmDeviceOb))) == NULL))
+  {
+    CLoraNodeSwarm_Delete(this);
+    return NULL;
+  }
+
+  for (BYTE i = 0; i < LORANODESWARM_SF_NUMBER; i++)
+  {
+    dwWeightSum += g_LoraNodeSwarmConfig.m_usSFWeights[i];
+  }
+
+  pDevice = this->m_pDevices;
+  for (BYTE i = 0; i < g_LoraNodeSwarmConfig.m_usDevAddrRangeNumber; i++)
+  {
+    for (WORD j = 0; j < g_LoraNodeSwarmConfig.m_DevAddrRanges[i].m_wNodeNumber; j++, wDeviceIndex++)
+    {
+      if ((wDeviceIndex % CONFIG_LORA_TRANSCEIVER_NUMBER) != usTransceiverIndex)
+      {
+        continue;
+      }
+
+      pDevice->m_dwDevAddr = g_LoraNodeSwarmConfig.m_DevAddrRanges[i].m_dwFirstDevAddr + j;
+      pDevice->m_wFCnt = g_LoraNodeSwarmConfig.m_wFirstFCnt;
+
+      // Spreading factor drawn with configured weights (SF7 if no weight)
+      pDevice->m_usSpreadingFactor = LORATRANSCEIVERITF_SF_7;
+      if (dwWeightSum > 0)
+      {
+        dwWeight = CLoraNodeSwarm_Random(this) % dwWeightSum;
+        for (BYTE k = 0; k < LORANODESWARM_SF_NUMBER; k++)
+        {
+          if (dwWeight < g_LoraNodeSwarmConfig.m_usSFWeights[k])
+          {
+            pDevice->m_usSpreadingFactor = LORATRANSCEIVERITF_SF_7 + k;
+            break;
+          }
+          dwWeight -= g_LoraNodeSwarmConfig.m_usSFWeights[k];
+        }
+      }
+
+      // Signal: SNR from -10 to +10 dB, RSSI from -120 to -60 dBm
+      pDevice->m_nSNR = (int8_t) (CLoraNodeSwarm_Random(this) % 21) - 10;
+      pDevice->m_nRSSI = (int16_t) (CLoraNodeSwarm_Random(this) % 61) - 120;
+
+      pDevice->m_bConfirmed = false;
+      pDevice->m_bAcknowledged = false;
+      pDevice->m_qwNextUplinkTimestamp = LORANODESWARM_TIMESTAMP_NONE;
+      pDevice->m_qwRX1Timestamp = 0;
+      ++pDevice;
+    }
+  }
+
+  if (((this->m_hMutex = xSemaphoreCreateMutex()) == NULL) ||
+      ((this->m_hTerminated = xSemaphoreCreateBinary()) == NULL))
+  {
+    CLoraNodeSwarm_Delete(this);
+    return NULL;
+  }
+
+  // Create swarm task
+  if (CTaskPlacement_CreateTask(TASKPLACEMENT_TASK_NODESWARM, CLoraNodeSwarm_SwarmTask, this, &(this->m_hSwarmTask)) == false)
+  {
+    this->m_hSwarmTask = NULL;
+    CLoraNodeSwarm_Delete(this);
+    return NULL;
+  }
+
+  return this;
+}
+
+
+/*****************************************************************************************//**
+ * @fn         void CLoraNodeSwarm_Delete(CLoraNodeSwarm this)
+ *
+ * @brief      Object destruction.
+ *
+ * @details    The swarm task is terminated, the RTOS objects are destroyed and the memory used
+ *             by CLoraNodeSwarm object is released.
+ *
+ * @param      this
+ *             The pointer to CLoraNodeSwarm object.
+ *
+ * @return     None.
+*********************************************************************************************/
+void CLoraNodeSwarm_Delete(CLoraNodeSwarm this)
+{
+  // Ask swarm task for termination
+  if (this->m_hSwarmTask != NULL)
+  {
+    xSemaphoreTake(this->m_hMutex, portMAX_DELAY);
+    this->m_dwCurrentState = LORANODESWARM_STATE_TERMINATED;
+    xSemaphoreGive(this->m_hMutex);
+
+    xTaskNotifyGive(this->m_hSwarmTask);
+    xSemaphoreTake(this->m_hTerminated, portMAX_DELAY);
+  }
+
+  if (g_pLoraNodeSwarms[this->m_usTransceiverIndex] == this)
+  {
+    g_pLoraNodeSwarms[this->m_usTransceiverIndex] = NULL;
+  }
+  if (this->m_pLoraTransceiverItf != NULL)
+  {
+    ILoraTransceiver_Delete(this->m_pLoraTransceiverItf);
+  }
+  if (this->m_hMutex != NULL)
+  {
+    vSemaphoreDelete(this->m_hMutex);
+  }
+  if (this->m_hTerminated != NULL)
+  {
+    vSemaphoreDelete(this->m_hTerminated);
+  }
+  if (this->m_pDevices != NULL)
+  {
+    vPortFree(this->m_pDevices);
+  }
+
+  vPortFree(this);
+}
+
+
+/*********************************************************************************************
+  Private methods (implementation)
+
+  Swarm task
+
+  The task emits the uplinks of simulated devices when they are due, starts the bursts of
+  uplinks (bursty arrival) and notifies the end of transmission of downlinks.
+  The task is woken up by the interface methods changing its next wake-up time (i.e.
+  'Receive' and transmission methods).
+*********************************************************************************************/
+
+void CLoraNodeSwarm_SwarmTask(void *pParams)
+{
+  CLoraNodeSwarm this = (CLoraNodeSwarm) pParams;
+  QWORD qwNow;
+  QWORD qwNextEvent;
+  QWORD qwDeviceEvent;
+  TickType_t dwWaitTicks;
+
+  xSemaphoreTake(this->m_hMutex, portMAX_DELAY);
+  while (this->m_dwCurrentState != LORANODESWARM_STATE_TERMINATED)
+  {
+    qwNow = GATEWAY_CLOCK_MICROSEC();
+    qwNextEvent = qwNow + GATEWAY_CLOCK_MS_TO_US(LORANODESWARM_MAX_WAIT);
+
+    // End of transmission
+    if (this->m_dwCurrentState == LORANODESWARM_STATE_SENDING)
+    {
+      if (qwNow >= this->m_qwTxEndTimestamp)
+      {
+        CLoraNodeSwarm_NotifyPacketSent(this);
+      }
+      else if (this->m_qwTxEndTimestamp < qwNextEvent)
+      {
+        qwNextEvent = this->m_qwTxEndTimestamp;
+      }
+    }
+
+    // Uplinks of simulated devices
+    if (this->m_bStarted == true)
+    {
+      if (g_LoraNodeSwarmConfig.m_usArrivalMode == LORANODESWARM_ARRIVAL_BURSTY)
+      {
+        if (qwNow >= this->m_qwNextBurstTimestamp)
+        {
+          CLoraNodeSwarm_StartBurst(this, qwNow);
+        }
+        if (this->m_qwNextBurstTimestamp < qwNextEvent)
+        {
+          qwNextEvent = this->m_qwNextBurstTimestamp;
+        }
+      }
+
+      if ((qwDeviceEvent = CLoraNodeSwarm_ProcessDevices(this, qwNow)) < qwNextEvent)
+      {
+        qwNextEvent = qwDeviceEvent;
+      }
+
+      // Statistics trace
+      if (g_LoraNodeSwarmConfig.m_dwReportPeriod > 0)
+      {
+        if (qwNow >= this->m_qwNextReportTimestamp)
+        {
+          CLoraNodeSwarm_TraceStatistics(this);
+          this->m_qwNextReportTimestamp = qwNow + GATEWAY_CLOCK_MS_TO_US(g_LoraNodeSwarmConfig.m_dwReportPeriod);
+        }
+        if (this->m_qwNextReportTimestamp < qwNextEvent)
+        {
+          qwNextEvent = this->m_qwNextReportTimestamp;
+        }
+      }
+    }
+    xSemaphoreGive(this->m_hMutex);
+
+    // Wait for next event (at least one tick, i.e. the uplinks due during the tick are emitted
+    // together)
+    dwWaitTicks = pdMS_TO_TICKS((DWORD) ((qwNextEvent - qwNow) / 1000));
+    ulTaskNotifyTake(pdTRUE, dwWaitTicks > 0 ? dwWaitTicks : 1);
+
+    xSemaphoreTake(this->m_hMutex, portMAX_DELAY);
+  }
+  xSemaphoreGive(this->m_hMutex);
+
+  // Swarm task terminated ('CLoraNodeSwarm' being deleted)
+  xSemaphoreGive(this->m_hTerminated);
+  vTaskDelete(NULL);
+}
+
+
+// Schedules the first uplink of simulated devices
+// Poisson arrival: first uplinks spread over the mean period (i.e. no synchronized start)
+void CLoraNodeSwarm_StartDevices(CLoraNodeSwarm this, QWORD qwNow)
+{
+  for (WORD i = 0; i < this->m_wDeviceNumber; i++)
+  {
+    if (g_LoraNodeSwarmConfig.m_usArrivalMode == LORANODESWARM_ARRIVAL_POISSON)
+    {
+      this->m_pDevices[i].m_qwNextUplinkTimestamp = qwNow +
+        GATEWAY_CLOCK_MS_TO_US(CLoraNodeSwarm_Random(this) % (g_LoraNodeSwarmConfig.m_dwMeanPeriod + 1));
+    }
+  }
+
+  this->m_qwNextBurstTimestamp = qwNow;
+  this->m_qwNextReportTimestamp = qwNow + GATEWAY_CLOCK_MS_TO_US(g_LoraNodeSwarmConfig.m_dwReportPeriod);
+  this->m_bStarted = true;
+}
+
+
+// Emits the uplinks due
+// Returns the gateway clock of the next uplink
+QWORD CLoraNodeSwarm_ProcessDevices(CLoraNodeSwarm this, QWORD qwNow)
+{
+  CLoraNodeSwarmDevice pDevice = this->m_pDevices;
+  QWORD qwNextUplink = LORANODESWARM_TIMESTAMP_NONE;
+
+  for (WORD i = 0; i < this->m_wDeviceNumber; i++, pDevice++)
+  {
+    if (pDevice->m_qwNextUplinkTimestamp <= qwNow)
+    {
+      CLoraNodeSwarm_EmitUplink(this, pDevice, qwNow);
+    }
+    if (pDevice->m_qwNextUplinkTimestamp < qwNextUplink)
+    {
+      qwNextUplink = pDevice->m_qwNextUplinkTimestamp;
+    }
+  }
+  return qwNextUplink;
+}
+
+
+// Bursty arrival: schedules the uplinks of 'm_wBurstSize' random devices within 'm_dwBurstSpread'
+// Note: The uplink of a device still waiting for its RX windows is delayed
+void CLoraNodeSwarm_StartBurst(CLoraNodeSwarm this, QWORD qwNow)
+{
+  CLoraNodeSwarmDevice pDevice;
+  QWORD qwUplink;
+  QWORD qwEarliest;
+
+  for (WORD i = 0; (i < g_LoraNodeSwarmConfig.m_wBurstSize) && (this->m_wDeviceNumber > 0); i++)
+  {
+    pDevice = &(this->m_pDevices[CLoraNodeSwarm_Random(this) % this->m_wDeviceNumber]);
+    qwUplink = qwNow + GATEWAY_CLOCK_MS_TO_US(CLoraNodeSwarm_Random(this) % (g_LoraNodeSwarmConfig.m_dwBurstSpread + 1));
+
+    if (pDevice->m_qwRX1Timestamp != 0)
+    {
+      qwEarliest = pDevice->m_qwRX1Timestamp - LORANODESWARM_CLASSA_RECEIVE_DELAY1 + LORANODESWARM_CLASSA_MIN_UPLINK_DELAY;
+      qwUplink = qwUplink > qwEarliest ? qwUplink : qwEarliest;
+    }
+    if (qwUplink < pDevice->m_qwNextUplinkTimestamp)
+    {
+      pDevice->m_qwNextUplinkTimestamp = qwUplink;
+    }
+  }
+
+  this->m_qwNextBurstTimestamp += GATEWAY_CLOCK_MS_TO_US(g_LoraNodeSwarmConfig.m_dwBurstPeriod);
+  if (this->m_qwNextBurstTimestamp <= qwNow)
+  {
+    // Burst period too short for the task (or null)
+    this->m_qwNextBurstTimestamp = qwNow + GATEWAY_CLOCK_MS_TO_US(LORANODESWARM_MAX_WAIT);
+  }
+}
+
+
+/*****************************************************************************************//**
+ * @fn         void CLoraNodeSwarm_EmitUplink(CLoraNodeSwarm this, CLoraNodeSwarmDevice pDevice,
+ *                                            QWORD qwNow)
+ *
+ * @brief      Emits the next uplink of a simulated device.
+ *
+ * @details    The uplink ends at 'qwNow' (i.e. 'RxDone' time). The uplink is received if the
+ *             transceiver is in receive mode and was not sending during the time-on-air of the
+ *             uplink.\n
+ *             The RX windows of the device are opened and its next uplink is scheduled.
+ *
+ * @param      this
+ *             The pointer to CLoraNodeSwarm object.
+ *
+ * @param      pDevice
+ *             The simulated device.
+ *
+ * @param      qwNow
+ *             The gateway clock.
+ *
+ * @return     None.
+*********************************************************************************************/
+void CLoraNodeSwarm_EmitUplink(CLoraNodeSwarm this, CLoraNodeSwarmDevice pDevice, QWORD qwNow)
+{
+  BYTE usPayloadLength;
+  DWORD dwAirtime;
+
+  // Result of RX windows of previous uplink
+  if ((pDevice->m_bConfirmed == true) && (pDevice->m_bAcknowledged == false))
+  {
+    ++this->m_Statistics.m_dwMissedAckNumber;
+  }
+
+  usPayloadLength = g_LoraNodeSwarmConfig.m_usMinPayloadLength;
+  if (g_LoraNodeSwarmConfig.m_usMaxPayloadLength > usPayloadLength)
+  {
+    usPayloadLength += CLoraNodeSwarm_Random(this) % (g_LoraNodeSwarmConfig.m_usMaxPayloadLength - usPayloadLength + 1);
+  }
+  if (usPayloadLength > LORANODESWARM_MAX_FRMPAYLOAD_LENGTH)
+  {
+    usPayloadLength = LORANODESWARM_MAX_FRMPAYLOAD_LENGTH;
+  }
+
+  pDevice->m_bConfirmed = (CLoraNodeSwarm_Random(this) % 100) < g_LoraNodeSwarmConfig.m_usConfirmedPercent;
+  pDevice->m_bAcknowledged = false;
+
+  ++this->m_Statistics.m_dwUplinkNumber;
+  if (pDevice->m_bConfirmed == true)
+  {
+    ++this->m_Statistics.m_dwConfirmedNumber;
+  }
+
+  // Half-duplex: uplink lost if the transceiver is not receiving or has been sending during
+  // the uplink
+  dwAirtime = CLoraDutyCycle_GetTimeOnAir(pDevice->m_usSpreadingFactor, LORATRANSCEIVERITF_BANDWIDTH_125, LORATRANSCEIVERITF_CR_5,
+                                          LORATRANSCEIVERITF_PREAMBLE_LENGTH_LORA, true, true,
+                                          LORANODESWARM_FRAME_HEADER_LENGTH + usPayloadLength + LORANODESWARM_FRAME_MIC_LENGTH);
+  if ((this->m_dwCurrentState != LORANODESWARM_STATE_RECEIVING) || (qwNow < this->m_qwTxEndTimestamp + dwAirtime))
+  {
+    ++this->m_Statistics.m_dwNotListeningNumber;
+  }
+  else if (CLoraNodeSwarm_DeliverUplink(this, pDevice, qwNow, usPayloadLength) == false)
+  {
+    ++this->m_Statistics.m_dwMissedNumber;
+  }
+  else
+  {
+    ++this->m_Statistics.m_dwReceivedNumber;
+  }
+
+  // Class A device: RX windows after the uplink
+  pDevice->m_qwRX1Timestamp = qwNow + LORANODESWARM_CLASSA_RECEIVE_DELAY1;
+  pDevice->m_wFCnt += g_LoraNodeSwarmConfig.m_usFCntStep;
+  CLoraNodeSwarm_ScheduleUplink(this, pDevice, qwNow);
+}
+
+
+// Stores the uplink frame of a device in a shared packet buffer and notifies the owner object
+// Returns false if no packet buffer or receive ring slot is available
+bool CLoraNodeSwarm_DeliverUplink(CLoraNodeSwarm this, CLoraNodeSwarmDevice pDevice, QWORD qwNow, BYTE usPayloadLength)
+{
+  CWideMemoryBlockArrayEntryOb MemBlockEntry;
+  CLoraTransceiverItf_LoraPacket pPacket;
+  CLoraTransceiverItf_ReceiveSlot pReceiveSlot = NULL;
+  CLoraTransceiverItf_EventOb EventOb;
+  CLoraTransceiverItf_ReceivedLoraPacketInfo pPacketInfo;
+  struct timeval tmNow;
+  BYTE *pData;
+  DWORD dwLength;
+
+  if ((this->m_pReceiveRing != NULL) &&
+      ((pReceiveSlot = (CLoraTransceiverItf_ReceiveSlot) CSpscRing_GetWriteSlot(this->m_pReceiveRing)) == NULL))
+  {
+    return false;
+  }
+
+  if ((pPacket = (CLoraTransceiverItf_LoraPacket) CWideMemoryBlockArray_GetBlock(this->m_pLoraPacketPool, &MemBlockEntry)) == NULL)
+  {
+    return false;
+  }
+
+  // Data message (MHDR, DevAddr, FCtrl, FCnt, FPort, FRMPayload, MIC), little endian fields
+  pData = pPacket->m_usData;
+  pData[0] = pDevice->m_bConfirmed == true ? LORANODESWARM_MHDR_CONFIRMED_UP : LORANODESWARM_MHDR_UNCONFIRMED_UP;
+  pData[1] = (BYTE) pDevice->m_dwDevAddr;
+  pData[2] = (BYTE) (pDevice->m_dwDevAddr >> 8);
+  pData[3] = (BYTE) (pDevice->m_dwDevAddr >> 16);
+  pData[4] = (BYTE) (pDevice->m_dwDevAddr >> 24);
+  pData[5] = 0x00;
+  pData[6] = (BYTE) pDevice->m_wFCnt;
+  pData[7] = (BYTE) (pDevice->m_wFCnt >> 8);
+  pData[8] = g_LoraNodeSwarmConfig.m_usFPort;
+
+  dwLength = LORANODESWARM_FRAME_HEADER_LENGTH + usPayloadLength + LORANODESWARM_FRAME_MIC_LENGTH;
+  for (DWORD i = LORANODESWARM_FRAME_HEADER_LENGTH; i < dwLength; i++)
+  {
+    pData[i] = (BYTE) CLoraNodeSwarm_Random(this);
+  }
+
+  pPacket->m_qwTimestamp = qwNow;
+  pPacket->m_dwDataSize = dwLength;
+
+  // Additional information for received packet
+  pPacketInfo = pReceiveSlot != NULL ? &(pReceiveSlot->m_PacketInfo) : &(this->m_ReceivedPacketInfo);
+  gettimeofday(&tmNow, NULL);
+  pPacketInfo->m_dwUTCSec = (DWORD) tmNow.tv_sec;
+  pPacketInfo->m_dwUTCMicroSec = (DWORD) tmNow.tv_usec;
+  strcpy((char *) pPacketInfo->m_szFrequency, g_szLoraNodeSwarmFreqText[this->m_usFreqChannel]);
+  snprintf((char *) pPacketInfo->m_szDataRate, sizeof(pPacketInfo->m_szDataRate), "SF%uBW125", (unsigned int) pDevice->m_usSpreadingFactor);
+  strcpy((char *) pPacketInfo->m_szCodingRate, "4/5");
+  snprintf((char *) pPacketInfo->m_szSNR, sizeof(pPacketInfo->m_szSNR), "%.1lf", (double) pDevice->m_nSNR);
+  snprintf((char *) pPacketInfo->m_szRSSI, sizeof(pPacketInfo->m_szRSSI), "%d", (int) pDevice->m_nRSSI);
+
+  EventOb.m_wEventType = LORATRANSCEIVERITF_EVENT_PACKETRECEIVED;
+  EventOb.m_pLoraTransceiverItf = this->m_pLoraTransceiverItf;
+  EventOb.m_pEventData = pPacket;
+
+  // With receive ring, the reference on the block is owned by the ring (i.e. the event only
+  // signals the ring and may be lost if the event queue is full)
+  if (pReceiveSlot != NULL)
+  {
+    pReceiveSlot->m_pPacket = pPacket;
+    CSpscRing_CommitWrite(this->m_pReceiveRing);
+    xQueueSend(this->m_hEventNotifyQueue, &EventOb, 0);
+    return true;
+  }
+
+  if (xQueueSend(this->m_hEventNotifyQueue, &EventOb, 0) != pdPASS)
+  {
+    CWideMemoryBlockArray_ReleaseRef(this->m_pLoraPacketPool, MemBlockEntry.m_wBlockIndex);
+    return false;
+  }
+  return true;
+}
+
+
+// Schedules the next uplink of a device
+// Poisson arrival: exponential interval, not before the end of RX windows of current uplink
+// Bursty arrival: uplink scheduled by a next burst
+void CLoraNodeSwarm_ScheduleUplink(CLoraNodeSwarm this, CLoraNodeSwarmDevice pDevice, QWORD qwNow)
+{
+  QWORD qwInterval;
+
+  if (g_LoraNodeSwarmConfig.m_usArrivalMode == LORANODESWARM_ARRIVAL_POISSON)
+  {
+    qwInterval = GATEWAY_CLOCK_MS_TO_US(CLoraNodeSwarm_RandomExponential(this, g_LoraNodeSwarmConfig.m_dwMeanPeriod));
+    pDevice->m_qwNextUplinkTimestamp = qwNow + (qwInterval > LORANODESWARM_CLASSA_MIN_UPLINK_DELAY ?
+                                                qwInterval : LORANODESWARM_CLASSA_MIN_UPLINK_DELAY);
+  }
+  else
+  {
+    pDevice->m_qwNextUplinkTimestamp = LORANODESWARM_TIMESTAMP_NONE;
+  }
+}
+
+
+/*********************************************************************************************
+  Private methods (implementation)
+
+  Downlinks
+*********************************************************************************************/
+
+// Starts the transmission of the armed packet (i.e. uplinks not received until end of
+// time-on-air) and records the downlink
+void CLoraNodeSwarm_FireArmedPacket(CLoraNodeSwarm this, QWORD qwNow)
+{
+  CLoraTransceiverItf_LoraPacket pPacket = this->m_pPacketToSend;
+
+  pPacket->m_qwTimestamp = qwNow;
+  this->m_qwTxEndTimestamp = qwNow + CLoraDutyCycle_GetTimeOnAir(this->m_usSpreadingFactor, this->m_usBandwidth, this->m_usCodingRate,
+                                                                 this->m_wPreambleLength, this->m_bHeader, this->m_bCRC,
+                                                                 pPacket->m_dwDataSize);
+  this->m_dwCurrentState = LORANODESWARM_STATE_SENDING;
+
+  CLoraNodeSwarm_RecordDownlink(this, pPacket, qwNow);
+}
+
+
+/*****************************************************************************************//**
+ * @fn         void CLoraNodeSwarm_RecordDownlink(CLoraNodeSwarm this,
+ *                                    CLoraTransceiverItf_LoraPacket pPacket, QWORD qwFireTimestamp)
+ *
+ * @brief      Records a downlink sent to a simulated device.
+ *
+ * @details    The timing error is computed relative to the start of nearest RX window of last
+ *             uplink of the device. The downlink is received by the device if the error is
+ *             within 'm_dwRxWindowTolerance' (i.e. the 'ACK' of a confirmed uplink is
+ *             received).\n
+ *             Join-accept and downlinks for other devices are only counted.
+ *
+ * @param      this
+ *             The pointer to CLoraNodeSwarm object.
+ *
+ * @param      pPacket
+ *             The packet sent.
+ *
+ * @param      qwFireTimestamp
+ *             The gateway clock at start of transmission.
+ *
+ * @return     None.
+*********************************************************************************************/
+void CLoraNodeSwarm_RecordDownlink(CLoraNodeSwarm this, CLoraTransceiverItf_LoraPacket pPacket, QWORD qwFireTimestamp)
+{
+  CLoraNodeSwarmStatistics pStatistics = &(this->m_Statistics);
+  CLoraNodeSwarmDevice pDevice = NULL;
+  BYTE *pData = pPacket->m_usData;
+  BYTE usMessageType;
+  BYTE usRxWindow;
+  int64_t nError[LORANODESWARM_RXWINDOW_NUMBER];
+  int64_t nAbsError[LORANODESWARM_RXWINDOW_NUMBER];
+  int32_t nTimingError;
+
+  ++pStatistics->m_dwDownlinkNumber;
+
+  usMessageType = pData[0] & LORANODESWARM_MHDR_TYPE_MASK;
+  if ((pPacket->m_dwDataSize >= LORANODESWARM_FRAME_HEADER_LENGTH - 1) &&
+      ((usMessageType == LORANODESWARM_MHDR_UNCONFIRMED_DOWN) || (usMessageType == LORANODESWARM_MHDR_CONFIRMED_DOWN)))
+  {
+    pDevice = CLoraNodeSwarm_FindDevice(this, (DWORD) pData[1] | ((DWORD) pData[2] << 8) | ((DWORD) pData[3] << 16) |
+                                              ((DWORD) pData[4] << 24));
+  }
+
+  if ((pDevice == NULL) || (pDevice->m_qwRX1Timestamp == 0))
+  {
+    ++pStatistics->m_dwUnknownDeviceNumber;
+    return;
+  }
+
+  // Nearest RX window
+  nError[LORANODESWARM_RXWINDOW_RX1] = (int64_t) (qwFireTimestamp - pDevice->m_qwRX1Timestamp);
+  nError[LORANODESWARM_RXWINDOW_RX2] = (int64_t) (qwFireTimestamp - (pDevice->m_qwRX1Timestamp +
+                                       LORANODESWARM_CLASSA_RECEIVE_DELAY2 - LORANODESWARM_CLASSA_RECEIVE_DELAY1));
+  for (usRxWindow = 0; usRxWindow < LORANODESWARM_RXWINDOW_NUMBER; usRxWindow++)
+  {
+    nAbsError[usRxWindow] = nError[usRxWindow] < 0 ? -nError[usRxWindow] : nError[usRxWindow];
+  }
+  usRxWindow = nAbsError[LORANODESWARM_RXWINDOW_RX1] <= nAbsError[LORANODESWARM_RXWINDOW_RX2] ?
+               LORANODESWARM_RXWINDOW_RX1 : LORANODESWARM_RXWINDOW_RX2;
+
+  if (nAbsError[usRxWindow] > g_LoraNodeSwarmConfig.m_dwRxWindowTolerance)
+  {
+    // Device not listening (the error of a late downlink is not meaningful)
+    ++pStatistics->m_dwOutOfWindowNumber;
+    return;
+  }
+
+  nTimingError = (int32_t) nError[usRxWindow];
+  ++pStatistics->m_dwRxWindowNumber[usRxWindow];
+  pStatistics->m_qwAbsTimingErrorSum += (QWORD) nAbsError[usRxWindow];
+  if (nTimingError < pStatistics->m_nMinTimingError)
+  {
+    pStatistics->m_nMinTimingError = nTimingError;
+  }
+  if (nTimingError > pStatistics->m_nMaxTimingError)
+  {
+    pStatistics->m_nMaxTimingError = nTimingError;
+  }
+
+  // Acknowledge of confirmed uplink (only one downlink per uplink)
+  if ((pDevice->m_bConfirmed == true) && (pDevice->m_bAcknowledged == false) &&
+      (pPacket->m_dwDataSize > 5) && ((pData[5] & LORANODESWARM_FCTRL_ACK) != 0))
+  {
+    pDevice->m_bAcknowledged = true;
+    ++pStatistics->m_dwAckNumber;
+  }
+}
+
+
+// End of transmission: the 'PACKETSENT' event is notified to owner object
+void CLoraNodeSwarm_NotifyPacketSent(CLoraNodeSwarm this)
+{
+  CLoraTransceiverItf_EventOb EventOb;
+
+  this->m_dwCurrentState = g_LoraNodeSwarmConfig.m_bResumeReceive == true ? LORANODESWARM_STATE_RECEIVING :
+                                                                            LORANODESWARM_STATE_STANDBY;
+
+  EventOb.m_wEventType = LORATRANSCEIVERITF_EVENT_PACKETSENT;
+  EventOb.m_pLoraTransceiverItf = this->m_pLoraTransceiverItf;
+  EventOb.m_pEventData = this->m_pPacketToSend;
+  if (xQueueSend(this->m_hEventNotifyQueue, &EventOb, 0) != pdPASS)
+  {
+    #if (LORANODESWARM_DEBUG_LEVEL0)
+      DEBUG_PRINT_LN("[ERROR] CLoraNodeSwarm_NotifyPacketSent, event notification queue full");
+    #endif
+  }
+  this->m_pPacketToSend = NULL;
+}
+
+
+// Retrieves a simulated device of this object with its DevAddr
+// Returns NULL if the device is not simulated by this object
+CLoraNodeSwarmDevice CLoraNodeSwarm_FindDevice(CLoraNodeSwarm this, DWORD dwDevAddr)
+{
+  WORD wDeviceIndex = 0;
+  CLoraNodeSwarmDevAddrRangeOb const *pRange;
+
+  // Index of device in swarm configuration (i.e. consecutive DevAddr in each range)
+  for (BYTE i = 0; i < g_LoraNodeSwarmConfig.m_usDevAddrRangeNumber; i++)
+  {
+    pRange = &(g_LoraNodeSwarmConfig.m_DevAddrRanges[i]);
+    if ((dwDevAddr >= pRange->m_dwFirstDevAddr) && (dwDevAddr - pRange->m_dwFirstDevAddr < pRange->m_wNodeNumber))
+    {
+      wDeviceIndex += (WORD) (dwDevAddr - pRange->m_dwFirstDevAddr);
+      if ((wDeviceIndex % CONFIG_LORA_TRANSCEIVER_NUMBER) != this->m_usTransceiverIndex)
+      {
+        return NULL;
+      }
+      return &(this->m_pDevices[wDeviceIndex / CONFIG_LORA_TRANSCEIVER_NUMBER]);
+    }
+    wDeviceIndex += pRange->m_wNodeNumber;
+  }
+  return NULL;
+}
+
+
+// Traces the statistics of simulated devices
+void CLoraNodeSwarm_TraceStatistics(CLoraNodeSwarm this)
+{
+  #if (LORANODESWARM_DEBUG_LEVEL0)
+    CLoraNodeSwarmStatistics pStatistics = &(this->m_Statistics);
+    DWORD dwInWindowNumber = pStatistics->m_dwRxWindowNumber[LORANODESWARM_RXWINDOW_RX1] +
+                             pStatistics->m_dwRxWindowNumber[LORANODESWARM_RXWINDOW_RX2];
+
+    DEBUG_PRINT("[INFO] Node swarm ");
+    DEBUG_PRINT_DEC(this->m_usTransceiverIndex);
+    DEBUG_PRINT(", uplinks: ");
+    DEBUG_PRINT_DEC(pStatistics->m_dwUplinkNumber);
+    DEBUG_PRINT(" (confirmed: ");
+    DEBUG_PRINT_DEC(pStatistics->m_dwConfirmedNumber);
+    DEBUG_PRINT("), received: ");
+    DEBUG_PRINT_DEC(pStatistics->m_dwReceivedNumber);
+    DEBUG_PRINT(", not listening: ");
+    DEBUG_PRINT_DEC(pStatistics->m_dwNotListeningNumber);
+    DEBUG_PRINT(", missed: ");
+    DEBUG_PRINT_DEC(pStatistics->m_dwMissedNumber);
+    DEBUG_PRINT_CR;
+
+    DEBUG_PRINT("[INFO] Node swarm ");
+    DEBUG_PRINT_DEC(this->m_usTransceiverIndex);
+    DEBUG_PRINT(", downlinks: ");
+    DEBUG_PRINT_DEC(pStatistics->m_dwDownlinkNumber);
+    DEBUG_PRINT(", RX1: ");
+    DEBUG_PRINT_DEC(pStatistics->m_dwRxWindowNumber[LORANODESWARM_RXWINDOW_RX1]);
+    DEBUG_PRINT(", RX2: ");
+    DEBUG_PRINT_DEC(pStatistics->m_dwRxWindowNumber[LORANODESWARM_RXWINDOW_RX2]);
+    DEBUG_PRINT(", out of window: ");
+    DEBUG_PRINT_DEC(pStatistics->m_dwOutOfWindowNumber);
+    DEBUG_PRINT(", unknown device: ");
+    DEBUG_PRINT_DEC(pStatistics->m_dwUnknownDeviceNumber);
+    DEBUG_PRINT(", acks: ");
+    DEBUG_PRINT_DEC(pStatistics->m_dwAckNumber);
+    DEBUG_PRINT(", missed acks: ");
+    DEBUG_PRINT_DEC(pStatistics->m_dwMissedAckNumber);
+    DEBUG_PRINT_CR;
+
+    if (dwInWindowNumber > 0)
+    {
+      DEBUG_PRINT("[INFO] Node swarm ");
+      DEBUG_PRINT_DEC(this->m_usTransceiverIndex);
+      DEBUG_PRINT(", downlink timing error (us), min: ");
+      DEBUG_PRINT_DEC(pStatistics->m_nMinTimingError);
+      DEBUG_PRINT(", max: ");
+      DEBUG_PRINT_DEC(pStatistics->m_nMaxTimingError);
+      DEBUG_PRINT(", average absolute: ");
+      DEBUG_PRINT_DEC((DWORD) (pStatistics->m_qwAbsTimingErrorSum / dwInWindowNumber));
+      DEBUG_PRINT_CR;
+    }
+  #endif
+}
+
+
+/*********************************************************************************************
+  Private methods (implementation)
+
+  Pseudo-random generator
+*********************************************************************************************/
+
+// Next value of xorshift32 generator
+DWORD CLoraNodeSwarm_Random(CLoraNodeSwarm this)
+{
+  DWORD dwState = this->m_dwRandomState;
+
+  dwState ^= dwState << 13;
+  dwState ^= dwState >> 17;
+  dwState ^= dwState << 5;
+  this->m_dwRandomState = dwState;
+  return dwState;
+}
+
+// Exponential distribution with mean 'dwMean' (i.e. interval between events of a Poisson process)
+DWORD CLoraNodeSwarm_RandomExponential(CLoraNodeSwarm this, DWORD dwMean)
+{
+  double dUniform;
+
+  // Uniform in ]0, 1]
+  dUniform = ((double) CLoraNodeSwarm_Random(this) + 1.0) / 4294967296.0;
+  return (DWORD) (-log(dUniform) * (double) dwMean);
+}
+
+
+#endif
@@ -33,6 +33,11 @@
 
 #include <Common.h>
 
+#ifndef ESP_PLATFORM
+  #include <errno.h>
+  #include <time.h>
+#endif
+
 /*********************************************************************************************
   Includes for object implementation
 *********************************************************************************************/
@@ -44,6 +49,7 @@
 #include "TransceiverManagerItf.h"
 #include "LoraRealtimeSenderItf.h"
 #include "Configuration.h"
+#include "TaskPlacement.h"
 
 // Object's definitions and methods
 #include "LoraRealtimeSender.h"
@@ -186,6 +192,10 @@ bool CLoraRealtimeSender_Initialize(void *this, CLoraRealtimeSenderItf_Initializ
   if (((CLoraRealtimeSender *)this)->m_dwCurrentState == LORAREALTIMESENDER_AUTOMATON_STATE_CREATED)
   {
     ((CLoraRealtimeSender *)this)->m_pTransceiverManagerItf = pParams->m_pTransceiverManagerItf;
+    if (pParams->m_pTxStatistics != NULL)
+    {
+      ((CLoraRealtimeSender *)this)->m_pTxStatistics = pParams->m_pTxStatistics;
+    }
     ((CLoraRealtimeSender *)this)->m_dwCurrentState = LORAREALTIMESENDER_AUTOMATON_STATE_INITIALIZED;
     return true;
   }
@@ -254,21 +264,25 @@ bool CLoraRealtimeSender_RegisterNodeRxWindows(void *this,
                                                CLoraRealtimeSenderItf_RegisterNodeRxWindowsParams pParams)
 {
   CNodeReceiveWindow pNodeReceiveWindow;
-  CMemoryBlockArrayEntryOb MemBlockEntry;
+  CWideMemoryBlockArrayEntryOb MemBlockEntry;
 
   // Obtain an entry in 'm_pNodeReceiveWindowArray' array
   // The RX window definition depends on LoRa class of device
   if (pParams->m_usDeviceClass == LORAREALTIMESENDER_DEVICECLASS_A)
   {
+    xSemaphoreTake(((CLoraRealtimeSender *) this)->m_hReceiveWindowMutex, portMAX_DELAY);
+
     // Sanity check: 
     //  - For LoRa class A, a given node cannot send another uplink packet until duration for
     //    RX windows is elapsed.
     //  - The periodical cleanup for expired entries in 'm_pNodeReceiveWindowArray' array may
     //    have not processed the entry yet.
-    if ((pNodeReceiveWindow = CLoraRealtimeSender_FindNodeReceiveWindow((CLoraRealtimeSender *) this, pParams->m_dwDeviceAddr, false)) != NULL)
+    // Note: The 'Join Request' entries are not indexed by device address
+    if ((pParams->m_bJoinRequest == false) &&
+        ((pNodeReceiveWindow = CLoraRealtimeSender_FindNodeReceiveWindow((CLoraRealtimeSender *) this, pParams->m_dwDeviceAddr, false)) != NULL))
     {
       // The new uplink packet must be received after last RX window duration of previous packet is elapsed
-      if (pParams->m_dwRXTimestamp < pNodeReceiveWindow->m_dwRX2WindowTimestamp + LORAREALTIMESENDER_LORAWAN_RX_WINDOW_LENGTH)
+      if (pParams->m_qwRXTimestamp < pNodeReceiveWindow->m_qwRX2WindowTimestamp + LORAREALTIMESENDER_LORAWAN_RX_WINDOW_LENGTH)
       {
         // Should never occur
         // Maybe adjust 'LORAREALTIMESENDER_CLASSA_RX_PREAMBLE_RATIO' (some nodes may have very small
@@ -276,33 +290,56 @@ bool CLoraRealtimeSender_RegisterNodeRxWindows(void *this,
         #if (LORAREALTIMESENDER_DEBUG_LEVEL0)
           DEBUG_PRINT_LN("[ERROR] CLoraRealtimeSender_RegisterNodeRxWindows - Uplink packet received too early");
         #endif
+        xSemaphoreGive(((CLoraRealtimeSender *) this)->m_hReceiveWindowMutex);
         return false;
       }
 
-      // Note: 
-      //  - By design, the periodical cleanup must remove this entry before the downlink packet is received
-      //  - A new entry is always used for the received uplink packet
+      // Note: A new entry is always used for the received uplink packet (i.e. the entry of
+      //       previous packet is removed now instead of by the periodical cleanup)
+      CLoraRealtimeSender_RemoveNodeReceiveWindow((CLoraRealtimeSender *) this, 
+        CWideMemoryBlockArray_BlockIndexFromPtr(((CLoraRealtimeSender *) this)->m_pNodeReceiveWindowArray, pNodeReceiveWindow));
     }
 
-    if ((pNodeReceiveWindow = (CNodeReceiveWindow) CMemoryBlockArray_GetBlock(((CLoraRealtimeSender *) this)->m_pNodeReceiveWindowArray, &MemBlockEntry)) == NULL)
+    if ((pNodeReceiveWindow = (CNodeReceiveWindow) CWideMemoryBlockArray_GetBlock(((CLoraRealtimeSender *) this)->m_pNodeReceiveWindowArray, &MemBlockEntry)) == NULL)
     {
       // Should never occur
       #if (LORAREALTIMESENDER_DEBUG_LEVEL0)
         DEBUG_PRINT_LN("[ERROR] CLoraRealtimeSender_RegisterNodeRxWindows - NodeReceiveWindow array full");
       #endif
+      xSemaphoreGive(((CLoraRealtimeSender *) this)->m_hReceiveWindowMutex);
       return false;
     }
 
     // Compute start times of RX windows
-    pNodeReceiveWindow->m_dwRX1WindowTimestamp = pParams->m_dwRXTimestamp + LORAREALTIMESENDER_CLASSA_RECEIVE_DELAY1;
-    pNodeReceiveWindow->m_dwRX2WindowTimestamp = pParams->m_dwRXTimestamp + LORAREALTIMESENDER_CLASSA_RECEIVE_DELAY2;
+    pNodeReceiveWindow->m_qwRX1WindowTimestamp = pParams->m_qwRXTimestamp + (pParams->m_bJoinRequest == true ?
+                                                 LORAREALTIMESENDER_CLASSA_JOIN_ACCEPT_DELAY1 : LORAREALTIMESENDER_CLASSA_RECEIVE_DELAY1);
+    pNodeReceiveWindow->m_qwRX2WindowTimestamp = pParams->m_qwRXTimestamp + (pParams->m_bJoinRequest == true ?
+                                                 LORAREALTIMESENDER_CLASSA_JOIN_ACCEPT_DELAY2 : LORAREALTIMESENDER_CLASSA_RECEIVE_DELAY2);
 
     pNodeReceiveWindow->m_usDeviceClass = pParams->m_usDeviceClass;
     pNodeReceiveWindow->m_dwDeviceAddr = pParams->m_dwDeviceAddr;
     pNodeReceiveWindow->m_pLoraTransceiverItf = pParams->m_pLoraTransceiverItf;
+    pNodeReceiveWindow->m_bJoinRequest = pParams->m_bJoinRequest;
+    memcpy(pNodeReceiveWindow->m_RxRadio, pParams->m_RxRadio, sizeof(pNodeReceiveWindow->m_RxRadio));
 
     // Allow other tasks to use this entry
-    CMemoryBlockArray_SetBlockReady(((CLoraRealtimeSender *) this)->m_pNodeReceiveWindowArray, MemBlockEntry.m_usBlockIndex);
+    CWideMemoryBlockArray_SetBlockReady(((CLoraRealtimeSender *) this)->m_pNodeReceiveWindowArray, MemBlockEntry.m_wBlockIndex);
+
+    // Entry indexed by device address and by expiration time (i.e. same expiration as checked
+    // by 'CLoraRealtimeSender_FindNodeReceiveWindow')
+    if ((pParams->m_bJoinRequest == false) &&
+        (CHashIndex_Insert(((CLoraRealtimeSender *) this)->m_pNodeReceiveWindowIndex, MemBlockEntry.m_wBlockIndex, 
+                           pParams->m_dwDeviceAddr) == false))
+    {
+      // Should never occur (index created for the size of 'm_pNodeReceiveWindowArray')
+      #if (LORAREALTIMESENDER_DEBUG_LEVEL0)
+        DEBUG_PRINT_LN("[ERROR] CLoraRealtimeSender_RegisterNodeRxWindows - Block index outside of device address index");
+      #endif
+    }
+    CMinHeap_Insert(((CLoraRealtimeSender *) this)->m_pNodeReceiveWindowExpiryHeap, MemBlockEntry.m_wBlockIndex,
+                    pNodeReceiveWindow->m_qwRX2WindowTimestamp + (LORAREALTIMESENDER_LORAWAN_RX_WINDOW_LENGTH - LORAREALTIMESENDER_GATEWAY_TX_DELAY));
+
+    xSemaphoreGive(((CLoraRealtimeSender *) this)->m_hReceiveWindowMutex);
   }
   else
   {
@@ -328,9 +365,16 @@ bool CLoraRealtimeSender_RegisterNodeRxWindows(void *this,
  *                packet from Network Server.\n
  *              - The function checks when an RX window will be active on destination node
  *                by looking in 'm_pNodeReceiveWindowArray' array.\n
- *              - If an active RX window is retrieved and no schedule collision is detected
- *                on the transceiver, a new entry is inserted in the 'm_pRealtimeLoraPacketArray'
- *                array.\n
+ *              - The RX1 window is used if the transmission is possible: not too late, no
+ *                other transmission on the transceiver during the time-on-air of the packet
+ *                and duty-cycle budget of the sub-band not exhausted. Otherwise, the RX2
+ *                window is checked the same way.\n
+ *              - If the send time is requested by Network Server, only the RX window 
+ *                including this time is checked (or the packet is sent as soon as possible
+ *                for an 'immediate' request).\n
+ *              - If an RX window is available, a new entry is inserted in the
+ *                'm_pRealtimeLoraPacketArray' array and the transmission time is reserved
+ *                in the duty-cycle ledger.\n
  *              - The 'SenderTask' looks in 'm_pNodeReceiveWindowArray' array and send the
  *                LoRa packets at the scheduled time.\n
  * 
@@ -343,15 +387,24 @@ bool CLoraRealtimeSender_RegisterNodeRxWindows(void *this,
  *
  * @note       For Semtech protocol the Network Server must be notified if the downlink packet 
  *             can be sent at expected time (i.e. not a confirmation that node has received
- *             the packet.
+ *             the packet.\n
+ *             The function is not reentrant (i.e. only invoked by 'LoraNodeManager' task).
 *********************************************************************************************/
 DWORD CLoraRealtimeSender_ScheduleSendNodePacket(void *this, 
                             CLoraRealtimeSenderItf_ScheduleSendNodePacketParams pParams)
 {
   CNodeReceiveWindow pNodeReceiveWindow;
+  CNodeReceiveWindowOb NodeReceiveWindow;
+  CLoraRealtimeSenderItf_RadioParamsOb Radio;
   CRealtimeLoraPacket pRealtimeLoraPacket;
-  CMemoryBlockArrayEntryOb MemBlockEntry;
-  DWORD dwCurrentTimestamp;
+  CWideMemoryBlockArrayEntryOb MemBlockEntry;
+  QWORD qwCurrentTimestamp;
+  QWORD qwSendTimestamp;
+  QWORD qwServerTimestamp;
+  DWORD dwAirtime;
+  DWORD dwResult;
+  DWORD dwWindowResult;
+  BYTE usRxWindow;
   bool bScheduled;
   CTransceiverManagerItf_SessionEventOb SessionEvent;
 
@@ -362,7 +415,21 @@ DWORD CLoraRealtimeSender_ScheduleSendNodePacket(void *this,
   #endif
 
   // Step 1: Retrieve the receive windows for the destination device
-  if ((pNodeReceiveWindow = CLoraRealtimeSender_FindNodeReceiveWindow((CLoraRealtimeSender *) this, pParams->m_dwDeviceAddr, true)) == NULL)
+  // Note: The entry is copied (i.e. may be removed by the periodical cleanup once the mutex is
+  //       released)
+  // Note: The 'Join Accept' does not contain a device address (i.e. the RX windows of 'Join Request'
+  //       are found by send time)
+  xSemaphoreTake(((CLoraRealtimeSender *) this)->m_hReceiveWindowMutex, portMAX_DELAY);
+  pNodeReceiveWindow = pParams->m_bJoinAccept == true ?
+    CLoraRealtimeSender_FindJoinReceiveWindow((CLoraRealtimeSender *) this, pParams->m_bImmediate, pParams->m_dwSendTimestamp) :
+    CLoraRealtimeSender_FindNodeReceiveWindow((CLoraRealtimeSender *) this, pParams->m_dwDeviceAddr, true);
+  if (pNodeReceiveWindow != NULL)
+  {
+    NodeReceiveWindow = *pNodeReceiveWindow;
+  }
+  xSemaphoreGive(((CLoraRealtimeSender *) this)->m_hReceiveWindowMutex);
+
+  if (pNodeReceiveWindow == NULL)
   {
     // No receive window descriptor registered
     // Probably a too late downlink message for a Class A device
@@ -373,7 +440,7 @@ DWORD CLoraRealtimeSender_ScheduleSendNodePacket(void *this,
   }
 
   // Step 2: Obtain an entry in the schedule queue
-  if ((pRealtimeLoraPacket = CMemoryBlockArray_GetBlock(((CLoraRealtimeSender *) this)->m_pRealtimeLoraPacketArray, &MemBlockEntry)) == NULL)
+  if ((pRealtimeLoraPacket = CWideMemoryBlockArray_GetBlock(((CLoraRealtimeSender *) this)->m_pRealtimeLoraPacketArray, &MemBlockEntry)) == NULL)
   {
     // Should never occur
     #if (LORAREALTIMESENDER_DEBUG_LEVEL0)
@@ -385,42 +452,99 @@ DWORD CLoraRealtimeSender_ScheduleSendNodePacket(void *this,
   // Step 3: Define when packet can be sent
 
   // Check if it not too late to schedule the send operation
-  dwCurrentTimestamp = xTaskGetTickCount() * portTICK_RATE_MS;
+  // Note: The transmission is started at the beginning of RX window (i.e. the node is listening
+  //       for the preamble of downlink packet only during a few symbols)
+  qwCurrentTimestamp = GATEWAY_CLOCK_MICROSEC();
   bScheduled = false;
-  if (pNodeReceiveWindow->m_usDeviceClass == LORAREALTIMESENDER_DEVICECLASS_A)
+  if (NodeReceiveWindow.m_usDeviceClass == LORAREALTIMESENDER_DEVICECLASS_A)
   {
-    if (dwCurrentTimestamp < pNodeReceiveWindow->m_dwRX1WindowTimestamp + 
-        (LORAREALTIMESENDER_LORAWAN_RX_WINDOW_LENGTH - LORAREALTIMESENDER_GATEWAY_TX_DELAY))
-    {
-      // Lora packet can be send on RX1 window, look for collision
-      bScheduled = true;
-      pRealtimeLoraPacket->m_bASAP = true;
-      pRealtimeLoraPacket->m_dwSendTimestamp = pNodeReceiveWindow->m_dwRX1WindowTimestamp + 
-        (LORAREALTIMESENDER_LORAWAN_RX_WINDOW_LENGTH - LORAREALTIMESENDER_GATEWAY_TX_DELAY);
-    }
+    // RX1 window checked first, RX2 window if RX1 is too late or not possible
+    // Note: The result code is 'TOO_LATE' only if no window was checked for collision
+    dwResult = LORAREALTIMESENDER_SCHEDULESEND_TOO_LATE;
 
-    // If packet cannot be scheduled on RX1 window, check if possible on RX2 window
-    if (bScheduled == false)
+    // Send time requested by Network Server converted to 64 bits gateway clock
+    // Note: The 32 bits timestamp wraps every 71 minutes, the value is converted using the RX1 
+    //       window timestamp as reference (i.e. signed difference)
+    qwServerTimestamp = NodeReceiveWindow.m_qwRX1WindowTimestamp + 
+                        (int32_t)(pParams->m_dwSendTimestamp - (DWORD) NodeReceiveWindow.m_qwRX1WindowTimestamp);
+
+    for (usRxWindow = REALTIMELORAPACKET_RXWINDOW_RX1; usRxWindow < LORAREALTIMESENDER_RXWINDOW_NUMBER; usRxWindow++)
     {
-      if (dwCurrentTimestamp < pNodeReceiveWindow->m_dwRX2WindowTimestamp + 
-          (LORAREALTIMESENDER_LORAWAN_RX_WINDOW_LENGTH - LORAREALTIMESENDER_GATEWAY_TX_DELAY))
+      qwSendTimestamp = usRxWindow == REALTIMELORAPACKET_RXWINDOW_RX1 ? NodeReceiveWindow.m_qwRX1WindowTimestamp :
+                                                                      NodeReceiveWindow.m_qwRX2WindowTimestamp;
+
+      if ((pParams->m_bServerTiming == true) && (pParams->m_bImmediate == true))
       {
-        // Lora packet can be send on RX1 window, look for collision
-        pRealtimeLoraPacket->m_bASAP = true;
-        pRealtimeLoraPacket->m_dwSendTimestamp = pNodeReceiveWindow->m_dwRX2WindowTimestamp + 
-          (LORAREALTIMESENDER_LORAWAN_RX_WINDOW_LENGTH - LORAREALTIMESENDER_GATEWAY_TX_DELAY);
+        // Immediate send requested by Network Server, radio settings of RX1 window used
+        qwSendTimestamp = qwCurrentTimestamp + LORAREALTIMESENDER_GATEWAY_TX_DELAY;
       }
-      else
+      else if (pParams->m_bServerTiming == true)
       {
-        // Too late to schedule send of LoRa packet
-        #if (LORAREALTIMESENDER_DEBUG_LEVEL0)
-          DEBUG_PRINT_LN("[WARNING] CLoraRealtimeSender_ScheduleSendNodePacket - No RX window available (too late)");
-        #endif
-        CMemoryBlockArray_ReleaseBlock(((CLoraRealtimeSender *) this)->m_pRealtimeLoraPacketArray, MemBlockEntry.m_usBlockIndex);
-        return LORAREALTIMESENDER_SCHEDULESEND_TOO_LATE;
+        // Only the RX window including the time requested by Network Server can be used
+        // Note: A time before RX1 window is 'TOO_EARLY' (i.e. node not listening yet), a time after
+        //       RX1 window start but outside any window is 'TOO_LATE' (i.e. RX window missed)
+        if ((qwServerTimestamp < qwSendTimestamp) ||
+            (qwServerTimestamp > qwSendTimestamp + LORAREALTIMESENDER_LORAWAN_RX_WINDOW_LENGTH))
+        {
+          dwResult = qwServerTimestamp < NodeReceiveWindow.m_qwRX1WindowTimestamp ?
+                     LORAREALTIMESENDER_SCHEDULESEND_TOO_EARLY : LORAREALTIMESENDER_SCHEDULESEND_TOO_LATE;
+          continue;
+        }
+        dwResult = LORAREALTIMESENDER_SCHEDULESEND_TOO_LATE;
+        qwSendTimestamp = qwServerTimestamp;
+      }
+
+      if (qwCurrentTimestamp + LORAREALTIMESENDER_GATEWAY_TX_DELAY > qwSendTimestamp)
+      {
+        if (pParams->m_bServerTiming == true)
+        {
+          break;
+        }
+        continue;
+      }
+
+      // Radio settings of RX window replaced by settings requested by Network Server
+      Radio = NodeReceiveWindow.m_RxRadio[usRxWindow];
+      if (pParams->m_bServerTiming == true)
+      {
+        CLoraRealtimeSender_ApplyServerRadio(&Radio, &(pParams->m_ServerRadio));
+      }
+
+      dwWindowResult = CLoraRealtimeSender_CheckTransmission((CLoraRealtimeSender *) this, NodeReceiveWindow.m_pLoraTransceiverItf,
+                                                             &Radio, qwSendTimestamp, pParams->m_pPacketToSend->m_dwDataSize, &dwAirtime);
+      if (dwWindowResult == LORAREALTIMESENDER_SCHEDULESEND_NONE)
+      {
+        // Lora packet can be send on this RX window
+        bScheduled = true;
+        pRealtimeLoraPacket->m_bASAP = (pParams->m_bServerTiming == true) && (pParams->m_bImmediate == true);
+        pRealtimeLoraPacket->m_qwSendTimestamp = qwSendTimestamp;
+        pRealtimeLoraPacket->m_qwEndTimestamp = qwSendTimestamp + dwAirtime;
+        pRealtimeLoraPacket->m_usRxWindow = usRxWindow;
+        pRealtimeLoraPacket->m_Radio = Radio;
+
+        CLoraDutyCycle_Reserve(((CLoraRealtimeSender *) this)->m_pDutyCycle, CLoraDutyCycle_GetSubBand(Radio.m_usFreqChannel),
+                               qwSendTimestamp, dwAirtime);
+        break;
+      }
+
+      dwResult = dwWindowResult;
+      if (pParams->m_bServerTiming == true)
+      {
+        break;
       }
     }
 
+    if (bScheduled == false)
+    {
+      #if (LORAREALTIMESENDER_DEBUG_LEVEL0)
+        DEBUG_PRINT("[WARNING] CLoraRealtimeSender_ScheduleSendNodePacket - No RX window available, result: ");
+        DEBUG_PRINT_DEC(dwResult);
+        DEBUG_PRINT_CR;
+      #endif
+      CWideMemoryBlockArray_ReleaseBlock(((CLoraRealtimeSender *) this)->m_pRealtimeLoraPacketArray, MemBlockEntry.m_wBlockIndex);
+      return dwResult;
+    }
+
     // Note: The 'NodeReceiveWindow' checked here (Class A = generated by uplink LoRa packet) will be
     //       removed later by the 'SenderTask'.
   }
@@ -430,14 +554,14 @@ DWORD CLoraRealtimeSender_ScheduleSendNodePacket(void *this,
     #if (LORAREALTIMESENDER_DEBUG_LEVEL0)
       DEBUG_PRINT_LN("[ERROR] CLoraRealtimeSender_ScheduleSendNodePacket - Only Class A devices supported");
     #endif
-    CMemoryBlockArray_ReleaseBlock(((CLoraRealtimeSender *) this)->m_pRealtimeLoraPacketArray, MemBlockEntry.m_usBlockIndex);
+    CWideMemoryBlockArray_ReleaseBlock(((CLoraRealtimeSender *) this)->m_pRealtimeLoraPacketArray, MemBlockEntry.m_wBlockIndex);
     return LORAREALTIMESENDER_SCHEDULESEND_TOO_LATE;
   }
 
   // Step 4: Schedule send for the LoRa packet
   //
   // NOTE: When reaching this point, 'bScheduled' is always true
-  pRealtimeLoraPacket->m_pLoraTransceiverItf = pNodeReceiveWindow->m_pLoraTransceiverItf;
+  pRealtimeLoraPacket->m_pLoraTransceiverItf = NodeReceiveWindow.m_pLoraTransceiverItf;
   pRealtimeLoraPacket->m_dwDownlinkSessionId = pParams->m_dwDownlinkSessionId;
   pRealtimeLoraPacket->m_pDownlinkSession = pParams->m_pDownlinkSession;
   pRealtimeLoraPacket->m_pPacketToSend = pParams->m_pPacketToSend;
@@ -455,7 +579,13 @@ DWORD CLoraRealtimeSender_ScheduleSendNodePacket(void *this,
   SessionEvent.m_wEventType = TRANSCEIVERMANAGER_SESSIONEVENT_DOWNLINK_SCHEDULED;
   ITransceiverManager_SessionEvent(((CLoraRealtimeSender *) this)->m_pTransceiverManagerItf, &SessionEvent);
 
-  CMemoryBlockArray_SetBlockReady(((CLoraRealtimeSender *) this)->m_pRealtimeLoraPacketArray, MemBlockEntry.m_usBlockIndex);
+  CWideMemoryBlockArray_SetBlockReady(((CLoraRealtimeSender *) this)->m_pRealtimeLoraPacketArray, MemBlockEntry.m_wBlockIndex);
+
+  // Packet ordered by send time and 'SenderTask' woken up (i.e. new packet may be the next to send)
+  xSemaphoreTake(((CLoraRealtimeSender *) this)->m_hPacketArrayMutex, portMAX_DELAY);
+  CMinHeap_Insert(((CLoraRealtimeSender *) this)->m_pRealtimeLoraPacketHeap, MemBlockEntry.m_wBlockIndex, 
+                  pRealtimeLoraPacket->m_qwSendTimestamp);
+  xSemaphoreGive(((CLoraRealtimeSender *) this)->m_hPacketArrayMutex);
   xSemaphoreGive(((CLoraRealtimeSender *) this)->m_hPacketWaiting);
 
   return LORAREALTIMESENDER_SCHEDULESEND_NONE;
@@ -487,7 +617,13 @@ DWORD CLoraRealtimeSender_ScheduleSendNodePacket(void *this,
  * @brief      Periodically checks if it is time to send next LoRa packet to its destination node.
  * 
  * @details    This function is the RTOS task used to send downlink packets at their progammed
- *             time (i.e. when the receive window of destination node is open):
+ *             time (i.e. when the receive window of destination node is open):\n
+ *              - The next packet to send is the packet with smallest send time in the 
+ *                'm_pRealtimeLoraPacketHeap' min-heap.\n
+ *              - The task sleeps until the time to arm the transceiver for this packet. The
+ *                sleep is interrupted when a new packet is scheduled (i.e. the new packet may
+ *                have to be sent first).\n
+ *              - The expired RX windows are removed on each iteration.
  * 
  * @param      this
  *             The pointer to CLoraRealtimeSender object.
@@ -497,115 +633,194 @@ DWORD CLoraRealtimeSender_ScheduleSendNodePacket(void *this,
 *********************************************************************************************/
 void CLoraRealtimeSender_PacketSenderAutomaton(CLoraRealtimeSender *this)
 {
-  DWORD dwCurrentTicks;
-  CLoraTransceiverItf_SendParamsOb SendParams;
+  CLoraTransceiverItf_ArmSendParamsOb ArmSendParams;
+  CLoraTransceiverItf_StandByParamsOb StandByParams;
   CTransceiverManagerItf_SessionEventOb SessionEvent;
   CRealtimeLoraPacket pRealtimeLoraPacket;
+  CLoraRealtimeSenderItf_TxStatistics pTxStatistics;
   bool bSendingPacket;
-  DWORD dwSemaphoreWaitMs;
+  QWORD qwArmTimestamp;
+  QWORD qwFireTimestamp;
+  QWORD qwCurrentTimestamp;
+  TickType_t dwWaitTicks;
 
-  dwSemaphoreWaitMs = 500;
   while (this->m_dwCurrentState != LORAREALTIMESENDER_AUTOMATON_STATE_TERMINATED)
   {
     if (this->m_dwCurrentState == LORAREALTIMESENDER_AUTOMATON_STATE_RUNNING)
     {
-      #if (LORAREALTIMESENDER_DEBUG_LEVEL0)
-        DEBUG_PRINT_LN("[DEBUG] CLoraRealtimeSender_PacketSenderAutomaton, waiting message");
-      #endif
+      // Cleanup in collections (i.e. only expired entries are accessed)
+      CLoraRealtimeSender_RemoveExpiredNodeReceiveWindows(this);
 
-      // Wait for signal that a new LoRa packet is programmed for realtime send
-      if (xSemaphoreTake(this->m_hPacketWaiting, pdMS_TO_TICKS(dwSemaphoreWaitMs)) == pdPASS)
+      // Retrieve the next packet to send
+      // Note: In current version only Class A nodes are implemented
+      if ((pRealtimeLoraPacket = CLoraRealtimeSender_GetNextRealtimePacket(this)) == NULL)
       {
-        // Process message
+        // No packet waiting in realtime queue, wait for signal that a new LoRa packet is 
+        // programmed for realtime send
         #if (LORAREALTIMESENDER_DEBUG_LEVEL0)
-          DEBUG_PRINT_LN("[INFO] CLoraRealtimeSender_PacketSenderAutomaton, next packet scheduled: ");
-        #endif
-  
-        #if (LORAREALTIMESENDER_DEBUG_LEVEL2)
-          DEBUG_PRINT("[DEBUG] CLoraRealtimeSender_PacketSenderAutomaton - ticks: ");
-          DEBUG_PRINT_DEC((DWORD) xTaskGetTickCount());
-          DEBUG_PRINT_CR;
+          DEBUG_PRINT_LN("[DEBUG] CLoraRealtimeSender_PacketSenderAutomaton, waiting message");
         #endif
+        xSemaphoreTake(this->m_hPacketWaiting, pdMS_TO_TICKS(500));
+        continue;
+      }
 
-        // Retrieve the next packet to send
-        // 
-        // NOTE:
-        //  - In current version only Class A nodes are implemented
-        //  - The packets are inserted in queue as a FIFO scheme (i.e. no packet can be scheduled
-        //    before packet referenced by 'm_pNextRealtimeLoraPacket')
-        //  - The task loop MUST be adjusted to allow management of packets with absolute send time
-
-        // Sanity check: 'm_pNextRealtimeLoraPacket' MUST be NULL when 'm_hPacketWaiting' semaphore is detected
-        if (this->m_pNextRealtimeLoraPacket != NULL)
+      // Wait for the time to arm the transceiver
+      // Note: The RTOS wait ends up to one tick before (i.e. tick granularity), the packet is armed
+      //       earlier (i.e. only the transmission requires a precise time)
+      qwCurrentTimestamp = GATEWAY_CLOCK_MICROSEC();
+      qwArmTimestamp = pRealtimeLoraPacket->m_bASAP == true ? qwCurrentTimestamp : 
+                       pRealtimeLoraPacket->m_qwSendTimestamp - LORAREALTIMESENDER_ARM_LEAD;
+      if (qwArmTimestamp > qwCurrentTimestamp)
+      {
+        dwWaitTicks = pdMS_TO_TICKS((DWORD) ((qwArmTimestamp - qwCurrentTimestamp) / 1000));
+        if (dwWaitTicks > 1)
         {
-          #if (LORAREALTIMESENDER_DEBUG_LEVEL0)
-            DEBUG_PRINT_LN("[ERROR] CLoraRealtimeSender_PacketSenderAutomaton - Packet signal inconsistency");
-          #endif
+          // Woken up if a new packet is scheduled
+          xSemaphoreTake(this->m_hPacketWaiting, dwWaitTicks - 1);
+          continue;
         }
+      }
 
-        if ((this->m_pNextRealtimeLoraPacket = CLoraRealtimeSender_GetNextRealtimePacket(this)) == NULL)
-        {
-          // Should never occur, the automaton was too slow to process scheduled packets
-          // Maybe adjust 'LORAREALTIMESENDER_GATEWAY_TX_DELAY'
-          #if (LORAREALTIMESENDER_DEBUG_LEVEL0)
-            DEBUG_PRINT_LN("[ERROR] CLoraRealtimeSender_PacketSenderAutomaton - Scheduled packet expired");
-          #endif
-        }
-        else
+      #if (LORAREALTIMESENDER_DEBUG_LEVEL0)
+        DEBUG_PRINT_LN("[INFO] CLoraRealtimeSender_PacketSenderAutomaton, sending next scheduled packet");
+      #endif
+
+      #if (LORAREALTIMESENDER_DEBUG_LEVEL2)
+        DEBUG_PRINT("[DEBUG] CLoraRealtimeSender_PacketSenderAutomaton - ticks: ");
+        DEBUG_PRINT_DEC((DWORD) xTaskGetTickCount());
+        DEBUG_PRINT_CR;
+      #endif
+
+      // The packet is removed from the realtime queue
+      // Note: 'm_pNextRealtimeLoraPacket' is the packet currently processed
+      CLoraRealtimeSender_RemoveRealtimePacket(this, pRealtimeLoraPacket);
+      this->m_pNextRealtimeLoraPacket = pRealtimeLoraPacket;
+
+      // Send packet at the scheduled time
+      // The packet is loaded in transceiver before the start of RX window and the transmission
+      // is fired at the start of RX window when the one-shot timer expires
+      bSendingPacket = false;
+      pTxStatistics = &(this->m_pTxStatistics[pRealtimeLoraPacket->m_usRxWindow]);
+      if ((pRealtimeLoraPacket->m_bASAP == false) && 
+          (GATEWAY_CLOCK_MICROSEC() > pRealtimeLoraPacket->m_qwSendTimestamp + LORAREALTIMESENDER_TX_LATE_LIMIT))
+      {
+        // Should never occur, the automaton was too slow to process scheduled packets
+        // Maybe adjust 'LORAREALTIMESENDER_GATEWAY_TX_DELAY'
+        ++pTxStatistics->m_dwLateNumber;
+        #if (LORAREALTIMESENDER_DEBUG_LEVEL0)
+          DEBUG_PRINT_LN("[ERROR] CLoraRealtimeSender_PacketSenderAutomaton - Scheduled packet expired");
+        #endif
+      }
+      else
+      {
+        ArmSendParams.m_pPacketToSend = pRealtimeLoraPacket->m_pPacketToSend;
+        ArmSendParams.m_usFreqChannel = pRealtimeLoraPacket->m_Radio.m_usFreqChannel;
+        ArmSendParams.m_usSpreadingFactor = pRealtimeLoraPacket->m_Radio.m_usSpreadingFactor;
+        ArmSendParams.m_usBandwidth = pRealtimeLoraPacket->m_Radio.m_usBandwidth;
+        ArmSendParams.m_usCodingRate = pRealtimeLoraPacket->m_Radio.m_usCodingRate;
+        ArmSendParams.m_usPowerLevel = pRealtimeLoraPacket->m_Radio.m_usPowerLevel;
+        if (ILoraTransceiver_ArmSend(pRealtimeLoraPacket->m_pLoraTransceiverItf, &ArmSendParams) == true)
         {
-          // Send packet at the scheduled time
-          pRealtimeLoraPacket = this->m_pNextRealtimeLoraPacket;
-          if (pRealtimeLoraPacket->m_bASAP == false)
+          qwFireTimestamp = pRealtimeLoraPacket->m_bASAP == true ? GATEWAY_CLOCK_MICROSEC() : pRealtimeLoraPacket->m_qwSendTimestamp;
+          this->m_usFireResult = LORAREALTIMESENDER_FIRE_FAILED;
+          CLoraRealtimeSender_StartFireTimer(this, qwFireTimestamp);
+
+          // Wait for timer expiration and start the transmission
+          qwCurrentTimestamp = GATEWAY_CLOCK_MICROSEC();
+          if (xSemaphoreTake(this->m_hFireWake, pdMS_TO_TICKS(LORAREALTIMESENDER_FIRE_TIMEOUT + 
+              (DWORD) (qwFireTimestamp > qwCurrentTimestamp ? (qwFireTimestamp - qwCurrentTimestamp) / 1000 : 0))) == pdPASS)
           {
-            dwCurrentTicks = xTaskGetTickCount();
-            vTaskDelay(pdMS_TO_TICKS(pRealtimeLoraPacket->m_dwSendTimestamp - (dwCurrentTicks * portTICK_RATE_MS)));
+            CLoraRealtimeSender_FireSend(this);
           }
-
-          SendParams.m_pPacketToSend = pRealtimeLoraPacket->m_pPacketToSend;
-          if ((bSendingPacket = ILoraTransceiver_Send(pRealtimeLoraPacket->m_pLoraTransceiverItf, &SendParams)) == true)
+          else
           {
+            // Should never occur
+            // Note: A late expiration must not wake up the task for the next packet
+            #ifdef ESP_PLATFORM
+              esp_timer_stop(this->m_hFireTimer);
+            #endif
+            xSemaphoreTake(this->m_hFireWake, 0);
             #if (LORAREALTIMESENDER_DEBUG_LEVEL0)
-              DEBUG_PRINT_LN("[INFO] CLoraRealtimeSender_PacketSenderAutomaton - LoRa packet currently sent by transceiver");
+              DEBUG_PRINT_LN("[ERROR] CLoraRealtimeSender_PacketSenderAutomaton - Fire timer not expired");
             #endif
+          }
+
+          if (this->m_usFireResult == LORAREALTIMESENDER_FIRE_SENDING)
+          {
+            bSendingPacket = true;
+            CLoraRealtimeSender_SetTransceiverTxEnd(this, pRealtimeLoraPacket->m_pLoraTransceiverItf, this->m_FireSendParams.m_qwFireTimestamp + 
+              (pRealtimeLoraPacket->m_qwEndTimestamp - pRealtimeLoraPacket->m_qwSendTimestamp));
+            if (pRealtimeLoraPacket->m_bASAP == false)
+            {
+              CLoraRealtimeSender_UpdateTxStats(this, pRealtimeLoraPacket->m_usRxWindow, pRealtimeLoraPacket->m_qwSendTimestamp,
+                                                this->m_FireSendParams.m_qwFireTimestamp);
+            }
+          }
+          else if (this->m_usFireResult == LORAREALTIMESENDER_FIRE_LATE)
+          {
+            // Node no more listening, the armed packet is cancelled
+            ++pTxStatistics->m_dwLateNumber;
+            StandByParams.m_bForce = false;
+            ILoraTransceiver_StandBy(pRealtimeLoraPacket->m_pLoraTransceiverItf, &StandByParams);
 
-            #if (LORAREALTIMESENDER_DEBUG_LEVEL2)
-              DEBUG_PRINT("[DEBUG] CLoraRealtimeSender_PacketSenderAutomaton - transceiver sending... - ticks: ");
-              DEBUG_PRINT_DEC((DWORD) xTaskGetTickCount());
-              DEBUG_PRINT_CR;
+            #if (LORAREALTIMESENDER_DEBUG_LEVEL0)
+              DEBUG_PRINT_LN("[ERROR] CLoraRealtimeSender_PacketSenderAutomaton - RX window missed, LoRa packet not sent");
             #endif
           }
           else
           {
-            // Should never occur
-            // Maybe check if transceiver is not currently sending a previous packet (i.e. adjust schedule strategy)
+            // Fire timer not expired or transmission not started by transceiver, the armed packet
+            // is cancelled (i.e. transceiver not left in 'ARMED' state)
+            ++pTxStatistics->m_dwFailedNumber;
+            StandByParams.m_bForce = false;
+            ILoraTransceiver_StandBy(pRealtimeLoraPacket->m_pLoraTransceiverItf, &StandByParams);
+
             #if (LORAREALTIMESENDER_DEBUG_LEVEL0)
-              DEBUG_PRINT_LN("[ERROR] CLoraRealtimeSender_PacketSenderAutomaton - Transceiver cannot send LoRa packet");
+              DEBUG_PRINT_LN("[ERROR] CLoraRealtimeSender_PacketSenderAutomaton - Transmission not started, LoRa packet not sent");
             #endif
           }
-
-          // Downlink packet transmission is started
-          // Notify the parent 'LoraNodeManager'
-          // Note: The 'LoraNodeManager' will be directly notified when packet is sent (i.e. event received on its
-          //       'TransceiverAutomaton' task)
-          SessionEvent.m_pSession = pRealtimeLoraPacket->m_pDownlinkSession;
-          SessionEvent.m_dwSessionId = pRealtimeLoraPacket->m_dwDownlinkSessionId;  
-          SessionEvent.m_wEventType = bSendingPacket == true ? TRANSCEIVERMANAGER_SESSIONEVENT_DOWNLINK_SENDING :
-                                                                TRANSCEIVERMANAGER_SESSIONEVENT_DOWNLINK_FAILED;
-          ITransceiverManager_SessionEvent(this->m_pTransceiverManagerItf, &SessionEvent);
-
-          // Ready for next LoRa packet
-          this->m_pNextRealtimeLoraPacket = NULL;
         }
+        else
+        {
+          ++pTxStatistics->m_dwFailedNumber;
+        }
+      }
+
+      if (bSendingPacket == true)
+      {
+        #if (LORAREALTIMESENDER_DEBUG_LEVEL0)
+          DEBUG_PRINT_LN("[INFO] CLoraRealtimeSender_PacketSenderAutomaton - LoRa packet currently sent by transceiver");
+        #endif
 
-        // Configure to trigger immediate cleanup if no more packet is registered in realtime queue
-        dwSemaphoreWaitMs = 10;
+        #if (LORAREALTIMESENDER_DEBUG_LEVEL2)
+          DEBUG_PRINT("[DEBUG] CLoraRealtimeSender_PacketSenderAutomaton - transceiver sending... - ticks: ");
+          DEBUG_PRINT_DEC((DWORD) xTaskGetTickCount());
+          DEBUG_PRINT_CR;
+        #endif
       }
       else
       {
-        // No packet waiting in realtime queue, performs some cleanup in collections 
-        dwSemaphoreWaitMs = 500;
-        CLoraRealtimeSender_RemoveExpiredNodeReceiveWindows(this);
+        // Should never occur
+        // Maybe check if transceiver is not currently sending a previous packet (i.e. adjust schedule strategy)
+        #if (LORAREALTIMESENDER_DEBUG_LEVEL0)
+          DEBUG_PRINT_LN("[ERROR] CLoraRealtimeSender_PacketSenderAutomaton - Transceiver cannot send LoRa packet");
+        #endif
       }
+
+      // Downlink packet transmission is started
+      // Notify the parent 'LoraNodeManager'
+      // Note: The 'LoraNodeManager' will be directly notified when packet is sent (i.e. event received on its
+      //       'TransceiverAutomaton' task)
+      SessionEvent.m_pSession = pRealtimeLoraPacket->m_pDownlinkSession;
+      SessionEvent.m_dwSessionId = pRealtimeLoraPacket->m_dwDownlinkSessionId;  
+      SessionEvent.m_wEventType = bSendingPacket == true ? TRANSCEIVERMANAGER_SESSIONEVENT_DOWNLINK_SENDING :
+                                                            TRANSCEIVERMANAGER_SESSIONEVENT_DOWNLINK_FAILED;
+      ITransceiverManager_SessionEvent(this->m_pTransceiverManagerItf, &SessionEvent);
+
+      // Ready for next LoRa packet
+      CWideMemoryBlockArray_ReleaseBlock(this->m_pRealtimeLoraPacketArray, 
+        CWideMemoryBlockArray_BlockIndexFromPtr(this->m_pRealtimeLoraPacketArray, pRealtimeLoraPacket));
+      this->m_pNextRealtimeLoraPacket = NULL;
     }
     else if (this->m_dwCurrentState == LORAREALTIMESENDER_AUTOMATON_STATE_STOPPING)
     {
@@ -663,26 +878,50 @@ CLoraRealtimeSender * CLoraRealtimeSender_New()
 
     // Embedded objects are not defined (i.e. created below)
     this->m_pNodeReceiveWindowArray = NULL;
+    this->m_pNodeReceiveWindowIndex = NULL;
+    this->m_pNodeReceiveWindowExpiryHeap = NULL;
     this->m_pRealtimeLoraPacketArray = NULL;
+    this->m_pRealtimeLoraPacketHeap = NULL;
     this->m_hPacketSenderTask = NULL;
+    this->m_hReceiveWindowMutex = NULL;
     this->m_hPacketArrayMutex = NULL;
     this->m_hPacketWaiting = NULL;
+    this->m_hFireWake = NULL;
+    this->m_pDutyCycle = NULL;
+    #ifdef ESP_PLATFORM
+      this->m_hFireTimer = NULL;
+    #endif
 
     // Allocate memory blocks for internal collections
-    if ((this->m_pNodeReceiveWindowArray = CMemoryBlockArray_New(sizeof(CNodeReceiveWindowOb),
+    if ((this->m_pNodeReceiveWindowArray = CWideMemoryBlockArray_New(sizeof(CNodeReceiveWindowOb),
         CONFIG_NODE_MAX_NUMBER)) == NULL)
     {
       CLoraRealtimeSender_Delete(this);
       return NULL;
     }
 
-    if ((this->m_pRealtimeLoraPacketArray = CMemoryBlockArray_New(sizeof(CRealtimeLoraPacketOb),
+    if ((this->m_pRealtimeLoraPacketArray = CWideMemoryBlockArray_New(sizeof(CRealtimeLoraPacketOb),
         CONFIG_NODE_MAX_NUMBER)) == NULL)
     {
       CLoraRealtimeSender_Delete(this);
       return NULL;
     }
 
+    // Allocate indexes for internal collections
+    if (((this->m_pNodeReceiveWindowIndex = CHashIndex_New(CONFIG_NODE_MAX_NUMBER)) == NULL) ||
+        ((this->m_pNodeReceiveWindowExpiryHeap = CMinHeap_New(CONFIG_NODE_MAX_NUMBER)) == NULL) ||
+        ((this->m_pRealtimeLoraPacketHeap = CMinHeap_New(CONFIG_NODE_MAX_NUMBER)) == NULL))
+    {
+      CLoraRealtimeSender_Delete(this);
+      return NULL;
+    }
+
+    if ((this->m_hReceiveWindowMutex = xSemaphoreCreateMutex()) == NULL)
+    {
+      CLoraRealtimeSender_Delete(this);
+      return NULL;
+    }
+
     if ((this->m_hPacketArrayMutex = xSemaphoreCreateMutex()) == NULL)
     {
       CLoraRealtimeSender_Delete(this);
@@ -695,9 +934,37 @@ CLoraRealtimeSender * CLoraRealtimeSender_New()
       return NULL;
     }
 
+    if ((this->m_hFireWake = xSemaphoreCreateBinary()) == NULL)
+    {
+      CLoraRealtimeSender_Delete(this);
+      return NULL;
+    }
+
+    if ((this->m_pDutyCycle = CLoraDutyCycle_New()) == NULL)
+    {
+      CLoraRealtimeSender_Delete(this);
+      return NULL;
+    }
+
+    // One-shot timer for start of transmissions
+    #ifdef ESP_PLATFORM
+    {
+      esp_timer_create_args_t FireTimerArgs = { .callback = CLoraRealtimeSender_FireTimerCallback,
+                                                .arg = this,
+                                                .name = "CLoraRealtimeSender_FireTimer"
+                                              };
+
+      if (esp_timer_create(&FireTimerArgs, &(this->m_hFireTimer)) != ESP_OK)
+      {
+        CLoraRealtimeSender_Delete(this);
+        return NULL;
+      }
+    }
+    #endif
+
     // Create PacketSender automaton task
-    if (xTaskCreate((TaskFunction_t) CLoraRealtimeSender_PacketSenderAutomaton, "CLoraRealtimeSender_PacketSenderAutomaton", 
-        2048, this, 5, &(this->m_hPacketSenderTask)) == pdFAIL)
+    if (CTaskPlacement_CreateTask(TASKPLACEMENT_TASK_REALTIMESENDER, (TaskFunction_t) CLoraRealtimeSender_PacketSenderAutomaton, 
+        this, &(this->m_hPacketSenderTask)) == false)
     {
       CLoraRealtimeSender_Delete(this);
       return NULL;
@@ -706,6 +973,9 @@ CLoraRealtimeSender * CLoraRealtimeSender_New()
     // Initialize object's properties
     this->m_nRefCount = 0;
     this->m_pNextRealtimeLoraPacket = NULL;
+    memset(this->m_TxStatistics, 0, sizeof(this->m_TxStatistics));
+    this->m_pTxStatistics = this->m_TxStatistics;
+    memset(this->m_RealtimeTransceiverArray, 0, sizeof(this->m_RealtimeTransceiverArray));
 
     // Enter the 'CREATED' state
     this->m_dwCurrentState = LORAREALTIMESENDER_AUTOMATON_STATE_CREATED;
@@ -735,12 +1005,32 @@ void CLoraRealtimeSender_Delete(CLoraRealtimeSender *this)
   // Free memory
   if (this->m_pNodeReceiveWindowArray != NULL)
   {
-    CMemoryBlockArray_Delete(this->m_pNodeReceiveWindowArray);
+    CWideMemoryBlockArray_Delete(this->m_pNodeReceiveWindowArray);
   }
 
   if (this->m_pRealtimeLoraPacketArray != NULL)
   {
-    CMemoryBlockArray_Delete(this->m_pRealtimeLoraPacketArray);
+    CWideMemoryBlockArray_Delete(this->m_pRealtimeLoraPacketArray);
+  }
+
+  if (this->m_pNodeReceiveWindowIndex != NULL)
+  {
+    CHashIndex_Delete(this->m_pNodeReceiveWindowIndex);
+  }
+
+  if (this->m_pNodeReceiveWindowExpiryHeap != NULL)
+  {
+    CMinHeap_Delete(this->m_pNodeReceiveWindowExpiryHeap);
+  }
+
+  if (this->m_pRealtimeLoraPacketHeap != NULL)
+  {
+    CMinHeap_Delete(this->m_pRealtimeLoraPacketHeap);
+  }
+
+  if (this->m_hReceiveWindowMutex != NULL)
+  {
+    vSemaphoreDelete(this->m_hReceiveWindowMutex);
   }
 
   if (this->m_hPacketArrayMutex != NULL)
@@ -752,6 +1042,24 @@ void CLoraRealtimeSender_Delete(CLoraRealtimeSender *this)
   {
     vSemaphoreDelete(this->m_hPacketWaiting);
   }
+
+  #ifdef ESP_PLATFORM
+    if (this->m_hFireTimer != NULL)
+    {
+      esp_timer_stop(this->m_hFireTimer);
+      esp_timer_delete(this->m_hFireTimer);
+    }
+  #endif
+
+  if (this->m_hFireWake != NULL)
+  {
+    vSemaphoreDelete(this->m_hFireWake);
+  }
+
+  if (this->m_pDutyCycle != NULL)
+  {
+    CLoraDutyCycle_Delete(this->m_pDutyCycle);
+  }
   
   vPortFree(this);
 }
@@ -766,187 +1074,385 @@ void CLoraRealtimeSender_Delete(CLoraRealtimeSender *this)
 *********************************************************************************************/
 
 
+// Entry of a device in 'm_pNodeReceiveWindowArray' array (NULL if not found)
+// Note: The caller owns the 'm_hReceiveWindowMutex' mutex
 CNodeReceiveWindow CLoraRealtimeSender_FindNodeReceiveWindow(CLoraRealtimeSender *this, DWORD dwDeviceAddr, bool bCheckExpired)
 {
-  bool bEntryFound;
-  CMemoryBlockArrayEnumItemOb EnumItem;
-  CNodeReceiveWindowOb NodeReceiveWindow;
-  DWORD dwCurrentTimestamp;
+  CNodeReceiveWindow pNodeReceiveWindow;
+  QWORD qwCurrentTimestamp;
+  WORD wBlockIndex;
+
+  // Lookup in device address index
+  if ((wBlockIndex = CHashIndex_Find(this->m_pNodeReceiveWindowIndex, dwDeviceAddr)) == HASHINDEX_NONE)
+  {
+    return NULL;
+  }
+  pNodeReceiveWindow = (CNodeReceiveWindow) CWideMemoryBlockArray_BlockPtrFromIndex(this->m_pNodeReceiveWindowArray, wBlockIndex);
+
+  // The caller may ask to provide object only if not expired
+  if ((bCheckExpired == true) && (pNodeReceiveWindow->m_usDeviceClass == NODERECEIVEWINDOW_DEVICECLASS_A))
+  {
+    qwCurrentTimestamp = GATEWAY_CLOCK_MICROSEC();
 
-  // Enumerate the array containing 'CNodeReceiveWindow' objects for nodes with active RX windows
-  EnumItem.m_pItemData = (void *) &NodeReceiveWindow;
-  EnumItem.m_bByValue = true;
-  bEntryFound = CMemoryBlockArray_EnumStart(this->m_pNodeReceiveWindowArray, &EnumItem);
-  while (bEntryFound == true)
+    if (qwCurrentTimestamp > pNodeReceiveWindow->m_qwRX2WindowTimestamp + 
+        (LORAREALTIMESENDER_LORAWAN_RX_WINDOW_LENGTH - LORAREALTIMESENDER_GATEWAY_TX_DELAY))
+    {
+      #if (LORAREALTIMESENDER_DEBUG_LEVEL0)
+        DEBUG_PRINT_LN("[INFO] CLoraRealtimeSender_FindNodeReceiveWindow - Expired RX windows found for device");
+      #endif
+      return NULL;
+    }
+  }
+  return pNodeReceiveWindow;
+}
+
+
+// Entry of 'Join Request' in 'm_pNodeReceiveWindowArray' array with an RX window including the
+// send time (NULL if not found)
+// Notes: 
+//  - For an immediate send, the first entry not expired is provided (i.e. only the transceiver 
+//    and radio settings are used)
+//  - The caller owns the 'm_hReceiveWindowMutex' mutex
+CNodeReceiveWindow CLoraRealtimeSender_FindJoinReceiveWindow(CLoraRealtimeSender *this, bool bImmediate, DWORD dwSendTimestamp)
+{
+  CNodeReceiveWindow pNodeReceiveWindow;
+  QWORD qwCurrentTimestamp;
+  QWORD qwExpiryTimestamp;
+  QWORD qwSendTimestamp;
+  WORD wBlockIndex;
+
+  // The 'Join Request' entries are only found in the index by expiration time
+  qwCurrentTimestamp = GATEWAY_CLOCK_MICROSEC();
+  for (WORD i = 0; CMinHeap_GetEntry(this->m_pNodeReceiveWindowExpiryHeap, i, &wBlockIndex, &qwExpiryTimestamp) == true; i++)
   {
-    if (NodeReceiveWindow.m_dwDeviceAddr == dwDeviceAddr)
+    pNodeReceiveWindow = (CNodeReceiveWindow) CWideMemoryBlockArray_BlockPtrFromIndex(this->m_pNodeReceiveWindowArray, wBlockIndex);
+    if ((pNodeReceiveWindow->m_bJoinRequest == false) || (qwCurrentTimestamp > qwExpiryTimestamp))
     {
-      // The caller may ask to provide object only if not expired
-      if ((bCheckExpired == true) && (NodeReceiveWindow.m_usDeviceClass == NODERECEIVEWINDOW_DEVICECLASS_A))
-      {
-        dwCurrentTimestamp = xTaskGetTickCount() * portTICK_RATE_MS;
+      continue;
+    }
+    if (bImmediate == true)
+    {
+      return pNodeReceiveWindow;
+    }
 
-        if (dwCurrentTimestamp > NodeReceiveWindow.m_dwRX2WindowTimestamp + 
-            (LORAREALTIMESENDER_LORAWAN_RX_WINDOW_LENGTH - LORAREALTIMESENDER_GATEWAY_TX_DELAY))
-        {
-          #if (LORAREALTIMESENDER_DEBUG_LEVEL0)
-            DEBUG_PRINT_LN("[INFO] CLoraRealtimeSender_FindNodeReceiveWindow - Expired RX windows found for device");
-          #endif
-          return NULL;
-        }
-      }
-      return (CNodeReceiveWindow) CMemoryBlockArray_BlockPtrFromIndex(this->m_pNodeReceiveWindowArray, EnumItem.m_usBlockIndex);
+    // 32 bits send time converted to 64 bits gateway clock (see 'ScheduleSendNodePacket')
+    qwSendTimestamp = pNodeReceiveWindow->m_qwRX1WindowTimestamp + 
+                      (int32_t)(dwSendTimestamp - (DWORD) pNodeReceiveWindow->m_qwRX1WindowTimestamp);
+    if (((qwSendTimestamp >= pNodeReceiveWindow->m_qwRX1WindowTimestamp) &&
+         (qwSendTimestamp <= pNodeReceiveWindow->m_qwRX1WindowTimestamp + LORAREALTIMESENDER_LORAWAN_RX_WINDOW_LENGTH)) ||
+        ((qwSendTimestamp >= pNodeReceiveWindow->m_qwRX2WindowTimestamp) &&
+         (qwSendTimestamp <= pNodeReceiveWindow->m_qwRX2WindowTimestamp + LORAREALTIMESENDER_LORAWAN_RX_WINDOW_LENGTH)))
+    {
+      return pNodeReceiveWindow;
     }
-    bEntryFound = CMemoryBlockArray_EnumNext(this->m_pNodeReceiveWindowArray, &EnumItem);
   }
   return NULL;
 }
 
 
-CRealtimeLoraPacket CLoraRealtimeSender_GetNextRealtimePacket(CLoraRealtimeSender *this)
+// Replaces the radio settings of an RX window by the settings requested by Network Server
+// Note: The 'NONE' values of Network Server settings are ignored (i.e. settings of RX window kept)
+void CLoraRealtimeSender_ApplyServerRadio(CLoraRealtimeSenderItf_RadioParams pRadio, CLoraRealtimeSenderItf_RadioParams pServerRadio)
 {
-  CMemoryBlockArrayEnumItemOb EnumItem;
-  CRealtimeLoraPacketOb RealtimeLoraPacket;
-  WORD wCount;
-  bool bAsapFound;
-  DWORD dwAsapTimestamp;
-  BYTE usAsapEntryIndex;
-  bool bAbsoluteFound;
-  DWORD dwAbsoluteTimestamp;
-  BYTE usAbsoluteEntryIndex;
-  DWORD dwCurrentTimestamp;
-  BYTE usEntryIndex;
-
-  bAsapFound = bAbsoluteFound = false;
-  usAbsoluteEntryIndex = usAsapEntryIndex = 0;     // Compiler error (should be warning)
-  dwAbsoluteTimestamp = dwAsapTimestamp = 0;       // Compiler error (should be warning)
-  wCount = 0;
-
-  // Enumerate the array containing 'CRealtimeLoraPacket' for scheduled send
-  EnumItem.m_pItemData = (void *) &RealtimeLoraPacket;
-  EnumItem.m_bByValue = true;
-  if (CMemoryBlockArray_EnumStart(this->m_pRealtimeLoraPacketArray, &EnumItem) == true)
-  {
-    do
-    {
-      // Retrieve the first packet to send:
-      //  - For packet programmed with absolute time, select it if time is nearer than 'LORAREALTIMESENDER_GATEWAY_TX_DELAY'
-      //    (i.e. duration required to send another packet before) or if there is no ASAP packet.
-      //    If there is more than one absolute time packet the previous rules are applied to the first packet to send
-      //    regarding programmed time.
-      //  - For ASAP packet, select the first packet to send regarding maximum allowed time
-      if (RealtimeLoraPacket.m_bASAP == true)
-      {
-        if (bAsapFound == true)
-        {
-          if (RealtimeLoraPacket.m_dwSendTimestamp >= dwAsapTimestamp)
-          {
-            continue;
-          }
-        }
-        else
-        {
-          bAsapFound = true;
-        }
-        dwAsapTimestamp = RealtimeLoraPacket.m_dwSendTimestamp;
-        usAsapEntryIndex = EnumItem.m_usBlockIndex;
-      }
-      else
-      {
-        if (bAbsoluteFound == true)
-        {
-          if (RealtimeLoraPacket.m_dwSendTimestamp >= dwAbsoluteTimestamp)
-          {
-            continue;
-          }
-        }
-        else
-        {
-          bAbsoluteFound = true;
-        }
-        dwAbsoluteTimestamp = RealtimeLoraPacket.m_dwSendTimestamp;
-        usAbsoluteEntryIndex = EnumItem.m_usBlockIndex;
-      }
-      wCount++;
-    } 
-    while (CMemoryBlockArray_EnumNext(this->m_pRealtimeLoraPacketArray, &EnumItem) == true);
+  if (pServerRadio->m_usFreqChannel != LORATRANSCEIVERITF_FREQUENCY_CHANNEL_NONE)
+  {
+    pRadio->m_usFreqChannel = pServerRadio->m_usFreqChannel;
   }
-  else
+  if (pServerRadio->m_usSpreadingFactor != LORATRANSCEIVERITF_SF_NONE)
   {
-    // By design the array MUST contain at least one entry:
-    //  - Each time an entry is inserted a 'count' semaphore is incremented
-    //  - The 'SenderTask' waits on 'count' semaphore and invokes this function (i.e. one function call
-    //    for each programmed packet)
-    #if (LORAREALTIMESENDER_DEBUG_LEVEL0)
-      DEBUG_PRINT_LN("[ERROR] CLoraRealtimeSender_GetNextRealtimePacket - FATAL: no entry in realtime queue");
-    #endif
-    return NULL;
+    pRadio->m_usSpreadingFactor = pServerRadio->m_usSpreadingFactor;
+  }
+  if (pServerRadio->m_usBandwidth != LORATRANSCEIVERITF_BANDWIDTH_NONE)
+  {
+    pRadio->m_usBandwidth = pServerRadio->m_usBandwidth;
+  }
+  if (pServerRadio->m_usCodingRate != LORATRANSCEIVERITF_CR_NONE)
+  {
+    pRadio->m_usCodingRate = pServerRadio->m_usCodingRate;
   }
+  if (pServerRadio->m_usPowerLevel != LORATRANSCEIVERITF_POWER_LEVEL_NONE)
+  {
+    pRadio->m_usPowerLevel = pServerRadio->m_usPowerLevel;
+  }
+}
+
+
+// Packet with smallest send time in realtime queue (NULL if queue is empty)
+// Note: The packet is not removed from the realtime queue
+CRealtimeLoraPacket CLoraRealtimeSender_GetNextRealtimePacket(CLoraRealtimeSender *this)
+{
+  WORD wEntryIndex;
+  QWORD qwSendTimestamp;
+  bool bFound;
 
-  // Check for too late
-  // Current version assumes that automaton is fast enough too send all programmed packets and downlink 
-  // packets with absolute time are scheduled by Network Server in order of arrival (should be OK because
-  // this implementation is supporting only Class A devices)
-  dwCurrentTimestamp = xTaskGetTickCount() * portTICK_RATE_MS;
+  xSemaphoreTake(this->m_hPacketArrayMutex, portMAX_DELAY);
+  bFound = CMinHeap_Peek(this->m_pRealtimeLoraPacketHeap, &wEntryIndex, &qwSendTimestamp);
+  xSemaphoreGive(this->m_hPacketArrayMutex);
 
-  if ((bAsapFound == false) && (bAbsoluteFound == false))
+  if (bFound == false)
   {
-    // Should never occur, always something selected even if only expired objects in queue
-    #if (LORAREALTIMESENDER_DEBUG_LEVEL0)
-      DEBUG_PRINT_LN("[ERROR] CLoraRealtimeSender_GetNextRealtimePacket - FATAL: no entry selected in realtime queue");
-    #endif
     return NULL;
   }
+  return (CRealtimeLoraPacket) CWideMemoryBlockArray_BlockPtrFromIndex(this->m_pRealtimeLoraPacketArray, wEntryIndex);
+}
 
-  if (((bAsapFound == true) && (dwAsapTimestamp < dwCurrentTimestamp)) ||
-      ((bAbsoluteFound == true) && (dwAbsoluteTimestamp < dwCurrentTimestamp)))
+
+// Checks if a downlink packet can be transmitted at the specified time
+// The function returns 'LORAREALTIMESENDER_SCHEDULESEND_NONE' if the transmission is possible
+// (i.e. 'pAirtime' is the time-on-air in microseconds) or the rejection code of Semtech protocol
+DWORD CLoraRealtimeSender_CheckTransmission(CLoraRealtimeSender *this, ILoraTransceiver pLoraTransceiverItf,
+                                           CLoraRealtimeSenderItf_RadioParams pRadio, QWORD qwSendTimestamp,
+                                           DWORD dwPayloadLength, DWORD *pAirtime)
+{
+  BYTE usSubBand;
+
+  // Radio settings supported by duty-cycle accounting
+  usSubBand = CLoraDutyCycle_GetSubBand(pRadio->m_usFreqChannel);
+  *pAirtime = CLoraDutyCycle_GetTimeOnAir(pRadio->m_usSpreadingFactor, pRadio->m_usBandwidth, pRadio->m_usCodingRate,
+                                          pRadio->m_wPreambleLength, pRadio->m_usHeader == LORATRANSCEIVERITF_HEADER_ON,
+                                          pRadio->m_usCRC == LORATRANSCEIVERITF_CRC_ON, dwPayloadLength);
+  if ((usSubBand == LORADUTYCYCLE_SUBBAND_NONE) || (*pAirtime == 0))
   {
-    // Invalid entry found
-    // TO DO: update 'SenderTask' algorithme for cleanup of expired 'CRealtimeLoraPacket'
-    #if (LORAREALTIMESENDER_DEBUG_LEVEL0)
-      DEBUG_PRINT_LN("[ERROR] CLoraRealtimeSender_GetNextRealtimePacket - Expired entry found realtime queue");
-    #endif
+    return LORAREALTIMESENDER_SCHEDULESEND_TX_FREQ;
   }
-   
-  // Select the next packet to send
-  if ((bAbsoluteFound == false) || (dwAbsoluteTimestamp > dwCurrentTimestamp + LORAREALTIMESENDER_GATEWAY_TX_DELAY))
+
+  // Transceiver physically able to transmit (i.e. no other transmission during time-on-air)
+  if (CLoraRealtimeSender_IsTransceiverBusy(this, pLoraTransceiverItf, qwSendTimestamp, qwSendTimestamp + *pAirtime) == true)
   {
-    usEntryIndex = usAsapEntryIndex;
+    return LORAREALTIMESENDER_SCHEDULESEND_COLLISION_PACKET;
   }
-  else
+
+  // Transmission legally allowed (i.e. duty-cycle of sub-band)
+  if (CLoraDutyCycle_Check(this->m_pDutyCycle, usSubBand, qwSendTimestamp, *pAirtime) == false)
+  {
+    return LORAREALTIMESENDER_SCHEDULESEND_COLLISION_PACKET;
+  }
+
+  return LORAREALTIMESENDER_SCHEDULESEND_NONE;
+}
+
+
+// Checks if a transmission on a transceiver overlaps the transmission of a scheduled packet or
+// the current transmission
+bool CLoraRealtimeSender_IsTransceiverBusy(CLoraRealtimeSender *this, ILoraTransceiver pLoraTransceiverItf,
+                                           QWORD qwStartTimestamp, QWORD qwEndTimestamp)
+{
+  CRealtimeLoraPacket pRealtimeLoraPacket;
+  WORD wEntryIndex;
+  QWORD qwSendTimestamp;
+  bool bBusy = false;
+
+  xSemaphoreTake(this->m_hPacketArrayMutex, portMAX_DELAY);
+
+  for (BYTE i = 0; i < GATEWAY_MAX_LORATRANSCEIVERS; i++)
+  {
+    if ((this->m_RealtimeTransceiverArray[i].m_pLoraTransceiverItf == pLoraTransceiverItf) &&
+        (qwStartTimestamp < this->m_RealtimeTransceiverArray[i].m_qwTxEndTimestamp + LORAREALTIMESENDER_TX_SEPARATION))
+    {
+      bBusy = true;
+      break;
+    }
+  }
+
+  for (WORD i = 0; (bBusy == false) && (CMinHeap_GetEntry(this->m_pRealtimeLoraPacketHeap, i, &wEntryIndex, &qwSendTimestamp) == true); i++)
+  {
+    pRealtimeLoraPacket = (CRealtimeLoraPacket) CWideMemoryBlockArray_BlockPtrFromIndex(this->m_pRealtimeLoraPacketArray, wEntryIndex);
+    if ((pRealtimeLoraPacket->m_pLoraTransceiverItf == pLoraTransceiverItf) &&
+        (qwStartTimestamp < pRealtimeLoraPacket->m_qwEndTimestamp + LORAREALTIMESENDER_TX_SEPARATION) &&
+        (qwSendTimestamp < qwEndTimestamp + LORAREALTIMESENDER_TX_SEPARATION))
+    {
+      bBusy = true;
+    }
+  }
+
+  xSemaphoreGive(this->m_hPacketArrayMutex);
+  return bBusy;
+}
+
+
+// Records the end of the transmission started by a transceiver
+void CLoraRealtimeSender_SetTransceiverTxEnd(CLoraRealtimeSender *this, ILoraTransceiver pLoraTransceiverItf,
+                                             QWORD qwTxEndTimestamp)
+{
+  xSemaphoreTake(this->m_hPacketArrayMutex, portMAX_DELAY);
+  for (BYTE i = 0; i < GATEWAY_MAX_LORATRANSCEIVERS; i++)
   {
-    usEntryIndex = usAbsoluteEntryIndex;
+    if ((this->m_RealtimeTransceiverArray[i].m_pLoraTransceiverItf == pLoraTransceiverItf) ||
+        (this->m_RealtimeTransceiverArray[i].m_pLoraTransceiverItf == NULL))
+    {
+      this->m_RealtimeTransceiverArray[i].m_pLoraTransceiverItf = pLoraTransceiverItf;
+      this->m_RealtimeTransceiverArray[i].m_qwTxEndTimestamp = qwTxEndTimestamp;
+      break;
+    }
   }
+  xSemaphoreGive(this->m_hPacketArrayMutex);
+}
 
-  return (CRealtimeLoraPacket) CMemoryBlockArray_BlockPtrFromIndex(this->m_pRealtimeLoraPacketArray, usEntryIndex);
+
+// Removes a packet from the realtime queue (i.e. the entry in 'm_pRealtimeLoraPacketArray' is
+// released by caller)
+void CLoraRealtimeSender_RemoveRealtimePacket(CLoraRealtimeSender *this, CRealtimeLoraPacket pRealtimeLoraPacket)
+{
+  xSemaphoreTake(this->m_hPacketArrayMutex, portMAX_DELAY);
+  CMinHeap_Remove(this->m_pRealtimeLoraPacketHeap, 
+                  CWideMemoryBlockArray_BlockIndexFromPtr(this->m_pRealtimeLoraPacketArray, pRealtimeLoraPacket));
+  xSemaphoreGive(this->m_hPacketArrayMutex);
 }
 
+
 void CLoraRealtimeSender_RemoveExpiredNodeReceiveWindows(CLoraRealtimeSender *this)
 {
-  CMemoryBlockArrayEnumItemOb EnumItem;
-  DWORD dwCurrentTimestamp;
+  QWORD qwCurrentTimestamp;
+  QWORD qwExpiryTimestamp;
+  WORD wBlockIndex;
 
-  // Enumerate the array containing 'CNodeReceiveWindow' objects for nodes with active RX windows
-  dwCurrentTimestamp = xTaskGetTickCount() * portTICK_RATE_MS;
+  // The entries are removed in order of expiration time (i.e. only expired entries are accessed)
+  qwCurrentTimestamp = GATEWAY_CLOCK_MICROSEC();
 
-  EnumItem.m_bByValue = false;
-  if (CMemoryBlockArray_EnumStart(this->m_pNodeReceiveWindowArray, &EnumItem) == true)
+  xSemaphoreTake(this->m_hReceiveWindowMutex, portMAX_DELAY);
+  while ((CMinHeap_Peek(this->m_pNodeReceiveWindowExpiryHeap, &wBlockIndex, &qwExpiryTimestamp) == true) &&
+         (qwCurrentTimestamp > qwExpiryTimestamp))
   {
-    do
+    #if (LORAREALTIMESENDER_DEBUG_LEVEL0)
+      DEBUG_PRINT_LN("[INFO] CLoraRealtimeSender_RemoveExpiredNodeReceiveWindows - Removed expired RX windows");
+    #endif
+    CLoraRealtimeSender_RemoveNodeReceiveWindow(this, wBlockIndex);
+  }
+  xSemaphoreGive(this->m_hReceiveWindowMutex);
+}
+
+
+// Removes an entry from 'm_pNodeReceiveWindowArray' array and its indexes
+// Note: The caller owns the 'm_hReceiveWindowMutex' mutex
+void CLoraRealtimeSender_RemoveNodeReceiveWindow(CLoraRealtimeSender *this, WORD wBlockIndex)
+{
+  CHashIndex_Remove(this->m_pNodeReceiveWindowIndex, wBlockIndex);
+  CMinHeap_Remove(this->m_pNodeReceiveWindowExpiryHeap, wBlockIndex);
+  CWideMemoryBlockArray_ReleaseBlock(this->m_pNodeReceiveWindowArray, wBlockIndex);
+}
+
+
+// Starts the one-shot timer executing 'FireSend' at the specified time (gateway clock)
+// Note: On Linux host, the 'SenderTask' sleeps until the absolute time (i.e. high resolution
+//       sleep on monotonic clock) and the timer callback is directly invoked
+void CLoraRealtimeSender_StartFireTimer(CLoraRealtimeSender *this, QWORD qwFireTimestamp)
+{
+  QWORD qwCurrentTimestamp = GATEWAY_CLOCK_MICROSEC();
+
+  #ifdef ESP_PLATFORM
+    if (qwFireTimestamp > qwCurrentTimestamp)
     {
-      if (((CNodeReceiveWindow) EnumItem.m_pItemData)->m_usDeviceClass == NODERECEIVEWINDOW_DEVICECLASS_A)
+      if (esp_timer_start_once(this->m_hFireTimer, qwFireTimestamp - qwCurrentTimestamp) == ESP_OK)
       {
-        if (dwCurrentTimestamp > ((CNodeReceiveWindow) EnumItem.m_pItemData)->m_dwRX2WindowTimestamp + 
-            (LORAREALTIMESENDER_LORAWAN_RX_WINDOW_LENGTH - LORAREALTIMESENDER_GATEWAY_TX_DELAY))
+        return;
+      }
+
+      // Should never occur
+      #if (LORAREALTIMESENDER_DEBUG_LEVEL0)
+        DEBUG_PRINT_LN("[ERROR] CLoraRealtimeSender_StartFireTimer - Failed to start timer");
+      #endif
+    }
+  #else
+    struct timespec FireTime;
+    int nSleepResult;
+
+    if (qwFireTimestamp > qwCurrentTimestamp)
+    {
+      clock_gettime(CLOCK_MONOTONIC, &FireTime);
+      FireTime.tv_sec += (time_t) ((qwFireTimestamp - qwCurrentTimestamp) / 1000000);
+      FireTime.tv_nsec += (long) (((qwFireTimestamp - qwCurrentTimestamp) % 1000000) * 1000);
+      if (FireTime.tv_nsec >= 1000000000)
+      {
+        FireTime.tv_nsec -= 1000000000;
+        ++FireTime.tv_sec;
+      }
+      // Note: The error number is returned (i.e. 'errno' not set), only an interrupted sleep is
+      //       resumed (i.e. absolute time), other errors fire immediately
+      do
+      {
+        nSleepResult = clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &FireTime, NULL);
+      } while (nSleepResult == EINTR);
+
+      #if (LORAREALTIMESENDER_DEBUG_LEVEL0)
+        if (nSleepResult != 0)
         {
-          #if (LORAREALTIMESENDER_DEBUG_LEVEL0)
-            DEBUG_PRINT_LN("[INFO] CLoraRealtimeSender_RemoveExpiredNodeReceiveWindows - Removed expired RX windows");
-          #endif
-          CMemoryBlockArray_ReleaseBlock(this->m_pNodeReceiveWindowArray, EnumItem.m_usBlockIndex);
+          DEBUG_PRINT("[ERROR] CLoraRealtimeSender_StartFireTimer - Failed to wait fire time, error: ");
+          DEBUG_PRINT_DEC(nSleepResult);
+          DEBUG_PRINT_CR;
         }
-      }
-    } 
-    while (CMemoryBlockArray_EnumNext(this->m_pNodeReceiveWindowArray, &EnumItem) == true);
+      #endif
+    }
+  #endif
+
+  // Time already reached
+  CLoraRealtimeSender_FireTimerCallback(this);
+}
+
+
+// One-shot timer callback: wakes up the 'SenderTask' to start the transmission of the armed packet
+// Note: Executed by the 'esp_timer' task on ESP32 (i.e. shared with other timer callbacks, the SPI
+//       transaction is executed by the 'SenderTask' on radio core)
+void CLoraRealtimeSender_FireTimerCallback(void *pArg)
+{
+  xSemaphoreGive(((CLoraRealtimeSender *) pArg)->m_hFireWake);
+}
+
+// Starts the transmission of the armed packet ('m_pNextRealtimeLoraPacket')
+// Note: The transceiver does not start the transmission if it cannot take the SPI bus before the
+//       late limit (i.e. 'm_bLate' returned)
+void CLoraRealtimeSender_FireSend(CLoraRealtimeSender *this)
+{
+  CRealtimeLoraPacket pRealtimeLoraPacket = this->m_pNextRealtimeLoraPacket;
+
+  this->m_FireSendParams.m_qwLateTimestamp = pRealtimeLoraPacket->m_bASAP == true ? 0 :
+                                             pRealtimeLoraPacket->m_qwSendTimestamp + LORAREALTIMESENDER_TX_LATE_LIMIT;
+  this->m_FireSendParams.m_bLate = false;
+  if ((this->m_FireSendParams.m_qwLateTimestamp != 0) && (GATEWAY_CLOCK_MICROSEC() > this->m_FireSendParams.m_qwLateTimestamp))
+  {
+    this->m_usFireResult = LORAREALTIMESENDER_FIRE_LATE;
+  }
+  else if (ILoraTransceiver_FireSend(pRealtimeLoraPacket->m_pLoraTransceiverItf, &(this->m_FireSendParams)) == true)
+  {
+    this->m_usFireResult = LORAREALTIMESENDER_FIRE_SENDING;
+  }
+  else
+  {
+    this->m_usFireResult = this->m_FireSendParams.m_bLate == true ? LORAREALTIMESENDER_FIRE_LATE : LORAREALTIMESENDER_FIRE_FAILED;
   }
 }
 
+
+void CLoraRealtimeSender_UpdateTxStats(CLoraRealtimeSender *this, BYTE usRxWindow, QWORD qwSendTimestamp, QWORD qwFireTimestamp)
+{
+  CLoraRealtimeSenderItf_TxStatistics pTxStats;
+  DWORD dwError;
+
+  pTxStats = &(this->m_pTxStatistics[usRxWindow]);
+  dwError = qwFireTimestamp > qwSendTimestamp ? (DWORD) (qwFireTimestamp - qwSendTimestamp) : 0;
+
+  if ((pTxStats->m_dwFireNumber == 0) || (dwError < pTxStats->m_dwErrorMin))
+  {
+    pTxStats->m_dwErrorMin = dwError;
+  }
+  if (dwError > pTxStats->m_dwErrorMax)
+  {
+    pTxStats->m_dwErrorMax = dwError;
+  }
+  pTxStats->m_qwErrorSum += dwError;
+  ++pTxStats->m_dwFireNumber;
+
+  #if (LORAREALTIMESENDER_DEBUG_LEVEL1)
+    DEBUG_PRINT(usRxWindow == REALTIMELORAPACKET_RXWINDOW_RX1 ? "[INFO] RX1" : "[INFO] RX2");
+    DEBUG_PRINT(" TX start error (us): ");
+    DEBUG_PRINT_DEC(dwError);
+    DEBUG_PRINT(", average: ");
+    DEBUG_PRINT_DEC((DWORD) (pTxStats->m_qwErrorSum / pTxStats->m_dwFireNumber));
+    DEBUG_PRINT(", max: ");
+    DEBUG_PRINT_DEC(pTxStats->m_dwErrorMax);
+    DEBUG_PRINT(", late: ");
+    DEBUG_PRINT_DEC(pTxStats->m_dwLateNumber);
+    DEBUG_PRINT(", failed: ");
+    DEBUG_PRINT_DEC(pTxStats->m_dwFailedNumber);
+    DEBUG_PRINT_CR;
+  #endif
+}
@@ -52,6 +52,8 @@
 #include "NetworkServerProtocolItf.h"
 #include "SemtechProtocolEngineItf.h"
 #include "TransceiverManagerItf.h"
+#include "TaskPlacement.h"
+#include "TraceRing.h"
 
 // Object's definitions and methods
 #include "LoraServerManager.h"
@@ -393,7 +395,7 @@ bool CLoraServerManager_ServerMessageEvent(void *this, void *pEvent)
   // Note: The 'CLoraServerManager_MessageOb' object inserted in queue is a 
   //       'CServerManagerItf_ServerMessageEventOb' object
   QueueMessage.m_wMessageType = ((CServerManagerItf_ServerMessageEvent) pEvent)->m_wEventType;
-  QueueMessage.m_dwMessageData = (DWORD)((CServerManagerItf_ServerMessageEvent) pEvent)->m_pMessage;
+  QueueMessage.m_dwMessageData = (uintptr_t)((CServerManagerItf_ServerMessageEvent) pEvent)->m_pMessage;
   QueueMessage.m_dwMessageData2 = ((CServerManagerItf_ServerMessageEvent) pEvent)->m_dwParam;
 
   #if (LORASERVERMANAGER_DEBUG_LEVEL2)
@@ -601,17 +603,32 @@ void CLoraServerManager_ServerManagerAutomaton(CLoraServerManager *this)
   CLoraServerManager_MessageOb QueueMessage;
   CLoraServerUpMessage pLoraServerMessage;
   CNetworkServerProtocol_BuildUplinkMessageParamsOb ProtocolEncodeParams;
+  TickType_t dwWaitTicks;
+  TickType_t dwReplayWaitTicks = pdMS_TO_TICKS(500);
 
   // Initialize the parameter object for 'heartbeat' processing (i.e. same object used uring
   // whole life of task)
   this->m_HeartbeatMessageOb.m_usMessageId = 0xFF;
   this->m_HeartbeatMessageOb.m_dwProtocolMessageId = 0xFFFFFFFF;
   this->m_HeartbeatMessageOb.m_pLoraPacket = NULL;
+  this->m_HeartbeatMessageOb.m_pLoraPacketPool = NULL;
   this->m_HeartbeatMessageOb.m_pLoraPacketInfo = NULL;
   this->m_HeartbeatMessageOb.m_pSession = NULL;
+  this->m_HeartbeatMessageOb.m_usNextMessageId = 0xFF;
+  this->m_HeartbeatMessageOb.m_pData = this->m_usHeartbeatData;
+
+  // Same initialization for replayed stored messages (i.e. message data provided by 'UplinkLog')
+  this->m_ReplayMessageOb.m_usMessageId = 0xFE;
+  this->m_ReplayMessageOb.m_dwProtocolMessageId = 0xFFFFFFFF;
+  this->m_ReplayMessageOb.m_pLoraPacket = NULL;
+  this->m_ReplayMessageOb.m_pLoraPacketPool = NULL;
+  this->m_ReplayMessageOb.m_pLoraPacketInfo = NULL;
+  this->m_ReplayMessageOb.m_pSession = NULL;
+  this->m_ReplayMessageOb.m_usNextMessageId = 0xFF;
+  this->m_ReplayMessageOb.m_pData = this->m_usReplayData;
 
   ProtocolEncodeParams.m_wServerManagerMessageId = 0xFF;
-  ProtocolEncodeParams.m_pMessageData = this->m_HeartbeatMessageOb.m_usData;
+  ProtocolEncodeParams.m_pMessageData = this->m_HeartbeatMessageOb.m_pData;
   ProtocolEncodeParams.m_wMessageType = NETWORKSERVERPROTOCOL_UPLINKMSG_HEARTBEAT;
   ProtocolEncodeParams.m_bForceHeartbeat = false;
   ProtocolEncodeParams.m_pLoraPacket = NULL;
@@ -628,7 +645,15 @@ void CLoraServerManager_ServerManagerAutomaton(CLoraServerManager *this)
       #endif
   
       // Wait for messages
-      if (xQueueReceive(this->m_hServerManagerQueue, &QueueMessage, pdMS_TO_TICKS(500)) == pdPASS)
+      // Note: The wait is shortened while an aggregated uplink message is open (i.e. the message is sent
+      //       when the aggregation window is elapsed) or when stored messages are replayed
+      dwWaitTicks = CLoraServerManager_CheckAggregatedMessage(this);
+      if (dwReplayWaitTicks < dwWaitTicks)
+      {
+        dwWaitTicks = dwReplayWaitTicks;
+      }
+
+      if (xQueueReceive(this->m_hServerManagerQueue, &QueueMessage, dwWaitTicks) == pdPASS)
       {
         // Process message
         #if (LORASERVERMANAGER_DEBUG_LEVEL0)
@@ -726,6 +751,18 @@ void CLoraServerManager_ServerManagerAutomaton(CLoraServerManager *this)
           #endif
         }
       }
+
+      // Terminate the uplink sessions expired in 'ProtocolEngine' (i.e. ACK not received from Network Server)
+      if (this->m_pNetworkServerProtocolItf != NULL)
+      {
+        CLoraServerManager_CheckExpiredSessions(this);
+      }
+
+      // Replay the uplink messages stored while no 'ServerConnector' was available
+      if ((this->m_pUplinkLog != NULL) && (this->m_dwCurrentState == LORASERVERMANAGER_AUTOMATON_STATE_RUNNING))
+      {
+        dwReplayWaitTicks = CLoraServerManager_ReplayStoredMessage(this);
+      }
     }
     else
     {
@@ -766,16 +803,19 @@ void CLoraServerManager_ServerManagerAutomaton(CLoraServerManager *this)
  * 
  * @details    This function is the RTOS task used to process uplink packets received from
  *             'LoraNodeManager'.
- *             When an uplink packet is received from 'LoraNodeManager':
+ *             The 'LoraNodeManager' pushes the uplink packets in the 'm_pUplinkQueue' bounded
+ *             queue and notifies the task. The queue is drained in batches and for each uplink
+ *             packet:
  *              - A new 'CLoraServerUpMessage' object is created and inserted in the 
  *                'm_pLoraServerUpMessageArray' memory block array.
  *              - A 'UPLINK_ACCEPTED' event is sent to the 'LoraNodeManager' to inform it that
- *                next 'LoraPacket' can be transmitted (via 'ITransceiverManager' interface).
+ *                the 'CServerManagerItf_LoraSessionPacketOb' object is no more used.
  *              - A 'UPLINK_RECEIVED' event is sent to main automaton ('ServerManager' task to
  *                inforn it that a new 'LoraPacket' is received. The 'ServerManager' task will
  *                generate a suitable message for the Network Server and send it.
- *             If there is no space in 'm_pLoraServerUpMessageArray' to accept the new 
- *             'Lorapacket' a 'UPLINK_REJECTED' event is sent to the 'LoraNodeManager'.
+ *             If there is no space in 'm_pLoraServerUpMessageArray', the uplink packets are left
+ *             in the queue (i.e. the 'LoraNodeManager' stops forwarding packets when the queue is 
+ *             full). The task is notified when a 'CLoraServerUpMessage' is released.
  * 
  * @param      this
  *             The pointer to CLoraServerManager object.
@@ -783,8 +823,8 @@ void CLoraServerManager_ServerManagerAutomaton(CLoraServerManager *this)
  * @return     The RTOS task terminates when object is deleted (typically on main program
  *             exit).
  *
- * @note       The automaton's main loop waits for direct notify.
- *             The notify value is a pointer to a 'CServerManagerItf_LoraSessionPacket' object.
+ * @note       The automaton's main loop waits for direct notify (no notify value).
+ *             The queue items are pointers to 'CServerManagerItf_LoraSessionPacket' objects.
  *             The contents of this 'CServerManagerItf_LoraSessionPacketOb' object may change 
  *             as soon as the 'UPLINK_ACCEPTED' or 'UPLINK_REJECTED' event is sent.
  *             The 'CLoraPacketSession' and 'CLoraPacket' referenced in the received
@@ -798,15 +838,6 @@ void CLoraServerManager_ServerManagerAutomaton(CLoraServerManager *this)
 *********************************************************************************************/
 void CLoraServerManager_NodeManagerAutomaton(CLoraServerManager *this)
 {
-  CServerManagerItf_LoraSessionPacket pLoraSessionPacket;
-
-  CMemoryBlockArrayEntryOb MemBlockEntry;
-  CLoraTransceiverItf_LoraPacket pReceivedPacket;
-  CTransceiverManagerItf_SessionEventOb SessionEvent;
-  CServerManagerItf_ServerMessageEventOb ServerMessageEvent;
-  CLoraServerUpMessage pLoraServerMessage;
-
-
   while (this->m_dwCurrentState != LORASERVERMANAGER_AUTOMATON_STATE_TERMINATED)
   {
     if (this->m_dwCurrentState >= LORASERVERMANAGER_AUTOMATON_STATE_INITIALIZED)
@@ -816,138 +847,210 @@ void CLoraServerManager_NodeManagerAutomaton(CLoraServerManager *this)
       #endif
 
       // Wait for notify
-      if (xTaskNotifyWait(0, 0xFFFFFFFF, (DWORD *) &pLoraSessionPacket, pdMS_TO_TICKS(500)) == pdTRUE)
+      // Note: The queue is also checked on timeout (i.e. notifications are not counted)
+      xTaskNotifyWait(0, 0xFFFFFFFF, NULL, pdMS_TO_TICKS(500));
+
+      // Drain the uplink queue
+      while (CLoraServerManager_ProcessUplinkQueue(this) > 0)
       {
-        // Process new 'LoraPacketSession' (i.e. uplink packet)
-        #if (LORASERVERMANAGER_DEBUG_LEVEL0)
-          DEBUG_PRINT_CR;
-          DEBUG_PRINT("CLoraServerManager_NodeManagerAutomaton, new uplink packet session received: ");
-          DEBUG_PRINT_HEX(pLoraSessionPacket->m_dwSessionId);
-          DEBUG_PRINT_CR;
-        #endif
+      }
+    }
+    else
+    {
+      // Parent object not ready, wait for end of object's initialization
+      vTaskDelay(pdMS_TO_TICKS(100));
+    }
+  }
 
-        // For event sent to 'LoraNodeManager' (i.e. LoRa packet 'ACCEPTED' or 'REJECTED')
-        SessionEvent.m_pSession = pLoraSessionPacket->m_pSession;
-        SessionEvent.m_dwSessionId = pLoraSessionPacket->m_dwSessionId;  
+  // Main automaton terminated (typically 'CLoraServerManager' being deleted)
+  vTaskDelete(NULL);
+  this->m_hNodeManagerTask = NULL;
+}
 
-        // New uplink 'LoraPacket' allowed only in 'RUNNING' automaton state
-        if (this->m_dwCurrentState != LORASERVERMANAGER_AUTOMATON_STATE_RUNNING)
-        {
-          #if (LORASERVERMANAGER_DEBUG_LEVEL0)
-            DEBUG_PRINT("[WARNING] LoraPacket received in wrong state: ");
-            DEBUG_PRINT_DEC(this->m_dwCurrentState);
-            DEBUG_PRINT_CR;
-          #endif
 
-          // Notify 'LoraNodeManager' that packet is rejected
-          SessionEvent.m_wEventType = TRANSCEIVERMANAGER_SESSIONEVENT_UPLINK_REJECTED;
-          ITransceiverManager_SessionEvent(this->m_pTransceiverManagerItf, &SessionEvent);
-          continue;
-        }
+/********************************************************************************************* 
 
-        // Received LoRa packet
-        pReceivedPacket = (CLoraTransceiverItf_LoraPacket) (pLoraSessionPacket->m_pLoraPacket);
+  Processing of uplink packets received by 'NodeManager' Task
 
-        #if (LORASERVERMANAGER_DEBUG_LEVEL2)
-          DEBUG_PRINT("[DEBUG] CLoraServerManager_NodeManagerAutomaton. Received packet, addr: ");
-          DEBUG_PRINT_HEX((DWORD) pReceivedPacket);
-          DEBUG_PRINT(", Timestamp: ");
-          DEBUG_PRINT_DEC(pReceivedPacket->m_dwTimestamp);
-          DEBUG_PRINT(", Data size: ");
-          DEBUG_PRINT_DEC(pReceivedPacket->m_dwDataSize);
-          DEBUG_PRINT(", Head data: ");
-          DEBUG_PRINT_HEX(pReceivedPacket->m_usData[0]);
-          DEBUG_PRINT(",");
-          DEBUG_PRINT_HEX(pReceivedPacket->m_usData[1]);
-          DEBUG_PRINT(",");
-          DEBUG_PRINT_HEX(pReceivedPacket->m_usData[2]);
-          DEBUG_PRINT(",");
-          DEBUG_PRINT_HEX(pReceivedPacket->m_usData[3]);
-          DEBUG_PRINT_CR;
-        #endif
+*********************************************************************************************/
 
-        // Step 1 - Obtain a 'MemoryBlock' to prepare a new 'LoraServerUpMessage' to process the received uplink packet
+// Processes one batch of uplink packets waiting in 'm_pUplinkQueue'
+// Returns the number of uplink packets removed from the queue
+// Note: The 'CLoraServerUpMessage' objects are reserved before removing the packets from the queue
+//       (i.e. the packets remain in queue when the 'm_pLoraServerUpMessageArray' is exhausted)
+WORD CLoraServerManager_ProcessUplinkQueue(CLoraServerManager *this)
+{
+  void *pLoraSessionPackets[LORASERVERMANAGER_MAX_SERVERUPMESSAGES];
+  CMemoryBlockArrayEntryOb MemBlockEntries[LORASERVERMANAGER_MAX_SERVERUPMESSAGES];
+  CServerManagerItf_LoraSessionPacket pLoraSessionPacket;
+  CTransceiverManagerItf_SessionEventOb SessionEvent;
+  WORD wMaxItems;
+  WORD wBlockNumber;
+  WORD wItemNumber;
 
-        if ((pLoraServerMessage = CMemoryBlockArray_GetBlock(this->m_pLoraServerUpMessageArray, &MemBlockEntry)) == NULL)
-        {
-          // Should never occur. Buffer for 'LoraServerUpMessage' exhausted
-          // Note: No recovery mechanism = for stress test in current version
-          #if (LORASERVERMANAGER_DEBUG_LEVEL0)
-            DEBUG_PRINT_LN("[ERROR] LoraServerUpMessage buffer exhausted. Entering 'ERROR' state");
-            this->m_dwCurrentState = LORASERVERMANAGER_AUTOMATON_STATE_ERROR;
-          #endif
+  // Batch size bounded by the number of 'LoraServerUpMessages'
+  if ((wMaxItems = CMpscRing_GetOccupancy(this->m_pUplinkQueue)) == 0)
+  {
+    return 0;
+  }
+  if (wMaxItems > LORASERVERMANAGER_MAX_SERVERUPMESSAGES)
+  {
+    wMaxItems = LORASERVERMANAGER_MAX_SERVERUPMESSAGES;
+  }
 
-          // Notify 'LoraNodeManager' that packet is rejected
-          SessionEvent.m_wEventType = TRANSCEIVERMANAGER_SESSIONEVENT_UPLINK_REJECTED;
-          ITransceiverManager_SessionEvent(this->m_pTransceiverManagerItf, &SessionEvent);
-          continue;
-        }
+  // New uplink 'LoraPacket' allowed only in 'RUNNING' automaton state
+  if (this->m_dwCurrentState != LORASERVERMANAGER_AUTOMATON_STATE_RUNNING)
+  {
+    wItemNumber = CMpscRing_Pop(this->m_pUplinkQueue, pLoraSessionPackets, wMaxItems);
 
-        // Step 2 - Initialize 'LoraServerUpMessage'
+    for (WORD i = 0; i < wItemNumber; i++)
+    {
+      pLoraSessionPacket = (CServerManagerItf_LoraSessionPacket) pLoraSessionPackets[i];
 
-        pLoraServerMessage->m_dwMessageState = LORANODEMANAGER_SERVERUPMESSAGE_STATE_CREATED;
+      #if (LORASERVERMANAGER_DEBUG_LEVEL0)
+        DEBUG_PRINT("[WARNING] LoraPacket received in wrong state: ");
+        DEBUG_PRINT_DEC(this->m_dwCurrentState);
+        DEBUG_PRINT_CR;
+      #endif
 
-        // The identifier of the 'LoraServerUpMessage' is the index in the 'm_pLoraServerUpMessageArray' MemoryBlockArray
-        pLoraServerMessage->m_usMessageId = MemBlockEntry.m_usBlockIndex;
+      // Notify 'LoraNodeManager' that packet is rejected
+      SessionEvent.m_pSession = pLoraSessionPacket->m_pSession;
+      SessionEvent.m_dwSessionId = pLoraSessionPacket->m_dwSessionId;  
+      SessionEvent.m_wEventType = TRANSCEIVERMANAGER_SESSIONEVENT_UPLINK_REJECTED;
+      ITransceiverManager_SessionEvent(this->m_pTransceiverManagerItf, &SessionEvent);
+    }
+    return wItemNumber;
+  }
 
-        // The 'CLoraPacket' and 'CLoraPacketSession' objects are owned by 'CLoraNodeManager'
-        // The 'CLoraPacket' object is alive until 'TRANSCEIVERMANAGER_SESSIONEVENT_UPLINK_PROGRESSING' event is sent to
-        // 'CLoraNodeManager'
-        pLoraServerMessage->m_pLoraPacket = pLoraSessionPacket->m_pLoraPacket;
-        pLoraServerMessage->m_pSession = pLoraSessionPacket->m_pSession;
-        pLoraServerMessage->m_pLoraPacketInfo = pLoraSessionPacket->m_pLoraPacketInfo;
-        pLoraServerMessage->m_dwSessionId = pLoraSessionPacket->m_dwSessionId;
-        pLoraServerMessage->m_wDataLength = 0;
+  // Step 1 - Obtain the 'MemoryBlocks' to prepare the new 'LoraServerUpMessages'
 
-        // The 'LoraServerUpMessage' object is fully defined in MemoryBlocks (i.e. it is 'CREATED')
-        // Set the 'Ready' flag to allow other tasks to use it
-        CMemoryBlockArray_SetBlockReady(this->m_pLoraServerUpMessageArray, MemBlockEntry.m_usBlockIndex);
+  for (wBlockNumber = 0; wBlockNumber < wMaxItems; wBlockNumber++)
+  {
+    if (CMemoryBlockArray_GetBlock(this->m_pLoraServerUpMessageArray, &MemBlockEntries[wBlockNumber]) == NULL)
+    {
+      break;
+    }
+  }
 
-        // Step 3 - Notify 'LoraNodeManager' that packet is accepted
+  if (wBlockNumber == 0)
+  {
+    // Buffer for 'LoraServerUpMessage' exhausted
+    // The uplink packets stay in queue until a 'LoraServerUpMessage' is released
+    #if (LORASERVERMANAGER_DEBUG_LEVEL1)
+      DEBUG_PRINT_LN("[WARNING] CLoraServerManager_ProcessUplinkQueue, LoraServerUpMessage buffer exhausted");
+    #endif
+    return 0;
+  }
 
-        #if (LORASERVERMANAGER_DEBUG_LEVEL0)
-          DEBUG_PRINT_LN("[INFO] CLoraServerManager_NodeManagerAutomaton, uplink packet accepted");
-        #endif
+  // Step 2 - Process the batch of uplink packets
 
-        SessionEvent.m_wEventType = TRANSCEIVERMANAGER_SESSIONEVENT_UPLINK_ACCEPTED;
-        ITransceiverManager_SessionEvent(this->m_pTransceiverManagerItf, &SessionEvent);
+  wItemNumber = CMpscRing_Pop(this->m_pUplinkQueue, pLoraSessionPackets, wBlockNumber);
 
-        // Step 4 - Inform the main automaton that a new LoRa packet must be prosessed (encoded) and sent
-        //
-        // Note: The processing of received LoRa packet is decoupled here to support small uplink packet bursts
-        //       (i.e. building Network Server message from LoRa packet is a bit heavy)
+  #if (LORASERVERMANAGER_DEBUG_LEVEL2)
+    DEBUG_PRINT("[DEBUG] CLoraServerManager_ProcessUplinkQueue, batch size: ");
+    DEBUG_PRINT_DEC((DWORD) wItemNumber);
+    DEBUG_PRINT(", high watermark: ");
+    DEBUG_PRINT_DEC((DWORD) CMpscRing_GetHighWatermark(this->m_pUplinkQueue));
+    DEBUG_PRINT(", full: ");
+    DEBUG_PRINT_DEC(CMpscRing_GetFullNumber(this->m_pUplinkQueue));
+    DEBUG_PRINT_CR;
+  #endif
 
-        #if (LORASERVERMANAGER_DEBUG_LEVEL2)
-          DEBUG_PRINT("[DEBUG] CLoraServerManager_NodeManagerAutomaton, Sending Event message, Addr: ");
-          DEBUG_PRINT_HEX((DWORD) pLoraServerMessage);
-          DEBUG_PRINT(", Id: ");
-          DEBUG_PRINT_HEX((DWORD) pLoraServerMessage->m_usMessageId);
-          DEBUG_PRINT(", Lora packet: ");
-          DEBUG_PRINT_HEX((DWORD) pLoraServerMessage->m_pLoraPacket);
-          DEBUG_PRINT(", Packet session: ");
-          DEBUG_PRINT_HEX((DWORD) pLoraServerMessage->m_pSession);
-          DEBUG_PRINT(", Packet Info: ");
-          DEBUG_PRINT_HEX((DWORD) pLoraServerMessage->m_pLoraPacketInfo);
-          DEBUG_PRINT_CR;
-        #endif
+  for (WORD i = 0; i < wItemNumber; i++)
+  {
+    CLoraServerManager_ProcessUplinkSessionPacket(this, (CServerManagerItf_LoraSessionPacket) pLoraSessionPackets[i],
+                                                  (CLoraServerUpMessage) MemBlockEntries[i].m_pDataBlock,
+                                                  MemBlockEntries[i].m_usBlockIndex);
+  }
 
-        ServerMessageEvent.m_wEventType = SERVERMANAGER_MESSAGEEVENT_UPLINK_RECEIVED;
-        ServerMessageEvent.m_pMessage = pLoraServerMessage;
-        ServerMessageEvent.m_dwParam = NULL;
-//      ServerMessageEvent.m_dwMessageId = (DWORD) pLoraServerMessage->m_usMessageId;
-        IServerManager_ServerMessageEvent(this->m_pServerManagerItf, &ServerMessageEvent);
-      }
-    }
-    else
-    {
-      // Parent object not ready, wait for end of object's initialization
-      vTaskDelay(pdMS_TO_TICKS(100));
-    }
+  // Release unused 'MemoryBlocks'
+  for (WORD i = wItemNumber; i < wBlockNumber; i++)
+  {
+    CMemoryBlockArray_ReleaseBlock(this->m_pLoraServerUpMessageArray, MemBlockEntries[i].m_usBlockIndex);
   }
 
-  // Main automaton terminated (typically 'CLoraServerManager' being deleted)
-  vTaskDelete(NULL);
-  this->m_hNodeManagerTask = NULL;
+  return wItemNumber;
+}
+
+// Creates the 'LoraServerUpMessage' for one uplink packet (stored in the 'MemoryBlock' reserved by caller)
+void CLoraServerManager_ProcessUplinkSessionPacket(CLoraServerManager *this, CServerManagerItf_LoraSessionPacket pLoraSessionPacket,
+                                                   CLoraServerUpMessage pLoraServerMessage, BYTE usMessageId)
+{
+  CLoraTransceiverItf_LoraPacket pReceivedPacket;
+  CTransceiverManagerItf_SessionEventOb SessionEvent;
+  CServerManagerItf_ServerMessageEventOb ServerMessageEvent;
+
+  // Process new 'LoraPacketSession' (i.e. uplink packet)
+  // For event sent to 'LoraNodeManager' (i.e. LoRa packet 'ACCEPTED')
+  SessionEvent.m_pSession = pLoraSessionPacket->m_pSession;
+  SessionEvent.m_dwSessionId = pLoraSessionPacket->m_dwSessionId;  
+
+  // Received LoRa packet
+  pReceivedPacket = (CLoraTransceiverItf_LoraPacket) (pLoraSessionPacket->m_pLoraPacket);
+  CTaskPlacement_RecordLatency(TASKPLACEMENT_TASK_SERVERMANAGER_NODEMANAGER, pReceivedPacket->m_qwTimestamp);
+
+  #if (LORASERVERMANAGER_DEBUG_LEVEL0)
+    TRACERING_EVENT(TRACERING_ID_SERVERMANAGER_UPLINK, pLoraSessionPacket->m_dwSessionId, usMessageId,
+                    pReceivedPacket->m_dwDataSize, pReceivedPacket->m_qwTimestamp);
+  #endif
+
+  // Step 1 - Initialize 'LoraServerUpMessage'
+
+  pLoraServerMessage->m_dwMessageState = LORANODEMANAGER_SERVERUPMESSAGE_STATE_CREATED;
+
+  // The identifier of the 'LoraServerUpMessage' is the index in the 'm_pLoraServerUpMessageArray' MemoryBlockArray
+  pLoraServerMessage->m_usMessageId = usMessageId;
+
+  // The 'CLoraPacketSession' object is owned by 'CLoraNodeManager'
+  // The 'CLoraPacket' object is a shared packet buffer: add a reference on it for the 'LoraServerUpMessage'
+  // (released when the packet is encoded)
+  pLoraServerMessage->m_pLoraPacket = pLoraSessionPacket->m_pLoraPacket;
+  pLoraServerMessage->m_pLoraPacketPool = pLoraSessionPacket->m_pLoraPacketPool;
+  CWideMemoryBlockArray_AddRef(pLoraServerMessage->m_pLoraPacketPool,
+    CWideMemoryBlockArray_BlockIndexFromPtr(pLoraServerMessage->m_pLoraPacketPool, pLoraServerMessage->m_pLoraPacket));
+  pLoraServerMessage->m_pSession = pLoraSessionPacket->m_pSession;
+  pLoraServerMessage->m_pLoraPacketInfo = pLoraSessionPacket->m_pLoraPacketInfo;
+  pLoraServerMessage->m_dwSessionId = pLoraSessionPacket->m_dwSessionId;
+  pLoraServerMessage->m_wDataLength = 0;
+  pLoraServerMessage->m_pData = NULL;
+  pLoraServerMessage->m_usNextMessageId = 0xFF;
+
+  // The 'LoraServerUpMessage' object is fully defined in MemoryBlocks (i.e. it is 'CREATED')
+  // Set the 'Ready' flag to allow other tasks to use it
+  CMemoryBlockArray_SetBlockReady(this->m_pLoraServerUpMessageArray, usMessageId);
+
+  // Step 2 - Notify 'LoraNodeManager' that packet is accepted
+
+  #if (LORASERVERMANAGER_DEBUG_LEVEL0)
+    TRACERING_EVENT(TRACERING_ID_SERVERMANAGER_ACCEPTED, SessionEvent.m_dwSessionId, usMessageId, 0, 0);
+  #endif
+
+  SessionEvent.m_wEventType = TRANSCEIVERMANAGER_SESSIONEVENT_UPLINK_ACCEPTED;
+  ITransceiverManager_SessionEvent(this->m_pTransceiverManagerItf, &SessionEvent);
+
+  // Step 3 - Inform the main automaton that a new LoRa packet must be prosessed (encoded) and sent
+  //
+  // Note: The processing of received LoRa packet is decoupled here to support small uplink packet bursts
+  //       (i.e. building Network Server message from LoRa packet is a bit heavy)
+
+  #if (LORASERVERMANAGER_DEBUG_LEVEL2)
+    DEBUG_PRINT("[DEBUG] CLoraServerManager_NodeManagerAutomaton, Sending Event message, Addr: ");
+    DEBUG_PRINT_PTR(pLoraServerMessage);
+    DEBUG_PRINT(", Id: ");
+    DEBUG_PRINT_HEX((DWORD) pLoraServerMessage->m_usMessageId);
+    DEBUG_PRINT(", Lora packet: ");
+    DEBUG_PRINT_PTR(pLoraServerMessage->m_pLoraPacket);
+    DEBUG_PRINT(", Packet session: ");
+    DEBUG_PRINT_PTR(pLoraServerMessage->m_pSession);
+    DEBUG_PRINT(", Packet Info: ");
+    DEBUG_PRINT_PTR(pLoraServerMessage->m_pLoraPacketInfo);
+    DEBUG_PRINT_CR;
+  #endif
+
+  ServerMessageEvent.m_wEventType = SERVERMANAGER_MESSAGEEVENT_UPLINK_RECEIVED;
+  ServerMessageEvent.m_pMessage = pLoraServerMessage;
+  ServerMessageEvent.m_dwParam = 0;
+  IServerManager_ServerMessageEvent(this->m_pServerManagerItf, &ServerMessageEvent);
 }
 
 
@@ -996,7 +1099,6 @@ void CLoraServerManager_NodeManagerAutomaton(CLoraServerManager *this)
 *********************************************************************************************/
 void CLoraServerManager_ConnectorAutomaton(CLoraServerManager *this)
 {
-  CServerConnectorItf_ServerDownlinkMessageOb DownlinkMessage;
   CNetworkServerProtocol_ProcessServerMessageParamsOb ProcessMessageParams;
   DWORD dwResult;
   CServerConnectorItf_ConnectorEventOb ConnectorEvent;
@@ -1006,6 +1108,10 @@ void CLoraServerManager_ConnectorAutomaton(CLoraServerManager *this)
   CLoraServerUpMessage pLoraServerUpMessage;
   CServerManagerItf_ServerMessageEventOb ServerMessageEvent;
   CMemoryBlockArrayEntryOb MemBlockEntry;
+  CTransceiverManagerItf_SendDownlinkParamsOb SendDownlinkParams;
+  CNetworkServerProtocol_BuildDownlinkAckParamsOb BuildDownlinkAckParams;
+  CServerConnectorItf_SendParamsOb SendParams;
+  BYTE usDownlinkAck[LORASERVERMANAGER_MAX_DOWNLINKACK_LENGTH];
 
   while (this->m_dwCurrentState < LORASERVERMANAGER_AUTOMATON_STATE_TERMINATED)
   {
@@ -1084,16 +1190,9 @@ void CLoraServerManager_ConnectorAutomaton(CLoraServerManager *this)
               #endif
   
               // Retrieve the associated 'CLoraServerUpMessageOb' in 'm_pLoraServerUpMessageArray'
-              // Note: Specific 'CLoraServerUpMessageOb' for heartbeat(outside of array)
+              // Note: Specific 'CLoraServerUpMessageOb' for heartbeat and replayed message (outside of array)
               usBlockIndex = (BYTE) LORASERVERMANAGER_SERVERMANAGER_MESSAGEID(ProcessMessageParams.m_dwProtocolMessageId);
-              if (LORASERVERMANAGER_SERVERMANAGER_IS_HEARTBEAT(usBlockIndex))
-              {
-                pLoraServerUpMessage = &this->m_HeartbeatMessageOb;
-              }
-              else
-              {
-                pLoraServerUpMessage = CMemoryBlockArray_BlockPtrFromIndex(this->m_pLoraServerUpMessageArray, usBlockIndex);
-              }
+              pLoraServerUpMessage = CLoraServerManager_GetUpMessage(this, usBlockIndex);
 
               // Consistency check
               if (pLoraServerUpMessage->m_dwProtocolMessageId == ProcessMessageParams.m_dwProtocolMessageId)
@@ -1129,11 +1228,48 @@ void CLoraServerManager_ConnectorAutomaton(CLoraServerManager *this)
               // The Network Server have provided downlink data
               // A LoRa packet has been prepared by the 'ServerProtocolEngine'
               // Ask the 'NodeManager' to forward downlink packet to node
-              
-              // TO DO 
-              #if (LORASERVERMANAGER_DEBUG_LEVEL0)
-                DEBUG_PRINT_LN("[ERROR] CLoraServerManager_ConnectorAutomaton, TO DO forward downlink packet");
+              // Note: This operation is synchronous and the LoRa packet is copied by 'NodeManager' (i.e. the
+              //       result is known here and the memory block can be released). The 'Connector' task is
+              //       blocked at most 'TRANSCEIVERMANAGER_SENDDOWNLINK_MAX_DURATION' (i.e. the acknowledges
+              //       received meanwhile are processed before the timeout of Network Server protocol)
+              SendDownlinkParams.m_wPayloadSize = ProcessMessageParams.m_wLoraPacketLength;
+              SendDownlinkParams.m_pPayload = ProcessMessageParams.m_pData;
+              SendDownlinkParams.m_bImmediate = ProcessMessageParams.m_DownlinkPacketInfo.m_bImmediate;
+              SendDownlinkParams.m_dwTimestamp = ProcessMessageParams.m_DownlinkPacketInfo.m_dwTimestamp;
+              SendDownlinkParams.m_dwFrequency = ProcessMessageParams.m_DownlinkPacketInfo.m_dwFrequency;
+              SendDownlinkParams.m_usPower = ProcessMessageParams.m_DownlinkPacketInfo.m_usPower;
+              SendDownlinkParams.m_usSpreadingFactor = ProcessMessageParams.m_DownlinkPacketInfo.m_usSpreadingFactor;
+              SendDownlinkParams.m_wBandwidth = ProcessMessageParams.m_DownlinkPacketInfo.m_wBandwidth;
+              SendDownlinkParams.m_usCodingRate = ProcessMessageParams.m_DownlinkPacketInfo.m_usCodingRate;
+              SendDownlinkParams.m_dwResult = TRANSCEIVERMANAGER_SENDDOWNLINK_TOO_LATE;
+              ITransceiverManager_SendDownlink(this->m_pTransceiverManagerItf, &SendDownlinkParams);
+
+              #if (LORASERVERMANAGER_DEBUG_LEVEL1)
+                DEBUG_PRINT("[INFO] CLoraServerManager_ConnectorAutomaton, downlink packet forwarded to NodeManager, result: ");
+                DEBUG_PRINT_DEC(SendDownlinkParams.m_dwResult);
+                DEBUG_PRINT_CR;
               #endif
+
+              // Reply to Network Server (i.e. packet scheduled or rejected)
+              // Note: The reply is sent on the 'Connector' which has received the downlink message. The send
+              //       event posted by the 'Connector' is ignored (i.e. no 'CLoraServerUpMessage' for reply)
+              BuildDownlinkAckParams.m_dwProtocolMessageId = ProcessMessageParams.m_dwProtocolMessageId;
+              BuildDownlinkAckParams.m_dwDownlinkResult = SendDownlinkParams.m_dwResult;
+              BuildDownlinkAckParams.m_wMaxMessageLength = LORASERVERMANAGER_MAX_DOWNLINKACK_LENGTH;
+              BuildDownlinkAckParams.m_pMessageData = usDownlinkAck;
+              if (INetworkServerProtocol_BuildDownlinkAck(this->m_pNetworkServerProtocolItf, &BuildDownlinkAckParams) == true)
+              {
+                SendParams.m_wDataLength = BuildDownlinkAckParams.m_wMessageLength;
+                SendParams.m_pData = usDownlinkAck;
+                SendParams.m_pMessage = NULL;
+                SendParams.m_dwMessageId = 0;
+                if (IServerConnector_Send(pDownlinkMessage->m_pConnectorItf, &SendParams) == false)
+                {
+                  #if (LORASERVERMANAGER_DEBUG_LEVEL0)
+                    DEBUG_PRINT_LN("[ERROR] CLoraServerManager_ConnectorAutomaton, unable to send downlink acknowledge");
+                  #endif
+                }
+              }
             }
             else
             {
@@ -1143,12 +1279,22 @@ void CLoraServerManager_ConnectorAutomaton(CLoraServerManager *this)
               #endif
             }
           }
+
+          // Step 4 - Release the memory block provided for LoRa packet
+          if (ProcessMessageParams.m_pData != NULL)
+          {
+            CMemoryBlockArray_ReleaseBlock(this->m_pDownlinkLoraPacketArray, MemBlockEntry.m_usBlockIndex);
+          }
         }
         else if (ConnectorEvent.m_wConnectorEventType == SERVERCONNECTOR_CONNECTOREVENT_SERVERMSG_EVENT)
         {
           // Event related to send operation (by 'Connector') for uplink message
           // Transmit this event to main automaton (i.e. event serialization in main automaton)
-          IServerManager_ServerMessageEvent(this->m_pServerManagerItf, &ConnectorEvent.m_ServerMessageEvent);
+          // Note: No 'CLoraServerUpMessage' for acknowledge of downlink message (i.e. event ignored)
+          if (ConnectorEvent.m_ServerMessageEvent.m_pMessage != NULL)
+          {
+            IServerManager_ServerMessageEvent(this->m_pServerManagerItf, &ConnectorEvent.m_ServerMessageEvent);
+          }
         }
         else
         {
@@ -1208,13 +1354,16 @@ CLoraServerManager * CLoraServerManager_New()
 
     // Embedded objects are not defined (i.e. created below)
     this->m_pLoraServerUpMessageArray = NULL;
+    this->m_pUplinkMessageStreamArray = NULL;
+    this->m_pUplinkQueue = NULL;
     this->m_pLoraServerDownMessageArray = NULL;
     this->m_pDownlinkMessageStreamArray = NULL;
     this->m_pDownlinkLoraPacketArray = NULL;
+    this->m_pUplinkLog = NULL;
 
-    this->m_hCommandMutex = this->m_hCommandDone = this->m_hServerManagerTask = 
-      this->m_hNodeManagerTask = this->m_hConnectorTask = this->m_hServerManagerQueue = 
-      this->m_hConnectorNotifQueue = this->m_hTransceiverManagerTask = NULL;
+    this->m_hCommandMutex = this->m_hCommandDone = this->m_hServerManagerQueue = this->m_hConnectorNotifQueue = NULL;
+    this->m_hServerManagerTask = this->m_hNodeManagerTask = this->m_hConnectorTask = 
+      this->m_hTransceiverManagerTask = NULL;
     this->m_pNetworkServerProtocolItf = NULL;
 
     // Allocate memory blocks for internal collections
@@ -1230,6 +1379,20 @@ CLoraServerManager * CLoraServerManager_New()
       return NULL;
     }
 
+    if ((this->m_pUplinkMessageStreamArray = CMemoryBlockArray_New(LORASERVERMANAGER_MAX_UPMESSAGE_LENGTH,
+        LORASERVERMANAGER_MAX_UPMESSAGESTREAMS)) == NULL)
+    {
+      CLoraServerManager_Delete(this);
+      return NULL;
+    }
+
+    // Queue of uplink packets forwarded by 'LoraNodeManager'
+    if ((this->m_pUplinkQueue = CMpscRing_New(LORASERVERMANAGER_UPLINK_QUEUE_DEPTH)) == NULL)
+    {
+      CLoraServerManager_Delete(this);
+      return NULL;
+    }
+
     #if (LORASERVERMANAGER_DEBUG_LEVEL2)
       DEBUG_PRINT_LN("[DEBUG] CLoraServerManager_New Entering: create object 2");
     #endif
@@ -1263,13 +1426,38 @@ CLoraServerManager * CLoraServerManager_New()
       return NULL;
     }
 
+    // Store-and-forward log for uplink messages
+    // Note: Not a fatal error if the log storage is not available (i.e. messages are lost when no 'ServerConnector'
+    //       can send them)
+    #if (CONFIG_UPLINK_LOG_ENABLE)
+    {
+      CUplinkLogBackendOb UplinkLogBackend;
+
+      #ifdef ESP_PLATFORM
+        if (CUplinkLog_InitPartitionBackend(&UplinkLogBackend, CONFIG_UPLINK_LOG_PARTITION) == true)
+      #else
+        if (CUplinkLog_InitFileBackend(&UplinkLogBackend, CONFIG_UPLINK_LOG_FILE, CONFIG_UPLINK_LOG_FILE_SIZE) == true)
+      #endif
+      {
+        this->m_pUplinkLog = CUplinkLog_New(&UplinkLogBackend);
+      }
+
+      #if (LORASERVERMANAGER_DEBUG_LEVEL0)
+        if (this->m_pUplinkLog == NULL)
+        {
+          DEBUG_PRINT_LN("[WARNING] CLoraServerManager_New, store-and-forward log not available");
+        }
+      #endif
+    }
+    #endif
+
     #if (LORASERVERMANAGER_DEBUG_LEVEL2)
       DEBUG_PRINT_LN("[DEBUG] CLoraServerManager_New Entering: create object 5");
     #endif
 
     // Create ServerManager automaton task
-    if (xTaskCreate((TaskFunction_t) CLoraServerManager_ServerManagerAutomaton, "CLoraServerManager_ServerManagerAutomaton", 
-        2048, this, 5, &(this->m_hServerManagerTask)) == pdFAIL)
+    if (CTaskPlacement_CreateTask(TASKPLACEMENT_TASK_SERVERMANAGER_MAIN, (TaskFunction_t) CLoraServerManager_ServerManagerAutomaton, 
+        this, &(this->m_hServerManagerTask)) == false)
     {
       CLoraServerManager_Delete(this);
       return NULL;
@@ -1301,8 +1489,8 @@ CLoraServerManager * CLoraServerManager_New()
     #endif
 
     // Create NodeManager automaton task
-    if (xTaskCreate((TaskFunction_t) CLoraServerManager_NodeManagerAutomaton, "CLoraServerManager_NodeManagerAutomaton", 
-        2048, this, 5, &(this->m_hNodeManagerTask)) == pdFAIL)
+    if (CTaskPlacement_CreateTask(TASKPLACEMENT_TASK_SERVERMANAGER_NODEMANAGER, (TaskFunction_t) CLoraServerManager_NodeManagerAutomaton, 
+        this, &(this->m_hNodeManagerTask)) == false)
     {
       CLoraServerManager_Delete(this);
       return NULL;
@@ -1314,8 +1502,8 @@ CLoraServerManager * CLoraServerManager_New()
     #endif
 
     // Create Connector automaton task
-    if (xTaskCreate((TaskFunction_t) CLoraServerManager_ConnectorAutomaton, "CLoraServerManager_ForwarderAutomaton", 
-        2048, this, 5, &(this->m_hConnectorTask)) == pdFAIL)
+    if (CTaskPlacement_CreateTask(TASKPLACEMENT_TASK_SERVERMANAGER_CONNECTOR, (TaskFunction_t) CLoraServerManager_ConnectorAutomaton, 
+        this, &(this->m_hConnectorTask)) == false)
     {
       CLoraServerManager_Delete(this);
       return NULL;
@@ -1352,6 +1540,16 @@ CLoraServerManager * CLoraServerManager_New()
     this->m_nRefCount = 0;
     this->m_dwCommand = LORASERVERMANAGER_AUTOMATON_CMD_NONE;
     this->m_usConnectorNumber = 0;
+    this->m_usPendingMessageId = 0xFF;
+    this->m_usPendingLastMessageId = 0xFF;
+    this->m_bPendingInProgress = false;
+    this->m_usAggregateMessageId = 0xFF;
+    this->m_usAggregateLastMessageId = 0xFF;
+    this->m_usAggregatePacketNumber = 0;
+    this->m_dwAggregateStartTicks = 0;
+    this->m_bReplayInProgress = false;
+    this->m_dwReplayTicks = 0;
+    this->m_dwReplayDelay = 0;
 //  this->m_dwMissedUplinkPacketdNumber = 0;
 
 //  this->m_ForwardedUplinkPacket.m_pLoraPacket = NULL;
@@ -1392,6 +1590,16 @@ void CLoraServerManager_Delete(CLoraServerManager *this)
     CMemoryBlockArray_Delete(this->m_pLoraServerUpMessageArray);
   }
 
+  if (this->m_pUplinkMessageStreamArray != NULL)
+  {
+    CMemoryBlockArray_Delete(this->m_pUplinkMessageStreamArray);
+  }
+
+  if (this->m_pUplinkQueue != NULL)
+  {
+    CMpscRing_Delete(this->m_pUplinkQueue);
+  }
+
   if (this->m_pLoraServerDownMessageArray != NULL)
   {
     CMemoryBlockArray_Delete(this->m_pLoraServerDownMessageArray);
@@ -1407,6 +1615,14 @@ void CLoraServerManager_Delete(CLoraServerManager *this)
     CMemoryBlockArray_Delete(this->m_pDownlinkLoraPacketArray);
   }
 
+  if (this->m_pUplinkLog != NULL)
+  {
+    #ifndef ESP_PLATFORM
+      CUplinkLog_CloseFileBackend(&this->m_pUplinkLog->m_Backend);
+    #endif
+    CUplinkLog_Delete(this->m_pUplinkLog);
+  }
+
   if (this->m_hCommandMutex != NULL)
   {
     vSemaphoreDelete(this->m_hCommandMutex);
@@ -1737,10 +1953,11 @@ bool CLoraServerManager_ProcessInitialize(CLoraServerManager *this, CServerManag
 
   // Step 3: Attach the 'TransceiverManager'
   //
-  // The 'TransceiverManager' will directly notify the 'NodeManagerAutomaton' task of 'LoraServerManager'
-  // when a new Lora Packet is received (Uplink = to forward to Network Server)
+  // The 'TransceiverManager' will push new Lora Packets in the uplink queue and directly notify the
+  // 'NodeManagerAutomaton' task of 'LoraServerManager' (Uplink = to forward to Network Server)
   CTransceiverManagerItf_AttachParamsOb AttachParams;
   AttachParams.m_hPacketForwarderTask = this->m_hNodeManagerTask;
+  AttachParams.m_pUplinkQueue = this->m_pUplinkQueue;
 
   #if (LORASERVERMANAGER_DEBUG_LEVEL0)
     DEBUG_PRINT_LN("[DEBUG] CLoraServerManager_ProcessInitialize, calling ITransceiverManager_Attach");
@@ -1917,6 +2134,9 @@ bool CLoraServerManager_ProcessStop(CLoraServerManager *this, CServerManagerItf_
     return false;
   }
 
+  // Send the aggregated uplink message (if any) before stopping 'ServerConnectors'
+  CLoraServerManager_FlushAggregatedMessage(this);
+
   // Enter the 'STOPPING' state
   // Note: By design, no concurrency on automaton state variable
   this->m_dwCurrentState = LORASERVERMANAGER_AUTOMATON_STATE_STOPPING;
@@ -1987,15 +2207,14 @@ bool CLoraServerManager_ProcessStop(CLoraServerManager *this, CServerManagerItf_
 
 
 // A 'CLoraPacket' just received from 'CLoraNodeManager':
-//  - Build the message stream according to LoRa Network Server protocol
-//  - Send the message to LoRa Network Server
+//  - Queue the 'LoraServerUpMessage' after the ones waiting for a message stream (i.e. LoRa packets
+//    encoded in received order)
+//  - Build the message streams and send them to LoRa Network Server
 // Note: This method is used only for LoRa packet (i.e. not for 'heartbeat')
 void CLoraServerManager_ProcessServerMessageEventUplinkReceived(CLoraServerManager *this, 
                                                                 CLoraServerUpMessage pLoraServerMessage)
 {
-  CTransceiverManagerItf_SessionEventOb SessionEvent;
-  CServerManagerItf_ServerMessageEventOb ServerMessageEvent;
-  CNetworkServerProtocol_BuildUplinkMessageParamsOb ProtocolEncodeParams;
+  CLoraServerUpMessage pLastMessage;
 
   #if (LORASERVERMANAGER_DEBUG_LEVEL0)
     DEBUG_PRINT_LN("[INFO] Entering 'CLoraServerManager_ProcessServerMessageEventUplinkReceived'");
@@ -2012,23 +2231,23 @@ void CLoraServerManager_ProcessServerMessageEventUplinkReceived(CLoraServerManag
 
   #if (LORASERVERMANAGER_DEBUG_LEVEL2)
     DEBUG_PRINT("[DEBUG] CLoraServerManager_ProcessServerMessageEventUplinkReceived, Received message, Addr: ");
-    DEBUG_PRINT_HEX((DWORD) pLoraServerMessage);
+    DEBUG_PRINT_PTR(pLoraServerMessage);
     DEBUG_PRINT(", Id: ");
     DEBUG_PRINT_HEX((DWORD) pLoraServerMessage->m_usMessageId);
     DEBUG_PRINT(", Lora packet: ");
-    DEBUG_PRINT_HEX((DWORD) pLoraServerMessage->m_pLoraPacket);
+    DEBUG_PRINT_PTR(pLoraServerMessage->m_pLoraPacket);
     DEBUG_PRINT(", Packet session: ");
-    DEBUG_PRINT_HEX((DWORD) pLoraServerMessage->m_pSession);
+    DEBUG_PRINT_PTR(pLoraServerMessage->m_pSession);
     DEBUG_PRINT(", Packet Info: ");
-    DEBUG_PRINT_HEX((DWORD) pLoraServerMessage->m_pLoraPacketInfo);
+    DEBUG_PRINT_PTR(pLoraServerMessage->m_pLoraPacketInfo);
     DEBUG_PRINT_CR;
 
     CLoraTransceiverItf_LoraPacket pReceivedPacket;
     pReceivedPacket = (CLoraTransceiverItf_LoraPacket) pLoraServerMessage->m_pLoraPacket;
     DEBUG_PRINT("[DEBUG] CLoraServerManager_ProcessServerMessageEventUplinkReceived. Received packet, addr: ");
-    DEBUG_PRINT_HEX((DWORD) pReceivedPacket);
+    DEBUG_PRINT_PTR(pReceivedPacket);
     DEBUG_PRINT(", Timestamp: ");
-    DEBUG_PRINT_DEC(pReceivedPacket->m_dwTimestamp);
+    DEBUG_PRINT_DEC((DWORD) pReceivedPacket->m_qwTimestamp);
     DEBUG_PRINT(", Data size: ");
     DEBUG_PRINT_DEC(pReceivedPacket->m_dwDataSize);
     DEBUG_PRINT(", Head data: ");
@@ -2043,23 +2262,110 @@ void CLoraServerManager_ProcessServerMessageEventUplinkReceived(CLoraServerManag
   #endif
 
 
+  pLoraServerMessage->m_usNextMessageId = 0xFF;
+  if (this->m_usPendingMessageId == 0xFF)
+  {
+    this->m_usPendingMessageId = pLoraServerMessage->m_usMessageId;
+  }
+  else
+  {
+    pLastMessage = CMemoryBlockArray_BlockPtrFromIndex(this->m_pLoraServerUpMessageArray, this->m_usPendingLastMessageId);
+    pLastMessage->m_usNextMessageId = pLoraServerMessage->m_usMessageId;
+  }
+  this->m_usPendingLastMessageId = pLoraServerMessage->m_usMessageId;
+
+  CLoraServerManager_ProcessPendingMessages(this);
+}
+
+
+// Builds the message streams for the 'LoraServerUpMessages' waiting for a message stream
+// The function stops when all message streams are used (i.e. resumed when a message is terminated)
+// Note: The function is not reentrant. A message may be terminated while the waiting 'LoraServerUpMessages'
+//       are processed (typically flushed aggregated message and network unreachable)
+void CLoraServerManager_ProcessPendingMessages(CLoraServerManager *this)
+{
+  CLoraServerUpMessage pLoraServerMessage;
+
+  if (this->m_bPendingInProgress == true)
+  {
+    return;
+  }
+  this->m_bPendingInProgress = true;
+
+  while (this->m_usPendingMessageId != 0xFF)
+  {
+    pLoraServerMessage = CMemoryBlockArray_BlockPtrFromIndex(this->m_pLoraServerUpMessageArray, this->m_usPendingMessageId);
+    if (CLoraServerManager_BuildServerMessage(this, pLoraServerMessage) != true)
+    {
+      // No message stream available, the 'LoraServerUpMessage' stays first in waiting list
+      #if (LORASERVERMANAGER_DEBUG_LEVEL1)
+        DEBUG_PRINT_LN("[WARNING] CLoraServerManager_ProcessPendingMessages, message streams exhausted");
+      #endif
+      break;
+    }
+  }
+
+  this->m_bPendingInProgress = false;
+}
+
+
+// Builds the message stream for the first 'LoraServerUpMessage' waiting for a message stream and sends it
+// The function returns 'false' if no message stream is available. In this case the 'LoraServerUpMessage'
+// stays first in the waiting list.
+bool CLoraServerManager_BuildServerMessage(CLoraServerManager *this, CLoraServerUpMessage pLoraServerMessage)
+{
+  CTransceiverManagerItf_SessionEventOb SessionEvent;
+  CServerManagerItf_ServerMessageEventOb ServerMessageEvent;
+  CNetworkServerProtocol_BuildUplinkMessageParamsOb ProtocolEncodeParams;
+  CMemoryBlockArrayEntryOb MemBlockEntry;
+
+  // Remove the 'LoraServerUpMessage' from waiting list
+  this->m_usPendingMessageId = pLoraServerMessage->m_usNextMessageId;
+  pLoraServerMessage->m_usNextMessageId = 0xFF;
+
   // Step 1: Build the message stream according to LoRa Network Server protocol
+  //         If an aggregated message is open, the LoRa packet is added to this message
+  if (this->m_usAggregateMessageId != 0xFF)
+  {
+    if (CLoraServerManager_AggregateServerMessage(this, pLoraServerMessage) == true)
+    {
+      return true;
+    }
+
+    // LoRa packet not added (typically MTU reached), send the aggregated message and build a new one
+    CLoraServerManager_FlushAggregatedMessage(this);
+  }
+
+  // The message stream is obtained after flush (i.e. stream of aggregated message released if send failed)
+  if ((pLoraServerMessage->m_pData = CMemoryBlockArray_GetBlock(this->m_pUplinkMessageStreamArray, &MemBlockEntry)) == NULL)
+  {
+    // Put the 'LoraServerUpMessage' back at the head of waiting list
+    if ((pLoraServerMessage->m_usNextMessageId = this->m_usPendingMessageId) == 0xFF)
+    {
+      this->m_usPendingLastMessageId = pLoraServerMessage->m_usMessageId;
+    }
+    this->m_usPendingMessageId = pLoraServerMessage->m_usMessageId;
+    return false;
+  }
+
   ProtocolEncodeParams.m_pLoraPacket = pLoraServerMessage->m_pLoraPacket;
   ProtocolEncodeParams.m_pLoraPacketInfo = pLoraServerMessage->m_pLoraPacketInfo;
   ProtocolEncodeParams.m_wMessageType = NETWORKSERVERPROTOCOL_UPLINKMSG_LORADATA;
-  ProtocolEncodeParams.m_wMaxMessageLength = LORASERVERMANAGER_MAX_UPMESSAGE_LENGTH;
+  ProtocolEncodeParams.m_wServerManagerMessageId = pLoraServerMessage->m_usMessageId;
+  ProtocolEncodeParams.m_wMaxMessageLength = CONFIG_UPLINK_AGGREGATION_WINDOW > 0 ? 
+                                             LORASERVERMANAGER_AGGREGATION_MTU : LORASERVERMANAGER_MAX_UPMESSAGE_LENGTH;
   ProtocolEncodeParams.m_wMessageLength = 0;
-  ProtocolEncodeParams.m_pMessageData = (BYTE *) &pLoraServerMessage->m_usData; 
+  ProtocolEncodeParams.m_pMessageData = pLoraServerMessage->m_pData;
 
   if (INetworkServerProtocol_BuildUplinkMessage(this->m_pNetworkServerProtocolItf, &ProtocolEncodeParams) != true)
   {
     // Should never occur. Unable to send LoRa packet, discard it.
     #if (LORASERVERMANAGER_DEBUG_LEVEL0)
-      DEBUG_PRINT_LN("[ERROR] 'CLoraServerManager_ProcessServerMessageEventUplinkReceived' Failed to encode LoRa packet");
+      DEBUG_PRINT_LN("[ERROR] 'CLoraServerManager_BuildServerMessage' Failed to encode LoRa packet");
     #endif
 
     CLoraServerManager_ProcessServerMessageEventUplinkFailed(this, pLoraServerMessage);
-    return;
+    return true;
   }
 
   // ServerMessage prepared by ProtocolEngine, returned data are stream length and dwProtocolMessageId
@@ -2069,23 +2375,40 @@ void CLoraServerManager_ProcessServerMessageEventUplinkReceived(CLoraServerManag
   pLoraServerMessage->m_dwProtocolMessageId = ProtocolEncodeParams.m_dwProtocolMessageId;
 
   // Step 2: Notify the 'LoraNodeManager' that LoRa packet is currently being sent
-  //         The 'LoraNodeManager' may release the MemoryBlock used to store the 'CLoraPacket'
-  //         (i.e. not required anymore because we are sending the encoded stream to Network Server) 
-  pLoraServerMessage->m_pLoraPacket = NULL;
+  //         The reference on the 'CLoraPacket' is released and the 'LoraNodeManager' may release its
+  //         own reference (i.e. not required anymore because we are sending the encoded stream to Network Server) 
+  CLoraServerManager_ReleaseLoraPacket(this, pLoraServerMessage);
 
   SessionEvent.m_pSession = pLoraServerMessage->m_pSession;
   SessionEvent.m_dwSessionId = pLoraServerMessage->m_dwSessionId;  
   SessionEvent.m_wEventType = TRANSCEIVERMANAGER_SESSIONEVENT_UPLINK_PROGRESSING;
   ITransceiverManager_SessionEvent(this->m_pTransceiverManagerItf, &SessionEvent);
 
-  // Step 3: Notify the 'LoraServerManager' that message can be sent to Network Server
+  // Step 3: If uplink aggregation is enabled, the message is kept open to add next received LoRa packets
+  //         (i.e. sent when aggregation window is elapsed, see 'CLoraServerManager_CheckAggregatedMessage')
+  if (CONFIG_UPLINK_AGGREGATION_WINDOW > 0)
+  {
+    this->m_usAggregateMessageId = this->m_usAggregateLastMessageId = pLoraServerMessage->m_usMessageId;
+    this->m_usAggregatePacketNumber = 1;
+    this->m_dwAggregateStartTicks = xTaskGetTickCount();
+
+    #if (LORASERVERMANAGER_DEBUG_LEVEL2)
+      DEBUG_PRINT("[DEBUG] CLoraServerManager_BuildServerMessage, aggregated message opened, id: ");
+      DEBUG_PRINT_HEX((DWORD) pLoraServerMessage->m_usMessageId);
+      DEBUG_PRINT_CR;
+    #endif
+    return true;
+  }
+
+  // Step 4: Notify the 'LoraServerManager' that message can be sent to Network Server
   //         The send operation is triggered asynchronously to allow processing of events received
   //         during message preparation (i.e. encoding may take a significant duration)
   ServerMessageEvent.m_wEventType = SERVERMANAGER_MESSAGEEVENT_UPLINK_PREPARED;
   ServerMessageEvent.m_pMessage = pLoraServerMessage;
-  ServerMessageEvent.m_dwParam = NULL;
+  ServerMessageEvent.m_dwParam = 0;
 //ServerMessageEvent.m_dwMessageId = (DWORD) pLoraServerMessage->m_usMessageId;
   IServerManager_ServerMessageEvent(this->m_pServerManagerItf, &ServerMessageEvent);
+  return true;
 }
 
 
@@ -2107,11 +2430,12 @@ void CLoraServerManager_ProcessServerMessageEventUplinkPrepared(CLoraServerManag
   if (CLoraServerManager_SendServerMessage(this, pLoraServerMessage, true) != true)
   {
     // No 'ServerConnector' available (typically network unreachable)
-    // No recovery mechanism in this early version
+    // The message is stored for later replay (if store-and-forward log enabled)
     #if (LORASERVERMANAGER_DEBUG_LEVEL0)
       DEBUG_PRINT_LN("[WARNING] CLoraServerManager_ProcessServerMessageEventUplinkPrepared, network unreachable");
     #endif
 
+    CLoraServerManager_StoreServerMessage(this, pLoraServerMessage);
     CLoraServerManager_ProcessServerMessageEventUplinkFailed(this, pLoraServerMessage);
   }
   else
@@ -2168,7 +2492,7 @@ void CLoraServerManager_ProcessServerMessageEventUplinkSent(CLoraServerManager *
         DEBUG_PRINT_LN("[WARNING] 'CLoraServerManager_ProcessServerMessageEventUplinkSent' - ProtocolEngine reports error");
       #endif
       
-      // NOTE: Fallthrough
+      // Fallthrough
 
     case NETWORKSERVERPROTOCOL_UPLINKSESSIONEVENT_TERMINATED:
       // The message is sent and transaction in ProtocolEngine is successfully terminated
@@ -2198,11 +2522,12 @@ void CLoraServerManager_ProcessServerMessageEventUplinkSendFailed(CLoraServerMan
   if (CLoraServerManager_SendServerMessage(this, pLoraServerMessage, false) != true)
   {
     // No more 'ServerConnector' available
-    // No recovery mechanism in this early version
+    // The message is stored for later replay (if store-and-forward log enabled)
     #if (LORASERVERMANAGER_DEBUG_LEVEL0)
       DEBUG_PRINT_LN("[WARNING] CLoraServerManager_ProcessServerMessageEventUplinkSendFailed, no more connector");
     #endif
 
+    CLoraServerManager_StoreServerMessage(this, pLoraServerMessage);
     CLoraServerManager_ProcessServerMessageEventUplinkFailed(this, pLoraServerMessage);
   }
   else
@@ -2222,13 +2547,17 @@ void CLoraServerManager_ProcessServerMessageEventUplinkSendFailed(CLoraServerMan
 //  - NETWORKSERVERPROTOCOL_UPLINKSESSIONEVENT_TERMINATED = Message successfully sent to Network Server
 //  - NETWORKSERVERPROTOCOL_UPLINKSESSIONEVENT_FAILED = Message not sent to or not acknowledged by the Network Server
 // The function behaves has follows:
-//  - If the uplink message is for a LoRa packet, the 'LoraNodeManager' is notified 
-//  - The 'LoraServerMessage' is removed from MemoryBlockArray
+//  - If the uplink message is for LoRa packets, the 'LoraNodeManager' is notified for each packet (i.e. all
+//    'LoraServerUpMessages' aggregated in the message)
+//  - The 'LoraServerMessages' are removed from MemoryBlockArray
+//  - If the uplink message is a replayed stored message, it is removed from the store-and-forward log when
+//    successfully sent (i.e. kept for next replay attempt if failed)
 void CLoraServerManager_ProcessServerMessageEventUplinkTerminated(CLoraServerManager *this, 
                                                                   CLoraServerUpMessage pLoraServerMessage, DWORD dwProtocolState)
 {
-  CTransceiverManagerItf_SessionEventOb SessionEvent;
   CNetworkServerProtocol_ProcessSessionEventParamsOb ProcessSessionEventParams;
+  CLoraServerUpMessage pAggregatedMessage;
+  BYTE usMessageId;
 
   #if (LORASERVERMANAGER_DEBUG_LEVEL0)
     DEBUG_PRINT_LN("[INFO] Entering 'CLoraServerManager_ProcessServerMessageEventUplinkTerminated'");
@@ -2240,36 +2569,91 @@ void CLoraServerManager_ProcessServerMessageEventUplinkTerminated(CLoraServerMan
     DEBUG_PRINT_CR;
   #endif
 
-  // If not a 'heartbeat', notify the 'LoraNodeManager' for the result of uplink LoRa packet send operation
+  // The protocol session is common to all aggregated LoRa packets (i.e. identifier of first 'LoraServerUpMessage')
+  ProcessSessionEventParams.m_wSessionEvent = NETWORKSERVERPROTOCOL_SESSIONEVENT_RELEASED;
+  ProcessSessionEventParams.m_dwProtocolMessageId = pLoraServerMessage->m_dwProtocolMessageId;
+
+  // If not a 'heartbeat', terminate the session for each LoRa packet sent in the message
+  // Note: If LoRa packets are aggregated, the other 'LoraServerUpMessages' are chained to this one
+  if (LORASERVERMANAGER_SERVERMANAGER_IS_REPLAY(pLoraServerMessage->m_usMessageId))
+  {
+    // The LoRa packet sessions of a replayed message are already terminated (i.e. failed when message stored)
+    if (dwProtocolState == NETWORKSERVERPROTOCOL_UPLINKSESSIONEVENT_TERMINATED)
+    {
+      CUplinkLog_Consume(this->m_pUplinkLog);
+      this->m_dwReplayDelay = pdMS_TO_TICKS(CONFIG_UPLINK_LOG_REPLAY_PERIOD);
+    }
+    else
+    {
+      this->m_dwReplayDelay = pdMS_TO_TICKS(CONFIG_UPLINK_LOG_RETRY_PERIOD);
+    }
+    this->m_dwReplayTicks = xTaskGetTickCount();
+    this->m_bReplayInProgress = false;
+  }
+  else if (!LORASERVERMANAGER_SERVERMANAGER_IS_HEARTBEAT(pLoraServerMessage->m_usMessageId))
+  {
+    usMessageId = pLoraServerMessage->m_usNextMessageId;
+    while (usMessageId != 0xFF)
+    {
+      pAggregatedMessage = CMemoryBlockArray_BlockPtrFromIndex(this->m_pLoraServerUpMessageArray, usMessageId);
+      usMessageId = pAggregatedMessage->m_usNextMessageId;
+      CLoraServerManager_TerminateLoraPacketSession(this, pAggregatedMessage, dwProtocolState);
+    }
+
+    CLoraServerManager_TerminateLoraPacketSession(this, pLoraServerMessage, dwProtocolState);
+  }
+
+  // Confirm to the 'ProtocolEngine' that 'LoraServerManager' has finished with the protocol session
+  INetworkServerProtocol_ProcessSessionEvent(this->m_pNetworkServerProtocolItf, &ProcessSessionEventParams);
+
+  // A message stream may be released, encode the LoRa packets waiting for it (if any)
+  CLoraServerManager_ProcessPendingMessages(this);
+}
+
+
+// Terminates the uplink session for the LoRa packet of a 'LoraServerUpMessage' (i.e. not for 'heartbeat')
+//  - The 'LoraNodeManager' is notified for the result of uplink LoRa packet send operation
+//  - The 'LoraServerMessage' is removed from MemoryBlockArray
+void CLoraServerManager_TerminateLoraPacketSession(CLoraServerManager *this, CLoraServerUpMessage pLoraServerMessage, 
+                                                   DWORD dwProtocolState)
+{
+  CTransceiverManagerItf_SessionEventOb SessionEvent;
+
+  // Notify the 'LoraNodeManager' for the result of uplink LoRa packet send operation
   // The 'LoraNodeManager' may release the MemoryBlock used to store the 'CLoraPacketSession'
   // (do not access it from now)
-  if (!LORASERVERMANAGER_SERVERMANAGER_IS_HEARTBEAT(pLoraServerMessage->m_usMessageId))
-  {
-    #if (LORASERVERMANAGER_DEBUG_LEVEL2)
-      DEBUG_PRINT_LN("[DEBUG] CLoraServerManager_ProcessServerMessageEventUplinkTerminated, processing session for LoRa packet send");
-    #endif
+  #if (LORASERVERMANAGER_DEBUG_LEVEL2)
+    DEBUG_PRINT_LN("[DEBUG] CLoraServerManager_TerminateLoraPacketSession, processing session for LoRa packet send");
+  #endif
 
-    SessionEvent.m_pSession = pLoraServerMessage->m_pSession;
-    SessionEvent.m_dwSessionId = pLoraServerMessage->m_dwSessionId;  
-    SessionEvent.m_wEventType = dwProtocolState == NETWORKSERVERPROTOCOL_UPLINKSESSIONEVENT_TERMINATED ?
-                                 TRANSCEIVERMANAGER_SESSIONEVENT_UPLINK_SENT : TRANSCEIVERMANAGER_SESSIONEVENT_UPLINK_FAILED;
-    ITransceiverManager_SessionEvent(this->m_pTransceiverManagerItf, &SessionEvent);
+  SessionEvent.m_pSession = pLoraServerMessage->m_pSession;
+  SessionEvent.m_dwSessionId = pLoraServerMessage->m_dwSessionId;  
+  SessionEvent.m_wEventType = dwProtocolState == NETWORKSERVERPROTOCOL_UPLINKSESSIONEVENT_TERMINATED ?
+                               TRANSCEIVERMANAGER_SESSIONEVENT_UPLINK_SENT : TRANSCEIVERMANAGER_SESSIONEVENT_UPLINK_FAILED;
+  ITransceiverManager_SessionEvent(this->m_pTransceiverManagerItf, &SessionEvent);
 
-    // If not a 'heartbeat', release 'CLoraServerUpMessage' memory block
-    #if (LORASERVERMANAGER_DEBUG_LEVEL2)
-      DEBUG_PRINT("[DEBUG] CLoraServerManager_ProcessServerMessageEventUplinkTerminated, destroying LoraServerUpMessage, id: ");
-      DEBUG_PRINT_HEX(pLoraServerMessage->m_usMessageId);
-      DEBUG_PRINT_CR;
-    #endif
+  // Release 'CLoraServerUpMessage' memory block
+  #if (LORASERVERMANAGER_DEBUG_LEVEL2)
+    DEBUG_PRINT("[DEBUG] CLoraServerManager_TerminateLoraPacketSession, destroying LoraServerUpMessage, id: ");
+    DEBUG_PRINT_HEX(pLoraServerMessage->m_usMessageId);
+    DEBUG_PRINT_CR;
+  #endif
+
+  // Release the 'CLoraPacket' if not yet encoded (i.e. failure before encoding)
+  CLoraServerManager_ReleaseLoraPacket(this, pLoraServerMessage);
 
-    CMemoryBlockArray_ReleaseBlock(this->m_pLoraServerUpMessageArray, pLoraServerMessage->m_usMessageId);
+  // Release the message stream (i.e. first 'LoraServerUpMessage' of message)
+  if (pLoraServerMessage->m_pData != NULL)
+  {
+    CMemoryBlockArray_ReleaseBlock(this->m_pUplinkMessageStreamArray,
+      CMemoryBlockArray_BlockIndexFromPtr(this->m_pUplinkMessageStreamArray, pLoraServerMessage->m_pData));
+    pLoraServerMessage->m_pData = NULL;
   }
 
-  // Confirm to the 'ProtocolEngine' that 'LoraServerManager' has finished with the protocol session
-  ProcessSessionEventParams.m_wSessionEvent = NETWORKSERVERPROTOCOL_SESSIONEVENT_RELEASED;
-  ProcessSessionEventParams.m_dwProtocolMessageId = pLoraServerMessage->m_dwProtocolMessageId;
+  CMemoryBlockArray_ReleaseBlock(this->m_pLoraServerUpMessageArray, pLoraServerMessage->m_usMessageId);
 
-  INetworkServerProtocol_ProcessSessionEvent(this->m_pNetworkServerProtocolItf, &ProcessSessionEventParams);
+  // Uplink packets may be waiting in queue for a free 'CLoraServerUpMessage' (i.e. wake up 'NodeManager' task)
+  xTaskNotify(this->m_hNodeManagerTask, 0, eNoAction);
 }
 
 
@@ -2313,6 +2697,313 @@ void CLoraServerManager_ProcessServerMessageEventUplinkFailed(CLoraServerManager
                                                                NETWORKSERVERPROTOCOL_UPLINKSESSIONEVENT_FAILED);
 }
 
+
+// Releases the reference of 'LoraServerUpMessage' on its 'CLoraPacket' (shared packet buffer)
+// Note: Nothing done if the reference is already released (i.e. 'm_pLoraPacket' is NULL)
+void CLoraServerManager_ReleaseLoraPacket(CLoraServerManager *this, CLoraServerUpMessage pLoraServerMessage)
+{
+  if (pLoraServerMessage->m_pLoraPacket != NULL)
+  {
+    CWideMemoryBlockArray_ReleaseRef(pLoraServerMessage->m_pLoraPacketPool,
+      CWideMemoryBlockArray_BlockIndexFromPtr(pLoraServerMessage->m_pLoraPacketPool, pLoraServerMessage->m_pLoraPacket));
+    pLoraServerMessage->m_pLoraPacket = NULL;
+  }
+}
+
+
+/*********************************************************************************************
+  Private methods (implementation)
+
+  Aggregation of uplink LoRa packets (i.e. several LoRa packets sent in one Network Server
+  message)
+
+  When 'CONFIG_UPLINK_AGGREGATION_WINDOW' is not zero, the message built for a LoRa packet is
+  kept open and next received LoRa packets are added to it by the 'ProtocolEngine'. The message
+  is sent when the aggregation window is elapsed or when the next LoRa packet does not fit in
+  'LORASERVERMANAGER_AGGREGATION_MTU'. The aggregated LoRa packets are chained 'LoraServerUpMessages'
+  without message stream (i.e. the MTU is the only limit on the number of LoRa packets).
+
+  Note: These functions are called only by 'ServerManager' automaton (i.e. no concurrency on
+        aggregation variables).
+*********************************************************************************************/
+
+
+// Adds the LoRa packet of specified 'LoraServerUpMessage' to the open aggregated message
+// The function returns 'false' if the LoRa packet cannot be added (typically MTU reached). In this case the 
+// 'LoraServerUpMessage' is not modified.
+bool CLoraServerManager_AggregateServerMessage(CLoraServerManager *this, CLoraServerUpMessage pLoraServerMessage)
+{
+  CTransceiverManagerItf_SessionEventOb SessionEvent;
+  CNetworkServerProtocol_BuildUplinkMessageParamsOb ProtocolEncodeParams;
+  CLoraServerUpMessage pAggregateMessage;
+  CLoraServerUpMessage pLastMessage;
+
+  pAggregateMessage = CMemoryBlockArray_BlockPtrFromIndex(this->m_pLoraServerUpMessageArray, this->m_usAggregateMessageId);
+
+  // Ask the 'ProtocolEngine' to add the LoRa packet to the message stream of first 'LoraServerUpMessage'
+  ProtocolEncodeParams.m_pLoraPacket = pLoraServerMessage->m_pLoraPacket;
+  ProtocolEncodeParams.m_pLoraPacketInfo = pLoraServerMessage->m_pLoraPacketInfo;
+  ProtocolEncodeParams.m_wMessageType = NETWORKSERVERPROTOCOL_UPLINKMSG_LORADATA_APPEND;
+  ProtocolEncodeParams.m_wServerManagerMessageId = pAggregateMessage->m_usMessageId;
+  ProtocolEncodeParams.m_wMaxMessageLength = LORASERVERMANAGER_AGGREGATION_MTU;
+  ProtocolEncodeParams.m_wMessageLength = pAggregateMessage->m_wDataLength;
+  ProtocolEncodeParams.m_pMessageData = pAggregateMessage->m_pData;
+  ProtocolEncodeParams.m_dwProtocolMessageId = pAggregateMessage->m_dwProtocolMessageId;
+
+  if (INetworkServerProtocol_BuildUplinkMessage(this->m_pNetworkServerProtocolItf, &ProtocolEncodeParams) != true)
+  {
+    #if (LORASERVERMANAGER_DEBUG_LEVEL1)
+      DEBUG_PRINT_LN("[INFO] CLoraServerManager_AggregateServerMessage, LoRa packet not added to aggregated message");
+    #endif
+    return false;
+  }
+  pAggregateMessage->m_wDataLength = ProtocolEncodeParams.m_wMessageLength;
+
+  // The 'LoraServerUpMessage' is chained to the aggregated message (i.e. same protocol session)
+  pLoraServerMessage->m_dwMessageState = LORANODEMANAGER_SERVERUPMESSAGE_STATE_PREPARED;
+  pLoraServerMessage->m_wDataLength = 0;
+  pLoraServerMessage->m_dwProtocolMessageId = pAggregateMessage->m_dwProtocolMessageId;
+
+  pLastMessage = CMemoryBlockArray_BlockPtrFromIndex(this->m_pLoraServerUpMessageArray, this->m_usAggregateLastMessageId);
+  pLastMessage->m_usNextMessageId = pLoraServerMessage->m_usMessageId;
+  this->m_usAggregateLastMessageId = pLoraServerMessage->m_usMessageId;
+  ++this->m_usAggregatePacketNumber;
+
+  #if (LORASERVERMANAGER_DEBUG_LEVEL2)
+    DEBUG_PRINT("[DEBUG] CLoraServerManager_AggregateServerMessage, LoRa packet added, id: ");
+    DEBUG_PRINT_HEX((DWORD) pLoraServerMessage->m_usMessageId);
+    DEBUG_PRINT(", packets: ");
+    DEBUG_PRINT_DEC((DWORD) this->m_usAggregatePacketNumber);
+    DEBUG_PRINT(", length: ");
+    DEBUG_PRINT_DEC((DWORD) pAggregateMessage->m_wDataLength);
+    DEBUG_PRINT_CR;
+  #endif
+
+  // Notify the 'LoraNodeManager' that LoRa packet is currently being sent
+  CLoraServerManager_ReleaseLoraPacket(this, pLoraServerMessage);
+
+  SessionEvent.m_pSession = pLoraServerMessage->m_pSession;
+  SessionEvent.m_dwSessionId = pLoraServerMessage->m_dwSessionId;  
+  SessionEvent.m_wEventType = TRANSCEIVERMANAGER_SESSIONEVENT_UPLINK_PROGRESSING;
+  ITransceiverManager_SessionEvent(this->m_pTransceiverManagerItf, &SessionEvent);
+  return true;
+}
+
+
+// Sends the open aggregated message (if any) to Network Server
+void CLoraServerManager_FlushAggregatedMessage(CLoraServerManager *this)
+{
+  CLoraServerUpMessage pAggregateMessage;
+
+  if (this->m_usAggregateMessageId == 0xFF)
+  {
+    return;
+  }
+
+  #if (LORASERVERMANAGER_DEBUG_LEVEL1)
+    DEBUG_PRINT("[INFO] CLoraServerManager_FlushAggregatedMessage, sending aggregated message, packets: ");
+    DEBUG_PRINT_DEC((DWORD) this->m_usAggregatePacketNumber);
+    DEBUG_PRINT_CR;
+  #endif
+
+  pAggregateMessage = CMemoryBlockArray_BlockPtrFromIndex(this->m_pLoraServerUpMessageArray, this->m_usAggregateMessageId);
+  this->m_usAggregateMessageId = 0xFF;
+
+  // Note: Called from 'ServerManager' automaton (i.e. 'UPLINK_PREPARED' event processed synchronously)
+  CLoraServerManager_ProcessServerMessageEventUplinkPrepared(this, pAggregateMessage);
+}
+
+
+// Sends the open aggregated message (if any) when the aggregation window is elapsed
+// The function returns the maximum duration (ticks) to wait for next 'ServerManager' automaton message
+// Note: No aggregated message is opened when 'CONFIG_UPLINK_AGGREGATION_WINDOW' is zero
+TickType_t CLoraServerManager_CheckAggregatedMessage(CLoraServerManager *this)
+{
+  #if (CONFIG_UPLINK_AGGREGATION_WINDOW > 0)
+    TickType_t dwElapsedTicks;
+
+    if (this->m_usAggregateMessageId != 0xFF)
+    {
+      dwElapsedTicks = xTaskGetTickCount() - this->m_dwAggregateStartTicks;
+      if (dwElapsedTicks < pdMS_TO_TICKS(CONFIG_UPLINK_AGGREGATION_WINDOW))
+      {
+        return pdMS_TO_TICKS(CONFIG_UPLINK_AGGREGATION_WINDOW) - dwElapsedTicks;
+      }
+
+      CLoraServerManager_FlushAggregatedMessage(this);
+    }
+  #endif
+  return pdMS_TO_TICKS(500);
+}
+
+// Terminates the uplink sessions expired in 'ProtocolEngine' (i.e. ACK not received from Network Server)
+// Each expired session is processed as a failed uplink message (i.e. same processing as send failure)
+void CLoraServerManager_CheckExpiredSessions(CLoraServerManager *this)
+{
+  CNetworkServerProtocol_GetExpiredSessionParamsOb ExpiredSessionParams;
+  CNetworkServerProtocol_ProcessSessionEventParamsOb ProcessSessionEventParams;
+  CLoraServerUpMessage pLoraServerMessage;
+  BYTE usBlockIndex;
+
+  while (INetworkServerProtocol_GetExpiredSession(this->m_pNetworkServerProtocolItf, &ExpiredSessionParams) == true)
+  {
+    #if (LORASERVERMANAGER_DEBUG_LEVEL1)
+      DEBUG_PRINT("[INFO] CLoraServerManager_CheckExpiredSessions, uplink session expired, id: ");
+      DEBUG_PRINT_HEX(ExpiredSessionParams.m_dwProtocolMessageId);
+      DEBUG_PRINT_CR;
+    #endif
+
+    // Retrieve the associated 'CLoraServerUpMessageOb' in 'm_pLoraServerUpMessageArray'
+    // Note: Specific 'CLoraServerUpMessageOb' for heartbeat and replayed message (outside of array)
+    usBlockIndex = (BYTE) LORASERVERMANAGER_SERVERMANAGER_MESSAGEID(ExpiredSessionParams.m_dwProtocolMessageId);
+    pLoraServerMessage = CLoraServerManager_GetUpMessage(this, usBlockIndex);
+
+    if (pLoraServerMessage->m_dwProtocolMessageId == ExpiredSessionParams.m_dwProtocolMessageId)
+    {
+      CLoraServerManager_ProcessServerMessageEventUplinkTerminated(this, pLoraServerMessage, 
+                                                                   NETWORKSERVERPROTOCOL_UPLINKSESSIONEVENT_FAILED);
+    }
+    else
+    {
+      // Should never occur (memory leak in array)
+      // Release the session in 'ProtocolEngine' anyway
+      #if (LORASERVERMANAGER_DEBUG_LEVEL0)
+        DEBUG_PRINT_LN("[ERROR] CLoraServerManager_CheckExpiredSessions, unable to retrieve LoraServerUpMessage (LEAK)");
+      #endif
+
+      ProcessSessionEventParams.m_wSessionEvent = NETWORKSERVERPROTOCOL_SESSIONEVENT_RELEASED;
+      ProcessSessionEventParams.m_dwProtocolMessageId = ExpiredSessionParams.m_dwProtocolMessageId;
+      INetworkServerProtocol_ProcessSessionEvent(this->m_pNetworkServerProtocolItf, &ProcessSessionEventParams);
+    }
+  }
+}
+
+// Returns the 'LoraServerUpMessage' for specified identifier (i.e. 'CLoraServerManager' part of 'm_dwProtocolMessageId')
+// Note: The 'heartbeat' and replayed messages are not stored in 'm_pLoraServerUpMessageArray'
+CLoraServerUpMessage CLoraServerManager_GetUpMessage(CLoraServerManager *this, BYTE usMessageId)
+{
+  if (LORASERVERMANAGER_SERVERMANAGER_IS_HEARTBEAT(usMessageId))
+  {
+    return &this->m_HeartbeatMessageOb;
+  }
+  else if (LORASERVERMANAGER_SERVERMANAGER_IS_REPLAY(usMessageId))
+  {
+    return &this->m_ReplayMessageOb;
+  }
+  return CMemoryBlockArray_BlockPtrFromIndex(this->m_pLoraServerUpMessageArray, usMessageId);
+}
+
+
+/*********************************************************************************************
+  Private methods (implementation)
+
+  Store-and-forward of uplink messages
+
+  The uplink messages that cannot be sent because no 'ServerConnector' is available are stored
+  in the 'UplinkLog' (i.e. encoded message stream). When a 'ServerConnector' accepts to send
+  messages again, the stored messages are replayed in FIFO order:
+   - One replayed message at a time (i.e. 'm_ReplayMessageOb')
+   - At least 'CONFIG_UPLINK_LOG_REPLAY_PERIOD' between two replayed messages (i.e. bounded
+     rate, the live traffic keeps priority)
+   - A replayed message is removed from the log only when successfully sent. After a failure,
+     the next attempt is delayed by 'CONFIG_UPLINK_LOG_RETRY_PERIOD'
+
+  Note: These functions are called only by 'ServerManager' automaton (i.e. no concurrency on
+        'UplinkLog' object).
+*********************************************************************************************/
+
+// Stores the 'LoraServerUpMessage' in the store-and-forward log (if enabled)
+// Note: The 'heartbeat' messages are not stored (i.e. gateway status obsolete when replayed) and the replayed
+//       message is already in the log
+void CLoraServerManager_StoreServerMessage(CLoraServerManager *this, CLoraServerUpMessage pLoraServerMessage)
+{
+  if ((this->m_pUplinkLog == NULL) || LORASERVERMANAGER_SERVERMANAGER_IS_HEARTBEAT(pLoraServerMessage->m_usMessageId) ||
+      LORASERVERMANAGER_SERVERMANAGER_IS_REPLAY(pLoraServerMessage->m_usMessageId))
+  {
+    return;
+  }
+
+  if (CUplinkLog_Append(this->m_pUplinkLog, pLoraServerMessage->m_pData, pLoraServerMessage->m_wDataLength) == true)
+  {
+    #if (LORASERVERMANAGER_DEBUG_LEVEL0)
+      DEBUG_PRINT("[INFO] CLoraServerManager_StoreServerMessage, message stored, pending: ");
+      DEBUG_PRINT_DEC(CUplinkLog_GetRecordNumber(this->m_pUplinkLog));
+      DEBUG_PRINT_CR;
+    #endif
+  }
+  else
+  {
+    #if (LORASERVERMANAGER_DEBUG_LEVEL0)
+      DEBUG_PRINT_LN("[ERROR] CLoraServerManager_StoreServerMessage, failed to store message");
+    #endif
+  }
+}
+
+// Replays the oldest stored message if the replay period is elapsed
+// The function returns the maximum delay (ticks) before the next call (i.e. wait in automaton loop)
+TickType_t CLoraServerManager_ReplayStoredMessage(CLoraServerManager *this)
+{
+  CNetworkServerProtocol_BuildUplinkMessageParamsOb ProtocolEncodeParams;
+  TickType_t dwElapsedTicks;
+  WORD wLength;
+
+  if (this->m_bReplayInProgress == true)
+  {
+    return pdMS_TO_TICKS(500);
+  }
+
+  dwElapsedTicks = xTaskGetTickCount() - this->m_dwReplayTicks;
+  if (dwElapsedTicks < this->m_dwReplayDelay)
+  {
+    return this->m_dwReplayDelay - dwElapsedTicks;
+  }
+
+  if ((wLength = CUplinkLog_Peek(this->m_pUplinkLog, this->m_ReplayMessageOb.m_pData, LORASERVERMANAGER_MAX_UPMESSAGE_LENGTH)) == 0)
+  {
+    // Nothing to replay
+    return pdMS_TO_TICKS(500);
+  }
+
+  // The 'ProtocolEngine' creates a new transaction for the stored message stream (i.e. stream updated in place)
+  ProtocolEncodeParams.m_wMessageType = NETWORKSERVERPROTOCOL_UPLINKMSG_REPLAY;
+  ProtocolEncodeParams.m_wServerManagerMessageId = this->m_ReplayMessageOb.m_usMessageId;
+  ProtocolEncodeParams.m_bForceHeartbeat = false;
+  ProtocolEncodeParams.m_pLoraPacket = NULL;
+  ProtocolEncodeParams.m_pLoraPacketInfo = NULL;
+  ProtocolEncodeParams.m_wMaxMessageLength = LORASERVERMANAGER_MAX_UPMESSAGE_LENGTH;
+  ProtocolEncodeParams.m_wMessageLength = wLength;
+  ProtocolEncodeParams.m_pMessageData = this->m_ReplayMessageOb.m_pData;
+
+  this->m_dwReplayTicks = xTaskGetTickCount();
+
+  if (INetworkServerProtocol_BuildUplinkMessage(this->m_pNetworkServerProtocolItf, &ProtocolEncodeParams) != true)
+  {
+    // Stored message rejected by 'ProtocolEngine'
+    // Note: The stored message streams are built by the 'ProtocolEngine' and checked by 'UplinkLog' (CRC). The
+    //       message is rejected only if no protocol transaction is available (i.e. retried later)
+    #if (LORASERVERMANAGER_DEBUG_LEVEL0)
+      DEBUG_PRINT_LN("[ERROR] CLoraServerManager_ReplayStoredMessage, stored message rejected by ProtocolEngine");
+    #endif
+
+    this->m_dwReplayDelay = pdMS_TO_TICKS(CONFIG_UPLINK_LOG_RETRY_PERIOD);
+    return this->m_dwReplayDelay;
+  }
+
+  #if (LORASERVERMANAGER_DEBUG_LEVEL0)
+    DEBUG_PRINT("[INFO] CLoraServerManager_ReplayStoredMessage, replaying stored message, pending: ");
+    DEBUG_PRINT_DEC(CUplinkLog_GetRecordNumber(this->m_pUplinkLog));
+    DEBUG_PRINT_CR;
+  #endif
+
+  this->m_ReplayMessageOb.m_dwProtocolMessageId = ProtocolEncodeParams.m_dwProtocolMessageId;
+  this->m_ReplayMessageOb.m_wDataLength = ProtocolEncodeParams.m_wMessageLength;
+
+  // Note: The send operation may fail immediately (i.e. replay state updated when message terminated)
+  this->m_bReplayInProgress = true;
+  CLoraServerManager_ProcessServerMessageEventUplinkPrepared(this, &this->m_ReplayMessageOb);
+
+  return this->m_bReplayInProgress == true ? pdMS_TO_TICKS(500) : this->m_dwReplayDelay;
+}
                    
 /*********************************************************************************************
   Private methods (implementation)
@@ -2373,7 +3064,7 @@ bool CLoraServerManager_SendServerMessage(CLoraServerManager *this, CLoraServerU
     pConnectorDescr = this->m_ConnectorDescrArray + usConnectorId;
 
     SendParams.m_wDataLength = pLoraServerMessage->m_wDataLength;
-    SendParams.m_pData = (BYTE *) &pLoraServerMessage->m_usData;
+    SendParams.m_pData = pLoraServerMessage->m_pData;
     SendParams.m_pMessage = pLoraServerMessage;
     SendParams.m_dwMessageId = (DWORD) pLoraServerMessage->m_usMessageId;
 
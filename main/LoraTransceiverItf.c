@@ -201,6 +201,16 @@ bool ILoraTransceiver_Send(ILoraTransceiver this, CLoraTransceiverItf_SendParams
   return this->m_pOwnerItfImpl->m_pSend(this->m_pOwnerObject, pParams);
 }
 
+bool ILoraTransceiver_ArmSend(ILoraTransceiver this, CLoraTransceiverItf_ArmSendParams pParams)
+{
+  return this->m_pOwnerItfImpl->m_pArmSend(this->m_pOwnerObject, pParams);
+}
+
+bool ILoraTransceiver_FireSend(ILoraTransceiver this, CLoraTransceiverItf_FireSendParams pParams)
+{
+  return this->m_pOwnerItfImpl->m_pFireSend(this->m_pOwnerObject, pParams);
+}
+
 bool ILoraTransceiver_GetReceivedPacketInfo(ILoraTransceiver this, CLoraTransceiverItf_GetReceivedPacketInfoParams pParams)
 {
   return this->m_pOwnerItfImpl->m_pGetReceivedPacketInfo(this->m_pOwnerObject, pParams);
@@ -239,5 +239,55 @@ DWORD INetworkServerProtocol_ProcessSessionEvent(INetworkServerProtocol this, CN
   return this->m_pOwnerItfImpl->m_pProcessSessionEvent(this->m_pOwnerObject, pParams);
 }
 
+/*****************************************************************************************//**
+ * @fn         bool INetworkServerProtocol_GetExpiredSession(INetworkServerProtocol this, 
+                                   CNetworkServerProtocolItf_GetExpiredSessionParams pParams)
+ * 
+ * @brief      Retrieves an uplink session expired in 'NetworkServerProtocol' (i.e. the reply 
+ *             from Network Server has not been received in time).
+ * 
+ * @details    This function invokes the implementation of 'GetExpiredSession' method on owner
+ *             object.\n
+ *             The owner object typically calls this method periodically until it returns 
+ *             'false'.
+ * 
+ * @param      this
+ *             The object pointer.
+ *  
+ * @param      pParams
+ *             The method parameters. See 'NetworkServerProtocolItf.h' for details.
+ *
+ * @return     The function returns 'true' if an expired session is returned in 'pParams'.
+ *             The caller must terminate this session (failed) and release it using 
+ *             'INetworkServerProtocol_ProcessSessionEvent'.
+*********************************************************************************************/
+bool INetworkServerProtocol_GetExpiredSession(INetworkServerProtocol this, CNetworkServerProtocolItf_GetExpiredSessionParams pParams)
+{
+  return this->m_pOwnerItfImpl->m_pGetExpiredSession(this->m_pOwnerObject, pParams);
+}
 
-
+/*****************************************************************************************//**
+ * @fn         bool INetworkServerProtocol_BuildDownlinkAck(INetworkServerProtocol this, 
+                                   CNetworkServerProtocolItf_BuildDownlinkAckParams pParams)
+ * 
+ * @brief      Builds the message to send to Network Server as acknowledge of a downlink 
+ *             message (i.e. 'TX_ACK' for Semtech protocol).
+ * 
+ * @details    This function invokes the implementation of 'BuildDownlinkAck' method on owner
+ *             object.\n
+ *             The owner object calls this method once the LoRa packet returned by 
+ *             'ProcessServerMessage' has been scheduled (or rejected) by the gateway.
+ * 
+ * @param      this
+ *             The object pointer.
+ *  
+ * @param      pParams
+ *             The method parameters. See 'NetworkServerProtocolItf.h' for details.
+ *
+ * @return     The function returns 'true' if the message is built in 'pParams' buffer or
+ *             'false' if the buffer is too small or if no acknowledge is defined by protocol.
+*********************************************************************************************/
+bool INetworkServerProtocol_BuildDownlinkAck(INetworkServerProtocol this, CNetworkServerProtocolItf_BuildDownlinkAckParams pParams)
+{
+  return this->m_pOwnerItfImpl->m_pBuildDownlinkAck(this->m_pOwnerObject, pParams);
+}
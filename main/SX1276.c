@@ -33,6 +33,8 @@
 #define LORATRANSCEIVERITF_IMPL
 
 #include "LoraTransceiverItf.h"
+#include "TaskPlacement.h"
+#include "TraceRing.h"
 
 // Object's definitions and methods
 #include "SX1276.h"
@@ -53,9 +55,26 @@ CLoraTransceiverItfImplOb g_LoraTransceiverItfImplOb = { .m_pAddRef = CSX1276_Ad
                                                          .m_pStandBy = CSX1276_StandBy,
                                                          .m_pReceive = CSX1276_Receive,
                                                          .m_pSend = CSX1276_Send,
+                                                         .m_pArmSend = CSX1276_ArmSend,
+                                                         .m_pFireSend = CSX1276_FireSend,
                                                          .m_pGetReceivedPacketInfo = CSX1276_GetReceivedPacketInfo
                                                        };
 
+// SPI device access with ESP-IDF 'spi_master' driver (default 'CSX1276SpiBackendOb')
+const CSX1276SpiBackendOb g_SX1276EspSpiBackendOb = { .m_pTransmit = spi_device_transmit,
+                                                      .m_pQueueTrans = spi_device_queue_trans,
+                                                      .m_pGetTransResult = spi_device_get_trans_result
+                                                    };
+
+// Arbiter of the SPI bus shared by all SX1276 (see 'CSX1276SpiBusOb')
+CSX1276SpiBusOb g_SX1276SpiBusOb = { .m_hMutex = NULL, .m_dwRxPendingNumber = 0, .m_usDeviceNumber = 0 };
+
+// Pins of SX1276 devices on shared SPI bus (indexed by SPI slave ID)
+const CSX1276DevicePinsOb g_SX1276DevicePins[SX1276_MAX_DEVICES] = SX1276_DEVICE_PINS;
+
+// Number of CSX1276 objects (i.e. GPIO ISR service installed for first object)
+static BYTE g_usSX1276InstanceNumber = 0;
+
 const double SignalBwLog[] =
 {
   5.0969100130080564143587833158265,
@@ -372,6 +391,88 @@ bool CSX1276_Send(void *this, void *pParams)
   return CSX1276_NotifyAndProcessCommand((CSX1276 *) this, SX1276_AUTOMATON_CMD_SEND, pParams);
 }
 
+/*****************************************************************************************//**
+ * @fn         bool CSX1276_ArmSend(void *this, void *pParams)
+ * 
+ * @brief      Prepares the Semtech SX1276 chip to send a specified LoRa packet.
+ * 
+ * @details    This function transfers the specified LoRa packet in SX1276 device (FIFO, 
+ *             payload length, IRQ mapping) and locks the frequency synthesizer on TX 
+ *             frequency ('FSTX' mode).
+
+ *             The transmission is started by 'FireSend' method.
+ * 
+ * @param      this
+ *             The pointer to CSX1276 object.
+ *  
+ * @param      pParams
+ *             The method parameters (see 'LoraTransceiverItf.h' for details).
+ *
+ * @return     The returned value is 'true' if the SX1276 device is ready to send the LoRa
+ *             packet or 'false' in case of error.
+*********************************************************************************************/
+bool CSX1276_ArmSend(void *this, void *pParams)
+{
+  return CSX1276_NotifyAndProcessCommand((CSX1276 *) this, SX1276_AUTOMATON_CMD_ARMSEND, pParams);
+}
+
+/*****************************************************************************************//**
+ * @fn         bool CSX1276_FireSend(void *this, void *pParams)
+ * 
+ * @brief      Starts the transmission of the LoRa packet prepared by 'ArmSend' method.
+ * 
+ * @details    This function is time critical and is directly executed by the calling task
+ *             (i.e. not processed by main automaton). The transmission is started by a single
+ *             SPI transaction prepared by 'ArmSend' method.
+
+ *             The end of transmission is notified as for 'Send' method.
+ * 
+ * @param      this
+ *             The pointer to CSX1276 object.
+ *  
+ * @param      pParams
+ *             The method parameters (see 'LoraTransceiverItf.h' for details).
+ *
+ * @return     The returned value is 'true' if the SX1276 device is sending the LoRa packet
+ *             or 'false' if no packet is armed (or a command is processed by automaton).\n
+ *             The 'm_bLate' output is set if the transmission cannot start before the late 
+ *             limit specified in parameters (i.e. SPI bus busy).
+*********************************************************************************************/
+bool CSX1276_FireSend(void *this, void *pParams)
+{
+  CSX1276 *pThis = (CSX1276 *) this;
+
+  // The command mutex is never waited (i.e. if a command is currently processed, the armed 
+  // packet may be cancelled)
+  if (xSemaphoreTake(pThis->m_hCommandMutex, 0) == pdFAIL)
+  {
+    return false;
+  }
+
+  if ((pThis->m_dwCommand != SX1276_AUTOMATON_CMD_NONE) || (pThis->m_dwCurrentState != SX1276_AUTOMATON_STATE_ARMED))
+  {
+    xSemaphoreGive(pThis->m_hCommandMutex);
+    return false;
+  }
+
+  // The 'SENDING' automaton state is entered before 'TX_DONE' IRQ is enabled
+  // Note: Automaton state not modified by main automaton in 'ARMED' state (i.e. no command and
+  //       no IRQ)
+  pThis->m_dwCurrentState = SX1276_AUTOMATON_STATE_SENDING;
+  if (CSX1276_fireSend(pThis, ((CLoraTransceiverItf_FireSendParams) pParams)->m_qwLateTimestamp) == false)
+  {
+    // SPI bus not obtained in time, the packet remains armed
+    pThis->m_dwCurrentState = SX1276_AUTOMATON_STATE_ARMED;
+    ((CLoraTransceiverItf_FireSendParams) pParams)->m_bLate = true;
+    xSemaphoreGive(pThis->m_hCommandMutex);
+    return false;
+  }
+  ((CLoraTransceiverItf_FireSendParams) pParams)->m_qwFireTimestamp = pThis->m_pPacketToSend->m_qwTimestamp;
+
+  xSemaphoreGive(pThis->m_hCommandMutex);
+  return true;
+}
+
 
 /*****************************************************************************************//**
  * @fn         bool CSX1276_GetReceivedPacketInfo(void *this, void *pParams)
@@ -550,12 +651,15 @@ bool CSX1276_NotifyAndProcessCommand(CSX1276 *this, DWORD dwCommand, void *pCmdP
 void CSX1276_MainAutomaton(CSX1276 *this)
 {
   DWORD dwNotificationFlags;
+  DWORD dwSpiSavedNumber;
+  bool bPacketReceived;
 
   while (this->m_dwCurrentState != SX1276_AUTOMATON_STATE_TERMINATED)
   {
     // Wait for events
     // Rem: 'dwNotificationFlags' cleared on 'xTaskNotifyWait' exit
-    if (xTaskNotifyWait(0, 0xFFFFFFFF, &dwNotificationFlags, pdMS_TO_TICKS(100)) == pdTRUE)
+    // Note: In scanner mode, the wait is bounded by the RX lock timeout
+    if (xTaskNotifyWait(0, 0xFFFFFFFF, &dwNotificationFlags, CSX1276_scanGetWaitTicks(this)) == pdTRUE)
     {
       // Process any events signaled in 'dwNotificationFlags'
       #if (SX1276_DEBUG_LEVEL0)
@@ -570,8 +674,19 @@ void CSX1276_MainAutomaton(CSX1276 *this)
       {
         // A 'Command' is waiting for processing (i.e. launched via 'ILoraTransceiver' interface)
         // Note: commands are serialized by design and only one command is associated to this signal
+        dwSpiSavedNumber = this->m_dwSpiSavedNumber;
         CSX1276_ProcessAutomatonNotifyCommand(this);
 
+        // Deferred register writes done before end of command
+        CSX1276_flushRegisters(this);
+        this->m_dwSpiSavedLastCommand = this->m_dwSpiSavedNumber - dwSpiSavedNumber;
+
+        #if (SX1276_DEBUG_LEVEL1)
+          DEBUG_PRINT("CSX1276_MainAutomaton, SPI transactions saved by command: ");
+          DEBUG_PRINT_DEC(this->m_dwSpiSavedLastCommand);
+          DEBUG_PRINT_CR;
+        #endif
+
         // Command executed, release calling task (i.e. command execution is synchronous)
         xSemaphoreGive(this->m_hCommandDone);
       }
@@ -579,14 +694,46 @@ void CSX1276_MainAutomaton(CSX1276 *this)
       // 2- Check and process 'Packet Received' hardware interrupt raised by SX1276
       if (dwNotificationFlags & SX1276_AUTOMATON_NOTIFY_PACKET_RECEIVED)
       {
-        CSX1276_ProcessAutomatonNotifyPacketReceived(this);
+        dwSpiSavedNumber = this->m_dwSpiSavedNumber;
+        bPacketReceived = CSX1276_ProcessAutomatonNotifyPacketReceived(this);
+
+        // Scanner mode: channel activity detection resumed
+        if (this->m_Scanner.m_usPhase != SX1276_SCAN_PHASE_OFF)
+        {
+          CSX1276_scanPacketReceived(this, bPacketReceived);
+        }
+
+        CSX1276_flushRegisters(this);
+        this->m_dwSpiSavedLastPacket = this->m_dwSpiSavedNumber - dwSpiSavedNumber;
+
+        // Packet read, configuration traffic of other SX1276 on shared bus not deferred anymore
+        if (__atomic_exchange_n(&(this->m_bRxPending), false, __ATOMIC_ACQ_REL))
+        {
+          __atomic_sub_fetch(&(g_SX1276SpiBusOb.m_dwRxPendingNumber), 1, __ATOMIC_RELEASE);
+        }
       }
 
       // 3- Check and process 'Packet Sent' hardware interrupt raised by SX1276
       if (dwNotificationFlags & SX1276_AUTOMATON_NOTIFY_PACKET_SENT)
       {
+        dwSpiSavedNumber = this->m_dwSpiSavedNumber;
         CSX1276_ProcessAutomatonNotifyPacketSent(this);
+        CSX1276_flushRegisters(this);
+        this->m_dwSpiSavedLastPacket = this->m_dwSpiSavedNumber - dwSpiSavedNumber;
       }
+
+      // 4- Check and process 'CAD Done' hardware interrupt raised by SX1276 (scanner mode)
+      if (dwNotificationFlags & SX1276_AUTOMATON_NOTIFY_CAD_DONE)
+      {
+        CSX1276_ProcessAutomatonNotifyCadDone(this);
+        CSX1276_flushRegisters(this);
+      }
+    }
+    else if (this->m_Scanner.m_usPhase != SX1276_SCAN_PHASE_OFF)
+    {
+      // Scanner mode: RX lock timeout (or lost 'CadDone' IRQ)
+      CSX1276_ProcessAutomatonScanTimeout(this);
+      CSX1276_flushRegisters(this);
     }
     else
     {
@@ -637,8 +784,9 @@ CSX1276 * CSX1276_New()
   if ((this = (void *) pvPortMalloc(sizeof(CSX1276))) != NULL)
   {
     // Allocate memory blocks for data transfers
-    this->m_pPacketReceived = this->m_hCommandMutex = this->m_hCommandDone = 
-      this->m_hAutomatonTask = this->m_hPacketReceivedIntOb = NULL;
+    this->m_pPacketReceived = NULL;
+    this->m_hCommandMutex = this->m_hCommandDone = this->m_hPacketReceivedIntOb = NULL;
+    this->m_hAutomatonTask = NULL;
 
     if ((this->m_pPacketReceived = (CLoraPacket *) pvPortMalloc(sizeof(CLoraPacket))) == NULL)
     {
@@ -659,18 +807,23 @@ CSX1276 * CSX1276_New()
     }
 
     // Create main automaton task
-    if (xTaskCreate((TaskFunction_t) CSX1276_MainAutomaton, "CSX1276_Automaton", 4096, this, 5, &(this->m_hAutomatonTask)) == pdFAIL)
+    if (CTaskPlacement_CreateTask(TASKPLACEMENT_TASK_SX1276, (TaskFunction_t) CSX1276_MainAutomaton, 
+        this, &(this->m_hAutomatonTask)) == false)
     {
       CSX1276_Delete(this);
       return NULL;
     }
 
-    // Initialize GPIO interrupt handler
-    if (gpio_install_isr_service(ESP_INTR_FLAG_IRAM) != ESP_OK)
+    // Initialize GPIO interrupt handler (service shared by all CSX1276 objects)
+    if (g_usSX1276InstanceNumber == 0)
     {
-      CSX1276_Delete(this);
-      return NULL;
+      if (gpio_install_isr_service(ESP_INTR_FLAG_IRAM) != ESP_OK)
+      {
+        CSX1276_Delete(this);
+        return NULL;
+      }
     }
+    ++g_usSX1276InstanceNumber;
 
     // Initialize object's properties
     this->m_nRefCount = 0;
@@ -690,16 +843,37 @@ CSX1276 * CSX1276_New()
     this->m_usOcpRate = SX1276_OCP_UNDEFINED;
     this->m_wPreambleLength = SX1276_PREAMBLE_LENGTH_UNDEFINED;
     this->m_usSyncWord = SX1276_SYNCWORD_UNDEFINED;
+    this->m_qwIrqTimestamp = 0;
     this->m_dwPacketReceivedNumber = 0;
     this->m_dwMissedPacketReceivedNumber = 0;
     this->m_dwPacketSentNumber = 0;
     this->m_pPacketToSend = NULL;
     this->m_usRetries = 0;
     this->m_usMaxRetries = 3;
-    this->m_usSpiSlaveID = 0; //SPISlaveID;
+    this->m_usSpiSlaveID = 0;
+    this->m_nPinCS = -1;
+    this->m_nPinIrq = -1;
     this->m_SpiDeviceHandle = NULL;
+    this->m_bRxPending = false;
+    this->m_pSpiBackend = &g_SX1276EspSpiBackendOb;
+    this->m_SpiBatch.m_usCount = 0;
+
+    CSX1276_invalidateRegisters(this);
+    this->m_dwSpiTransactionNumber = 0;
+    this->m_dwSpiBatchNumber = 0;
+    this->m_dwSpiDeferredNumber = 0;
+    this->m_dwSpiSavedNumber = 0;
+    this->m_dwSpiSavedLastCommand = 0;
+    this->m_dwSpiSavedLastPacket = 0;
 
     this->m_hEventNotifyQueue = NULL;
+    this->m_pLoraPacketPool = NULL;
+    this->m_pReceiveRing = NULL;
+
+    this->m_Scanner.m_usPhase = SX1276_SCAN_PHASE_OFF;
+    this->m_Scanner.m_usChannelNumber = 0;
+    this->m_Scanner.m_pStatistics = NULL;
+    this->m_TxRadio.m_bActive = false;
 
     this->m_ReceivedPacketInfo.m_szDataRate[0] = 0;
     this->m_ReceivedPacketInfo.m_szFrequency[0] = 0;
@@ -730,7 +904,15 @@ void CSX1276_Delete(CSX1276 *this)
 {
   if (this->m_pPacketReceived != NULL) 
   {
-    vPortFree(this->m_pPacketReceived);
+    if (this->m_pLoraPacketPool != NULL)
+    {
+      CWideMemoryBlockArray_ReleaseRef(this->m_pLoraPacketPool, 
+        CWideMemoryBlockArray_BlockIndexFromPtr(this->m_pLoraPacketPool, this->m_pPacketReceived));
+    }
+    else
+    {
+      vPortFree(this->m_pPacketReceived);
+    }
   }
   if (this->m_pLoraTransceiverItf != NULL)
   {
@@ -745,7 +927,10 @@ void CSX1276_Delete(CSX1276 *this)
     vSemaphoreDelete(this->m_hCommandDone);
   }
 
-  gpio_uninstall_isr_service();
+  if ((g_usSX1276InstanceNumber > 0) && (--g_usSX1276InstanceNumber == 0))
+  {
+    gpio_uninstall_isr_service();
+  }
 
   // Ask main automaton for termination
   // TO DO (also check how to delete task object)
@@ -753,6 +938,36 @@ void CSX1276_Delete(CSX1276 *this)
   vPortFree(this);
 }
 
+/*****************************************************************************************//**
+ * @fn         void CSX1276_SetSpiBackend(CSX1276 *this, const CSX1276SpiBackendOb *pBackend, 
+ *                                        spi_device_handle_t hDevice)
+ * 
+ * @brief      Specifies the SPI device used to access the SX1276.
+ * 
+ * @details    By default, the SX1276 is attached to the ESP32 SPI bus by 'Initialize' command.\n
+ *             This function is used to access another device (typically the mock SX1276 on 
+ *             Linux host, see 'SX1276MockSpi.h'). In this case, the SPI bus is not initialized
+ *             by the 'Initialize' command.
+ *
+ * @param      this
+ *             The pointer to CSX1276 object.
+ *  
+ * @param      pBackend
+ *             The access methods for the SPI device.
+ *  
+ * @param      hDevice
+ *             The SPI device (i.e. handle passed to 'pBackend' methods).
+ *  
+ * @return     None.
+ *
+ * @note       This function must be called before the 'Initialize' command.
+*********************************************************************************************/
+void CSX1276_SetSpiBackend(CSX1276 *this, const CSX1276SpiBackendOb *pBackend, spi_device_handle_t hDevice)
+{
+  this->m_pSpiBackend = pBackend;
+  this->m_SpiDeviceHandle = hDevice;
+}
+
 
 /*********************************************************************************************
   Private methods (implementation)
@@ -815,6 +1030,9 @@ bool CSX1276_ProcessAutomatonNotifyCommand(CSX1276 *this)
     case SX1276_AUTOMATON_CMD_SEND:
       return CSX1276_ProcessSend(this, (CLoraTransceiverItf_SendParams) this->m_pCommandParams);
 
+    case SX1276_AUTOMATON_CMD_ARMSEND:
+      return CSX1276_ProcessArmSend(this, (CLoraTransceiverItf_ArmSendParams) this->m_pCommandParams);
+
     default:
       break;
   }
@@ -868,8 +1086,7 @@ bool CSX1276_ProcessInitialize(CSX1276 *this, CLoraTransceiverItf_InitializePara
   }
 
   // Step 1: Initialize SPI link and start LoRa in 'Standby' (with chip default configuration)
-  // TO DO = Manage SPI Slave ID
-  if (CSX1276_InitializeDevice(this, 0, pParams) != LORATRANSCEIVERITF_RESULT_SUCCESS)
+  if (CSX1276_InitializeDevice(this, pParams->m_usSpiSlaveID, pParams) != LORATRANSCEIVERITF_RESULT_SUCCESS)
   {
     #if (SX1276_DEBUG_LEVEL0)
       DEBUG_PRINT_LN("[ERROR] Failed to initialize device");
@@ -879,6 +1096,21 @@ bool CSX1276_ProcessInitialize(CSX1276 *this, CLoraTransceiverItf_InitializePara
 
   // Set the queue to use for event notifications
   this->m_hEventNotifyQueue = pParams->m_hEventNotifyQueue ; 
+
+  // Use the shared packet buffers of owner object if provided
+  // Note: The single receive buffer allocated by 'New' method is not required anymore
+  if ((pParams->m_pLoraPacketPool != NULL) && (this->m_pLoraPacketPool == NULL))
+  {
+    vPortFree(this->m_pPacketReceived);
+    this->m_pLoraPacketPool = (CWideMemoryBlockArray) pParams->m_pLoraPacketPool;
+    this->m_pPacketReceived = CSX1276_getReceiveBuffer(this);
+  }
+
+  // Use the receive ring of owner object if provided (only with shared packet buffers)
+  if ((pParams->m_pReceiveRing != NULL) && (this->m_pLoraPacketPool != NULL))
+  {
+    this->m_pReceiveRing = (CSpscRing) pParams->m_pReceiveRing;
+  }
   
   // Enter 'INITIALIZED' state if current state is still 'CREATED'
   // Note: By design, no concurrency on automaton state variable
@@ -1105,24 +1337,7 @@ bool CSX1276_ProcessSetLoraMode(CSX1276 *this, CLoraTransceiverItf_SetLoraModePa
 
   // Store current SpreadingFactor and Bandwidth information (i.e. text value retrieved by client object
   // when a LoraPacket is received)
-  sprintf((char *) this->m_ReceivedPacketInfo.m_szDataRate, "SF%dBW", (int) this->m_usSpreadingFactor);
-  switch (this->m_usBandwidth)
-  {
-    case LORATRANSCEIVERITF_BANDWIDTH_125:
-      strcat((char *) this->m_ReceivedPacketInfo.m_szDataRate, "125");
-      break;
-    case LORATRANSCEIVERITF_BANDWIDTH_250:
-      strcat((char *) this->m_ReceivedPacketInfo.m_szDataRate, "250");
-      break;
-    case LORATRANSCEIVERITF_BANDWIDTH_500:
-      strcat((char *) this->m_ReceivedPacketInfo.m_szDataRate, "500");
-      break;
-    default:
-      strcat((char *) this->m_ReceivedPacketInfo.m_szDataRate, "?");
-      #if (SX1276_DEBUG_LEVEL0)
-        DEBUG_PRINT_LN("[ERROR] Unable to generate datarate string");
-      #endif
-  }
+  CSX1276_setDataRateText(this, this->m_usSpreadingFactor);
 
   #if (SX1276_DEBUG_LEVEL2)
     DEBUG_PRINT("[DEBUG] CSX1276_ProcessSetLoraMode - Data Rate: ");
@@ -1268,10 +1483,12 @@ bool CSX1276_ProcessStandBy(CSX1276 *this, CLoraTransceiverItf_StandByParams pPa
     DEBUG_PRINT_LN("[INFO] Entering 'CSX1276_ProcessStandBy'");
   #endif
 
-  // The 'StandBy' method is allowed only in 'STANDBY', 'RECEIVING' and 'SENDING' automaton states
+  // The 'StandBy' method is allowed only in 'STANDBY', 'RECEIVING', 'SENDING' and 'ARMED' 
+  // automaton states (i.e. armed packet cancelled)
   if ((this->m_dwCurrentState != SX1276_AUTOMATON_STATE_RECEIVING) && 
       (this->m_dwCurrentState != SX1276_AUTOMATON_STATE_SENDING) &&
-      (this->m_dwCurrentState != SX1276_AUTOMATON_STATE_STANDBY))
+      (this->m_dwCurrentState != SX1276_AUTOMATON_STATE_STANDBY) &&
+      (this->m_dwCurrentState != SX1276_AUTOMATON_STATE_ARMED))
   {
     // By design, should never occur
     #if (SX1276_DEBUG_LEVEL0)
@@ -1290,6 +1507,9 @@ bool CSX1276_ProcessStandBy(CSX1276 *this, CLoraTransceiverItf_StandByParams pPa
     return false;
   }
 
+  // End of scanner mode (i.e. configured channel and SF restored)
+  CSX1276_stopScan(this);
+
   // Set SX1276 device in standby mode
   if (CSX1276_startStandBy(this) != LORATRANSCEIVERITF_RESULT_SUCCESS)
   {
@@ -1299,6 +1519,9 @@ bool CSX1276_ProcessStandBy(CSX1276 *this, CLoraTransceiverItf_StandByParams pPa
     return false;
   }
 
+  // Armed packet cancelled or sent (i.e. configured radio settings restored)
+  CSX1276_restoreTxRadio(this);
+
   // The 'STANDBY' automaton state is entered
   // Note: By design, no concurrency on automaton state variable
   this->m_dwCurrentState = SX1276_AUTOMATON_STATE_STANDBY;
@@ -1316,12 +1539,14 @@ bool CSX1276_ProcessReceive(CSX1276 *this, CLoraTransceiverItf_ReceiveParams pPa
     DEBUG_PRINT_LN("[INFO] Entering 'CSX1276_ProcessReceive'");
   #endif
 
-  // The 'Receive' method is allowed only in 'STANDBY', 'SENDING' and 'RECEIVING' automaton states
+  // The 'Receive' method is allowed only in 'STANDBY', 'SENDING', 'RECEIVING' and 'ARMED' 
+  // automaton states
   // Note: The owner object is responsible to be sure that no packet is currently 'SENDING' when asking
-  //       for 'RECEIVING' mode 
+  //       for 'RECEIVING' mode (an 'ARMED' packet is cancelled)
   if ((this->m_dwCurrentState != SX1276_AUTOMATON_STATE_STANDBY) && 
       (this->m_dwCurrentState != SX1276_AUTOMATON_STATE_SENDING) &&
-      (this->m_dwCurrentState != SX1276_AUTOMATON_STATE_RECEIVING))
+      (this->m_dwCurrentState != SX1276_AUTOMATON_STATE_RECEIVING) &&
+      (this->m_dwCurrentState != SX1276_AUTOMATON_STATE_ARMED))
   {
     // By design, should never occur
     #if (SX1276_DEBUG_LEVEL0)
@@ -1340,9 +1565,27 @@ bool CSX1276_ProcessReceive(CSX1276 *this, CLoraTransceiverItf_ReceiveParams pPa
     return false;
   }
 
+  // Previous scanner mode ended (i.e. configured channel and SF restored) and armed packet 
+  // cancelled (i.e. configured radio settings restored)
+  CSX1276_stopScan(this);
+  CSX1276_restoreTxRadio(this);
+
+  // Scanner mode: check the channel list and time budget
+  if ((pParams->m_pScanParams != NULL) && (pParams->m_pScanParams->m_usChannelNumber != 0))
+  {
+    if (CSX1276_startScan(this, pParams->m_pScanParams) != LORATRANSCEIVERITF_RESULT_SUCCESS)
+    {
+      #if (SX1276_DEBUG_LEVEL0)
+        DEBUG_PRINT_LN("[ERROR] Failed to start scanner mode");
+      #endif
+      return false;
+    }
+  }
+
   // Set SX1276 device in receive mode
   if (CSX1276_startReceive(this) != LORATRANSCEIVERITF_RESULT_SUCCESS)
   {
+    this->m_Scanner.m_usPhase = SX1276_SCAN_PHASE_OFF;
     #if (SX1276_DEBUG_LEVEL0)
       DEBUG_PRINT_LN("[ERROR] Failed to set RECEIVE mode in SX1276");
     #endif
@@ -1355,6 +1598,12 @@ bool CSX1276_ProcessReceive(CSX1276 *this, CLoraTransceiverItf_ReceiveParams pPa
   #if (SX1276_DEBUG_LEVEL0)
     DEBUG_PRINT_LN("[INFO] CSX1276 automaton state changed: 'RECEIVING'");
   #endif
+
+  // Scanner mode: first CAD started when IRQ can be notified (i.e. 'RECEIVING' state)
+  if (this->m_Scanner.m_usPhase != SX1276_SCAN_PHASE_OFF)
+  {
+    CSX1276_scanHop(this);
+  }
   return true;
 }
 
@@ -1365,11 +1614,12 @@ bool CSX1276_ProcessSend(CSX1276 *this, CLoraTransceiverItf_SendParams pParams)
     DEBUG_PRINT_LN("[INFO] Entering 'CSX1276_ProcessSend'");
   #endif
 
-  // The 'Send' method is allowed only in 'STANDBY' and 'RECEIVING' automaton states
+  // The 'Send' method is allowed only in 'STANDBY', 'RECEIVING' and 'ARMED' automaton states
   // Note: By design, the SX1276 automatically returns to 'STANDBY' when packet is sent. This is
   //       detected by 'TX_DONE' IRQ and CSX1276 automaton state is adjusted accordingly.
   if ((this->m_dwCurrentState != SX1276_AUTOMATON_STATE_STANDBY) && 
-      (this->m_dwCurrentState != SX1276_AUTOMATON_STATE_RECEIVING))
+      (this->m_dwCurrentState != SX1276_AUTOMATON_STATE_RECEIVING) &&
+      (this->m_dwCurrentState != SX1276_AUTOMATON_STATE_ARMED))
   {
     // By design, should never occur
     #if (SX1276_DEBUG_LEVEL0)
@@ -1379,8 +1629,11 @@ bool CSX1276_ProcessSend(CSX1276 *this, CLoraTransceiverItf_SendParams pParams)
   }
 
   // Enter 'STANDBY' mode (i.e. the SX1276 MUST be in 'STANDBY' mode to allow send operation)
+  // Note: Packet sent on configured channel and SF (i.e. end of scanner mode)
   if (this->m_dwCurrentState != SX1276_AUTOMATON_STATE_STANDBY)
   {
+    CSX1276_stopScan(this);
+
     if (CSX1276_startStandBy(this) != LORATRANSCEIVERITF_RESULT_SUCCESS)
     {
       #if (SX1276_DEBUG_LEVEL0)
@@ -1389,6 +1642,7 @@ bool CSX1276_ProcessSend(CSX1276 *this, CLoraTransceiverItf_SendParams pParams)
       return false;
     }
   }
+  CSX1276_restoreTxRadio(this);
 
   // Copy packet in SX1276 and send it
   // Note: Packet payload is copied directly from 'CLoraTransceiverItf_LoraPacketOb'
@@ -1410,6 +1664,73 @@ bool CSX1276_ProcessSend(CSX1276 *this, CLoraTransceiverItf_SendParams pParams)
   return true;
 }
 
+
+bool CSX1276_ProcessArmSend(CSX1276 *this, CLoraTransceiverItf_ArmSendParams pParams)
+{
+  #if (SX1276_DEBUG_LEVEL0)
+    DEBUG_PRINT_CR;
+    DEBUG_PRINT_LN("[INFO] Entering 'CSX1276_ProcessArmSend'");
+  #endif
+
+  // The 'ArmSend' method is allowed only in 'STANDBY', 'RECEIVING' and 'ARMED' automaton states
+  // Note: A packet already armed is replaced
+  if ((this->m_dwCurrentState != SX1276_AUTOMATON_STATE_STANDBY) && 
+      (this->m_dwCurrentState != SX1276_AUTOMATON_STATE_RECEIVING) &&
+      (this->m_dwCurrentState != SX1276_AUTOMATON_STATE_ARMED))
+  {
+    // By design, should never occur
+    #if (SX1276_DEBUG_LEVEL0)
+      DEBUG_PRINT_LN("[ERROR] Function called in invalid automaton state");
+    #endif
+    return false;
+  }
+
+  // Enter 'STANDBY' mode (i.e. the SX1276 MUST be in 'STANDBY' mode to load the FIFO)
+  // Note: Packet sent on configured channel and SF (i.e. end of scanner mode) unless other radio
+  //       settings are requested for this packet
+  if (this->m_dwCurrentState != SX1276_AUTOMATON_STATE_STANDBY)
+  {
+    CSX1276_stopScan(this);
+
+    if (CSX1276_startStandBy(this) != LORATRANSCEIVERITF_RESULT_SUCCESS)
+    {
+      #if (SX1276_DEBUG_LEVEL0)
+        DEBUG_PRINT_LN("[ERROR] Cannot set 'STANDBY' automaton state");
+      #endif
+      return false;
+    }
+  }
+
+  // Radio settings of a replaced armed packet restored before settings of this packet are applied
+  CSX1276_restoreTxRadio(this);
+  if (CSX1276_setTxRadio(this, pParams) != LORATRANSCEIVERITF_RESULT_SUCCESS)
+  {
+    return false;
+  }
+
+  // Copy packet in SX1276
+  if (CSX1276_armSend(this, pParams->m_pPacketToSend) != LORATRANSCEIVERITF_RESULT_SUCCESS)
+  {
+    #if (SX1276_DEBUG_LEVEL0)
+      DEBUG_PRINT_LN("[ERROR] Failed to load packet in SX1276");
+    #endif
+    CSX1276_restoreTxRadio(this);
+    return false;
+  }
+
+  // Frequency synthesizer locked on TX frequency (i.e. PLL lock time not included in TX start
+  // latency)
+  CSX1276_writeRegister(this, REG_OP_MODE, LORA_FSTX_MODE);
+
+  // The 'ARMED' automaton state is entered
+  // Note: By design, no concurrency on automaton state variable
+  this->m_dwCurrentState = SX1276_AUTOMATON_STATE_ARMED;
+  #if (SX1276_DEBUG_LEVEL0)
+    DEBUG_PRINT_LN("[INFO] CSX1276 automaton state changed: 'ARMED'");
+  #endif
+  return true;
+}
+
 /*********************************************************************************************
   Private methods (implementation)
 
@@ -1431,7 +1752,9 @@ bool CSX1276_ProcessSend(CSX1276 *this, CLoraTransceiverItf_SendParams pParams)
  *             signaling that a LoRa packet has been received by SX1276 and data are waiting
  *             in reception buffer.\n
  *             The function transfers the received bytes in the 'm_pPacketReceived' buffer of
- *             CSX1276 object and notifies the owner object.
+ *             CSX1276 object and notifies the owner object.\n
+ *             When the owner object has provided a receive ring, the packet is stored in the
+ *             next slot of the ring (i.e. the packet is dropped if the ring is full).
  * 
  * @param      this
  *             The pointer to CSX1276 object.
@@ -1442,6 +1765,7 @@ bool CSX1276_ProcessSend(CSX1276 *this, CLoraTransceiverItf_SendParams pParams)
 bool CSX1276_ProcessAutomatonNotifyPacketReceived(CSX1276 *this)
 {
   CLoraTransceiverItf_EventOb EventOb;
+  CLoraTransceiverItf_ReceiveSlot pReceiveSlot;
 
   #if (SX1276_DEBUG_LEVEL0)
     DEBUG_PRINT_CR;
@@ -1467,6 +1791,45 @@ bool CSX1276_ProcessAutomatonNotifyPacketReceived(CSX1276 *this)
     return false;
   }
 
+  // With receive ring, the packet and its information are stored in next slot
+  // Note: If owner object is too slow, the ring is full and the packet is dropped (i.e. the
+  //       packet buffer is reused for next packet)
+  if (this->m_pReceiveRing != NULL)
+  {
+    if ((pReceiveSlot = (CLoraTransceiverItf_ReceiveSlot) CSpscRing_GetWriteSlot(this->m_pReceiveRing)) == NULL)
+    {
+      ++this->m_dwMissedPacketReceivedNumber;
+
+      #if (SX1276_DEBUG_LEVEL0)
+        DEBUG_PRINT("[ERROR] Receive ring full, total missed packets: ");
+        DEBUG_PRINT_DEC(this->m_dwMissedPacketReceivedNumber);
+        DEBUG_PRINT_CR;
+      #endif
+      return false;
+    }
+
+    pReceiveSlot->m_pPacket = (CLoraTransceiverItf_LoraPacket) this->m_pPacketReceived;
+    memcpy(&pReceiveSlot->m_PacketInfo, &this->m_ReceivedPacketInfo, sizeof(CLoraTransceiverItf_ReceivedLoraPacketInfoOb));
+    CSpscRing_CommitWrite(this->m_pReceiveRing);
+
+    // The reference on the block is now owned by the ring (i.e. by owner object)
+    this->m_pPacketReceived = CSX1276_getReceiveBuffer(this);
+    ++this->m_dwPacketReceivedNumber;
+
+    // Signal the owner object
+    // Note: If the event queue is full, the packet will be read by owner object on next event
+    EventOb.m_wEventType = LORATRANSCEIVERITF_EVENT_PACKETRECEIVED;
+    EventOb.m_pLoraTransceiverItf = this->m_pLoraTransceiverItf;
+    EventOb.m_pEventData = pReceiveSlot->m_pPacket;
+    if (xQueueSend(this->m_hEventNotifyQueue, &EventOb, 0) != pdPASS)
+    {
+      #if (SX1276_DEBUG_LEVEL0)
+        DEBUG_PRINT_LN("[WARNING] Event notification queue full, packet kept in receive ring");
+      #endif
+    }
+    return true;
+  }
+
   // Packet is ready for use by owner object
   // Send an event on 'CLoraTransceiverItf' interface to notify owner object
   EventOb.m_wEventType = LORATRANSCEIVERITF_EVENT_PACKETRECEIVED;
@@ -1487,6 +1850,14 @@ bool CSX1276_ProcessAutomatonNotifyPacketReceived(CSX1276 *this)
     #endif
     return false;
   }
+
+  // With shared packet buffers, the reference on the block is now owned by owner object
+  // Obtain a new block for next received packet
+  if (this->m_pLoraPacketPool != NULL)
+  {
+    this->m_pPacketReceived = CSX1276_getReceiveBuffer(this);
+  }
+
   ++this->m_dwPacketReceivedNumber;
   return true;
 }
@@ -1532,7 +1903,13 @@ bool CSX1276_ProcessAutomatonNotifyPacketSent(CSX1276 *this)
   }
 
   // The SX1276 has automatically returned to 'STANDBY' mode, update automaton state
-  gpio_intr_disable(PIN_NUM_RX_TX_IRQ);
+  gpio_intr_disable(this->m_nPinIrq);
+
+  // Mode changed by SX1276 (i.e. shadow of 'REG_OP_MODE' updated)
+  this->m_usRegShadow[REG_OP_MODE] = LORA_STANDBY_MODE;
+
+  // Configured radio settings restored (i.e. settings of sent packet only used for transmission)
+  CSX1276_restoreTxRadio(this);
    
   this->m_dwCurrentState = SX1276_AUTOMATON_STATE_STANDBY;
   #if (SX1276_DEBUG_LEVEL0)
@@ -1561,620 +1938,1700 @@ bool CSX1276_ProcessAutomatonNotifyPacketSent(CSX1276 *this)
 }
 
 
-/*********************************************************************************************
-  Private methods (implementation)
-
-  Access to SX1276 registers
-
-  LoRa Configuration registers are accessed through the SPI interface. 
-  Registers are readable in all device modes including Sleep. However, they should be written 
-  only in 'Sleep' and 'StandBy' modes.
-*********************************************************************************************/
-
 /*****************************************************************************************//**
- * @fn         BYTE CSX1276_readRegister(spi_device_handle_t SPIDeviceHandle, BYTE address)
+ * @fn         bool CSX1276_ProcessAutomatonNotifyCadDone(CSX1276 *this)
  * 
- * @brief      Reads value in a specified register.
+ * @brief      Process the CAD done event currently waiting in automaton (scanner mode).
  * 
- * @details    The function retrieves the byte value stored in the specified register.
- *
- * @param      SPIDeviceHandle
- *             The handle to the SPIDevice (ESP32 IDF object) associated to the SX1276 chip.
- *  
- * @param      address
- *             Register address to read from.
+ * @details    This function is invoked by main automaton when it receives a notification 
+ *             signaling that a channel activity detection is terminated by SX1276 (i.e. the 
+ *             SX1276 has returned to 'STANDBY' mode).\n
+ *             If activity is detected, the SX1276 is locked in receive mode on the scanned
+ *             channel and SF. Otherwise, the CAD is started on next channel.
+ * 
+ * @param      this
+ *             The pointer to CSX1276 object.
  *  
- * @return     The functions returns the content of the specified register.
+ * @return     The returned value is 'true' if activity is detected or 'false' otherwise.
 *********************************************************************************************/
-BYTE CSX1276_readRegister(spi_device_handle_t SPIDeviceHandle, BYTE address)
+bool CSX1276_ProcessAutomatonNotifyCadDone(CSX1276 *this)
 {
-  BYTE value = 0x00;
+  CSX1276ScanChannelOb *pChannel;
+  BYTE usIrqFlags;
+  QWORD qwElapsed;
 
-  #if (SX1276_DEBUG_LEVEL2)
-    DEBUG_PRINT_CR;
-    DEBUG_PRINT("CSX1276_readRegister, dev: ");
-    DEBUG_PRINT_HEX((uint32_t)SPIDeviceHandle);
+  #if (SX1276_DEBUG_LEVEL1)
     DEBUG_PRINT_CR;
+    DEBUG_PRINT_LN("[INFO] Entering 'CSX1276_ProcessAutomatonNotifyCadDone'");
   #endif
 
-  spi_transaction_t t;
+  // This function MUST be called only in 'CAD' phase of scanner mode
+  if ((this->m_dwCurrentState != SX1276_AUTOMATON_STATE_RECEIVING) || 
+      (this->m_Scanner.m_usPhase != SX1276_SCAN_PHASE_CAD))
+  {
+    // By design, should never occur
+    #if (SX1276_DEBUG_LEVEL0)
+      DEBUG_PRINT_LN("[ERROR] Function called in invalid automaton state");
+    #endif
+    return false;
+  }
 
-  // Zero out the transaction
-  memset(&t, 0, sizeof(t));       
+  // Read and clear IRQ flags (pipelined SPI transactions)
+  CSX1276_batchBegin(this);
+  CSX1276_batchReadRegister(this, REG_IRQ_FLAGS, &usIrqFlags);
+  CSX1276_batchWriteRegister(this, REG_IRQ_FLAGS, 0xFF);
+  CSX1276_batchWait(this);
 
-  // Bit 7 cleared to read from registers
-  bitClear(address, 7);   
-  t.addr = (uint64_t) address;
+  // Check 'CadDone' flag (i.e. IRQ raised by end of previous RX lock is ignored)
+  if (bitRead(usIrqFlags, 2) == 0)
+  {
+    #if (SX1276_DEBUG_LEVEL0)
+      DEBUG_PRINT_LN("[WARNING] NOT 'CadDone' flag");
+    #endif
+    return false;
+  }
 
-  // Use transaction RX buffer (declared as 4 bytes array)
-  t.flags = SPI_TRANS_USE_RXDATA;
+  // Mode changed by SX1276 (i.e. shadow of 'REG_OP_MODE' updated)
+  this->m_usRegShadow[REG_OP_MODE] = LORA_STANDBY_MODE;
 
-  // 8 bits of data to receive
-  t.length = 8;                     
+  // Hop time measured with timestamp latched by ISR (i.e. averaged value used for time budget)
+  pChannel = &(this->m_Scanner.m_Channels[this->m_Scanner.m_usCurrent]);
+  qwElapsed = this->m_qwIrqTimestamp - this->m_Scanner.m_qwHopStart;
+  if ((this->m_qwIrqTimestamp > this->m_Scanner.m_qwHopStart) && (qwElapsed > pChannel->m_dwCadTime))
+  {
+    this->m_Scanner.m_dwHopTime = (DWORD) ((7 * (QWORD) this->m_Scanner.m_dwHopTime + 
+                                           (qwElapsed - pChannel->m_dwCadTime)) / 8);
+  }
 
-  // Start transaction and wait until completed
-  esp_err_t ret = spi_device_transmit(SPIDeviceHandle, &t);
-  assert(ret == ESP_OK);
+  // Check 'CadDetected' flag
+  if (bitRead(usIrqFlags, 0) == 0)
+  {
+    // No activity, next channel
+    CSX1276_scanHop(this);
+    return false;
+  }
 
-  value = (BYTE) (*(uint32_t*)t.rx_data);
-
-  #if (SX1276_DEBUG_LEVEL2)
-    ret == ESP_OK ? DEBUG_PRINT("[OK] Register: ") : DEBUG_PRINT("[ERROR] Register: ");
-    DEBUG_PRINT_HEX(address);
-    DEBUG_PRINT(" -> ");
-    DEBUG_PRINT_HEX(value);
+  #if (SX1276_DEBUG_LEVEL1)
+    DEBUG_PRINT("[INFO] Activity detected, channel: ");
+    DEBUG_PRINT_DEC(pChannel->m_usFreqChannel);
+    DEBUG_PRINT(", SF: ");
+    DEBUG_PRINT_DEC(pChannel->m_usSpreadingFactor);
     DEBUG_PRINT_CR;
   #endif
-     
-  return value;
+
+  ++this->m_Scanner.m_pStatistics[this->m_Scanner.m_usCurrent].m_dwDetectedNumber;
+  CSX1276_scanLock(this);
+  return true;
 }
 
+
 /*****************************************************************************************//**
- * @fn         void CSX1276_writeRegister(spi_device_handle_t SPIDeviceHandle, BYTE address, BYTE data)
+ * @fn         bool CSX1276_ProcessAutomatonScanTimeout(CSX1276 *this)
  * 
- * @brief      Writes in the specified register.
+ * @brief      Process the expiration of automaton wait in scanner mode.
  * 
- * @details    The function writes a specified byte value in a specified register.
- *
- * @param      SPIDeviceHandle
- *             The handle to the SPIDevice (ESP32 IDF object) associated to the SX1276 chip.
- *  
- * @param      address
- *             Register address to write in.
- *  
- * @param      address
- *             Byte value to write in the register.
+ * @details    This function is invoked by main automaton when no notification is received
+ *             before the time returned by 'CSX1276_scanGetWaitTicks':
+ *              - RX lock: if the modem is not synchronized at the end of the preamble, the
+ *                detection is considered as false and the CAD is started on next channel.
+ *                Otherwise, the lock is extended to the maximum packet duration.
+ *              - CAD: the 'CadDone' IRQ is lost and the CAD is started on next channel
+ * 
+ * @param      this
+ *             The pointer to CSX1276 object.
  *  
- * @return     None.
+ * @return     The returned value is 'true' if scanner has left the channel or 'false' 
+ *             otherwise.
 *********************************************************************************************/
-void CSX1276_writeRegister(spi_device_handle_t SPIDeviceHandle, BYTE address, BYTE data)
+bool CSX1276_ProcessAutomatonScanTimeout(CSX1276 *this)
 {
-  #if (SX1276_DEBUG_LEVEL2)
-    DEBUG_PRINT_CR;
-    DEBUG_PRINT("CSX1276_writeRegister, dev: ");
-    DEBUG_PRINT_HEX((uint32_t)SPIDeviceHandle);
-    DEBUG_PRINT_CR;
-  #endif
+  CSX1276ScanChannelOb *pChannel;
+  QWORD qwNow;
+  BYTE usModemStat;
+  DWORD dwPayloadSymbols;
+  BYTE usSpreadingFactor;
+  BYTE usCodingRate;
+  BYTE usLowDataRate;
 
-  esp_err_t ret;
-  spi_transaction_t t;
+  if (this->m_dwCurrentState != SX1276_AUTOMATON_STATE_RECEIVING)
+  {
+    return false;
+  }
 
-  // Zero out the transaction
-  memset(&t, 0, sizeof(t));       
+  qwNow = GATEWAY_CLOCK_MICROSEC();
 
-  // Bit 7 of address set to write to registers
-  bitSet(address, 7);        
-  t.addr = (uint64_t) address;
+  // Lost 'CadDone' IRQ (watchdog)
+  if (this->m_Scanner.m_usPhase == SX1276_SCAN_PHASE_CAD)
+  {
+    if (qwNow - this->m_Scanner.m_qwHopStart < GATEWAY_CLOCK_MS_TO_US(SX1276_SCAN_MAX_WAIT))
+    {
+      return false;
+    }
 
-  // Use transaction TX buffer (declared as 4 bytes array)
-  *(uint32_t*)t.tx_data = data;
-  t.flags = SPI_TRANS_USE_TXDATA;
+    #if (SX1276_DEBUG_LEVEL0)
+      DEBUG_PRINT_LN("[WARNING] 'CadDone' IRQ not received, next channel");
+    #endif
+    CSX1276_scanHop(this);
+    return true;
+  }
 
-  // 8 bits of data to transmit
-  t.length = 8;                     
+  if ((this->m_Scanner.m_usPhase != SX1276_SCAN_PHASE_LOCKED) || (qwNow < this->m_Scanner.m_qwLockDeadline))
+  {
+    return false;
+  }
 
-  // Start transaction and wait until completed
-  ret = spi_device_transmit(SPIDeviceHandle, &t);
-  assert(ret == ESP_OK);                        //Should have had no issues.
+  // Signal detected, synchronized or header received (bits 0, 1 and 3 of 'REG_MODEM_STAT'):
+  // lock extended once to the duration of a packet with maximum payload
+  usModemStat = CSX1276_readRegister(this, REG_MODEM_STAT);
+  if ((this->m_Scanner.m_bLockExtended == false) && ((usModemStat & 0x0B) != 0))
+  {
+    pChannel = &(this->m_Scanner.m_Channels[this->m_Scanner.m_usCurrent]);
+    usSpreadingFactor = pChannel->m_usSpreadingFactor;
+    usCodingRate = (this->m_usCodingRate != SX1276_CR_UNDEFINED) ? this->m_usCodingRate : LORATRANSCEIVERITF_CR_8;
+    usLowDataRate = (pChannel->m_dwSymbolTime >= 16000) ? 1 : 0;
 
-  #if (SX1276_DEBUG_LEVEL2)
-    ret == ESP_OK ? DEBUG_PRINT("[OK] Register: ") : DEBUG_PRINT("[ERROR] Register: ");
-    bitClear(address, 7);
-    DEBUG_PRINT_HEX(address);
-    DEBUG_PRINT(" -> ");
-    DEBUG_PRINT_HEX(data);
-    DEBUG_PRINT_CR;
+    // Payload symbols (explicit header and CRC)
+    dwPayloadSymbols = 8 + (((8 * LORA_MAX_PAYLOAD_LENGTH) - (4 * usSpreadingFactor) + 28 + 16 +
+                             (4 * (usSpreadingFactor - 2 * usLowDataRate)) - 1) /
+                            (4 * (usSpreadingFactor - 2 * usLowDataRate))) * (usCodingRate + 4);
+
+    this->m_Scanner.m_bLockExtended = true;
+    this->m_Scanner.m_qwLockDeadline = qwNow + (QWORD) dwPayloadSymbols * pChannel->m_dwSymbolTime;
+    return false;
+  }
+
+  #if (SX1276_DEBUG_LEVEL1)
+    DEBUG_PRINT_LN("[INFO] RX lock timeout, next channel");
   #endif
 
+  ++this->m_Scanner.m_pStatistics[this->m_Scanner.m_usCurrent].m_dwFalseDetectedNumber;
+  CSX1276_scanHop(this);
+  return true;
 }
 
+
+/*********************************************************************************************
+  Private methods (implementation)
+
+  Register shadow
+
+  The configuration registers are cached in 'm_usRegShadow' (see 'SX1276_SHADOW_CACHED_REGS'):
+   - A read of a valid cached register is served without SPI transaction
+   - A write of a cached register is deferred (i.e. register marked dirty) and is skipped if 
+     the register already has the written value
+   - The dirty registers are written before any other SPI access (i.e. order of operations
+     is kept) and at the end of each command or event processed by the automaton
+   - Writes to 'REG_OP_MODE' are never deferred (mode changes are immediate)
+*********************************************************************************************/
+
+// Registers which can be cached in shadow
+static const DWORD g_dwSX1276CachedRegs[SX1276_SHADOW_SIZE / 32] = SX1276_SHADOW_CACHED_REGS;
+
 /*****************************************************************************************//**
- * @fn         void CSX1276_clearFlags(CSX1276 *this)
+ * @fn         bool CSX1276_isCachedRegister(CSX1276 *this, BYTE address)
  * 
- * @brief      Clears the IRQ flags register.
+ * @brief      Indicates if a register is currently served by the register shadow.
  * 
- * @details    The function clears the interrupt request flags register.\n
- *             This function can be called even if SX1276 is not in 'Sleep' or 'StandBy' mode.
+ * @details    Configuration registers are cached only when the LoRa registers are mapped (i.e.
+ *             LoRa mode without access to FSK registers). The 'REG_OP_MODE' register is always
+ *             cached.
  *
  * @param      this
  *             The pointer to CSX1276 object.
  *  
- * @return     None.
+ * @param      address
+ *             Register address.
+ *  
+ * @return     The function returns 'true' if the register is cached.
 *********************************************************************************************/
-void CSX1276_clearFlags(CSX1276 *this)
+bool CSX1276_isCachedRegister(CSX1276 *this, BYTE address)
 {
-  BYTE st0;
-  register spi_device_handle_t SPIDeviceHandle = this->m_SpiDeviceHandle;
-
-  // Save current mode
-  st0 = CSX1276_readRegister(SPIDeviceHandle, REG_OP_MODE);    
-
-  if (st0 != LORA_STANDBY_MODE)
+  if ((address >= SX1276_SHADOW_SIZE) || 
+      ((g_dwSX1276CachedRegs[address / 32] & SX1276_SHADOW_FLAG_MASK(address)) == 0))
   {
-    // 'StandBy' mode to write in registers   
-    CSX1276_writeRegister(SPIDeviceHandle, REG_OP_MODE, LORA_STANDBY_MODE);  
+    return false;
   }
 
-  // Clear IRQ flags register
-  CSX1276_writeRegister(SPIDeviceHandle, REG_IRQ_FLAGS, 0xFF); 
-
-  if (st0 != LORA_STANDBY_MODE)
+  if (address == REG_OP_MODE)
   {
-    // Back to previous mode
-    CSX1276_writeRegister(SPIDeviceHandle, REG_OP_MODE, st0);
+    return true;
   }
 
-  #if (SX1276_DEBUG_LEVEL0)
-    DEBUG_PRINT_LN("## LoRa IRQ flags cleared ##");
-  #endif
+  // Current mode must be known and must be LoRa with LoRa registers page ('AccessSharedReg' = 0)
+  return (((this->m_dwRegValidFlags[0] & SX1276_SHADOW_FLAG_MASK(REG_OP_MODE)) != 0) &&
+          ((this->m_usRegShadow[REG_OP_MODE] & 0xC0) == 0x80));
 }
 
 
-
-/*********************************************************************************************
-  Private methods (implementation)
-
-  SX1276 configuration and management.
-
-  These functions are invoked by the main automaton.
-*********************************************************************************************/
-
 /*****************************************************************************************//**
- * @fn         uint8_t CSX1276_InitializeDevice(CSX1276 *this, BYTE SPISlaveID, 
- *                                              CLoraTransceiverItf_InitializeParams pParams)
+ * @fn         BYTE CSX1276_readRegister(CSX1276 *this, BYTE address)
  * 
- * @brief      Initializes the SX1276 device.
+ * @brief      Reads value in a specified register.
  * 
- * @details    The function establishes the SPI link to SX1276 device and configure the modem
- *             for the specified LoRa mode.\n
- *             On exit, the device is in 'StandBy' mode and ready for LoRa transmission (with
- *             LoRa MAC layer configured with default values for use on LoRaWAN public networks).
+ * @details    The value of a cached register is returned from the register shadow.\n
+ *             Otherwise the pending writes are done and the register is read on SPI bus.
  *
  * @param      this
  *             The pointer to CSX1276 object.
  *  
- * @param      pParams
- *             The method parameters. See 'LoraTransceiverItf.h' for details.
- *
- * @return     The function returns one of the following a result codes:
- *              - LORATRANSCEIVERITF_RESULT_SUCCESS = the SX1276 is ready
- *              - LORATRANSCEIVERITF_RESULT_NOTEXECUTED = the operation has not been executed
+ * @param      address
+ *             Register address to read from.
+ *  
+ * @return     The functions returns the content of the specified register.
 *********************************************************************************************/
-uint8_t CSX1276_InitializeDevice(CSX1276 *this, BYTE SPISlaveID, CLoraTransceiverItf_InitializeParams pParams)
+BYTE CSX1276_readRegister(CSX1276 *this, BYTE address)
 {
-  uint8_t resultCode;
-  
-  #if (SX1276_DEBUG_LEVEL0)
-    DEBUG_PRINT_CR;
-    DEBUG_PRINT_LN("Entering CSX1276_InitializeDevice");
-  #endif
-    
-  esp_err_t ret;
-
-  spi_bus_config_t buscfg = {.miso_io_num = PIN_NUM_MISO,
-                             .mosi_io_num = PIN_NUM_MOSI,
-                             .sclk_io_num = PIN_NUM_CLK,
-                             .quadwp_io_num = -1,
-                             .quadhd_io_num = -1,
-                             .max_transfer_sz = 512
-                            };
-
-  // TO DO : CS PIN according to SpiDeviceID
-  spi_device_interface_config_t devcfg = {.command_bits = 0,                        // Amount of bits in command phase (0-16)
-                                          .address_bits = 8,                        // Amount of bits in address phase (0-64)
-                                          .clock_speed_hz = 5*1000*1000,            // Clock out at 5 MHz (Note: NOK at 10 Mhz on breadboard)
-                                          .mode = 0,                                // SPI mode 0  (CPOL = 0, CPHA = 0)
-                                          .spics_io_num = PIN_NUM_CS,               // CS pin
-                                          .queue_size = 7,                          // We want to be able to queue 7 transactions at a time
-                                          .pre_cb = NULL,                           // Possible to have pre-transfer callback 
-                                          .post_cb = NULL,                          // Possible to have post-transfer callback 
-                                         };
-
-  // Initialize the SPI bus
-  ret = spi_bus_initialize(HSPI_HOST, &buscfg, 1);
-  assert(ret==ESP_OK);
-
-  // Attach the SX1276 to the SPI bus
-  ret = spi_bus_add_device(HSPI_HOST, &devcfg, &(this->m_SpiDeviceHandle));
-  assert(ret==ESP_OK);
-    
-  // RX calibration (just after SX1276 reset)
-  CSX1276_RxChainCalibration(this);
-
-  // Frequency used by RxChainCalibration must be changed by explicit configuration
-  this->m_usFreqChannel = SX1276_FREQ_CH_UNDEFINED;
+  BYTE value;
+  bool bCached = CSX1276_isCachedRegister(this, address);
 
-  // Set Maximum Over Current Protection
-  resultCode = CSX1276_setMaxCurrent(this, 0x1B);
-  
-  if (resultCode == LORATRANSCEIVERITF_RESULT_SUCCESS)
+  if (bCached && ((this->m_dwRegValidFlags[address / 32] & SX1276_SHADOW_FLAG_MASK(address)) != 0))
   {
-    #if (SX1276_DEBUG_LEVEL0)
-      DEBUG_PRINT_LN("Set LoRa mode with maximum current supply");
-    #endif
-
-    // This current (OCP) must be confirmed by explicit configuration
-    this->m_usOcpRate = SX1276_OCP_UNDEFINED;
-     
-    // Set LoRa in Standby (i.e. other SX1276 registers with reset value)
-    if ((resultCode = CSX1276_setLoRa(this)) == LORATRANSCEIVERITF_RESULT_SUCCESS)
-    {
-      // Set default 'SyncWord' for LoRaWAN public networks
-      resultCode = CSX1276_setSyncWord(this, LORATRANSCEIVERITF_SYNCWORD_PUBLIC);
-
-      if (resultCode == LORATRANSCEIVERITF_RESULT_SUCCESS)
-      {
-        // Set default 'Preamble Length' for LoRaWAN public networks
-        resultCode = CSX1276_setPreambleLength(this, LORATRANSCEIVERITF_PREAMBLE_LENGTH_LORA);
-      }
-     
-      if (resultCode == LORATRANSCEIVERITF_RESULT_SUCCESS)
-      {
-        // Set default 'Header ON' for LoRaWAN public networks
-        resultCode = CSX1276_setHeaderON(this);
-      }
-       
-      if (resultCode == LORATRANSCEIVERITF_RESULT_SUCCESS)
-      {
-        // Set default 'CRC ON' for LoRaWAN public networks
-        resultCode = CSX1276_setCRC_ON(this);
-      }
-
-      // Set GPIO for Interrupt Requests from SX1276
-      if (resultCode == LORATRANSCEIVERITF_RESULT_SUCCESS)
-      {
-        // PacketReceived and PacketSent IRQ
-        // Note: Same PIN used for both RX_DONE and TX_DONE IRQs (i.e. software configuration of DIO on Sx1276
-        //       according to OP mode) 
-        gpio_set_direction(PIN_NUM_RX_TX_IRQ, GPIO_MODE_INPUT);
-        gpio_set_pull_mode(PIN_NUM_RX_TX_IRQ, GPIO_PULLDOWN_ENABLE); //GPIO_FLOATING);
-        gpio_set_intr_type(PIN_NUM_RX_TX_IRQ, GPIO_INTR_POSEDGE);
-        gpio_intr_disable(PIN_NUM_RX_TX_IRQ); 
-
-        if (gpio_isr_handler_add(PIN_NUM_RX_TX_IRQ, (gpio_isr_t) CSX1276_PacketRxTxIntHandler, this) != ESP_OK)
-        {
-          resultCode = LORATRANSCEIVERITF_RESULT_ERROR;
-        }
-      }
+    ++this->m_dwSpiSavedNumber;
+    return this->m_usRegShadow[address];
+  }
 
-    }
+  CSX1276_flushRegisters(this);
 
+  value = CSX1276_spiReadRegister(this, address);
+  ++this->m_dwSpiTransactionNumber;
 
-   // DEBUG
-//   CSX1276_CPhamInit(this);
+  if (bCached)
+  {
+    this->m_usRegShadow[address] = value;
+    this->m_dwRegValidFlags[address / 32] |= SX1276_SHADOW_FLAG_MASK(address);
   }
-    
-  return resultCode;
+
+  return value;
 }
 
+
 /*****************************************************************************************//**
- * @fn         void CSX1276_RxChainCalibration(CSX1276 *this)
+ * @fn         void CSX1276_writeRegister(CSX1276 *this, BYTE address, BYTE data)
  * 
- * @brief      Performs the RX chain calibration for LF and HF bands.
+ * @brief      Writes a value in a specified register.
  * 
- * @details    The RX calibration is required for SX1276 device.\n
- *             This function MUST be called just after the reset so all registers are at 
- *             their default values. 
+ * @details    The write of a cached register is deferred (i.e. done by next SPI access or
+ *             by 'CSX1276_flushRegisters').\n
+ *             The write of 'REG_OP_MODE' is immediate and all registers are invalidated when
+ *             the 'LongRangeMode' bit is changed (i.e. FSK/OOK <-> LoRa).
  *
  * @param      this
  *             The pointer to CSX1276 object.
  *  
+ * @param      address
+ *             Register address to write to.
+ *  
+ * @param      data
+ *             Value to write in register.
+ *  
  * @return     None.
 *********************************************************************************************/
-void CSX1276_RxChainCalibration(CSX1276 *this)
+void CSX1276_writeRegister(CSX1276 *this, BYTE address, BYTE data)
 {
-  register spi_device_handle_t SPIDeviceHandle = this->m_SpiDeviceHandle;
+  bool bValid;
 
-  #if (SX1276_DEBUG_LEVEL0)
-    DEBUG_PRINT_LN("Starting SX1276 LF/HF calibration");
-  #endif
+  if (CSX1276_isCachedRegister(this, address) == true)
+  {
+    bValid = (this->m_dwRegValidFlags[address / 32] & SX1276_SHADOW_FLAG_MASK(address)) != 0;
 
-  // Cut the PA just in case, RFO output, power = -1 dBm
-  CSX1276_writeRegister(SPIDeviceHandle, REG_PA_CONFIG, 0x00);
+    if (bValid && (this->m_usRegShadow[address] == data))
+    {
+      // Register already has (or will have) this value
+      ++this->m_dwSpiSavedNumber;
+      return;
+    }
 
-  // Launch Rx chain calibration for LF band
-  CSX1276_writeRegister(SPIDeviceHandle, REG_IMAGE_CAL, (CSX1276_readRegister(SPIDeviceHandle, REG_IMAGE_CAL) & RF_IMAGECAL_IMAGECAL_MASK) | RF_IMAGECAL_IMAGECAL_START);
-  while((CSX1276_readRegister(SPIDeviceHandle, REG_IMAGE_CAL) & RF_IMAGECAL_IMAGECAL_RUNNING) == RF_IMAGECAL_IMAGECAL_RUNNING)
-  {
+    if (address != REG_OP_MODE)
+    {
+      // Deferred write (overwrite of a pending value saves one transaction)
+      if ((this->m_dwRegDirtyFlags[address / 32] & SX1276_SHADOW_FLAG_MASK(address)) != 0)
+      {
+        ++this->m_dwSpiSavedNumber;
+      }
+      this->m_usRegShadow[address] = data;
+      this->m_dwRegValidFlags[address / 32] |= SX1276_SHADOW_FLAG_MASK(address);
+      this->m_dwRegDirtyFlags[address / 32] |= SX1276_SHADOW_FLAG_MASK(address);
+      return;
+    }
+
+    // Mode change: pending writes done in previous mode
+    CSX1276_flushRegisters(this);
+
+    if (bValid && (((this->m_usRegShadow[REG_OP_MODE] ^ data) & 0x80) != 0))
+    {
+      // Registers are reset when 'LongRangeMode' is changed
+      CSX1276_invalidateRegisters(this);
+    }
+
+    CSX1276_spiWriteRegister(this, address, data);
+    ++this->m_dwSpiTransactionNumber;
+
+    this->m_usRegShadow[REG_OP_MODE] = data;
+    this->m_dwRegValidFlags[0] |= SX1276_SHADOW_FLAG_MASK(REG_OP_MODE);
+    return;
   }
 
-  // Sets a Frequency in HF band
-  CSX1276_setChannel(this, LORATRANSCEIVERITF_FREQUENCY_CHANNEL_17);
+  CSX1276_flushRegisters(this);
 
-  // Launch Rx chain calibration for HF band
-  CSX1276_writeRegister(SPIDeviceHandle, REG_IMAGE_CAL, (CSX1276_readRegister(SPIDeviceHandle, REG_IMAGE_CAL) & RF_IMAGECAL_IMAGECAL_MASK) | RF_IMAGECAL_IMAGECAL_START);
-  while((CSX1276_readRegister(SPIDeviceHandle, REG_IMAGE_CAL) & RF_IMAGECAL_IMAGECAL_RUNNING) == RF_IMAGECAL_IMAGECAL_RUNNING)
+  CSX1276_spiWriteRegister(this, address, data);
+  ++this->m_dwSpiTransactionNumber;
+
+  // Registers common to LoRa and FSK pages may be written while shadow is not used
+  if (address < SX1276_SHADOW_SIZE)
   {
+    this->m_dwRegValidFlags[address / 32] &= ~SX1276_SHADOW_FLAG_MASK(address);
   }
-
-  #if (SX1276_DEBUG_LEVEL0)
-    DEBUG_PRINT_LN("[OK] SX1276 LF/HF calibration");
-  #endif
 }
 
+
 /*****************************************************************************************//**
- * @fn         uint8_t CSX1276_setLoRa(CSX1276 *this)
+ * @fn         void CSX1276_readBurst(CSX1276 *this, BYTE address, BYTE *pBuffer, WORD wLength)
  * 
- * @brief      Sets the SX1276 in LoRa radio mode.
+ * @brief      Reads a sequence of bytes from a non cached register (typically 'REG_FIFO').
  * 
- * @details    The function sets the modem for LoRa mode and activates the 'StandBy' mode.
+ * @details    The pending writes are done before the burst read.
  *
  * @param      this
  *             The pointer to CSX1276 object.
  *  
- * @return     The function returns one of the following a result codes:
- *              - LORATRANSCEIVERITF_RESULT_SUCCESS = the SX1276 is set in LoRa 'StandBy' mode
- *              - LORATRANSCEIVERITF_RESULT_NOTEXECUTED = the operation has not been executed
+ * @param      address
+ *             Register address to read from.
+ *  
+ * @param      pBuffer
+ *             Buffer receiving the bytes.
+ *  
+ * @param      wLength
+ *             Number of bytes to read.
+ *  
+ * @return     None.
 *********************************************************************************************/
-uint8_t CSX1276_setLoRa(CSX1276 *this)
+void CSX1276_readBurst(CSX1276 *this, BYTE address, BYTE *pBuffer, WORD wLength)
 {
-  uint8_t resultCode = LORATRANSCEIVERITF_RESULT_NOTEXECUTED;
-  BYTE st0;
-  register spi_device_handle_t SPIDeviceHandle = this->m_SpiDeviceHandle;
-
-  #if (SX1276_DEBUG_LEVEL0)
-    DEBUG_PRINT_CR;
-    DEBUG_PRINT_LN("Starting 'setLORA'");
-  #endif
+  CSX1276_flushRegisters(this);
 
-  CSX1276_writeRegister(SPIDeviceHandle, REG_OP_MODE, FSK_SLEEP_MODE);     // Sleep mode (mandatory to set LoRa mode)
-  CSX1276_writeRegister(SPIDeviceHandle, REG_OP_MODE, LORA_SLEEP_MODE);    // LoRa sleep mode
-  CSX1276_writeRegister(SPIDeviceHandle, REG_OP_MODE, LORA_STANDBY_MODE);  // LoRa standby mode
+  CSX1276_spiReadBurst(this, address, pBuffer, wLength);
+  ++this->m_dwSpiTransactionNumber;
+}
 
-  CSX1276_writeRegister(SPIDeviceHandle, REG_MAX_PAYLOAD_LENGTH, LORA_MAX_PAYLOAD_LENGTH);
-    
-  // Set RegModemConfig1 to Default values
-  CSX1276_writeRegister(SPIDeviceHandle, REG_MODEM_CONFIG1, 0x08); 
-  // Set RegModemConfig2 to Default values
-  CSX1276_writeRegister(SPIDeviceHandle, REG_MODEM_CONFIG2, 0x74);   
 
-  // Delay 100ms
-  vTaskDelay(pdMS_TO_TICKS(100));
+/*****************************************************************************************//**
+ * @fn         void CSX1276_writeBurst(CSX1276 *this, BYTE address, BYTE *pBuffer, WORD wLength)
+ * 
+ * @brief      Writes a sequence of bytes to a non cached register (typically 'REG_FIFO').
+ * 
+ * @details    The pending writes are done before the burst write.
+ *
+ * @param      this
+ *             The pointer to CSX1276 object.
+ *  
+ * @param      address
+ *             Register address to write to.
+ *  
+ * @param      pBuffer
+ *             Bytes to write.
+ *  
+ * @param      wLength
+ *             Number of bytes to write.
+ *  
+ * @return     None.
+*********************************************************************************************/
+void CSX1276_writeBurst(CSX1276 *this, BYTE address, BYTE *pBuffer, WORD wLength)
+{
+  CSX1276_flushRegisters(this);
 
-  st0 = CSX1276_readRegister(SPIDeviceHandle, REG_OP_MODE);  // Reading config mode
-  if (st0 == LORA_STANDBY_MODE)
-  { 
-    // LoRa mode
-    this->m_usModemMode = MODEM_MODE_LORA;
-    resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
-    #if (SX1276_DEBUG_LEVEL0)
-      DEBUG_PRINT_LN("[OK] LoRa mode set");
-      DEBUG_PRINT_CR;
-    #endif
-  }
-  return resultCode;
+  CSX1276_spiWriteBurst(this, address, pBuffer, wLength);
+  ++this->m_dwSpiTransactionNumber;
 }
 
+
 /*****************************************************************************************//**
- * @fn         uint8_t CSX1276_setLoRaMode(CSX1276 *this, uint8_t LoraMode)
+ * @fn         void CSX1276_flushRegisters(CSX1276 *this)
  * 
- * @brief      Sets the SX1276 in a specified LoRa mode.
+ * @brief      Writes the dirty registers of the register shadow.
  * 
- * @details    The function sets the modem to LoRa radio mode and configure the specified
- *             bandwith, coding rate and spreading factor of the LoRa modulation.\n
- *             On exit the modem is in 'StandBy' mode.
+ * @details    Contiguous dirty registers are written with one SPI burst (the SX1276 address 
+ *             pointer is incremented for each byte of a burst access).
  *
  * @param      this
  *             The pointer to CSX1276 object.
  *  
- * @param      LoraMode
- *             The LoRa mode number as defined by 'LORATRANSCEIVERITF_LORAMODE_xxx' constants
- *             (see 'LoraTransceiverItf.h' for details).
- *  
- * @return     The function returns one of the following a result codes:
- *              - LORATRANSCEIVERITF_RESULT_SUCCESS = the SX1276 is set in LoRa 'StandBy' mode
- *              - LORATRANSCEIVERITF_RESULT_ERROR = error during configuration
- *              - LORATRANSCEIVERITF_RESULT_INVALIDPARAMS = invalid value of specified LoraMode
- *              - LORATRANSCEIVERITF_RESULT_NOTEXECUTED = the operation has not been executed
+ * @return     None.
 *********************************************************************************************/
-uint8_t CSX1276_setLoRaMode(CSX1276 *this, uint8_t LoraMode)
+void CSX1276_flushRegisters(CSX1276 *this)
 {
-  uint8_t resultCode = LORATRANSCEIVERITF_RESULT_NOTEXECUTED;
-  BYTE st0;
-  BYTE config1 = 0x00;
-  BYTE config2 = 0x00;
-  register spi_device_handle_t SPIDeviceHandle = this->m_SpiDeviceHandle;
-
-  #if (SX1276_DEBUG_LEVEL0)
-    DEBUG_PRINT_CR;
-    DEBUG_PRINT_LN("Entering 'setLoraMode'");
-  #endif
+  // Burst data copied in aligned buffer (SPI DMA)
+  DWORD dwBurstBuffer[SX1276_SHADOW_SIZE / 4];
+  WORD wAddress;
+  WORD wStart;
+  WORD wIndex;
 
-  // 'SetMode' function only can be called in LoRa mode
-  if (this->m_usModemMode != MODEM_MODE_LORA)
+  for (wIndex = 0; wIndex < SX1276_SHADOW_SIZE / 32; wIndex++)
   {
-    if ((resultCode = CSX1276_setLoRa(this)) != LORATRANSCEIVERITF_RESULT_SUCCESS)
+    if (this->m_dwRegDirtyFlags[wIndex] != 0)
     {
-      return resultCode;
+      break;
     }
-    resultCode = LORATRANSCEIVERITF_RESULT_NOTEXECUTED;
   }
-  
-  // Save the current OP mode
-  st0 = CSX1276_readRegister(SPIDeviceHandle, REG_OP_MODE);    
-
-  // LoRa standby mode
-  if (st0 != LORA_STANDBY_MODE)
+  if (wIndex == SX1276_SHADOW_SIZE / 32)
   {
-    CSX1276_writeRegister(SPIDeviceHandle, REG_OP_MODE, LORA_STANDBY_MODE);  
+    return;
   }
 
-  switch (LoraMode)
+  for (wAddress = 0; wAddress < SX1276_SHADOW_SIZE; wAddress++)
   {
-    // Mode 1 (better reach, medium time on air)
-    case LORATRANSCEIVERITF_LORAMODE_1:   
-      CSX1276_setCR(this, LORATRANSCEIVERITF_CR_5);      // CR = 4/5
-      CSX1276_setSF(this, LORATRANSCEIVERITF_SF_12);     // SF = 12
-      CSX1276_setBW(this, LORATRANSCEIVERITF_BANDWIDTH_125);    // BW = 125 KHz
-      break;
+    if ((this->m_dwRegDirtyFlags[wAddress / 32] & SX1276_SHADOW_FLAG_MASK(wAddress)) == 0)
+    {
+      continue;
+    }
 
-    // Mode 2 (medium reach, less time on air)
-    case LORATRANSCEIVERITF_LORAMODE_2:   
-      CSX1276_setCR(this, LORATRANSCEIVERITF_CR_5);      // CR = 4/5
-      CSX1276_setSF(this, LORATRANSCEIVERITF_SF_12);     // SF = 12
-      CSX1276_setBW(this, LORATRANSCEIVERITF_BANDWIDTH_250);    // BW = 250 KHz
-      break;
+    wStart = wAddress;
+    while (((wAddress + 1) < SX1276_SHADOW_SIZE) &&
+           ((this->m_dwRegDirtyFlags[(wAddress + 1) / 32] & SX1276_SHADOW_FLAG_MASK(wAddress + 1)) != 0))
+    {
+      ++wAddress;
+    }
 
-    // Mode 3 (worst reach, less time on air)
-    case LORATRANSCEIVERITF_LORAMODE_3: 
-      CSX1276_setCR(this, LORATRANSCEIVERITF_CR_5);      // CR = 4/5
-      CSX1276_setSF(this, LORATRANSCEIVERITF_SF_10);     // SF = 10
-      CSX1276_setBW(this, LORATRANSCEIVERITF_BANDWIDTH_125);    // BW = 125 KHz
-      break;
+    if (wAddress == wStart)
+    {
+      CSX1276_spiWriteRegister(this, (BYTE) wStart, this->m_usRegShadow[wStart]);
+    }
+    else
+    {
+      memcpy(dwBurstBuffer, &(this->m_usRegShadow[wStart]), wAddress - wStart + 1);
+      CSX1276_spiWriteBurst(this, (BYTE) wStart, (BYTE *) dwBurstBuffer, wAddress - wStart + 1);
+      this->m_dwSpiSavedNumber += wAddress - wStart;
+    }
+    ++this->m_dwSpiTransactionNumber;
+  }
 
-    // Mode 4 (better reach, low time on air)
-    case LORATRANSCEIVERITF_LORAMODE_4:
-      CSX1276_setCR(this, LORATRANSCEIVERITF_CR_5);      // CR = 4/5
-      CSX1276_setSF(this, LORATRANSCEIVERITF_SF_12);     // SF = 12
-      CSX1276_setBW(this, LORATRANSCEIVERITF_BANDWIDTH_500);    // BW = 500 KHz
-      break;
+  memset(this->m_dwRegDirtyFlags, 0, sizeof(this->m_dwRegDirtyFlags));
+}
 
-    // Mode 5 (better reach, medium time on air)
-    case LORATRANSCEIVERITF_LORAMODE_5:
-      CSX1276_setCR(this, LORATRANSCEIVERITF_CR_5);      // CR = 4/5
-      CSX1276_setSF(this, LORATRANSCEIVERITF_SF_10);     // SF = 10
-      CSX1276_setBW(this, LORATRANSCEIVERITF_BANDWIDTH_250);    // BW = 250 KHz
-      break;
 
-    // Mode 6 (better reach, worst time-on-air)
-    case LORATRANSCEIVERITF_LORAMODE_6:
-      CSX1276_setCR(this, LORATRANSCEIVERITF_CR_5);      // CR = 4/5
-      CSX1276_setSF(this, LORATRANSCEIVERITF_SF_11);     // SF = 11
-      CSX1276_setBW(this, LORATRANSCEIVERITF_BANDWIDTH_500);    // BW = 500 KHz
-      break;
+/*****************************************************************************************//**
+ * @fn         void CSX1276_invalidateRegisters(CSX1276 *this)
+ * 
+ * @brief      Invalidates all registers of the register shadow.
+ * 
+ * @details    The function must be called when the content of SX1276 registers is unknown
+ *             (i.e. reset, modem change).\n
+ *             The pending writes are discarded.
+ *
+ * @param      this
+ *             The pointer to CSX1276 object.
+ *  
+ * @return     None.
+*********************************************************************************************/
+void CSX1276_invalidateRegisters(CSX1276 *this)
+{
+  memset(this->m_dwRegValidFlags, 0, sizeof(this->m_dwRegValidFlags));
+  memset(this->m_dwRegDirtyFlags, 0, sizeof(this->m_dwRegDirtyFlags));
+}
 
-    // Mode 7 (medium-high reach, medium-low time-on-air)
-    case LORATRANSCEIVERITF_LORAMODE_7: 
-      CSX1276_setCR(this, LORATRANSCEIVERITF_CR_5);      // CR = 4/5
-      CSX1276_setSF(this, LORATRANSCEIVERITF_SF_9);      // SF = 9
-      CSX1276_setBW(this, LORATRANSCEIVERITF_BANDWIDTH_250);    // BW = 250 KHz
-      break;
 
-    // Mode 8 (medium reach, medium time-on-air)
-    case LORATRANSCEIVERITF_LORAMODE_8:
-      CSX1276_setCR(this, LORATRANSCEIVERITF_CR_5);      // CR = 4/5
-      CSX1276_setSF(this, LORATRANSCEIVERITF_SF_9);      // SF = 9
-      CSX1276_setBW(this, LORATRANSCEIVERITF_BANDWIDTH_500);    // BW = 500 KHz
-      break;
+/*********************************************************************************************
+  Private methods (implementation)
 
-    // Mode 9 (medium-low reach, medium-high time-on-air)
-    case LORATRANSCEIVERITF_LORAMODE_9:
-      CSX1276_setCR(this, LORATRANSCEIVERITF_CR_5);      // CR = 4/5
-      CSX1276_setSF(this, LORATRANSCEIVERITF_SF_8);      // SF = 8
-      CSX1276_setBW(this, LORATRANSCEIVERITF_BANDWIDTH_500);    // BW = 500 KHz
-      break;
+  Shared SPI bus
 
-    // Mode 10 (worst reach, less time_on_air)
-    case LORATRANSCEIVERITF_LORAMODE_10:
-      CSX1276_setCR(this, LORATRANSCEIVERITF_CR_5);      // CR = 4/5
-      CSX1276_setSF(this, LORATRANSCEIVERITF_SF_7);      // SF = 7
-      CSX1276_setBW(this, LORATRANSCEIVERITF_BANDWIDTH_500);    // BW = 500 KHz
-      break;
+  Several SX1276 are attached to the same SPI bus (see 'CSX1276SpiBusOb'):
+   - The bus is owned for one SPI transaction or one batch of pipelined transactions
+   - The SX1276 with a received packet to read have priority (i.e. the accesses of other SX1276
+     are deferred until the 'PACKET_RECEIVED' event is processed)
+*********************************************************************************************/
 
-    // test for LoRaWAN channel
-    case LORATRANSCEIVERITF_LORAMODE_11:
-    	CSX1276_setCR(this, LORATRANSCEIVERITF_CR_5);        // CR = 4/5
-    	CSX1276_setSF(this, LORATRANSCEIVERITF_SF_12);       // SF = 12
-    	CSX1276_setBW(this, LORATRANSCEIVERITF_BANDWIDTH_125);      // BW = 125 KHz
-      break;
+/*****************************************************************************************//**
+ * @fn         void CSX1276_busAcquire(CSX1276 *this)
+ * 
+ * @brief      Takes the ownership of the shared SPI bus.
+ * 
+ * @details    The function waits until the bus is free.\n
+ *             If another SX1276 has a received packet to read, the ownership is released and
+ *             the access is deferred (i.e. RX servicing before configuration traffic).
+ *
+ * @param      this
+ *             The pointer to CSX1276 object.
+ *  
+ * @return     None.
+*********************************************************************************************/
+void CSX1276_busAcquire(CSX1276 *this)
+{
+  // Bus not shared (i.e. no 'Initialize' command processed)
+  if (g_SX1276SpiBusOb.m_hMutex == NULL)
+  {
+    return;
+  }
 
-    default:
-      resultCode = LORATRANSCEIVERITF_RESULT_INVALIDPARAMS; 
-  };
+  while (true)
+  {
+    xSemaphoreTake(g_SX1276SpiBusOb.m_hMutex, portMAX_DELAY);
+
+    // Received packet of this SX1276 is counted in 'm_dwRxPendingNumber'
+    if ((__atomic_load_n(&(g_SX1276SpiBusOb.m_dwRxPendingNumber), __ATOMIC_ACQUIRE) == 0) ||
+        __atomic_load_n(&(this->m_bRxPending), __ATOMIC_ACQUIRE))
+    {
+      return;
+    }
 
+    // Let the automaton of SX1276 with received packet use the bus
+    xSemaphoreGive(g_SX1276SpiBusOb.m_hMutex);
+    ++this->m_dwSpiDeferredNumber;
+    taskYIELD();
+  }
+}
 
-  // Check proper register configuration
-  if (resultCode == LORATRANSCEIVERITF_RESULT_INVALIDPARAMS)
+
+// Releases the ownership of the shared SPI bus
+void CSX1276_busRelease(CSX1276 *this)
+{
+  if (g_SX1276SpiBusOb.m_hMutex != NULL)
   {
-    // Don't change resultCode value
-    #if (SX1276_DEBUG_LEVEL0)
-      DEBUG_PRINT("** The indicated mode doesn't exist, ");
-      DEBUG_PRINT_LN("please select from 1 to 10 **");
-    #endif
+    xSemaphoreGive(g_SX1276SpiBusOb.m_hMutex);
   }
-  else
-  {
-    resultCode = LORATRANSCEIVERITF_RESULT_ERROR;
-    config1 = CSX1276_readRegister(SPIDeviceHandle, REG_MODEM_CONFIG1);
-    switch (LoraMode)
-    { 
-      //  Different way to check for each mode:
-      // (config1 >> 1) ---> take out bits 7-1 from REG_MODEM_CONFIG1 (=_bandwidth & _codingRate together)
-      // (config2 >> 4) ---> take out bits 7-4 from REG_MODEM_CONFIG2 (=_spreadingFactor)
+}
 
-      // mode 1: BW = 125 KHz, CR = 4/5, SF = 12.
-      case LORATRANSCEIVERITF_LORAMODE_1:  
-        if ((config1 >> 1) == 0x39)
-        { 
-          config2 = CSX1276_readRegister(SPIDeviceHandle, REG_MODEM_CONFIG2);
-          if ((config2 >> 4) == LORATRANSCEIVERITF_SF_12)
-          {
-            resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
-          }
-        }
-        break;
 
-      // mode 2: BW = 250 KHz, CR = 4/5, SF = 12.
-      case LORATRANSCEIVERITF_LORAMODE_2:  
-        if ((config1 >> 1) == 0x41)
-        {
-          config2 = CSX1276_readRegister(SPIDeviceHandle, REG_MODEM_CONFIG2);
-          if ((config2 >> 4) == LORATRANSCEIVERITF_SF_12)
-          {
-            resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
-          }
-        }
-        break;
+/*********************************************************************************************
+  Private methods (implementation)
 
-      // mode 3: BW = 125 KHz, CR = 4/5, SF = 10.
-      case LORATRANSCEIVERITF_LORAMODE_3:  
-        if ((config1 >> 1) == 0x39)
-        {
-          config2 = CSX1276_readRegister(SPIDeviceHandle, REG_MODEM_CONFIG2);
-          if ((config2 >> 4) == LORATRANSCEIVERITF_SF_10)
-          {
-            resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
-          }
-        }
-        break;
+  Pipelined SPI transactions
 
-      // mode 4: BW = 500 KHz, CR = 4/5, SF = 12.
-      case LORATRANSCEIVERITF_LORAMODE_4:  
-        if ((config1 >> 1) == 0x49)
-        { 
-          config2 = CSX1276_readRegister(SPIDeviceHandle, REG_MODEM_CONFIG2);
-          if ((config2 >> 4) == LORATRANSCEIVERITF_SF_12)
-          {
-            resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
-          }
-        }
-        break;
+  A sequence of independent register accesses is queued in the SPI driver as a batch (see
+  'CSX1276SpiBatchOb') and the results are collected once for the whole sequence:
+   - The batch begins with the write of dirty registers (i.e. order of operations is kept)
+   - Registers written in the batch update the register shadow
+   - Registers read in the batch are never stored in the register shadow
+   - The batch is automatically collected when the SPI transaction queue is full or before a
+     non pipelined SPI access
+*********************************************************************************************/
+
+/*****************************************************************************************//**
+ * @fn         void CSX1276_batchBegin(CSX1276 *this)
+ * 
+ * @brief      Starts a batch of pipelined SPI transactions.
+ * 
+ * @details    The pending writes of the register shadow are done before the batch.
+ *
+ * @param      this
+ *             The pointer to CSX1276 object.
+ *  
+ * @return     None.
+*********************************************************************************************/
+void CSX1276_batchBegin(CSX1276 *this)
+{
+  if (this->m_SpiBatch.m_usCount != 0)
+  {
+    CSX1276_batchWait(this);
+  }
+  CSX1276_flushRegisters(this);
+}
+
+
+/*****************************************************************************************//**
+ * @fn         void CSX1276_batchQueue(CSX1276 *this, spi_transaction_t *pTrans)
+ * 
+ * @brief      Adds a transaction to the current batch.
+ * 
+ * @details    The transaction is copied in the batch and queued in the SPI driver.\n
+ *             If the SPI transaction queue is full, the current batch is collected first.
+ *
+ * @param      this
+ *             The pointer to CSX1276 object.
+ *  
+ * @param      pTrans
+ *             The transaction to queue.
+ *  
+ * @return     None.
+*********************************************************************************************/
+void CSX1276_batchQueue(CSX1276 *this, spi_transaction_t *pTrans)
+{
+  spi_transaction_t *pQueuedTrans;
+
+  if (this->m_SpiBatch.m_usCount == SX1276_SPI_QUEUE_SIZE)
+  {
+    CSX1276_batchWait(this);
+  }
+
+  // Shared bus owned until the batch is collected
+  if (this->m_SpiBatch.m_usCount == 0)
+  {
+    CSX1276_busAcquire(this);
+  }
+
+  pQueuedTrans = &(this->m_SpiBatch.m_Trans[this->m_SpiBatch.m_usCount++]);
+  memcpy(pQueuedTrans, pTrans, sizeof(spi_transaction_t));
+
+  esp_err_t ret = this->m_pSpiBackend->m_pQueueTrans(this->m_SpiDeviceHandle, pQueuedTrans, portMAX_DELAY);
+  assert(ret == ESP_OK);
+  ++this->m_dwSpiTransactionNumber;
+
+  #if (SX1276_DEBUG_LEVEL2)
+    DEBUG_PRINT("CSX1276_batchQueue, register: ");
+    DEBUG_PRINT_HEX((DWORD) (pTrans->addr & 0x7F));
+    DEBUG_PRINT(", depth: ");
+    DEBUG_PRINT_DEC(this->m_SpiBatch.m_usCount);
+    DEBUG_PRINT_CR;
+  #endif
+}
+
+
+/*****************************************************************************************//**
+ * @fn         void CSX1276_batchWait(CSX1276 *this)
+ * 
+ * @brief      Waits for the completion of all transactions of the current batch.
+ * 
+ * @details    The values of registers read in the batch are copied to the locations specified
+ *             by 'CSX1276_batchReadRegister'.\n
+ *             The shared SPI bus is released.
+ *
+ * @param      this
+ *             The pointer to CSX1276 object.
+ *  
+ * @return     None.
+*********************************************************************************************/
+void CSX1276_batchWait(CSX1276 *this)
+{
+  spi_transaction_t *pTrans;
+
+  if (this->m_SpiBatch.m_usCount == 0)
+  {
+    return;
+  }
+
+  for (BYTE i = 0; i < this->m_SpiBatch.m_usCount; i++)
+  {
+    esp_err_t ret = this->m_pSpiBackend->m_pGetTransResult(this->m_SpiDeviceHandle, &pTrans, portMAX_DELAY);
+    assert(ret == ESP_OK);
+
+    if (((pTrans->flags & SPI_TRANS_USE_RXDATA) != 0) && (pTrans->user != NULL))
+    {
+      *((BYTE *) pTrans->user) = (BYTE) (*(uint32_t*)pTrans->rx_data);
+    }
+  }
+
+  this->m_SpiBatch.m_usCount = 0;
+  ++this->m_dwSpiBatchNumber;
+
+  CSX1276_busRelease(this);
+}
+
+
+/*****************************************************************************************//**
+ * @fn         void CSX1276_batchReadRegister(CSX1276 *this, BYTE address, BYTE *pusValue)
+ * 
+ * @brief      Adds the read of a register to the current batch.
+ * 
+ * @details    The value of a valid cached register is immediately returned from the register
+ *             shadow (i.e. no SPI transaction).
+ *
+ * @param      this
+ *             The pointer to CSX1276 object.
+ *  
+ * @param      address
+ *             Register address to read from.
+ *  
+ * @param      pusValue
+ *             The location receiving the register value (valid after 'CSX1276_batchWait').
+ *  
+ * @return     None.
+*********************************************************************************************/
+void CSX1276_batchReadRegister(CSX1276 *this, BYTE address, BYTE *pusValue)
+{
+  spi_transaction_t t;
+
+  if (CSX1276_isCachedRegister(this, address) && 
+      ((this->m_dwRegValidFlags[address / 32] & SX1276_SHADOW_FLAG_MASK(address)) != 0))
+  {
+    *pusValue = this->m_usRegShadow[address];
+    ++this->m_dwSpiSavedNumber;
+    return;
+  }
+
+  memset(&t, 0, sizeof(t));       
+  bitClear(address, 7);   
+  t.addr = (uint64_t) address;
+  t.flags = SPI_TRANS_USE_RXDATA;
+  t.length = 8;                     
+  t.user = pusValue;
+
+  CSX1276_batchQueue(this, &t);
+}
+
+
+/*****************************************************************************************//**
+ * @fn         void CSX1276_batchWriteRegister(CSX1276 *this, BYTE address, BYTE data)
+ * 
+ * @brief      Adds the write of a register to the current batch.
+ * 
+ * @details    The write of a cached register is skipped if the register already has the 
+ *             value. Otherwise the register shadow is updated (as for 'CSX1276_writeRegister').
+ *
+ * @param      this
+ *             The pointer to CSX1276 object.
+ *  
+ * @param      address
+ *             Register address to write to.
+ *  
+ * @param      data
+ *             Value to write in register.
+ *  
+ * @return     None.
+*********************************************************************************************/
+void CSX1276_batchWriteRegister(CSX1276 *this, BYTE address, BYTE data)
+{
+  spi_transaction_t t;
+  bool bValid;
+
+  if (CSX1276_isCachedRegister(this, address) == true)
+  {
+    bValid = (this->m_dwRegValidFlags[address / 32] & SX1276_SHADOW_FLAG_MASK(address)) != 0;
+
+    if (bValid && (this->m_usRegShadow[address] == data))
+    {
+      ++this->m_dwSpiSavedNumber;
+      return;
+    }
+
+    if ((address == REG_OP_MODE) && bValid && (((this->m_usRegShadow[REG_OP_MODE] ^ data) & 0x80) != 0))
+    {
+      // Registers are reset when 'LongRangeMode' is changed
+      CSX1276_invalidateRegisters(this);
+    }
+
+    this->m_usRegShadow[address] = data;
+    this->m_dwRegValidFlags[address / 32] |= SX1276_SHADOW_FLAG_MASK(address);
+  }
+  else if (address < SX1276_SHADOW_SIZE)
+  {
+    this->m_dwRegValidFlags[address / 32] &= ~SX1276_SHADOW_FLAG_MASK(address);
+  }
+
+  memset(&t, 0, sizeof(t));       
+  bitSet(address, 7);        
+  t.addr = (uint64_t) address;
+  t.tx_data[0] = data;
+  t.flags = SPI_TRANS_USE_TXDATA;
+  t.length = 8;                     
+
+  CSX1276_batchQueue(this, &t);
+}
+
+
+/*****************************************************************************************//**
+ * @fn         void CSX1276_batchReadBurst(CSX1276 *this, BYTE address, BYTE *pBuffer, 
+ *                                         WORD wLength)
+ * 
+ * @brief      Adds a burst read of a non cached register (typically 'REG_FIFO') to the batch.
+ * 
+ * @param      this
+ *             The pointer to CSX1276 object.
+ *  
+ * @param      address
+ *             Register address to read from.
+ *  
+ * @param      pBuffer
+ *             Buffer receiving the bytes (valid after 'CSX1276_batchWait').
+ *  
+ * @param      wLength
+ *             Number of bytes to read.
+ *  
+ * @return     None.
+*********************************************************************************************/
+void CSX1276_batchReadBurst(CSX1276 *this, BYTE address, BYTE *pBuffer, WORD wLength)
+{
+  spi_transaction_t t;
+
+  if (wLength == 0)
+  {
+    return;
+  }
+
+  memset(&t, 0, sizeof(t));       
+  bitClear(address, 7);   
+  t.addr = (uint64_t) address;
+  t.rx_buffer = pBuffer;
+  t.length = 8 * (size_t) wLength;
+  t.rxlength = t.length;
+
+  CSX1276_batchQueue(this, &t);
+}
+
+
+/*****************************************************************************************//**
+ * @fn         void CSX1276_batchWriteBurst(CSX1276 *this, BYTE address, BYTE *pBuffer, 
+ *                                          WORD wLength)
+ * 
+ * @brief      Adds a burst write of a non cached register (typically 'REG_FIFO') to the batch.
+ * 
+ * @param      this
+ *             The pointer to CSX1276 object.
+ *  
+ * @param      address
+ *             Register address to write to.
+ *  
+ * @param      pBuffer
+ *             Bytes to write (must not be modified before 'CSX1276_batchWait').
+ *  
+ * @param      wLength
+ *             Number of bytes to write.
+ *  
+ * @return     None.
+*********************************************************************************************/
+void CSX1276_batchWriteBurst(CSX1276 *this, BYTE address, BYTE *pBuffer, WORD wLength)
+{
+  spi_transaction_t t;
+
+  if (wLength == 0)
+  {
+    return;
+  }
+
+  memset(&t, 0, sizeof(t));       
+  bitSet(address, 7);        
+  t.addr = (uint64_t) address;
+  t.tx_buffer = pBuffer;
+  t.length = 8 * (size_t) wLength;
+
+  CSX1276_batchQueue(this, &t);
+}
+
+
+/*****************************************************************************************//**
+ * @fn         void CSX1276_batchClearFlags(CSX1276 *this)
+ * 
+ * @brief      Adds the clear of IRQ flags register to the current batch.
+ * 
+ * @details    The SX1276 is set in 'StandBy' mode for the write and the previous mode is
+ *             restored (see 'CSX1276_clearFlags').
+ *
+ * @param      this
+ *             The pointer to CSX1276 object.
+ *  
+ * @return     None.
+*********************************************************************************************/
+void CSX1276_batchClearFlags(CSX1276 *this)
+{
+  BYTE st0;
+
+  // Save current mode
+  // Note: Mode in register shadow when known (i.e. no wait for batch completion)
+  st0 = CSX1276_readRegister(this, REG_OP_MODE);    
+
+  if (st0 != LORA_STANDBY_MODE)
+  {
+    CSX1276_batchWriteRegister(this, REG_OP_MODE, LORA_STANDBY_MODE);  
+  }
+
+  CSX1276_batchWriteRegister(this, REG_IRQ_FLAGS, 0xFF); 
+
+  if (st0 != LORA_STANDBY_MODE)
+  {
+    CSX1276_batchWriteRegister(this, REG_OP_MODE, st0);
+  }
+}
+
+
+/*********************************************************************************************
+  Private methods (implementation)
+
+  Access to SX1276 registers
+
+  LoRa Configuration registers are accessed through the SPI interface. 
+  Registers are readable in all device modes including Sleep. However, they should be written 
+  only in 'Sleep' and 'StandBy' modes.
+*********************************************************************************************/
+
+/*****************************************************************************************//**
+ * @fn         BYTE CSX1276_spiReadRegister(CSX1276 *this, BYTE address)
+ * 
+ * @brief      Reads value in a specified register.
+ * 
+ * @details    The function retrieves the byte value stored in the specified register.
+ *
+ * @param      this
+ *             The pointer to CSX1276 object.
+ *  
+ * @param      address
+ *             Register address to read from.
+ *  
+ * @return     The functions returns the content of the specified register.
+*********************************************************************************************/
+BYTE CSX1276_spiReadRegister(CSX1276 *this, BYTE address)
+{
+  BYTE value = 0x00;
+
+  #if (SX1276_DEBUG_LEVEL2)
+    DEBUG_PRINT_CR;
+    DEBUG_PRINT("CSX1276_spiReadRegister, dev: ");
+    DEBUG_PRINT_PTR(this->m_SpiDeviceHandle);
+    DEBUG_PRINT_CR;
+  #endif
+
+  spi_transaction_t t;
+
+  // Zero out the transaction
+  memset(&t, 0, sizeof(t));       
+
+  // Bit 7 cleared to read from registers
+  bitClear(address, 7);   
+  t.addr = (uint64_t) address;
+
+  // Use transaction RX buffer (declared as 4 bytes array)
+  t.flags = SPI_TRANS_USE_RXDATA;
+
+  // 8 bits of data to receive
+  t.length = 8;                     
+
+  // Pipelined transactions collected first (i.e. SPI driver returns results in order)
+  CSX1276_batchWait(this);
+
+  // Start transaction on shared bus and wait until completed
+  CSX1276_busAcquire(this);
+  esp_err_t ret = this->m_pSpiBackend->m_pTransmit(this->m_SpiDeviceHandle, &t);
+  CSX1276_busRelease(this);
+  assert(ret == ESP_OK);
+
+  value = (BYTE) (*(uint32_t*)t.rx_data);
+
+  #if (SX1276_DEBUG_LEVEL2)
+    ret == ESP_OK ? DEBUG_PRINT("[OK] Register: ") : DEBUG_PRINT("[ERROR] Register: ");
+    DEBUG_PRINT_HEX(address);
+    DEBUG_PRINT(" -> ");
+    DEBUG_PRINT_HEX(value);
+    DEBUG_PRINT_CR;
+  #endif
+     
+  return value;
+}
+
+/*****************************************************************************************//**
+ * @fn         void CSX1276_spiWriteRegister(CSX1276 *this, BYTE address, BYTE data)
+ * 
+ * @brief      Writes in the specified register.
+ * 
+ * @details    The function writes a specified byte value in a specified register.
+ *
+ * @param      this
+ *             The pointer to CSX1276 object.
+ *  
+ * @param      address
+ *             Register address to write in.
+ *  
+ * @param      address
+ *             Byte value to write in the register.
+ *  
+ * @return     None.
+*********************************************************************************************/
+void CSX1276_spiWriteRegister(CSX1276 *this, BYTE address, BYTE data)
+{
+  #if (SX1276_DEBUG_LEVEL2)
+    DEBUG_PRINT_CR;
+    DEBUG_PRINT("CSX1276_spiWriteRegister, dev: ");
+    DEBUG_PRINT_PTR(this->m_SpiDeviceHandle);
+    DEBUG_PRINT_CR;
+  #endif
+
+  esp_err_t ret;
+  spi_transaction_t t;
+
+  // Zero out the transaction
+  memset(&t, 0, sizeof(t));       
+
+  // Bit 7 of address set to write to registers
+  bitSet(address, 7);        
+  t.addr = (uint64_t) address;
+
+  // Use transaction TX buffer (declared as 4 bytes array)
+  *(uint32_t*)t.tx_data = data;
+  t.flags = SPI_TRANS_USE_TXDATA;
+
+  // 8 bits of data to transmit
+  t.length = 8;                     
+
+  // Pipelined transactions collected first (i.e. SPI driver returns results in order)
+  CSX1276_batchWait(this);
+
+  // Start transaction on shared bus and wait until completed
+  CSX1276_busAcquire(this);
+  ret = this->m_pSpiBackend->m_pTransmit(this->m_SpiDeviceHandle, &t);
+  CSX1276_busRelease(this);
+  assert(ret == ESP_OK);                        //Should have had no issues.
+
+  #if (SX1276_DEBUG_LEVEL2)
+    ret == ESP_OK ? DEBUG_PRINT("[OK] Register: ") : DEBUG_PRINT("[ERROR] Register: ");
+    bitClear(address, 7);
+    DEBUG_PRINT_HEX(address);
+    DEBUG_PRINT(" -> ");
+    DEBUG_PRINT_HEX(data);
+    DEBUG_PRINT_CR;
+  #endif
+
+}
+
+/*****************************************************************************************//**
+ * @fn         void CSX1276_spiReadBurst(CSX1276 *this, BYTE address, 
+ *                                    BYTE *pBuffer, WORD wLength)
+ * 
+ * @brief      Reads several consecutive bytes in a single SPI transaction.
+ * 
+ * @details    The function uses the SX1276 SPI burst access mode: the address byte is sent once
+ *             and the register address is automatically incremented by the chip for each 
+ *             byte clocked out (except for 'REG_FIFO' where the FIFO address pointer is 
+ *             incremented instead).\n
+ *             This function is typically used to transfer a full LoRa payload from FIFO with
+ *             one SPI transaction instead of one transaction per byte.
+ *
+ * @param      this
+ *             The pointer to CSX1276 object.
+ *  
+ * @param      address
+ *             Address of first register to read from.
+ *  
+ * @param      pBuffer
+ *             Destination buffer for read bytes (at least 'wLength' bytes).
+ *  
+ * @param      wLength
+ *             Number of bytes to read.
+ *  
+ * @return     None.
+ *
+ * @note       The SPI bus uses DMA, the destination buffer must be in DMA capable memory and
+ *             32 bits aligned (i.e. heap or static internal RAM).
+*********************************************************************************************/
+void CSX1276_spiReadBurst(CSX1276 *this, BYTE address, BYTE *pBuffer, WORD wLength)
+{
+  #if (SX1276_DEBUG_LEVEL2)
+    DEBUG_PRINT_CR;
+    DEBUG_PRINT("CSX1276_spiReadBurst, dev: ");
+    DEBUG_PRINT_PTR(this->m_SpiDeviceHandle);
+    DEBUG_PRINT(", length: ");
+    DEBUG_PRINT_DEC(wLength);
+    DEBUG_PRINT_CR;
+  #endif
+
+  if (wLength == 0)
+  {
+    return;
+  }
+
+  esp_err_t ret;
+  spi_transaction_t t;
+
+  // Zero out the transaction
+  memset(&t, 0, sizeof(t));       
+
+  // Bit 7 cleared to read from registers
+  bitClear(address, 7);   
+  t.addr = (uint64_t) address;
+
+  // Bytes are directly received in caller buffer
+  t.rx_buffer = pBuffer;
+  t.tx_buffer = NULL;
+
+  // Total number of bits to receive
+  t.length = 8 * (size_t) wLength;
+  t.rxlength = t.length;
+
+  // Pipelined transactions collected first (i.e. SPI driver returns results in order)
+  CSX1276_batchWait(this);
+
+  // Start transaction on shared bus and wait until completed
+  CSX1276_busAcquire(this);
+  ret = this->m_pSpiBackend->m_pTransmit(this->m_SpiDeviceHandle, &t);
+  CSX1276_busRelease(this);
+  assert(ret == ESP_OK);
+
+  #if (SX1276_DEBUG_LEVEL2)
+    ret == ESP_OK ? DEBUG_PRINT("[OK] Burst read from register: ") : DEBUG_PRINT("[ERROR] Burst read from register: ");
+    DEBUG_PRINT_HEX(address);
+    DEBUG_PRINT_CR;
+  #endif
+}
+
+/*****************************************************************************************//**
+ * @fn         void CSX1276_spiWriteBurst(CSX1276 *this, BYTE address, 
+ *                                     BYTE *pBuffer, WORD wLength)
+ * 
+ * @brief      Writes several consecutive bytes in a single SPI transaction.
+ * 
+ * @details    The function uses the SX1276 SPI burst access mode: the address byte is sent once
+ *             and the register address is automatically incremented by the chip for each 
+ *             byte clocked in (except for 'REG_FIFO' where the FIFO address pointer is 
+ *             incremented instead).\n
+ *             This function is typically used to transfer a full LoRa payload to FIFO with
+ *             one SPI transaction instead of one transaction per byte.
+ *
+ * @param      this
+ *             The pointer to CSX1276 object.
+ *  
+ * @param      address
+ *             Address of first register to write in.
+ *  
+ * @param      pBuffer
+ *             Source buffer containing the 'wLength' bytes to write.
+ *  
+ * @param      wLength
+ *             Number of bytes to write.
+ *  
+ * @return     None.
+ *
+ * @note       The SPI bus uses DMA, the source buffer must be in DMA capable memory and
+ *             32 bits aligned (i.e. heap or static internal RAM).
+*********************************************************************************************/
+void CSX1276_spiWriteBurst(CSX1276 *this, BYTE address, BYTE *pBuffer, WORD wLength)
+{
+  #if (SX1276_DEBUG_LEVEL2)
+    DEBUG_PRINT_CR;
+    DEBUG_PRINT("CSX1276_spiWriteBurst, dev: ");
+    DEBUG_PRINT_PTR(this->m_SpiDeviceHandle);
+    DEBUG_PRINT(", length: ");
+    DEBUG_PRINT_DEC(wLength);
+    DEBUG_PRINT_CR;
+  #endif
+
+  if (wLength == 0)
+  {
+    return;
+  }
+
+  esp_err_t ret;
+  spi_transaction_t t;
+
+  // Zero out the transaction
+  memset(&t, 0, sizeof(t));       
+
+  // Bit 7 of address set to write to registers
+  bitSet(address, 7);        
+  t.addr = (uint64_t) address;
+
+  // Bytes are directly sent from caller buffer
+  t.tx_buffer = pBuffer;
+  t.rx_buffer = NULL;
+
+  // Total number of bits to transmit
+  t.length = 8 * (size_t) wLength;
+
+  // Pipelined transactions collected first (i.e. SPI driver returns results in order)
+  CSX1276_batchWait(this);
+
+  // Start transaction on shared bus and wait until completed
+  CSX1276_busAcquire(this);
+  ret = this->m_pSpiBackend->m_pTransmit(this->m_SpiDeviceHandle, &t);
+  CSX1276_busRelease(this);
+  assert(ret == ESP_OK);
+
+  #if (SX1276_DEBUG_LEVEL2)
+    ret == ESP_OK ? DEBUG_PRINT("[OK] Burst write to register: ") : DEBUG_PRINT("[ERROR] Burst write to register: ");
+    bitClear(address, 7);
+    DEBUG_PRINT_HEX(address);
+    DEBUG_PRINT_CR;
+  #endif
+}
+
+/*****************************************************************************************//**
+ * @fn         void CSX1276_clearFlags(CSX1276 *this)
+ * 
+ * @brief      Clears the IRQ flags register.
+ * 
+ * @details    The function clears the interrupt request flags register.\n
+ *             This function can be called even if SX1276 is not in 'Sleep' or 'StandBy' mode.
+ *
+ * @param      this
+ *             The pointer to CSX1276 object.
+ *  
+ * @return     None.
+*********************************************************************************************/
+void CSX1276_clearFlags(CSX1276 *this)
+{
+  // 'StandBy' mode to write in registers, clear IRQ flags and back to previous mode
+  // (pipelined SPI transactions)
+  CSX1276_batchBegin(this);
+  CSX1276_batchClearFlags(this);
+  CSX1276_batchWait(this);
+
+  #if (SX1276_DEBUG_LEVEL0)
+    DEBUG_PRINT_LN("## LoRa IRQ flags cleared ##");
+  #endif
+}
+
+
+
+/*********************************************************************************************
+  Private methods (implementation)
+
+  SX1276 configuration and management.
+
+  These functions are invoked by the main automaton.
+*********************************************************************************************/
+
+/*****************************************************************************************//**
+ * @fn         uint8_t CSX1276_InitializeDevice(CSX1276 *this, BYTE SPISlaveID, 
+ *                                              CLoraTransceiverItf_InitializeParams pParams)
+ * 
+ * @brief      Initializes the SX1276 device.
+ * 
+ * @details    The function establishes the SPI link to SX1276 device and configure the modem
+ *             for the specified LoRa mode.\n
+ *             On exit, the device is in 'StandBy' mode and ready for LoRa transmission (with
+ *             LoRa MAC layer configured with default values for use on LoRaWAN public networks).
+ *
+ * @param      this
+ *             The pointer to CSX1276 object.
+ *  
+ * @param      SPISlaveID
+ *             The index of SX1276 pins in 'SX1276_DEVICE_PINS' (i.e. CS and IRQ pins on the
+ *             shared SPI bus).
+ *  
+ * @param      pParams
+ *             The method parameters. See 'LoraTransceiverItf.h' for details.
+ *
+ * @return     The function returns one of the following a result codes:
+ *              - LORATRANSCEIVERITF_RESULT_SUCCESS = the SX1276 is ready
+ *              - LORATRANSCEIVERITF_RESULT_NOTEXECUTED = the operation has not been executed
+ *              - LORATRANSCEIVERITF_RESULT_INVALIDPARAMS = the SPI slave ID is not valid
+*********************************************************************************************/
+uint8_t CSX1276_InitializeDevice(CSX1276 *this, BYTE SPISlaveID, CLoraTransceiverItf_InitializeParams pParams)
+{
+  uint8_t resultCode;
+  
+  #if (SX1276_DEBUG_LEVEL0)
+    DEBUG_PRINT_CR;
+    DEBUG_PRINT_LN("Entering CSX1276_InitializeDevice");
+  #endif
+    
+  esp_err_t ret;
+
+  if (SPISlaveID >= SX1276_MAX_DEVICES)
+  {
+    #if (SX1276_DEBUG_LEVEL0)
+      DEBUG_PRINT_LN("[ERROR] Invalid SPI slave ID");
+    #endif
+    return LORATRANSCEIVERITF_RESULT_INVALIDPARAMS;
+  }
+
+  this->m_usSpiSlaveID = SPISlaveID;
+  this->m_nPinCS = g_SX1276DevicePins[SPISlaveID].m_nPinCS;
+  this->m_nPinIrq = g_SX1276DevicePins[SPISlaveID].m_nPinIrq;
+
+  spi_bus_config_t buscfg = {.miso_io_num = PIN_NUM_MISO,
+                             .mosi_io_num = PIN_NUM_MOSI,
+                             .sclk_io_num = PIN_NUM_CLK,
+                             .quadwp_io_num = -1,
+                             .quadhd_io_num = -1,
+                             .max_transfer_sz = 512
+                            };
+
+  spi_device_interface_config_t devcfg = {.command_bits = 0,                        // Amount of bits in command phase (0-16)
+                                          .address_bits = 8,                        // Amount of bits in address phase (0-64)
+                                          .clock_speed_hz = 5*1000*1000,            // Clock out at 5 MHz (Note: NOK at 10 Mhz on breadboard)
+                                          .mode = 0,                                // SPI mode 0  (CPOL = 0, CPHA = 0)
+                                          .spics_io_num = this->m_nPinCS,           // CS pin
+                                          .queue_size = SX1276_SPI_QUEUE_SIZE,      // Pipelined transactions (see 'CSX1276SpiBatchOb')
+                                          .pre_cb = NULL,                           // Possible to have pre-transfer callback 
+                                          .post_cb = NULL,                          // Possible to have post-transfer callback 
+                                         };
+
+  // Initialize the SPI bus (first SX1276 only) and attach the SX1276 to the SPI bus
+  // Note: Not done if another SPI device is specified (see 'CSX1276_SetSpiBackend')
+  if (this->m_SpiDeviceHandle == NULL)
+  {
+    if (g_SX1276SpiBusOb.m_usDeviceNumber == 0)
+    {
+      ret = spi_bus_initialize(HSPI_HOST, &buscfg, 1);
+      assert(ret==ESP_OK);
+    }
+
+    ret = spi_bus_add_device(HSPI_HOST, &devcfg, &(this->m_SpiDeviceHandle));
+    assert(ret==ESP_OK);
+  }
+
+  // Arbiter of shared SPI bus (see 'CSX1276_busAcquire')
+  if (g_SX1276SpiBusOb.m_hMutex == NULL)
+  {
+    if ((g_SX1276SpiBusOb.m_hMutex = xSemaphoreCreateMutex()) == NULL)
+    {
+      return LORATRANSCEIVERITF_RESULT_ERROR;
+    }
+  }
+  ++g_SX1276SpiBusOb.m_usDeviceNumber;
+
+  // Content of SX1276 registers unknown
+  CSX1276_invalidateRegisters(this);
+    
+  // RX calibration (just after SX1276 reset)
+  CSX1276_RxChainCalibration(this);
+
+  // Frequency used by RxChainCalibration must be changed by explicit configuration
+  this->m_usFreqChannel = SX1276_FREQ_CH_UNDEFINED;
+
+  // Set Maximum Over Current Protection
+  resultCode = CSX1276_setMaxCurrent(this, 0x1B);
+  
+  if (resultCode == LORATRANSCEIVERITF_RESULT_SUCCESS)
+  {
+    #if (SX1276_DEBUG_LEVEL0)
+      DEBUG_PRINT_LN("Set LoRa mode with maximum current supply");
+    #endif
+
+    // This current (OCP) must be confirmed by explicit configuration
+    this->m_usOcpRate = SX1276_OCP_UNDEFINED;
+     
+    // Set LoRa in Standby (i.e. other SX1276 registers with reset value)
+    if ((resultCode = CSX1276_setLoRa(this)) == LORATRANSCEIVERITF_RESULT_SUCCESS)
+    {
+      // Set default 'SyncWord' for LoRaWAN public networks
+      resultCode = CSX1276_setSyncWord(this, LORATRANSCEIVERITF_SYNCWORD_PUBLIC);
+
+      if (resultCode == LORATRANSCEIVERITF_RESULT_SUCCESS)
+      {
+        // Set default 'Preamble Length' for LoRaWAN public networks
+        resultCode = CSX1276_setPreambleLength(this, LORATRANSCEIVERITF_PREAMBLE_LENGTH_LORA);
+      }
+     
+      if (resultCode == LORATRANSCEIVERITF_RESULT_SUCCESS)
+      {
+        // Set default 'Header ON' for LoRaWAN public networks
+        resultCode = CSX1276_setHeaderON(this);
+      }
+       
+      if (resultCode == LORATRANSCEIVERITF_RESULT_SUCCESS)
+      {
+        // Set default 'CRC ON' for LoRaWAN public networks
+        resultCode = CSX1276_setCRC_ON(this);
+      }
+
+      // Set GPIO for Interrupt Requests from SX1276
+      if (resultCode == LORATRANSCEIVERITF_RESULT_SUCCESS)
+      {
+        // PacketReceived and PacketSent IRQ
+        // Note: Same PIN used for both RX_DONE and TX_DONE IRQs (i.e. software configuration of DIO on Sx1276
+        //       according to OP mode) 
+        gpio_set_direction(this->m_nPinIrq, GPIO_MODE_INPUT);
+        gpio_set_pull_mode(this->m_nPinIrq, GPIO_PULLDOWN_ENABLE); //GPIO_FLOATING);
+        gpio_set_intr_type(this->m_nPinIrq, GPIO_INTR_POSEDGE);
+        gpio_intr_disable(this->m_nPinIrq); 
+
+        if (gpio_isr_handler_add(this->m_nPinIrq, (gpio_isr_t) CSX1276_PacketRxTxIntHandler, this) != ESP_OK)
+        {
+          resultCode = LORATRANSCEIVERITF_RESULT_ERROR;
+        }
+      }
+
+    }
+
+
+   // DEBUG
+//   CSX1276_CPhamInit(this);
+  }
+    
+  return resultCode;
+}
+
+/*****************************************************************************************//**
+ * @fn         void CSX1276_RxChainCalibration(CSX1276 *this)
+ * 
+ * @brief      Performs the RX chain calibration for LF and HF bands.
+ * 
+ * @details    The RX calibration is required for SX1276 device.\n
+ *             This function MUST be called just after the reset so all registers are at 
+ *             their default values. 
+ *
+ * @param      this
+ *             The pointer to CSX1276 object.
+ *  
+ * @return     None.
+*********************************************************************************************/
+void CSX1276_RxChainCalibration(CSX1276 *this)
+{
+
+  #if (SX1276_DEBUG_LEVEL0)
+    DEBUG_PRINT_LN("Starting SX1276 LF/HF calibration");
+  #endif
+
+  // Cut the PA just in case, RFO output, power = -1 dBm
+  CSX1276_writeRegister(this, REG_PA_CONFIG, 0x00);
+
+  // Launch Rx chain calibration for LF band
+  CSX1276_writeRegister(this, REG_IMAGE_CAL, (CSX1276_readRegister(this, REG_IMAGE_CAL) & RF_IMAGECAL_IMAGECAL_MASK) | RF_IMAGECAL_IMAGECAL_START);
+  while((CSX1276_readRegister(this, REG_IMAGE_CAL) & RF_IMAGECAL_IMAGECAL_RUNNING) == RF_IMAGECAL_IMAGECAL_RUNNING)
+  {
+  }
+
+  // Sets a Frequency in HF band
+  CSX1276_setChannel(this, LORATRANSCEIVERITF_FREQUENCY_CHANNEL_17);
+
+  // Launch Rx chain calibration for HF band
+  CSX1276_writeRegister(this, REG_IMAGE_CAL, (CSX1276_readRegister(this, REG_IMAGE_CAL) & RF_IMAGECAL_IMAGECAL_MASK) | RF_IMAGECAL_IMAGECAL_START);
+  while((CSX1276_readRegister(this, REG_IMAGE_CAL) & RF_IMAGECAL_IMAGECAL_RUNNING) == RF_IMAGECAL_IMAGECAL_RUNNING)
+  {
+  }
+
+  #if (SX1276_DEBUG_LEVEL0)
+    DEBUG_PRINT_LN("[OK] SX1276 LF/HF calibration");
+  #endif
+}
+
+/*****************************************************************************************//**
+ * @fn         uint8_t CSX1276_setLoRa(CSX1276 *this)
+ * 
+ * @brief      Sets the SX1276 in LoRa radio mode.
+ * 
+ * @details    The function sets the modem for LoRa mode and activates the 'StandBy' mode.
+ *
+ * @param      this
+ *             The pointer to CSX1276 object.
+ *  
+ * @return     The function returns one of the following a result codes:
+ *              - LORATRANSCEIVERITF_RESULT_SUCCESS = the SX1276 is set in LoRa 'StandBy' mode
+ *              - LORATRANSCEIVERITF_RESULT_NOTEXECUTED = the operation has not been executed
+*********************************************************************************************/
+uint8_t CSX1276_setLoRa(CSX1276 *this)
+{
+  uint8_t resultCode = LORATRANSCEIVERITF_RESULT_NOTEXECUTED;
+  BYTE st0;
+
+  #if (SX1276_DEBUG_LEVEL0)
+    DEBUG_PRINT_CR;
+    DEBUG_PRINT_LN("Starting 'setLORA'");
+  #endif
+
+  CSX1276_writeRegister(this, REG_OP_MODE, FSK_SLEEP_MODE);     // Sleep mode (mandatory to set LoRa mode)
+  CSX1276_writeRegister(this, REG_OP_MODE, LORA_SLEEP_MODE);    // LoRa sleep mode
+  CSX1276_writeRegister(this, REG_OP_MODE, LORA_STANDBY_MODE);  // LoRa standby mode
+
+  CSX1276_writeRegister(this, REG_MAX_PAYLOAD_LENGTH, LORA_MAX_PAYLOAD_LENGTH);
+    
+  // Set RegModemConfig1 to Default values
+  CSX1276_writeRegister(this, REG_MODEM_CONFIG1, 0x08); 
+  // Set RegModemConfig2 to Default values
+  CSX1276_writeRegister(this, REG_MODEM_CONFIG2, 0x74);   
+
+  // Delay 100ms
+  vTaskDelay(pdMS_TO_TICKS(100));
+
+  st0 = CSX1276_readRegister(this, REG_OP_MODE);  // Reading config mode
+  if (st0 == LORA_STANDBY_MODE)
+  { 
+    // LoRa mode
+    this->m_usModemMode = MODEM_MODE_LORA;
+    resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
+    #if (SX1276_DEBUG_LEVEL0)
+      DEBUG_PRINT_LN("[OK] LoRa mode set");
+      DEBUG_PRINT_CR;
+    #endif
+  }
+  return resultCode;
+}
+
+/*****************************************************************************************//**
+ * @fn         uint8_t CSX1276_setLoRaMode(CSX1276 *this, uint8_t LoraMode)
+ * 
+ * @brief      Sets the SX1276 in a specified LoRa mode.
+ * 
+ * @details    The function sets the modem to LoRa radio mode and configure the specified
+ *             bandwith, coding rate and spreading factor of the LoRa modulation.\n
+ *             On exit the modem is in 'StandBy' mode.
+ *
+ * @param      this
+ *             The pointer to CSX1276 object.
+ *  
+ * @param      LoraMode
+ *             The LoRa mode number as defined by 'LORATRANSCEIVERITF_LORAMODE_xxx' constants
+ *             (see 'LoraTransceiverItf.h' for details).
+ *  
+ * @return     The function returns one of the following a result codes:
+ *              - LORATRANSCEIVERITF_RESULT_SUCCESS = the SX1276 is set in LoRa 'StandBy' mode
+ *              - LORATRANSCEIVERITF_RESULT_ERROR = error during configuration
+ *              - LORATRANSCEIVERITF_RESULT_INVALIDPARAMS = invalid value of specified LoraMode
+ *              - LORATRANSCEIVERITF_RESULT_NOTEXECUTED = the operation has not been executed
+*********************************************************************************************/
+uint8_t CSX1276_setLoRaMode(CSX1276 *this, uint8_t LoraMode)
+{
+  uint8_t resultCode = LORATRANSCEIVERITF_RESULT_NOTEXECUTED;
+  BYTE st0;
+  BYTE config1 = 0x00;
+  BYTE config2 = 0x00;
+
+  #if (SX1276_DEBUG_LEVEL0)
+    DEBUG_PRINT_CR;
+    DEBUG_PRINT_LN("Entering 'setLoraMode'");
+  #endif
+
+  // 'SetMode' function only can be called in LoRa mode
+  if (this->m_usModemMode != MODEM_MODE_LORA)
+  {
+    if ((resultCode = CSX1276_setLoRa(this)) != LORATRANSCEIVERITF_RESULT_SUCCESS)
+    {
+      return resultCode;
+    }
+    resultCode = LORATRANSCEIVERITF_RESULT_NOTEXECUTED;
+  }
+  
+  // Save the current OP mode
+  st0 = CSX1276_readRegister(this, REG_OP_MODE);    
+
+  // LoRa standby mode
+  if (st0 != LORA_STANDBY_MODE)
+  {
+    CSX1276_writeRegister(this, REG_OP_MODE, LORA_STANDBY_MODE);  
+  }
+
+  switch (LoraMode)
+  {
+    // Mode 1 (better reach, medium time on air)
+    case LORATRANSCEIVERITF_LORAMODE_1:   
+      CSX1276_setCR(this, LORATRANSCEIVERITF_CR_5);      // CR = 4/5
+      CSX1276_setSF(this, LORATRANSCEIVERITF_SF_12);     // SF = 12
+      CSX1276_setBW(this, LORATRANSCEIVERITF_BANDWIDTH_125);    // BW = 125 KHz
+      break;
+
+    // Mode 2 (medium reach, less time on air)
+    case LORATRANSCEIVERITF_LORAMODE_2:   
+      CSX1276_setCR(this, LORATRANSCEIVERITF_CR_5);      // CR = 4/5
+      CSX1276_setSF(this, LORATRANSCEIVERITF_SF_12);     // SF = 12
+      CSX1276_setBW(this, LORATRANSCEIVERITF_BANDWIDTH_250);    // BW = 250 KHz
+      break;
+
+    // Mode 3 (worst reach, less time on air)
+    case LORATRANSCEIVERITF_LORAMODE_3: 
+      CSX1276_setCR(this, LORATRANSCEIVERITF_CR_5);      // CR = 4/5
+      CSX1276_setSF(this, LORATRANSCEIVERITF_SF_10);     // SF = 10
+      CSX1276_setBW(this, LORATRANSCEIVERITF_BANDWIDTH_125);    // BW = 125 KHz
+      break;
+
+    // Mode 4 (better reach, low time on air)
+    case LORATRANSCEIVERITF_LORAMODE_4:
+      CSX1276_setCR(this, LORATRANSCEIVERITF_CR_5);      // CR = 4/5
+      CSX1276_setSF(this, LORATRANSCEIVERITF_SF_12);     // SF = 12
+      CSX1276_setBW(this, LORATRANSCEIVERITF_BANDWIDTH_500);    // BW = 500 KHz
+      break;
+
+    // Mode 5 (better reach, medium time on air)
+    case LORATRANSCEIVERITF_LORAMODE_5:
+      CSX1276_setCR(this, LORATRANSCEIVERITF_CR_5);      // CR = 4/5
+      CSX1276_setSF(this, LORATRANSCEIVERITF_SF_10);     // SF = 10
+      CSX1276_setBW(this, LORATRANSCEIVERITF_BANDWIDTH_250);    // BW = 250 KHz
+      break;
+
+    // Mode 6 (better reach, worst time-on-air)
+    case LORATRANSCEIVERITF_LORAMODE_6:
+      CSX1276_setCR(this, LORATRANSCEIVERITF_CR_5);      // CR = 4/5
+      CSX1276_setSF(this, LORATRANSCEIVERITF_SF_11);     // SF = 11
+      CSX1276_setBW(this, LORATRANSCEIVERITF_BANDWIDTH_500);    // BW = 500 KHz
+      break;
+
+    // Mode 7 (medium-high reach, medium-low time-on-air)
+    case LORATRANSCEIVERITF_LORAMODE_7: 
+      CSX1276_setCR(this, LORATRANSCEIVERITF_CR_5);      // CR = 4/5
+      CSX1276_setSF(this, LORATRANSCEIVERITF_SF_9);      // SF = 9
+      CSX1276_setBW(this, LORATRANSCEIVERITF_BANDWIDTH_250);    // BW = 250 KHz
+      break;
+
+    // Mode 8 (medium reach, medium time-on-air)
+    case LORATRANSCEIVERITF_LORAMODE_8:
+      CSX1276_setCR(this, LORATRANSCEIVERITF_CR_5);      // CR = 4/5
+      CSX1276_setSF(this, LORATRANSCEIVERITF_SF_9);      // SF = 9
+      CSX1276_setBW(this, LORATRANSCEIVERITF_BANDWIDTH_500);    // BW = 500 KHz
+      break;
+
+    // Mode 9 (medium-low reach, medium-high time-on-air)
+    case LORATRANSCEIVERITF_LORAMODE_9:
+      CSX1276_setCR(this, LORATRANSCEIVERITF_CR_5);      // CR = 4/5
+      CSX1276_setSF(this, LORATRANSCEIVERITF_SF_8);      // SF = 8
+      CSX1276_setBW(this, LORATRANSCEIVERITF_BANDWIDTH_500);    // BW = 500 KHz
+      break;
+
+    // Mode 10 (worst reach, less time_on_air)
+    case LORATRANSCEIVERITF_LORAMODE_10:
+      CSX1276_setCR(this, LORATRANSCEIVERITF_CR_5);      // CR = 4/5
+      CSX1276_setSF(this, LORATRANSCEIVERITF_SF_7);      // SF = 7
+      CSX1276_setBW(this, LORATRANSCEIVERITF_BANDWIDTH_500);    // BW = 500 KHz
+      break;
+
+    // test for LoRaWAN channel
+    case LORATRANSCEIVERITF_LORAMODE_11:
+    	CSX1276_setCR(this, LORATRANSCEIVERITF_CR_5);        // CR = 4/5
+    	CSX1276_setSF(this, LORATRANSCEIVERITF_SF_12);       // SF = 12
+    	CSX1276_setBW(this, LORATRANSCEIVERITF_BANDWIDTH_125);      // BW = 125 KHz
+      break;
+
+    default:
+      resultCode = LORATRANSCEIVERITF_RESULT_INVALIDPARAMS; 
+  };
+
+
+  // Check proper register configuration
+  if (resultCode == LORATRANSCEIVERITF_RESULT_INVALIDPARAMS)
+  {
+    // Don't change resultCode value
+    #if (SX1276_DEBUG_LEVEL0)
+      DEBUG_PRINT("** The indicated mode doesn't exist, ");
+      DEBUG_PRINT_LN("please select from 1 to 10 **");
+    #endif
+  }
+  else
+  {
+    resultCode = LORATRANSCEIVERITF_RESULT_ERROR;
+    config1 = CSX1276_readRegister(this, REG_MODEM_CONFIG1);
+    switch (LoraMode)
+    { 
+      //  Different way to check for each mode:
+      // (config1 >> 1) ---> take out bits 7-1 from REG_MODEM_CONFIG1 (=_bandwidth & _codingRate together)
+      // (config2 >> 4) ---> take out bits 7-4 from REG_MODEM_CONFIG2 (=_spreadingFactor)
+
+      // mode 1: BW = 125 KHz, CR = 4/5, SF = 12.
+      case LORATRANSCEIVERITF_LORAMODE_1:  
+        if ((config1 >> 1) == 0x39)
+        { 
+          config2 = CSX1276_readRegister(this, REG_MODEM_CONFIG2);
+          if ((config2 >> 4) == LORATRANSCEIVERITF_SF_12)
+          {
+            resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
+          }
+        }
+        break;
+
+      // mode 2: BW = 250 KHz, CR = 4/5, SF = 12.
+      case LORATRANSCEIVERITF_LORAMODE_2:  
+        if ((config1 >> 1) == 0x41)
+        {
+          config2 = CSX1276_readRegister(this, REG_MODEM_CONFIG2);
+          if ((config2 >> 4) == LORATRANSCEIVERITF_SF_12)
+          {
+            resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
+          }
+        }
+        break;
+
+      // mode 3: BW = 125 KHz, CR = 4/5, SF = 10.
+      case LORATRANSCEIVERITF_LORAMODE_3:  
+        if ((config1 >> 1) == 0x39)
+        {
+          config2 = CSX1276_readRegister(this, REG_MODEM_CONFIG2);
+          if ((config2 >> 4) == LORATRANSCEIVERITF_SF_10)
+          {
+            resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
+          }
+        }
+        break;
+
+      // mode 4: BW = 500 KHz, CR = 4/5, SF = 12.
+      case LORATRANSCEIVERITF_LORAMODE_4:  
+        if ((config1 >> 1) == 0x49)
+        { 
+          config2 = CSX1276_readRegister(this, REG_MODEM_CONFIG2);
+          if ((config2 >> 4) == LORATRANSCEIVERITF_SF_12)
+          {
+            resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
+          }
+        }
+        break;
 
       // mode 5: BW = 250 KHz, CR = 4/5, SF = 10.
       case LORATRANSCEIVERITF_LORAMODE_5:
         if ((config1 >> 1) == 0x41)
         {  
-          config2 = CSX1276_readRegister(SPIDeviceHandle, REG_MODEM_CONFIG2);
+          config2 = CSX1276_readRegister(this, REG_MODEM_CONFIG2);
           if ((config2 >> 4) == LORATRANSCEIVERITF_SF_10)
           {
             resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
@@ -2182,139 +3639,516 @@ uint8_t CSX1276_setLoRaMode(CSX1276 *this, uint8_t LoraMode)
         }
         break;
 
-      // mode 6: BW = 500 KHz, CR = 4/5, SF = 11.
-      case LORATRANSCEIVERITF_LORAMODE_6:  
-        if ((config1 >> 1) == 0x49)
-        {
-          config2 = CSX1276_readRegister(SPIDeviceHandle, REG_MODEM_CONFIG2);
-          if ((config2 >> 4) == LORATRANSCEIVERITF_SF_11)
-          {
-            resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
-          }
-        }
-        break;
+      // mode 6: BW = 500 KHz, CR = 4/5, SF = 11.
+      case LORATRANSCEIVERITF_LORAMODE_6:  
+        if ((config1 >> 1) == 0x49)
+        {
+          config2 = CSX1276_readRegister(this, REG_MODEM_CONFIG2);
+          if ((config2 >> 4) == LORATRANSCEIVERITF_SF_11)
+          {
+            resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
+          }
+        }
+        break;
+
+      // mode 7: BW = 250 KHz, CR = 4/5, SF = 9.
+      case LORATRANSCEIVERITF_LORAMODE_7:  
+        if ((config1 >> 1) == 0x41)
+        {  
+          config2 = CSX1276_readRegister(this, REG_MODEM_CONFIG2);
+          if ((config2 >> 4) == LORATRANSCEIVERITF_SF_9)
+          {
+            resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
+          }
+        }
+        break;
+
+      // mode 8: BW = 500 KHz, CR = 4/5, SF = 9.
+      case LORATRANSCEIVERITF_LORAMODE_8: 
+        if ((config1 >> 1) == 0x49)
+        {
+          config2 = CSX1276_readRegister(this, REG_MODEM_CONFIG2);
+          if ((config2 >> 4) == LORATRANSCEIVERITF_SF_9)
+          {
+            resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
+          }
+        }
+        break;
+
+      // mode 9: BW = 500 KHz, CR = 4/5, SF = 8.
+      case LORATRANSCEIVERITF_LORAMODE_9:  
+        if ((config1 >> 1) == 0x49)
+        {  
+          config2 = CSX1276_readRegister(this, REG_MODEM_CONFIG2);
+          if ((config2 >> 4) == LORATRANSCEIVERITF_SF_8)
+          {
+            resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
+          }
+        }
+        break;
+
+      // mode 10: BW = 500 KHz, CR = 4/5, SF = 7.
+      case LORATRANSCEIVERITF_LORAMODE_10: 
+        if ((config1 >> 1) == 0x49)
+        {  
+          config2 = CSX1276_readRegister(this, REG_MODEM_CONFIG2);
+          if ((config2 >> 4) == LORATRANSCEIVERITF_SF_7)
+          {
+            resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
+          }
+        }
+        break;
+
+      // mode 11: BW = 125 KHz, CR = 4/5, SF = 7.
+      case LORATRANSCEIVERITF_LORAMODE_11: 
+        if ((config1 >> 1) == 0x39)
+        {  
+          config2 = CSX1276_readRegister(this, REG_MODEM_CONFIG2);
+          if ((config2 >> 4) == LORATRANSCEIVERITF_SF_12)
+          {
+            resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
+          }
+        }
+    }
+  }
+  
+  #if (SX1276_DEBUG_LEVEL0)
+    if (resultCode == LORATRANSCEIVERITF_RESULT_SUCCESS)
+    {
+      DEBUG_PRINT("[INFO] Mode ");
+      DEBUG_PRINT_DEC(LoraMode);
+      DEBUG_PRINT_LN(" configured with success");    
+    }
+    else
+    {
+      DEBUG_PRINT("[ERROR] There has been an error while configuring mode ");    
+      DEBUG_PRINT_DEC(LoraMode);
+    }
+  #endif
+  
+  // Restore previous OP mode
+  if (st0 != LORA_STANDBY_MODE)
+  {
+    CSX1276_writeRegister(this, REG_OP_MODE, st0);  
+  }
+  
+  return resultCode;
+}
+
+/*****************************************************************************************//**
+ * @fn         uint8_t CSX1276_setSyncWord(CSX1276 *this, uint8_t SyncWord)
+ * 
+ * @brief      Sets the 'Sync Word' for LoRa radio.
+ * 
+ * @details    The function sets the 'Sync Word' used by LoRa radio to detect packet preamble.
+ *
+ * @param      this
+ *             The pointer to CSX1276 object.
+ *  
+ * @param      SyncWord
+ *             The value of 'Sync Word' to set for LoRa radio.
+ *             In LoRa specification, values are:
+ *              - 0x34 for public networks (i.e. compliant with LoRaWAN)
+ *              - 0x12 for private networks (typically LoRa)
+ *
+ * @return     The function returns one of the following a result codes:
+ *              - LORATRANSCEIVERITF_RESULT_SUCCESS = the 'Sync Word' is set for LoRa radio
+ *              - LORATRANSCEIVERITF_RESULT_ERROR = error during configuration
+ *              - LORATRANSCEIVERITF_RESULT_NOTEXECUTED = the operation has not been executed
+*********************************************************************************************/
+uint8_t CSX1276_setSyncWord(CSX1276 *this, uint8_t SyncWord)
+{
+  BYTE st0;
+  uint8_t resultCode = LORATRANSCEIVERITF_RESULT_NOTEXECUTED;
+  BYTE config1;
+
+  #if (SX1276_DEBUG_LEVEL0)
+    DEBUG_PRINT_LN("Starting CSX1276_setSyncWord");
+  #endif
+
+  // Should never occur
+  if (this->m_usModemMode != MODEM_MODE_LORA)
+  {
+    #if (SX1276_DEBUG_LEVEL0)
+      DEBUG_PRINT_LN("[WARNING] Function called before LoRa mode activated - Switching to LoRa");
+    #endif
+    if ((resultCode = CSX1276_setLoRa(this)) != LORATRANSCEIVERITF_RESULT_SUCCESS)
+    {
+      return resultCode;
+    }
+  }
+
+  // Save the current OP mode
+  st0 = CSX1276_readRegister(this, REG_OP_MODE);		
+
+  // Set Standby mode to write in registers
+  if (st0 != LORA_STANDBY_MODE)
+  {
+    CSX1276_writeRegister(this, REG_OP_MODE, LORA_STANDBY_MODE);		
+  }
+  CSX1276_writeRegister(this, REG_SYNC_WORD, SyncWord);
+
+  // Delay 100ms
+  vTaskDelay(pdMS_TO_TICKS(100));
+
+  config1 = CSX1276_readRegister(this, REG_SYNC_WORD);
+
+  if (config1 == SyncWord) 
+  {
+    this->m_usSyncWord = SyncWord;
+    resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
+    #if (SX1276_DEBUG_LEVEL0)
+      DEBUG_PRINT("[OK] Sync word set: ");
+      DEBUG_PRINT_HEX(SyncWord);
+      DEBUG_PRINT_CR;
+    #endif
+  }
+  else 
+  {
+    resultCode = LORATRANSCEIVERITF_RESULT_ERROR;
+    #if (SX1276_DEBUG_LEVEL0)
+      DEBUG_PRINT_LN("[ERROR] Unable to set Sync Word");
+    #endif
+  }
+
+  if (st0 != LORA_STANDBY_MODE)
+  {
+    // Get back to previous OP mode
+    CSX1276_writeRegister(this, REG_OP_MODE, st0);	
+  }
+
+  // Delay 100ms
+  vTaskDelay(pdMS_TO_TICKS(100));
+
+  return resultCode;
+}
+
+/*****************************************************************************************//**
+ * @fn         uint8_t CSX1276_setHeaderON(CSX1276 *this)
+ * 
+ * @brief      Sets the SX1276 in explicit header mode (header is sent).
+ * 
+ * @details    The function configures the SX1276 to put the 'Header' field in LoRa messages.
+ *
+ * @param      this
+ *             The pointer to CSX1276 object.
+ *  
+ * @return     The function returns one of the following a result codes:
+ *              - LORATRANSCEIVERITF_RESULT_SUCCESS = the 'Header' is set to ON for LoRa radio
+ *              - LORATRANSCEIVERITF_RESULT_ERROR = error during configuration
+ *              - LORATRANSCEIVERITF_RESULT_NOTEXECUTED = the operation has not been executed
+ *              - LORATRANSCEIVERITF_RESULT_INVALIDSTATE = Function called on invalid state
+*********************************************************************************************/
+uint8_t CSX1276_setHeaderON(CSX1276 *this)
+{
+  int8_t resultCode = LORATRANSCEIVERITF_RESULT_NOTEXECUTED;
+  BYTE config1;
+
+  #if (SX1276_DEBUG_LEVEL0)
+    DEBUG_PRINT_CR;
+    DEBUG_PRINT_LN("Starting 'CSX1276_setHeaderON'");
+  #endif
+
+  if (this->m_usModemMode != MODEM_MODE_LORA)
+  {
+    // Should never occur: must be configured in LoRa mode before
+    resultCode = LORATRANSCEIVERITF_RESULT_INVALIDSTATE;  
+    #if (SX1276_DEBUG_LEVEL0)
+      DEBUG_PRINT_LN("[ERROR] Not configured in LoRa mode");
+      DEBUG_PRINT_CR;
+    #endif
+  }
+  else
+  {
+    // Save config1 to modify only the header bit
+    config1 = CSX1276_readRegister(this, REG_MODEM_CONFIG1);  
+    if (this->m_usSpreadingFactor == 6)
+    {
+      // Mandatory headerOFF with SF = 6
+      resultCode = LORATRANSCEIVERITF_RESULT_INVALIDSTATE;   
+      #if (SX1276_DEBUG_LEVEL0)
+        DEBUG_PRINT_LN("[ERROR] Mandatory implicit header mode with spreading factor = 6");
+      #endif
+    }
+    else
+    {
+      // Clear bit 0 from config1 (= headerON) and update config1
+      config1 = config1 & 0b11111110;                                     
+      CSX1276_writeRegister(this, REG_MODEM_CONFIG1, config1);
+    }
+    if (this->m_usSpreadingFactor != 6 )
+    {
+      // Check headerON taking out bit 0 from REG_MODEM_CONFIG1
+      config1 = CSX1276_readRegister(this, REG_MODEM_CONFIG1);
+      if (bitRead(config1, 0) == 0)
+      {
+        resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
+        this->m_usHeader = SX1276_HEADER_ON;
+        #if (SX1276_DEBUG_LEVEL0)
+          DEBUG_PRINT_LN("[INFO] Header has been activated");
+          DEBUG_PRINT_CR;
+        #endif
+      }
+      else
+      {
+        resultCode = LORATRANSCEIVERITF_RESULT_ERROR;
+        #if (SX1276_DEBUG_LEVEL0)
+          DEBUG_PRINT_LN("[ERROR] Failed to activate header");
+          DEBUG_PRINT_CR;
+        #endif
+      }
+    }
+  }
+  return resultCode;
+}
+
+/*****************************************************************************************//**
+ * @fn         uint8_t CSX1276_setHeaderOFF(CSX1276 *this)
+ * 
+ * @brief      Sets the SX1276 in implicit header mode (header is not sent).
+ * 
+ * @details    The function configures the SX1276 to not put the 'Header' field in LoRa messages.
+ *
+ * @param      this
+ *             The pointer to CSX1276 object.
+ *  
+ * @return     The function returns one of the following a result codes:
+ *              - LORATRANSCEIVERITF_RESULT_SUCCESS = the 'Header' is set to OFF for LoRa radio
+ *              - LORATRANSCEIVERITF_RESULT_ERROR = error during configuration
+ *              - LORATRANSCEIVERITF_RESULT_INVALIDSTATE = Function called on invalid state
+*********************************************************************************************/
+uint8_t  CSX1276_setHeaderOFF(CSX1276 *this)
+{
+  uint8_t resultCode = LORATRANSCEIVERITF_RESULT_NOTEXECUTED;
+  BYTE config1;
+
+  #if (SX1276_DEBUG_LEVEL0)
+    DEBUG_PRINT_CR;
+    DEBUG_PRINT_LN("Starting 'CSX1276_setHeaderOFF'");
+  #endif
+
+  if (this->m_usModemMode != MODEM_MODE_LORA)
+  { 
+    // Should never occur: must be configured in LoRa mode before
+    resultCode = LORATRANSCEIVERITF_RESULT_INVALIDSTATE;
+    #if (SX1276_DEBUG_LEVEL0)
+      DEBUG_PRINT_LN("[ERROR] Not configured in LoRa mode");
+      DEBUG_PRINT_CR;
+    #endif
+  }
+  else
+  {
+    // Read config1 to modify only the header bit
+    config1 = CSX1276_readRegister(this, REG_MODEM_CONFIG1);  
+    
+    // Set bit 0 from REG_MODEM_CONFIG1 (= headerOFF) and update Config1
+    config1 = config1 | 0b00000001;    
+    CSX1276_writeRegister(this, REG_MODEM_CONFIG1, config1);   
+
+    // Check register
+    config1 = CSX1276_readRegister(this, REG_MODEM_CONFIG1);
+    if (bitRead(config1, 0) == SX1276_HEADER_OFF)
+    { 
+      // Checking headerOFF taking out bit 2 from REG_MODEM_CONFIG1
+      resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
+      this->m_usHeader = SX1276_HEADER_OFF;
+
+      #if (SX1276_DEBUG_LEVEL0)
+          DEBUG_PRINT_LN("[INFO] Header has been desactivated");
+          DEBUG_PRINT_CR;
+      #endif
+    }
+    else
+    {
+      resultCode = LORATRANSCEIVERITF_RESULT_ERROR;
+      #if (SX1276_DEBUG_LEVEL0)
+        DEBUG_PRINT_LN("[ERROR] Failed to desactivate header");
+        DEBUG_PRINT_CR;
+      #endif
+    }
+  }
+  return resultCode;
+}
+
+/*****************************************************************************************//**
+ * @fn         uint8_t CSX1276_setCRC_ON(CSX1276 *this)
+ * 
+ * @brief      Sets the SX1276 with CRC ON.
+ * 
+ * @details    The function configures the SX1276 to put the 'CRC' field in LoRa messages.
+ *
+ * @param      this
+ *             The pointer to CSX1276 object.
+ *  
+ * @return     The function returns one of the following a result codes:
+ *              - LORATRANSCEIVERITF_RESULT_SUCCESS = the 'CRC' is set to ON for LoRa radio
+ *              - LORATRANSCEIVERITF_RESULT_ERROR = error during configuration
+ *              - LORATRANSCEIVERITF_RESULT_INVALIDSTATE = Function called on invalid state
+*********************************************************************************************/
+uint8_t CSX1276_setCRC_ON(CSX1276 *this)
+{
+  uint8_t resultCode = LORATRANSCEIVERITF_RESULT_NOTEXECUTED;
+  BYTE config1;
+
+  #if (SX1276_DEBUG_LEVEL0)
+    DEBUG_PRINT_CR;
+    DEBUG_PRINT_LN("[INFO] Starting 'CSX1276_setCRC_ON'");
+  #endif
+
+  if (this->m_usModemMode == MODEM_MODE_LORA)
+  { 
+    // LORA mode
+    config1 = CSX1276_readRegister(this, REG_MODEM_CONFIG2);  // Save config2 to modify only the CRC bit
+    config1 = config1 | 0b00000100;                                      // sets bit 2 from REG_MODEM_CONFIG2 = CRC_ON
+    CSX1276_writeRegister(this, REG_MODEM_CONFIG2, config1);
+
+    config1 = CSX1276_readRegister(this, REG_MODEM_CONFIG2);
+    if (bitRead(config1, 2) == SX1276_CRC_ON)
+    {
+      // take out bit 2 from REG_MODEM_CONFIG2 indicates RxPayloadCrcOn
+      resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
+      this->m_usCRC = SX1276_CRC_ON;
+      #if (SX1276_DEBUG_LEVEL0)
+        DEBUG_PRINT_LN("[INFO] CRC has been activated");
+        DEBUG_PRINT_CR;
+      #endif
+    }
+    else
+    {
+      resultCode = LORATRANSCEIVERITF_RESULT_ERROR;
+      #if (SX1276_DEBUG_LEVEL0)
+        DEBUG_PRINT_LN("[ERROR] Failed to set CRC ON");
+        DEBUG_PRINT_CR;
+      #endif
+    }
+  }
+  else
+  { 
+    // Should never occur: must be configured in LoRa mode before
+    resultCode = LORATRANSCEIVERITF_RESULT_INVALIDSTATE;
+    #if (SX1276_DEBUG_LEVEL0)
+      DEBUG_PRINT_LN("[ERROR] Not configured in LoRa mode");
+      DEBUG_PRINT_CR;
+    #endif
+  }
+  return resultCode;
+}
 
-      // mode 7: BW = 250 KHz, CR = 4/5, SF = 9.
-      case LORATRANSCEIVERITF_LORAMODE_7:  
-        if ((config1 >> 1) == 0x41)
-        {  
-          config2 = CSX1276_readRegister(SPIDeviceHandle, REG_MODEM_CONFIG2);
-          if ((config2 >> 4) == LORATRANSCEIVERITF_SF_9)
-          {
-            resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
-          }
-        }
-        break;
+/*****************************************************************************************//**
+ * @fn         uint8_t CSX1276_setCRC_OFF(CSX1276 *this)
+ * 
+ * @brief      Sets the SX1276 with CRC OFF.
+ * 
+ * @details    The function configures the SX1276 to not put the 'CRC' field in LoRa messages.
+ *
+ * @param      this
+ *             The pointer to CSX1276 object.
+ *  
+ * @return     The function returns one of the following a result codes:
+ *              - LORATRANSCEIVERITF_RESULT_SUCCESS = the 'CRC' is set to OFF for LoRa radio
+ *              - LORATRANSCEIVERITF_RESULT_ERROR = error during configuration
+ *              - LORATRANSCEIVERITF_RESULT_INVALIDSTATE = Function called on invalid state
+*********************************************************************************************/
+uint8_t CSX1276_setCRC_OFF(CSX1276 *this)
+{
+  int8_t resultCode = LORATRANSCEIVERITF_RESULT_NOTEXECUTED;
+  BYTE config1;
 
-      // mode 8: BW = 500 KHz, CR = 4/5, SF = 9.
-      case LORATRANSCEIVERITF_LORAMODE_8: 
-        if ((config1 >> 1) == 0x49)
-        {
-          config2 = CSX1276_readRegister(SPIDeviceHandle, REG_MODEM_CONFIG2);
-          if ((config2 >> 4) == LORATRANSCEIVERITF_SF_9)
-          {
-            resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
-          }
-        }
-        break;
+  #if (SX1276_DEBUG_LEVEL0)
+    DEBUG_PRINT_CR;
+    DEBUG_PRINT_LN("[INFO] Starting 'CSX1276_setCRC_OFF'");
+  #endif
 
-      // mode 9: BW = 500 KHz, CR = 4/5, SF = 8.
-      case LORATRANSCEIVERITF_LORAMODE_9:  
-        if ((config1 >> 1) == 0x49)
-        {  
-          config2 = CSX1276_readRegister(SPIDeviceHandle, REG_MODEM_CONFIG2);
-          if ((config2 >> 4) == LORATRANSCEIVERITF_SF_8)
-          {
-            resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
-          }
-        }
-        break;
+  if (this->m_usModemMode == MODEM_MODE_LORA)
+  { 
+    // Save config2 to modify only the CRC bit
+    config1 = CSX1276_readRegister(this, REG_MODEM_CONFIG2);  
 
-      // mode 10: BW = 500 KHz, CR = 4/5, SF = 7.
-      case LORATRANSCEIVERITF_LORAMODE_10: 
-        if ((config1 >> 1) == 0x49)
-        {  
-          config2 = CSX1276_readRegister(SPIDeviceHandle, REG_MODEM_CONFIG2);
-          if ((config2 >> 4) == LORATRANSCEIVERITF_SF_7)
-          {
-            resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
-          }
-        }
-        break;
+    // Clear bit 2 from config2 = CRC_OFF
+    config1 = config1 & 0b11111011;                                      
+    CSX1276_writeRegister(this, REG_MODEM_CONFIG2, config1);
 
-      // mode 11: BW = 125 KHz, CR = 4/5, SF = 7.
-      case LORATRANSCEIVERITF_LORAMODE_11: 
-        if ((config1 >> 1) == 0x39)
-        {  
-          config2 = CSX1276_readRegister(SPIDeviceHandle, REG_MODEM_CONFIG2);
-          if ((config2 >> 4) == LORATRANSCEIVERITF_SF_12)
-          {
-            resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
-          }
-        }
-    }
-  }
-  
-  #if (SX1276_DEBUG_LEVEL0)
-    if (resultCode == LORATRANSCEIVERITF_RESULT_SUCCESS)
+    config1 = CSX1276_readRegister(this, REG_MODEM_CONFIG2);
+    if ((bitRead(config1, 2)) == SX1276_CRC_OFF)
     {
-      DEBUG_PRINT("[INFO] Mode ");
-      DEBUG_PRINT_DEC(LoraMode);
-      DEBUG_PRINT_LN(" configured with success");    
+      // Take out bit 1 from REG_MODEM_CONFIG1 indicates RxPayloadCrcOn
+      resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
+      this->m_usCRC = SX1276_CRC_OFF;
+      #if (SX1276_DEBUG_LEVEL0)
+        DEBUG_PRINT_LN("[INFO] CRC has been desactivated");
+        DEBUG_PRINT_CR;
+      #endif
     }
     else
     {
-      DEBUG_PRINT("[ERROR] There has been an error while configuring mode ");    
-      DEBUG_PRINT_DEC(LoraMode);
+      resultCode = LORATRANSCEIVERITF_RESULT_ERROR;
+      #if (SX1276_DEBUG_LEVEL0)
+        DEBUG_PRINT_LN("[ERROR] Failed to set CRC OFF");
+        DEBUG_PRINT_CR;
+      #endif
     }
-  #endif
-  
-  // Restore previous OP mode
-  if (st0 != LORA_STANDBY_MODE)
-  {
-    CSX1276_writeRegister(SPIDeviceHandle, REG_OP_MODE, st0);  
   }
-  
+  else
+  { 
+    // Should never occur: must be configured in LoRa mode before
+    resultCode = LORATRANSCEIVERITF_RESULT_INVALIDSTATE;
+    #if (SX1276_DEBUG_LEVEL0)
+      DEBUG_PRINT_LN("[ERROR] Not configured in LoRa mode");
+      DEBUG_PRINT_CR;
+    #endif
+  }
   return resultCode;
 }
 
 /*****************************************************************************************//**
- * @fn         uint8_t CSX1276_setSyncWord(CSX1276 *this, uint8_t SyncWord)
+ * @fn         uint8_t CSX1276_setSF(CSX1276 *this, uint8_t SpreadingFactor)
  * 
- * @brief      Sets the 'Sync Word' for LoRa radio.
+ * @brief      Sets the Spreading Factor in SX1276.
  * 
- * @details    The function sets the 'Sync Word' used by LoRa radio to detect packet preamble.
+ * @details    The function sets the specified Spreading Factor for LoRa radio.
  *
  * @param      this
  *             The pointer to CSX1276 object.
- *  
- * @param      SyncWord
- *             The value of 'Sync Word' to set for LoRa radio.
- *             In LoRa specification, values are:
- *              - 0x34 for public networks (i.e. compliant with LoRaWAN)
- *              - 0x12 for private networks (typically LoRa)
+ *
+ * @param      SpreadingFactor
+ *             The Spreading Factor value. Allowed values are 'LORATRANSCEIVERITF_SF_xxx'.
+ *             See 'LoraTransceiverItf.h' for details.    
  *
  * @return     The function returns one of the following a result codes:
- *              - LORATRANSCEIVERITF_RESULT_SUCCESS = the 'Sync Word' is set for LoRa radio
+ *              - LORATRANSCEIVERITF_RESULT_SUCCESS = the 'SF' is set for LoRa radio
  *              - LORATRANSCEIVERITF_RESULT_ERROR = error during configuration
+ *              - LORATRANSCEIVERITF_RESULT_INVALIDPARAMS = invalid value specified for SF
  *              - LORATRANSCEIVERITF_RESULT_NOTEXECUTED = the operation has not been executed
 *********************************************************************************************/
-uint8_t CSX1276_setSyncWord(CSX1276 *this, uint8_t SyncWord)
+uint8_t CSX1276_setSF(CSX1276 *this, uint8_t SpreadingFactor)
 {
   BYTE st0;
   uint8_t resultCode = LORATRANSCEIVERITF_RESULT_NOTEXECUTED;
   BYTE config1;
-  register spi_device_handle_t SPIDeviceHandle = this->m_SpiDeviceHandle;
+  BYTE config2;
 
   #if (SX1276_DEBUG_LEVEL0)
-    DEBUG_PRINT_LN("Starting CSX1276_setSyncWord");
+    DEBUG_PRINT_CR;
+    DEBUG_PRINT_LN("[INFO] Starting 'CSX1276_setSF'");
   #endif
 
-  // Should never occur
+  if (CSX1276_isSF(SpreadingFactor) == false)
+  { 
+    // Checking allowed values for SpreadingFactor
+    #if (SX1276_DEBUG_LEVEL0)
+      DEBUG_PRINT("[ERROR] Spreadin Factor ");
+      DEBUG_PRINT_HEX(SpreadingFactor);
+      DEBUG_PRINT_LN(" is not a correct value");
+      DEBUG_PRINT_CR;
+    #endif
+    return LORATRANSCEIVERITF_RESULT_INVALIDPARAMS;
+  }
+
   if (this->m_usModemMode != MODEM_MODE_LORA)
   {
+    // Should never occur: Lora mode must be set first
     #if (SX1276_DEBUG_LEVEL0)
-      DEBUG_PRINT_LN("[WARNING] Function called before LoRa mode activated - Switching to LoRa");
+      DEBUG_PRINT("[WARNING] LoRa mode not set, activating now");
     #endif
     if ((resultCode = CSX1276_setLoRa(this)) != LORATRANSCEIVERITF_RESULT_SUCCESS)
     {
@@ -2322,379 +4156,669 @@ uint8_t CSX1276_setSyncWord(CSX1276 *this, uint8_t SyncWord)
     }
   }
 
-  // Save the current OP mode
-  st0 = CSX1276_readRegister(SPIDeviceHandle, REG_OP_MODE);		
-
-  // Set Standby mode to write in registers
+  resultCode = LORATRANSCEIVERITF_RESULT_ERROR;
+
+  // Save the current OP mode
+  st0 = CSX1276_readRegister(this, REG_OP_MODE);  
+
+  // LoRa standby mode
+  if (st0 != LORA_STANDBY_MODE)
+  {
+    CSX1276_writeRegister(this, REG_OP_MODE, LORA_STANDBY_MODE);  
+  }
+  
+  // Read config1 to modify only the LowDataRateOptimize
+  config1 = (CSX1276_readRegister(this, REG_MODEM_CONFIG1));  
+  // Read config2 to modify SF value (bits 7-4)
+  config2 = (CSX1276_readRegister(this, REG_MODEM_CONFIG2));  
+  
+  switch (SpreadingFactor)
+  {
+    case LORATRANSCEIVERITF_SF_6:
+      config2 = config2 & 0b01101111;  // clears bits 7 & 4 from REG_MODEM_CONFIG2
+      config2 = config2 | 0b01100000;  // sets bits 6 & 5 from REG_MODEM_CONFIG2
+      break;
+
+    case LORATRANSCEIVERITF_SF_7: 
+      config2 = config2 & 0b01111111;  // clears bits 7 from REG_MODEM_CONFIG2
+      config2 = config2 | 0b01110000;  // sets bits 6, 5 & 4
+      break;
+        
+    case LORATRANSCEIVERITF_SF_8:  
+      config2 = config2 & 0b10001111;  // clears bits 6, 5 & 4 from REG_MODEM_CONFIG2
+      config2 = config2 | 0b10000000;  // sets bit 7 from REG_MODEM_CONFIG2
+      break;
+        
+    case LORATRANSCEIVERITF_SF_9:  
+      config2 = config2 & 0b10011111;  // clears bits 6, 5 & 4 from REG_MODEM_CONFIG2
+      config2 = config2 | 0b10010000;  // sets bits 7 & 4 from REG_MODEM_CONFIG2
+      break;
+        
+    case LORATRANSCEIVERITF_SF_10: config2 = config2 & 0b10101111;  // clears bits 6 & 4 from REG_MODEM_CONFIG2
+      config2 = config2 | 0b10100000;  // sets bits 7 & 5 from REG_MODEM_CONFIG2
+      break;
+        
+    case LORATRANSCEIVERITF_SF_11: 
+      config2 = config2 & 0b10111111;  // clears bit 6 from REG_MODEM_CONFIG2
+      config2 = config2 | 0b10110000;  // sets bits 7, 5 & 4 from REG_MODEM_CONFIG2
+      CSX1276_getBW(this);
+      if (this->m_usBandwidth == LORATRANSCEIVERITF_BANDWIDTH_125)
+      { 
+        // LowDataRateOptimize (Mandatory with LORATRANSCEIVERITF_SF_11 if LORATRANSCEIVERITF_BANDWIDTH_125)
+        BYTE config3 = CSX1276_readRegister(this, REG_MODEM_CONFIG3);
+        config3 = config3 | 0b00001000;
+        CSX1276_writeRegister(this, REG_MODEM_CONFIG3, config3);
+      }
+      break;
+        
+    case LORATRANSCEIVERITF_SF_12: 
+      config2 = config2 & 0b11001111;  // clears bits 5 & 4 from REG_MODEM_CONFIG2
+      config2 = config2 | 0b11000000;  // sets bits 7 & 6 from REG_MODEM_CONFIG2
+      CSX1276_getBW(this);
+      if (this->m_usBandwidth == LORATRANSCEIVERITF_BANDWIDTH_125)
+      { 
+        // LowDataRateOptimize (Mandatory with LORATRANSCEIVERITF_SF_12 if LORATRANSCEIVERITF_BANDWIDTH_125)
+        BYTE config3 = CSX1276_readRegister(this, REG_MODEM_CONFIG3);
+        config3 = config3 | 0b00001000;
+        CSX1276_writeRegister(this, REG_MODEM_CONFIG3, config3);
+      }
+      break;
+  }
+  
+  // Check if it is neccesary to set special settings for SF=6
+  if (SpreadingFactor == LORATRANSCEIVERITF_SF_6)
+  {   
+    // Mandatory headerOFF with SF = 6 (Implicit mode)
+    CSX1276_setHeaderOFF(this); 
+    
+    // Set the bit field DetectionOptimize of 
+    // register RegLoRaDetectOptimize to value "0b101".
+    CSX1276_writeRegister(this, REG_DETECT_OPTIMIZE, 0x05);
+    
+    // Write 0x0C in the register RegDetectionThreshold.            
+    CSX1276_writeRegister(this, REG_DETECTION_THRESHOLD, 0x0C);
+  }
+  else
+  {
+    // added by C. Pham
+    CSX1276_setHeaderON(this);
+
+    // LoRa detection Optimize: 0x03 --> SF7 to SF12
+    CSX1276_writeRegister(this, REG_DETECT_OPTIMIZE, 0x03);
+    
+    // LoRa detection threshold: 0x0A --> SF7 to SF12         
+    CSX1276_writeRegister(this, REG_DETECTION_THRESHOLD, 0x0A);   
+  }
+  
+  // Set the AgcAutoOn in bit 2 of REG_MODEM_CONFIG3
+  BYTE config3 = CSX1276_readRegister(this, REG_MODEM_CONFIG3);
+  config3 = config3 | 0b00000100;
+  CSX1276_writeRegister(this, REG_MODEM_CONFIG3, config3);
+
+  // Update 'config2'
+  CSX1276_writeRegister(this, REG_MODEM_CONFIG2, config2);    
+  
+  // Read 'config1' and 'config2' to check update
+  config1 = (CSX1276_readRegister(this, REG_MODEM_CONFIG3));
+  config2 = (CSX1276_readRegister(this, REG_MODEM_CONFIG2));
+  
+  // (config2 >> 4) ---> take out bits 7-4 from REG_MODEM_CONFIG2 (=_spreadingFactor)
+  // bitRead(config1, 0) ---> take out bit 3 from REG_MODEM_CONFIG3 (=LowDataRateOptimize)
+  // LowDataRateOptimize is in REG_MODEM_CONFIG3
+  switch (SpreadingFactor)
+  {
+    case LORATRANSCEIVERITF_SF_6:
+      if (((config2 >> 4) == SpreadingFactor) && (bitRead(config1, 2) == 1) && (this->m_usHeader == SX1276_HEADER_OFF))
+      {
+        resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
+      }
+      break;
+    case LORATRANSCEIVERITF_SF_7:  
+      if (((config2 >> 4) == 0x07) && (bitRead(config1, 2) == 1))
+      {
+        resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
+      }
+      break;
+    case LORATRANSCEIVERITF_SF_8:  
+      if (((config2 >> 4) == 0x08) && (bitRead(config1, 2) == 1))
+      {
+        resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
+      }
+      break;
+    case LORATRANSCEIVERITF_SF_9:  
+      if (((config2 >> 4) == 0x09) && (bitRead(config1, 2) == 1))
+      {
+        resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
+      }
+      break;
+    case LORATRANSCEIVERITF_SF_10: 
+      if (((config2 >> 4) == 0x0A) && (bitRead(config1, 2) == 1))
+      {
+        resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
+      }
+      break;
+    case LORATRANSCEIVERITF_SF_11: 
+      if (((config2 >> 4) == 0x0B) && (bitRead(config1, 2) == 1) && (bitRead(config1, 3) == 1))
+      {
+        resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
+      }
+      break;
+    case LORATRANSCEIVERITF_SF_12: 
+      if (((config2 >> 4) == 0x0C) && (bitRead(config1, 2) == 1) && (bitRead(config1, 3) == 1))
+      {
+        resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
+      }
+      break;
+    default:  
+      resultCode = LORATRANSCEIVERITF_RESULT_ERROR;
+  }
+
+  // Restore previous OP Mode
   if (st0 != LORA_STANDBY_MODE)
   {
-    CSX1276_writeRegister(SPIDeviceHandle, REG_OP_MODE, LORA_STANDBY_MODE);		
+    CSX1276_writeRegister(this, REG_OP_MODE, st0);  
   }
-  CSX1276_writeRegister(SPIDeviceHandle, REG_SYNC_WORD, SyncWord);
-
-  // Delay 100ms
-  vTaskDelay(pdMS_TO_TICKS(100));
-
-  config1 = CSX1276_readRegister(SPIDeviceHandle, REG_SYNC_WORD);
 
-  if (config1 == SyncWord) 
-  {
-    this->m_usSyncWord = SyncWord;
-    resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
+  if (resultCode == LORATRANSCEIVERITF_RESULT_SUCCESS)
+  { 
+    this->m_usSpreadingFactor = SpreadingFactor;
     #if (SX1276_DEBUG_LEVEL0)
-      DEBUG_PRINT("[OK] Sync word set: ");
-      DEBUG_PRINT_HEX(SyncWord);
+      DEBUG_PRINT("[INFO] Spreading factor ");
+      DEBUG_PRINT_DEC(SpreadingFactor);
+      DEBUG_PRINT_LN(" has been successfully set");
       DEBUG_PRINT_CR;
     #endif
   }
-  else 
+  else
   {
-    resultCode = LORATRANSCEIVERITF_RESULT_ERROR;
     #if (SX1276_DEBUG_LEVEL0)
-      DEBUG_PRINT_LN("[ERROR] Unable to set Sync Word");
+      DEBUG_PRINT("[ERROR] Failed to set spreading factor");
+      DEBUG_PRINT_CR;
     #endif
   }
-
-  if (st0 != LORA_STANDBY_MODE)
-  {
-    // Get back to previous OP mode
-    CSX1276_writeRegister(SPIDeviceHandle, REG_OP_MODE, st0);	
-  }
-
-  // Delay 100ms
-  vTaskDelay(pdMS_TO_TICKS(100));
-
   return resultCode;
 }
 
 /*****************************************************************************************//**
- * @fn         uint8_t CSX1276_setHeaderON(CSX1276 *this)
+ * @fn         uint8_t  CSX1276_setBW(CSX1276 *this, uint16_t BandWidth)
  * 
- * @brief      Sets the SX1276 in explicit header mode (header is sent).
+ * @brief      Sets the Bandwidth in SX1276.
  * 
- * @details    The function configures the SX1276 to put the 'Header' field in LoRa messages.
+ * @details    The function sets the specified Bandwidth for LoRa radio.
  *
  * @param      this
  *             The pointer to CSX1276 object.
- *  
+ *
+ * @param      BandWidth
+ *             The bandwidth value. Allowed values are 'LORATRANSCEIVERITF_BANDWIDTH_xxx'.
+ *             See 'LoraTransceiverItf.h' for details.    
+ *
  * @return     The function returns one of the following a result codes:
- *              - LORATRANSCEIVERITF_RESULT_SUCCESS = the 'Header' is set to ON for LoRa radio
+ *              - LORATRANSCEIVERITF_RESULT_SUCCESS = the 'BW' is set for LoRa radio
  *              - LORATRANSCEIVERITF_RESULT_ERROR = error during configuration
+ *              - LORATRANSCEIVERITF_RESULT_INVALIDPARAMS = invalid bandwidth value specified
  *              - LORATRANSCEIVERITF_RESULT_NOTEXECUTED = the operation has not been executed
- *              - LORATRANSCEIVERITF_RESULT_INVALIDSTATE = Function called on invalid state
 *********************************************************************************************/
-uint8_t CSX1276_setHeaderON(CSX1276 *this)
+uint8_t  CSX1276_setBW(CSX1276 *this, uint16_t BandWidth)
 {
+  BYTE st0;
   int8_t resultCode = LORATRANSCEIVERITF_RESULT_NOTEXECUTED;
   BYTE config1;
-  register spi_device_handle_t SPIDeviceHandle = this->m_SpiDeviceHandle;
 
   #if (SX1276_DEBUG_LEVEL0)
     DEBUG_PRINT_CR;
-    DEBUG_PRINT_LN("Starting 'CSX1276_setHeaderON'");
+    DEBUG_PRINT_LN("Starting 'setBW'");
   #endif
 
-  if (this->m_usModemMode != MODEM_MODE_LORA)
+  if (CSX1276_isBW(BandWidth) == false)
   {
-    // Should never occur: must be configured in LoRa mode before
-    resultCode = LORATRANSCEIVERITF_RESULT_INVALIDSTATE;  
     #if (SX1276_DEBUG_LEVEL0)
-      DEBUG_PRINT_LN("[ERROR] Not configured in LoRa mode");
+      DEBUG_PRINT("[ERROR] Bandwidth ");
+      DEBUG_PRINT_HEX(BandWidth);
+      DEBUG_PRINT_LN(" is not a correct value");
       DEBUG_PRINT_CR;
     #endif
+    return LORATRANSCEIVERITF_RESULT_INVALIDPARAMS;
   }
-  else
+
+  if (this->m_usModemMode != MODEM_MODE_LORA)
   {
-    // Save config1 to modify only the header bit
-    config1 = CSX1276_readRegister(SPIDeviceHandle, REG_MODEM_CONFIG1);  
-    if (this->m_usSpreadingFactor == 6)
-    {
-      // Mandatory headerOFF with SF = 6
-      resultCode = LORATRANSCEIVERITF_RESULT_INVALIDSTATE;   
-      #if (SX1276_DEBUG_LEVEL0)
-        DEBUG_PRINT_LN("[ERROR] Mandatory implicit header mode with spreading factor = 6");
-      #endif
-    }
-    else
+    // Should never occur: Lora mode must be set first
+    #if (SX1276_DEBUG_LEVEL0)
+      DEBUG_PRINT("[WARNING] LoRa mode not set, activating now");
+    #endif
+    if ((resultCode = CSX1276_setLoRa(this)) != LORATRANSCEIVERITF_RESULT_SUCCESS)
     {
-      // Clear bit 0 from config1 (= headerON) and update config1
-      config1 = config1 & 0b11111110;                                     
-      CSX1276_writeRegister(SPIDeviceHandle, REG_MODEM_CONFIG1, config1);
+      return resultCode;
     }
-    if (this->m_usSpreadingFactor != 6 )
-    {
-      // Check headerON taking out bit 0 from REG_MODEM_CONFIG1
-      config1 = CSX1276_readRegister(SPIDeviceHandle, REG_MODEM_CONFIG1);
-      if (bitRead(config1, 0) == 0)
+  }
+
+  resultCode = LORATRANSCEIVERITF_RESULT_ERROR;
+
+  // Save the previous OP mode
+  st0 = CSX1276_readRegister(this, REG_OP_MODE);    
+
+  // LoRa standby mode
+  if (st0 != LORA_STANDBY_MODE)
+  {
+    CSX1276_writeRegister(this, REG_OP_MODE, LORA_STANDBY_MODE); 
+  }
+
+  // Save config1 to modify only the BW and clear bits 7 - 4 from REG_MODEM_CONFIG1
+  config1 = (CSX1276_readRegister(this, REG_MODEM_CONFIG1));   
+  config1 = config1 & 0b00001111;	                                        
+  switch (BandWidth)
+  {
+    case LORATRANSCEIVERITF_BANDWIDTH_125: 
+      // 0111
+      config1 = config1 | 0b01110000;
+      CSX1276_getSF(this);
+      if (this->m_usSpreadingFactor == 11 || this->m_usSpreadingFactor == 12)
+      { 
+        // LowDataRateOptimize (Mandatory with LORATRANSCEIVERITF_BANDWIDTH_125 if LORATRANSCEIVERITF_SF_11 or LORATRANSCEIVERITF_SF_12)
+        BYTE config3 = CSX1276_readRegister(this, REG_MODEM_CONFIG3);
+        config3 = config3 | 0b00001000;
+        CSX1276_writeRegister(this, REG_MODEM_CONFIG3, config3);
+      }
+      break;
+    case LORATRANSCEIVERITF_BANDWIDTH_250: 
+      // 1000
+      config1 = config1 | 0b10000000;
+      break;
+    case LORATRANSCEIVERITF_BANDWIDTH_500: 
+      // 1001
+      config1 = config1 | 0B10010000;
+      break;
+  }
+  // Update config1
+  CSX1276_writeRegister(this, REG_MODEM_CONFIG1, config1);   
+
+  config1 = CSX1276_readRegister(this, REG_MODEM_CONFIG1);
+
+  // (config1 >> 4) ---> take out bits 7-4 from REG_MODEM_CONFIG1 (=_bandwidth)
+  switch (BandWidth)
+  {
+    case LORATRANSCEIVERITF_BANDWIDTH_125: 
+      if ((config1 >> 4) == LORATRANSCEIVERITF_BANDWIDTH_125)
       {
         resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
-        this->m_usHeader = SX1276_HEADER_ON;
-        #if (SX1276_DEBUG_LEVEL0)
-          DEBUG_PRINT_LN("[INFO] Header has been activated");
-          DEBUG_PRINT_CR;
-        #endif
+        BYTE config3 = CSX1276_readRegister(this, REG_MODEM_CONFIG3);
+
+        if ((this->m_usSpreadingFactor == 11) || (this->m_usSpreadingFactor == 12))
+        {
+          if (bitRead(config3, 3) != 1)
+          {
+            // No LowDataRateOptimize
+            resultCode = LORATRANSCEIVERITF_RESULT_ERROR;
+          }
+        }
       }
-      else
+      break;
+    case LORATRANSCEIVERITF_BANDWIDTH_250: 
+      if ((config1 >> 4) == LORATRANSCEIVERITF_BANDWIDTH_250)
       {
-        resultCode = LORATRANSCEIVERITF_RESULT_ERROR;
-        #if (SX1276_DEBUG_LEVEL0)
-          DEBUG_PRINT_LN("[ERROR] Failed to activate header");
-          DEBUG_PRINT_CR;
-        #endif
+        resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
       }
-    }
+      break;
+    case LORATRANSCEIVERITF_BANDWIDTH_500: 
+      if ((config1 >> 4) == LORATRANSCEIVERITF_BANDWIDTH_500)
+      {
+        resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
+      }
+      break;
   }
-  return resultCode;
-}
-
-/*****************************************************************************************//**
- * @fn         uint8_t CSX1276_setHeaderOFF(CSX1276 *this)
- * 
- * @brief      Sets the SX1276 in implicit header mode (header is not sent).
- * 
- * @details    The function configures the SX1276 to not put the 'Header' field in LoRa messages.
- *
- * @param      this
- *             The pointer to CSX1276 object.
- *  
- * @return     The function returns one of the following a result codes:
- *              - LORATRANSCEIVERITF_RESULT_SUCCESS = the 'Header' is set to OFF for LoRa radio
- *              - LORATRANSCEIVERITF_RESULT_ERROR = error during configuration
- *              - LORATRANSCEIVERITF_RESULT_INVALIDSTATE = Function called on invalid state
-*********************************************************************************************/
-uint8_t  CSX1276_setHeaderOFF(CSX1276 *this)
-{
-  uint8_t resultCode = LORATRANSCEIVERITF_RESULT_NOTEXECUTED;
-  BYTE config1;
-  register spi_device_handle_t SPIDeviceHandle = this->m_SpiDeviceHandle;
-
-  #if (SX1276_DEBUG_LEVEL0)
-    DEBUG_PRINT_CR;
-    DEBUG_PRINT_LN("Starting 'CSX1276_setHeaderOFF'");
-  #endif
 
-  if (this->m_usModemMode != MODEM_MODE_LORA)
-  { 
-    // Should never occur: must be configured in LoRa mode before
-    resultCode = LORATRANSCEIVERITF_RESULT_INVALIDSTATE;
+  if (resultCode != LORATRANSCEIVERITF_RESULT_SUCCESS)
+  {
     #if (SX1276_DEBUG_LEVEL0)
-      DEBUG_PRINT_LN("[ERROR] Not configured in LoRa mode");
-      DEBUG_PRINT_CR;
+      DEBUG_PRINT_LN("[ERROR] Failed to set bandwidth");
     #endif
   }
   else
   {
-    // Read config1 to modify only the header bit
-    config1 = CSX1276_readRegister(SPIDeviceHandle, REG_MODEM_CONFIG1);  
-    
-    // Set bit 0 from REG_MODEM_CONFIG1 (= headerOFF) and update Config1
-    config1 = config1 | 0b00000001;    
-    CSX1276_writeRegister(SPIDeviceHandle, REG_MODEM_CONFIG1, config1);   
-
-    // Check register
-    config1 = CSX1276_readRegister(SPIDeviceHandle, REG_MODEM_CONFIG1);
-    if (bitRead(config1, 0) == SX1276_HEADER_OFF)
-    { 
-      // Checking headerOFF taking out bit 2 from REG_MODEM_CONFIG1
-      resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
-      this->m_usHeader = SX1276_HEADER_OFF;
+    this->m_usBandwidth = BandWidth;
+    #if (SX1276_DEBUG_LEVEL0)
+      DEBUG_PRINT("[INFO] Bandwidth ");
+      DEBUG_PRINT_HEX(BandWidth);
+      DEBUG_PRINT_LN(" has been successfully set");
+      DEBUG_PRINT_CR;
+    #endif
+  }
 
-      #if (SX1276_DEBUG_LEVEL0)
-          DEBUG_PRINT_LN("[INFO] Header has been desactivated");
-          DEBUG_PRINT_CR;
-      #endif
-    }
-    else
-    {
-      resultCode = LORATRANSCEIVERITF_RESULT_ERROR;
-      #if (SX1276_DEBUG_LEVEL0)
-        DEBUG_PRINT_LN("[ERROR] Failed to desactivate header");
-        DEBUG_PRINT_CR;
-      #endif
-    }
+  // Restore previous OP mode
+  if (st0 != LORA_STANDBY_MODE)
+  {
+    CSX1276_writeRegister(this, REG_OP_MODE, st0);
   }
   return resultCode;
 }
 
 /*****************************************************************************************//**
- * @fn         uint8_t CSX1276_setCRC_ON(CSX1276 *this)
+ * @fn         uint8_t CSX1276_setCR(CSX1276 *this, uint8_t CodingRate)
  * 
- * @brief      Sets the SX1276 with CRC ON.
+ * @brief      Sets the Coding Rate in SX1276.
  * 
- * @details    The function configures the SX1276 to put the 'CRC' field in LoRa messages.
+ * @details    The function sets the specified Codding Rate for LoRa radio.
  *
  * @param      this
  *             The pointer to CSX1276 object.
- *  
+ *
+ * @param      CodingRate
+ *             The coding rate value. Allowed values are 'LORATRANSCEIVERITF_CR_x'.
+ *             See 'LoraTransceiverItf.h' for details.    
+ *
  * @return     The function returns one of the following a result codes:
- *              - LORATRANSCEIVERITF_RESULT_SUCCESS = the 'CRC' is set to ON for LoRa radio
+ *              - LORATRANSCEIVERITF_RESULT_SUCCESS = the 'CR' is set for LoRa radio
  *              - LORATRANSCEIVERITF_RESULT_ERROR = error during configuration
- *              - LORATRANSCEIVERITF_RESULT_INVALIDSTATE = Function called on invalid state
+ *              - LORATRANSCEIVERITF_RESULT_INVALIDPARAMS = invalid CR value specified
+ *              - LORATRANSCEIVERITF_RESULT_NOTEXECUTED = the operation has not been executed
 *********************************************************************************************/
-uint8_t CSX1276_setCRC_ON(CSX1276 *this)
+uint8_t CSX1276_setCR(CSX1276 *this, uint8_t CodingRate)
 {
-  uint8_t resultCode = LORATRANSCEIVERITF_RESULT_NOTEXECUTED;
+  BYTE st0;
+  int8_t resultCode = LORATRANSCEIVERITF_RESULT_NOTEXECUTED;
   BYTE config1;
-  register spi_device_handle_t SPIDeviceHandle = this->m_SpiDeviceHandle;
 
   #if (SX1276_DEBUG_LEVEL0)
     DEBUG_PRINT_CR;
-    DEBUG_PRINT_LN("[INFO] Starting 'CSX1276_setCRC_ON'");
+    DEBUG_PRINT_LN("[INFO] Starting 'CSX1276_setCR'");
   #endif
 
-  if (this->m_usModemMode == MODEM_MODE_LORA)
-  { 
-    // LORA mode
-    config1 = CSX1276_readRegister(SPIDeviceHandle, REG_MODEM_CONFIG2);  // Save config2 to modify only the CRC bit
-    config1 = config1 | 0b00000100;                                      // sets bit 2 from REG_MODEM_CONFIG2 = CRC_ON
-    CSX1276_writeRegister(SPIDeviceHandle, REG_MODEM_CONFIG2, config1);
+  if (CSX1276_isCR(CodingRate) == false)
+  {
+    #if (SX1276_DEBUG_LEVEL0)
+      DEBUG_PRINT("[ERROR] Coding Rate ");
+      DEBUG_PRINT_HEX(CodingRate);
+      DEBUG_PRINT_LN(" is not a correct value");
+      DEBUG_PRINT_CR;
+    #endif
+    return LORATRANSCEIVERITF_RESULT_INVALIDPARAMS;
+  }
 
-    config1 = CSX1276_readRegister(SPIDeviceHandle, REG_MODEM_CONFIG2);
-    if (bitRead(config1, 2) == SX1276_CRC_ON)
-    {
-      // take out bit 2 from REG_MODEM_CONFIG2 indicates RxPayloadCrcOn
-      resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
-      this->m_usCRC = SX1276_CRC_ON;
-      #if (SX1276_DEBUG_LEVEL0)
-        DEBUG_PRINT_LN("[INFO] CRC has been activated");
-        DEBUG_PRINT_CR;
-      #endif
-    }
-    else
+  if (this->m_usModemMode != MODEM_MODE_LORA)
+  {
+    // Should never occur: Lora mode must be set first
+    #if (SX1276_DEBUG_LEVEL0)
+      DEBUG_PRINT("[WARNING] LoRa mode not set, activating now");
+    #endif
+    if ((resultCode = CSX1276_setLoRa(this)) != LORATRANSCEIVERITF_RESULT_SUCCESS)
     {
-      resultCode = LORATRANSCEIVERITF_RESULT_ERROR;
-      #if (SX1276_DEBUG_LEVEL0)
-        DEBUG_PRINT_LN("[ERROR] Failed to set CRC ON");
-        DEBUG_PRINT_CR;
-      #endif
+      return resultCode;
     }
   }
+
+  resultCode = LORATRANSCEIVERITF_RESULT_ERROR;
+
+  // Save the current OP mode
+  st0 = CSX1276_readRegister(this, REG_OP_MODE);
+
+  // Set Standby mode to write in registers
+  if (st0 != LORA_STANDBY_MODE)
+  {
+    CSX1276_writeRegister(this, REG_OP_MODE, LORA_STANDBY_MODE);
+  }
+
+  // Save config1 to modify only the CR and clear bits 3 - 1 from REG_MODEM_CONFIG1
+  config1 = CSX1276_readRegister(this, REG_MODEM_CONFIG1);  
+  config1 = config1 & 0b11110001;	               
+
+  switch (CodingRate)
+  {
+    case LORATRANSCEIVERITF_CR_5:
+      config1 = config1 | 0b00000010;
+      break;
+    case LORATRANSCEIVERITF_CR_6:
+      config1 = config1 | 0b00000100;
+      break;
+    case LORATRANSCEIVERITF_CR_7:
+      config1 = config1 | 0b00000110;
+      break;
+    case LORATRANSCEIVERITF_CR_8:
+      config1 = config1 | 0b00001000;
+      break;
+  }
+  CSX1276_writeRegister(this, REG_MODEM_CONFIG1, config1);    // Update config1
+
+  config1 = CSX1276_readRegister(this, REG_MODEM_CONFIG1);
+
+  // ((config1 >> 1) & 0b0000111) ---> take out bits 3-1 from REG_MODEM_CONFIG1 (=_codingRate)
+  switch (CodingRate)
+  {
+    case LORATRANSCEIVERITF_CR_5:
+      if (((config1 >> 1) & 0b0000111) == 0x01)
+      {
+        resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
+      }
+      break;
+    case LORATRANSCEIVERITF_CR_6:
+      if (((config1 >> 1) & 0b0000111) == 0x02)
+      {
+        resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
+      }
+      break;
+    case LORATRANSCEIVERITF_CR_7:
+      if (((config1 >> 1) & 0b0000111) == 0x03)
+      {
+        resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
+      }
+      break;
+    case LORATRANSCEIVERITF_CR_8:
+      if (((config1 >> 1) & 0b0000111) == 0x04)
+      {
+        resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
+      }
+      break;
+  }
+
+  if (resultCode != LORATRANSCEIVERITF_RESULT_SUCCESS)
+  {
+    #if (SX1276_DEBUG_LEVEL0)
+      DEBUG_PRINT_LN("[ERROR] Failed to set Coding Rate");
+    #endif
+  }
   else
-  { 
-    // Should never occur: must be configured in LoRa mode before
-    resultCode = LORATRANSCEIVERITF_RESULT_INVALIDSTATE;
+  {
+    this->m_usCodingRate = CodingRate;
+
+    // Store current coding rate information (i.e. text value retrieved by client object when a 
+    // LoraPacket is received)
+    strcpy((char *) this->m_ReceivedPacketInfo.m_szCodingRate, CSX1276_getCRTextValue(CodingRate));
+
     #if (SX1276_DEBUG_LEVEL0)
-      DEBUG_PRINT_LN("[ERROR] Not configured in LoRa mode");
+      DEBUG_PRINT("[INFO] Coding Rate ");
+      DEBUG_PRINT_HEX(CodingRate);
+      DEBUG_PRINT_LN(" has been successfully set");
       DEBUG_PRINT_CR;
     #endif
   }
+
+  // Restore previous OP mode
+  if (st0 != LORA_STANDBY_MODE)
+  {
+    CSX1276_writeRegister(this, REG_OP_MODE, st0); 
+  }
   return resultCode;
 }
 
 /*****************************************************************************************//**
- * @fn         uint8_t CSX1276_setCRC_OFF(CSX1276 *this)
+ * @fn         uint8_t CSX1276_setChannel(CSX1276 *this, uint8_t FreqChannel)
  * 
- * @brief      Sets the SX1276 with CRC OFF.
+ * @brief      Sets the Frequency Channel in SX1276.
  * 
- * @details    The function configures the SX1276 to not put the 'CRC' field in LoRa messages.
+ * @details    The function sets the specified Frequency Channel for LoRa radio.
  *
  * @param      this
  *             The pointer to CSX1276 object.
- *  
+ *
+ * @param      FreqChannel
+ *             The frequency channel value. Allowed values are 'LORATRANSCEIVERITF_FREQUENCY_CHANNEL_xx'.
+ *             See 'LoraTransceiverItf.h' for details.    
+ *
  * @return     The function returns one of the following a result codes:
- *              - LORATRANSCEIVERITF_RESULT_SUCCESS = the 'CRC' is set to OFF for LoRa radio
+ *              - LORATRANSCEIVERITF_RESULT_SUCCESS = the 'FrequencyChannel' is set for LoRa radio
  *              - LORATRANSCEIVERITF_RESULT_ERROR = error during configuration
- *              - LORATRANSCEIVERITF_RESULT_INVALIDSTATE = Function called on invalid state
+ *              - LORATRANSCEIVERITF_RESULT_INVALIDPARAMS = invalid FreqChannel value specified
+ *              - LORATRANSCEIVERITF_RESULT_NOTEXECUTED = the operation has not been executed
 *********************************************************************************************/
-uint8_t CSX1276_setCRC_OFF(CSX1276 *this)
+uint8_t CSX1276_setChannel(CSX1276 *this, uint8_t FreqChannel)
 {
+  BYTE st0;
   int8_t resultCode = LORATRANSCEIVERITF_RESULT_NOTEXECUTED;
-  BYTE config1;
-  register spi_device_handle_t SPIDeviceHandle = this->m_SpiDeviceHandle;
+  uint32_t dwFreqRegValue;
+  unsigned int freq3;
+  unsigned int freq2;
+  uint8_t freq1;
+  uint32_t freq;
 
   #if (SX1276_DEBUG_LEVEL0)
     DEBUG_PRINT_CR;
-    DEBUG_PRINT_LN("[INFO] Starting 'CSX1276_setCRC_OFF'");
+    DEBUG_PRINT_LN("Starting 'setChannel'");
   #endif
 
-  if (this->m_usModemMode == MODEM_MODE_LORA)
-  { 
-    // Save config2 to modify only the CRC bit
-    config1 = CSX1276_readRegister(SPIDeviceHandle, REG_MODEM_CONFIG2);  
-
-    // Clear bit 2 from config2 = CRC_OFF
-    config1 = config1 & 0b11111011;                                      
-    CSX1276_writeRegister(SPIDeviceHandle, REG_MODEM_CONFIG2, config1);
+  if (CSX1276_isChannel(FreqChannel) == false)
+  {
+    #if (SX1276_DEBUG_LEVEL0)
+      DEBUG_PRINT("[ERROR] Frequency Channel ");
+      DEBUG_PRINT_HEX(FreqChannel);
+      DEBUG_PRINT_LN(" is not a correct value");
+      DEBUG_PRINT_CR;
+    #endif
+    return LORATRANSCEIVERITF_RESULT_INVALIDPARAMS;
+  }
 
-    config1 = CSX1276_readRegister(SPIDeviceHandle, REG_MODEM_CONFIG2);
-    if ((bitRead(config1, 2)) == SX1276_CRC_OFF)
-    {
-      // Take out bit 1 from REG_MODEM_CONFIG1 indicates RxPayloadCrcOn
-      resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
-      this->m_usCRC = SX1276_CRC_OFF;
-      #if (SX1276_DEBUG_LEVEL0)
-        DEBUG_PRINT_LN("[INFO] CRC has been desactivated");
-        DEBUG_PRINT_CR;
-      #endif
-    }
-    else
+  if (this->m_usModemMode != MODEM_MODE_LORA)
+  {
+    // Should never occur: Lora mode must be set first
+    #if (SX1276_DEBUG_LEVEL0)
+      DEBUG_PRINT("[WARNING] LoRa mode not set, activating now");
+    #endif
+    if ((resultCode = CSX1276_setLoRa(this)) != LORATRANSCEIVERITF_RESULT_SUCCESS)
     {
-      resultCode = LORATRANSCEIVERITF_RESULT_ERROR;
-      #if (SX1276_DEBUG_LEVEL0)
-        DEBUG_PRINT_LN("[ERROR] Failed to set CRC OFF");
-        DEBUG_PRINT_CR;
-      #endif
+      return resultCode;
     }
   }
-  else
-  { 
-    // Should never occur: must be configured in LoRa mode before
-    resultCode = LORATRANSCEIVERITF_RESULT_INVALIDSTATE;
+
+  // Save the current OP mode
+  st0 = CSX1276_readRegister(this, REG_OP_MODE);  
+
+  // LoRa Stdby mode in order to write in registers
+  if (st0 != LORA_STANDBY_MODE)
+  {
+    CSX1276_writeRegister(this, REG_OP_MODE, LORA_STANDBY_MODE);
+  }
+
+  resultCode = LORATRANSCEIVERITF_RESULT_ERROR;
+
+  dwFreqRegValue = CSX1276_getFreqRegValue(FreqChannel);
+
+  freq3 = ((dwFreqRegValue >> 16) & 0x0FF);   // frequency channel MSB
+  freq2 = ((dwFreqRegValue >> 8) & 0x0FF);    // frequency channel MIB
+  freq1 = (dwFreqRegValue & 0xFF);            // frequency channel LSB
+
+  CSX1276_writeRegister(this, REG_FRF_MSB, freq3);
+  CSX1276_writeRegister(this, REG_FRF_MID, freq2);
+  CSX1276_writeRegister(this, REG_FRF_LSB, freq1);
+
+  // Store MSB in freq channel value
+  freq3 = (CSX1276_readRegister(this, REG_FRF_MSB));
+  freq = (freq3 << 8) & 0xFFFFFF;
+
+  // Store MID in freq channel value
+  freq2 = (CSX1276_readRegister(this, REG_FRF_MID));
+  freq = (freq << 8) + ((freq2 << 8) & 0xFFFFFF);
+
+  // Store LSB in freq channel value
+  freq = freq + ((CSX1276_readRegister(this, REG_FRF_LSB)) & 0xFFFFFF);
+
+  if (freq == dwFreqRegValue)
+  {
+    resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
+    this->m_usFreqChannel = FreqChannel;
+    this->m_dwRegFreqChannel = dwFreqRegValue;
     #if (SX1276_DEBUG_LEVEL0)
-      DEBUG_PRINT_LN("[ERROR] Not configured in LoRa mode");
+      DEBUG_PRINT("[INFO] Frequency channel ");
+      DEBUG_PRINT_HEX(FreqChannel);
+      DEBUG_PRINT_LN(" has been successfully set");
       DEBUG_PRINT_CR;
     #endif
   }
+
+  // Restore previous OP mode
+  if (st0 != LORA_STANDBY_MODE)
+  {
+    CSX1276_writeRegister(this, REG_OP_MODE, st0);  
+  }
   return resultCode;
 }
 
 /*****************************************************************************************//**
- * @fn         uint8_t CSX1276_setSF(CSX1276 *this, uint8_t SpreadingFactor)
+ * @fn         uint8_t CSX1276_setPowerMode(CSX1276 *this, uint8_t PowerMode)
  * 
- * @brief      Sets the Spreading Factor in SX1276.
+ * @brief      Sets the Power Mode in SX1276.
  * 
- * @details    The function sets the specified Spreading Factor for LoRa radio.
+ * @details    The function sets the specified predefined Power level for LoRa radio.
  *
  * @param      this
  *             The pointer to CSX1276 object.
  *
- * @param      SpreadingFactor
- *             The Spreading Factor value. Allowed values are 'LORATRANSCEIVERITF_SF_xxx'.
+ * @param      PowerMode
+ *             The power mode value. Allowed values are 'LORATRANSCEIVERITF_POWER_MODE_xx'.
  *             See 'LoraTransceiverItf.h' for details.    
  *
  * @return     The function returns one of the following a result codes:
- *              - LORATRANSCEIVERITF_RESULT_SUCCESS = the 'SF' is set for LoRa radio
+ *              - LORATRANSCEIVERITF_RESULT_SUCCESS = the 'PowerMode' is set for LoRa radio
  *              - LORATRANSCEIVERITF_RESULT_ERROR = error during configuration
- *              - LORATRANSCEIVERITF_RESULT_INVALIDPARAMS = invalid value specified for SF
+ *              - LORATRANSCEIVERITF_RESULT_INVALIDPARAMS = invalid 'PowerMode' value specified
  *              - LORATRANSCEIVERITF_RESULT_NOTEXECUTED = the operation has not been executed
 *********************************************************************************************/
-uint8_t CSX1276_setSF(CSX1276 *this, uint8_t SpreadingFactor)
+uint8_t CSX1276_setPowerMode(CSX1276 *this, uint8_t PowerMode)
 {
   BYTE st0;
-  uint8_t resultCode = LORATRANSCEIVERITF_RESULT_NOTEXECUTED;
-  BYTE config1;
-  BYTE config2;
-  register spi_device_handle_t SPIDeviceHandle = this->m_SpiDeviceHandle;
+  int8_t resultCode = LORATRANSCEIVERITF_RESULT_NOTEXECUTED;
+  BYTE value = 0x00;
 
   #if (SX1276_DEBUG_LEVEL0)
     DEBUG_PRINT_CR;
-    DEBUG_PRINT_LN("[INFO] Starting 'CSX1276_setSF'");
+    DEBUG_PRINT_LN("[INFO] Starting 'CSX1276_setPowerMode'");
   #endif
 
-  if (CSX1276_isSF(SpreadingFactor) == false)
-  { 
-    // Checking allowed values for SpreadingFactor
-    #if (SX1276_DEBUG_LEVEL0)
-      DEBUG_PRINT("[ERROR] Spreadin Factor ");
-      DEBUG_PRINT_HEX(SpreadingFactor);
-      DEBUG_PRINT_LN(" is not a correct value");
-      DEBUG_PRINT_CR;
-    #endif
-    return LORATRANSCEIVERITF_RESULT_INVALIDPARAMS;
+  switch (PowerMode)
+  {
+    // LOW  = On SX1272/76: PA0 on RFO setting
+    // HIGH = On SX1272/76: PA0 on RFO setting
+    // MAX  = On SX1272/76: PA0 on RFO setting
+
+    // BOOST  = extreme; added by C. Pham. On SX1272/76: PA1&PA2 PA_BOOST setting
+    // BOOST2 = extreme; added by C. Pham. On SX1272/76: PA1&PA2 PA_BOOST setting + 20dBm settings
+    case LORATRANSCEIVERITF_POWER_MODE_BOOST:
+    case LORATRANSCEIVERITF_POWER_MODE_BOOST2:
+    case LORATRANSCEIVERITF_POWER_MODE_MAX:  
+      // SX1272/76: 14dBm
+      value = 0x0F;
+      break;
+
+    case LORATRANSCEIVERITF_POWER_MODE_LOW:
+      // SX1272/76: 2dBm
+      value = 0x03;
+      break;
+
+    case LORATRANSCEIVERITF_POWER_MODE_HIGH:
+      // SX1272/76: 6dBm
+      value = 0x07;
+      break;
+
+    default:
+      #if (SX1276_DEBUG_LEVEL0)
+        DEBUG_PRINT("[ERROR] Power Mode ");
+        DEBUG_PRINT_HEX(PowerMode);
+        DEBUG_PRINT_LN(" is not a correct value");
+        DEBUG_PRINT_CR;
+      #endif
+      return LORATRANSCEIVERITF_RESULT_INVALIDPARAMS;
   }
 
   if (this->m_usModemMode != MODEM_MODE_LORA)
-  {
+  { 
     // Should never occur: Lora mode must be set first
     #if (SX1276_DEBUG_LEVEL0)
       DEBUG_PRINT("[WARNING] LoRa mode not set, activating now");
@@ -2705,226 +4829,128 @@ uint8_t CSX1276_setSF(CSX1276 *this, uint8_t SpreadingFactor)
     }
   }
 
-  resultCode = LORATRANSCEIVERITF_RESULT_ERROR;
-
-  // Save the current OP mode
-  st0 = CSX1276_readRegister(SPIDeviceHandle, REG_OP_MODE);  
+  // Save current OP modes
+  st0 = CSX1276_readRegister(this, REG_OP_MODE);    
 
-  // LoRa standby mode
+  // LoRa Stdby mode in order to write in registers
   if (st0 != LORA_STANDBY_MODE)
   {
-    CSX1276_writeRegister(SPIDeviceHandle, REG_OP_MODE, LORA_STANDBY_MODE);  
+    CSX1276_writeRegister(this, REG_OP_MODE, LORA_STANDBY_MODE);
   }
-  
-  // Read config1 to modify only the LowDataRateOptimize
-  config1 = (CSX1276_readRegister(SPIDeviceHandle, REG_MODEM_CONFIG1));  
-  // Read config2 to modify SF value (bits 7-4)
-  config2 = (CSX1276_readRegister(SPIDeviceHandle, REG_MODEM_CONFIG2));  
-  
-  switch (SpreadingFactor)
-  {
-    case LORATRANSCEIVERITF_SF_6:
-      config2 = config2 & 0b01101111;  // clears bits 7 & 4 from REG_MODEM_CONFIG2
-      config2 = config2 | 0b01100000;  // sets bits 6 & 5 from REG_MODEM_CONFIG2
-      break;
 
-    case LORATRANSCEIVERITF_SF_7: 
-      config2 = config2 & 0b01111111;  // clears bits 7 from REG_MODEM_CONFIG2
-      config2 = config2 | 0b01110000;  // sets bits 6, 5 & 4
-      break;
-        
-    case LORATRANSCEIVERITF_SF_8:  
-      config2 = config2 & 0b10001111;  // clears bits 6, 5 & 4 from REG_MODEM_CONFIG2
-      config2 = config2 | 0b10000000;  // sets bit 7 from REG_MODEM_CONFIG2
-      break;
-        
-    case LORATRANSCEIVERITF_SF_9:  
-      config2 = config2 & 0b10011111;  // clears bits 6, 5 & 4 from REG_MODEM_CONFIG2
-      config2 = config2 | 0b10010000;  // sets bits 7 & 4 from REG_MODEM_CONFIG2
-      break;
-        
-    case LORATRANSCEIVERITF_SF_10: config2 = config2 & 0b10101111;  // clears bits 6 & 4 from REG_MODEM_CONFIG2
-      config2 = config2 | 0b10100000;  // sets bits 7 & 5 from REG_MODEM_CONFIG2
-      break;
-        
-    case LORATRANSCEIVERITF_SF_11: 
-      config2 = config2 & 0b10111111;  // clears bit 6 from REG_MODEM_CONFIG2
-      config2 = config2 | 0b10110000;  // sets bits 7, 5 & 4 from REG_MODEM_CONFIG2
-      CSX1276_getBW(this);
-      if (this->m_usBandwidth == LORATRANSCEIVERITF_BANDWIDTH_125)
-      { 
-        // LowDataRateOptimize (Mandatory with LORATRANSCEIVERITF_SF_11 if LORATRANSCEIVERITF_BANDWIDTH_125)
-        BYTE config3 = CSX1276_readRegister(SPIDeviceHandle, REG_MODEM_CONFIG3);
-        config3 = config3 | 0b00001000;
-        CSX1276_writeRegister(SPIDeviceHandle, REG_MODEM_CONFIG3, config3);
-      }
-      break;
-        
-    case LORATRANSCEIVERITF_SF_12: 
-      config2 = config2 & 0b11001111;  // clears bits 5 & 4 from REG_MODEM_CONFIG2
-      config2 = config2 | 0b11000000;  // sets bits 7 & 6 from REG_MODEM_CONFIG2
-      CSX1276_getBW(this);
-      if (this->m_usBandwidth == LORATRANSCEIVERITF_BANDWIDTH_125)
-      { 
-        // LowDataRateOptimize (Mandatory with LORATRANSCEIVERITF_SF_12 if LORATRANSCEIVERITF_BANDWIDTH_125)
-        BYTE config3 = CSX1276_readRegister(SPIDeviceHandle, REG_MODEM_CONFIG3);
-        config3 = config3 | 0b00001000;
-        CSX1276_writeRegister(SPIDeviceHandle, REG_MODEM_CONFIG3, config3);
-      }
-      break;
+  resultCode = LORATRANSCEIVERITF_RESULT_ERROR;
+
+  // Set power value
+  if (PowerMode == LORATRANSCEIVERITF_POWER_MODE_BOOST)
+  {
+    // we set only the PA_BOOST pin
+    // limit to 14dBm
+    value = 0x0C;
+    value = value | 0b10000000;
+    // set RegOcp for OcpOn and OcpTrim
+    // 130mA
+    CSX1276_setMaxCurrent(this, 0x10);
   }
-  
-  // Check if it is neccesary to set special settings for SF=6
-  if (SpreadingFactor == LORATRANSCEIVERITF_SF_6)
-  {   
-    // Mandatory headerOFF with SF = 6 (Implicit mode)
-    CSX1276_setHeaderOFF(this); 
-    
-    // Set the bit field DetectionOptimize of 
-    // register RegLoRaDetectOptimize to value "0b101".
-    CSX1276_writeRegister(SPIDeviceHandle, REG_DETECT_OPTIMIZE, 0x05);
-    
-    // Write 0x0C in the register RegDetectionThreshold.            
-    CSX1276_writeRegister(SPIDeviceHandle, REG_DETECTION_THRESHOLD, 0x0C);
+  else if (PowerMode == LORATRANSCEIVERITF_POWER_MODE_BOOST2) 
+  {
+    // normally value = 0x0F;
+    // we set the PA_BOOST pin
+    value = value | 0b10000000;
+    // and then set the high output power config with register REG_PA_DAC
+    CSX1276_writeRegister(this, 0x4D, 0x87);
+    // set RegOcp for OcpOn and OcpTrim
+    // 150mA
+    CSX1276_setMaxCurrent(this, 0x12);
   }
-  else
+  else 
   {
-    // added by C. Pham
-    CSX1276_setHeaderON(this);
+    // disable high power output in all other cases
+    CSX1276_writeRegister(this, 0x4D, 0x84);
 
-    // LoRa detection Optimize: 0x03 --> SF7 to SF12
-    CSX1276_writeRegister(SPIDeviceHandle, REG_DETECT_OPTIMIZE, 0x03);
-    
-    // LoRa detection threshold: 0x0A --> SF7 to SF12         
-    CSX1276_writeRegister(SPIDeviceHandle, REG_DETECTION_THRESHOLD, 0x0A);   
+    // Set default max current to 100mA
+    CSX1276_setMaxCurrent(this, 0x0B);
   }
-  
-  // Set the AgcAutoOn in bit 2 of REG_MODEM_CONFIG3
-  BYTE config3 = CSX1276_readRegister(SPIDeviceHandle, REG_MODEM_CONFIG3);
-  config3 = config3 | 0b00000100;
-  CSX1276_writeRegister(SPIDeviceHandle, REG_MODEM_CONFIG3, config3);
 
-  // Update 'config2'
-  CSX1276_writeRegister(SPIDeviceHandle, REG_MODEM_CONFIG2, config2);    
-  
-  // Read 'config1' and 'config2' to check update
-  config1 = (CSX1276_readRegister(SPIDeviceHandle, REG_MODEM_CONFIG3));
-  config2 = (CSX1276_readRegister(SPIDeviceHandle, REG_MODEM_CONFIG2));
-  
-  // (config2 >> 4) ---> take out bits 7-4 from REG_MODEM_CONFIG2 (=_spreadingFactor)
-  // bitRead(config1, 0) ---> take out bit 3 from REG_MODEM_CONFIG3 (=LowDataRateOptimize)
-  // LowDataRateOptimize is in REG_MODEM_CONFIG3
-  switch (SpreadingFactor)
-  {
-    case LORATRANSCEIVERITF_SF_6:
-      if (((config2 >> 4) == SpreadingFactor) && (bitRead(config1, 2) == 1) && (this->m_usHeader == SX1276_HEADER_OFF))
-      {
-        resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
-      }
-      break;
-    case LORATRANSCEIVERITF_SF_7:  
-      if (((config2 >> 4) == 0x07) && (bitRead(config1, 2) == 1))
-      {
-        resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
-      }
-      break;
-    case LORATRANSCEIVERITF_SF_8:  
-      if (((config2 >> 4) == 0x08) && (bitRead(config1, 2) == 1))
-      {
-        resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
-      }
-      break;
-    case LORATRANSCEIVERITF_SF_9:  
-      if (((config2 >> 4) == 0x09) && (bitRead(config1, 2) == 1))
-      {
-        resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
-      }
-      break;
-    case LORATRANSCEIVERITF_SF_10: 
-      if (((config2 >> 4) == 0x0A) && (bitRead(config1, 2) == 1))
-      {
-        resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
-      }
-      break;
-    case LORATRANSCEIVERITF_SF_11: 
-      if (((config2 >> 4) == 0x0B) && (bitRead(config1, 2) == 1) && (bitRead(config1, 3) == 1))
-      {
-        resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
-      }
-      break;
-    case LORATRANSCEIVERITF_SF_12: 
-      if (((config2 >> 4) == 0x0C) && (bitRead(config1, 2) == 1) && (bitRead(config1, 3) == 1))
-      {
-        resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
-      }
-      break;
-    default:  
-      resultCode = LORATRANSCEIVERITF_RESULT_ERROR;
-  }
+  // set MaxPower to 7 -> Pmax=10.8+0.6*MaxPower [dBm] = 15
+  value = value | 0b01110000;
 
-  // Restore previous OP Mode
-  if (st0 != LORA_STANDBY_MODE)
-  {
-    CSX1276_writeRegister(SPIDeviceHandle, REG_OP_MODE, st0);  
-  }
+  // then Pout = Pmax-(15-_power[3:0]) if  PaSelect=0 (RFO pin for +14dBm)
+  // so L=3dBm; H=7dBm; M=15dBm (but should be limited to 14dBm by RFO pin)
+
+  // and Pout = 17-(15-_power[3:0]) if  PaSelect=1 (PA_BOOST pin for +14dBm)
+  // so x= 14dBm (PA);
+  // when p=='X' for 20dBm, value is 0x0F and RegPaDacReg=0x87 so 20dBm is enabled
+  CSX1276_writeRegister(this, REG_PA_CONFIG, value); // Setting output power value
+  this->m_usPowerLevel = value;
 
-  if (resultCode == LORATRANSCEIVERITF_RESULT_SUCCESS)
-  { 
-    this->m_usSpreadingFactor = SpreadingFactor;
+  value = CSX1276_readRegister(this, REG_PA_CONFIG);
+
+  if (value == this->m_usPowerLevel)
+  {
+    this->m_usPowerMode = PowerMode;
+    resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
     #if (SX1276_DEBUG_LEVEL0)
-      DEBUG_PRINT("[INFO] Spreading factor ");
-      DEBUG_PRINT_DEC(SpreadingFactor);
-      DEBUG_PRINT_LN(" has been successfully set");
+      DEBUG_PRINT_LN("[INFO] Power Mode successfully set");
       DEBUG_PRINT_CR;
     #endif
   }
   else
   {
     #if (SX1276_DEBUG_LEVEL0)
-      DEBUG_PRINT("[ERROR] Failed to set spreading factor");
+      DEBUG_PRINT_LN("[ERROR] Failed to set Power Mode");
       DEBUG_PRINT_CR;
     #endif
   }
+
+  // Restore previous OP mode
+  if (st0 != LORA_STANDBY_MODE)
+  {
+    CSX1276_writeRegister(this, REG_OP_MODE, st0);  
+  }
   return resultCode;
 }
 
 /*****************************************************************************************//**
- * @fn         uint8_t  CSX1276_setBW(CSX1276 *this, uint16_t BandWidth)
+ * @fn         uint8_t CSX1276_setPowerLevel(CSX1276 *this, uint8_t PowerLevel)
  * 
- * @brief      Sets the Bandwidth in SX1276.
+ * @brief      Sets the Power Level in SX1276.
  * 
- * @details    The function sets the specified Bandwidth for LoRa radio.
+ * @details    The function sets the specified Output Power Level for LoRa radio.
  *
  * @param      this
  *             The pointer to CSX1276 object.
  *
- * @param      BandWidth
- *             The bandwidth value. Allowed values are 'LORATRANSCEIVERITF_BANDWIDTH_xxx'.
- *             See 'LoraTransceiverItf.h' for details.    
+ * @param      PowerLevel
+ *             The output power level value. The level values are in range from 0 to 14dBm.
  *
  * @return     The function returns one of the following a result codes:
- *              - LORATRANSCEIVERITF_RESULT_SUCCESS = the 'BW' is set for LoRa radio
+ *              - LORATRANSCEIVERITF_RESULT_SUCCESS = the 'PowerLevel' is set for LoRa radio
  *              - LORATRANSCEIVERITF_RESULT_ERROR = error during configuration
- *              - LORATRANSCEIVERITF_RESULT_INVALIDPARAMS = invalid bandwidth value specified
+ *              - LORATRANSCEIVERITF_RESULT_INVALIDPARAMS = invalid 'PowerLevel' value specified
  *              - LORATRANSCEIVERITF_RESULT_NOTEXECUTED = the operation has not been executed
+ *
+ * @note       Typically, the maximum current (OCP) must adjusted according to required power
+ *             level. This adjustment is made automatically by 'CSX1276_setPowerMode' method.
+ *             When output power is set using 'CSX1276_setPowerLevel' method, an explicit
+ *             call to 'CSX1276_setMaxCurrent' function is generaly required. 
 *********************************************************************************************/
-uint8_t  CSX1276_setBW(CSX1276 *this, uint16_t BandWidth)
+uint8_t CSX1276_setPowerLevel(CSX1276 *this, uint8_t PowerLevel)
 {
   BYTE st0;
-  int8_t resultCode = LORATRANSCEIVERITF_RESULT_NOTEXECUTED;
-  BYTE config1;
-  register spi_device_handle_t SPIDeviceHandle = this->m_SpiDeviceHandle;
+  uint8_t resultCode = LORATRANSCEIVERITF_RESULT_NOTEXECUTED;
+  BYTE value = 0x00;
 
   #if (SX1276_DEBUG_LEVEL0)
     DEBUG_PRINT_CR;
-    DEBUG_PRINT_LN("Starting 'setBW'");
+    DEBUG_PRINT_LN("[INFO] Starting 'CSX1276_setPowerLevel'");
   #endif
 
-  if (CSX1276_isBW(BandWidth) == false)
+  // Maximum power 14dBm
+  if (PowerLevel > 14)
   {
     #if (SX1276_DEBUG_LEVEL0)
-      DEBUG_PRINT("[ERROR] Bandwidth ");
-      DEBUG_PRINT_HEX(BandWidth);
+      DEBUG_PRINT("[ERROR] Power Level ");
+      DEBUG_PRINT_HEX(PowerLevel);
       DEBUG_PRINT_LN(" is not a correct value");
       DEBUG_PRINT_CR;
     #endif
@@ -2932,7 +4958,7 @@ uint8_t  CSX1276_setBW(CSX1276 *this, uint16_t BandWidth)
   }
 
   if (this->m_usModemMode != MODEM_MODE_LORA)
-  {
+  { 
     // Should never occur: Lora mode must be set first
     #if (SX1276_DEBUG_LEVEL0)
       DEBUG_PRINT("[WARNING] LoRa mode not set, activating now");
@@ -2943,296 +4969,445 @@ uint8_t  CSX1276_setBW(CSX1276 *this, uint16_t BandWidth)
     }
   }
 
+  // Save the currenrt OP mode
+  st0 = CSX1276_readRegister(this, REG_OP_MODE);    
+
+  // LoRa Standby mode to write in registers
+  if (st0 != LORA_STANDBY_MODE)
+  {
+    CSX1276_writeRegister(this, REG_OP_MODE, LORA_STANDBY_MODE);
+  }
+
   resultCode = LORATRANSCEIVERITF_RESULT_ERROR;
 
-  // Save the previous OP mode
-  st0 = CSX1276_readRegister(SPIDeviceHandle, REG_OP_MODE);    
+  this->m_usPowerLevel = PowerLevel;
 
-  // LoRa standby mode
-  if (st0 != LORA_STANDBY_MODE)
+  // Clear OutputPower, but keep current value of PaSelect and MaxPower
+  value = CSX1276_readRegister(this, REG_PA_CONFIG);
+  value = value & 0b11110000;
+  value = value + this->m_usPowerLevel;
+  this->m_usPowerLevel = value;
+
+  // Set output power value
+  CSX1276_writeRegister(this, REG_PA_CONFIG, this->m_usPowerLevel); 
+  value = CSX1276_readRegister(this, REG_PA_CONFIG);
+
+  if (value == this->m_usPowerLevel)
+  {
+    this->m_usPowerMode = SX1276_POWER_MODE_CUSTOM;
+    resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
+    #if (SX1276_DEBUG_LEVEL0)
+      DEBUG_PRINT_LN("[INFO] Output power level has been successfully set");
+      DEBUG_PRINT_CR;
+    #endif
+  }
+  else
   {
-    CSX1276_writeRegister(SPIDeviceHandle, REG_OP_MODE, LORA_STANDBY_MODE); 
+    #if (SX1276_DEBUG_LEVEL0)
+      DEBUG_PRINT_LN("[ERROR] Filed to set output power level");
+      DEBUG_PRINT_CR;
+    #endif
   }
 
-  // Save config1 to modify only the BW and clear bits 7 - 4 from REG_MODEM_CONFIG1
-  config1 = (CSX1276_readRegister(SPIDeviceHandle, REG_MODEM_CONFIG1));   
-  config1 = config1 & 0b00001111;	                                        
-  switch (BandWidth)
+  // Restore previous OP mode
+  if (st0 != LORA_STANDBY_MODE)
   {
-    case LORATRANSCEIVERITF_BANDWIDTH_125: 
-      // 0111
-      config1 = config1 | 0b01110000;
-      CSX1276_getSF(this);
-      if (this->m_usSpreadingFactor == 11 || this->m_usSpreadingFactor == 12)
-      { 
-        // LowDataRateOptimize (Mandatory with LORATRANSCEIVERITF_BANDWIDTH_125 if LORATRANSCEIVERITF_SF_11 or LORATRANSCEIVERITF_SF_12)
-        BYTE config3 = CSX1276_readRegister(SPIDeviceHandle, REG_MODEM_CONFIG3);
-        config3 = config3 | 0b00001000;
-        CSX1276_writeRegister(SPIDeviceHandle, REG_MODEM_CONFIG3, config3);
-      }
-      break;
-    case LORATRANSCEIVERITF_BANDWIDTH_250: 
-      // 1000
-      config1 = config1 | 0b10000000;
-      break;
-    case LORATRANSCEIVERITF_BANDWIDTH_500: 
-      // 1001
-      config1 = config1 | 0B10010000;
-      break;
+    CSX1276_writeRegister(this, REG_OP_MODE, st0);  
   }
-  // Update config1
-  CSX1276_writeRegister(SPIDeviceHandle, REG_MODEM_CONFIG1, config1);   
+  return resultCode;
+}
+
+/*****************************************************************************************//**
+ * @fn         uint8_t CSX1276_setPreambleLength(CSX1276 *this, uint16_t PreambleLength)
+ * 
+ * @brief      Sets the Preamble Length in SX1276.
+ * 
+ * @details    The function sets the specified Preamble Length for LoRa radio.
+ *
+ * @param      this
+ *             The pointer to CSX1276 object.
+ *
+ * @param      PreambleLength
+ *             The value to set as preamble length. The standard value for LoRa network is 8.
+ *
+ * @return     The function returns one of the following a result codes:
+ *              - LORATRANSCEIVERITF_RESULT_SUCCESS = the 'PreambleLength' is set for LoRa radio
+ *              - LORATRANSCEIVERITF_RESULT_ERROR = error during configuration
+ *              - LORATRANSCEIVERITF_RESULT_NOTEXECUTED = the operation has not been executed
+*********************************************************************************************/
+uint8_t CSX1276_setPreambleLength(CSX1276 *this, uint16_t PreambleLength)
+{
+  BYTE st0;
+  uint8_t p_length;
+  int8_t resultCode = LORATRANSCEIVERITF_RESULT_NOTEXECUTED;
 
-  config1 = CSX1276_readRegister(SPIDeviceHandle, REG_MODEM_CONFIG1);
+  #if (SX1276_DEBUG_LEVEL0)
+    DEBUG_PRINT_CR;
+    DEBUG_PRINT_LN("[INFO] Starting 'CSX1276_setPreambleLength'");
+  #endif
 
-  // (config1 >> 4) ---> take out bits 7-4 from REG_MODEM_CONFIG1 (=_bandwidth)
-  switch (BandWidth)
-  {
-    case LORATRANSCEIVERITF_BANDWIDTH_125: 
-      if ((config1 >> 4) == LORATRANSCEIVERITF_BANDWIDTH_125)
-      {
-        resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
-        BYTE config3 = CSX1276_readRegister(SPIDeviceHandle, REG_MODEM_CONFIG3);
+  if (this->m_usModemMode != MODEM_MODE_LORA)
+  { 
+    // Should never occur: Lora mode must be set first
+    #if (SX1276_DEBUG_LEVEL0)
+      DEBUG_PRINT("[WARNING] LoRa mode not set, activating now");
+    #endif
+    if ((resultCode = CSX1276_setLoRa(this)) != LORATRANSCEIVERITF_RESULT_SUCCESS)
+    {
+      return resultCode;
+    }
+  }
 
-        if ((this->m_usSpreadingFactor == 11) || (this->m_usSpreadingFactor == 12))
-        {
-          if (bitRead(config3, 3) != 1)
-          {
-            // No LowDataRateOptimize
-            resultCode = LORATRANSCEIVERITF_RESULT_ERROR;
-          }
-        }
-      }
-      break;
-    case LORATRANSCEIVERITF_BANDWIDTH_250: 
-      if ((config1 >> 4) == LORATRANSCEIVERITF_BANDWIDTH_250)
-      {
-        resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
-      }
-      break;
-    case LORATRANSCEIVERITF_BANDWIDTH_500: 
-      if ((config1 >> 4) == LORATRANSCEIVERITF_BANDWIDTH_500)
-      {
-        resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
-      }
-      break;
+  // Save the current OP mode
+  st0 = CSX1276_readRegister(this, REG_OP_MODE); 
+   
+  resultCode = LORATRANSCEIVERITF_RESULT_ERROR;
+
+  // Set Standby mode to write in registers
+  if (st0 != LORA_STANDBY_MODE)
+  {
+    CSX1276_writeRegister(this, REG_OP_MODE, LORA_STANDBY_MODE);    
   }
 
-  if (resultCode != LORATRANSCEIVERITF_RESULT_SUCCESS)
+  p_length = ((PreambleLength >> 8) & 0x0FF);
+
+  // Store MSB preamble length for LoRa mode
+  CSX1276_writeRegister(this, REG_PREAMBLE_MSB_LORA, p_length);
+  p_length = (PreambleLength & 0x0FF);
+
+  // Store LSB preamble length for LoRa mode
+  CSX1276_writeRegister(this, REG_PREAMBLE_LSB_LORA, p_length);
+
+  resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
+
+  this->m_wPreambleLength = PreambleLength;
+   
+  #if (SX1276_DEBUG_LEVEL0)
+    DEBUG_PRINT("[INFO] Preamble length ");
+    DEBUG_PRINT_HEX(PreambleLength);
+    DEBUG_PRINT_LN(" has been successfully set");
+    DEBUG_PRINT_CR;
+  #endif
+
+  // Restore previous OP mode
+  if (st0 != LORA_STANDBY_MODE)
   {
+    CSX1276_writeRegister(this, REG_OP_MODE, st0);  
+  }
+  return resultCode;
+}
+
+/*****************************************************************************************//**
+ * @fn         uint8_t CSX1276_getSNR(CSX1276 *this)
+ * 
+ * @brief      Gets the SNR in SX1276.
+ * 
+ * @details    The function gets SNR from SX1276 register and store the value in 'm_SNR' member
+ *             variable of CSX1276 object.\n
+ *             The SNR is available only for LoRa radio.\n
+ *             The LoRa radio mode must be configured before calling this function.
+ *
+ * @param      this
+ *             The pointer to CSX1276 object.
+ *
+ * @return     The function returns one of the following a result codes:
+ *              - LORATRANSCEIVERITF_RESULT_SUCCESS = the 'SNR' is stored in member variable
+ *              - LORATRANSCEIVERITF_RESULT_INVALIDSTATE = LoRa mode not configured before 
+ *                                                         calling the function
+*********************************************************************************************/
+uint8_t CSX1276_getSNR(CSX1276 *this)
+{ 
+  int8_t resultCode = LORATRANSCEIVERITF_RESULT_NOTEXECUTED;
+  BYTE value;
+
+  #if (SX1276_DEBUG_LEVEL0)
+    DEBUG_PRINT_CR;
+    DEBUG_PRINT_LN("[INFO] Starting 'CSX1276_getSNR'");
+  #endif
+
+  if (this->m_usModemMode == MODEM_MODE_LORA)
+  { 
+    // 'getSNR' exists only in LoRa mode
+    value = CSX1276_readRegister(this, REG_PKT_SNR_VALUE);
+
+    // The SNR sign bit is 1
+    if (value & 0x80) 
+    {
+      // Invert and divide by 4
+      value = ((~value + 1) & 0xFF) >> 2;
+      this->m_nSNRPacket = -value;
+    }
+    else
+    {
+      // Divide by 4
+      this->m_nSNRPacket = (value & 0xFF) >> 2;
+    }
+    resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
     #if (SX1276_DEBUG_LEVEL0)
-      DEBUG_PRINT_LN("[ERROR] Failed to set bandwidth");
+      DEBUG_PRINT("[INFO] SNR value is ");
+      DEBUG_PRINT_DEC(this->m_nSNRPacket);
+      DEBUG_PRINT_CR;
     #endif
   }
   else
-  {
-    this->m_usBandwidth = BandWidth;
+  { 
+    // LoRa mode must be set before calling this function
+    resultCode = LORATRANSCEIVERITF_RESULT_INVALIDSTATE;
     #if (SX1276_DEBUG_LEVEL0)
-      DEBUG_PRINT("[INFO] Bandwidth ");
-      DEBUG_PRINT_HEX(BandWidth);
-      DEBUG_PRINT_LN(" has been successfully set");
+      DEBUG_PRINT_LN("[ERROR] LoRa mode must be configured before calling function");
       DEBUG_PRINT_CR;
     #endif
   }
-
-  // Restore previous OP mode
-  if (st0 != LORA_STANDBY_MODE)
-  {
-    CSX1276_writeRegister(SPIDeviceHandle, REG_OP_MODE, st0);
-  }
   return resultCode;
 }
 
 /*****************************************************************************************//**
- * @fn         uint8_t CSX1276_setCR(CSX1276 *this, uint8_t CodingRate)
+ * @fn         uint8_t CSX1276_getRSSI(CSX1276 *this)
  * 
- * @brief      Sets the Coding Rate in SX1276.
+ * @brief      Gets the current value of RSSI in SX1276.
  * 
- * @details    The function sets the specified Codding Rate for LoRa radio.
+ * @details    The function gets current value of RSSI from SX1276 register and store the 
+ *             value in 'm_RSSI' member variable of CSX1276 object.\n
+ *             The LoRa radio mode must be configured before calling this function.
  *
  * @param      this
  *             The pointer to CSX1276 object.
  *
- * @param      CodingRate
- *             The coding rate value. Allowed values are 'LORATRANSCEIVERITF_CR_x'.
- *             See 'LoraTransceiverItf.h' for details.    
- *
  * @return     The function returns one of the following a result codes:
- *              - LORATRANSCEIVERITF_RESULT_SUCCESS = the 'CR' is set for LoRa radio
- *              - LORATRANSCEIVERITF_RESULT_ERROR = error during configuration
- *              - LORATRANSCEIVERITF_RESULT_INVALIDPARAMS = invalid CR value specified
- *              - LORATRANSCEIVERITF_RESULT_NOTEXECUTED = the operation has not been executed
+ *              - LORATRANSCEIVERITF_RESULT_SUCCESS = the 'RSSI' is stored in member variable
+ *              - LORATRANSCEIVERITF_RESULT_INVALIDSTATE = LoRa mode not configured before 
+ *                                                         calling the function
 *********************************************************************************************/
-uint8_t CSX1276_setCR(CSX1276 *this, uint8_t CodingRate)
+uint8_t CSX1276_getRSSI(CSX1276 *this)
 {
-  BYTE st0;
-  int8_t resultCode = LORATRANSCEIVERITF_RESULT_NOTEXECUTED;
-  BYTE config1;
-  register spi_device_handle_t SPIDeviceHandle = this->m_SpiDeviceHandle;
+  uint8_t resultCode = LORATRANSCEIVERITF_RESULT_NOTEXECUTED;
+  int rssi_mean = 0;
+  int total = 5;
 
   #if (SX1276_DEBUG_LEVEL0)
     DEBUG_PRINT_CR;
-    DEBUG_PRINT_LN("[INFO] Starting 'CSX1276_setCR'");
+    DEBUG_PRINT_LN("[INFO] Starting 'CSX1276_getRSSI'");
   #endif
 
-  if (CSX1276_isCR(CodingRate) == false)
-  {
+  if (this->m_usModemMode == MODEM_MODE_LORA)
+  { 
+    // Get mean value of RSSI
+    for (int i = 0; i < total; i++)
+    {
+      this->m_nRSSI = -OFFSET_RSSI + CSX1276_readRegister(this, REG_RSSI_VALUE_LORA);
+      rssi_mean += this->m_nRSSI;     
+    }
+    rssi_mean = rssi_mean / total;  
+    this->m_nRSSI = rssi_mean;
+    
+    resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
     #if (SX1276_DEBUG_LEVEL0)
-      DEBUG_PRINT("[ERROR] Coding Rate ");
-      DEBUG_PRINT_HEX(CodingRate);
-      DEBUG_PRINT_LN(" is not a correct value");
+      DEBUG_PRINT("[INFO] RSSI value is ");
+      DEBUG_PRINT_DEC(this->m_nRSSI);
       DEBUG_PRINT_CR;
-    #endif
-    return LORATRANSCEIVERITF_RESULT_INVALIDPARAMS;
+    #endif  
   }
-
-  if (this->m_usModemMode != MODEM_MODE_LORA)
+  else
   {
-    // Should never occur: Lora mode must be set first
+    // LoRa mode must be set before calling this function
+    resultCode = LORATRANSCEIVERITF_RESULT_INVALIDSTATE;
     #if (SX1276_DEBUG_LEVEL0)
-      DEBUG_PRINT("[WARNING] LoRa mode not set, activating now");
+      DEBUG_PRINT_LN("[ERROR] LoRa mode must be configured before calling function");
+      DEBUG_PRINT_CR;
     #endif
-    if ((resultCode = CSX1276_setLoRa(this)) != LORATRANSCEIVERITF_RESULT_SUCCESS)
-    {
-      return resultCode;
-    }
   }
+  return resultCode;
+}
 
-  resultCode = LORATRANSCEIVERITF_RESULT_ERROR;
+/*****************************************************************************************//**
+ * @fn         uint8_t CSX1276_getRSSIpacket(CSX1276 *this)
+ * 
+ * @brief      Gets the RSSI of last received packet.
+ * 
+ * @details    The function retrieves in SX1276 register the RSSI of last received packet and
+ *             stores the value in 'm_RSSIpacket' member variable of CSX1276 object.\n
+ *             The RSSI for last received packet is available only for LoRa radio.\n
+ *             The LoRa radio mode must be configured before calling this function.
+ *
+ * @param      this
+ *             The pointer to CSX1276 object.
+ *
+ * @return     The function returns one of the following a result codes:
+ *              - LORATRANSCEIVERITF_RESULT_SUCCESS = the last packet 'RSSI' is stored in 
+ *                 member variable
+ *              - LORATRANSCEIVERITF_RESULT_INVALIDSTATE = LoRa mode not configured before 
+ *                 calling the function
+*********************************************************************************************/
+uint8_t CSX1276_getRSSIpacket(CSX1276 *this)
+{ 
+  uint8_t resultCode = LORATRANSCEIVERITF_RESULT_NOTEXECUTED;
 
-  // Save the current OP mode
-  st0 = CSX1276_readRegister(SPIDeviceHandle, REG_OP_MODE);
+  #if (SX1276_DEBUG_LEVEL0)
+    DEBUG_PRINT_CR;
+    DEBUG_PRINT_LN("[INFO] Starting 'CSX1276_getRSSIpacket'");
+  #endif
 
-  // Set Standby mode to write in registers
-  if (st0 != LORA_STANDBY_MODE)
+  if (this->m_usModemMode == MODEM_MODE_LORA)
   {
-    CSX1276_writeRegister(SPIDeviceHandle, REG_OP_MODE, LORA_STANDBY_MODE);
-  }
+    // RSSIpacket only exists in LoRa 
+    CSX1276_setPacketSignal(this, CSX1276_readRegister(this, REG_PKT_SNR_VALUE), 
+                            CSX1276_readRegister(this, REG_PKT_RSSI_VALUE));
+    resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
 
-  // Save config1 to modify only the CR and clear bits 3 - 1 from REG_MODEM_CONFIG1
-  config1 = CSX1276_readRegister(SPIDeviceHandle, REG_MODEM_CONFIG1);  
-  config1 = config1 & 0b11110001;	               
+    #if (SX1276_DEBUG_LEVEL0)
+      DEBUG_PRINT("## RSSI packet value is ");
+      DEBUG_PRINT_DEC(this->m_nRSSIPacket);
+      DEBUG_PRINT_LN(" ##");
+      DEBUG_PRINT_CR;
+    #endif
+  }
+  else
+  { 
+    // LoRa mode must be set before calling this function
+    resultCode = LORATRANSCEIVERITF_RESULT_INVALIDSTATE;
+    #if (SX1276_DEBUG_LEVEL0)
+      DEBUG_PRINT_LN("[ERROR] LoRa mode must be configured before calling function");
+      DEBUG_PRINT_CR;
+    #endif
+  }
+  return resultCode;
+}
 
-  switch (CodingRate)
+/*****************************************************************************************//**
+ * @fn         void CSX1276_setPacketSignal(CSX1276 *this, BYTE usSnrValue, BYTE usRssiValue)
+ * 
+ * @brief      Computes the SNR and RSSI of last received packet.
+ * 
+ * @details    The function converts the raw values of 'REG_PKT_SNR_VALUE' and 
+ *             'REG_PKT_RSSI_VALUE' registers and stores the results in 'm_nSNRPacket' and
+ *             'm_nRSSIPacket' member variables of CSX1276 object.
+ *
+ * @param      this
+ *             The pointer to CSX1276 object.
+ *
+ * @param      usSnrValue
+ *             The value of 'REG_PKT_SNR_VALUE' register.
+ *
+ * @param      usRssiValue
+ *             The value of 'REG_PKT_RSSI_VALUE' register.
+ *
+ * @return     None.
+*********************************************************************************************/
+void CSX1276_setPacketSignal(CSX1276 *this, BYTE usSnrValue, BYTE usRssiValue)
+{
+  // The SNR sign bit is 1
+  if (usSnrValue & 0x80) 
   {
-    case LORATRANSCEIVERITF_CR_5:
-      config1 = config1 | 0b00000010;
-      break;
-    case LORATRANSCEIVERITF_CR_6:
-      config1 = config1 | 0b00000100;
-      break;
-    case LORATRANSCEIVERITF_CR_7:
-      config1 = config1 | 0b00000110;
-      break;
-    case LORATRANSCEIVERITF_CR_8:
-      config1 = config1 | 0b00001000;
-      break;
+    // Invert and divide by 4
+    usSnrValue = ((~usSnrValue + 1) & 0xFF) >> 2;
+    this->m_nSNRPacket = -usSnrValue;
   }
-  CSX1276_writeRegister(SPIDeviceHandle, REG_MODEM_CONFIG1, config1);    // Update config1
-
-  config1 = CSX1276_readRegister(SPIDeviceHandle, REG_MODEM_CONFIG1);
-
-  // ((config1 >> 1) & 0b0000111) ---> take out bits 3-1 from REG_MODEM_CONFIG1 (=_codingRate)
-  switch (CodingRate)
+  else
   {
-    case LORATRANSCEIVERITF_CR_5:
-      if (((config1 >> 1) & 0b0000111) == 0x01)
-      {
-        resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
-      }
-      break;
-    case LORATRANSCEIVERITF_CR_6:
-      if (((config1 >> 1) & 0b0000111) == 0x02)
-      {
-        resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
-      }
-      break;
-    case LORATRANSCEIVERITF_CR_7:
-      if (((config1 >> 1) & 0b0000111) == 0x03)
-      {
-        resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
-      }
-      break;
-    case LORATRANSCEIVERITF_CR_8:
-      if (((config1 >> 1) & 0b0000111) == 0x04)
-      {
-        resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
-      }
-      break;
+    // Divide by 4
+    this->m_nSNRPacket = (usSnrValue & 0xFF) >> 2;
   }
 
-  if (resultCode != LORATRANSCEIVERITF_RESULT_SUCCESS)
+  if (this->m_nSNRPacket < 0)
   {
-    #if (SX1276_DEBUG_LEVEL0)
-      DEBUG_PRINT_LN("[ERROR] Failed to set Coding Rate");
-    #endif
+    this->m_nRSSIPacket = -NOISE_ABSOLUTE_ZERO + 10.0 * SignalBwLog[this->m_usBandwidth] + NOISE_FIGURE + (double)this->m_nSNRPacket;
   }
   else
   {
-    this->m_usCodingRate = CodingRate;
+    this->m_nRSSIPacket = -OFFSET_RSSI + (double)usRssiValue;
+  }
+}
 
-    // Store current coding rate information (i.e. text value retrieved by client object when a 
-    // LoraPacket is received)
-    strcpy((char *) this->m_ReceivedPacketInfo.m_szCodingRate, CSX1276_getCRTextValue(CodingRate));
+/*****************************************************************************************//**
+ * @fn         uint8_t CSX1276_setRetries(CSX1276 *this, uint8_t RetryNumber)
+ * 
+ * @brief      Sets the maximum number of send retries.
+ * 
+ * @details    The function sets the maximum number of send retries (i.e. for acknowledged
+ *             packets).\n
+ *             This value is stored in 'm_maxRetries' member variable of CSX1276 object.
+ *
+ * @param      this
+ *             The pointer to CSX1276 object.
+ *
+ * @param      RetryNumber
+ *             The number of send retries to set for the CSX1276 object.
+ *             The maximum allowed value is defined by 'LORATRANSCEIVERITF_MAX_SEND_RETRIES'
+ *             in 'LoraTransceiverItf.h'.
+ *
+ * @return     The function returns one of the following a result codes:
+ *              - LORATRANSCEIVERITF_RESULT_SUCCESS = the number of retries is stored in 
+ *                 member variable
+ *              - LORATRANSCEIVERITF_RESULT_INVALIDPARAMS = the specified 'RetryNumber' value
+ *                 is out of range.
+*********************************************************************************************/
+uint8_t CSX1276_setRetries(CSX1276 *this, uint8_t RetryNumber)
+{
+  #if (SX1276_DEBUG_LEVEL0)
+    DEBUG_PRINT_CR;
+    DEBUG_PRINT_LN("[INFO] Starting 'CSX1276_setRetries'");
+  #endif
 
+  if (RetryNumber > LORATRANSCEIVERITF_MAX_SEND_RETRIES)
+  {
     #if (SX1276_DEBUG_LEVEL0)
-      DEBUG_PRINT("[INFO] Coding Rate ");
-      DEBUG_PRINT_HEX(CodingRate);
-      DEBUG_PRINT_LN(" has been successfully set");
+      DEBUG_PRINT("[ERROR] Retries value cannot be greater than ");
+      DEBUG_PRINT_DEC(LORATRANSCEIVERITF_MAX_SEND_RETRIES);
       DEBUG_PRINT_CR;
     #endif
+    return LORATRANSCEIVERITF_RESULT_INVALIDPARAMS;
   }
 
-  // Restore previous OP mode
-  if (st0 != LORA_STANDBY_MODE)
-  {
-    CSX1276_writeRegister(SPIDeviceHandle, REG_OP_MODE, st0); 
-  }
-  return resultCode;
+  this->m_usMaxRetries = RetryNumber;
+  #if (SX1276_DEBUG_LEVEL0)
+    DEBUG_PRINT("[INFO] Maximum retries value set to ");
+    DEBUG_PRINT_DEC(this->m_usMaxRetries);
+    DEBUG_PRINT_CR;
+  #endif
+  return LORATRANSCEIVERITF_RESULT_SUCCESS;
 }
 
 /*****************************************************************************************//**
- * @fn         uint8_t CSX1276_setChannel(CSX1276 *this, uint8_t FreqChannel)
+ * @fn         uint8_t CSX1276_setMaxCurrent(CSX1276 *this, uint8_t OcpRate)
  * 
- * @brief      Sets the Frequency Channel in SX1276.
+ * @brief      Sets the maximum output current in SX1276.
  * 
- * @details    The function sets the specified Frequency Channel for LoRa radio.
+ * @details    The function limits the current supply of the power amplifier (typically to
+ *             protect battery chemistries).
  *
  * @param      this
  *             The pointer to CSX1276 object.
  *
- * @param      FreqChannel
- *             The frequency channel value. Allowed values are 'LORATRANSCEIVERITF_FREQUENCY_CHANNEL_xx'.
- *             See 'LoraTransceiverItf.h' for details.    
+ * @param      OcpRate
+ *             The Over Current Protection rate to set in SX1276 registry.
+ *             The maximum allowed value is defined by 'LORATRANSCEIVERITF_OCP_MAX'
+ *             in 'LoraTransceiverItf.h'.
  *
  * @return     The function returns one of the following a result codes:
- *              - LORATRANSCEIVERITF_RESULT_SUCCESS = the 'FrequencyChannel' is set for LoRa radio
- *              - LORATRANSCEIVERITF_RESULT_ERROR = error during configuration
- *              - LORATRANSCEIVERITF_RESULT_INVALIDPARAMS = invalid FreqChannel value specified
- *              - LORATRANSCEIVERITF_RESULT_NOTEXECUTED = the operation has not been executed
+ *              - LORATRANSCEIVERITF_RESULT_SUCCESS = the number of retries is stored in 
+ *                 member variable
+ *              - LORATRANSCEIVERITF_RESULT_INVALIDPARAMS = the specified 'RetryNumber' value
+ *                 is out of range.
+ *
+ * @note       Maximum current is computed as follows:
+ *              - if OcpTrim <= 15, Imax = 45+5*OcpRate [mA] (120 mA)
+ *              - if 15 < OcpRate <= 27, Imax = -30+10*OcpRate [mA] (130 to 240 mA)
 *********************************************************************************************/
-uint8_t CSX1276_setChannel(CSX1276 *this, uint8_t FreqChannel)
+uint8_t CSX1276_setMaxCurrent(CSX1276 *this, uint8_t OcpRate)
 {
   BYTE st0;
-  int8_t resultCode = LORATRANSCEIVERITF_RESULT_NOTEXECUTED;
-  uint32_t dwFreqRegValue;
-  unsigned int freq3;
-  unsigned int freq2;
-  uint8_t freq1;
-  uint32_t freq;
-  register spi_device_handle_t SPIDeviceHandle = this->m_SpiDeviceHandle;
 
   #if (SX1276_DEBUG_LEVEL0)
     DEBUG_PRINT_CR;
-    DEBUG_PRINT_LN("Starting 'setChannel'");
+    DEBUG_PRINT_LN("[INFO] Starting 'CSX1276_setMaxCurrent'");
   #endif
 
-  if (CSX1276_isChannel(FreqChannel) == false)
+  // Check maximum OCP rate value (maximum current supply is 240 mA)
+  if (OcpRate > LORATRANSCEIVERITF_OCP_MAX)
   {
     #if (SX1276_DEBUG_LEVEL0)
-      DEBUG_PRINT("[ERROR] Frequency Channel ");
-      DEBUG_PRINT_HEX(FreqChannel);
-      DEBUG_PRINT_LN(" is not a correct value");
+      DEBUG_PRINT("[ERROR] Maximum current supply is 240 mA, so maximum parameter value is ");
+      DEBUG_PRINT_DEC(LORATRANSCEIVERITF_OCP_MAX);
       DEBUG_PRINT_CR;
     #endif
     return LORATRANSCEIVERITF_RESULT_INVALIDPARAMS;
@@ -3240,1444 +5415,1536 @@ uint8_t CSX1276_setChannel(CSX1276 *this, uint8_t FreqChannel)
 
   if (this->m_usModemMode != MODEM_MODE_LORA)
   {
-    // Should never occur: Lora mode must be set first
+    // LoRa mode must be set before calling this function
     #if (SX1276_DEBUG_LEVEL0)
-      DEBUG_PRINT("[WARNING] LoRa mode not set, activating now");
+      DEBUG_PRINT_LN("[ERROR] LoRa mode must be configured before calling function");
+      DEBUG_PRINT_CR;
     #endif
-    if ((resultCode = CSX1276_setLoRa(this)) != LORATRANSCEIVERITF_RESULT_SUCCESS)
-    {
-      return resultCode;
-    }
+    return LORATRANSCEIVERITF_RESULT_INVALIDSTATE;
   }
 
   // Save the current OP mode
-  st0 = CSX1276_readRegister(SPIDeviceHandle, REG_OP_MODE);  
+  st0 = CSX1276_readRegister(this, REG_OP_MODE);  
 
-  // LoRa Stdby mode in order to write in registers
+  // Set LoRa Standby mode to write in registers
   if (st0 != LORA_STANDBY_MODE)
   {
-    CSX1276_writeRegister(SPIDeviceHandle, REG_OP_MODE, LORA_STANDBY_MODE);
+    CSX1276_writeRegister(this, REG_OP_MODE, LORA_STANDBY_MODE);  
   }
 
-  resultCode = LORATRANSCEIVERITF_RESULT_ERROR;
-
-  dwFreqRegValue = CSX1276_getFreqRegValue(FreqChannel);
-
-  freq3 = ((dwFreqRegValue >> 16) & 0x0FF);   // frequency channel MSB
-  freq2 = ((dwFreqRegValue >> 8) & 0x0FF);    // frequency channel MIB
-  freq1 = (dwFreqRegValue & 0xFF);            // frequency channel LSB
-
-  CSX1276_writeRegister(SPIDeviceHandle, REG_FRF_MSB, freq3);
-  CSX1276_writeRegister(SPIDeviceHandle, REG_FRF_MID, freq2);
-  CSX1276_writeRegister(SPIDeviceHandle, REG_FRF_LSB, freq1);
-
-  // Store MSB in freq channel value
-  freq3 = (CSX1276_readRegister(SPIDeviceHandle, REG_FRF_MSB));
-  freq = (freq3 << 8) & 0xFFFFFF;
-
-  // Store MID in freq channel value
-  freq2 = (CSX1276_readRegister(SPIDeviceHandle, REG_FRF_MID));
-  freq = (freq << 8) + ((freq2 << 8) & 0xFFFFFF);
-
-  // Store LSB in freq channel value
-  freq = freq + ((CSX1276_readRegister(SPIDeviceHandle, REG_FRF_LSB)) & 0xFFFFFF);
-
-  if (freq == dwFreqRegValue)
-  {
-    resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
-    this->m_usFreqChannel = FreqChannel;
-    this->m_dwRegFreqChannel = dwFreqRegValue;
-    #if (SX1276_DEBUG_LEVEL0)
-      DEBUG_PRINT("[INFO] Frequency channel ");
-      DEBUG_PRINT_HEX(FreqChannel);
-      DEBUG_PRINT_LN(" has been successfully set");
-      DEBUG_PRINT_CR;
-    #endif
-  }
+  // Enable Over Current Protection
+  CSX1276_writeRegister(this, REG_OCP, OcpRate | 0b00100000); 
+  this->m_usOcpRate = OcpRate;
 
   // Restore previous OP mode
   if (st0 != LORA_STANDBY_MODE)
   {
-    CSX1276_writeRegister(SPIDeviceHandle, REG_OP_MODE, st0);  
+    CSX1276_writeRegister(this, REG_OP_MODE, st0);    
   }
-  return resultCode;
+  #if (SX1276_DEBUG_LEVEL0)
+    DEBUG_PRINT("[INFO] Maximum current protection set to ");
+    DEBUG_PRINT_DEC(OcpRate);
+    DEBUG_PRINT_CR;
+  #endif
+  return LORATRANSCEIVERITF_RESULT_SUCCESS;
 }
 
 /*****************************************************************************************//**
- * @fn         uint8_t CSX1276_setPowerMode(CSX1276 *this, uint8_t PowerMode)
+ * @fn         uint8_t CSX1276_getTemp(CSX1276 *this)
  * 
- * @brief      Sets the Power Mode in SX1276.
+ * @brief      Gets the temperature of SX1276 device.
  * 
- * @details    The function sets the specified predefined Power level for LoRa radio.
+ * @details    The function retrieves current device temperature in SX1276 register and
+ *             stores the value in 'm_temp' member variable of CSX1276 object.
  *
  * @param      this
  *             The pointer to CSX1276 object.
  *
- * @param      PowerMode
- *             The power mode value. Allowed values are 'LORATRANSCEIVERITF_POWER_MODE_xx'.
- *             See 'LoraTransceiverItf.h' for details.    
- *
  * @return     The function returns one of the following a result codes:
- *              - LORATRANSCEIVERITF_RESULT_SUCCESS = the 'PowerMode' is set for LoRa radio
- *              - LORATRANSCEIVERITF_RESULT_ERROR = error during configuration
- *              - LORATRANSCEIVERITF_RESULT_INVALIDPARAMS = invalid 'PowerMode' value specified
- *              - LORATRANSCEIVERITF_RESULT_NOTEXECUTED = the operation has not been executed
+ *              - LORATRANSCEIVERITF_RESULT_SUCCESS = the device temperature is stored in 
+ *                 member variable
+ *              - LORATRANSCEIVERITF_RESULT_INVALIDSTATE = LoRa mode not configured before 
+ *                 calling the function
 *********************************************************************************************/
-uint8_t CSX1276_setPowerMode(CSX1276 *this, uint8_t PowerMode)
+uint8_t CSX1276_getTemp(CSX1276 *this)
 {
   BYTE st0;
-  int8_t resultCode = LORATRANSCEIVERITF_RESULT_NOTEXECUTED;
-  BYTE value = 0x00;
-  register spi_device_handle_t SPIDeviceHandle = this->m_SpiDeviceHandle;
+  int nTemp;
 
   #if (SX1276_DEBUG_LEVEL0)
     DEBUG_PRINT_CR;
-    DEBUG_PRINT_LN("[INFO] Starting 'CSX1276_setPowerMode'");
+    DEBUG_PRINT_LN("Starting 'getTemp'");
   #endif
 
-  switch (PowerMode)
-  {
-    // LOW  = On SX1272/76: PA0 on RFO setting
-    // HIGH = On SX1272/76: PA0 on RFO setting
-    // MAX  = On SX1272/76: PA0 on RFO setting
-
-    // BOOST  = extreme; added by C. Pham. On SX1272/76: PA1&PA2 PA_BOOST setting
-    // BOOST2 = extreme; added by C. Pham. On SX1272/76: PA1&PA2 PA_BOOST setting + 20dBm settings
-    case LORATRANSCEIVERITF_POWER_MODE_BOOST:
-    case LORATRANSCEIVERITF_POWER_MODE_BOOST2:
-    case LORATRANSCEIVERITF_POWER_MODE_MAX:  
-      // SX1272/76: 14dBm
-      value = 0x0F;
-      break;
-
-    case LORATRANSCEIVERITF_POWER_MODE_LOW:
-      // SX1272/76: 2dBm
-      value = 0x03;
-      break;
-
-    case LORATRANSCEIVERITF_POWER_MODE_HIGH:
-      // SX1272/76: 6dBm
-      value = 0x07;
-      break;
-
-    default:
-      #if (SX1276_DEBUG_LEVEL0)
-        DEBUG_PRINT("[ERROR] Power Mode ");
-        DEBUG_PRINT_HEX(PowerMode);
-        DEBUG_PRINT_LN(" is not a correct value");
-        DEBUG_PRINT_CR;
-      #endif
-      return LORATRANSCEIVERITF_RESULT_INVALIDPARAMS;
-  }
-
-  if (this->m_usModemMode != MODEM_MODE_LORA)
+  if (this->m_usModemMode == MODEM_MODE_LORA)
   { 
-    // Should never occur: Lora mode must be set first
+    // LoRa mode must be set before calling this function
     #if (SX1276_DEBUG_LEVEL0)
-      DEBUG_PRINT("[WARNING] LoRa mode not set, activating now");
+      DEBUG_PRINT_LN("[ERROR] LoRa mode must be configured before calling function");
+      DEBUG_PRINT_CR;
     #endif
-    if ((resultCode = CSX1276_setLoRa(this)) != LORATRANSCEIVERITF_RESULT_SUCCESS)
-    {
-      return resultCode;
-    }
+    return LORATRANSCEIVERITF_RESULT_INVALIDSTATE;
   }
 
-  // Save current OP modes
-  st0 = CSX1276_readRegister(SPIDeviceHandle, REG_OP_MODE);    
+  // Save the current OP mode
+  st0 = CSX1276_readRegister(this, REG_OP_MODE);  
 
-  // LoRa Stdby mode in order to write in registers
-  if (st0 != LORA_STANDBY_MODE)
-  {
-    CSX1276_writeRegister(SPIDeviceHandle, REG_OP_MODE, LORA_STANDBY_MODE);
-  }
+  // Allowing access to FSK registers while in LoRa standby mode
+  CSX1276_writeRegister(this, REG_OP_MODE, LORA_STANDBY_FSK_REGS_MODE);
 
-  resultCode = LORATRANSCEIVERITF_RESULT_ERROR;
+  // Saving temperature value
+  nTemp = CSX1276_readRegister(this, REG_TEMP);
 
-  // Set power value
-  if (PowerMode == LORATRANSCEIVERITF_POWER_MODE_BOOST)
+  // Check SNR sign bit
+  if (nTemp & 0x80) 
   {
-    // we set only the PA_BOOST pin
-    // limit to 14dBm
-    value = 0x0C;
-    value = value | 0b10000000;
-    // set RegOcp for OcpOn and OcpTrim
-    // 130mA
-    CSX1276_setMaxCurrent(this, 0x10);
+    // The SNR sign bit is 1, invert and divide by 4
+    nTemp = ((~nTemp + 1) & 0xFF);
   }
-  else if (PowerMode == LORATRANSCEIVERITF_POWER_MODE_BOOST2) 
+  else
   {
-    // normally value = 0x0F;
-    // we set the PA_BOOST pin
-    value = value | 0b10000000;
-    // and then set the high output power config with register REG_PA_DAC
-    CSX1276_writeRegister(SPIDeviceHandle, 0x4D, 0x87);
-    // set RegOcp for OcpOn and OcpTrim
-    // 150mA
-    CSX1276_setMaxCurrent(this, 0x12);
+    // Divide by 4
+    nTemp = (nTemp & 0xFF);
   }
-  else 
-  {
-    // disable high power output in all other cases
-    CSX1276_writeRegister(SPIDeviceHandle, 0x4D, 0x84);
 
-    // Set default max current to 100mA
-    CSX1276_setMaxCurrent(this, 0x0B);
-  }
+  #if (SX1276_DEBUG_LEVEL0)
+    DEBUG_PRINT("[INFO] Temperature is: ");
+    DEBUG_PRINT_DEC(nTemp);
+    DEBUG_PRINT_CR;
+  #endif
+  this->m_nTemp = nTemp;
 
-  // set MaxPower to 7 -> Pmax=10.8+0.6*MaxPower [dBm] = 15
-  value = value | 0b01110000;
+  // Restore previous OP mode
+  CSX1276_writeRegister(this, REG_OP_MODE, st0);  
 
-  // then Pout = Pmax-(15-_power[3:0]) if  PaSelect=0 (RFO pin for +14dBm)
-  // so L=3dBm; H=7dBm; M=15dBm (but should be limited to 14dBm by RFO pin)
+  return LORATRANSCEIVERITF_RESULT_SUCCESS;
+}
 
-  // and Pout = 17-(15-_power[3:0]) if  PaSelect=1 (PA_BOOST pin for +14dBm)
-  // so x= 14dBm (PA);
-  // when p=='X' for 20dBm, value is 0x0F and RegPaDacReg=0x87 so 20dBm is enabled
-  CSX1276_writeRegister(SPIDeviceHandle, REG_PA_CONFIG, value); // Setting output power value
-  this->m_usPowerLevel = value;
+/*****************************************************************************************//**
+ * @fn         uint8_t CSX1276_getSF(CSX1276 *this)
+ * 
+ * @brief      Gets the Spreading Factor in SX1276.
+ * 
+ * @details    The function retrieves, in SX1276 register, the Spreading Factor and stores
+ *             the value in 'm_usSpreadingFactor' member variable of CSX1276 object.\n
+ *             The LoRa radio mode must be configured before calling this function.
+ *
+ * @param      this
+ *             The pointer to CSX1276 object.
+ *
+ * @return     The function returns one of the following a result codes:
+ *              - LORATRANSCEIVERITF_RESULT_SUCCESS = the 'Spreading Factor' is stored in 
+ *                 member variable
+ *              - LORATRANSCEIVERITF_RESULT_INVALIDSTATE = LoRa mode not configured before 
+ *                 calling the function
+ *              - LORATRANSCEIVERITF_RESULT_ERROR = the retrieved 'Spreading Factor' is not
+ *                 allowed
+*********************************************************************************************/
+uint8_t CSX1276_getSF(CSX1276 *this)
+{
+  int8_t resultCode = LORATRANSCEIVERITF_RESULT_NOTEXECUTED;
+  BYTE config2;
+
+  #if (SX1276_DEBUG_LEVEL0)
+    DEBUG_PRINT_CR;
+    DEBUG_PRINT_LN("[INFO] Starting 'CSX1276_getSF'");
+  #endif
+
+  if (this->m_usModemMode != MODEM_MODE_LORA)
+  {
+    #if (SX1276_DEBUG_LEVEL0)
+      DEBUG_PRINT_LN("[ERROR] LoRa mode must be configured before calling function");
+      DEBUG_PRINT_CR;
+    #endif
+    return LORATRANSCEIVERITF_RESULT_INVALIDSTATE;
+  }
 
-  value = CSX1276_readRegister(SPIDeviceHandle, REG_PA_CONFIG);
+  // Take out bits 7-4 from REG_MODEM_CONFIG2 indicates _spreadingFactor
+  config2 = (CSX1276_readRegister(this, REG_MODEM_CONFIG2)) >> 4;
 
-  if (value == this->m_usPowerLevel)
+  if (CSX1276_isSF(config2))
   {
-    this->m_usPowerMode = PowerMode;
+    this->m_usSpreadingFactor = config2;
     resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
     #if (SX1276_DEBUG_LEVEL0)
-      DEBUG_PRINT_LN("[INFO] Power Mode successfully set");
+      DEBUG_PRINT("[INFO] Spreading factor is ");
+      DEBUG_PRINT_HEX(config2);
       DEBUG_PRINT_CR;
     #endif
   }
   else
   {
     #if (SX1276_DEBUG_LEVEL0)
-      DEBUG_PRINT_LN("[ERROR] Failed to set Power Mode");
+      DEBUG_PRINT("[ERROR] Retrieved Spreading Factor not allowed, value is: ");
+      DEBUG_PRINT_HEX(config2);
       DEBUG_PRINT_CR;
     #endif
+    resultCode = LORATRANSCEIVERITF_RESULT_ERROR;
   }
-
-  // Restore previous OP mode
-  if (st0 != LORA_STANDBY_MODE)
-  {
-    CSX1276_writeRegister(SPIDeviceHandle, REG_OP_MODE, st0);  
-  }
+  
   return resultCode;
 }
 
 /*****************************************************************************************//**
- * @fn         uint8_t CSX1276_setPowerLevel(CSX1276 *this, uint8_t PowerLevel)
+ * @fn         uint8_t CSX1276_getBW(CSX1276 *this)
  * 
- * @brief      Sets the Power Level in SX1276.
+ * @brief      Gets the Bandwidth in SX1276.
  * 
- * @details    The function sets the specified Output Power Level for LoRa radio.
+ * @details    The function retrieves the Bandwidth in SX1276 register and stores the value
+ *             in 'm_usBandwidth' member variable of CSX1276 object.\n
+ *             The LoRa radio mode must be configured before calling this function.
  *
  * @param      this
  *             The pointer to CSX1276 object.
  *
- * @param      PowerLevel
- *             The output power level value. The level values are in range from 0 to 14dBm.
- *
  * @return     The function returns one of the following a result codes:
- *              - LORATRANSCEIVERITF_RESULT_SUCCESS = the 'PowerLevel' is set for LoRa radio
- *              - LORATRANSCEIVERITF_RESULT_ERROR = error during configuration
- *              - LORATRANSCEIVERITF_RESULT_INVALIDPARAMS = invalid 'PowerLevel' value specified
- *              - LORATRANSCEIVERITF_RESULT_NOTEXECUTED = the operation has not been executed
- *
- * @note       Typically, the maximum current (OCP) must adjusted according to required power
- *             level. This adjustment is made automatically by 'CSX1276_setPowerMode' method.
- *             When output power is set using 'CSX1276_setPowerLevel' method, an explicit
- *             call to 'CSX1276_setMaxCurrent' function is generaly required. 
+ *              - LORATRANSCEIVERITF_RESULT_SUCCESS = the 'Bandwidth' is stored in member
+ *                 variable
+ *              - LORATRANSCEIVERITF_RESULT_INVALIDSTATE = LoRa mode not configured before 
+ *                 calling the function
+ *              - LORATRANSCEIVERITF_RESULT_ERROR = the retrieved 'Bandwidth' is not allowed
 *********************************************************************************************/
-uint8_t CSX1276_setPowerLevel(CSX1276 *this, uint8_t PowerLevel)
+uint8_t CSX1276_getBW(CSX1276 *this)
 {
-  BYTE st0;
   uint8_t resultCode = LORATRANSCEIVERITF_RESULT_NOTEXECUTED;
-  BYTE value = 0x00;
-  register spi_device_handle_t SPIDeviceHandle = this->m_SpiDeviceHandle;
+  BYTE config1;
 
   #if (SX1276_DEBUG_LEVEL0)
     DEBUG_PRINT_CR;
-    DEBUG_PRINT_LN("[INFO] Starting 'CSX1276_setPowerLevel'");
+    DEBUG_PRINT_LN("[INFO] Starting 'CSX1276_getBW'");
   #endif
 
-  // Maximum power 14dBm
-  if (PowerLevel > 14)
+  if (this->m_usModemMode != MODEM_MODE_LORA)
   {
     #if (SX1276_DEBUG_LEVEL0)
-      DEBUG_PRINT("[ERROR] Power Level ");
-      DEBUG_PRINT_HEX(PowerLevel);
-      DEBUG_PRINT_LN(" is not a correct value");
+      DEBUG_PRINT_LN("[ERROR] LoRa mode must be configured before calling function");
       DEBUG_PRINT_CR;
     #endif
-    return LORATRANSCEIVERITF_RESULT_INVALIDPARAMS;
-  }
-
-  if (this->m_usModemMode != MODEM_MODE_LORA)
-  { 
-    // Should never occur: Lora mode must be set first
-    #if (SX1276_DEBUG_LEVEL0)
-      DEBUG_PRINT("[WARNING] LoRa mode not set, activating now");
-    #endif
-    if ((resultCode = CSX1276_setLoRa(this)) != LORATRANSCEIVERITF_RESULT_SUCCESS)
-    {
-      return resultCode;
-    }
-  }
-
-  // Save the currenrt OP mode
-  st0 = CSX1276_readRegister(SPIDeviceHandle, REG_OP_MODE);    
-
-  // LoRa Standby mode to write in registers
-  if (st0 != LORA_STANDBY_MODE)
-  {
-    CSX1276_writeRegister(SPIDeviceHandle, REG_OP_MODE, LORA_STANDBY_MODE);
+    return LORATRANSCEIVERITF_RESULT_INVALIDSTATE;
   }
 
-  resultCode = LORATRANSCEIVERITF_RESULT_ERROR;
-
-  this->m_usPowerLevel = PowerLevel;
-
-  // Clear OutputPower, but keep current value of PaSelect and MaxPower
-  value = CSX1276_readRegister(SPIDeviceHandle, REG_PA_CONFIG);
-  value = value & 0b11110000;
-  value = value + this->m_usPowerLevel;
-  this->m_usPowerLevel = value;
-
-  // Set output power value
-  CSX1276_writeRegister(SPIDeviceHandle, REG_PA_CONFIG, this->m_usPowerLevel); 
-  value = CSX1276_readRegister(SPIDeviceHandle, REG_PA_CONFIG);
+  // Take out bits 7-4 from REG_MODEM_CONFIG1 indicates _bandwidth
+  config1 = (CSX1276_readRegister(this, REG_MODEM_CONFIG1)) >> 4;
 
-  if (value == this->m_usPowerLevel)
+  if (CSX1276_isBW(config1))
   {
-    this->m_usPowerMode = SX1276_POWER_MODE_CUSTOM;
+    this->m_usBandwidth = config1;
     resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
     #if (SX1276_DEBUG_LEVEL0)
-      DEBUG_PRINT_LN("[INFO] Output power level has been successfully set");
+      DEBUG_PRINT("[INFO] Bandwidth is ");
+      DEBUG_PRINT_HEX(config1);
       DEBUG_PRINT_CR;
     #endif
   }
   else
   {
+    resultCode = LORATRANSCEIVERITF_RESULT_ERROR;
     #if (SX1276_DEBUG_LEVEL0)
-      DEBUG_PRINT_LN("[ERROR] Filed to set output power level");
+      DEBUG_PRINT("[ERROR] Retrieved Bandwidth not allowed, value is: ");
+      DEBUG_PRINT_HEX(config1);
       DEBUG_PRINT_CR;
     #endif
   }
+  return resultCode;
+}
 
-  // Restore previous OP mode
-  if (st0 != LORA_STANDBY_MODE)
+// Returns the LoRa symbol duration (microseconds) for the configured bandwidth (0 if bandwidth
+// not supported)
+DWORD CSX1276_getSymbolTime(CSX1276 *this, BYTE usSpreadingFactor)
+{
+  DWORD dwBandwidth;
+
+  switch (this->m_usBandwidth)
   {
-    CSX1276_writeRegister(SPIDeviceHandle, REG_OP_MODE, st0);  
+    case LORATRANSCEIVERITF_BANDWIDTH_125:
+      dwBandwidth = 125;
+      break;
+    case LORATRANSCEIVERITF_BANDWIDTH_250:
+      dwBandwidth = 250;
+      break;
+    case LORATRANSCEIVERITF_BANDWIDTH_500:
+      dwBandwidth = 500;
+      break;
+    default:
+      return 0;
+  }
+
+  // 2^SF chips at BW kHz
+  return (((DWORD) 1 << usSpreadingFactor) * 1000) / dwBandwidth;
+}
+
+
+// Stores the datarate text for specified SF and configured bandwidth (i.e. text value retrieved
+// by client object when a LoraPacket is received)
+void CSX1276_setDataRateText(CSX1276 *this, BYTE usSpreadingFactor)
+{
+  sprintf((char *) this->m_ReceivedPacketInfo.m_szDataRate, "SF%dBW", (int) usSpreadingFactor);
+  switch (this->m_usBandwidth)
+  {
+    case LORATRANSCEIVERITF_BANDWIDTH_125:
+      strcat((char *) this->m_ReceivedPacketInfo.m_szDataRate, "125");
+      break;
+    case LORATRANSCEIVERITF_BANDWIDTH_250:
+      strcat((char *) this->m_ReceivedPacketInfo.m_szDataRate, "250");
+      break;
+    case LORATRANSCEIVERITF_BANDWIDTH_500:
+      strcat((char *) this->m_ReceivedPacketInfo.m_szDataRate, "500");
+      break;
+    default:
+      strcat((char *) this->m_ReceivedPacketInfo.m_szDataRate, "?");
+      #if (SX1276_DEBUG_LEVEL0)
+        DEBUG_PRINT_LN("[ERROR] Unable to generate datarate string");
+      #endif
   }
-  return resultCode;
 }
 
 /*****************************************************************************************//**
- * @fn         uint8_t CSX1276_setPreambleLength(CSX1276 *this, uint16_t PreambleLength)
+ * @fn         uint8_t CSX1276_setPacketLength(CSX1276 *this, uint8_t PacketLength)
  * 
- * @brief      Sets the Preamble Length in SX1276.
+ * @brief      Sets the packet length in SX1276.
  * 
- * @details    The function sets the specified Preamble Length for LoRa radio.
+ * @details    The function sets the expected payload length (used in implicit header mode).
  *
  * @param      this
  *             The pointer to CSX1276 object.
  *
- * @param      PreambleLength
- *             The value to set as preamble length. The standard value for LoRa network is 8.
+ * @param      PacketLength
+ *             The payload length to set in SX1276 registry.
  *
  * @return     The function returns one of the following a result codes:
- *              - LORATRANSCEIVERITF_RESULT_SUCCESS = the 'PreambleLength' is set for LoRa radio
+ *              - LORATRANSCEIVERITF_RESULT_SUCCESS = the packet length is set in SX1276/
  *              - LORATRANSCEIVERITF_RESULT_ERROR = error during configuration
- *              - LORATRANSCEIVERITF_RESULT_NOTEXECUTED = the operation has not been executed
+ *              - LORATRANSCEIVERITF_RESULT_INVALIDSTATE = function called on invalid state
 *********************************************************************************************/
-uint8_t CSX1276_setPreambleLength(CSX1276 *this, uint16_t PreambleLength)
+uint8_t CSX1276_setPacketLength(CSX1276 *this, uint8_t PacketLength)
 {
   BYTE st0;
-  uint8_t p_length;
-  int8_t resultCode = LORATRANSCEIVERITF_RESULT_NOTEXECUTED;
-  register spi_device_handle_t SPIDeviceHandle = this->m_SpiDeviceHandle;
+  BYTE value = 0x00;
+  uint8_t resultCode = LORATRANSCEIVERITF_RESULT_ERROR;
 
   #if (SX1276_DEBUG_LEVEL0)
     DEBUG_PRINT_CR;
-    DEBUG_PRINT_LN("[INFO] Starting 'CSX1276_setPreambleLength'");
+    DEBUG_PRINT_LN("Starting 'CSX1276_setPacketLength'");
   #endif
 
   if (this->m_usModemMode != MODEM_MODE_LORA)
   { 
-    // Should never occur: Lora mode must be set first
+    // LoRa mode must be set before calling this function
     #if (SX1276_DEBUG_LEVEL0)
-      DEBUG_PRINT("[WARNING] LoRa mode not set, activating now");
+      DEBUG_PRINT_LN("[ERROR] LoRa mode must be configured before calling function");
+      DEBUG_PRINT_CR;
     #endif
-    if ((resultCode = CSX1276_setLoRa(this)) != LORATRANSCEIVERITF_RESULT_SUCCESS)
-    {
-      return resultCode;
-    }
+    return LORATRANSCEIVERITF_RESULT_INVALIDSTATE;
   }
 
   // Save the current OP mode
-  st0 = CSX1276_readRegister(SPIDeviceHandle, REG_OP_MODE); 
-   
-  resultCode = LORATRANSCEIVERITF_RESULT_ERROR;
+  st0 = CSX1276_readRegister(this, REG_OP_MODE);  
+  
 
-  // Set Standby mode to write in registers
+  // Set LoRa Standby mode to write in registers
   if (st0 != LORA_STANDBY_MODE)
   {
-    CSX1276_writeRegister(SPIDeviceHandle, REG_OP_MODE, LORA_STANDBY_MODE);    
+    CSX1276_writeRegister(this, REG_OP_MODE, LORA_STANDBY_MODE);    
   }
 
-  p_length = ((PreambleLength >> 8) & 0x0FF);
-
-  // Store MSB preamble length for LoRa mode
-  CSX1276_writeRegister(SPIDeviceHandle, REG_PREAMBLE_MSB_LORA, p_length);
-  p_length = (PreambleLength & 0x0FF);
-
-  // Store LSB preamble length for LoRa mode
-  CSX1276_writeRegister(SPIDeviceHandle, REG_PREAMBLE_LSB_LORA, p_length);
+  // Set packet length in register
+  CSX1276_writeRegister(this, REG_PAYLOAD_LENGTH_LORA, PacketLength);
 
-  resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
+  // Check length in register
+  value = CSX1276_readRegister(this, REG_PAYLOAD_LENGTH_LORA);
 
-  this->m_wPreambleLength = PreambleLength;
-   
-  #if (SX1276_DEBUG_LEVEL0)
-    DEBUG_PRINT("[INFO] Preamble length ");
-    DEBUG_PRINT_HEX(PreambleLength);
-    DEBUG_PRINT_LN(" has been successfully set");
-    DEBUG_PRINT_CR;
-  #endif
+  if (PacketLength == value)
+  {
+//    this->m_pPacketSent->length = PacketLength;
+    resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
+    #if (SX1276_DEBUG_LEVEL0)
+      DEBUG_PRINT("[INFO] Packet length ");
+      DEBUG_PRINT_DEC(PacketLength);
+      DEBUG_PRINT_LN(" has been successfully set");
+      DEBUG_PRINT_CR;
+    #endif
+  }
+  else
+  {
+    resultCode = LORATRANSCEIVERITF_RESULT_ERROR;
+    #if (SX1276_DEBUG_LEVEL0)
+      DEBUG_PRINT_LN("[ERROR] Failed to set packet length in SX1276");
+      DEBUG_PRINT_CR;
+    #endif
+  }
 
-  // Restore previous OP mode
+  // Restore to previous OP mode
   if (st0 != LORA_STANDBY_MODE)
   {
-    CSX1276_writeRegister(SPIDeviceHandle, REG_OP_MODE, st0);  
+    CSX1276_writeRegister(this, REG_OP_MODE, st0);  
   }
+
+  // To Check => removed !!!
+//vTaskDelay(pdMS_TO_TICKS(250));
+
   return resultCode;
 }
 
+/*********************************************************************************************
+  Private methods (implementation)
+
+  SX1276 packet receive and send operations.
+
+  These functions are invoked by the main automaton (interface commands or notifications
+  from ISR).
+*********************************************************************************************/
+
+
 /*****************************************************************************************//**
- * @fn         uint8_t CSX1276_getSNR(CSX1276 *this)
+ * @fn         uint8_t CSX1276_startStandBy(CSX1276 *this)
  * 
- * @brief      Gets the SNR in SX1276.
+ * @brief      Starts the standby mode in SX1276.
  * 
- * @details    The function gets SNR from SX1276 register and store the value in 'm_SNR' member
- *             variable of CSX1276 object.\n
- *             The SNR is available only for LoRa radio.\n
- *             The LoRa radio mode must be configured before calling this function.
+ * @details    The function sets the SX1276 modem in standby mode.\n
+ *             The device radio activity is stopped and LoRa packets are not received and 
+ *             cannot be sent until the modem mode is explicitly changed (i.e. by invoking
+ *             'CSX1276_startReceive' or 'CSX1276_startSent' method.\n
+ *             The hardware interrupt request handlers for 'RX_DONE' and 'TX_DONE' interrupts
+ *             are disabled.
  *
  * @param      this
  *             The pointer to CSX1276 object.
- *
- * @return     The function returns one of the following a result codes:
- *              - LORATRANSCEIVERITF_RESULT_SUCCESS = the 'SNR' is stored in member variable
- *              - LORATRANSCEIVERITF_RESULT_INVALIDSTATE = LoRa mode not configured before 
- *                                                         calling the function
+ *  
+ * @return     The function returns 'LORATRANSCEIVERITF_RESULT_SUCCESS' if the device is
+ *             in standby mode or 'LORATRANSCEIVERITF_RESULT_ERROR' in case of error.
 *********************************************************************************************/
-uint8_t CSX1276_getSNR(CSX1276 *this)
-{ 
-  int8_t resultCode = LORATRANSCEIVERITF_RESULT_NOTEXECUTED;
-  BYTE value;
-  register spi_device_handle_t SPIDeviceHandle = this->m_SpiDeviceHandle;
-
+uint8_t CSX1276_startStandBy(CSX1276 *this)
+{
+  BYTE usRegValue;
+  
   #if (SX1276_DEBUG_LEVEL0)
     DEBUG_PRINT_CR;
-    DEBUG_PRINT_LN("[INFO] Starting 'CSX1276_getSNR'");
+    DEBUG_PRINT_LN("Starting 'CSX1276_startStandBy'");
   #endif
 
-  if (this->m_usModemMode == MODEM_MODE_LORA)
-  { 
-    // 'getSNR' exists only in LoRa mode
-    value = CSX1276_readRegister(SPIDeviceHandle, REG_PKT_SNR_VALUE);
+  // Disable dectection of 'PACKET_RECEIVED' and 'PACKET_SENT' IRQ
+  gpio_intr_disable(this->m_nPinIrq); 
 
-    // The SNR sign bit is 1
-    if (value & 0x80) 
-    {
-      // Invert and divide by 4
-      value = ((~value + 1) & 0xFF) >> 2;
-      this->m_nSNRPacket = -value;
-    }
-    else
-    {
-      // Divide by 4
-      this->m_nSNRPacket = (value & 0xFF) >> 2;
-    }
-    resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
-    #if (SX1276_DEBUG_LEVEL0)
-      DEBUG_PRINT("[INFO] SNR value is ");
-      DEBUG_PRINT_DEC(this->m_nSNRPacket);
-      DEBUG_PRINT_CR;
-    #endif
-  }
-  else
-  { 
-    // LoRa mode must be set before calling this function
-    resultCode = LORATRANSCEIVERITF_RESULT_INVALIDSTATE;
+  // Change modem mode in SX1276
+  CSX1276_writeRegister(this, REG_OP_MODE, LORA_STANDBY_MODE);		
+
+  // Delay 100ms -> From libelium/CPham -> removed by FF, TO CHECK
+  //vTaskDelay(pdMS_TO_TICKS(100));
+
+  usRegValue = CSX1276_readRegister(this, REG_OP_MODE);		
+
+  if (usRegValue != LORA_STANDBY_MODE)
+  {
     #if (SX1276_DEBUG_LEVEL0)
-      DEBUG_PRINT_LN("[ERROR] LoRa mode must be configured before calling function");
-      DEBUG_PRINT_CR;
+      DEBUG_PRINT_LN("[ERROR] Failed to set STANDBY mode in SX1276");
     #endif
+    return LORATRANSCEIVERITF_RESULT_ERROR;
   }
-  return resultCode;
+
+  #if (SX1276_DEBUG_LEVEL0)
+    DEBUG_PRINT_LN("[INFO] StandBy mode successfully started in SX1276");
+  #endif
+
+  return LORATRANSCEIVERITF_RESULT_SUCCESS;
 }
 
 /*****************************************************************************************//**
- * @fn         uint8_t CSX1276_getRSSI(CSX1276 *this)
+ * @fn         uint8_t CSX1276_startReceive(CSX1276 *this)
  * 
- * @brief      Gets the current value of RSSI in SX1276.
+ * @brief      Starts the receive mode in SX1276.
  * 
- * @details    The function gets current value of RSSI from SX1276 register and store the 
- *             value in 'm_RSSI' member variable of CSX1276 object.\n
- *             The LoRa radio mode must be configured before calling this function.
+ * @details    The function sets the SX1276 in receive mode.\n
+ *             If a LoRa packet is received, it stored in the SX1276 FIFO.\n
+ *             The device is configured to accept a paylod of 'LORA_MAX_PAYLOAD_LENGTH' bytes.\n
+ *             When the packet is received, a hardware 'RX_DONE' interrupt request is generated.
+ *             The function enables the reception of this interrupt on corresponding GPIO of
+ *             ESP32 device (i.e. 'm_nPinIrq' in 'SX1276_DEVICE_PINS').
  *
  * @param      this
  *             The pointer to CSX1276 object.
+ *  
+ * @return     The function returns 'LORATRANSCEIVERITF_RESULT_SUCCESS' if the device is
+ *             in receiving mode or 'LORATRANSCEIVERITF_RESULT_ERROR' in case of error.
  *
- * @return     The function returns one of the following a result codes:
- *              - LORATRANSCEIVERITF_RESULT_SUCCESS = the 'RSSI' is stored in member variable
- *              - LORATRANSCEIVERITF_RESULT_INVALIDSTATE = LoRa mode not configured before 
- *                                                         calling the function
+ * @note       The SX1276 'RX_DONE' pin must be connected to the 'm_nPinIrq' pin on ESP32 (see
+ *             'SX1276_DEVICE_PINS').
 *********************************************************************************************/
-uint8_t CSX1276_getRSSI(CSX1276 *this)
+uint8_t CSX1276_startReceive(CSX1276 *this)
 {
-  uint8_t resultCode = LORATRANSCEIVERITF_RESULT_NOTEXECUTED;
-  int rssi_mean = 0;
-  int total = 5;
-  register spi_device_handle_t SPIDeviceHandle = this->m_SpiDeviceHandle;
-
+  uint8_t resultCode = LORATRANSCEIVERITF_RESULT_ERROR;
+  
   #if (SX1276_DEBUG_LEVEL0)
     DEBUG_PRINT_CR;
-    DEBUG_PRINT_LN("[INFO] Starting 'CSX1276_getRSSI'");
+    DEBUG_PRINT_LN("Starting 'CSX1276_startReceive'");
   #endif
 
-  if (this->m_usModemMode == MODEM_MODE_LORA)
-  { 
-    // Get mean value of RSSI
-    for (int i = 0; i < total; i++)
-    {
-      this->m_nRSSI = -OFFSET_RSSI + CSX1276_readRegister(SPIDeviceHandle, REG_RSSI_VALUE_LORA);
-      rssi_mean += this->m_nRSSI;     
-    }
-    rssi_mean = rssi_mean / total;  
-    this->m_nRSSI = rssi_mean;
-    
-    resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
+  // Clear m_pPacketReceived struct
+  if (this->m_pPacketReceived != NULL)
+  {
+    memset(this->m_pPacketReceived, 0x00, sizeof(CLoraPacket));  
+  }
+
+  // Set Testmode
+  CSX1276_writeRegister(this, 0x31, 0x43);
+
+  // Set LowPnTxPllOff 
+  CSX1276_writeRegister(this, REG_PA_RAMP, 0x09);
+
+  // Set LNA gain: Highest gain. LnaBoost:Improved sensitivity
+  CSX1276_writeRegister(this, REG_LNA, 0x23);
+
+  // Setting address pointer in FIFO data buffer    
+  CSX1276_writeRegister(this, REG_FIFO_ADDR_PTR, 0x00);   
+
+  // Change RegSymbTimeoutLsb 
+  CSX1276_writeRegister(this, REG_SYMB_TIMEOUT_LSB, 0xFF);
+
+  // Set current value of reception buffer pointer
+  CSX1276_writeRegister(this, REG_FIFO_RX_BYTE_ADDR, 0x00); 
+  
+  // Set packet length in order to get all packets with length <= LORA_MAX_PAYLOAD_LENGTH  
+  if ((resultCode = CSX1276_setPacketLength(this, LORA_MAX_PAYLOAD_LENGTH)) == LORATRANSCEIVERITF_RESULT_SUCCESS)
+  {
+    CSX1276_clearFlags(this); 
+
+    // Set SX1276 DIO0 for RX_DONE IRQ (bits 6-7)
+    CSX1276_writeRegister(this, REG_DIO_MAPPING1, 0b00000000);     
+
+    // Enable 'PACKET_RECEIVED' IRQ detection (on ESP32)
+    gpio_intr_enable(this->m_nPinIrq); 
+
+    // Set LORA mode - Rx
+    CSX1276_writeRegister(this, REG_OP_MODE, LORA_RX_MODE);     
+
     #if (SX1276_DEBUG_LEVEL0)
-      DEBUG_PRINT("[INFO] RSSI value is ");
-      DEBUG_PRINT_DEC(this->m_nRSSI);
-      DEBUG_PRINT_CR;
-    #endif  
+      DEBUG_PRINT_LN("[INFO] Receiving mode successfully started in SX1276");
+    #endif
   }
   else
   {
-    // LoRa mode must be set before calling this function
-    resultCode = LORATRANSCEIVERITF_RESULT_INVALIDSTATE;
     #if (SX1276_DEBUG_LEVEL0)
-      DEBUG_PRINT_LN("[ERROR] LoRa mode must be configured before calling function");
-      DEBUG_PRINT_CR;
+      DEBUG_PRINT_LN("[ERROR] Failed to start receiving mode in SX1276");
     #endif
   }
   return resultCode;
 }
 
 /*****************************************************************************************//**
- * @fn         uint8_t CSX1276_getRSSIpacket(CSX1276 *this)
+ * @fn         uint8_t CSX1276_getPacket(CSX1276 *this)
  * 
- * @brief      Gets the RSSI of last received packet.
+ * @brief      Transfers received packet from SX1276 to CSX1276 object.
  * 
- * @details    The function retrieves in SX1276 register the RSSI of last received packet and
- *             stores the value in 'm_RSSIpacket' member variable of CSX1276 object.\n
- *             The RSSI for last received packet is available only for LoRa radio.\n
- *             The LoRa radio mode must be configured before calling this function.
+ * @details    The function reads the received packet bytes in SX1276 FIFO and copies them in
+ *             'm_pPacketReceived' member variable of CSX1276 object.
  *
  * @param      this
  *             The pointer to CSX1276 object.
+ *  
+ * @return     The function returns 'LORATRANSCEIVERITF_RESULT_SUCCESS' if bytes are transfered
+ *             in CSX1276 object or 'LORATRANSCEIVERITF_RESULT_ERROR' in case of error.
  *
- * @return     The function returns one of the following a result codes:
- *              - LORATRANSCEIVERITF_RESULT_SUCCESS = the last packet 'RSSI' is stored in 
- *                 member variable
- *              - LORATRANSCEIVERITF_RESULT_INVALIDSTATE = LoRa mode not configured before 
- *                 calling the function
+ * @note       On exit, the function clears flag register of SX1276 are sets FIFO base pointer
+ *             to 0x00.
 *********************************************************************************************/
-uint8_t CSX1276_getRSSIpacket(CSX1276 *this)
-{ 
-  uint8_t resultCode = LORATRANSCEIVERITF_RESULT_NOTEXECUTED;
-  register spi_device_handle_t SPIDeviceHandle = this->m_SpiDeviceHandle;
+uint8_t CSX1276_getPacket(CSX1276 *this)
+{
+  uint8_t resultCode;
+  BYTE value;
+  BYTE usReceivedBytesNum;
+  BYTE usSnrValue;
+  BYTE usRssiValue;
+  struct timeval tmNow; 
+  QWORD qwElapsed;
+  bool bPacketReceived = false;
+  CLoraPacket *pPacketReceived = NULL;
 
-  #if (SX1276_DEBUG_LEVEL0)
-    DEBUG_PRINT_CR;
-    DEBUG_PRINT_LN("[INFO] Starting 'CSX1276_getRSSIpacket'");
-  #endif
+  // Debug -> duration
+  //previous = xTaskGetTickCount();
 
-  if (this->m_usModemMode == MODEM_MODE_LORA)
+  // The post-RX sequence is pipelined in two batches of SPI transactions:
+  //  1- IRQ flags, number of received bytes, packet SNR and RSSI, FIFO address pointer
+  //  2- Payload (length known from first batch), FIFO address pointer, IRQ flags
+  CSX1276_batchBegin(this);
+  CSX1276_batchReadRegister(this, REG_IRQ_FLAGS, &value);
+  CSX1276_batchReadRegister(this, REG_RX_NB_BYTES, &usReceivedBytesNum);
+  CSX1276_batchReadRegister(this, REG_PKT_SNR_VALUE, &usSnrValue);
+  CSX1276_batchReadRegister(this, REG_PKT_RSSI_VALUE, &usRssiValue);
+  CSX1276_batchWriteRegister(this, REG_FIFO_ADDR_PTR, 0x00); 
+  CSX1276_batchWait(this);
+  
+  // Check if 'RxDone' is true and 'PayloadCrcError' is correct
+  if ((bitRead(value, 6) == 1) && (bitRead(value, 5) == 0))
+  { 
+    // Packet received and CRC correct
+    bPacketReceived = true;
+  }
+  else
   {
-    // RSSIpacket only exists in LoRa 
-    resultCode = CSX1276_getSNR(this);
-    if (resultCode == LORATRANSCEIVERITF_RESULT_SUCCESS)
+    // NOTE: Should never reach this point with HW IRQ for 'RxDone'
+
+    if (bitRead(value, 6) != 1)
+    { 
+      #if (SX1276_DEBUG_LEVEL0)
+        DEBUG_PRINT_LN("[ERROR] NOT 'RxDone' flag");
+      #endif
+    }
+    
+    if (this->m_usCRC != SX1276_CRC_ON)
+    { 
+      #if (SX1276_DEBUG_LEVEL0)
+        DEBUG_PRINT_LN("[ERROR] NOT 'CRC_ON' enabled");
+      #endif
+    }
+    
+    if ((bitRead(value, 5) == 0) && (this->m_usCRC == SX1276_CRC_ON))
+    { 
+      // CRC is correct
+      #if (SX1276_DEBUG_LEVEL0)
+        DEBUG_PRINT_LN("[INFO] The CRC is correct");
+      #endif
+    }
+    else
+    { 
+      // CRC incorrect
+      #if (SX1276_DEBUG_LEVEL0)
+        DEBUG_PRINT_LN("[ERROR] The CRC is incorrect");
+      #endif
+    }
+  }     
+  
+  // Transfer packet from SX1276 to 'm_pPacketReceived' object if properly received
+  if (bPacketReceived == true)
+  { 
+    if (this->m_pLoraPacketPool != NULL)
     {
-      if (this->m_nSNRPacket < 0)
-      {
-        this->m_nRSSIPacket = -NOISE_ABSOLUTE_ZERO + 10.0 * SignalBwLog[this->m_usBandwidth] + NOISE_FIGURE + (double)this->m_nSNRPacket;
-      }
-      else
+      // Shared packet buffers: the receive buffer is always owned by the CSX1276 object
+      // Only missing if the pool was exhausted when previous packet was provided to owner object
+      if (this->m_pPacketReceived == NULL)
       {
-        this->m_nRSSIPacket = CSX1276_readRegister(SPIDeviceHandle, REG_PKT_RSSI_VALUE);
-        this->m_nRSSIPacket = -OFFSET_RSSI + (double)this->m_nRSSIPacket;
+        this->m_pPacketReceived = CSX1276_getReceiveBuffer(this);
       }
+    }
+    else if (this->m_pPacketReceived->m_dwDataSize != 0)
+    {
+      // Check if 'm_pPacketReceived' is available for receiving data
+      // (i.e. owner object must read previous received packet before receiving another packet)
+      // Wait a bit (but not too much)
+      #if (SX1276_DEBUG_LEVEL0)
+        DEBUG_PRINT_LN("[WARNING] Previous packet still in buffer");
+      #endif
+
+      vTaskDelay(pdMS_TO_TICKS(10));
+    }
+    pPacketReceived = this->m_pPacketReceived;
+    
+    if ((pPacketReceived == NULL) || (pPacketReceived->m_dwDataSize != 0))
+    {
+      // Miss this packet
+      pPacketReceived = NULL;
+      ++this->m_dwMissedPacketReceivedNumber;
+      resultCode = LORATRANSCEIVERITF_RESULT_ERROR;
+
       #if (SX1276_DEBUG_LEVEL0)
-        DEBUG_PRINT("## RSSI packet value is ");
-        DEBUG_PRINT_DEC(this->m_nRSSIPacket);
-        DEBUG_PRINT_LN(" ##");
+        DEBUG_PRINT("[ERROR] No receive buffer available, total missed: ");
+        DEBUG_PRINT_DEC(this->m_dwMissedPacketReceivedNumber);
         DEBUG_PRINT_CR;
       #endif
     }
+    else
+    {
+      // Receive buffer available
+      // Note: Timestamp latched by ISR at 'RX_DONE' IRQ edge (i.e. no task scheduling jitter)
+      pPacketReceived->m_qwTimestamp = this->m_qwIrqTimestamp;
+      CTaskPlacement_RecordLatency(TASKPLACEMENT_TASK_SX1276, pPacketReceived->m_qwTimestamp);
+  
+      #if (SX1276_DEBUG_LEVEL0)
+        TRACERING_EVENT(TRACERING_ID_SX1276_RX_PACKET, usReceivedBytesNum, usSnrValue, usRssiValue, value);
+      #endif
+  
+      // Store the packet
+      // Read all payload bytes in a single SPI burst transaction (FIFO address pointer set by
+      // first batch)
+      // Note: Packet information below is computed while the payload is transferred
+      CSX1276_batchReadBurst(this, REG_FIFO, pPacketReceived->m_usData, (WORD) usReceivedBytesNum);
+     
+      // RSSI information for received packet
+      // Note: 'm_nRSSIPacket' and 'm_nSNRPacket' member variables are updated
+      CSX1276_setPacketSignal(this, usSnrValue, usRssiValue);
+
+      // Lora SNR ratio in dB (signed float, 0.1 dB precision)
+      sprintf((char *) this->m_ReceivedPacketInfo.m_szSNR, "%.1lf", (double) this->m_nSNRPacket);
+
+      //  RSSI in dBm (signed integer, 1 dB precision)
+      sprintf((char *) this->m_ReceivedPacketInfo.m_szRSSI, "%d", (int) this->m_nRSSIPacket);
+       
+      // UTC timestamp
+      // Note: Current UTC time moved back to the IRQ edge (i.e. time elapsed since ISR)
+      gettimeofday(&tmNow, NULL); 
+      qwElapsed = GATEWAY_CLOCK_MICROSEC() - pPacketReceived->m_qwTimestamp;
+      if ((QWORD) tmNow.tv_usec < (qwElapsed % 1000000))
+      {
+        tmNow.tv_sec -= 1;
+        tmNow.tv_usec += 1000000;
+      }
+      this->m_ReceivedPacketInfo.m_dwUTCSec = tmNow.tv_sec - (DWORD) (qwElapsed / 1000000);
+      this->m_ReceivedPacketInfo.m_dwUTCMicroSec = tmNow.tv_usec - (DWORD) (qwElapsed % 1000000);
+  
+      resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
+    }
+  }
+  else
+  {
+    // Packet NOT received
+    resultCode = LORATRANSCEIVERITF_RESULT_ERROR;
+
+    #if (SX1276_DEBUG_LEVEL0)
+      DEBUG_PRINT_LN("[ERROR] Failed to transfer packet from SX1276");
+    #endif
   }
-  else
-  { 
-    // LoRa mode must be set before calling this function
-    resultCode = LORATRANSCEIVERITF_RESULT_INVALIDSTATE;
+  
+  // Set address pointer in FIFO data buffer to 0x00 again and initialize flags
+  // Note: Queued after payload burst read (second batch)
+  CSX1276_batchWriteRegister(this, REG_FIFO_ADDR_PTR, 0x00);
+  CSX1276_batchClearFlags(this); 
+  CSX1276_batchWait(this);
+
+  if (pPacketReceived != NULL)
+  {
+    // Payload available after completion of second batch
+    pPacketReceived->m_dwDataSize = (DWORD) usReceivedBytesNum;
+
+    // Trace the packet header if debug_mode (i.e. MHDR, DevAddr, FCtrl, FCnt)
     #if (SX1276_DEBUG_LEVEL0)
-      DEBUG_PRINT_LN("[ERROR] LoRa mode must be configured before calling function");
-      DEBUG_PRINT_CR;
+      TRACERING_EVENT(TRACERING_ID_SX1276_RX_PAYLOAD, usReceivedBytesNum,
+                      TRACERING_BYTES(pPacketReceived->m_usData, usReceivedBytesNum, 0),
+                      TRACERING_BYTES(pPacketReceived->m_usData, usReceivedBytesNum, 4),
+                      TRACERING_BYTES(pPacketReceived->m_usData, usReceivedBytesNum, 8));
     #endif
   }
+  
   return resultCode;
 }
 
 /*****************************************************************************************//**
- * @fn         uint8_t CSX1276_setRetries(CSX1276 *this, uint8_t RetryNumber)
+ * @fn         CLoraPacket * CSX1276_getReceiveBuffer(CSX1276 *this)
  * 
- * @brief      Sets the maximum number of send retries.
+ * @brief      Obtains a new receive buffer in shared packet buffers.
  * 
- * @details    The function sets the maximum number of send retries (i.e. for acknowledged
- *             packets).\n
- *             This value is stored in 'm_maxRetries' member variable of CSX1276 object.
+ * @details    The function obtains a block in the pool of shared packet buffers provided by
+ *             owner object (i.e. 'm_pLoraPacketPool'). The CSX1276 object owns the reference on
+ *             the block until the packet received in it is notified to owner object.
  *
  * @param      this
  *             The pointer to CSX1276 object.
- *
- * @param      RetryNumber
- *             The number of send retries to set for the CSX1276 object.
- *             The maximum allowed value is defined by 'LORATRANSCEIVERITF_MAX_SEND_RETRIES'
- *             in 'LoraTransceiverItf.h'.
- *
- * @return     The function returns one of the following a result codes:
- *              - LORATRANSCEIVERITF_RESULT_SUCCESS = the number of retries is stored in 
- *                 member variable
- *              - LORATRANSCEIVERITF_RESULT_INVALIDPARAMS = the specified 'RetryNumber' value
- *                 is out of range.
+ *  
+ * @return     The function returns the receive buffer or NULL if the pool is exhausted.
 *********************************************************************************************/
-uint8_t CSX1276_setRetries(CSX1276 *this, uint8_t RetryNumber)
+CLoraPacket * CSX1276_getReceiveBuffer(CSX1276 *this)
 {
-  #if (SX1276_DEBUG_LEVEL0)
-    DEBUG_PRINT_CR;
-    DEBUG_PRINT_LN("[INFO] Starting 'CSX1276_setRetries'");
-  #endif
+  CWideMemoryBlockArrayEntryOb MemBlockEntry;
+  CLoraPacket *pPacketReceived;
 
-  if (RetryNumber > LORATRANSCEIVERITF_MAX_SEND_RETRIES)
+  if ((pPacketReceived = (CLoraPacket *) CWideMemoryBlockArray_GetBlock(this->m_pLoraPacketPool, &MemBlockEntry)) == NULL)
   {
     #if (SX1276_DEBUG_LEVEL0)
-      DEBUG_PRINT("[ERROR] Retries value cannot be greater than ");
-      DEBUG_PRINT_DEC(LORATRANSCEIVERITF_MAX_SEND_RETRIES);
-      DEBUG_PRINT_CR;
+      DEBUG_PRINT_LN("[WARNING] Shared packet buffers exhausted");
     #endif
-    return LORATRANSCEIVERITF_RESULT_INVALIDPARAMS;
+    return NULL;
   }
 
-  this->m_usMaxRetries = RetryNumber;
-  #if (SX1276_DEBUG_LEVEL0)
-    DEBUG_PRINT("[INFO] Maximum retries value set to ");
-    DEBUG_PRINT_DEC(this->m_usMaxRetries);
-    DEBUG_PRINT_CR;
-  #endif
-  return LORATRANSCEIVERITF_RESULT_SUCCESS;
+  pPacketReceived->m_dwDataSize = 0;
+  return pPacketReceived;
 }
 
 /*****************************************************************************************//**
- * @fn         uint8_t CSX1276_setMaxCurrent(CSX1276 *this, uint8_t OcpRate)
+ * @fn         uint8_t CSX1276_startSend(CSX1276 *this, CLoraTransceiverItf_LoraPacket pLoraPacket)
  * 
- * @brief      Sets the maximum output current in SX1276.
+ * @brief      Transfers specified LoRa packet to SX1276 and starts sending it.
  * 
- * @details    The function limits the current supply of the power amplifier (typically to
- *             protect battery chemistries).
+ * @details    The function copies LoRa packet payload bytes in SX1276 FIFO and starts to 
+ *             transmit them over radio (i.e. 'armSend' immediately followed by 'fireSend').\n
+ *             The SX1276 must be in 'STANDBY' mode before calling this function.
  *
  * @param      this
  *             The pointer to CSX1276 object.
+ *  
+ * @param      pLoraPacket
+ *             The LoRa packet to send.
+ *  
+ * @return     The function returns 'LORATRANSCEIVERITF_RESULT_SUCCESS' if SX1276 is sending
+ *             packet or 'LORATRANSCEIVERITF_RESULT_INVALIDSTATE' if SX1276 is not in 'STANDBY'
+ *             mode.
  *
- * @param      OcpRate
- *             The Over Current Protection rate to set in SX1276 registry.
- *             The maximum allowed value is defined by 'LORATRANSCEIVERITF_OCP_MAX'
- *             in 'LoraTransceiverItf.h'.
- *
- * @return     The function returns one of the following a result codes:
- *              - LORATRANSCEIVERITF_RESULT_SUCCESS = the number of retries is stored in 
- *                 member variable
- *              - LORATRANSCEIVERITF_RESULT_INVALIDPARAMS = the specified 'RetryNumber' value
- *                 is out of range.
- *
- * @note       Maximum current is computed as follows:
- *              - if OcpTrim <= 15, Imax = 45+5*OcpRate [mA] (120 mA)
- *              - if 15 < OcpRate <= 27, Imax = -30+10*OcpRate [mA] (130 to 240 mA)
+ * @note       The SX1276 will trigger a 'TX_DONE' IRQ when packet is transmitted.\n
+ *             When send operation terminates, the SX1276 automatically returns to 'STANDBY' 
+ *             mode.
 *********************************************************************************************/
-uint8_t CSX1276_setMaxCurrent(CSX1276 *this, uint8_t OcpRate)
+uint8_t CSX1276_startSend(CSX1276 *this, CLoraTransceiverItf_LoraPacket pLoraPacket)
 {
-  BYTE st0;
-  register spi_device_handle_t SPIDeviceHandle = this->m_SpiDeviceHandle;
-
-  #if (SX1276_DEBUG_LEVEL0)
-    DEBUG_PRINT_CR;
-    DEBUG_PRINT_LN("[INFO] Starting 'CSX1276_setMaxCurrent'");
-  #endif
-
-  // Check maximum OCP rate value (maximum current supply is 240 mA)
-  if (OcpRate > LORATRANSCEIVERITF_OCP_MAX)
-  {
-    #if (SX1276_DEBUG_LEVEL0)
-      DEBUG_PRINT("[ERROR] Maximum current supply is 240 mA, so maximum parameter value is ");
-      DEBUG_PRINT_DEC(LORATRANSCEIVERITF_OCP_MAX);
-      DEBUG_PRINT_CR;
-    #endif
-    return LORATRANSCEIVERITF_RESULT_INVALIDPARAMS;
-  }
-
-  if (this->m_usModemMode != MODEM_MODE_LORA)
-  {
-    // LoRa mode must be set before calling this function
-    #if (SX1276_DEBUG_LEVEL0)
-      DEBUG_PRINT_LN("[ERROR] LoRa mode must be configured before calling function");
-      DEBUG_PRINT_CR;
-    #endif
-    return LORATRANSCEIVERITF_RESULT_INVALIDSTATE;
-  }
-
-  // Save the current OP mode
-  st0 = CSX1276_readRegister(SPIDeviceHandle, REG_OP_MODE);  
+  uint8_t usResult;
 
-  // Set LoRa Standby mode to write in registers
-  if (st0 != LORA_STANDBY_MODE)
+  if ((usResult = CSX1276_armSend(this, pLoraPacket)) != LORATRANSCEIVERITF_RESULT_SUCCESS)
   {
-    CSX1276_writeRegister(SPIDeviceHandle, REG_OP_MODE, LORA_STANDBY_MODE);  
+    return usResult;
   }
 
-  // Enable Over Current Protection
-  CSX1276_writeRegister(SPIDeviceHandle, REG_OCP, OcpRate | 0b00100000); 
-  this->m_usOcpRate = OcpRate;
-
-  // Restore previous OP mode
-  if (st0 != LORA_STANDBY_MODE)
-  {
-    CSX1276_writeRegister(SPIDeviceHandle, REG_OP_MODE, st0);    
-  }
-  #if (SX1276_DEBUG_LEVEL0)
-    DEBUG_PRINT("[INFO] Maximum current protection set to ");
-    DEBUG_PRINT_DEC(OcpRate);
-    DEBUG_PRINT_CR;
-  #endif
+  CSX1276_fireSend(this, 0);
   return LORATRANSCEIVERITF_RESULT_SUCCESS;
 }
 
+
 /*****************************************************************************************//**
- * @fn         uint8_t CSX1276_getTemp(CSX1276 *this)
+ * @fn         uint8_t CSX1276_armSend(CSX1276 *this, CLoraTransceiverItf_LoraPacket pLoraPacket)
  * 
- * @brief      Gets the temperature of SX1276 device.
+ * @brief      Transfers specified LoRa packet to SX1276 without sending it.
  * 
- * @details    The function retrieves current device temperature in SX1276 register and
- *             stores the value in 'm_temp' member variable of CSX1276 object.
+ * @details    The function copies LoRa packet payload bytes in SX1276 FIFO, sets the payload
+ *             length and maps DIO0 on 'TX_DONE' IRQ.\n
+ *             The SPI transaction switching the SX1276 to TX mode is prepared in 
+ *             'm_FireTrans' (i.e. 'fireSend' only executes this transaction).\n
+ *             The SX1276 must be in 'STANDBY' mode before calling this function.
  *
  * @param      this
  *             The pointer to CSX1276 object.
- *
- * @return     The function returns one of the following a result codes:
- *              - LORATRANSCEIVERITF_RESULT_SUCCESS = the device temperature is stored in 
- *                 member variable
- *              - LORATRANSCEIVERITF_RESULT_INVALIDSTATE = LoRa mode not configured before 
- *                 calling the function
+ *  
+ * @param      pLoraPacket
+ *             The LoRa packet to send.
+ *  
+ * @return     The function returns 'LORATRANSCEIVERITF_RESULT_SUCCESS' if the packet is 
+ *             ready to send or 'LORATRANSCEIVERITF_RESULT_INVALIDSTATE' if SX1276 is not in
+ *             'STANDBY' mode.
 *********************************************************************************************/
-uint8_t CSX1276_getTemp(CSX1276 *this)
+uint8_t CSX1276_armSend(CSX1276 *this, CLoraTransceiverItf_LoraPacket pLoraPacket)
 {
-  BYTE st0;
-  register spi_device_handle_t SPIDeviceHandle = this->m_SpiDeviceHandle;
-  int nTemp;
-
-  #if (SX1276_DEBUG_LEVEL0)
-    DEBUG_PRINT_CR;
-    DEBUG_PRINT_LN("Starting 'getTemp'");
-  #endif
-
-  if (this->m_usModemMode == MODEM_MODE_LORA)
-  { 
-    // LoRa mode must be set before calling this function
+  // The SX1276 must be in 'STANDBY' mode
+  if (CSX1276_readRegister(this, REG_OP_MODE) != LORA_STANDBY_MODE)
+  {
     #if (SX1276_DEBUG_LEVEL0)
-      DEBUG_PRINT_LN("[ERROR] LoRa mode must be configured before calling function");
-      DEBUG_PRINT_CR;
+      DEBUG_PRINT_LN("[ERROR] SX1276 not in 'STANDBY' mode");
     #endif
-    return LORATRANSCEIVERITF_RESULT_INVALIDSTATE;
-  }
-
-  // Save the current OP mode
-  st0 = CSX1276_readRegister(SPIDeviceHandle, REG_OP_MODE);  
-
-  // Allowing access to FSK registers while in LoRa standby mode
-  CSX1276_writeRegister(SPIDeviceHandle, REG_OP_MODE, LORA_STANDBY_FSK_REGS_MODE);
-
-  // Saving temperature value
-  nTemp = CSX1276_readRegister(SPIDeviceHandle, REG_TEMP);
 
-  // Check SNR sign bit
-  if (nTemp & 0x80) 
-  {
-    // The SNR sign bit is 1, invert and divide by 4
-    nTemp = ((~nTemp + 1) & 0xFF);
-  }
-  else
-  {
-    // Divide by 4
-    nTemp = (nTemp & 0xFF);
+    return LORATRANSCEIVERITF_RESULT_INVALIDSTATE;
   }
 
-  #if (SX1276_DEBUG_LEVEL0)
-    DEBUG_PRINT("[INFO] Temperature is: ");
-    DEBUG_PRINT_DEC(nTemp);
-    DEBUG_PRINT_CR;
-  #endif
-  this->m_nTemp = nTemp;
-
-  // Restore previous OP mode
-  CSX1276_writeRegister(SPIDeviceHandle, REG_OP_MODE, st0);  
+  // Keep pointer to packet currently sent
+  // Note: The pointed object will never been accessed outside of this function
+  //       (i.e. just a reference used for 'PACKET_SENT' event)
+  this->m_pPacketToSend = pLoraPacket;
 
-  return LORATRANSCEIVERITF_RESULT_SUCCESS;
-}
+  // The TX preload sequence is pipelined in one batch of SPI transactions (FIFO pointers,
+  // payload, payload length, IRQ flags, DIO mapping)
 
-/*****************************************************************************************//**
- * @fn         uint8_t CSX1276_getSF(CSX1276 *this)
- * 
- * @brief      Gets the Spreading Factor in SX1276.
- * 
- * @details    The function retrieves, in SX1276 register, the Spreading Factor and stores
- *             the value in 'm_usSpreadingFactor' member variable of CSX1276 object.\n
- *             The LoRa radio mode must be configured before calling this function.
- *
- * @param      this
- *             The pointer to CSX1276 object.
- *
- * @return     The function returns one of the following a result codes:
- *              - LORATRANSCEIVERITF_RESULT_SUCCESS = the 'Spreading Factor' is stored in 
- *                 member variable
- *              - LORATRANSCEIVERITF_RESULT_INVALIDSTATE = LoRa mode not configured before 
- *                 calling the function
- *              - LORATRANSCEIVERITF_RESULT_ERROR = the retrieved 'Spreading Factor' is not
- *                 allowed
-*********************************************************************************************/
-uint8_t CSX1276_getSF(CSX1276 *this)
-{
-  int8_t resultCode = LORATRANSCEIVERITF_RESULT_NOTEXECUTED;
-  BYTE config2;
-  register spi_device_handle_t SPIDeviceHandle = this->m_SpiDeviceHandle;
+  // Write payload to send in SX1276 FIFO
+  // Set address pointer in FIFO data buffer
+  CSX1276_batchBegin(this);
+  CSX1276_batchWriteRegister(this, REG_FIFO_TX_BASE_ADDR, 0x00);
+  CSX1276_batchWriteRegister(this, REG_FIFO_ADDR_PTR, 0x00);  
 
-  #if (SX1276_DEBUG_LEVEL0)
-    DEBUG_PRINT_CR;
-    DEBUG_PRINT_LN("[INFO] Starting 'CSX1276_getSF'");
-  #endif
+  // Write bytes in FIFO (single SPI burst transaction)
+  CSX1276_batchWriteBurst(this, REG_FIFO, pLoraPacket->m_usData, (WORD) pLoraPacket->m_dwDataSize);
 
-  if (this->m_usModemMode != MODEM_MODE_LORA)
-  {
-    #if (SX1276_DEBUG_LEVEL0)
-      DEBUG_PRINT_LN("[ERROR] LoRa mode must be configured before calling function");
-      DEBUG_PRINT_CR;
-    #endif
-    return LORATRANSCEIVERITF_RESULT_INVALIDSTATE;
-  }
+  TRACERING_EVENT(TRACERING_ID_SX1276_TX_ARM, pLoraPacket->m_dwDataSize,
+                  TRACERING_BYTES(pLoraPacket->m_usData, pLoraPacket->m_dwDataSize, 0),
+                  TRACERING_BYTES(pLoraPacket->m_usData, pLoraPacket->m_dwDataSize, 4),
+                  TRACERING_BYTES(pLoraPacket->m_usData, pLoraPacket->m_dwDataSize, 8));
 
-  // Take out bits 7-4 from REG_MODEM_CONFIG2 indicates _spreadingFactor
-  config2 = (CSX1276_readRegister(SPIDeviceHandle, REG_MODEM_CONFIG2)) >> 4;
+  // Number of bytes to send (i.e. the value set for reception is the maximum length)
+  CSX1276_batchWriteRegister(this, REG_PAYLOAD_LENGTH_LORA, (BYTE) pLoraPacket->m_dwDataSize);
 
-  if (CSX1276_isSF(config2))
-  {
-    this->m_usSpreadingFactor = config2;
-    resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
-    #if (SX1276_DEBUG_LEVEL0)
-      DEBUG_PRINT("[INFO] Spreading factor is ");
-      DEBUG_PRINT_HEX(config2);
-      DEBUG_PRINT_CR;
-    #endif
-  }
-  else
-  {
-    #if (SX1276_DEBUG_LEVEL0)
-      DEBUG_PRINT("[ERROR] Retrieved Spreading Factor not allowed, value is: ");
-      DEBUG_PRINT_HEX(config2);
-      DEBUG_PRINT_CR;
-    #endif
-    resultCode = LORATRANSCEIVERITF_RESULT_ERROR;
-  }
-  
-  return resultCode;
+  // Notes: 
+  //  - The end of send operation will be dectected by 'TX_DONE' IRQ
+  //  - When send operation terminates, the SX1276 automatically returns to 'STANDBY' mode
+  CSX1276_batchClearFlags(this); 
+
+  // Set SX1276 DIO0 for TX_DONE IRQ (bits 6-7)
+  CSX1276_batchWriteRegister(this, REG_DIO_MAPPING1, 0b01000000);     
+
+  // Preload completed before the packet can be fired
+  CSX1276_batchWait(this);
+
+  // Prepared SPI transaction for the switch to TX mode
+  memset(&(this->m_FireTrans), 0, sizeof(spi_transaction_t));
+  this->m_FireTrans.addr = REG_OP_MODE | 0x80;
+  this->m_FireTrans.length = 8;
+  this->m_FireTrans.flags = SPI_TRANS_USE_TXDATA;
+  this->m_FireTrans.tx_data[0] = LORA_TX_MODE;
+
+  return LORATRANSCEIVERITF_RESULT_SUCCESS;
 }
 
+
 /*****************************************************************************************//**
- * @fn         uint8_t CSX1276_getBW(CSX1276 *this)
+ * @fn         bool CSX1276_fireSend(CSX1276 *this, QWORD qwLateTimestamp)
  * 
- * @brief      Gets the Bandwidth in SX1276.
+ * @brief      Starts to send the LoRa packet transferred by 'armSend'.
  * 
- * @details    The function retrieves the Bandwidth in SX1276 register and stores the value
- *             in 'm_usBandwidth' member variable of CSX1276 object.\n
- *             The LoRa radio mode must be configured before calling this function.
+ * @details    The function executes the SPI transaction prepared by 'armSend' (i.e. single
+ *             register write) and timestamps the beginning of transmission.\n
+ *             The shared SPI bus is taken without RX servicing priority (i.e. a pending 
+ *             received packet of another SX1276 cannot delay the transmission) and with a
+ *             bounded wait ('SX1276_FIRE_BUS_MAX_WAIT').
  *
  * @param      this
  *             The pointer to CSX1276 object.
+ *  
+ * @param      qwLateTimestamp
+ *             The transmission is not started if the SPI bus is not obtained before this
+ *             gateway clock value (0 = wait without limit).
+ *  
+ * @return     The function returns 'true' if the transmission is started or 'false' if the
+ *             late limit is reached (i.e. the packet remains in SX1276 FIFO).
  *
- * @return     The function returns one of the following a result codes:
- *              - LORATRANSCEIVERITF_RESULT_SUCCESS = the 'Bandwidth' is stored in member
- *                 variable
- *              - LORATRANSCEIVERITF_RESULT_INVALIDSTATE = LoRa mode not configured before 
- *                 calling the function
- *              - LORATRANSCEIVERITF_RESULT_ERROR = the retrieved 'Bandwidth' is not allowed
+ * @note       The SX1276 will trigger a 'TX_DONE' IRQ when packet is transmitted.\n
+ *             When send operation terminates, the SX1276 automatically returns to 'STANDBY' 
+ *             mode.
 *********************************************************************************************/
-uint8_t CSX1276_getBW(CSX1276 *this)
+bool CSX1276_fireSend(CSX1276 *this, QWORD qwLateTimestamp)
 {
-  uint8_t resultCode = LORATRANSCEIVERITF_RESULT_NOTEXECUTED;
-  BYTE config1;
-  register spi_device_handle_t SPIDeviceHandle = this->m_SpiDeviceHandle;
-
-  #if (SX1276_DEBUG_LEVEL0)
-    DEBUG_PRINT_CR;
-    DEBUG_PRINT_LN("[INFO] Starting 'CSX1276_getBW'");
-  #endif
+  // Pending writes done before transmission (by design, none after 'armSend')
+  CSX1276_batchWait(this);
+  CSX1276_flushRegisters(this);
 
-  if (this->m_usModemMode != MODEM_MODE_LORA)
+  // Start to send packet
+  // Note: The bus is obtained with a bounded wait and the late limit is checked once obtained (i.e.
+  //       the transaction of another SX1276 may exceed the late limit)
+  if (g_SX1276SpiBusOb.m_hMutex != NULL)
   {
-    #if (SX1276_DEBUG_LEVEL0)
-      DEBUG_PRINT_LN("[ERROR] LoRa mode must be configured before calling function");
-      DEBUG_PRINT_CR;
-    #endif
-    return LORATRANSCEIVERITF_RESULT_INVALIDSTATE;
+    if (xSemaphoreTake(g_SX1276SpiBusOb.m_hMutex, qwLateTimestamp == 0 ? portMAX_DELAY : SX1276_FIRE_BUS_MAX_WAIT) == pdFAIL)
+    {
+      #if (SX1276_DEBUG_LEVEL0)
+        DEBUG_PRINT_LN("[ERROR] CSX1276_fireSend - SPI bus busy, transmission not started");
+      #endif
+      return false;
+    }
+
+    if ((qwLateTimestamp != 0) && (GATEWAY_CLOCK_MICROSEC() > qwLateTimestamp))
+    {
+      xSemaphoreGive(g_SX1276SpiBusOb.m_hMutex);
+      #if (SX1276_DEBUG_LEVEL0)
+        DEBUG_PRINT_LN("[ERROR] CSX1276_fireSend - SPI bus obtained too late, transmission not started");
+      #endif
+      return false;
+    }
   }
 
-  // Take out bits 7-4 from REG_MODEM_CONFIG1 indicates _bandwidth
-  config1 = (CSX1276_readRegister(SPIDeviceHandle, REG_MODEM_CONFIG1)) >> 4;
+  // Enable 'PACKET_SENT' IRQ detection (on ESP32)
+  gpio_intr_enable(this->m_nPinIrq); 
 
-  if (CSX1276_isBW(config1))
-  {
-    this->m_usBandwidth = config1;
-    resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
-    #if (SX1276_DEBUG_LEVEL0)
-      DEBUG_PRINT("[INFO] Bandwidth is ");
-      DEBUG_PRINT_HEX(config1);
-      DEBUG_PRINT_CR;
-    #endif
-  }
-  else
+  esp_err_t ret = this->m_pSpiBackend->m_pTransmit(this->m_SpiDeviceHandle, &(this->m_FireTrans));
+  assert(ret == ESP_OK);
+
+  // Timestamp for begining of transmission
+  this->m_pPacketToSend->m_qwTimestamp = GATEWAY_CLOCK_MICROSEC();
+
+  if (g_SX1276SpiBusOb.m_hMutex != NULL)
   {
-    resultCode = LORATRANSCEIVERITF_RESULT_ERROR;
-    #if (SX1276_DEBUG_LEVEL0)
-      DEBUG_PRINT("[ERROR] Retrieved Bandwidth not allowed, value is: ");
-      DEBUG_PRINT_HEX(config1);
-      DEBUG_PRINT_CR;
-    #endif
+    xSemaphoreGive(g_SX1276SpiBusOb.m_hMutex);
   }
-  return resultCode;
+
+  ++this->m_dwSpiTransactionNumber;
+  this->m_usRegShadow[REG_OP_MODE] = LORA_TX_MODE;
+  this->m_dwRegValidFlags[0] |= SX1276_SHADOW_FLAG_MASK(REG_OP_MODE);
+
+  TRACERING_EVENT(TRACERING_ID_SX1276_TX_FIRE, this->m_pPacketToSend->m_qwTimestamp, 0, 0, 0);
+  return true;
 }
 
+
 /*****************************************************************************************//**
- * @fn         uint8_t CSX1276_setPacketLength(CSX1276 *this, uint8_t PacketLength)
+ * @fn         uint8_t CSX1276_setTxRadio(CSX1276 *this, CLoraTransceiverItf_ArmSendParams pParams)
  * 
- * @brief      Sets the packet length in SX1276.
+ * @brief      Applies the radio settings requested for the armed packet.
  * 
- * @details    The function sets the expected payload length (used in implicit header mode).
+ * @details    The configured settings are saved in 'm_TxRadio' and the frequency, SF, BW, CR
+ *             and power level of 'pParams' are written in SX1276 registers ('NONE' values
+ *             keep the configured setting).\n
+ *             The configured settings are restored by 'CSX1276_restoreTxRadio'.\n
+ *             The SX1276 must be in 'STANDBY' mode before calling this function.
  *
  * @param      this
  *             The pointer to CSX1276 object.
- *
- * @param      PacketLength
- *             The payload length to set in SX1276 registry.
- *
- * @return     The function returns one of the following a result codes:
- *              - LORATRANSCEIVERITF_RESULT_SUCCESS = the packet length is set in SX1276/
- *              - LORATRANSCEIVERITF_RESULT_ERROR = error during configuration
- *              - LORATRANSCEIVERITF_RESULT_INVALIDSTATE = function called on invalid state
+ *  
+ * @param      pParams
+ *             The radio settings of the packet to arm.
+ *  
+ * @return     The function returns 'LORATRANSCEIVERITF_RESULT_SUCCESS' if the settings are
+ *             applied or 'LORATRANSCEIVERITF_RESULT_INVALIDPARAMS' if one setting is not
+ *             supported (i.e. configured settings kept).
 *********************************************************************************************/
-uint8_t CSX1276_setPacketLength(CSX1276 *this, uint8_t PacketLength)
+uint8_t CSX1276_setTxRadio(CSX1276 *this, CLoraTransceiverItf_ArmSendParams pParams)
 {
-  BYTE st0;
-  BYTE value = 0x00;
-  uint8_t resultCode = LORATRANSCEIVERITF_RESULT_ERROR;
-  register spi_device_handle_t SPIDeviceHandle = this->m_SpiDeviceHandle;
-
-  #if (SX1276_DEBUG_LEVEL0)
-    DEBUG_PRINT_CR;
-    DEBUG_PRINT_LN("Starting 'CSX1276_setPacketLength'");
-  #endif
-
-  if (this->m_usModemMode != MODEM_MODE_LORA)
-  { 
-    // LoRa mode must be set before calling this function
+  DWORD dwFreqRegValue;
+  DWORD dwSymbolTime;
+  BYTE usFreqChannel;
+  BYTE usSpreadingFactor;
+  BYTE usBandwidth;
+  BYTE usCodingRate;
+  BYTE usConfig;
+
+  // Settings equal to configured settings ignored (i.e. no register written for a packet sent
+  // with the radio settings of the transceiver)
+  usFreqChannel = pParams->m_usFreqChannel != this->m_usFreqChannel ? pParams->m_usFreqChannel : LORATRANSCEIVERITF_FREQUENCY_CHANNEL_NONE;
+  usSpreadingFactor = pParams->m_usSpreadingFactor != this->m_usSpreadingFactor ? pParams->m_usSpreadingFactor : LORATRANSCEIVERITF_SF_NONE;
+  usBandwidth = pParams->m_usBandwidth != this->m_usBandwidth ? pParams->m_usBandwidth : LORATRANSCEIVERITF_BANDWIDTH_NONE;
+  usCodingRate = pParams->m_usCodingRate != this->m_usCodingRate ? pParams->m_usCodingRate : LORATRANSCEIVERITF_CR_NONE;
+
+  if ((usFreqChannel == LORATRANSCEIVERITF_FREQUENCY_CHANNEL_NONE) && (usSpreadingFactor == LORATRANSCEIVERITF_SF_NONE) &&
+      (usBandwidth == LORATRANSCEIVERITF_BANDWIDTH_NONE) && (usCodingRate == LORATRANSCEIVERITF_CR_NONE) &&
+      (pParams->m_usPowerLevel == LORATRANSCEIVERITF_POWER_LEVEL_NONE))
+  {
+    return LORATRANSCEIVERITF_RESULT_SUCCESS;
+  }
+
+  // SF6 excluded (i.e. implicit header only), maximum power 14dBm (see 'CSX1276_setPowerLevel')
+  if (((usFreqChannel != LORATRANSCEIVERITF_FREQUENCY_CHANNEL_NONE) && (CSX1276_isChannel(usFreqChannel) == false)) ||
+      ((usSpreadingFactor != LORATRANSCEIVERITF_SF_NONE) && 
+       ((usSpreadingFactor < LORATRANSCEIVERITF_SF_7) || (usSpreadingFactor > LORATRANSCEIVERITF_SF_12))) ||
+      ((usBandwidth != LORATRANSCEIVERITF_BANDWIDTH_NONE) && (CSX1276_isBW(usBandwidth) == false)) ||
+      ((usCodingRate != LORATRANSCEIVERITF_CR_NONE) && (CSX1276_isCR(usCodingRate) == false)) ||
+      ((pParams->m_usPowerLevel != LORATRANSCEIVERITF_POWER_LEVEL_NONE) && (pParams->m_usPowerLevel > LORATRANSCEIVERITF_POWER_LEVEL_MAX)))
+  {
     #if (SX1276_DEBUG_LEVEL0)
-      DEBUG_PRINT_LN("[ERROR] LoRa mode must be configured before calling function");
-      DEBUG_PRINT_CR;
+      DEBUG_PRINT_LN("[ERROR] CSX1276_setTxRadio - Radio settings not supported");
     #endif
-    return LORATRANSCEIVERITF_RESULT_INVALIDSTATE;
+    return LORATRANSCEIVERITF_RESULT_INVALIDPARAMS;
   }
 
-  // Save the current OP mode
-  st0 = CSX1276_readRegister(SPIDeviceHandle, REG_OP_MODE);  
-  
+  // Configured settings saved (i.e. restored when the packet is sent or cancelled)
+  this->m_TxRadio.m_usSavedRegs[0] = CSX1276_readRegister(this, REG_FRF_MSB);
+  this->m_TxRadio.m_usSavedRegs[1] = CSX1276_readRegister(this, REG_FRF_MID);
+  this->m_TxRadio.m_usSavedRegs[2] = CSX1276_readRegister(this, REG_FRF_LSB);
+  this->m_TxRadio.m_usSavedRegs[3] = CSX1276_readRegister(this, REG_MODEM_CONFIG1);
+  this->m_TxRadio.m_usSavedRegs[4] = CSX1276_readRegister(this, REG_MODEM_CONFIG2);
+  this->m_TxRadio.m_usSavedRegs[5] = CSX1276_readRegister(this, REG_MODEM_CONFIG3);
+  this->m_TxRadio.m_usSavedRegs[6] = CSX1276_readRegister(this, REG_PA_CONFIG);
+  this->m_TxRadio.m_bActive = true;
 
-  // Set LoRa Standby mode to write in registers
-  if (st0 != LORA_STANDBY_MODE)
+  if (usFreqChannel != LORATRANSCEIVERITF_FREQUENCY_CHANNEL_NONE)
   {
-    CSX1276_writeRegister(SPIDeviceHandle, REG_OP_MODE, LORA_STANDBY_MODE);    
+    dwFreqRegValue = CSX1276_getFreqRegValue(usFreqChannel);
+    CSX1276_writeRegister(this, REG_FRF_MSB, (BYTE) ((dwFreqRegValue >> 16) & 0xFF));
+    CSX1276_writeRegister(this, REG_FRF_MID, (BYTE) ((dwFreqRegValue >> 8) & 0xFF));
+    CSX1276_writeRegister(this, REG_FRF_LSB, (BYTE) (dwFreqRegValue & 0xFF));
   }
 
-  // Set packet length in register
-  CSX1276_writeRegister(SPIDeviceHandle, REG_PAYLOAD_LENGTH_LORA, PacketLength);
+  // BW in bits 7-4 and CR in bits 3-1 of 'REG_MODEM_CONFIG1' (i.e. register values are the
+  // 'LORATRANSCEIVERITF_BANDWIDTH_xxx' and 'LORATRANSCEIVERITF_CR_x' values)
+  if ((usBandwidth != LORATRANSCEIVERITF_BANDWIDTH_NONE) || (usCodingRate != LORATRANSCEIVERITF_CR_NONE))
+  {
+    usConfig = this->m_TxRadio.m_usSavedRegs[3];
+    usConfig = usBandwidth != LORATRANSCEIVERITF_BANDWIDTH_NONE ? ((usConfig & 0x0F) | (usBandwidth << 4)) : usConfig;
+    usConfig = usCodingRate != LORATRANSCEIVERITF_CR_NONE ? ((usConfig & 0xF1) | (usCodingRate << 1)) : usConfig;
+    CSX1276_writeRegister(this, REG_MODEM_CONFIG1, usConfig);
+  }
 
-  // Check length in register
-  value = CSX1276_readRegister(SPIDeviceHandle, REG_PAYLOAD_LENGTH_LORA);
+  // SF in bits 7-4 of 'REG_MODEM_CONFIG2'
+  if (usSpreadingFactor != LORATRANSCEIVERITF_SF_NONE)
+  {
+    CSX1276_writeRegister(this, REG_MODEM_CONFIG2, (this->m_TxRadio.m_usSavedRegs[4] & 0x0F) | (usSpreadingFactor << 4));
+  }
 
-  if (PacketLength == value)
+  // LowDataRateOptimize for symbols of 16 ms or more (i.e. same rule as 'CSX1276_scanSetRadio')
+  if ((usSpreadingFactor != LORATRANSCEIVERITF_SF_NONE) || (usBandwidth != LORATRANSCEIVERITF_BANDWIDTH_NONE))
   {
-//    this->m_pPacketSent->length = PacketLength;
-    resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
-    #if (SX1276_DEBUG_LEVEL0)
-      DEBUG_PRINT("[INFO] Packet length ");
-      DEBUG_PRINT_DEC(PacketLength);
-      DEBUG_PRINT_LN(" has been successfully set");
-      DEBUG_PRINT_CR;
-    #endif
+    usSpreadingFactor = usSpreadingFactor != LORATRANSCEIVERITF_SF_NONE ? usSpreadingFactor : this->m_usSpreadingFactor;
+    usBandwidth = usBandwidth != LORATRANSCEIVERITF_BANDWIDTH_NONE ? usBandwidth : this->m_usBandwidth;
+    dwSymbolTime = CSX1276_isBW(usBandwidth) == true ? 
+                   (((DWORD) 1 << usSpreadingFactor) * 1000) / ((DWORD) 125 << (usBandwidth - LORATRANSCEIVERITF_BANDWIDTH_125)) : 0;
+    usConfig = this->m_TxRadio.m_usSavedRegs[5];
+    usConfig = dwSymbolTime >= 16000 ? (usConfig | 0b00001000) : (usConfig & 0b11110111);
+    CSX1276_writeRegister(this, REG_MODEM_CONFIG3, usConfig);
   }
-  else
+
+  // Output power in bits 3-0 of 'REG_PA_CONFIG' (i.e. PaSelect and MaxPower of configured power
+  // mode kept)
+  if (pParams->m_usPowerLevel != LORATRANSCEIVERITF_POWER_LEVEL_NONE)
   {
-    resultCode = LORATRANSCEIVERITF_RESULT_ERROR;
-    #if (SX1276_DEBUG_LEVEL0)
-      DEBUG_PRINT_LN("[ERROR] Failed to set packet length in SX1276");
-      DEBUG_PRINT_CR;
-    #endif
+    CSX1276_writeRegister(this, REG_PA_CONFIG, (this->m_TxRadio.m_usSavedRegs[6] & 0xF0) | pParams->m_usPowerLevel);
   }
 
-  // Restore to previous OP mode
-  if (st0 != LORA_STANDBY_MODE)
+  return LORATRANSCEIVERITF_RESULT_SUCCESS;
+}
+
+
+// Restores the configured radio settings after the transmission of the armed packet
+// Note: The SX1276 is set in 'STANDBY' mode if the settings of armed packet are active (i.e. the
+//       function does nothing otherwise)
+void CSX1276_restoreTxRadio(CSX1276 *this)
+{
+  if (this->m_TxRadio.m_bActive == false)
   {
-    CSX1276_writeRegister(SPIDeviceHandle, REG_OP_MODE, st0);  
+    return;
   }
+  this->m_TxRadio.m_bActive = false;
 
-  // To Check => removed !!!
-//vTaskDelay(pdMS_TO_TICKS(250));
+  if (CSX1276_readRegister(this, REG_OP_MODE) != LORA_STANDBY_MODE)
+  {
+    CSX1276_writeRegister(this, REG_OP_MODE, LORA_STANDBY_MODE);
+  }
 
-  return resultCode;
+  CSX1276_writeRegister(this, REG_FRF_MSB, this->m_TxRadio.m_usSavedRegs[0]);
+  CSX1276_writeRegister(this, REG_FRF_MID, this->m_TxRadio.m_usSavedRegs[1]);
+  CSX1276_writeRegister(this, REG_FRF_LSB, this->m_TxRadio.m_usSavedRegs[2]);
+  CSX1276_writeRegister(this, REG_MODEM_CONFIG1, this->m_TxRadio.m_usSavedRegs[3]);
+  CSX1276_writeRegister(this, REG_MODEM_CONFIG2, this->m_TxRadio.m_usSavedRegs[4]);
+  CSX1276_writeRegister(this, REG_MODEM_CONFIG3, this->m_TxRadio.m_usSavedRegs[5]);
+  CSX1276_writeRegister(this, REG_PA_CONFIG, this->m_TxRadio.m_usSavedRegs[6]);
 }
 
+
 /*********************************************************************************************
   Private methods (implementation)
 
-  SX1276 packet receive and send operations.
-
-  These functions are invoked by the main automaton (interface commands or notifications
-  from ISR).
+  Scanner mode
+
+  Channel activity detection (CAD) is cycled on the channel/SF pairs of the scan list:
+   - The next channel is the one with the earliest revisit time (i.e. last CAD + revisit 
+     interval)
+   - The revisit interval of a channel is its window (i.e. preamble still long enough to receive
+     the packet when the CAD ends) if the time budget allows to revisit all channels in time
+   - Otherwise, the time is shared between channels according to their weight (i.e. adaptive
+     dwell schedule gives more CAD to channels where packets are received)
+   - When activity is detected, the SX1276 receives on the channel until 'RxDone' IRQ or lock
+     timeout
 *********************************************************************************************/
 
-
 /*****************************************************************************************//**
- * @fn         uint8_t CSX1276_startStandBy(CSX1276 *this)
+ * @fn         uint8_t CSX1276_startScan(CSX1276 *this, CLoraTransceiverItf_ScanParams pParams)
  * 
- * @brief      Starts the standby mode in SX1276.
+ * @brief      Prepares the scanner mode.
  * 
- * @details    The function sets the SX1276 modem in standby mode.\n
- *             The device radio activity is stopped and LoRa packets are not received and 
- *             cannot be sent until the modem mode is explicitly changed (i.e. by invoking
- *             'CSX1276_startReceive' or 'CSX1276_startSent' method.\n
- *             The hardware interrupt request handlers for 'RX_DONE' and 'TX_DONE' interrupts
- *             are disabled.
+ * @details    The function checks the scan list and computes the time budget of each channel/SF
+ *             pair.\n
+ *             The first CAD is started by 'CSX1276_scanHop' when the automaton is in 
+ *             'RECEIVING' state.
  *
  * @param      this
  *             The pointer to CSX1276 object.
- *  
- * @return     The function returns 'LORATRANSCEIVERITF_RESULT_SUCCESS' if the device is
- *             in standby mode or 'LORATRANSCEIVERITF_RESULT_ERROR' in case of error.
+ *
+ * @param      pParams
+ *             The scan list. See 'LoraTransceiverItf.h' for details.    
+ *
+ * @return     The function returns one of the following a result codes:
+ *              - LORATRANSCEIVERITF_RESULT_SUCCESS = the scanner mode is ready
+ *              - LORATRANSCEIVERITF_RESULT_INVALIDPARAMS = invalid channel or SF in scan list,
+ *                or LoRa preamble too short for CAD
+ *
+ * @note       The scores of adaptive dwell schedule are kept if the scan list is unchanged
+ *             (i.e. typically when receive mode is restarted after a downlink packet).
 *********************************************************************************************/
-uint8_t CSX1276_startStandBy(CSX1276 *this)
+uint8_t CSX1276_startScan(CSX1276 *this, CLoraTransceiverItf_ScanParams pParams)
 {
-  BYTE usRegValue;
-  register spi_device_handle_t SPIDeviceHandle = this->m_SpiDeviceHandle;
-  
+  CSX1276ScanChannelOb *pChannel;
+  bool bSameList;
+  DWORD dwWindowSymbols;
+
   #if (SX1276_DEBUG_LEVEL0)
     DEBUG_PRINT_CR;
-    DEBUG_PRINT_LN("Starting 'CSX1276_startStandBy'");
+    DEBUG_PRINT_LN("[INFO] Starting 'CSX1276_startScan'");
   #endif
 
-  // Disable dectection of 'PACKET_RECEIVED' and 'PACKET_SENT' IRQ
-  gpio_intr_disable(PIN_NUM_RX_TX_IRQ); 
+  if ((pParams->m_usChannelNumber > LORATRANSCEIVERITF_SCAN_MAX_CHANNELS) ||
+      (this->m_wPreambleLength <= SX1276_SCAN_SYNC_SYMBOLS + SX1276_SCAN_CAD_SYMBOLS))
+  {
+    return LORATRANSCEIVERITF_RESULT_INVALIDPARAMS;
+  }
 
-  // Change modem mode in SX1276
-  CSX1276_writeRegister(SPIDeviceHandle, REG_OP_MODE, LORA_STANDBY_MODE);		
+  bSameList = (pParams->m_usChannelNumber == this->m_Scanner.m_usChannelNumber);
+  dwWindowSymbols = this->m_wPreambleLength - SX1276_SCAN_SYNC_SYMBOLS - SX1276_SCAN_CAD_SYMBOLS;
 
-  // Delay 100ms -> From libelium/CPham -> removed by FF, TO CHECK
-  //vTaskDelay(pdMS_TO_TICKS(100));
+  for (BYTE i = 0; i < pParams->m_usChannelNumber; i++)
+  {
+    // SF6 excluded (i.e. implicit header only)
+    if ((CSX1276_isChannel(pParams->m_Channels[i].m_usFreqChannel) == false) ||
+        (pParams->m_Channels[i].m_usSpreadingFactor < LORATRANSCEIVERITF_SF_7) ||
+        (pParams->m_Channels[i].m_usSpreadingFactor > LORATRANSCEIVERITF_SF_12) ||
+        (CSX1276_getSymbolTime(this, pParams->m_Channels[i].m_usSpreadingFactor) == 0))
+    {
+      #if (SX1276_DEBUG_LEVEL0)
+        DEBUG_PRINT("[ERROR] Invalid channel or SF in scan list, index: ");
+        DEBUG_PRINT_DEC(i);
+        DEBUG_PRINT_CR;
+      #endif
+      this->m_Scanner.m_usChannelNumber = 0;
+      return LORATRANSCEIVERITF_RESULT_INVALIDPARAMS;
+    }
 
-  usRegValue = CSX1276_readRegister(SPIDeviceHandle, REG_OP_MODE);		
+    pChannel = &(this->m_Scanner.m_Channels[i]);
+    if ((pChannel->m_usFreqChannel != pParams->m_Channels[i].m_usFreqChannel) ||
+        (pChannel->m_usSpreadingFactor != pParams->m_Channels[i].m_usSpreadingFactor))
+    {
+      bSameList = false;
+    }
 
-  if (usRegValue != LORA_STANDBY_MODE)
-  {
-    #if (SX1276_DEBUG_LEVEL0)
-      DEBUG_PRINT_LN("[ERROR] Failed to set STANDBY mode in SX1276");
-    #endif
-    return LORATRANSCEIVERITF_RESULT_ERROR;
+    pChannel->m_usFreqChannel = pParams->m_Channels[i].m_usFreqChannel;
+    pChannel->m_usSpreadingFactor = pParams->m_Channels[i].m_usSpreadingFactor;
+    pChannel->m_dwSymbolTime = CSX1276_getSymbolTime(this, pChannel->m_usSpreadingFactor);
+    pChannel->m_dwCadTime = SX1276_SCAN_CAD_SYMBOLS * pChannel->m_dwSymbolTime;
+    pChannel->m_dwWindow = dwWindowSymbols * pChannel->m_dwSymbolTime;
+    pChannel->m_qwLastVisit = 0;
   }
 
-  #if (SX1276_DEBUG_LEVEL0)
-    DEBUG_PRINT_LN("[INFO] StandBy mode successfully started in SX1276");
-  #endif
+  this->m_Scanner.m_usChannelNumber = pParams->m_usChannelNumber;
+  this->m_Scanner.m_bAdaptiveDwell = pParams->m_bAdaptiveDwell;
+  this->m_Scanner.m_dwHopTime = (pParams->m_wHopTime != LORATRANSCEIVERITF_SCAN_HOP_TIME_NONE) ? 
+                                pParams->m_wHopTime : SX1276_SCAN_HOP_TIME;
+  this->m_Scanner.m_usCurrent = pParams->m_usChannelNumber - 1;
 
-  return LORATRANSCEIVERITF_RESULT_SUCCESS;
-}
+  // Statistics provided by owner object (cumulated) or internal statistics
+  if (pParams->m_pStatistics != NULL)
+  {
+    this->m_Scanner.m_pStatistics = pParams->m_pStatistics;
+  }
+  else
+  {
+    this->m_Scanner.m_pStatistics = this->m_Scanner.m_Statistics;
+    memset(this->m_Scanner.m_Statistics, 0, sizeof(this->m_Scanner.m_Statistics));
+  }
+
+  if (bSameList == false)
+  {
+    for (BYTE i = 0; i < this->m_Scanner.m_usChannelNumber; i++)
+    {
+      this->m_Scanner.m_Channels[i].m_wScore = 0;
+    }
+    this->m_Scanner.m_dwCadNumber = 0;
+  }
+  CSX1276_scanUpdateSchedule(this);
 
-/*****************************************************************************************//**
- * @fn         uint8_t CSX1276_startReceive(CSX1276 *this)
- * 
- * @brief      Starts the receive mode in SX1276.
- * 
- * @details    The function sets the SX1276 in receive mode.\n
- *             If a LoRa packet is received, it stored in the SX1276 FIFO.\n
- *             The device is configured to accept a paylod of 'LORA_MAX_PAYLOAD_LENGTH' bytes.\n
- *             When the packet is received, a hardware 'RX_DONE' interrupt request is generated.
- *             The function enables the reception of this interrupt on corresponding GPIO of
- *             ESP32 device (i.e. 'PIN_NUM_RX_TX_IRQ').
- *
- * @param      this
- *             The pointer to CSX1276 object.
- *  
- * @return     The function returns 'LORATRANSCEIVERITF_RESULT_SUCCESS' if the device is
- *             in receiving mode or 'LORATRANSCEIVERITF_RESULT_ERROR' in case of error.
- *
- * @note       The SX1276 'RX_DONE' pin must be connected to 'PIN_NUM_RX_TX_IRQ' pin on ESP32.
-*********************************************************************************************/
-uint8_t CSX1276_startReceive(CSX1276 *this)
-{
-  uint8_t resultCode = LORATRANSCEIVERITF_RESULT_ERROR;
-  register spi_device_handle_t SPIDeviceHandle = this->m_SpiDeviceHandle;
-  
   #if (SX1276_DEBUG_LEVEL0)
+    DEBUG_PRINT("[INFO] Scanner time budget load (per mille): ");
+    DEBUG_PRINT_DEC(this->m_Scanner.m_dwLoad);
     DEBUG_PRINT_CR;
-    DEBUG_PRINT_LN("Starting 'CSX1276_startReceive'");
+    if (this->m_Scanner.m_dwLoad > 1000)
+    {
+      DEBUG_PRINT_LN("[WARNING] Channels cannot be revisited before end of preamble, adaptive dwell used");
+    }
   #endif
 
-  // Clear m_pPacketReceived struct
-  memset(this->m_pPacketReceived, 0x00, sizeof(CLoraPacket));  
-
-  // Set Testmode
-  CSX1276_writeRegister(SPIDeviceHandle, 0x31, 0x43);
-
-  // Set LowPnTxPllOff 
-  CSX1276_writeRegister(SPIDeviceHandle, REG_PA_RAMP, 0x09);
-
-  // Set LNA gain: Highest gain. LnaBoost:Improved sensitivity
-  CSX1276_writeRegister(SPIDeviceHandle, REG_LNA, 0x23);
-
-  // Setting address pointer in FIFO data buffer    
-  CSX1276_writeRegister(SPIDeviceHandle, REG_FIFO_ADDR_PTR, 0x00);   
-
-  // Change RegSymbTimeoutLsb 
-  CSX1276_writeRegister(SPIDeviceHandle, REG_SYMB_TIMEOUT_LSB, 0xFF);
-
-  // Set current value of reception buffer pointer
-  CSX1276_writeRegister(SPIDeviceHandle, REG_FIFO_RX_BYTE_ADDR, 0x00); 
-  
-  // Set packet length in order to get all packets with length <= LORA_MAX_PAYLOAD_LENGTH  
-  if ((resultCode = CSX1276_setPacketLength(this, LORA_MAX_PAYLOAD_LENGTH)) == LORATRANSCEIVERITF_RESULT_SUCCESS)
-  {
-    CSX1276_clearFlags(this); 
-
-    // Set SX1276 DIO0 for RX_DONE IRQ (bits 6-7)
-    CSX1276_writeRegister(SPIDeviceHandle, REG_DIO_MAPPING1, 0b00000000);     
+  // Configured channel and SF saved (i.e. restored at end of scanner mode)
+  this->m_Scanner.m_usSavedRegs[0] = CSX1276_readRegister(this, REG_FRF_MSB);
+  this->m_Scanner.m_usSavedRegs[1] = CSX1276_readRegister(this, REG_FRF_MID);
+  this->m_Scanner.m_usSavedRegs[2] = CSX1276_readRegister(this, REG_FRF_LSB);
+  this->m_Scanner.m_usSavedRegs[3] = CSX1276_readRegister(this, REG_MODEM_CONFIG2);
+  this->m_Scanner.m_usSavedRegs[4] = CSX1276_readRegister(this, REG_MODEM_CONFIG3);
 
-    // Enable 'PACKET_RECEIVED' IRQ detection (on ESP32)
-    gpio_intr_enable(PIN_NUM_RX_TX_IRQ); 
+  this->m_Scanner.m_usPhase = SX1276_SCAN_PHASE_CAD;
+  return LORATRANSCEIVERITF_RESULT_SUCCESS;
+}
 
-    // Set LORA mode - Rx
-    CSX1276_writeRegister(SPIDeviceHandle, REG_OP_MODE, LORA_RX_MODE);     
 
-    #if (SX1276_DEBUG_LEVEL0)
-      DEBUG_PRINT_LN("[INFO] Receiving mode successfully started in SX1276");
-    #endif
+/*****************************************************************************************//**
+ * @fn         void CSX1276_stopScan(CSX1276 *this)
+ * 
+ * @brief      Terminates the scanner mode.
+ * 
+ * @details    The SX1276 is set in standby mode with the configured channel and SF (i.e.
+ *             settings of 'SetFreqChannel' and 'SetLoraMode' commands).\n
+ *             The function does nothing if the scanner mode is not active.
+ *
+ * @param      this
+ *             The pointer to CSX1276 object.
+ *
+ * @return     None.
+*********************************************************************************************/
+void CSX1276_stopScan(CSX1276 *this)
+{
+  if (this->m_Scanner.m_usPhase == SX1276_SCAN_PHASE_OFF)
+  {
+    return;
   }
-  else
+
+  // IRQ not notified as 'CadDone' anymore
+  this->m_Scanner.m_usPhase = SX1276_SCAN_PHASE_OFF;
+  gpio_intr_disable(this->m_nPinIrq); 
+
+  if (CSX1276_readRegister(this, REG_OP_MODE) != LORA_STANDBY_MODE)
   {
-    #if (SX1276_DEBUG_LEVEL0)
-      DEBUG_PRINT_LN("[ERROR] Failed to start receiving mode in SX1276");
-    #endif
+    CSX1276_writeRegister(this, REG_OP_MODE, LORA_STANDBY_MODE);
   }
-  return resultCode;
+
+  CSX1276_writeRegister(this, REG_FRF_MSB, this->m_Scanner.m_usSavedRegs[0]);
+  CSX1276_writeRegister(this, REG_FRF_MID, this->m_Scanner.m_usSavedRegs[1]);
+  CSX1276_writeRegister(this, REG_FRF_LSB, this->m_Scanner.m_usSavedRegs[2]);
+  CSX1276_writeRegister(this, REG_MODEM_CONFIG2, this->m_Scanner.m_usSavedRegs[3]);
+  CSX1276_writeRegister(this, REG_MODEM_CONFIG3, this->m_Scanner.m_usSavedRegs[4]);
+
+  strcpy((char *) this->m_ReceivedPacketInfo.m_szFrequency, CSX1276_getFreqTextValue(this->m_usFreqChannel));
+  CSX1276_setDataRateText(this, this->m_usSpreadingFactor);
+
+  #if (SX1276_DEBUG_LEVEL0)
+    DEBUG_PRINT_LN("[INFO] Scanner mode terminated");
+  #endif
 }
 
+
 /*****************************************************************************************//**
- * @fn         uint8_t CSX1276_getPacket(CSX1276 *this)
+ * @fn         void CSX1276_scanHop(CSX1276 *this)
  * 
- * @brief      Transfers received packet from SX1276 to CSX1276 object.
+ * @brief      Starts the CAD on next channel of scanner mode.
  * 
- * @details    The function reads the received packet bytes in SX1276 FIFO and copies them in
- *             'm_pPacketReceived' member variable of CSX1276 object.
+ * @details    The next channel is selected by 'CSX1276_scanSelectChannel'. The channel and SF
+ *             are changed in 'StandBy' mode and the 'CadDone' IRQ is mapped on DIO0.\n
+ *             The scores of adaptive dwell schedule are periodically halved (i.e. recent 
+ *             activity favoured).
  *
  * @param      this
  *             The pointer to CSX1276 object.
- *  
- * @return     The function returns 'LORATRANSCEIVERITF_RESULT_SUCCESS' if bytes are transfered
- *             in CSX1276 object or 'LORATRANSCEIVERITF_RESULT_ERROR' in case of error.
  *
- * @note       On exit, the function clears flag register of SX1276 are sets FIFO base pointer
- *             to 0x00.
+ * @return     None.
 *********************************************************************************************/
-uint8_t CSX1276_getPacket(CSX1276 *this)
+void CSX1276_scanHop(CSX1276 *this)
 {
-  uint8_t resultCode;
-  BYTE value;
-  BYTE usReceivedBytesNum;
-  struct timeval tmNow; 
-  bool bPacketReceived = false;
-  register spi_device_handle_t SPIDeviceHandle = this->m_SpiDeviceHandle;
+  CSX1276ScanChannelOb *pChannel;
+  QWORD qwNow;
 
-  #if (SX1276_DEBUG_LEVEL0)
-    DEBUG_PRINT_CR;
-    DEBUG_PRINT_LN("[INFO] Starting 'CSX1276_getPacket'");
-  #endif
+  this->m_Scanner.m_usCurrent = CSX1276_scanSelectChannel(this);
+  pChannel = &(this->m_Scanner.m_Channels[this->m_Scanner.m_usCurrent]);
 
-  // Debug -> duration
-  //previous = xTaskGetTickCount();
-  
-  // Check if 'RxDone' is true and 'PayloadCrcError' is correct
-  value = CSX1276_readRegister(SPIDeviceHandle, REG_IRQ_FLAGS);
-  if ((bitRead(value, 6) == 1) && (bitRead(value, 5) == 0))
-  { 
-    // Packet received and CRC correct
-    bPacketReceived = true;
-    #if (SX1276_DEBUG_LEVEL0)
-      DEBUG_PRINT_LN("[INFO] Packet properly received");
-    #endif
-  }
-  else
+  qwNow = GATEWAY_CLOCK_MICROSEC();
+  this->m_Scanner.m_qwHopStart = qwNow;
+  pChannel->m_qwLastVisit = qwNow;
+
+  // Next IRQ is 'CadDone'
+  this->m_Scanner.m_usPhase = SX1276_SCAN_PHASE_CAD;
+
+  // Channel and SF changed in 'StandBy' mode (i.e. SX1276 already in 'StandBy' at end of CAD)
+  if (CSX1276_readRegister(this, REG_OP_MODE) != LORA_STANDBY_MODE)
   {
-    // NOTE: Should never reach this point with HW IRQ for 'RxDone'
+    CSX1276_writeRegister(this, REG_OP_MODE, LORA_STANDBY_MODE);
+  }
+  CSX1276_scanSetRadio(this, pChannel->m_usFreqChannel, pChannel->m_usSpreadingFactor);
 
-    if (bitRead(value, 6) != 1)
-    { 
-      #if (SX1276_DEBUG_LEVEL0)
-        DEBUG_PRINT_LN("[ERROR] NOT 'RxDone' flag");
-      #endif
-    }
-    
-    if (this->m_usCRC != SX1276_CRC_ON)
-    { 
-      #if (SX1276_DEBUG_LEVEL0)
-        DEBUG_PRINT_LN("[ERROR] NOT 'CRC_ON' enabled");
-      #endif
-    }
-    
-    if ((bitRead(value, 5) == 0) && (this->m_usCRC == SX1276_CRC_ON))
-    { 
-      // CRC is correct
-      #if (SX1276_DEBUG_LEVEL0)
-        DEBUG_PRINT_LN("[INFO] The CRC is correct");
-      #endif
-    }
-    else
-    { 
-      // CRC incorrect
-      #if (SX1276_DEBUG_LEVEL0)
-        DEBUG_PRINT_LN("[ERROR] The CRC is incorrect");
-      #endif
-    }
-  }     
-  
-  // Transfer packet from SX1276 to 'm_pPacketReceived' object if properly received
-  if (bPacketReceived == true)
-  { 
-    CLoraPacket *pPacketReceived = this->m_pPacketReceived;
-    
-    // Check if 'm_pPacketReceived' is available for receiving data
-    // (i.e. owner object must read previous received packet before receiving another packet)
-    if (pPacketReceived->m_dwDataSize != 0)
-    {
-      // Wait a bit (but not too much)
-      #if (SX1276_DEBUG_LEVEL0)
-        DEBUG_PRINT_LN("[WARNING] Previous packet still in buffer");
-      #endif
+  // Set SX1276 DIO0 for CAD_DONE IRQ (bits 6-7) and start CAD
+  // Note: Dirty registers written before 'REG_OP_MODE' (i.e. see register shadow)
+  CSX1276_writeRegister(this, REG_DIO_MAPPING1, 0b10000000);
+  CSX1276_writeRegister(this, REG_OP_MODE, LORA_CAD_MODE);
 
-      vTaskDelay(pdMS_TO_TICKS(10));
-    }
-    
-    if (pPacketReceived->m_dwDataSize != 0)
-    {
-      // Miss this packet
-      ++this->m_dwMissedPacketReceivedNumber;
-      resultCode = LORATRANSCEIVERITF_RESULT_ERROR;
+  ++this->m_Scanner.m_pStatistics[this->m_Scanner.m_usCurrent].m_dwCadNumber;
 
-      #if (SX1276_DEBUG_LEVEL0)
-        DEBUG_PRINT("[ERROR] Previous packet still in buffer, total missed: ");
-        DEBUG_PRINT_DEC(this->m_dwMissedPacketReceivedNumber);
-        DEBUG_PRINT_CR;
-      #endif
-    }
-    else
+  if (++this->m_Scanner.m_dwCadNumber >= SX1276_SCAN_DECAY_CAD)
+  {
+    this->m_Scanner.m_dwCadNumber = 0;
+    for (BYTE i = 0; i < this->m_Scanner.m_usChannelNumber; i++)
     {
-      // Receive buffer available
-      pPacketReceived->m_dwTimestamp = xTaskGetTickCount() * portTICK_RATE_MS;
-      usReceivedBytesNum = CSX1276_readRegister(SPIDeviceHandle, REG_RX_NB_BYTES);
-      pPacketReceived->m_dwDataSize = (DWORD) usReceivedBytesNum;
-  
-      #if (SX1276_DEBUG_LEVEL0)
-        DEBUG_PRINT("[INFO] Received byte number: ");
-        DEBUG_PRINT_HEX(usReceivedBytesNum);
-        DEBUG_PRINT_CR;
-      #endif
-  
-      // Store the packet
-      // Set address pointer in FIFO data buffer
-      CSX1276_writeRegister(SPIDeviceHandle, REG_FIFO_ADDR_PTR, 0x00); 
-  
-      for (unsigned int i = 0; i < usReceivedBytesNum; i++)
-      {
-        pPacketReceived->m_usData[i] = CSX1276_readRegister(SPIDeviceHandle, REG_FIFO);
-      }
-     
-      // Retrieve RSSI information for received packet
-      // Note: 'm_nRSSIPacket' and 'm_nSNRPacket' member variables are updated
-      CSX1276_getRSSIpacket(this);
+      this->m_Scanner.m_Channels[i].m_wScore >>= 1;
+    }
+    CSX1276_scanUpdateSchedule(this);
+  }
+}
 
-      // Lora SNR ratio in dB (signed float, 0.1 dB precision)
-      sprintf((char *) this->m_ReceivedPacketInfo.m_szSNR, "%.1lf", (double) this->m_nSNRPacket);
 
-      //  RSSI in dBm (signed integer, 1 dB precision)
-      sprintf((char *) this->m_ReceivedPacketInfo.m_szRSSI, "%d", (int) this->m_nRSSIPacket);
-       
-      // UTC timestamp
-      gettimeofday(&tmNow, NULL); 
-      this->m_ReceivedPacketInfo.m_dwUTCSec = tmNow.tv_sec;
-      this->m_ReceivedPacketInfo.m_dwUTCMicroSec = tmNow.tv_usec;
+// Locks SX1276 in receive mode on current channel of scanner mode (activity detected)
+void CSX1276_scanLock(CSX1276 *this)
+{
+  CSX1276ScanChannelOb *pChannel = &(this->m_Scanner.m_Channels[this->m_Scanner.m_usCurrent]);
+
+  // Information of packet received on scanned channel and SF
+  strcpy((char *) this->m_ReceivedPacketInfo.m_szFrequency, CSX1276_getFreqTextValue(pChannel->m_usFreqChannel));
+  CSX1276_setDataRateText(this, pChannel->m_usSpreadingFactor);
+
+  // Next IRQ is 'RxDone' (or lock timeout if no valid header received)
+  this->m_Scanner.m_usPhase = SX1276_SCAN_PHASE_LOCKED;
+  this->m_Scanner.m_bLockExtended = false;
+  // Note: Activity detected during preamble (i.e. at most preamble without CAD remaining)
+  this->m_Scanner.m_qwLockDeadline = GATEWAY_CLOCK_MICROSEC() + 
+    (QWORD) (this->m_wPreambleLength - SX1276_SCAN_CAD_SYMBOLS + SX1276_SCAN_LOCK_SYMBOLS) * pChannel->m_dwSymbolTime;
+
+  // Set SX1276 DIO0 for RX_DONE IRQ (bits 6-7) and LORA mode - Rx
+  CSX1276_writeRegister(this, REG_DIO_MAPPING1, 0b00000000);
+  CSX1276_writeRegister(this, REG_OP_MODE, LORA_RX_MODE);
+}
 
-      // Print the packet if debug_mode
-      #if (SX1276_DEBUG_LEVEL0)
-        DEBUG_PRINT_LN("[INFO] Payload data:");
-        for (unsigned int i = 0; i < usReceivedBytesNum; i++)
-        {
-          DEBUG_PRINT_HEX(pPacketReceived->m_usData[i]);   
-          DEBUG_PRINT("|");
-        }
-        DEBUG_PRINT_CR;
-        DEBUG_PRINT_LN("## Packet end");
-      #endif
-  
-      resultCode = LORATRANSCEIVERITF_RESULT_SUCCESS;
-    }
+
+// Updates statistics and adaptive dwell schedule when a packet is received in scanner mode,
+// then starts the CAD on next channel
+void CSX1276_scanPacketReceived(CSX1276 *this, bool bReceived)
+{
+  CSX1276ScanChannelOb *pChannel = &(this->m_Scanner.m_Channels[this->m_Scanner.m_usCurrent]);
+  DWORD dwHitScore;
+
+  if (this->m_Scanner.m_usPhase != SX1276_SCAN_PHASE_LOCKED)
+  {
+    return;
   }
-  else
+
+  if (bReceived == true)
   {
-    // Packet NOT received
-    resultCode = LORATRANSCEIVERITF_RESULT_ERROR;
+    ++this->m_Scanner.m_pStatistics[this->m_Scanner.m_usCurrent].m_dwReceivedNumber;
 
-    #if (SX1276_DEBUG_LEVEL0)
-      DEBUG_PRINT_LN("[ERROR] Failed to transfer packet from SX1276");
-    #endif
+    // The hit is weighted by the inverse of channel coverage (i.e. the score estimates the
+    // traffic of the channel and not the share of time given by schedule)
+    dwHitScore = (SX1276_SCAN_HIT_SCORE * pChannel->m_dwRevisit) / pChannel->m_dwWindow;
+    pChannel->m_wScore = (pChannel->m_wScore + dwHitScore < SX1276_SCAN_MAX_SCORE) ?
+                         pChannel->m_wScore + dwHitScore : SX1276_SCAN_MAX_SCORE;
+    CSX1276_scanUpdateSchedule(this);
   }
-  
-  // Set address pointer in FIFO data buffer to 0x00 again
-  CSX1276_writeRegister(SPIDeviceHandle, REG_FIFO_ADDR_PTR, 0x00);
-  
-  // Initialize flags 
-  CSX1276_clearFlags(this); 
-  
-  return resultCode;
+
+  CSX1276_scanHop(this);
 }
 
+
 /*****************************************************************************************//**
- * @fn         uint8_t CSX1276_startSend(CSX1276 *this, CLoraTransceiverItf_LoraPacket pLoraPacket)
- * 
- * @brief      Transfers specified LoRa packet to SX1276 and starts sending it.
- * 
- * @details    The function copies LoRa packet payload bytes in SX1276 FIFO and starts to 
- *             transmit them over radio.\n
- *             The SX1276 must be in 'STANDBY' mode before calling this function.
+ * @fn         void CSX1276_scanUpdateSchedule(CSX1276 *this)
+ * 
+ * @brief      Computes the revisit interval of each channel of scanner mode.
+ * 
+ * @details    The load of the time budget is the sum of the visit cost to window ratios of
+ *             all channels (i.e. share of time required by each channel to be revisited
+ *             within its window, per mille):
+ *              - Load <= 1000 per mille: each channel is revisited within its window (i.e. 
+ *                every preamble is detected)
+ *              - Load > 1000 per mille: the time is shared according to channel weights. A
+ *                channel never gets more than its required share and the remaining time is
+ *                shared by other channels (i.e. revisit interval = cost / share)
+ *
+ *             Without adaptive dwell, all channels have the same weight.
  *
  * @param      this
  *             The pointer to CSX1276 object.
- *  
- * @param      pLoraPacket
- *             The LoRa packet to send.
- *  
- * @return     The function returns 'LORATRANSCEIVERITF_RESULT_SUCCESS' if SX1276 is sending
- *             packet or 'LORATRANSCEIVERITF_RESULT_INVALIDSTATE' if SX1276 is not in 'STANDBY'
- *             mode.
  *
- * @note       The SX1276 will trigger a 'TX_DONE' IRQ when packet is transmitted.\n
- *             When send operation terminates, the SX1276 automatically returns to 'STANDBY' 
- *             mode.
+ * @return     None.
 *********************************************************************************************/
-uint8_t CSX1276_startSend(CSX1276 *this, CLoraTransceiverItf_LoraPacket pLoraPacket)
+void CSX1276_scanUpdateSchedule(CSX1276 *this)
 {
-  register spi_device_handle_t SPIDeviceHandle = this->m_SpiDeviceHandle;
-  
-  #if (SX1276_DEBUG_LEVEL0)
-    DEBUG_PRINT_CR;
-    DEBUG_PRINT_LN("Starting 'CSX1276_startSend'");
-  #endif
+  CSX1276ScanChannelOb *pChannel;
+  DWORD dwCost[LORATRANSCEIVERITF_SCAN_MAX_CHANNELS];
+  DWORD dwShare[LORATRANSCEIVERITF_SCAN_MAX_CHANNELS];
+  DWORD dwWeight[LORATRANSCEIVERITF_SCAN_MAX_CHANNELS];
+  DWORD dwTotalWeight = 0;
+  DWORD dwCapacity = 1000;
+  DWORD dwLoad = 0;
+  bool bSaturated[LORATRANSCEIVERITF_SCAN_MAX_CHANNELS];
+  bool bChanged;
+
+  // Required share of each channel (per mille)
+  for (BYTE i = 0; i < this->m_Scanner.m_usChannelNumber; i++)
+  {
+    pChannel = &(this->m_Scanner.m_Channels[i]);
+    dwCost[i] = this->m_Scanner.m_dwHopTime + pChannel->m_dwCadTime;
+    dwShare[i] = ((dwCost[i] * 1000) + pChannel->m_dwWindow - 1) / pChannel->m_dwWindow;
+    dwLoad += dwShare[i];
+
+    dwWeight[i] = (this->m_Scanner.m_bAdaptiveDwell == true) ? SX1276_SCAN_HIT_SCORE + pChannel->m_wScore : 1;
+    dwTotalWeight += dwWeight[i];
+    bSaturated[i] = false;
+    this->m_Scanner.m_pStatistics[i].m_wWeight = (WORD) dwWeight[i];
+  }
+  this->m_Scanner.m_dwLoad = dwLoad;
+
+  // Channels requiring less than their weighted share get their required share, the remaining
+  // time is shared again by other channels (i.e. until no more channel is satisfied)
+  do
+  {
+    bChanged = false;
+    for (BYTE i = 0; i < this->m_Scanner.m_usChannelNumber; i++)
+    {
+      if ((bSaturated[i] == false) && (dwShare[i] * dwTotalWeight <= dwCapacity * dwWeight[i]))
+      {
+        bSaturated[i] = true;
+        dwCapacity -= dwShare[i];
+        dwTotalWeight -= dwWeight[i];
+        bChanged = true;
+      }
+    }
+  } while (bChanged == true);
 
-  // The SX1276 must be in 'STANDBY' mode
-  if (CSX1276_readRegister(SPIDeviceHandle, REG_OP_MODE) != LORA_STANDBY_MODE)
+  for (BYTE i = 0; i < this->m_Scanner.m_usChannelNumber; i++)
   {
-    #if (SX1276_DEBUG_LEVEL0)
-      DEBUG_PRINT_LN("[ERROR] SX1276 not in 'STANDBY' mode");
-    #endif
-
-    return LORATRANSCEIVERITF_RESULT_INVALIDSTATE;
+    pChannel = &(this->m_Scanner.m_Channels[i]);
+    if (bSaturated[i] == true)
+    {
+      pChannel->m_dwRevisit = pChannel->m_dwWindow;
+    }
+    else
+    {
+      dwShare[i] = (dwCapacity * dwWeight[i]) / dwTotalWeight;
+      pChannel->m_dwRevisit = (dwCost[i] * 1000) / ((dwShare[i] != 0) ? dwShare[i] : 1);
+    }
   }
+}
 
-  // Keep pointer to packet currently sent
-  // Note: The pointed object will never been accessed outside of this function
-  //       (i.e. just a reference used for 'PACKET_SENT' event)
-  this->m_pPacketToSend = pLoraPacket;
 
-  // Write payload to send in SX1276 FIFO
-  // Set address pointer in FIFO data buffer
-  CSX1276_writeRegister(SPIDeviceHandle, REG_FIFO_TX_BASE_ADDR, 0x00);
-  CSX1276_writeRegister(SPIDeviceHandle, REG_FIFO_ADDR_PTR, 0x00);  
+// Selects the channel with the earliest revisit time (scanner mode)
+// Note: Channels with the same revisit time are selected in round robin order
+BYTE CSX1276_scanSelectChannel(CSX1276 *this)
+{
+  CSX1276ScanChannelOb *pChannel;
+  BYTE usIndex;
+  BYTE usSelected = 0;
+  QWORD qwDue;
+  QWORD qwSelectedDue = 0;
 
-  // Write bytes in FIFO
-  BYTE *pData = pLoraPacket->m_usData;
-  for (DWORD i = 0; i < pLoraPacket->m_dwDataSize; i++, pData++)
+  for (BYTE i = 0; i < this->m_Scanner.m_usChannelNumber; i++)
   {
-    CSX1276_writeRegister(SPIDeviceHandle, REG_FIFO, *pData);
-  }
+    usIndex = (this->m_Scanner.m_usCurrent + 1 + i) % this->m_Scanner.m_usChannelNumber;
+    pChannel = &(this->m_Scanner.m_Channels[usIndex]);
+    qwDue = pChannel->m_qwLastVisit + pChannel->m_dwRevisit;
 
-  #if (SX1276_DEBUG_LEVEL0)
-    DEBUG_PRINT_LN("[INFO] Packet bytes copied in FIFO");
-    DEBUG_PRINT("Bytes to send: ");
-    pData = pLoraPacket->m_usData;
-    for (DWORD i = 0; i < pLoraPacket->m_dwDataSize; i++, pData++)
+    if ((i == 0) || (qwDue < qwSelectedDue))
     {
-      DEBUG_PRINT_HEX(*pData);
-      DEBUG_PRINT("|");
+      usSelected = usIndex;
+      qwSelectedDue = qwDue;
     }
-    DEBUG_PRINT_LN("End payload bytes");
-  #endif
+  }
+  return usSelected;
+}
 
-  // Switch SX1276 to TX mode (i.e. send packet)
-  // Notes: 
-  //  - The end of send operation will be dectected by 'TX_DONE' IRQ
-  //  - When send operation terminates, the SX1276 automatically returns to 'STANDBY' mode
-  CSX1276_clearFlags(this); 
 
-  // Set SX1276 DIO0 for TX_DONE IRQ (bits 6-7)
-  CSX1276_writeRegister(SPIDeviceHandle, REG_DIO_MAPPING1, 0b01000000);     
+// Sets the channel and SF of a scanned pair (i.e. register shadow updated, written before next
+// mode change)
+// Note: LowDataRateOptimize (bit 3 of 'REG_MODEM_CONFIG3') is mandatory when symbol duration
+//       exceeds 16 ms
+void CSX1276_scanSetRadio(CSX1276 *this, BYTE usFreqChannel, BYTE usSpreadingFactor)
+{
+  DWORD dwFreqRegValue = CSX1276_getFreqRegValue(usFreqChannel);
+  BYTE usConfig2;
+  BYTE usConfig3;
 
-  // Enable 'PACKET_SENT' IRQ detection (on ESP32)
-  gpio_intr_enable(PIN_NUM_RX_TX_IRQ); 
+  CSX1276_writeRegister(this, REG_FRF_MSB, (BYTE) ((dwFreqRegValue >> 16) & 0xFF));
+  CSX1276_writeRegister(this, REG_FRF_MID, (BYTE) ((dwFreqRegValue >> 8) & 0xFF));
+  CSX1276_writeRegister(this, REG_FRF_LSB, (BYTE) (dwFreqRegValue & 0xFF));
 
-  // Start to send packet
-  CSX1276_writeRegister(SPIDeviceHandle, REG_OP_MODE, LORA_TX_MODE); 
-  
-  // Timestamp for begining of transmission
-  pLoraPacket->m_dwTimestamp = xTaskGetTickCount() * portTICK_RATE_MS;
+  // SF in bits 7-4 of 'REG_MODEM_CONFIG2'
+  usConfig2 = (CSX1276_readRegister(this, REG_MODEM_CONFIG2) & 0x0F) | (usSpreadingFactor << 4);
+  CSX1276_writeRegister(this, REG_MODEM_CONFIG2, usConfig2);
 
-  #if (SX1276_DEBUG_LEVEL0)
-    DEBUG_PRINT_LN("[INFO] The SX1276 in now sending packet");
-  #endif
+  usConfig3 = CSX1276_readRegister(this, REG_MODEM_CONFIG3);
+  if (CSX1276_getSymbolTime(this, usSpreadingFactor) >= 16000)
+  {
+    usConfig3 |= 0b00001000;
+  }
+  else
+  {
+    usConfig3 &= 0b11110111;
+  }
+  CSX1276_writeRegister(this, REG_MODEM_CONFIG3, usConfig3);
+}
 
-  return LORATRANSCEIVERITF_RESULT_SUCCESS;
+
+// Returns the maximum wait of main automaton for notifications
+// Note: In RX lock of scanner mode, the wait ends at lock timeout (at least one tick)
+TickType_t CSX1276_scanGetWaitTicks(CSX1276 *this)
+{
+  QWORD qwNow;
+  TickType_t dwTicks;
+
+  if (this->m_Scanner.m_usPhase != SX1276_SCAN_PHASE_LOCKED)
+  {
+    return pdMS_TO_TICKS(SX1276_SCAN_MAX_WAIT);
+  }
+
+  qwNow = GATEWAY_CLOCK_MICROSEC();
+  if (qwNow >= this->m_Scanner.m_qwLockDeadline)
+  {
+    return 1;
+  }
+
+  dwTicks = pdMS_TO_TICKS((DWORD) ((this->m_Scanner.m_qwLockDeadline - qwNow + 999) / 1000));
+  return (dwTicks == 0) ? 1 : dwTicks;
 }
 
+
 /*********************************************************************************************
   Private methods (implementation)
 
@@ -4688,12 +6955,28 @@ IRAM_ATTR void CSX1276_PacketRxTxIntHandler(CSX1276 *this)
 {
   BaseType_t xHigherPriorityTaskWoken = 0;
 
+  // Latch gateway clock at IRQ edge (first statement, timestamp used for LoRaWAN RX windows
+  // and Network Server 'tmst')
+  this->m_qwIrqTimestamp = GATEWAY_CLOCK_MICROSEC();
+
   // Same IRQ used for both RX_DONE and TX_DONE IRQs (i.e. software configuration of DIO
   // on SX1276 according to OP mode)
 
-  // Notify 'PacketReceived' or 'PacketSent' event to main automaton (RTOS task)
-  if (this->m_dwCurrentState == SX1276_AUTOMATON_STATE_RECEIVING)
+  // Notify 'PacketReceived', 'CadDone' or 'PacketSent' event to main automaton (RTOS task)
+  // Note: 'CadDone' also mapped on same IRQ in scanner mode (i.e. during CAD phase)
+  if ((this->m_dwCurrentState == SX1276_AUTOMATON_STATE_RECEIVING) &&
+      (this->m_Scanner.m_usPhase == SX1276_SCAN_PHASE_CAD))
+  {
+    xTaskNotifyFromISR(this->m_hAutomatonTask, SX1276_AUTOMATON_NOTIFY_CAD_DONE, eSetBits,
+                       &xHigherPriorityTaskWoken);
+  }
+  else if (this->m_dwCurrentState == SX1276_AUTOMATON_STATE_RECEIVING)
   {
+    // RX servicing has priority on shared SPI bus (see 'CSX1276_busAcquire')
+    if (!__atomic_exchange_n(&(this->m_bRxPending), true, __ATOMIC_ACQ_REL))
+    {
+      __atomic_add_fetch(&(g_SX1276SpiBusOb.m_dwRxPendingNumber), 1, __ATOMIC_RELEASE);
+    }
     xTaskNotifyFromISR(this->m_hAutomatonTask, SX1276_AUTOMATON_NOTIFY_PACKET_RECEIVED, eSetBits,
                        &xHigherPriorityTaskWoken);
   }
@@ -4706,7 +6989,11 @@ IRAM_ATTR void CSX1276_PacketRxTxIntHandler(CSX1276 *this)
   // Allow quick activation of processing task
   if (xHigherPriorityTaskWoken)
   {
-    portYIELD_FROM_ISR();
+    #ifdef ESP_PLATFORM
+      portYIELD_FROM_ISR();
+    #else
+      portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+    #endif
   }
 }
 
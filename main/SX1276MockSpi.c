@@ -0,0 +1,456 @@
+/*****************************************************************************************//**
+ * @file     SX1276MockSpi.c
+ *
+ * @author   F.Fargon
+ *
+ * @version  V1.0
+ *
+ * @date     16/10/2026
+ *
+ * @brief    Mock SX1276 device for Linux host.
+ *
+ * @details  This file implements the following classes or functions:\n
+ *            - CSX1276MockSpi = Simulated SX1276 on a simulated SPI bus (i.e. 'CSX1276SpiBackendOb'
+ *              methods used by CSX1276 driver on Linux host)
+*********************************************************************************************/
+
+
+/*********************************************************************************************
+  Espressif framework includes
+*********************************************************************************************/
+
+#include <Common.h>
+
+#ifndef ESP_PLATFORM
+
+#include <unistd.h>
+
+
+/*********************************************************************************************
+  Includes for objects implementation
+*********************************************************************************************/
+
+#include "LoraTransceiverItf.h"
+#include "SX1276MockSpi.h"
+
+
+/*********************************************************************************************
+  Instantiate global static objects used by module implementation
+*********************************************************************************************/
+
+// SPI backend methods for 'CSX1276_SetSpiBackend'
+const CSX1276SpiBackendOb g_SX1276MockSpiBackendOb = { .m_pTransmit = CSX1276MockSpi_Transmit,
+                                                       .m_pQueueTrans = CSX1276MockSpi_QueueTrans,
+                                                       .m_pGetTransResult = CSX1276MockSpi_GetTransResult
+                                                     };
+
+// Simulated SPI bus shared by all mock devices (i.e. one transfer at a time)
+static pthread_mutex_t g_hMockSpiBusMutex = PTHREAD_MUTEX_INITIALIZER;
+
+
+/*********************************************************************************************
+ SX1276MockSpi Class
+
+ Mock SX1276 device on a simulated SPI bus
+
+ Notes:
+  - See SX1276MockSpi.h for description of simulated device
+  - The queued and completed transactions are protected by 'm_hMutex'
+
+ WARNING: This object cannot be static. It MUST always be allocated by with the construction
+          method ('CSX1276MockSpi_New')
+*********************************************************************************************/
+
+// Private helpers
+static void *CSX1276MockSpi_WorkerThread(void *pParam);
+static void CSX1276MockSpi_Execute(CSX1276MockSpi this, spi_transaction_t *pTrans);
+
+
+/*********************************************************************************************
+  Public methods of CSX1276MockSpi object
+*********************************************************************************************/
+
+/*****************************************************************************************//**
+ * @fn         CSX1276MockSpi CSX1276MockSpi_New(DWORD dwTransferLatency, DWORD dwWakeupLatency)
+ *
+ * @brief      Creates a new CSX1276MockSpi object.
+ *
+ * @details    The simulated SX1276 registers have their reset value (i.e. FSK 'StandBy' mode)
+ *             and the worker thread executing the SPI transactions is started.
+ *
+ * @param      dwTransferLatency
+ *             Duration of each SPI transaction (microseconds).
+ *
+ * @param      dwWakeupLatency
+ *             Delay for a caller waiting for a transaction result (microseconds).
+ *
+ * @return     The function returns the pointer to the CSX1276MockSpi object or NULL if error.
+*********************************************************************************************/
+CSX1276MockSpi CSX1276MockSpi_New(DWORD dwTransferLatency, DWORD dwWakeupLatency)
+{
+  CSX1276MockSpi this;
+
+  if ((this = (CSX1276MockSpi) pvPortMalloc(sizeof(CSX1276MockSpiOb))) == NULL)
+  {
+    return NULL;
+  }
+
+  memset(this->m_usRegisters, 0, sizeof(this->m_usRegisters));
+  memset(this->m_usFifo, 0, sizeof(this->m_usFifo));
+  this->m_usRegisters[REG_OP_MODE] = 0x09;
+  this->m_usRegisters[REG_VERSION] = 0x12;
+
+  this->m_dwTransferLatency = dwTransferLatency;
+  this->m_dwWakeupLatency = dwWakeupLatency;
+
+  this->m_usQueuedIndex = 0;
+  this->m_usQueuedCount = 0;
+  this->m_usCompletedIndex = 0;
+  this->m_usCompletedCount = 0;
+  this->m_bTerminate = false;
+
+  this->m_pCadActivity = NULL;
+  this->m_pCadContext = NULL;
+
+  this->m_dwTransactionNumber = 0;
+  this->m_usMaxPipelineDepth = 0;
+
+  pthread_mutex_init(&this->m_hMutex, NULL);
+  pthread_cond_init(&this->m_hCondition, NULL);
+
+  if (pthread_create(&this->m_hWorkerThread, NULL, CSX1276MockSpi_WorkerThread, this) != 0)
+  {
+    pthread_cond_destroy(&this->m_hCondition);
+    pthread_mutex_destroy(&this->m_hMutex);
+    vPortFree(this);
+    return NULL;
+  }
+
+  return this;
+}
+
+
+/*****************************************************************************************//**
+ * @fn         void CSX1276MockSpi_Delete(CSX1276MockSpi this)
+ *
+ * @brief      Deletes a CSX1276MockSpi object.
+ *
+ * @details    The worker thread is terminated. The transactions still queued are not executed.
+ *
+ * @param      this
+ *             The pointer to CSX1276MockSpi object.
+ *
+ * @return     None.
+*********************************************************************************************/
+void CSX1276MockSpi_Delete(CSX1276MockSpi this)
+{
+  pthread_mutex_lock(&this->m_hMutex);
+  this->m_bTerminate = true;
+  pthread_cond_broadcast(&this->m_hCondition);
+  pthread_mutex_unlock(&this->m_hMutex);
+
+  pthread_join(this->m_hWorkerThread, NULL);
+
+  pthread_cond_destroy(&this->m_hCondition);
+  pthread_mutex_destroy(&this->m_hMutex);
+  vPortFree(this);
+}
+
+
+/*****************************************************************************************//**
+ * @fn         void CSX1276MockSpi_InjectPacket(CSX1276MockSpi this, const BYTE *pData,
+ *                                              BYTE usLength, BYTE usSnrValue, BYTE usRssiValue)
+ *
+ * @brief      Simulates the reception of a LoRa packet.
+ *
+ * @details    The payload is stored in FIFO at 'REG_FIFO_RX_BASE_ADDR' and the registers are
+ *             updated as by SX1276 on 'RxDone' (i.e. the client must simulate the DIO0 IRQ).
+ *
+ * @param      this
+ *             The pointer to CSX1276MockSpi object.
+ *
+ * @param      pData
+ *             The packet payload.
+ *
+ * @param      usLength
+ *             The payload length.
+ *
+ * @param      usSnrValue
+ *             Raw value for 'REG_PKT_SNR_VALUE' (i.e. SNR in dB x 4, two's complement).
+ *
+ * @param      usRssiValue
+ *             Raw value for 'REG_PKT_RSSI_VALUE'.
+ *
+ * @return     None.
+*********************************************************************************************/
+void CSX1276MockSpi_InjectPacket(CSX1276MockSpi this, const BYTE *pData, BYTE usLength, BYTE usSnrValue, BYTE usRssiValue)
+{
+  BYTE usAddress;
+
+  pthread_mutex_lock(&this->m_hMutex);
+
+  usAddress = this->m_usRegisters[REG_FIFO_RX_BASE_ADDR];
+  for (WORD i = 0; i < usLength; i++)
+  {
+    this->m_usFifo[usAddress++] = pData[i];
+  }
+
+  this->m_usRegisters[REG_FIFO_RX_CURRENT_ADDR] = this->m_usRegisters[REG_FIFO_RX_BASE_ADDR];
+  this->m_usRegisters[REG_RX_NB_BYTES] = usLength;
+  this->m_usRegisters[REG_PKT_SNR_VALUE] = usSnrValue;
+  this->m_usRegisters[REG_PKT_RSSI_VALUE] = usRssiValue;
+
+  // 'RxDone' and 'ValidHeader' IRQ flags
+  this->m_usRegisters[REG_IRQ_FLAGS] |= 0x50;
+
+  pthread_mutex_unlock(&this->m_hMutex);
+}
+
+
+// Sets the callback returning the channel activity for a CAD (i.e. 'REG_FRF_xxx' value and SF)
+// Note: Without callback, no activity is detected
+void CSX1276MockSpi_SetCadActivity(CSX1276MockSpi this, 
+                                   bool (*pCadActivity)(void *pContext, DWORD dwRegFreq, BYTE usSpreadingFactor),
+                                   void *pContext)
+{
+  pthread_mutex_lock(&this->m_hMutex);
+  this->m_pCadActivity = pCadActivity;
+  this->m_pCadContext = pContext;
+  pthread_mutex_unlock(&this->m_hMutex);
+}
+
+
+DWORD CSX1276MockSpi_GetTransactionNumber(CSX1276MockSpi this)
+{
+  return this->m_dwTransactionNumber;
+}
+
+
+BYTE CSX1276MockSpi_GetMaxPipelineDepth(CSX1276MockSpi this)
+{
+  return this->m_usMaxPipelineDepth;
+}
+
+
+/*********************************************************************************************
+  SPI backend methods ('CSX1276SpiBackendOb')
+*********************************************************************************************/
+
+// Blocking transaction (i.e. queued and waited for)
+esp_err_t CSX1276MockSpi_Transmit(spi_device_handle_t hDevice, spi_transaction_t *pTrans)
+{
+  spi_transaction_t *pCompletedTrans;
+  esp_err_t ret;
+
+  if ((ret = CSX1276MockSpi_QueueTrans(hDevice, pTrans, portMAX_DELAY)) != ESP_OK)
+  {
+    return ret;
+  }
+  if ((ret = CSX1276MockSpi_GetTransResult(hDevice, &pCompletedTrans, portMAX_DELAY)) != ESP_OK)
+  {
+    return ret;
+  }
+
+  // Same rule as ESP-IDF driver: no other transaction in flight
+  return pCompletedTrans == pTrans ? ESP_OK : ESP_FAIL;
+}
+
+
+// Queues a transaction (waits if maximum number of transactions in flight is reached)
+esp_err_t CSX1276MockSpi_QueueTrans(spi_device_handle_t hDevice, spi_transaction_t *pTrans, TickType_t dwTicksToWait)
+{
+  CSX1276MockSpi this = (CSX1276MockSpi) hDevice;
+  BYTE usDepth;
+
+  pthread_mutex_lock(&this->m_hMutex);
+
+  while (this->m_usQueuedCount + this->m_usCompletedCount == SX1276_SPI_QUEUE_SIZE)
+  {
+    if (dwTicksToWait == 0)
+    {
+      pthread_mutex_unlock(&this->m_hMutex);
+      return ESP_ERR_TIMEOUT;
+    }
+    pthread_cond_wait(&this->m_hCondition, &this->m_hMutex);
+  }
+
+  this->m_pQueuedTrans[(this->m_usQueuedIndex + this->m_usQueuedCount) % SX1276_SPI_QUEUE_SIZE] = pTrans;
+  ++this->m_usQueuedCount;
+
+  usDepth = this->m_usQueuedCount + this->m_usCompletedCount;
+  if (usDepth > this->m_usMaxPipelineDepth)
+  {
+    this->m_usMaxPipelineDepth = usDepth;
+  }
+
+  pthread_cond_broadcast(&this->m_hCondition);
+  pthread_mutex_unlock(&this->m_hMutex);
+  return ESP_OK;
+}
+
+
+// Collects the oldest completed transaction
+esp_err_t CSX1276MockSpi_GetTransResult(spi_device_handle_t hDevice, spi_transaction_t **ppTrans, TickType_t dwTicksToWait)
+{
+  CSX1276MockSpi this = (CSX1276MockSpi) hDevice;
+  bool bWaited = false;
+
+  pthread_mutex_lock(&this->m_hMutex);
+
+  while (this->m_usCompletedCount == 0)
+  {
+    if ((dwTicksToWait == 0) || (this->m_usQueuedCount == 0))
+    {
+      pthread_mutex_unlock(&this->m_hMutex);
+      return ESP_ERR_TIMEOUT;
+    }
+    pthread_cond_wait(&this->m_hCondition, &this->m_hMutex);
+    bWaited = true;
+  }
+
+  *ppTrans = this->m_pCompletedTrans[this->m_usCompletedIndex];
+  this->m_usCompletedIndex = (this->m_usCompletedIndex + 1) % SX1276_SPI_QUEUE_SIZE;
+  --this->m_usCompletedCount;
+
+  pthread_cond_broadcast(&this->m_hCondition);
+  pthread_mutex_unlock(&this->m_hMutex);
+
+  if (bWaited && (this->m_dwWakeupLatency != 0))
+  {
+    // Caller released by SPI driver (task switch)
+    usleep(this->m_dwWakeupLatency);
+  }
+  return ESP_OK;
+}
+
+
+/*********************************************************************************************
+  Private methods of CSX1276MockSpi object
+*********************************************************************************************/
+
+// Executes the queued transactions in order
+static void *CSX1276MockSpi_WorkerThread(void *pParam)
+{
+  CSX1276MockSpi this = (CSX1276MockSpi) pParam;
+  spi_transaction_t *pTrans;
+
+  pthread_mutex_lock(&this->m_hMutex);
+
+  while (true)
+  {
+    while ((this->m_usQueuedCount == 0) && !this->m_bTerminate)
+    {
+      pthread_cond_wait(&this->m_hCondition, &this->m_hMutex);
+    }
+    if (this->m_bTerminate)
+    {
+      break;
+    }
+
+    pTrans = this->m_pQueuedTrans[this->m_usQueuedIndex];
+    pthread_mutex_unlock(&this->m_hMutex);
+
+    // Bus transfer (shared by all mock devices)
+    pthread_mutex_lock(&g_hMockSpiBusMutex);
+    if (this->m_dwTransferLatency != 0)
+    {
+      usleep(this->m_dwTransferLatency);
+    }
+    pthread_mutex_unlock(&g_hMockSpiBusMutex);
+
+    pthread_mutex_lock(&this->m_hMutex);
+    CSX1276MockSpi_Execute(this, pTrans);
+    ++this->m_dwTransactionNumber;
+
+    this->m_usQueuedIndex = (this->m_usQueuedIndex + 1) % SX1276_SPI_QUEUE_SIZE;
+    --this->m_usQueuedCount;
+    this->m_pCompletedTrans[(this->m_usCompletedIndex + this->m_usCompletedCount) % SX1276_SPI_QUEUE_SIZE] = pTrans;
+    ++this->m_usCompletedCount;
+
+    pthread_cond_broadcast(&this->m_hCondition);
+  }
+
+  pthread_mutex_unlock(&this->m_hMutex);
+  return NULL;
+}
+
+
+// Simulated SX1276 register access (called with 'm_hMutex' locked)
+// Note: Register address is automatically incremented for each byte of a burst access (except
+//       'REG_FIFO' where the FIFO address pointer is incremented)
+static void CSX1276MockSpi_Execute(CSX1276MockSpi this, spi_transaction_t *pTrans)
+{
+  BYTE usAddress = (BYTE) (pTrans->addr & 0x7F);
+  bool bWrite = (pTrans->addr & 0x80) != 0;
+  size_t nLength = pTrans->length / 8;
+  const BYTE *pTxData;
+  BYTE *pRxData;
+  BYTE usData;
+
+  pTxData = (pTrans->flags & SPI_TRANS_USE_TXDATA) ? pTrans->tx_data : (const BYTE *) pTrans->tx_buffer;
+  pRxData = (pTrans->flags & SPI_TRANS_USE_RXDATA) ? pTrans->rx_data : (BYTE *) pTrans->rx_buffer;
+
+  for (size_t i = 0; i < nLength; i++)
+  {
+    if (usAddress == REG_FIFO)
+    {
+      if (bWrite)
+      {
+        this->m_usFifo[this->m_usRegisters[REG_FIFO_ADDR_PTR]++] = pTxData[i];
+      }
+      else
+      {
+        pRxData[i] = this->m_usFifo[this->m_usRegisters[REG_FIFO_ADDR_PTR]++];
+      }
+      continue;
+    }
+
+    if (!bWrite)
+    {
+      pRxData[i] = this->m_usRegisters[usAddress];
+    }
+    else
+    {
+      usData = pTxData[i];
+      if (usAddress == REG_IRQ_FLAGS)
+      {
+        // Flags cleared by writing 1
+        this->m_usRegisters[REG_IRQ_FLAGS] &= ~usData;
+      }
+      else if ((usAddress == REG_OP_MODE) && ((usData & 0x07) == 0x03))
+      {
+        // 'TX' mode: packet sent immediately ('TxDone') and back to 'StandBy' mode
+        this->m_usRegisters[REG_IRQ_FLAGS] |= 0x08;
+        this->m_usRegisters[REG_OP_MODE] = (usData & 0xF8) | 0x01;
+      }
+      else if ((usAddress == REG_OP_MODE) && ((usData & 0x07) == 0x07))
+      {
+        // 'CAD' mode: activity given by client callback ('CadDone' and 'CadDetected') and back 
+        // to 'StandBy' mode
+        this->m_usRegisters[REG_IRQ_FLAGS] |= 0x04;
+        if ((this->m_pCadActivity != NULL) && 
+            (this->m_pCadActivity(this->m_pCadContext,
+                                  ((DWORD) this->m_usRegisters[REG_FRF_MSB] << 16) |
+                                  ((DWORD) this->m_usRegisters[REG_FRF_MID] << 8) | 
+                                  this->m_usRegisters[REG_FRF_LSB],
+                                  this->m_usRegisters[REG_MODEM_CONFIG2] >> 4) == true))
+        {
+          this->m_usRegisters[REG_IRQ_FLAGS] |= 0x01;
+        }
+        this->m_usRegisters[REG_OP_MODE] = (usData & 0xF8) | 0x01;
+      }
+      else
+      {
+        this->m_usRegisters[usAddress] = usData;
+      }
+    }
+
+    if (usAddress < SX1276_SHADOW_SIZE - 1)
+    {
+      ++usAddress;
+    }
+  }
+}
+
+
+#endif
@@ -36,6 +36,7 @@
 #define NETWORKSERVERPROTOCOLITF_IMPL
 
 #include "NetworkServerProtocolItf.h"
+#include "TraceRing.h"
 
 // Object's definitions and methods
 #include "SemtechProtocolEngine.h"
@@ -54,7 +55,9 @@ struct _CNetworkServerProtocolItfImpl g_NetworkServerProtocolItfImplOb = { .m_pA
                                                                            .m_pReleaseItf = CSemtechProtocolEngine_ReleaseItf,
                                                                            .m_pBuildUplinkMessage = CSemtechProtocolEngine_BuildUplinkMessage,
                                                                            .m_pProcessServerMessage = CSemtechProtocolEngine_ProcessServerMessage,
-                                                                           .m_pProcessSessionEvent = CSemtechProtocolEngine_ProcessSessionEvent
+                                                                           .m_pProcessSessionEvent = CSemtechProtocolEngine_ProcessSessionEvent,
+                                                                           .m_pGetExpiredSession = CSemtechProtocolEngine_GetExpiredSession,
+                                                                           .m_pBuildDownlinkAck = CSemtechProtocolEngine_BuildDownlinkAck
                                                                          };
 
 
@@ -185,6 +188,12 @@ uint32_t CSemtechProtocolEngine_ReleaseItf(void *this)
  *                or a PULL_DATA message according to configurated periods (i.e. the period
  *                management if implemented in the 'ProtocolEngine' = owner object simply calls
  *                periodically using a comptible frequency).
+ *              - The 'ServerManager' invokes the function to append a LoRa packet to a PUSH_DATA
+ *                message previously built for LoRa data (aggregation of several LoRa packets in
+ *                the same 'rxpk' array). The packet is added to the transaction of this message.
+ *              - The 'ServerManager' invokes the function to send again a PUSH_DATA message
+ *                stored when the Network Server was unreachable. A new transaction is created
+ *                and the message header is updated (i.e. new random token).
  * 
  * @param      this
  *             The pointer to CSemtechProtocolEngine object.
@@ -201,20 +210,34 @@ uint32_t CSemtechProtocolEngine_ReleaseItf(void *this)
 bool CSemtechProtocolEngine_BuildUplinkMessage(void *this, 
                                                CNetworkServerProtocolItf_BuildUplinkMessageParams pParams)
 {
-  CMemoryBlockArrayEntryOb MemBlockArrayEntry;
+  CWideMemoryBlockArrayEntryOb MemBlockArrayEntry;
   CSemtechMessageTransaction pMessageTransaction;
   BYTE *pStreamHead;
-  BYTE pTempBuffer[40];
-  WORD wLength;
-  struct tm *tmTime;
-  CLoraTransceiverItf_ReceivedLoraPacketInfo pPacketInfo;
   TickType_t dwCurrentTicks;
   DWORD dwElapsedTicks;
   WORD wSemtechMsgType;           // SEMTECHPROTOCOLENGINE_SEMTECH_MESSAGE_PUSH_DATA
                                   // or SEMTECHPROTOCOLENGINE_SEMTECH_MESSAGE_PULL_DATA
 
+  // LoRa packet appended to a message already built (i.e. no new transaction)
+  if (pParams->m_wMessageType == NETWORKSERVERPROTOCOL_UPLINKMSG_LORADATA_APPEND)
+  {
+    return CSemtechProtocolEngine_AppendUplinkPacket((CSemtechProtocolEngine *)this, pParams);
+  }
+
+  // Replayed message must be a PUSH_DATA message previously built for LoRa packets (i.e. header and JSON object)
+  if ((pParams->m_wMessageType == NETWORKSERVERPROTOCOL_UPLINKMSG_REPLAY) &&
+      ((pParams->m_wMessageLength <= 12) || (pParams->m_wMessageLength > pParams->m_wMaxMessageLength) ||
+       (pParams->m_pMessageData[0] != SEMTECHPROTOCOLENGINE_SEMTECH_PROTOCOL_VERSION) ||
+       (pParams->m_pMessageData[3] != SEMTECHPROTOCOLENGINE_SEMTECH_MESSAGE_PUSH_DATA)))
+  {
+    #if (SEMTECHPROTOCOLENGINE_DEBUG_LEVEL0)
+      DEBUG_PRINT_LN("[ERROR] CSemtechProtocolEngine_BuildUplinkMessage- invalid replayed message");
+    #endif
+    return false;
+  }
+
   // Step 1: Obtain a memory block for the 'CSemtechMessageTransactionOb' object
-  if ((pMessageTransaction = (CSemtechMessageTransaction) CMemoryBlockArray_GetBlock
+  if ((pMessageTransaction = (CSemtechMessageTransaction) CWideMemoryBlockArray_GetBlock
       (((CSemtechProtocolEngine *)this)->m_pTransactionArray, &MemBlockArrayEntry)) == NULL)
   {
     // Should never occur. Buffer for 'CSemtechMessageTransaction' exhausted
@@ -247,7 +270,7 @@ bool CSemtechProtocolEngine_BuildUplinkMessage(void *this,
             DEBUG_PRINT_DEC(((CSemtechProtocolEngine *)this)->m_wPendingUpTransactionCount);
             DEBUG_PRINT_CR;
           #endif
-          CMemoryBlockArray_ReleaseBlock(((CSemtechProtocolEngine *)this)->m_pTransactionArray, pMessageTransaction->m_usTransactionId);
+          CWideMemoryBlockArray_ReleaseBlock(((CSemtechProtocolEngine *)this)->m_pTransactionArray, pMessageTransaction->m_wTransactionId);
           return false;
         }
         // Generate a PULL_DATA message
@@ -279,6 +302,15 @@ bool CSemtechProtocolEngine_BuildUplinkMessage(void *this,
       #endif
     }
   }
+  else if (pParams->m_wMessageType == NETWORKSERVERPROTOCOL_UPLINKMSG_REPLAY)
+  {
+    // Send again a stored PUSH_DATA message (LoRa packets already counted when message was built)
+    wSemtechMsgType = SEMTECHPROTOCOLENGINE_SEMTECH_MESSAGE_PUSH_DATA;
+
+    #if (SEMTECHPROTOCOLENGINE_DEBUG_LEVEL2)
+      DEBUG_PRINT_LN("[DEBUG] CSemtechProtocolEngine_BuildUplinkMessage - Replaying stored PUSH_DATA message");
+    #endif
+  }
   else
   {
     // Generate a PUSH_DATA message (LoRa packet message)
@@ -300,21 +332,23 @@ bool CSemtechProtocolEngine_BuildUplinkMessage(void *this,
   #endif
 
   // The identifier of transaction is the entry index in MemoryBlockArray
-  pMessageTransaction->m_usTransactionId = MemBlockArrayEntry.m_usBlockIndex;
+  pMessageTransaction->m_wTransactionId = MemBlockArrayEntry.m_wBlockIndex;
 
   // Step 2: Obtain a random identifier for the Semtech message 
   //
   // A 16 bit value used by Network Server to identify the message in ACK reply (see Semtech protocol) 
   pMessageTransaction->m_wMessageId = CSemtechProtocolEngine_GetNewMessageId(((CSemtechProtocolEngine *)this),
-                                                                             pMessageTransaction->m_usTransactionId);
+                                                                             pMessageTransaction->m_wTransactionId);
   pMessageTransaction->m_wMessageType = wSemtechMsgType; 
   pMessageTransaction->m_usTransactionType = 
     wSemtechMsgType == SEMTECHPROTOCOLENGINE_SEMTECH_MESSAGE_PULL_DATA ? SEMTECHMESSAGETRANSACTION_TYPE_PULLDATA : 
                                                                          SEMTECHMESSAGETRANSACTION_TYPE_PUSHDATA;
 
   pMessageTransaction->m_bHeartbeat = pParams->m_wMessageType == NETWORKSERVERPROTOCOL_UPLINKMSG_HEARTBEAT ? true : false;
+  pMessageTransaction->m_usLoraPacketNumber = 0;
   pMessageTransaction->m_dwLastEventTicks = pMessageTransaction->m_dwTransactionStartTicks = dwCurrentTicks;
   pMessageTransaction->m_wTransactionState = SEMTECHPROTOCOLENGINE_TRANSACTION_STATE_SENDING;
+  pMessageTransaction->m_wTimerSlot = SEMTECHPROTOCOLENGINE_TIMERWHEEL_NONE;
 
   // The message identifer is returned for later use when calling 'INetworkServerProtocol_ProcessSessionEvent'
   // event notification method
@@ -324,7 +358,7 @@ bool CSemtechProtocolEngine_BuildUplinkMessage(void *this,
    
   #if (SEMTECHPROTOCOLENGINE_DEBUG_LEVEL2)
     DEBUG_PRINT("[DEBUG] CSemtechProtocolEngine_BuildUplinkMessage - Transaction created: ");
-    DEBUG_PRINT_HEX(pMessageTransaction);
+    DEBUG_PRINT_PTR(pMessageTransaction);
     DEBUG_PRINT(", m_dwProtocolMessageId: ");
     DEBUG_PRINT_HEX(pMessageTransaction->m_dwProtocolMessageId);
     DEBUG_PRINT(", m_wMessageType: ");
@@ -367,205 +401,49 @@ bool CSemtechProtocolEngine_BuildUplinkMessage(void *this,
   if (pParams->m_wMessageType == NETWORKSERVERPROTOCOL_UPLINKMSG_LORADATA)
   {
     // Generate the 'rxpk' object (i.e. using LoRa packet specified in parameters)
-    pPacketInfo = pParams->m_pLoraPacketInfo;
-  
     // The 'rxpk' object is a JSON array (i.e. one entry per LoRa packet to transmit)
-    // Note: In this implementation, the Semtech message only contains one LoRa packet 
-    memcpy(pStreamHead, (void *)"{\"rxpk\":[{", 10);
-    pStreamHead += 10;
-  
-    #if (SEMTECHPROTOCOLENGINE_DEBUG_LEVEL0)
-      DEBUG_PRINT_LN("[WARNING] CSemtechProtocolEngine_BuildUplinkMessage- TO DO: improve timestamp management");
-    #endif
-  
-    // RAW timestamp, 8-17 useful chars
-    // Internal timestamp of "RX finished" event (32bit unsigned)
-    // REM: Milliseconds calculated using System Tick count (i.e. rotates in about 23 days)
-  
-    // TO DO = check if snprint available (= best efficiency)
-  
-    sprintf((char*) pTempBuffer, "\"tmst\":%u", pParams->m_pLoraPacket->m_dwTimestamp);
-    memcpy(pStreamHead, pTempBuffer, wLength = strlen((char*) pTempBuffer));
-    pStreamHead += wLength;
-  
-    // Packet RX time 
-    // UTC time of pkt RX, microsecond precision, ISO 8601 'compact' format (37 useful chars)
-  
-    // Split the UNIX timestamp to its calendar components
-    time_t timePacket = pPacketInfo->m_dwUTCSec;
-    tmTime = gmtime(&timePacket);
-    sprintf((char*) pTempBuffer, ",\"time\":\"%04i-%02i-%02iT%02i:%02i:%02i.%06liZ\"", (tmTime->tm_year) + 1900,
-            (tmTime->tm_mon) + 1, tmTime->tm_mday, tmTime->tm_hour, tmTime->tm_min, tmTime->tm_sec, 
-            (long int) pPacketInfo->m_dwUTCMicroSec);
-    memcpy(pStreamHead, pTempBuffer, wLength = strlen((char*) pTempBuffer));
-    pStreamHead += wLength;
-  
-    // RX central frequency in MHz (unsigned float, Hz precision)
-    memcpy(pStreamHead, ",\"freq\":", 8);
-    pStreamHead += 8;
-    memcpy(pStreamHead, pPacketInfo->m_szFrequency, wLength = strlen((char*) pPacketInfo->m_szFrequency));
-    pStreamHead += wLength;
-  
-    // Packet modulation, 13-14 useful chars 
-    memcpy(pStreamHead, (void *) ",\"modu\":\"LORA\"", 14);
-    pStreamHead += 14;
-  
-    // Lora datarate and bandwidth, 16-19 useful chars
-    // LoRa datarate identifier (eg. SF12BW500) 
-    memcpy(pStreamHead, ",\"datr\":\"", 9);
-    pStreamHead += 9;
-    memcpy(pStreamHead, pPacketInfo->m_szDataRate, wLength = strlen((char*) pPacketInfo->m_szDataRate));
-    pStreamHead += wLength;
-  
-    // Lora coding rate, 13 useful chars
-    // LoRa coding rate identifier (eg. 4/5) 
-    memcpy(pStreamHead, "\",\"codr\":\"", 10);
-    pStreamHead += 10;
-    memcpy(pStreamHead, pPacketInfo->m_szCodingRate, wLength = strlen((char*) pPacketInfo->m_szCodingRate));
-    pStreamHead += wLength;
-
-    // Lora SNR, 11-13 useful chars 
-    // Lora SNR ratio in dB (signed float, 0.1 dB precision)
-    memcpy(pStreamHead, "\",\"lsnr\":", 9);
-    pStreamHead += 9;
-    memcpy(pStreamHead, pPacketInfo->m_szSNR, wLength = strlen((char*) pPacketInfo->m_szSNR));
-    pStreamHead += wLength;
-  
-    // Packet RSSI and payload size, 18-23 useful chars
-    //  - RSSI in dBm (signed integer, 1 dB precision)
-    //  - RF packet payload size in bytes (unsigned integer)
-    memcpy(pStreamHead, ",\"rssi\":", 8);
-    pStreamHead += 8;
-    memcpy(pStreamHead, pPacketInfo->m_szRSSI, wLength = strlen((char*) pPacketInfo->m_szRSSI));
-    pStreamHead += wLength;
-  
-    sprintf((char*) pTempBuffer, ",\"size\":%u", pParams->m_pLoraPacket->m_dwDataSize);
-    memcpy(pStreamHead, pTempBuffer, wLength = strlen((char*) pTempBuffer));
-    pStreamHead += wLength;
-  
-    // NOTE: The following fields are required by the specification.
-    //       In current version the associated concepts are not implemented dans hardcoded values are provided
-    memcpy(pStreamHead, ",\"chan\":0,\"rfch\":0,\"stat\":1", 27);
-    pStreamHead += 27;
-                                                         
-    // Packet Base64 encoded RF payload padded, 14-350 useful chars
-    memcpy(pStreamHead, (void *)",\"data\":\"", 9);
+    // Note: This message contains the first LoRa packet. Other packets may be appended to the 'rxpk' array
+    //       later (see 'NETWORKSERVERPROTOCOL_UPLINKMSG_LORADATA_APPEND')
+    memcpy(pStreamHead, (void *)"{\"rxpk\":[", 9);
     pStreamHead += 9;
-  
-    #if (SEMTECHPROTOCOLENGINE_DEBUG_LEVEL2)
-      *((BYTE *) pStreamHead) = 0;
-      DEBUG_PRINT_LN("[DEBUG] CSemtechProtocolEngine_BuildUplinkMessage- JSON Message stream (before base64): ");
-      DEBUG_PRINT_LN(pParams->m_pMessageData + 12);
-    #endif
-  
-    // Check available space
-    //  - Base64 encoding -> 255 bytes = 340 chars in Base64 (+ null char)
-    //  - End of serialization -> 2 bytes
-    //  - Null char if JSON stream displayed for debug -> 1 byte
-  
-    #if (SEMTECHPROTOCOLENGINE_DEBUG_LEVEL2)
-      *((BYTE *) pStreamHead) = 0;
-      DEBUG_PRINT("[DEBUG] CSemtechProtocolEngine_BuildUplinkMessage- MaxMessageLength: ");
-      DEBUG_PRINT_DEC(pParams->m_wMaxMessageLength);
-      DEBUG_PRINT(", current size: ");
-      DEBUG_PRINT_DEC((pStreamHead - pParams->m_pMessageData));
-      DEBUG_PRINT(", diff: ");
-      DEBUG_PRINT_DEC(pParams->m_wMaxMessageLength - ((WORD) (pStreamHead - pParams->m_pMessageData)));
-      DEBUG_PRINT_CR;
-    #endif
-  
-    if (pParams->m_wMaxMessageLength - ((WORD) (pStreamHead - pParams->m_pMessageData)) < 343)
-    {
-      #if (SEMTECHPROTOCOLENGINE_DEBUG_LEVEL0)
-        DEBUG_PRINT_LN("[ERROR] CSemtechProtocolEngine_BuildUplinkMessage- buffer to small to encode payload data");
-      #endif
-      CMemoryBlockArray_ReleaseBlock(((CSemtechProtocolEngine *)this)->m_pTransactionArray, pMessageTransaction->m_usTransactionId);
-      return false;
-    }
-  
-    #if (SEMTECHPROTOCOLENGINE_DEBUG_LEVEL2)
-      DEBUG_PRINT_LN("[DEBUG] Payload data before encoding:");
-      for (unsigned int i = 0; i < pParams->m_pLoraPacket->m_dwDataSize; i++)
-      {
-        DEBUG_PRINT_BYTE(pParams->m_pLoraPacket->m_usData[i]);   
-        DEBUG_PRINT("|");
-      }
-      DEBUG_PRINT_CR;
-      DEBUG_PRINT_LN("## Packet end");
-    #endif
-  
-    wLength = Base64_BinToB64(pParams->m_pLoraPacket->m_usData, pParams->m_pLoraPacket->m_dwDataSize, pStreamHead, 341);
-  
-    #if (SEMTECHPROTOCOLENGINE_DEBUG_LEVEL2)
-      if (wLength != 0xFFFF)
-      {  
-        DEBUG_PRINT("[DEBUG] Encoded payload length: ");
-        DEBUG_PRINT_DEC(wLength);
-        DEBUG_PRINT_CR;
-        *(pStreamHead + wLength) = 0;
-        DEBUG_PRINT("[DEBUG] Encoded Payload data: ");
-        DEBUG_PRINT_LN(pStreamHead);
-    
-        BYTE *pDecodedData = (BYTE *) pvPortMalloc(pParams->m_pLoraPacket->m_dwDataSize + 10);
-      
-        WORD wDecodedLength = Base64_B64ToBin(pStreamHead, wLength, pDecodedData, pParams->m_pLoraPacket->m_dwDataSize + 10);
-      
-        if (wDecodedLength != 0xFFFF)
-        {
-          if (wDecodedLength != pParams->m_pLoraPacket->m_dwDataSize)
-          {
-            DEBUG_PRINT("[DEBUG] Payload data after encoding and decoding: Wrong length, encoded: ");
-            DEBUG_PRINT_DEC(wLength);
-            DEBUG_PRINT(", decoded: ");
-            DEBUG_PRINT_DEC(wDecodedLength);
-            DEBUG_PRINT_CR;
-          }
-          DEBUG_PRINT_LN("[DEBUG] Payload data after encoding and decoding:");
-          for (unsigned int i = 0; i < (unsigned int) wDecodedLength; i++)
-          {
-            DEBUG_PRINT_BYTE(pDecodedData[i]);   
-            DEBUG_PRINT("|");
-          }
-          DEBUG_PRINT_CR;
-          DEBUG_PRINT_LN("## Packet end");
-        }
-        else
-        {
-          DEBUG_PRINT_LN("[DEBUG] Payload data after encoding and decoding: Decoding error");
-        }
-        vPortFree(pDecodedData);
-      }
-    #endif
-  
-    if (wLength == 0xFFFF)
+
+    // Note: 2 bytes reserved for end of serialization
+    if ((pStreamHead = CSemtechProtocolEngine_GetRxpkStream(this, pStreamHead, 
+                         pParams->m_pMessageData + pParams->m_wMaxMessageLength - 2,
+                         pParams->m_pLoraPacket, pParams->m_pLoraPacketInfo)) == NULL)
     {
       #if (SEMTECHPROTOCOLENGINE_DEBUG_LEVEL0)
-        DEBUG_PRINT_LN("[ERROR] CSemtechProtocolEngine_BuildUplinkMessage- failed to encode payload in Base64");
+        DEBUG_PRINT_LN("[ERROR] CSemtechProtocolEngine_BuildUplinkMessage- failed to build 'rxpk' stream");
       #endif
-      CMemoryBlockArray_ReleaseBlock(((CSemtechProtocolEngine *)this)->m_pTransactionArray, pMessageTransaction->m_usTransactionId);
+      CWideMemoryBlockArray_ReleaseBlock(((CSemtechProtocolEngine *)this)->m_pTransactionArray, pMessageTransaction->m_wTransactionId);
       return false;
     }
-    pStreamHead += wLength;
+    pMessageTransaction->m_usLoraPacketNumber = 1;
 
-    // End of packet serialization
-    *(pStreamHead++) = '"'; 
-    *(pStreamHead++) = '}'; 
+    // End of 'rxpk' array serialization
     *(pStreamHead++) = ']'; 
     *(pStreamHead++) = '}'; 
   }
+  else if (pParams->m_wMessageType == NETWORKSERVERPROTOCOL_UPLINKMSG_REPLAY)
+  {
+    // The JSON object of stored message is kept unchanged (only header updated with new message identifier)
+    // Note: The 'rxpk' array of a replayed message is closed (i.e. the 'm_usLoraPacketNumber' is 0 so no LoRa
+    //       packet can be appended)
+    pStreamHead = pParams->m_pMessageData + pParams->m_wMessageLength;
+  }
   else if (pParams->m_wMessageType == NETWORKSERVERPROTOCOL_UPLINKMSG_HEARTBEAT)
   {
     // Note: Additional stream not required for 'PULL_DATA' message
     if (wSemtechMsgType == SEMTECHPROTOCOLENGINE_SEMTECH_MESSAGE_PUSH_DATA)
     {
       // Generate the 'stat' object (i.e. built using current state recorded in ProtocolEngine)
-      BYTE * pResult = CSemtechProtocolEngine_GetStatStream(this, pStreamHead);
+      BYTE * pResult = CSemtechProtocolEngine_GetStatStream(this, pStreamHead, pParams->m_pMessageData + pParams->m_wMaxMessageLength);
       if (pResult == NULL)
       {
         #if (SEMTECHPROTOCOLENGINE_DEBUG_LEVEL0)
           DEBUG_PRINT_LN("[ERROR] CSemtechProtocolEngine_BuildUplinkMessage- failed to build 'stat' stream");
         #endif
-        CMemoryBlockArray_ReleaseBlock(((CSemtechProtocolEngine *)this)->m_pTransactionArray, pMessageTransaction->m_usTransactionId);
+        CWideMemoryBlockArray_ReleaseBlock(((CSemtechProtocolEngine *)this)->m_pTransactionArray, pMessageTransaction->m_wTransactionId);
         return false;
       }
       pStreamHead = pResult;
@@ -576,24 +454,12 @@ bool CSemtechProtocolEngine_BuildUplinkMessage(void *this,
   ++((CSemtechProtocolEngine *)this)->m_wPendingUpTransactionCount;
   pParams->m_wMessageLength = (WORD) (pStreamHead - pParams->m_pMessageData);
 
+  // Semtech header (version, token, identifier, gateway EUI) and message size
   #if (SEMTECHPROTOCOLENGINE_DEBUG_LEVEL2)
-    *((BYTE *) pStreamHead) = 0;
-    DEBUG_PRINT_LN("[DEBUG] CSemtechProtocolEngine_BuildUplinkMessage- Message stream (with header): ");
-    for (int i = 0; i < 12; i++)
-    {
-      DEBUG_PRINT_BYTE(pParams->m_pMessageData[i]);
-      DEBUG_PRINT(", ");
-    }
-    DEBUG_PRINT_LN(pParams->m_pMessageData + 12);
-    DEBUG_PRINT("[DEBUG] CSemtechProtocolEngine_BuildUplinkMessage- Message stream size: ");
-    DEBUG_PRINT_DEC((DWORD)pParams->m_wMessageLength);
-    DEBUG_PRINT_LN(" bytes");
-  #endif
-
-  #if (SEMTECHPROTOCOLENGINE_DEBUG_LEVEL2)
-    DEBUG_PRINT("[DEBUG] CSemtechProtocolEngine_BuildUplinkMessage- Number of pending uplink transactions: ");
-    DEBUG_PRINT_DEC(((CSemtechProtocolEngine *)this)->m_wPendingUpTransactionCount);
-    DEBUG_PRINT_CR;
+    TRACERING_EVENT(TRACERING_ID_SEMTECH_UPLINK_MESSAGE, pParams->m_wMessageLength, 
+                    ((CSemtechProtocolEngine *)this)->m_wPendingUpTransactionCount,
+                    TRACERING_BYTES(pParams->m_pMessageData, pParams->m_wMessageLength, 0),
+                    TRACERING_BYTES(pParams->m_pMessageData, pParams->m_wMessageLength, 4));
   #endif
 
   return true;
@@ -608,7 +474,7 @@ DWORD CSemtechProtocolEngine_ProcessServerMessage(void *this,
 {
   WORD wToken;
   BYTE usMessageType;
-  BYTE usTransactionId;
+  WORD wTransactionId;
   CSemtechMessageTransaction pMessageTransaction;
   DWORD dwCurrentTicks;
 
@@ -660,22 +526,26 @@ DWORD CSemtechProtocolEngine_ProcessServerMessage(void *this,
     // The ACK message terminates the protocol transaction
     // Retrieve the transaction id from provided token
     // The identifier of transaction is the entry index in MemoryBlockArray
-    usTransactionId = wToken & SEMTECHPROTOCOLENGINE_TRANSACTION_ID_MASK;
+    wTransactionId = wToken & SEMTECHPROTOCOLENGINE_TRANSACTION_ID_MASK;
 
     pMessageTransaction = 
-      (CSemtechMessageTransaction) CMemoryBlockArray_BlockPtrFromIndex(((CSemtechProtocolEngine *)this)->m_pTransactionArray, usTransactionId);
+      (CSemtechMessageTransaction) CWideMemoryBlockArray_BlockPtrFromIndex(((CSemtechProtocolEngine *)this)->m_pTransactionArray, wTransactionId);
 
     #if (SEMTECHPROTOCOLENGINE_DEBUG_LEVEL2)
       DEBUG_PRINT("[DEBUG] CSemtechProtocolEngine_ProcessServerMessage - Processing ACK, Transaction retrieved: ");
-      DEBUG_PRINT_HEX(pMessageTransaction);
+      DEBUG_PRINT_PTR(pMessageTransaction);
       DEBUG_PRINT_CR;
     #endif
 
     // Consistency check
-    if ((CMemoryBlockArray_IsBlockUsed(((CSemtechProtocolEngine *)this)->m_pTransactionArray, usTransactionId) == false) ||
+    if ((CWideMemoryBlockArray_IsBlockUsed(((CSemtechProtocolEngine *)this)->m_pTransactionArray, wTransactionId) == false) ||
         (pMessageTransaction->m_wMessageId != wToken))
     {
       // Unable to retrieve the 'Transaction' associated with the message
+      // Typically the ACK is received after expiry of transaction (i.e. transaction already released)
+      // Note: Counter updated by 'Connector' task and read by the task expiring the transactions
+      __atomic_add_fetch(&((CSemtechProtocolEngine *)this)->m_dwAckLateCount, 1, __ATOMIC_RELAXED);
+
       #if (SEMTECHPROTOCOLENGINE_DEBUG_LEVEL0)
         DEBUG_PRINT("[WARNING] CSemtechProtocolEngine_ProcessServerMessage - Unable to retrieve transaction, maybe message too late (");
         if (pMessageTransaction->m_wMessageId != wToken)
@@ -690,6 +560,31 @@ DWORD CSemtechProtocolEngine_ProcessServerMessage(void *this,
       return NETWORKSERVERPROTOCOL_SESSIONERROR_TRANSACTION;
     }
 
+    // The ACK is ignored if the transaction has already expired (i.e. already reported as failed to owner object)
+    // Note: The transaction may also be expired concurrently by 'GetExpiredSession' (i.e. atomic state switch)
+    if (CSemtechProtocolEngine_SwitchTransactionState(pMessageTransaction, SEMTECHPROTOCOLENGINE_TRANSACTION_STATE_SENT,
+        SEMTECHPROTOCOLENGINE_TRANSACTION_STATE_ACKNOWLEDGED) == true)
+    {
+      // Usual case: ACK received after the 'SENT' event (i.e. message already counted)
+    }
+    else if (CSemtechProtocolEngine_SwitchTransactionState(pMessageTransaction, SEMTECHPROTOCOLENGINE_TRANSACTION_STATE_SENDING,
+             SEMTECHPROTOCOLENGINE_TRANSACTION_STATE_ACKNOWLEDGED) == true)
+    {
+      // ACK received before the 'SENT' event: the message is counted here because the transaction
+      // is terminated (i.e. possibly released before the 'SENT' event is processed)
+      __atomic_add_fetch(&((CSemtechProtocolEngine *)this)->m_dwUpnbCount, 1, __ATOMIC_RELAXED);
+      __atomic_add_fetch(&((CSemtechProtocolEngine *)this)->m_dwRxfwCount, pMessageTransaction->m_usLoraPacketNumber, __ATOMIC_RELAXED);
+    }
+    else
+    {
+      __atomic_add_fetch(&((CSemtechProtocolEngine *)this)->m_dwAckLateCount, 1, __ATOMIC_RELAXED);
+
+      #if (SEMTECHPROTOCOLENGINE_DEBUG_LEVEL0)
+        DEBUG_PRINT_LN("[WARNING] CSemtechProtocolEngine_ProcessServerMessage - ACK received after expiry of transaction, ignored");
+      #endif
+      return NETWORKSERVERPROTOCOL_SESSIONERROR_TRANSACTION;
+    }
+
     // Transaction found, provide Protocol Message identifier to caller (typically used by caller to retrieve its own session descriptor)
     pParams->m_dwProtocolMessageId = pMessageTransaction->m_dwProtocolMessageId;
 
@@ -714,29 +609,54 @@ DWORD CSemtechProtocolEngine_ProcessServerMessage(void *this,
     return NETWORKSERVERPROTOCOL_UPLINKSESSIONEVENT_TERMINATED;
   }
 
-  // TO DO -> Other messages types
   if (usMessageType == SEMTECHPROTOCOLENGINE_SEMTECH_MESSAGE_PULL_RESP)
   {
-  
     // In case of PULL_RESP a LoRa packet must be sent to Node
-    //  - This message instanciate a downlink transaction in 'ProtocolEngine'
-    //  - The data in PULL_RESP message are process to describe the LoRa packet to transmit
-   
+    //  - The 'txpk' object in PULL_RESP message describes the LoRa packet to transmit
+    //  - The payload is decoded directly in the memory block provided by caller (i.e. the received
+    //    message is read in place, without copy)
+    //  - The token is returned to the caller, it must be provided when building the TX_ACK message
+    //    (i.e. reply expected by Network Server for protocol version 2, see 'BuildDownlinkAck')
+    ++((CSemtechProtocolEngine *)this)->m_dwDwnbCount;
+    pParams->m_dwProtocolMessageId = (DWORD) wToken;
+
     // The caller must provide the memory block for LoRa packet
     if (pParams->m_pData == NULL || pParams->m_wMaxLoraPacketLength == 0)
     {
       // Should never occur (i.e. adjust memory block array size)
       // Unable to process the dwonlink message
       #if (SEMTECHPROTOCOLENGINE_DEBUG_LEVEL0)
-        DEBUG_PRINT_LN("[ERROR] CSemtechProtocolEngine_ProcessServerMessage - No memory to encode ACK (no confirmation available for Node)");
+        DEBUG_PRINT_LN("[ERROR] CSemtechProtocolEngine_ProcessServerMessage - No memory to decode LoRa packet to send to node");
       #endif
+      return NETWORKSERVERPROTOCOL_SESSIONERROR_MESSAGE;
     }
 
     // Prepare the LoRa packet
-    
-  }
+    if (CSemtechProtocolEngine_ParseTxpkStream((CSemtechProtocolEngine *)this, pParams->m_pMessageData + 4, 
+        pParams->m_pMessageData + pParams->m_wMessageLength, pParams) == false)
+    {
+      #if (SEMTECHPROTOCOLENGINE_DEBUG_LEVEL0)
+        DEBUG_PRINT_LN("[ERROR] CSemtechProtocolEngine_ProcessServerMessage - Invalid 'txpk' object in PULL_RESP message");
+      #endif
+      return NETWORKSERVERPROTOCOL_SESSIONERROR_MESSAGE;
+    }
 
+    #if (SEMTECHPROTOCOLENGINE_DEBUG_LEVEL2)
+      DEBUG_PRINT("[DEBUG] CSemtechProtocolEngine_ProcessServerMessage - PULL_RESP decoded, size: ");
+      DEBUG_PRINT_DEC((DWORD) pParams->m_wLoraPacketLength);
+      DEBUG_PRINT(", freq: ");
+      DEBUG_PRINT_DEC(pParams->m_DownlinkPacketInfo.m_dwFrequency);
+      DEBUG_PRINT(", tmst: ");
+      DEBUG_PRINT_DEC(pParams->m_DownlinkPacketInfo.m_dwTimestamp);
+      DEBUG_PRINT(", SF: ");
+      DEBUG_PRINT_DEC((DWORD) pParams->m_DownlinkPacketInfo.m_usSpreadingFactor);
+      DEBUG_PRINT(", BW: ");
+      DEBUG_PRINT_DEC((DWORD) pParams->m_DownlinkPacketInfo.m_wBandwidth);
+      DEBUG_PRINT_CR;
+    #endif
 
+    return NETWORKSERVERPROTOCOL_DOWNLINKSESSIONEVENT_PREPARED;
+  }
 
   // Unknown type, probably corrupted data
   #if (SEMTECHPROTOCOLENGINE_DEBUG_LEVEL0)
@@ -755,7 +675,8 @@ DWORD CSemtechProtocolEngine_ProcessSessionEvent(void *this,
                                                  CNetworkServerProtocolItf_ProcessSessionEventParams pParams)
 {                                     
   CSemtechMessageTransaction pMessageTransaction;
-  BYTE usBlockIndex;
+  WORD wBlockIndex;
+  bool bSent;
 
   DWORD dwResult = NETWORKSERVERPROTOCOL_SESSIONERROR_OK;
 
@@ -769,12 +690,12 @@ DWORD CSemtechProtocolEngine_ProcessSessionEvent(void *this,
   //
   // The 'TransactionId' is encoded in the LOWORD of specified 'm_dwProtocolMessageId.
   // The 'TransactionId' is the index in the 'MemoryBlockArray' used for 'CSemtechMessageTransaction'
-  usBlockIndex = (BYTE)(((WORD) pParams->m_dwProtocolMessageId) & SEMTECHPROTOCOLENGINE_TRANSACTION_ID_MASK);
-  pMessageTransaction = CMemoryBlockArray_BlockPtrFromIndex(((CSemtechProtocolEngine *)this)->m_pTransactionArray, usBlockIndex);
+  wBlockIndex = (((WORD) pParams->m_dwProtocolMessageId) & SEMTECHPROTOCOLENGINE_TRANSACTION_ID_MASK);
+  pMessageTransaction = CWideMemoryBlockArray_BlockPtrFromIndex(((CSemtechProtocolEngine *)this)->m_pTransactionArray, wBlockIndex);
 
   // Consistency check (i.e. 'MemoryBlockArray' entries are reused (timeout applies when waiting for protocol
   // message/events)
-  if ((CMemoryBlockArray_IsBlockUsed(((CSemtechProtocolEngine *)this)->m_pTransactionArray, usBlockIndex) == false) ||
+  if ((CWideMemoryBlockArray_IsBlockUsed(((CSemtechProtocolEngine *)this)->m_pTransactionArray, wBlockIndex) == false) ||
       (pMessageTransaction->m_wMessageId != (WORD) pParams->m_dwProtocolMessageId))
   {
     // Unable to retrieve the 'Transaction' associated with the message
@@ -798,7 +719,7 @@ DWORD CSemtechProtocolEngine_ProcessSessionEvent(void *this,
 
   #if (SEMTECHPROTOCOLENGINE_DEBUG_LEVEL2)
     DEBUG_PRINT("[DEBUG] CSemtechProtocolEngine_ProcessSessionEvent - Transaction found: ");
-    DEBUG_PRINT_HEX(pMessageTransaction);
+    DEBUG_PRINT_PTR(pMessageTransaction);
     DEBUG_PRINT(", m_dwProtocolMessageId: ");
     DEBUG_PRINT_HEX(pMessageTransaction->m_dwProtocolMessageId);
     DEBUG_PRINT(", m_wMessageType: ");
@@ -817,21 +738,29 @@ DWORD CSemtechProtocolEngine_ProcessSessionEvent(void *this,
       if ((pMessageTransaction->m_usTransactionType == SEMTECHMESSAGETRANSACTION_TYPE_PUSHDATA) ||
           (pMessageTransaction->m_usTransactionType == SEMTECHMESSAGETRANSACTION_TYPE_PULLDATA))
       {
-        if (pMessageTransaction->m_wTransactionState == SEMTECHPROTOCOLENGINE_TRANSACTION_STATE_SENDING)
+        // Note: The 'ACK' message may be received (by 'Connector' task) before the 'SENT' event
+        bSent = CSemtechProtocolEngine_SwitchTransactionState(pMessageTransaction, SEMTECHPROTOCOLENGINE_TRANSACTION_STATE_SENDING,
+                                                              SEMTECHPROTOCOLENGINE_TRANSACTION_STATE_SENT);
+        if ((bSent == true) || (pMessageTransaction->m_wTransactionState == SEMTECHPROTOCOLENGINE_TRANSACTION_STATE_ACKNOWLEDGED))
         {
           // Update transaction state
           // Automaton will wait for 'ACK' meessage (or timeout)
           pMessageTransaction->m_dwLastEventTicks = xTaskGetTickCount();
-          pMessageTransaction->m_wTransactionState = SEMTECHPROTOCOLENGINE_TRANSACTION_STATE_SENT;
+          if (pMessageTransaction->m_wTransactionState == SEMTECHPROTOCOLENGINE_TRANSACTION_STATE_SENT)
+          {
+            CSemtechProtocolEngine_StartTransactionTimer((CSemtechProtocolEngine *)this, pMessageTransaction);
+          }
           dwResult = NETWORKSERVERPROTOCOL_UPLINKSESSIONEVENT_PROGRESSING;
 
           // Update counters uplink messages sent (Heartbeat and LoRa packets)
-          ++((CSemtechProtocolEngine *)this)->m_dwUpnbCount;
-
-          // If sending a LoRa packet, update forwarded packet counter
-          if (pMessageTransaction->m_bHeartbeat == false)
+          // Note: Already updated when the ACK was received first
+          if (bSent == true)
           {
-            ++((CSemtechProtocolEngine *)this)->m_dwRxfwCount;
+            __atomic_add_fetch(&((CSemtechProtocolEngine *)this)->m_dwUpnbCount, 1, __ATOMIC_RELAXED);
+
+            // If sending LoRa packets, update forwarded packet counter (i.e. several packets if aggregated)
+            __atomic_add_fetch(&((CSemtechProtocolEngine *)this)->m_dwRxfwCount, pMessageTransaction->m_usLoraPacketNumber,
+                               __ATOMIC_RELAXED);
           }
         }
         else
@@ -857,7 +786,7 @@ DWORD CSemtechProtocolEngine_ProcessSessionEvent(void *this,
         if (pMessageTransaction->m_wTransactionState == SEMTECHPROTOCOLENGINE_TRANSACTION_STATE_SENDING)
         {
           // Unable to send the message, terminate the transaction
-          CMemoryBlockArray_ReleaseBlock(((CSemtechProtocolEngine *)this)->m_pTransactionArray, usBlockIndex);
+          CWideMemoryBlockArray_ReleaseBlock(((CSemtechProtocolEngine *)this)->m_pTransactionArray, wBlockIndex);
           --((CSemtechProtocolEngine *)this)->m_wPendingUpTransactionCount;
           dwResult = NETWORKSERVERPROTOCOL_UPLINKSESSIONEVENT_FAILED;
 
@@ -889,7 +818,8 @@ DWORD CSemtechProtocolEngine_ProcessSessionEvent(void *this,
         DEBUG_PRINT_LN("[DEBUG] CSemtechProtocolEngine_ProcessSessionEvent - Releasing Transaction memory block");
       #endif
 
-      CMemoryBlockArray_ReleaseBlock(((CSemtechProtocolEngine *)this)->m_pTransactionArray, usBlockIndex);
+      CSemtechProtocolEngine_StopTransactionTimer((CSemtechProtocolEngine *)this, pMessageTransaction);
+      CWideMemoryBlockArray_ReleaseBlock(((CSemtechProtocolEngine *)this)->m_pTransactionArray, wBlockIndex);
       --((CSemtechProtocolEngine *)this)->m_wPendingUpTransactionCount;
 
       #if (SEMTECHPROTOCOLENGINE_DEBUG_LEVEL2)
@@ -911,7 +841,8 @@ DWORD CSemtechProtocolEngine_ProcessSessionEvent(void *this,
 
     case NETWORKSERVERPROTOCOL_SESSIONEVENT_CANCELED:
       // Owner object asks to cancel the transaction (typically no more event expected from Network Server)
-      CMemoryBlockArray_ReleaseBlock(((CSemtechProtocolEngine *)this)->m_pTransactionArray, usBlockIndex);
+      CSemtechProtocolEngine_StopTransactionTimer((CSemtechProtocolEngine *)this, pMessageTransaction);
+      CWideMemoryBlockArray_ReleaseBlock(((CSemtechProtocolEngine *)this)->m_pTransactionArray, wBlockIndex);
       --((CSemtechProtocolEngine *)this)->m_wPendingUpTransactionCount;
 
       #if (SEMTECHPROTOCOLENGINE_DEBUG_LEVEL2)
@@ -932,6 +863,128 @@ DWORD CSemtechProtocolEngine_ProcessSessionEvent(void *this,
   return dwResult;
 }
 
+// Returns the next uplink session expired without ACK from Network Server
+// The function processes the timer wheel slots elapsed since previous call and returns 'false' when there is no
+// more expired session
+// Note: The owner object must terminate the returned session (failed) and confirm with 'NETWORKSERVERPROTOCOL_SESSIONEVENT_RELEASED'
+// Note: Each call processes at most 'SEMTECHPROTOCOLENGINE_TIMERWHEEL_SLOTS' slots (i.e. the slot list of not 
+//       expired transactions are visited once per call)
+bool CSemtechProtocolEngine_GetExpiredSession(void *this, CNetworkServerProtocolItf_GetExpiredSessionParams pParams)
+{
+  CSemtechProtocolEngine *pEngine = (CSemtechProtocolEngine *)this;
+  CSemtechMessageTransaction pMessageTransaction;
+  TickType_t dwCurrentTicks;
+  DWORD dwSlotNumber;
+  DWORD dwSlot;
+  WORD wTransactionId;
+
+  dwCurrentTicks = xTaskGetTickCount();
+
+  // Number of slots to visit (i.e. from slot of last processing up to current slot)
+  dwSlotNumber = SEMTECHPROTOCOLENGINE_TIMERWHEEL_SLOT(dwCurrentTicks) - SEMTECHPROTOCOLENGINE_TIMERWHEEL_SLOT(pEngine->m_dwTimerWheelTicks) + 1;
+  if (dwSlotNumber > SEMTECHPROTOCOLENGINE_TIMERWHEEL_SLOTS)
+  {
+    dwSlotNumber = SEMTECHPROTOCOLENGINE_TIMERWHEEL_SLOTS;
+  }
+
+  for (dwSlot = SEMTECHPROTOCOLENGINE_TIMERWHEEL_SLOT(pEngine->m_dwTimerWheelTicks); dwSlotNumber > 0; dwSlot++, dwSlotNumber--)
+  {
+    wTransactionId = pEngine->m_wTimerWheel[dwSlot & SEMTECHPROTOCOLENGINE_TIMERWHEEL_SLOT_MASK];
+    while (wTransactionId != SEMTECHPROTOCOLENGINE_TIMERWHEEL_NONE)
+    {
+      pMessageTransaction = CWideMemoryBlockArray_BlockPtrFromIndex(pEngine->m_pTransactionArray, wTransactionId);
+      wTransactionId = pMessageTransaction->m_wNextTimerId;
+
+      // Not expired (i.e. next turn of the wheel)
+      if ((int32_t) (dwCurrentTicks - pMessageTransaction->m_dwExpiryTicks) < 0)
+      {
+        continue;
+      }
+
+      // The transaction is removed from timer wheel (expired or already acknowledged)
+      CSemtechProtocolEngine_StopTransactionTimer(pEngine, pMessageTransaction);
+      if (CSemtechProtocolEngine_SwitchTransactionState(pMessageTransaction, SEMTECHPROTOCOLENGINE_TRANSACTION_STATE_SENT,
+          SEMTECHPROTOCOLENGINE_TRANSACTION_STATE_EXPIRED) == true)
+      {
+        ++pEngine->m_dwAckLostCount;
+        pMessageTransaction->m_dwLastEventTicks = dwCurrentTicks;
+        pParams->m_dwProtocolMessageId = pMessageTransaction->m_dwProtocolMessageId;
+
+        #if (SEMTECHPROTOCOLENGINE_DEBUG_LEVEL1)
+          DEBUG_PRINT("[INFO] CSemtechProtocolEngine_GetExpiredSession - No ACK received, transaction expired, m_dwProtocolMessageId: ");
+          DEBUG_PRINT_HEX(pMessageTransaction->m_dwProtocolMessageId);
+          DEBUG_PRINT(", lost ACK: ");
+          DEBUG_PRINT_DEC(pEngine->m_dwAckLostCount);
+          DEBUG_PRINT(", late ACK: ");
+          DEBUG_PRINT_DEC(__atomic_load_n(&pEngine->m_dwAckLateCount, __ATOMIC_RELAXED));
+          DEBUG_PRINT_CR;
+        #endif
+
+        // Note: The current slot is visited again on next call (i.e. 'm_dwTimerWheelTicks' not updated)
+        pEngine->m_dwTimerWheelTicks = (TickType_t) (dwSlot * pdMS_TO_TICKS(SEMTECHPROTOCOLENGINE_TIMERWHEEL_SLOT_DURATION));
+        return true;
+      }
+    }
+  }
+
+  pEngine->m_dwTimerWheelTicks = dwCurrentTicks;
+  return false;
+}
+
+// Builds the TX_ACK message for a PULL_RESP message
+// The TX_ACK message is:
+//  - Byte  0      = protocol version (2)
+//  - Bytes 1-2    = same token as the PULL_RESP message
+//  - Byte  3      = TX_ACK identifier (0x05)
+//  - Bytes 4-11   = gateway unique identifier
+//  - Bytes 12-end = JSON object '{"txpk_ack":{"error":"xxx"}}' (error is 'NONE' if packet scheduled)
+bool CSemtechProtocolEngine_BuildDownlinkAck(void *this, CNetworkServerProtocolItf_BuildDownlinkAckParams pParams)
+{
+  // Error names of Semtech protocol (index = 'TRANSCEIVERMANAGER_SENDDOWNLINK_xxx')
+  static const char * const s_pszErrorName[] = { "NONE", "TOO_LATE", "TOO_EARLY", "COLLISION_PACKET",
+                                                 "COLLISION_BEACON", "TX_FREQ", "TX_POWER", "GPS_UNLOCKED" };
+  const char *pszError;
+  BYTE *pStreamHead;
+  WORD wErrorLength;
+
+  pszError = pParams->m_dwDownlinkResult < (sizeof(s_pszErrorName) / sizeof(s_pszErrorName[0])) ?
+             s_pszErrorName[pParams->m_dwDownlinkResult] : s_pszErrorName[TRANSCEIVERMANAGER_SENDDOWNLINK_TOO_LATE];
+  wErrorLength = (WORD) strlen(pszError);
+
+  pParams->m_wMessageLength = 12 + 22 + wErrorLength + 3;
+  if (pParams->m_wMessageLength > pParams->m_wMaxMessageLength)
+  {
+    #if (SEMTECHPROTOCOLENGINE_DEBUG_LEVEL0)
+      DEBUG_PRINT_LN("[ERROR] CSemtechProtocolEngine_BuildDownlinkAck - Buffer too small for TX_ACK message");
+    #endif
+    pParams->m_wMessageLength = 0;
+    return false;
+  }
+
+  // Message header (bytes 0-11)
+  pStreamHead = pParams->m_pMessageData;
+  *(pStreamHead++) = SEMTECHPROTOCOLENGINE_SEMTECH_PROTOCOL_VERSION;
+  *((WORD*) pStreamHead) = (WORD) pParams->m_dwProtocolMessageId;
+  pStreamHead += 2;
+  *(pStreamHead++) = SEMTECHPROTOCOLENGINE_SEMTECH_MESSAGE_TX_ACK;
+  memcpy(pStreamHead, ((CSemtechProtocolEngine *) this)->m_GatewayMACAddr, 8);
+  pStreamHead += 8;
+
+  // Message JSON stream (bytes 12-)
+  memcpy(pStreamHead, (void *)"{\"txpk_ack\":{\"error\":\"", 22);
+  pStreamHead += 22;
+  memcpy(pStreamHead, pszError, wErrorLength);
+  pStreamHead += wErrorLength;
+  memcpy(pStreamHead, (void *)"\"}}", 3);
+
+  #if (SEMTECHPROTOCOLENGINE_DEBUG_LEVEL1)
+    DEBUG_PRINT("[INFO] CSemtechProtocolEngine_BuildDownlinkAck - TX_ACK built, error: ");
+    DEBUG_PRINT_LN(pszError);
+  #endif
+
+  return true;
+}
+
 
 /********************************************************************************************* 
   Private methods of CSemtechProtocolEngine object
@@ -976,7 +1029,7 @@ CSemtechProtocolEngine * CSemtechProtocolEngine_New()
     this->m_pTransactionArray = NULL;
 
     // Allocate memory blocks for internal collections
-    if ((this->m_pTransactionArray = CMemoryBlockArray_New(sizeof(CSemtechMessageTransactionOb),
+    if ((this->m_pTransactionArray = CWideMemoryBlockArray_New(sizeof(CSemtechMessageTransactionOb),
         SEMTECHPROTOCOLENGINE_MAX_TRANSACTIONS)) == NULL)
     {
       CSemtechProtocolEngine_Delete(this);
@@ -1000,6 +1053,17 @@ CSemtechProtocolEngine * CSemtechProtocolEngine_New()
     this->m_dwTxnbCount = 0; 
     this->m_dwUpnbCount = 0;
 
+    this->m_dwAckLostCount = 0;
+    this->m_dwAckLateCount = 0;
+
+    for (WORD wSlot = 0; wSlot < SEMTECHPROTOCOLENGINE_TIMERWHEEL_SLOTS; wSlot++)
+    {
+      this->m_wTimerWheel[wSlot] = SEMTECHPROTOCOLENGINE_TIMERWHEEL_NONE;
+    }
+    this->m_dwTimerWheelTicks = xTaskGetTickCount();
+
+    this->m_dwIsoTimeSec = 0xFFFFFFFF;
+
     // Hardcoded
     // TO DO -> Provided during initialization (from configuration or GPS)
     strcpy((char*) this->m_strGatewayLatitude, "45.835549");
@@ -1043,7 +1107,7 @@ void CSemtechProtocolEngine_Delete(CSemtechProtocolEngine *this)
   // Free memory
   if (this->m_pTransactionArray != NULL)
   {
-    CMemoryBlockArray_Delete(this->m_pTransactionArray);
+    CWideMemoryBlockArray_Delete(this->m_pTransactionArray);
   }
 
   vPortFree(this);
@@ -1059,15 +1123,15 @@ void CSemtechProtocolEngine_Delete(CSemtechProtocolEngine *this)
 *********************************************************************************************/
 
 
-WORD CSemtechProtocolEngine_GetNewMessageId(CSemtechProtocolEngine *this, BYTE usTransactionId)
+WORD CSemtechProtocolEngine_GetNewMessageId(CSemtechProtocolEngine *this, WORD wTransactionId)
 {
   // The identifier is built using 2 values:
   //  - <hi_part><low_part>'
   //  - An incremental counter (this->m_wMessageIdCounter) for '<hi_part>'
-  //  - The 'usTransactionId' for '<low_part>'
+  //  - The 'wTransactionId' for '<low_part>'
   //  - The range for these parts depends on the maximum number of active transactions 
   //    configured for the 'SemtechProtocolEngine' (= SEMTECHPROTOCOLENGINE_MAX_TRANSACTIONS)
-  //    (i.e. the range for 'usTransactionId')
+  //    (i.e. the range for 'wTransactionId')
   if (this->m_wMessageIdCounter == 0xFFFF >> SEMTECHPROTOCOLENGINE_MAX_TRANSACTION_BITS)
   {
     // By design, do not generate id with 0 value
@@ -1077,104 +1141,538 @@ WORD CSemtechProtocolEngine_GetNewMessageId(CSemtechProtocolEngine *this, BYTE u
   {
     this->m_wMessageIdCounter++;
   }
-  return (this->m_wMessageIdCounter << SEMTECHPROTOCOLENGINE_MAX_TRANSACTION_BITS) | ((WORD) usTransactionId);
+  return (this->m_wMessageIdCounter << SEMTECHPROTOCOLENGINE_MAX_TRANSACTION_BITS) | wTransactionId;
 }
 
 // Builds the 'stat' JSON string using current counter values
 // The format of this 'stat' JSON string is conform for use in the 'PUSH_DATA' message
-// The function return the pointer to 'end of stream + 1' for updated stream or NULL in case of error 
-// The calling function MUST ensure that 'pStreamData' buffer length is at least 170 bytes (for 16-bit counters)
-// or 190 bytes (for 32-bit counters)
-
-BYTE * CSemtechProtocolEngine_GetStatStream(CSemtechProtocolEngine *this, BYTE *pStreamData)
+// The function returns the pointer to 'end of stream + 1' for updated stream or NULL in case of error 
+// (typically end of buffer reached)
+// Note: The 'pStreamEnd' parameter is the end of 'pStreamData' buffer (i.e. pointer to 'last byte + 1')
+BYTE * CSemtechProtocolEngine_GetStatStream(CSemtechProtocolEngine *this, BYTE *pStreamData, BYTE *pStreamEnd)
 {
-  struct tm *tmTime;
+  CJsonWriterOb Writer;
   time_t timeNow;
-  BYTE pTempBuffer[64];
-  WORD wLength;
-  BYTE *pStreamHead;
-  double dTempValue;
-
-  pStreamHead = pStreamData;
-
-  memcpy(pStreamHead, (void *)"{\"stat\":{", 9);
-  pStreamHead += 9;
+  BYTE *pTime;
+  DWORD dwAckRatio;
+  DWORD dwUpnbCount;
+  QWORD qwAckTenths;
 
-  #if (SEMTECHPROTOCOLENGINE_DEBUG_LEVEL0)
-    DEBUG_PRINT_LN("[WARNING] CSemtechProtocolEngine_GetStatStream- TO DO: improve timestamp management");
-  #endif
+  CJsonWriter_Initialize(&Writer, pStreamData, pStreamEnd);
 
   // Gateway system time
   // UTC 'system' time of the gateway, ISO 8601 'expanded' format (23 useful chars)
-
-  // Split the UNIX timestamp to its calendar components 
   time(&timeNow);
-  tmTime = gmtime(&timeNow);
-  sprintf((char*) pTempBuffer, "\"time\":\"%04i-%02i-%02i %02i:%02i:%02i GMT\"", (tmTime->tm_year) + 1900,
-          (tmTime->tm_mon) + 1, tmTime->tm_mday, tmTime->tm_hour, tmTime->tm_min, tmTime->tm_sec);
-  memcpy(pStreamHead, pTempBuffer, wLength = strlen((char*) pTempBuffer));
-  pStreamHead += wLength;
+  pTime = CSemtechProtocolEngine_GetIsoTime(this, (DWORD) timeNow);
+  JSONWRITER_WRITE_LITERAL(&Writer, "{\"stat\":{\"time\":\"");
+  CJsonWriter_WriteBytes(&Writer, pTime, 10);
+  CJsonWriter_WriteByte(&Writer, ' ');
+  CJsonWriter_WriteBytes(&Writer, pTime + 11, 8);
+  JSONWRITER_WRITE_LITERAL(&Writer, " GMT\"");
 
   // GPS latitude of the gateway in degree (float, precision 5 decimals, North is +)
-  memcpy(pStreamHead, ",\"lati\":", 8);
-  pStreamHead += 8;
-  memcpy(pStreamHead, this->m_strGatewayLatitude, this->m_wGatewayLatitudeLength);
-  pStreamHead += this->m_wGatewayLatitudeLength;
+  JSONWRITER_WRITE_LITERAL(&Writer, ",\"lati\":");
+  CJsonWriter_WriteBytes(&Writer, this->m_strGatewayLatitude, this->m_wGatewayLatitudeLength);
 
   // GPS latitude of the gateway in degree (float, precision 5 decimals, East is +)
-  memcpy(pStreamHead, ",\"long\":", 8);
-  pStreamHead += 8;
-  memcpy(pStreamHead, this->m_strGatewayLongitude, this->m_wGatewayLongitudeLength);
-  pStreamHead += this->m_wGatewayLongitudeLength;
+  JSONWRITER_WRITE_LITERAL(&Writer, ",\"long\":");
+  CJsonWriter_WriteBytes(&Writer, this->m_strGatewayLongitude, this->m_wGatewayLongitudeLength);
   
   // GPS altitude of the gateway in meter RX (integer)
-  memcpy(pStreamHead, ",\"alti\":", 8);
-  pStreamHead += 8;
-  memcpy(pStreamHead, this->m_strGatewayAltitude, this->m_wGatewayAltitudeLength);
-  pStreamHead += this->m_wGatewayAltitudeLength;
+  JSONWRITER_WRITE_LITERAL(&Writer, ",\"alti\":");
+  CJsonWriter_WriteBytes(&Writer, this->m_strGatewayAltitude, this->m_wGatewayAltitudeLength);
 
   // Number of radio packets received from nodes (unsigned integer)
-  sprintf((char*) pTempBuffer, ",\"rxnb\":%u", this->m_dwRxnbCount);
-  memcpy(pStreamHead, pTempBuffer, wLength = strlen((char*) pTempBuffer));
-  pStreamHead += wLength;
+  JSONWRITER_WRITE_LITERAL(&Writer, ",\"rxnb\":");
+  CJsonWriter_WriteUnsigned(&Writer, this->m_dwRxnbCount);
 
   // Number of radio packets received from nodes with a valid PHY CRC (unsigned integer)
-  sprintf((char*) pTempBuffer, ",\"rxok\":%u", this->m_dwRxokCount);
-  memcpy(pStreamHead, pTempBuffer, wLength = strlen((char*) pTempBuffer));
-  pStreamHead += wLength;
+  JSONWRITER_WRITE_LITERAL(&Writer, ",\"rxok\":");
+  CJsonWriter_WriteUnsigned(&Writer, this->m_dwRxokCount);
 
   // Number of radio packets forwarded to Network Server (unsigned integer)
-  sprintf((char*) pTempBuffer, ",\"rxfw\":%u", this->m_dwRxfwCount);
-  memcpy(pStreamHead, pTempBuffer, wLength = strlen((char*) pTempBuffer));
-  pStreamHead += wLength;
+  JSONWRITER_WRITE_LITERAL(&Writer, ",\"rxfw\":");
+  CJsonWriter_WriteUnsigned(&Writer, __atomic_load_n(&this->m_dwRxfwCount, __ATOMIC_RELAXED));
 
   // Percentage of upstream datagrams that were acknowledged (float, precision 1 decimal)
-  if (this->m_dwUpnbCount == 0)
+  // Note: Computed in tenths of percent with integers, halfway cases rounded to even digit
+  //       (i.e. exact ratio, no rounding error of floating point)
+  dwUpnbCount = __atomic_load_n(&this->m_dwUpnbCount, __ATOMIC_RELAXED);
+  if (dwUpnbCount == 0)
   {
-    dTempValue = 100;
+    dwAckRatio = 1000;
   }
   else
   {
-    dTempValue = ((double) this->m_dwAckrCount * 100) / this->m_dwUpnbCount;
+    qwAckTenths = (QWORD) this->m_dwAckrCount * 1000;
+    dwAckRatio = (DWORD) (qwAckTenths / dwUpnbCount);
+    qwAckTenths = 2 * (qwAckTenths % dwUpnbCount);
+    if ((qwAckTenths > dwUpnbCount) || ((qwAckTenths == dwUpnbCount) && ((dwAckRatio & 1) != 0)))
+    {
+      ++dwAckRatio;
+    }
   }
-  sprintf((char*) pTempBuffer, ",\"ackr\":%.1f", dTempValue); 
-
-  memcpy(pStreamHead, pTempBuffer, wLength = strlen((char*) pTempBuffer));
-  pStreamHead += wLength;
+  JSONWRITER_WRITE_LITERAL(&Writer, ",\"ackr\":");
+  CJsonWriter_WriteFixed(&Writer, dwAckRatio, 1);
 
   // Number of downlink datagrams received (unsigned integer)
-  sprintf((char*) pTempBuffer, ",\"dwnb\":%u", this->m_dwDwnbCount);
-  memcpy(pStreamHead, pTempBuffer, wLength = strlen((char*) pTempBuffer));
-  pStreamHead += wLength;
+  JSONWRITER_WRITE_LITERAL(&Writer, ",\"dwnb\":");
+  CJsonWriter_WriteUnsigned(&Writer, this->m_dwDwnbCount);
 
   // Number of radio packets emitted to nodes (unsigned integer)
-  sprintf((char*) pTempBuffer, ",\"txnb\":%u}}", this->m_dwTxnbCount);
-  memcpy(pStreamHead, pTempBuffer, wLength = strlen((char*) pTempBuffer));
-  pStreamHead += wLength;
+  JSONWRITER_WRITE_LITERAL(&Writer, ",\"txnb\":");
+  CJsonWriter_WriteUnsigned(&Writer, this->m_dwTxnbCount);
+  JSONWRITER_WRITE_LITERAL(&Writer, "}}");
+
+  return CJsonWriter_End(&Writer);
+}
+
+// Appends a LoRa packet to the 'rxpk' array of a PUSH_DATA message previously built for LoRa data
+// The message is identified by 'm_pMessageData', 'm_wMessageLength' and 'm_dwProtocolMessageId' in parameters.
+// The function returns 'false' without modifying the message stream if the LoRa packet cannot be added (typically
+// 'm_wMaxMessageLength' reached). In this case, the caller must send the message and build a new one for the packet.
+// Note: The LoRa packet is added to the transaction of the message (i.e. a single ACK terminates the transaction
+//       for all LoRa packets)
+bool CSemtechProtocolEngine_AppendUplinkPacket(CSemtechProtocolEngine *this, 
+                                               CNetworkServerProtocolItf_BuildUplinkMessageParams pParams)
+{
+  CSemtechMessageTransaction pMessageTransaction;
+  WORD wBlockIndex;
+  BYTE *pStreamHead;
+  BYTE *pStreamTail;
+
+  // Retrieve the transaction of the message (built by a previous call for the first LoRa packet)
+  wBlockIndex = (((WORD) pParams->m_dwProtocolMessageId) & SEMTECHPROTOCOLENGINE_TRANSACTION_ID_MASK);
+  pMessageTransaction = CWideMemoryBlockArray_BlockPtrFromIndex(this->m_pTransactionArray, wBlockIndex);
+
+  // Consistency check
+  // Note: The transaction must not be sent yet and must be a PUSH_DATA for LoRa data
+  if ((CWideMemoryBlockArray_IsBlockUsed(this->m_pTransactionArray, wBlockIndex) == false) ||
+      (pMessageTransaction->m_wMessageId != (WORD) pParams->m_dwProtocolMessageId) ||
+      (pMessageTransaction->m_wTransactionState != SEMTECHPROTOCOLENGINE_TRANSACTION_STATE_SENDING) ||
+      (pMessageTransaction->m_usLoraPacketNumber == 0))
+  {
+    #if (SEMTECHPROTOCOLENGINE_DEBUG_LEVEL0)
+      DEBUG_PRINT_LN("[ERROR] CSemtechProtocolEngine_AppendUplinkPacket- Unable to retrieve transaction for LoRa data message");
+    #endif
+    return false;
+  }
+
+  // The message stream ends with the closing of 'rxpk' array and of JSON object (i.e. ']}')
+  pStreamTail = pParams->m_pMessageData + pParams->m_wMessageLength - 2;
+  if ((pParams->m_wMessageLength < 14) || (*pStreamTail != ']') || (*(pStreamTail + 1) != '}'))
+  {
+    #if (SEMTECHPROTOCOLENGINE_DEBUG_LEVEL0)
+      DEBUG_PRINT_LN("[ERROR] CSemtechProtocolEngine_AppendUplinkPacket- Invalid message stream");
+    #endif
+    return false;
+  }
+
+  // Add the 'rxpk' object in array
+  // Note: 2 bytes reserved for end of serialization
+  pStreamHead = pStreamTail;
+  *(pStreamHead++) = ',';
+
+  if ((pStreamHead = CSemtechProtocolEngine_GetRxpkStream(this, pStreamHead, 
+                       pParams->m_pMessageData + pParams->m_wMaxMessageLength - 2,
+                       pParams->m_pLoraPacket, pParams->m_pLoraPacketInfo)) == NULL)
+  {
+    // LoRa packet not added (typically max message length reached), restore end of message stream
+    #if (SEMTECHPROTOCOLENGINE_DEBUG_LEVEL1)
+      DEBUG_PRINT_LN("[INFO] CSemtechProtocolEngine_AppendUplinkPacket- LoRa packet not appended to message");
+    #endif
+    *pStreamTail = ']';
+    *(pStreamTail + 1) = '}';
+    return false;
+  }
+
+  // End of 'rxpk' array serialization
+  *(pStreamHead++) = ']'; 
+  *(pStreamHead++) = '}'; 
+  pParams->m_wMessageLength = (WORD) (pStreamHead - pParams->m_pMessageData);
+
+  // Update counters for LoRa packets received from nodes
+  ++this->m_dwRxnbCount;
+  ++this->m_dwRxokCount;
+  ++pMessageTransaction->m_usLoraPacketNumber;
+
+  #if (SEMTECHPROTOCOLENGINE_DEBUG_LEVEL2)
+    DEBUG_PRINT("[DEBUG] CSemtechProtocolEngine_AppendUplinkPacket- LoRa packet appended, packets in message: ");
+    DEBUG_PRINT_DEC((DWORD) pMessageTransaction->m_usLoraPacketNumber);
+    DEBUG_PRINT(", message stream size: ");
+    DEBUG_PRINT_DEC((DWORD) pParams->m_wMessageLength);
+    DEBUG_PRINT_CR;
+  #endif
+
+  return true;
+}
+
+// Builds one 'rxpk' JSON object (i.e. one entry of 'rxpk' array) for the specified LoRa packet
+// The function returns the pointer to 'end of stream + 1' for updated stream or NULL in case of error 
+// (typically end of buffer reached)
+// Note: The 'pStreamEnd' parameter is the end of 'pStreamData' buffer (i.e. pointer to 'last byte + 1')
+BYTE * CSemtechProtocolEngine_GetRxpkStream(CSemtechProtocolEngine *this, BYTE *pStreamData, BYTE *pStreamEnd,
+                                            CLoraTransceiverItf_LoraPacket pLoraPacket, 
+                                            CLoraTransceiverItf_ReceivedLoraPacketInfo pPacketInfo)
+{
+  CJsonWriterOb Writer;
+
+  CJsonWriter_Initialize(&Writer, pStreamData, pStreamEnd);
+
+  // RAW timestamp, 8-17 useful chars
+  // Internal timestamp of "RX finished" event (32bit unsigned)
+  // Note: Low 32 bits of gateway clock in microseconds (i.e. wraps every ~71 minutes as
+  //       expected by Network Server)
+  JSONWRITER_WRITE_LITERAL(&Writer, "{\"tmst\":");
+  CJsonWriter_WriteUnsigned(&Writer, (DWORD) pLoraPacket->m_qwTimestamp);
+
+  // Packet RX time 
+  // UTC time of pkt RX, microsecond precision, ISO 8601 'compact' format (37 useful chars)
+  // Note: The date and time part is converted once per second (cached)
+  JSONWRITER_WRITE_LITERAL(&Writer, ",\"time\":\"");
+  CJsonWriter_WriteBytes(&Writer, CSemtechProtocolEngine_GetIsoTime(this, pPacketInfo->m_dwUTCSec), 19);
+  CJsonWriter_WriteByte(&Writer, '.');
+  CJsonWriter_WriteDigits(&Writer, pPacketInfo->m_dwUTCMicroSec, 6);
+  JSONWRITER_WRITE_LITERAL(&Writer, "Z\"");
+
+  // RX central frequency in MHz (unsigned float, Hz precision)
+  JSONWRITER_WRITE_LITERAL(&Writer, ",\"freq\":");
+  CJsonWriter_WriteString(&Writer, pPacketInfo->m_szFrequency);
+
+  // Packet modulation, 13-14 useful chars 
+  JSONWRITER_WRITE_LITERAL(&Writer, ",\"modu\":\"LORA\"");
+
+  // Lora datarate and bandwidth, 16-19 useful chars
+  // LoRa datarate identifier (eg. SF12BW500) 
+  JSONWRITER_WRITE_LITERAL(&Writer, ",\"datr\":\"");
+  CJsonWriter_WriteString(&Writer, pPacketInfo->m_szDataRate);
+
+  // Lora coding rate, 13 useful chars
+  // LoRa coding rate identifier (eg. 4/5) 
+  JSONWRITER_WRITE_LITERAL(&Writer, "\",\"codr\":\"");
+  CJsonWriter_WriteString(&Writer, pPacketInfo->m_szCodingRate);
+
+  // Lora SNR, 11-13 useful chars 
+  // Lora SNR ratio in dB (signed float, 0.1 dB precision)
+  JSONWRITER_WRITE_LITERAL(&Writer, "\",\"lsnr\":");
+  CJsonWriter_WriteString(&Writer, pPacketInfo->m_szSNR);
+
+  // Packet RSSI and payload size, 18-23 useful chars
+  //  - RSSI in dBm (signed integer, 1 dB precision)
+  //  - RF packet payload size in bytes (unsigned integer)
+  JSONWRITER_WRITE_LITERAL(&Writer, ",\"rssi\":");
+  CJsonWriter_WriteString(&Writer, pPacketInfo->m_szRSSI);
+  JSONWRITER_WRITE_LITERAL(&Writer, ",\"size\":");
+  CJsonWriter_WriteUnsigned(&Writer, pLoraPacket->m_dwDataSize);
+
+  // NOTE: The following fields are required by the specification.
+  //       In current version the associated concepts are not implemented dans hardcoded values are provided
+  JSONWRITER_WRITE_LITERAL(&Writer, ",\"chan\":0,\"rfch\":0,\"stat\":1");
+
+  #if (SEMTECHPROTOCOLENGINE_DEBUG_LEVEL2)
+    TRACERING_EVENT(TRACERING_ID_SEMTECH_RXPK, pLoraPacket->m_dwDataSize,
+                    TRACERING_BYTES(pLoraPacket->m_usData, pLoraPacket->m_dwDataSize, 0),
+                    TRACERING_BYTES(pLoraPacket->m_usData, pLoraPacket->m_dwDataSize, 4),
+                    TRACERING_BYTES(pLoraPacket->m_usData, pLoraPacket->m_dwDataSize, 8));
+  #endif
+
+  // Packet Base64 encoded RF payload padded, 14-350 useful chars
+  JSONWRITER_WRITE_LITERAL(&Writer, ",\"data\":\"");
+  CJsonWriter_WriteBase64(&Writer, pLoraPacket->m_usData, (WORD) pLoraPacket->m_dwDataSize);
+
+  // End of packet serialization
+  JSONWRITER_WRITE_LITERAL(&Writer, "\"}");
+
+  #if (SEMTECHPROTOCOLENGINE_DEBUG_LEVEL0)
+    if (Writer.m_bOverflow == true)
+    {
+      DEBUG_PRINT_LN("[WARNING] CSemtechProtocolEngine_GetRxpkStream- buffer to small to encode LoRa packet");
+    }
+  #endif
+
+  return CJsonWriter_End(&Writer);
+}
+
+// Returns the ISO 8601 representation of the specified UTC time, without fractional seconds and time zone
+// (i.e. 'YYYY-MM-DDTHH:MM:SS', 19 chars, not null terminated)
+// Note: The conversion is cached (i.e. calendar conversion executed only when the second changes)
+BYTE * CSemtechProtocolEngine_GetIsoTime(CSemtechProtocolEngine *this, DWORD dwUTCSec)
+{
+  CJsonWriterOb Writer;
+  struct tm tmTime;
+  time_t timeValue;
+
+  if (dwUTCSec != this->m_dwIsoTimeSec)
+  {
+    // Split the UNIX timestamp to its calendar components
+    timeValue = (time_t) dwUTCSec;
+    gmtime_r(&timeValue, &tmTime);
+
+    CJsonWriter_Initialize(&Writer, this->m_strIsoTime, this->m_strIsoTime + sizeof(this->m_strIsoTime));
+    CJsonWriter_WriteDigits(&Writer, tmTime.tm_year + 1900, 4);
+    CJsonWriter_WriteByte(&Writer, '-');
+    CJsonWriter_WriteDigits(&Writer, tmTime.tm_mon + 1, 2);
+    CJsonWriter_WriteByte(&Writer, '-');
+    CJsonWriter_WriteDigits(&Writer, tmTime.tm_mday, 2);
+    CJsonWriter_WriteByte(&Writer, 'T');
+    CJsonWriter_WriteDigits(&Writer, tmTime.tm_hour, 2);
+    CJsonWriter_WriteByte(&Writer, ':');
+    CJsonWriter_WriteDigits(&Writer, tmTime.tm_min, 2);
+    CJsonWriter_WriteByte(&Writer, ':');
+    CJsonWriter_WriteDigits(&Writer, tmTime.tm_sec, 2);
+
+    this->m_dwIsoTimeSec = dwUTCSec;
+  }
+  return this->m_strIsoTime;
+}
+
+// Decodes the 'txpk' object of PULL_RESP message
+// The LoRa packet payload is Base64 decoded directly in 'm_pData' buffer of 'pParams' and the transmission
+// parameters are stored in 'm_DownlinkPacketInfo'
+// The function returns 'false' if the stream is not a valid 'txpk' object for LoRa modulation
+// Note: The 'pStreamEnd' parameter is the end of 'pStreamData' stream (i.e. pointer to 'last byte + 1')
+bool CSemtechProtocolEngine_ParseTxpkStream(CSemtechProtocolEngine *this, const BYTE *pStreamData, const BYTE *pStreamEnd,
+                                            CNetworkServerProtocolItf_ProcessServerMessageParams pParams)
+{
+  CJsonReaderOb Reader;
+  CJsonTokenOb Name;
+  CJsonTokenOb Value;
+  CNetworkServerProtocolItf_DownlinkPacketInfo pPacketInfo = &pParams->m_DownlinkPacketInfo;
+  BYTE usFields = 0;
+  DWORD dwValue;
+  DWORD dwSize = 0xFFFFFFFF;
+  WORD wLength;
+
+  // Search the 'txpk' object (i.e. the only member expected in PULL_RESP message)
+  if (CJsonReader_Initialize(&Reader, pStreamData, pStreamEnd) == false)
+  {
+    return false;
+  }
+  do
+  {
+    if (CJsonReader_NextMember(&Reader, &Name, &Value) == false)
+    {
+      return false;
+    }
+  } while (!JSONREADER_TOKEN_EQUALS(&Name, "txpk"));
+
+  if (CJsonReader_InitializeFromToken(&Reader, &Value) == false)
+  {
+    return false;
+  }
+
+  pPacketInfo->m_bImmediate = false;
+  pPacketInfo->m_dwTimestamp = 0;
+  pPacketInfo->m_usPower = SEMTECHPROTOCOLENGINE_TXPK_DEFAULT_POWER;
+
+  // Read the 'txpk' fields
+  // Note: Fields not used by the gateway are ignored (e.g. 'rfch', 'ipol', 'prea', 'ncrc')
+  while (CJsonReader_NextMember(&Reader, &Name, &Value) == true)
+  {
+    if (JSONREADER_TOKEN_EQUALS(&Name, "imme"))
+    {
+      // Send packet immediately (will ignore tmst & time)
+      if (CJsonToken_GetBool(&Value, &pPacketInfo->m_bImmediate) == false)
+      {
+        return false;
+      }
+      if (pPacketInfo->m_bImmediate == true)
+      {
+        usFields |= SEMTECHPROTOCOLENGINE_TXPK_FIELD_TIME;
+      }
+    }
+    else if (JSONREADER_TOKEN_EQUALS(&Name, "tmst"))
+    {
+      // Send packet on a certain timestamp value (will ignore time)
+      if (CJsonToken_GetUnsigned(&Value, &pPacketInfo->m_dwTimestamp) == false)
+      {
+        return false;
+      }
+      usFields |= SEMTECHPROTOCOLENGINE_TXPK_FIELD_TIME;
+    }
+    else if (JSONREADER_TOKEN_EQUALS(&Name, "freq"))
+    {
+      // TX central frequency in MHz (unsigned float, Hz precision)
+      if (CJsonToken_GetFixed(&Value, 6, &pPacketInfo->m_dwFrequency) == false)
+      {
+        return false;
+      }
+      usFields |= SEMTECHPROTOCOLENGINE_TXPK_FIELD_FREQ;
+    }
+    else if (JSONREADER_TOKEN_EQUALS(&Name, "powe"))
+    {
+      // TX output power in dBm (unsigned integer, dBm precision)
+      if ((CJsonToken_GetUnsigned(&Value, &dwValue) == false) || (dwValue > 0xFF))
+      {
+        return false;
+      }
+      pPacketInfo->m_usPower = (BYTE) dwValue;
+    }
+    else if (JSONREADER_TOKEN_EQUALS(&Name, "modu"))
+    {
+      // Modulation identifier "LORA" or "FSK" (only LoRa supported by gateway)
+      if ((Value.m_usType != JSONREADER_TOKEN_STRING) || !JSONREADER_TOKEN_EQUALS(&Value, "LORA"))
+      {
+        return false;
+      }
+    }
+    else if (JSONREADER_TOKEN_EQUALS(&Name, "datr"))
+    {
+      // LoRa datarate identifier (eg. SF12BW500)
+      if (CSemtechProtocolEngine_ParseDataRate(&Value, &pPacketInfo->m_usSpreadingFactor, &pPacketInfo->m_wBandwidth) == false)
+      {
+        return false;
+      }
+      usFields |= SEMTECHPROTOCOLENGINE_TXPK_FIELD_DATR;
+    }
+    else if (JSONREADER_TOKEN_EQUALS(&Name, "codr"))
+    {
+      // LoRa ECC coding rate identifier (eg. 4/5)
+      if ((Value.m_usType != JSONREADER_TOKEN_STRING) || (Value.m_wLength != 3) || 
+          (Value.m_pData[0] != '4') || (Value.m_pData[1] != '/') || (Value.m_pData[2] < '5') || (Value.m_pData[2] > '8'))
+      {
+        return false;
+      }
+      pPacketInfo->m_usCodingRate = Value.m_pData[2] - '0';
+      usFields |= SEMTECHPROTOCOLENGINE_TXPK_FIELD_CODR;
+    }
+    else if (JSONREADER_TOKEN_EQUALS(&Name, "size"))
+    {
+      // RF packet payload size in bytes (unsigned integer)
+      // Note: Checked when all fields are read (i.e. order of fields not specified)
+      if (CJsonToken_GetUnsigned(&Value, &dwSize) == false)
+      {
+        return false;
+      }
+    }
+    else if (JSONREADER_TOKEN_EQUALS(&Name, "data"))
+    {
+      // Base64 encoded RF packet payload, padding optional
+      if ((wLength = CJsonToken_GetBase64(&Value, pParams->m_pData, pParams->m_wMaxLoraPacketLength)) == 0xFFFF)
+      {
+        return false;
+      }
+      pParams->m_wLoraPacketLength = wLength;
+      usFields |= SEMTECHPROTOCOLENGINE_TXPK_FIELD_DATA;
+    }
+  }
+
+  if ((Reader.m_bError == true) || (usFields != SEMTECHPROTOCOLENGINE_TXPK_FIELDS_REQUIRED))
+  {
+    return false;
+  }
+  if ((dwSize != 0xFFFFFFFF) && (dwSize != pParams->m_wLoraPacketLength))
+  {
+    return false;
+  }
+  return true;
+}
+
+// Decodes the LoRa datarate identifier (i.e. 'SFnnBWmmm' string)
+bool CSemtechProtocolEngine_ParseDataRate(CJsonToken pToken, BYTE *pusSpreadingFactor, WORD *pwBandwidth)
+{
+  CJsonTokenOb Number;
+  const BYTE *pEnd = pToken->m_pData + pToken->m_wLength;
+  DWORD dwSpreadingFactor;
+  DWORD dwBandwidth;
+
+  if ((pToken->m_usType != JSONREADER_TOKEN_STRING) || (pToken->m_wLength < 6) || 
+      (pToken->m_pData[0] != 'S') || (pToken->m_pData[1] != 'F'))
+  {
+    return false;
+  }
+
+  // The numbers are converted using tokens pointing to their digits
+  Number.m_usType = JSONREADER_TOKEN_NUMBER;
+  Number.m_pData = pToken->m_pData + 2;
+  Number.m_wLength = 0;
+  while ((Number.m_pData + Number.m_wLength < pEnd) && (Number.m_pData[Number.m_wLength] != 'B'))
+  {
+    ++Number.m_wLength;
+  }
+  if ((Number.m_pData + Number.m_wLength + 2 >= pEnd) || (Number.m_pData[Number.m_wLength + 1] != 'W') ||
+      (CJsonToken_GetUnsigned(&Number, &dwSpreadingFactor) == false))
+  {
+    return false;
+  }
 
-  return pStreamHead;
+  Number.m_pData += Number.m_wLength + 2;
+  Number.m_wLength = (WORD) (pEnd - Number.m_pData);
+  if (CJsonToken_GetUnsigned(&Number, &dwBandwidth) == false)
+  {
+    return false;
+  }
+
+  if ((dwSpreadingFactor < 6) || (dwSpreadingFactor > 12) || 
+      ((dwBandwidth != 125) && (dwBandwidth != 250) && (dwBandwidth != 500)))
+  {
+    return false;
+  }
+  *pusSpreadingFactor = (BYTE) dwSpreadingFactor;
+  *pwBandwidth = (WORD) dwBandwidth;
+  return true;
 }
 
+
+// Switches the state of transaction if the current state is 'wFromState'
+// Note: Atomic operation (i.e. state may be updated by tasks invoking 'ProcessServerMessage' and 'ProcessSessionEvent')
+bool CSemtechProtocolEngine_SwitchTransactionState(CSemtechMessageTransaction pMessageTransaction, WORD wFromState, WORD wToState)
+{
+  return __atomic_compare_exchange_n(&pMessageTransaction->m_wTransactionState, &wFromState, wToState, false,
+                                     __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+}
+
+// Inserts the transaction in the timer wheel (i.e. waiting for ACK until 'CONFIG_SEMTECH_ACK_TIMEOUT')
+void CSemtechProtocolEngine_StartTransactionTimer(CSemtechProtocolEngine *this, CSemtechMessageTransaction pMessageTransaction)
+{
+  CSemtechMessageTransaction pNextTransaction;
+  WORD wSlot;
+
+  pMessageTransaction->m_dwExpiryTicks = pMessageTransaction->m_dwLastEventTicks + pdMS_TO_TICKS(CONFIG_SEMTECH_ACK_TIMEOUT);
+  wSlot = (WORD) (SEMTECHPROTOCOLENGINE_TIMERWHEEL_SLOT(pMessageTransaction->m_dwExpiryTicks) & SEMTECHPROTOCOLENGINE_TIMERWHEEL_SLOT_MASK);
+
+  // Insert at head of slot list
+  pMessageTransaction->m_wTimerSlot = wSlot;
+  pMessageTransaction->m_wPrevTimerId = SEMTECHPROTOCOLENGINE_TIMERWHEEL_NONE;
+  pMessageTransaction->m_wNextTimerId = this->m_wTimerWheel[wSlot];
+  if (pMessageTransaction->m_wNextTimerId != SEMTECHPROTOCOLENGINE_TIMERWHEEL_NONE)
+  {
+    pNextTransaction = CWideMemoryBlockArray_BlockPtrFromIndex(this->m_pTransactionArray, pMessageTransaction->m_wNextTimerId);
+    pNextTransaction->m_wPrevTimerId = pMessageTransaction->m_wTransactionId;
+  }
+  this->m_wTimerWheel[wSlot] = pMessageTransaction->m_wTransactionId;
+}
+
+// Removes the transaction from the timer wheel (if present)
+void CSemtechProtocolEngine_StopTransactionTimer(CSemtechProtocolEngine *this, CSemtechMessageTransaction pMessageTransaction)
+{
+  CSemtechMessageTransaction pLinkedTransaction;
+
+  if (pMessageTransaction->m_wTimerSlot == SEMTECHPROTOCOLENGINE_TIMERWHEEL_NONE)
+  {
+    return;
+  }
+
+  if (pMessageTransaction->m_wPrevTimerId == SEMTECHPROTOCOLENGINE_TIMERWHEEL_NONE)
+  {
+    this->m_wTimerWheel[pMessageTransaction->m_wTimerSlot] = pMessageTransaction->m_wNextTimerId;
+  }
+  else
+  {
+    pLinkedTransaction = CWideMemoryBlockArray_BlockPtrFromIndex(this->m_pTransactionArray, pMessageTransaction->m_wPrevTimerId);
+    pLinkedTransaction->m_wNextTimerId = pMessageTransaction->m_wNextTimerId;
+  }
+
+  if (pMessageTransaction->m_wNextTimerId != SEMTECHPROTOCOLENGINE_TIMERWHEEL_NONE)
+  {
+    pLinkedTransaction = CWideMemoryBlockArray_BlockPtrFromIndex(this->m_pTransactionArray, pMessageTransaction->m_wNextTimerId);
+    pLinkedTransaction->m_wPrevTimerId = pMessageTransaction->m_wPrevTimerId;
+  }
+
+  pMessageTransaction->m_wTimerSlot = SEMTECHPROTOCOLENGINE_TIMERWHEEL_NONE;
+}
+
+
 DWORD CSemtechProtocolEngine_GetElapsedTicks(DWORD dwCurrentTicks, DWORD dwPreviousTicks)
 {
   if (dwCurrentTicks < dwPreviousTicks)
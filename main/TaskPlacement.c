@@ -0,0 +1,312 @@
+/*****************************************************************************************//**
+ * @file     TaskPlacement.c
+ *
+ * @author   F.Fargon
+ *
+ * @version  V1.0
+ *
+ * @date     16/10/2026
+ *
+ * @brief    Placement of gateway RTOS tasks on ESP32 cores.
+ *
+ * @details  This file implements the following classes or functions:\n
+ *            - Creation of gateway tasks using the central placement table
+ *            - Monitor task for per-core utilisation and task latency traces
+*********************************************************************************************/
+
+
+/*********************************************************************************************
+  Espressif framework includes
+*********************************************************************************************/
+
+#include <Common.h>
+
+
+/*********************************************************************************************
+  Includes for objects implementation
+*********************************************************************************************/
+
+#include "TaskPlacement.h"
+
+// The placement table is defined in the configuration file
+#define TASKPLACEMENTCONFIG_IMPL
+
+#include "Configuration.h"
+
+
+/*********************************************************************************************
+ TaskPlacement functions
+
+ Central placement of the gateway tasks
+
+ Notes:
+  - See TaskPlacement.h for description of traces
+  - The statistics of the SX1276 task are shared by all 'CSX1276' objects (i.e. updated with
+    atomic operations, the maximum latency may miss a concurrent update)
+*********************************************************************************************/
+
+// Statistics of gateway tasks
+static CTaskPlacementStatOb g_TaskPlacementStats[TASKPLACEMENT_TASK_NUMBER];
+
+#if defined(ESP_PLATFORM) && (configGENERATE_RUN_TIME_STATS == 1) && (configUSE_TRACE_FACILITY == 1)
+
+// RTOS task states read by monitor task (i.e. not allocated on monitor stack)
+static TaskStatus_t g_TaskPlacementTaskStatus[TASKPLACEMENT_MAX_TRACED_TASKS];
+
+// Run time counters of idle tasks and total run time at previous trace
+static DWORD g_dwTaskPlacementPrevIdleTime[TASKPLACEMENT_CORE_NUMBER];
+static DWORD g_dwTaskPlacementPrevTotalTime;
+
+#endif
+
+
+/*****************************************************************************************//**
+ * @fn         bool CTaskPlacement_CreateTask(BYTE usTaskId, TaskFunction_t pTaskFunction,
+ *                                            void *pParams, TaskHandle_t *pTaskHandle)
+ *
+ * @brief      Creates a gateway task using its entry in placement table.
+ *
+ * @details    The task is created on the core, with the priority and stack size, defined in
+ *             the 'g_TaskPlacementTable' entry of the task.
+ *
+ * @param      usTaskId
+ *             The identifier of the task ('TASKPLACEMENT_TASK_xxx').
+ *
+ * @param      pTaskFunction
+ *             The RTOS task function.
+ *
+ * @param      pParams
+ *             The parameter of task function (typically the owner object).
+ *
+ * @param      pTaskHandle
+ *             The variable receiving the handle of created task.
+ *
+ * @return     The function returns 'true' if the task is created.
+ *
+ * @note       On Linux host, the core is ignored.
+*********************************************************************************************/
+bool CTaskPlacement_CreateTask(BYTE usTaskId, TaskFunction_t pTaskFunction, void *pParams, TaskHandle_t *pTaskHandle)
+{
+  const CTaskPlacementEntryOb *pEntry;
+  BaseType_t xResult;
+
+  if (usTaskId >= TASKPLACEMENT_TASK_NUMBER)
+  {
+    // Should never occur
+    #if (TASKPLACEMENT_DEBUG_LEVEL0)
+      DEBUG_PRINT_LN("[ERROR] CTaskPlacement_CreateTask, invalid task identifier");
+    #endif
+    return false;
+  }
+
+  pEntry = &(g_TaskPlacementTable[usTaskId]);
+
+  #ifdef ESP_PLATFORM
+    xResult = xTaskCreatePinnedToCore(pTaskFunction, pEntry->m_pszName, pEntry->m_wStackSize, pParams, pEntry->m_usPriority,
+                                      pTaskHandle, (pEntry->m_usCore == TASKPLACEMENT_CORE_ANY) ?
+                                                   tskNO_AFFINITY : (BaseType_t) pEntry->m_usCore);
+  #else
+    // Note: On FreeRTOS POSIX port, the stack size is a number of words and each task is a
+    //       thread (i.e. at least 'configMINIMAL_STACK_SIZE' for 'PTHREAD_STACK_MIN')
+    xResult = xTaskCreate(pTaskFunction, pEntry->m_pszName,
+                          configMINIMAL_STACK_SIZE + (pEntry->m_wStackSize / sizeof(StackType_t)),
+                          pParams, pEntry->m_usPriority, pTaskHandle);
+  #endif
+
+  #if (TASKPLACEMENT_DEBUG_LEVEL1)
+    DEBUG_PRINT("[INFO] CTaskPlacement_CreateTask, task: ");
+    DEBUG_PRINT(pEntry->m_pszName);
+    DEBUG_PRINT(", core: ");
+    DEBUG_PRINT_DEC((DWORD) pEntry->m_usCore);
+    DEBUG_PRINT(", priority: ");
+    DEBUG_PRINT_DEC((DWORD) pEntry->m_usPriority);
+    DEBUG_PRINT(", result: ");
+    DEBUG_PRINT_DEC((DWORD) xResult);
+    DEBUG_PRINT_CR;
+  #endif
+
+  return (xResult == pdPASS);
+}
+
+
+// Records the processing of an event by a task (latency = elapsed time since event timestamp)
+// Note: Typically the IRQ timestamp of a received LoRa packet
+void CTaskPlacement_RecordLatency(BYTE usTaskId, QWORD qwEventTimestamp)
+{
+  CTaskPlacementStat pStat = &(g_TaskPlacementStats[usTaskId]);
+  DWORD dwLatency = (DWORD) (GATEWAY_CLOCK_MICROSEC() - qwEventTimestamp);
+
+  __atomic_fetch_add(&pStat->m_dwLatencySum, dwLatency, __ATOMIC_RELAXED);
+  if (dwLatency > pStat->m_dwLatencyMax)
+  {
+    pStat->m_dwLatencyMax = dwLatency;
+  }
+  __atomic_fetch_add(&pStat->m_dwEventNumber, 1, __ATOMIC_RELEASE);
+}
+
+
+// Starts the monitor task (trace every 'dwPeriod' milliseconds)
+// Note: On ESP32, the monitor is not started if the RTOS run time counters are not enabled (i.e.
+//       'Use FreeRTOS trace facility' and 'Enable FreeRTOS to collect run time stats' in menuconfig)
+bool CTaskPlacement_StartMonitor(DWORD dwPeriod)
+{
+  TaskHandle_t hMonitorTask;
+
+  #if defined(ESP_PLATFORM) && ((configGENERATE_RUN_TIME_STATS != 1) || (configUSE_TRACE_FACILITY != 1))
+    DEBUG_PRINT_LN("[ERROR] CTaskPlacement_StartMonitor, RTOS run time stats or trace facility not enabled in sdkconfig");
+    return false;
+  #endif
+
+  memset(g_TaskPlacementStats, 0, sizeof(g_TaskPlacementStats));
+
+  return CTaskPlacement_CreateTask(TASKPLACEMENT_TASK_MONITOR, CTaskPlacement_MonitorTask, (void *) (uintptr_t) dwPeriod, &hMonitorTask);
+}
+
+
+/*********************************************************************************************
+  Monitor task
+*********************************************************************************************/
+
+void CTaskPlacement_MonitorTask(void *pParams)
+{
+  DWORD dwPeriod = (DWORD) (uintptr_t) pParams;
+  TickType_t xLastWakeTime = xTaskGetTickCount();
+
+  while (true)
+  {
+    vTaskDelayUntil(&xLastWakeTime, pdMS_TO_TICKS(dwPeriod));
+
+    CTaskPlacement_TraceUtilisation(dwPeriod);
+    CTaskPlacement_TraceLatency();
+  }
+}
+
+// Traces the utilisation of each core and the CPU time used by gateway tasks since previous trace
+// Note: The RTOS run time counters are required (i.e. no trace if not enabled in RTOS configuration)
+void CTaskPlacement_TraceUtilisation(DWORD dwPeriod)
+{
+#if defined(ESP_PLATFORM) && (configGENERATE_RUN_TIME_STATS == 1) && (configUSE_TRACE_FACILITY == 1)
+
+  UBaseType_t uxTaskNumber;
+  uint32_t ulTotalRunTime;
+  DWORD dwElapsed;
+  DWORD dwIdleTime[TASKPLACEMENT_CORE_NUMBER];
+  DWORD dwTaskRunTime[TASKPLACEMENT_TASK_NUMBER];
+
+  if ((uxTaskNumber = uxTaskGetSystemState(g_TaskPlacementTaskStatus, TASKPLACEMENT_MAX_TRACED_TASKS, &ulTotalRunTime)) == 0)
+  {
+    #if (TASKPLACEMENT_DEBUG_LEVEL0)
+      DEBUG_PRINT_LN("[WARNING] CTaskPlacement_TraceUtilisation, too many tasks");
+    #endif
+    return;
+  }
+
+  memset(dwIdleTime, 0, sizeof(dwIdleTime));
+  memset(dwTaskRunTime, 0, sizeof(dwTaskRunTime));
+
+  // Cumulated run time of idle task of each core and of gateway tasks
+  // Note: Several tasks may have the same name (i.e. one SX1276 task per transceiver)
+  for (UBaseType_t i = 0; i < uxTaskNumber; i++)
+  {
+    for (BYTE usCore = 0; usCore < TASKPLACEMENT_CORE_NUMBER; usCore++)
+    {
+      if (g_TaskPlacementTaskStatus[i].xHandle == xTaskGetIdleTaskHandleForCPU(usCore))
+      {
+        dwIdleTime[usCore] = g_TaskPlacementTaskStatus[i].ulRunTimeCounter;
+      }
+    }
+
+    for (BYTE usTaskId = 0; usTaskId < TASKPLACEMENT_TASK_NUMBER; usTaskId++)
+    {
+      if (strncmp(g_TaskPlacementTaskStatus[i].pcTaskName, g_TaskPlacementTable[usTaskId].m_pszName,
+                  configMAX_TASK_NAME_LEN - 1) == 0)
+      {
+        dwTaskRunTime[usTaskId] += g_TaskPlacementTaskStatus[i].ulRunTimeCounter;
+        break;
+      }
+    }
+  }
+
+  dwElapsed = ulTotalRunTime - g_dwTaskPlacementPrevTotalTime;
+  g_dwTaskPlacementPrevTotalTime = ulTotalRunTime;
+
+  if (dwElapsed == 0)
+  {
+    return;
+  }
+
+  #if (TASKPLACEMENT_DEBUG_LEVEL0)
+    DEBUG_PRINT("[INFO] Core utilisation (percent):");
+    for (BYTE usCore = 0; usCore < TASKPLACEMENT_CORE_NUMBER; usCore++)
+    {
+      DEBUG_PRINT(" core ");
+      DEBUG_PRINT_DEC((DWORD) usCore);
+      DEBUG_PRINT(": ");
+      DEBUG_PRINT_DEC(100 - (DWORD) ((((QWORD) (dwIdleTime[usCore] - g_dwTaskPlacementPrevIdleTime[usCore])) * 100) / dwElapsed));
+    }
+    DEBUG_PRINT_CR;
+
+    for (BYTE usTaskId = 0; usTaskId < TASKPLACEMENT_TASK_NUMBER; usTaskId++)
+    {
+      DEBUG_PRINT("[INFO]   ");
+      DEBUG_PRINT(g_TaskPlacementTable[usTaskId].m_pszName);
+      DEBUG_PRINT(" (core ");
+      DEBUG_PRINT_DEC((DWORD) g_TaskPlacementTable[usTaskId].m_usCore);
+      DEBUG_PRINT(") CPU (per mille of a core): ");
+      DEBUG_PRINT_DEC((DWORD) ((((QWORD) (dwTaskRunTime[usTaskId] - g_TaskPlacementStats[usTaskId].m_dwPrevRunTime)) * 1000) / dwElapsed));
+      DEBUG_PRINT_CR;
+    }
+  #endif
+
+  for (BYTE usCore = 0; usCore < TASKPLACEMENT_CORE_NUMBER; usCore++)
+  {
+    g_dwTaskPlacementPrevIdleTime[usCore] = dwIdleTime[usCore];
+  }
+  for (BYTE usTaskId = 0; usTaskId < TASKPLACEMENT_TASK_NUMBER; usTaskId++)
+  {
+    g_TaskPlacementStats[usTaskId].m_dwPrevRunTime = dwTaskRunTime[usTaskId];
+  }
+
+#endif
+}
+
+// Traces the latency of events processed by gateway tasks since previous trace
+void CTaskPlacement_TraceLatency()
+{
+  CTaskPlacementStat pStat;
+  DWORD dwEventNumber;
+  DWORD dwLatencySum;
+  DWORD dwLatencyMax;
+
+  for (BYTE usTaskId = 0; usTaskId < TASKPLACEMENT_TASK_NUMBER; usTaskId++)
+  {
+    pStat = &(g_TaskPlacementStats[usTaskId]);
+
+    dwEventNumber = __atomic_load_n(&pStat->m_dwEventNumber, __ATOMIC_ACQUIRE);
+    if (dwEventNumber == pStat->m_dwPrevEventNumber)
+    {
+      // No event for this task
+      continue;
+    }
+
+    dwLatencySum = __atomic_load_n(&pStat->m_dwLatencySum, __ATOMIC_RELAXED);
+    dwLatencyMax = __atomic_exchange_n(&pStat->m_dwLatencyMax, 0, __ATOMIC_RELAXED);
+
+    #if (TASKPLACEMENT_DEBUG_LEVEL0)
+      DEBUG_PRINT("[INFO] Task latency, ");
+      DEBUG_PRINT(g_TaskPlacementTable[usTaskId].m_pszName);
+      DEBUG_PRINT(", events: ");
+      DEBUG_PRINT_DEC(dwEventNumber - pStat->m_dwPrevEventNumber);
+      DEBUG_PRINT(", average (us): ");
+      DEBUG_PRINT_DEC((dwLatencySum - pStat->m_dwPrevLatencySum) / (dwEventNumber - pStat->m_dwPrevEventNumber));
+      DEBUG_PRINT(", max (us): ");
+      DEBUG_PRINT_DEC(dwLatencyMax);
+      DEBUG_PRINT_CR;
+    #else
+      (void) dwLatencyMax;
+    #endif
+
+    pStat->m_dwPrevEventNumber = dwEventNumber;
+    pStat->m_dwPrevLatencySum = dwLatencySum;
+  }
+}
@@ -0,0 +1,247 @@
+/*****************************************************************************************//**
+ * @file     TraceRing.c
+ *
+ * @author   F.Fargon
+ *
+ * @version  V1.0
+ *
+ * @date     16/10/2026
+ *
+ * @brief    Binary trace records for hot paths.
+ *
+ * @details  This file implements the following classes or functions:\n
+ *            - Lock-free trace rings (one per core)
+ *            - Drain task rendering the trace records
+*********************************************************************************************/
+
+
+/*********************************************************************************************
+  Espressif framework includes
+*********************************************************************************************/
+
+#include <Common.h>
+
+
+/*********************************************************************************************
+  Includes for objects implementation
+*********************************************************************************************/
+
+#include "TaskPlacement.h"
+#include "TraceRing.h"
+
+
+/*********************************************************************************************
+  Instantiate global static objects used by module implementation
+*********************************************************************************************/
+
+// Trace rings (statically allocated, i.e. trace points can be used before any initialization)
+static CTraceRingOb g_TraceRings[TRACERING_CORE_NUMBER];
+
+// Format strings of trace events (arguments are 'DWORD')
+static const char * const g_TraceRingEventFormats[TRACERING_ID_NUMBER] =
+  {
+    [TRACERING_ID_SX1276_RX_PACKET] =         "SX1276 RX packet, length: %u, SNR: 0x%02X, RSSI: 0x%02X, IRQ flags: 0x%02X",
+    [TRACERING_ID_SX1276_RX_PAYLOAD] =        "SX1276 RX payload, length: %u, head: %08X %08X %08X",
+    [TRACERING_ID_SX1276_TX_ARM] =            "SX1276 TX armed, length: %u, head: %08X %08X %08X",
+    [TRACERING_ID_SX1276_TX_FIRE] =           "SX1276 TX fired, timestamp: %u",
+    [TRACERING_ID_NODEMANAGER_SESSION] =      "NodeManager session created, id: 0x%08X, DevAddr: 0x%08X, FCnt: %u, type: %u",
+    [TRACERING_ID_SERVERMANAGER_UPLINK] =     "ServerManager uplink, session: 0x%08X, message id: %u, length: %u, timestamp: %u",
+    [TRACERING_ID_SERVERMANAGER_ACCEPTED] =   "ServerManager uplink accepted, session: 0x%08X, message id: %u",
+    [TRACERING_ID_SEMTECH_RXPK] =             "Semtech rxpk, length: %u, head: %08X %08X %08X",
+    [TRACERING_ID_SEMTECH_UPLINK_MESSAGE] =   "Semtech uplink message, length: %u, pending transactions: %u, header: %08X %08X"
+  };
+
+
+/*********************************************************************************************
+ TraceRing functions
+
+ Binary trace of the gateway
+
+ Notes:
+  - See TraceRing.h for description of the ring protocol
+*********************************************************************************************/
+
+/*****************************************************************************************//**
+ * @fn         void CTraceRing_Write(WORD wEventId, DWORD dwArg0, DWORD dwArg1, DWORD dwArg2,
+ *                                   DWORD dwArg3)
+ *
+ * @brief      Writes a trace record in the ring of current core.
+ *
+ * @details    The function reserves the next position of the ring, writes the record and
+ *             commits it (i.e. sequence number written last).\n
+ *             The function never waits (i.e. the oldest record is overwritten when the ring
+ *             is full).
+ *
+ * @param      wEventId
+ *             The identifier of trace event ('TRACERING_ID_xxx').
+ *
+ * @param      dwArg0
+ *             The first argument of trace event (up to 'dwArg3').
+ *
+ * @return     None.
+ *
+ * @note       Typically invoked with the 'TRACERING_EVENT' macro (i.e. compile-time filter).
+*********************************************************************************************/
+void CTraceRing_Write(WORD wEventId, DWORD dwArg0, DWORD dwArg1, DWORD dwArg2, DWORD dwArg3)
+{
+  CTraceRing pRing;
+  CTraceRecord pRecord;
+  DWORD dwPosition;
+
+  #ifdef ESP_PLATFORM
+    pRing = &(g_TraceRings[xPortGetCoreID()]);
+  #else
+    pRing = &(g_TraceRings[0]);
+  #endif
+
+  dwPosition = __atomic_fetch_add(&pRing->m_dwHead, 1, __ATOMIC_RELAXED);
+  pRecord = &(pRing->m_Records[dwPosition & (TRACERING_RECORD_NUMBER - 1)]);
+
+  // Record invalid while written (i.e. drain task detects a partially overwritten record)
+  __atomic_store_n(&pRecord->m_dwSequence, 0, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+
+  pRecord->m_dwTimestamp = (DWORD) GATEWAY_CLOCK_MICROSEC();
+  pRecord->m_wEventId = wEventId;
+  pRecord->m_dwArgs[0] = dwArg0;
+  pRecord->m_dwArgs[1] = dwArg1;
+  pRecord->m_dwArgs[2] = dwArg2;
+  pRecord->m_dwArgs[3] = dwArg3;
+
+  __atomic_store_n(&pRecord->m_dwSequence, dwPosition + 1, __ATOMIC_RELEASE);
+}
+
+
+// Packs 4 bytes of a buffer starting at 'dwOffset' in a trace argument (missing bytes are 0)
+// Note: The first byte is the most significant (i.e. '%08X' renders the bytes in buffer order)
+DWORD CTraceRing_PackBytes(const BYTE *pData, DWORD dwLength, DWORD dwOffset)
+{
+  DWORD dwValue = 0;
+
+  for (DWORD i = dwOffset; i < dwOffset + 4; i++)
+  {
+    dwValue = (dwValue << 8) | ((i < dwLength) ? pData[i] : 0);
+  }
+  return dwValue;
+}
+
+
+// Starts the drain task
+bool CTraceRing_StartDrain()
+{
+  TaskHandle_t hDrainTask;
+
+  return CTaskPlacement_CreateTask(TASKPLACEMENT_TASK_TRACEDRAIN, CTraceRing_DrainTask, NULL, &hDrainTask);
+}
+
+
+// Renders the committed records of all rings
+// Returns the number of rendered records
+// Note: Invoked by drain task (or directly on Linux host, i.e. not used concurrently)
+DWORD CTraceRing_Drain()
+{
+  DWORD dwRendered = 0;
+
+  for (BYTE usCore = 0; usCore < TRACERING_CORE_NUMBER; usCore++)
+  {
+    dwRendered += CTraceRing_DrainRing(&(g_TraceRings[usCore]), usCore);
+  }
+  return dwRendered;
+}
+
+
+/*********************************************************************************************
+  Drain task
+*********************************************************************************************/
+
+void CTraceRing_DrainTask(void *pParams)
+{
+  while (true)
+  {
+    vTaskDelay(pdMS_TO_TICKS(TRACERING_DRAIN_PERIOD));
+    CTraceRing_Drain();
+  }
+}
+
+// Renders the committed records of one ring
+DWORD CTraceRing_DrainRing(CTraceRing pRing, BYTE usCore)
+{
+  CTraceRecordOb Record;
+  CTraceRecord pRecord;
+  DWORD dwHead;
+  DWORD dwSequence;
+  DWORD dwRendered = 0;
+
+  // Records overwritten since previous drain
+  dwHead = __atomic_load_n(&pRing->m_dwHead, __ATOMIC_ACQUIRE);
+  if ((dwHead - pRing->m_dwTail) > TRACERING_RECORD_NUMBER)
+  {
+    pRing->m_dwLostNumber += (dwHead - TRACERING_RECORD_NUMBER) - pRing->m_dwTail;
+    pRing->m_dwTail = dwHead - TRACERING_RECORD_NUMBER;
+  }
+
+  while (pRing->m_dwTail != dwHead)
+  {
+    pRecord = &(pRing->m_Records[pRing->m_dwTail & (TRACERING_RECORD_NUMBER - 1)]);
+
+    dwSequence = __atomic_load_n(&pRecord->m_dwSequence, __ATOMIC_ACQUIRE);
+    if (dwSequence != pRing->m_dwTail + 1)
+    {
+      if ((dwSequence == 0) || ((int32_t) (dwSequence - (pRing->m_dwTail + 1)) < 0))
+      {
+        // Record not yet committed (i.e. rendered at next drain)
+        break;
+      }
+
+      // Record overwritten by a more recent one (i.e. ring wrapped during drain)
+      ++pRing->m_dwLostNumber;
+      ++pRing->m_dwTail;
+      continue;
+    }
+
+    // Copy the record and check that it was not overwritten during copy
+    memcpy(&Record, pRecord, sizeof(CTraceRecordOb));
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if (__atomic_load_n(&pRecord->m_dwSequence, __ATOMIC_RELAXED) != dwSequence)
+    {
+      ++pRing->m_dwLostNumber;
+      ++pRing->m_dwTail;
+      continue;
+    }
+
+    CTraceRing_RenderRecord(&Record, usCore);
+    ++pRing->m_dwTail;
+    ++dwRendered;
+  }
+
+  if (pRing->m_dwLostNumber != pRing->m_dwReportedLostNumber)
+  {
+    printf("[TRACE] core %u, records lost: %u\n", (unsigned int) usCore, (unsigned int) (pRing->m_dwLostNumber - pRing->m_dwReportedLostNumber));
+    pRing->m_dwReportedLostNumber = pRing->m_dwLostNumber;
+  }
+
+  return dwRendered;
+}
+
+// Renders a trace record as a text line
+void CTraceRing_RenderRecord(CTraceRecord pRecord, BYTE usCore)
+{
+  printf("[TRACE] %u %10u ", (unsigned int) usCore, (unsigned int) pRecord->m_dwTimestamp);
+
+  if (pRecord->m_wEventId < TRACERING_ID_NUMBER)
+  {
+    // Note: The format strings of 'g_TraceRingEventFormats' are not literals (i.e. not checked by
+    //       compiler), each one must use at most 4 '%u'/'%X' conversions of 'unsigned int'
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wformat-nonliteral"
+    printf(g_TraceRingEventFormats[pRecord->m_wEventId], (unsigned int) pRecord->m_dwArgs[0], (unsigned int) pRecord->m_dwArgs[1],
+           (unsigned int) pRecord->m_dwArgs[2], (unsigned int) pRecord->m_dwArgs[3]);
+    #pragma GCC diagnostic pop
+  }
+  else
+  {
+    printf("Unknown event %u: %08X %08X %08X %08X", (unsigned int) pRecord->m_wEventId, (unsigned int) pRecord->m_dwArgs[0],
+           (unsigned int) pRecord->m_dwArgs[1], (unsigned int) pRecord->m_dwArgs[2], (unsigned int) pRecord->m_dwArgs[3]);
+  }
+  printf("\n");
+}
@@ -192,3 +192,26 @@ bool ITransceiverManager_SessionEvent(ITransceiverManager this, CTransceiverMana
   return this->m_pOwnerItfImpl->m_pSessionEvent(this->m_pOwnerObject, pEvent);
 }
 
+/*****************************************************************************************//**
+ * @fn         bool ITransceiverManager_SendDownlink(ITransceiverManager this, 
+ *                                        CTransceiverManagerItf_SendDownlinkParams pParams)
+ * 
+ * @brief      Sends a downlink LoRa packet provided by the Network Server.
+ * 
+ * @details    This function invokes the implementation of 'SendDownlink' method on owner object.\n
+ *             The 'SendDownlink' method is invoked by the 'ServerManager' when a LoRa packet
+ *             must be sent to a node at the time requested by the Network Server.
+ * 
+ * @param      this
+ *             The object pointer.
+ *  
+ * @param      pParams
+ *             The method parameters. See 'TransceiverManagerItf.h' for details.
+ *
+ * @return     The function returns 'true' if the packet is scheduled for send or 'false' if
+ *             it is rejected (i.e. reason in 'm_dwResult').
+*********************************************************************************************/
+bool ITransceiverManager_SendDownlink(ITransceiverManager this, CTransceiverManagerItf_SendDownlinkParams pParams)
+{
+  return this->m_pOwnerItfImpl->m_pSendDownlink(this->m_pOwnerObject, pParams);
+}
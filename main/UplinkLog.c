@@ -0,0 +1,644 @@
+/*****************************************************************************************//**
+ * @file     UplinkLog.c
+ *
+ * @author   F.Fargon
+ *
+ * @version  V1.0
+ *
+ * @date     16/10/2026
+ *
+ * @brief    Store-and-forward log for uplink messages.
+ *
+ * @details  This file implements the following classes or functions:\n
+ *            - CUplinkLog = Append-only ring log of encoded uplink messages
+ *            - Storage backends for 'CUplinkLog' (flash partition or file)
+*********************************************************************************************/
+
+
+/*********************************************************************************************
+  Espressif framework includes
+*********************************************************************************************/
+
+#include <Common.h>
+
+#ifdef ESP_PLATFORM
+  #include "esp_partition.h"
+  #include "esp_spi_flash.h"
+#else
+  #include <unistd.h>
+#endif
+
+
+/*********************************************************************************************
+  Includes for objects implementation
+*********************************************************************************************/
+
+#include "UplinkLog.h"
+
+
+/*********************************************************************************************
+ UplinkLog Class
+
+ Append-only ring log for encoded uplink messages
+
+ Notes:
+  - The object is not thread safe (used only by 'ServerManager' task)
+  - See UplinkLog.h for description of storage organization and crash safety
+
+ WARNING: This object cannot be static. It MUST always be allocated by with the construction
+          method ('CUplinkLog_New')
+*********************************************************************************************/
+
+// Private helpers
+static WORD CUplinkLog_Crc16(WORD wCrc, const BYTE *pData, DWORD dwLength);
+static bool CUplinkLog_ReadHeader(CUplinkLog this, DWORD dwOffset, CUplinkLogRecordHeader pHeader);
+static bool CUplinkLog_CheckRecord(CUplinkLog this, DWORD dwOffset, CUplinkLogRecordHeader pHeader, BYTE *pData);
+static DWORD CUplinkLog_NextSector(CUplinkLog this, DWORD dwOffset);
+static DWORD CUplinkLog_SeekPending(CUplinkLog this, DWORD dwOffset);
+static void CUplinkLog_Recover(CUplinkLog this);
+
+
+CUplinkLog CUplinkLog_New(CUplinkLogBackend pBackend)
+{
+  CUplinkLog this;
+
+  // A record must fit in a sector and at least two sectors are required (i.e. the head sector
+  // is erased while records are kept in the other sectors)
+  if ((pBackend->m_dwSectorSize < sizeof(CUplinkLogRecordHeaderOb) * 2) || ((pBackend->m_dwSectorSize & 0x03) != 0) ||
+      (pBackend->m_dwSize % pBackend->m_dwSectorSize != 0) || (pBackend->m_dwSize / pBackend->m_dwSectorSize < 2))
+  {
+    #if (UPLINKLOG_DEBUG_LEVEL0)
+      DEBUG_PRINT_LN("[ERROR] CUplinkLog_New, invalid storage geometry");
+    #endif
+    return NULL;
+  }
+
+  if ((this = (void *) pvPortMalloc(sizeof(CUplinkLogOb))) != NULL)
+  {
+    this->m_Backend = *pBackend;
+    this->m_dwSectorNumber = pBackend->m_dwSize / pBackend->m_dwSectorSize;
+    this->m_dwDroppedNumber = 0;
+
+    // Rebuild the log from records found in storage
+    CUplinkLog_Recover(this);
+
+    #if (UPLINKLOG_DEBUG_LEVEL0)
+      DEBUG_PRINT("[INFO] CUplinkLog_New, pending records: ");
+      DEBUG_PRINT_DEC(this->m_dwRecordNumber);
+      DEBUG_PRINT(", next sequence: ");
+      DEBUG_PRINT_DEC(this->m_dwSequence);
+      DEBUG_PRINT_CR;
+    #endif
+  }
+
+  return this;
+}
+
+void CUplinkLog_Delete(CUplinkLog this)
+{
+  vPortFree(this);
+}
+
+
+/*****************************************************************************************//**
+ * @fn         bool CUplinkLog_Append(CUplinkLog this, const BYTE *pData, WORD wLength)
+ *
+ * @brief      Appends a record at the head of the log.
+ *
+ * @details    The record is written at the current head position. If the record does not fit
+ *             in the remaining space of the current sector, it is written at the beginning of
+ *             the next sector.\n
+ *             When the head enters a sector, the sector is erased. If this sector contains
+ *             the oldest pending records (i.e. log full), these records are dropped.
+ *
+ * @param      this
+ *             The pointer to CUplinkLog object.
+ *
+ * @param      pData
+ *             The record data (typically an encoded uplink message).
+ *
+ * @param      wLength
+ *             The length of record data (bytes).
+ *
+ * @return     The 'true' value is returned if the record is written in storage.
+*********************************************************************************************/
+bool CUplinkLog_Append(CUplinkLog this, const BYTE *pData, WORD wLength)
+{
+  CUplinkLogRecordHeaderOb Header;
+  DWORD dwSectorSize = this->m_Backend.m_dwSectorSize;
+  DWORD dwRecordSize = UPLINKLOG_RECORD_SIZE(wLength);
+  DWORD dwOffset;
+
+  if (dwRecordSize > dwSectorSize)
+  {
+    return false;
+  }
+
+  // Records never straddle sectors
+  if ((this->m_dwHeadOffset % dwSectorSize) + dwRecordSize > dwSectorSize)
+  {
+    this->m_dwHeadOffset = CUplinkLog_NextSector(this, this->m_dwHeadOffset);
+  }
+
+  // Head entering a sector: drop the oldest records if they are in this sector and erase it
+  if ((this->m_dwHeadOffset % dwSectorSize) == 0)
+  {
+    if ((this->m_dwRecordNumber > 0) &&
+        (this->m_dwTailOffset / dwSectorSize == this->m_dwHeadOffset / dwSectorSize))
+    {
+      for (dwOffset = this->m_dwTailOffset; (this->m_dwRecordNumber > 0) &&
+           (CUplinkLog_ReadHeader(this, dwOffset, &Header) == true); dwOffset += UPLINKLOG_RECORD_SIZE(Header.m_wLength))
+      {
+        if (Header.m_wFlags == UPLINKLOG_RECORD_FLAGS_PENDING)
+        {
+          --this->m_dwRecordNumber;
+          ++this->m_dwDroppedNumber;
+        }
+        if ((dwOffset + UPLINKLOG_RECORD_SIZE(Header.m_wLength)) % dwSectorSize == 0)
+        {
+          break;
+        }
+      }
+
+      if (this->m_dwRecordNumber > 0)
+      {
+        this->m_dwTailOffset = CUplinkLog_SeekPending(this, CUplinkLog_NextSector(this, this->m_dwHeadOffset));
+      }
+
+      #if (UPLINKLOG_DEBUG_LEVEL0)
+        DEBUG_PRINT("[WARNING] CUplinkLog_Append, log full, dropped records: ");
+        DEBUG_PRINT_DEC(this->m_dwDroppedNumber);
+        DEBUG_PRINT_CR;
+      #endif
+    }
+
+    if (this->m_Backend.m_pErase(this->m_Backend.m_pContext, this->m_dwHeadOffset, dwSectorSize) != true)
+    {
+      #if (UPLINKLOG_DEBUG_LEVEL0)
+        DEBUG_PRINT_LN("[ERROR] CUplinkLog_Append, failed to erase sector");
+      #endif
+      return false;
+    }
+  }
+
+  // Record data is written before the header (i.e. interrupted append leaves an erased header)
+  Header.m_wMagic = UPLINKLOG_RECORD_MAGIC;
+  Header.m_wLength = wLength;
+  Header.m_dwSequence = this->m_dwSequence;
+  Header.m_wCrc = CUplinkLog_Crc16(CUplinkLog_Crc16(CUplinkLog_Crc16(0xFFFF, (BYTE *) &Header.m_wLength, 2),
+                                                    (BYTE *) &Header.m_dwSequence, 4), pData, wLength);
+  Header.m_wFlags = UPLINKLOG_RECORD_FLAGS_PENDING;
+
+  if (((wLength > 0) && (this->m_Backend.m_pWrite(this->m_Backend.m_pContext, this->m_dwHeadOffset + sizeof(Header),
+                                                   pData, wLength) != true)) ||
+      (this->m_Backend.m_pWrite(this->m_Backend.m_pContext, this->m_dwHeadOffset, &Header, sizeof(Header)) != true))
+  {
+    // The end of sector is not reliable anymore, next record will be written in next sector
+    #if (UPLINKLOG_DEBUG_LEVEL0)
+      DEBUG_PRINT_LN("[ERROR] CUplinkLog_Append, failed to write record");
+    #endif
+    this->m_dwHeadOffset = CUplinkLog_NextSector(this, this->m_dwHeadOffset);
+    return false;
+  }
+
+  if (this->m_dwRecordNumber++ == 0)
+  {
+    this->m_dwTailOffset = this->m_dwHeadOffset;
+  }
+  ++this->m_dwSequence;
+
+  this->m_dwHeadOffset += dwRecordSize;
+  if (this->m_dwHeadOffset >= this->m_Backend.m_dwSize)
+  {
+    this->m_dwHeadOffset = 0;
+  }
+
+  #if (UPLINKLOG_DEBUG_LEVEL2)
+    DEBUG_PRINT("[DEBUG] CUplinkLog_Append, record appended, length: ");
+    DEBUG_PRINT_DEC((DWORD) wLength);
+    DEBUG_PRINT(", pending records: ");
+    DEBUG_PRINT_DEC(this->m_dwRecordNumber);
+    DEBUG_PRINT_CR;
+  #endif
+
+  return true;
+}
+
+
+/*****************************************************************************************//**
+ * @fn         WORD CUplinkLog_Peek(CUplinkLog this, BYTE *pData, WORD wMaxLength)
+ *
+ * @brief      Reads the oldest pending record of the log.
+ *
+ * @details    The record is not removed from the log (see 'CUplinkLog_Consume').\n
+ *             Corrupted records (i.e. wrong CRC) and records larger than 'wMaxLength' are
+ *             dropped.
+ *
+ * @param      this
+ *             The pointer to CUplinkLog object.
+ *
+ * @param      pData
+ *             The buffer where to copy the record data.
+ *
+ * @param      wMaxLength
+ *             The size of 'pData' buffer.
+ *
+ * @return     The length of record data or 0 if the log is empty.
+*********************************************************************************************/
+WORD CUplinkLog_Peek(CUplinkLog this, BYTE *pData, WORD wMaxLength)
+{
+  CUplinkLogRecordHeaderOb Header;
+
+  while (this->m_dwRecordNumber > 0)
+  {
+    if ((CUplinkLog_ReadHeader(this, this->m_dwTailOffset, &Header) == true) && (Header.m_wLength <= wMaxLength) &&
+        (CUplinkLog_CheckRecord(this, this->m_dwTailOffset, &Header, pData) == true))
+    {
+      return Header.m_wLength;
+    }
+
+    #if (UPLINKLOG_DEBUG_LEVEL0)
+      DEBUG_PRINT_LN("[WARNING] CUplinkLog_Peek, invalid record dropped");
+    #endif
+
+    ++this->m_dwDroppedNumber;
+    CUplinkLog_Consume(this);
+  }
+
+  return 0;
+}
+
+
+/*****************************************************************************************//**
+ * @fn         void CUplinkLog_Consume(CUplinkLog this)
+ *
+ * @brief      Removes the oldest pending record of the log.
+ *
+ * @details    The record is marked as consumed in storage (i.e. not replayed after reboot).
+ *
+ * @param      this
+ *             The pointer to CUplinkLog object.
+*********************************************************************************************/
+void CUplinkLog_Consume(CUplinkLog this)
+{
+  CUplinkLogRecordHeaderOb Header;
+  WORD wFlags = UPLINKLOG_RECORD_FLAGS_CONSUMED;
+
+  if (this->m_dwRecordNumber == 0)
+  {
+    return;
+  }
+
+  if (CUplinkLog_ReadHeader(this, this->m_dwTailOffset, &Header) == true)
+  {
+    // Note: 'm_wFlags' is the last member of record header
+    this->m_Backend.m_pWrite(this->m_Backend.m_pContext, this->m_dwTailOffset + sizeof(Header) - sizeof(wFlags),
+                             &wFlags, sizeof(wFlags));
+    this->m_dwTailOffset += UPLINKLOG_RECORD_SIZE(Header.m_wLength);
+    if (this->m_dwTailOffset >= this->m_Backend.m_dwSize)
+    {
+      this->m_dwTailOffset = 0;
+    }
+  }
+  else
+  {
+    // Should never occur (tail always on a record header)
+    this->m_dwTailOffset = CUplinkLog_NextSector(this, this->m_dwTailOffset);
+  }
+
+  if (--this->m_dwRecordNumber > 0)
+  {
+    this->m_dwTailOffset = CUplinkLog_SeekPending(this, this->m_dwTailOffset);
+  }
+}
+
+
+DWORD CUplinkLog_GetRecordNumber(CUplinkLog this)
+{
+  return this->m_dwRecordNumber;
+}
+
+DWORD CUplinkLog_GetDroppedNumber(CUplinkLog this)
+{
+  return this->m_dwDroppedNumber;
+}
+
+
+/*********************************************************************************************
+  Private methods (implementation)
+*********************************************************************************************/
+
+// CRC16 (CCITT, polynomial 0x1021) using a 16 entries table (i.e. 4 bits per step)
+static WORD CUplinkLog_Crc16(WORD wCrc, const BYTE *pData, DWORD dwLength)
+{
+  static const WORD CrcTable[16] =
+  {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+  };
+
+  while (dwLength-- > 0)
+  {
+    wCrc = (wCrc << 4) ^ CrcTable[(wCrc >> 12) ^ (*pData >> 4)];
+    wCrc = (wCrc << 4) ^ CrcTable[(wCrc >> 12) ^ (*pData++ & 0x0F)];
+  }
+  return wCrc;
+}
+
+// Reads the record header at specified offset
+// Returns 'false' if there is no record at this offset (i.e. erased header, end of sector or corrupted length)
+static bool CUplinkLog_ReadHeader(CUplinkLog this, DWORD dwOffset, CUplinkLogRecordHeader pHeader)
+{
+  DWORD dwSectorOffset = dwOffset % this->m_Backend.m_dwSectorSize;
+
+  if ((dwSectorOffset + sizeof(CUplinkLogRecordHeaderOb) > this->m_Backend.m_dwSectorSize) ||
+      (this->m_Backend.m_pRead(this->m_Backend.m_pContext, dwOffset, pHeader, sizeof(CUplinkLogRecordHeaderOb)) != true) ||
+      (pHeader->m_wMagic != UPLINKLOG_RECORD_MAGIC) ||
+      (dwSectorOffset + UPLINKLOG_RECORD_SIZE(pHeader->m_wLength) > this->m_Backend.m_dwSectorSize))
+  {
+    return false;
+  }
+  return true;
+}
+
+// Reads the record data and checks the CRC
+// If 'pData' is NULL, the data is only read for CRC check
+static bool CUplinkLog_CheckRecord(CUplinkLog this, DWORD dwOffset, CUplinkLogRecordHeader pHeader, BYTE *pData)
+{
+  BYTE usBuffer[64];
+  WORD wCrc;
+  DWORD dwLength;
+
+  wCrc = CUplinkLog_Crc16(CUplinkLog_Crc16(0xFFFF, (BYTE *) &pHeader->m_wLength, 2), (BYTE *) &pHeader->m_dwSequence, 4);
+  dwOffset += sizeof(CUplinkLogRecordHeaderOb);
+
+  if (pData != NULL)
+  {
+    if ((pHeader->m_wLength > 0) &&
+        (this->m_Backend.m_pRead(this->m_Backend.m_pContext, dwOffset, pData, pHeader->m_wLength) != true))
+    {
+      return false;
+    }
+    wCrc = CUplinkLog_Crc16(wCrc, pData, pHeader->m_wLength);
+  }
+  else
+  {
+    for (DWORD dwRead = 0; dwRead < pHeader->m_wLength; dwRead += dwLength)
+    {
+      dwLength = pHeader->m_wLength - dwRead > sizeof(usBuffer) ? sizeof(usBuffer) : pHeader->m_wLength - dwRead;
+      if (this->m_Backend.m_pRead(this->m_Backend.m_pContext, dwOffset + dwRead, usBuffer, dwLength) != true)
+      {
+        return false;
+      }
+      wCrc = CUplinkLog_Crc16(wCrc, usBuffer, dwLength);
+    }
+  }
+
+  return wCrc == pHeader->m_wCrc ? true : false;
+}
+
+// Returns the offset of the sector following the sector containing specified offset
+static DWORD CUplinkLog_NextSector(CUplinkLog this, DWORD dwOffset)
+{
+  dwOffset = (dwOffset - (dwOffset % this->m_Backend.m_dwSectorSize)) + this->m_Backend.m_dwSectorSize;
+  return dwOffset >= this->m_Backend.m_dwSize ? 0 : dwOffset;
+}
+
+// Returns the offset of the first pending record starting at specified offset
+// Note: Called only when 'm_dwRecordNumber' is not 0 (i.e. a pending record exists)
+static DWORD CUplinkLog_SeekPending(CUplinkLog this, DWORD dwOffset)
+{
+  CUplinkLogRecordHeaderOb Header;
+  DWORD dwSectorNumber = 0;
+
+  while (dwSectorNumber <= this->m_dwSectorNumber)
+  {
+    if (CUplinkLog_ReadHeader(this, dwOffset, &Header) == true)
+    {
+      if (Header.m_wFlags == UPLINKLOG_RECORD_FLAGS_PENDING)
+      {
+        return dwOffset;
+      }
+
+      dwOffset += UPLINKLOG_RECORD_SIZE(Header.m_wLength);
+      if (dwOffset >= this->m_Backend.m_dwSize)
+      {
+        dwOffset = 0;
+      }
+      if ((dwOffset % this->m_Backend.m_dwSectorSize) == 0)
+      {
+        ++dwSectorNumber;
+      }
+    }
+    else
+    {
+      dwOffset = CUplinkLog_NextSector(this, dwOffset);
+      ++dwSectorNumber;
+    }
+  }
+
+  // Should never occur (inconsistent record number)
+  #if (UPLINKLOG_DEBUG_LEVEL0)
+    DEBUG_PRINT_LN("[ERROR] CUplinkLog_SeekPending, pending record not found");
+  #endif
+
+  this->m_dwDroppedNumber += this->m_dwRecordNumber;
+  this->m_dwRecordNumber = 0;
+  return this->m_dwHeadOffset;
+}
+
+// Rebuilds the log state from records found in storage
+//  - The head is the beginning of the sector following the sector of newest record
+//  - The tail is the oldest pending record (i.e. sectors scanned from head sector)
+static void CUplinkLog_Recover(CUplinkLog this)
+{
+  CUplinkLogRecordHeaderOb Header;
+  DWORD dwSectorSize = this->m_Backend.m_dwSectorSize;
+  DWORD dwNewestSequence = 0;
+  DWORD dwNewestOffset = 0;
+  DWORD dwSectorOffset;
+  DWORD dwOffset;
+  bool bFound = false;
+
+  this->m_dwRecordNumber = 0;
+
+  // Step 1: Retrieve the newest valid record
+  for (dwSectorOffset = 0; dwSectorOffset < this->m_Backend.m_dwSize; dwSectorOffset += dwSectorSize)
+  {
+    for (dwOffset = dwSectorOffset; (dwOffset < dwSectorOffset + dwSectorSize) &&
+         (CUplinkLog_ReadHeader(this, dwOffset, &Header) == true); dwOffset += UPLINKLOG_RECORD_SIZE(Header.m_wLength))
+    {
+      if (((bFound == false) || ((int32_t) (Header.m_dwSequence - dwNewestSequence) > 0)) &&
+          (CUplinkLog_CheckRecord(this, dwOffset, &Header, NULL) == true))
+      {
+        dwNewestSequence = Header.m_dwSequence;
+        dwNewestOffset = dwOffset;
+        bFound = true;
+      }
+    }
+  }
+
+  if (bFound == false)
+  {
+    // Empty log (next append erases the first sector)
+    this->m_dwHeadOffset = this->m_dwTailOffset = 0;
+    this->m_dwSequence = 0;
+    return;
+  }
+
+  this->m_dwSequence = dwNewestSequence + 1;
+  this->m_dwHeadOffset = CUplinkLog_NextSector(this, dwNewestOffset);
+
+  // Step 2: Count the pending records, from oldest sector (i.e. head sector) to newest sector
+  dwSectorOffset = this->m_dwHeadOffset;
+  for (DWORD i = 0; i < this->m_dwSectorNumber; i++)
+  {
+    for (dwOffset = dwSectorOffset; (dwOffset < dwSectorOffset + dwSectorSize) &&
+         (CUplinkLog_ReadHeader(this, dwOffset, &Header) == true); dwOffset += UPLINKLOG_RECORD_SIZE(Header.m_wLength))
+    {
+      if (Header.m_wFlags == UPLINKLOG_RECORD_FLAGS_PENDING)
+      {
+        if (this->m_dwRecordNumber++ == 0)
+        {
+          this->m_dwTailOffset = dwOffset;
+        }
+      }
+    }
+    dwSectorOffset = CUplinkLog_NextSector(this, dwSectorOffset);
+  }
+}
+
+
+/*********************************************************************************************
+  Storage backends
+*********************************************************************************************/
+
+#ifdef ESP_PLATFORM
+
+// Flash partition (data partition defined in partition table)
+// Note: The context is the 'esp_partition_t' descriptor
+
+static bool CUplinkLog_PartitionRead(void *pContext, DWORD dwOffset, void *pData, DWORD dwLength)
+{
+  return esp_partition_read((const esp_partition_t *) pContext, dwOffset, pData, dwLength) == ESP_OK ? true : false;
+}
+
+static bool CUplinkLog_PartitionWrite(void *pContext, DWORD dwOffset, const void *pData, DWORD dwLength)
+{
+  return esp_partition_write((const esp_partition_t *) pContext, dwOffset, pData, dwLength) == ESP_OK ? true : false;
+}
+
+static bool CUplinkLog_PartitionErase(void *pContext, DWORD dwOffset, DWORD dwLength)
+{
+  return esp_partition_erase_range((const esp_partition_t *) pContext, dwOffset, dwLength) == ESP_OK ? true : false;
+}
+
+bool CUplinkLog_InitPartitionBackend(CUplinkLogBackend pBackend, const char *szPartitionLabel)
+{
+  const esp_partition_t *pPartition;
+
+  if ((pPartition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, szPartitionLabel)) == NULL)
+  {
+    #if (UPLINKLOG_DEBUG_LEVEL0)
+      DEBUG_PRINT("[WARNING] CUplinkLog_InitPartitionBackend, partition not found: ");
+      DEBUG_PRINT_LN(szPartitionLabel);
+    #endif
+    return false;
+  }
+
+  pBackend->m_pContext = (void *) pPartition;
+  pBackend->m_dwSectorSize = SPI_FLASH_SEC_SIZE;
+  pBackend->m_dwSize = pPartition->size - (pPartition->size % SPI_FLASH_SEC_SIZE);
+  pBackend->m_pRead = CUplinkLog_PartitionRead;
+  pBackend->m_pWrite = CUplinkLog_PartitionWrite;
+  pBackend->m_pErase = CUplinkLog_PartitionErase;
+  return true;
+}
+
+#else
+
+// File (Linux host)
+// Note: The context is the 'FILE' descriptor. The file is synced after each write (i.e. crash safety)
+
+#define UPLINKLOG_FILE_SECTOR_SIZE   4096
+
+static bool CUplinkLog_FileWrite(void *pContext, DWORD dwOffset, const void *pData, DWORD dwLength)
+{
+  if ((fseek((FILE *) pContext, dwOffset, SEEK_SET) != 0) || (fwrite(pData, 1, dwLength, (FILE *) pContext) != dwLength) ||
+      (fflush((FILE *) pContext) != 0))
+  {
+    return false;
+  }
+  return fsync(fileno((FILE *) pContext)) == 0 ? true : false;
+}
+
+static bool CUplinkLog_FileRead(void *pContext, DWORD dwOffset, void *pData, DWORD dwLength)
+{
+  if ((fseek((FILE *) pContext, dwOffset, SEEK_SET) != 0) || (fread(pData, 1, dwLength, (FILE *) pContext) != dwLength))
+  {
+    return false;
+  }
+  return true;
+}
+
+static bool CUplinkLog_FileErase(void *pContext, DWORD dwOffset, DWORD dwLength)
+{
+  BYTE usErased[256];
+
+  memset(usErased, 0xFF, sizeof(usErased));
+  if (fseek((FILE *) pContext, dwOffset, SEEK_SET) != 0)
+  {
+    return false;
+  }
+  for (DWORD dwWritten = 0; dwWritten < dwLength; dwWritten += sizeof(usErased))
+  {
+    if (fwrite(usErased, 1, sizeof(usErased), (FILE *) pContext) != sizeof(usErased))
+    {
+      return false;
+    }
+  }
+  return (fflush((FILE *) pContext) == 0) && (fsync(fileno((FILE *) pContext)) == 0) ? true : false;
+}
+
+bool CUplinkLog_InitFileBackend(CUplinkLogBackend pBackend, const char *szFileName, DWORD dwSize)
+{
+  FILE *pFile;
+  long lFileSize;
+
+  dwSize -= dwSize % UPLINKLOG_FILE_SECTOR_SIZE;
+
+  // The file is created (or extended) with erased sectors
+  if (((pFile = fopen(szFileName, "r+b")) == NULL) && ((pFile = fopen(szFileName, "w+b")) == NULL))
+  {
+    return false;
+  }
+
+  if ((fseek(pFile, 0, SEEK_END) != 0) || ((lFileSize = ftell(pFile)) < 0))
+  {
+    fclose(pFile);
+    return false;
+  }
+
+  lFileSize -= lFileSize % UPLINKLOG_FILE_SECTOR_SIZE;
+  if (((DWORD) lFileSize < dwSize) && (CUplinkLog_FileErase(pFile, lFileSize, dwSize - lFileSize) != true))
+  {
+    fclose(pFile);
+    return false;
+  }
+
+  pBackend->m_pContext = pFile;
+  pBackend->m_dwSectorSize = UPLINKLOG_FILE_SECTOR_SIZE;
+  pBackend->m_dwSize = dwSize;
+  pBackend->m_pRead = CUplinkLog_FileRead;
+  pBackend->m_pWrite = CUplinkLog_FileWrite;
+  pBackend->m_pErase = CUplinkLog_FileErase;
+  return true;
+}
+
+void CUplinkLog_CloseFileBackend(CUplinkLogBackend pBackend)
+{
+  fclose((FILE *) pBackend->m_pContext);
+  pBackend->m_pContext = NULL;
+}
+
+#endif
@@ -11,6 +11,7 @@
  *
  * @details  This file implements the following utility classes or functions:\n
  *            - CMemoryBlockArray = Fixed size data blocks with quick allocation
+ *            - CWideMemoryBlockArray = Same as 'CMemoryBlockArray' for large collections
  *            - Base64 = Base64 encoding and decoding functions
 *********************************************************************************************/
 
@@ -37,42 +38,106 @@
  Notes: 
   - The maximum size of collection is 255 memory blocks
   - The object is thread safe
+  - Two implementations are available for the free block list (see 'MEMORYBLOCKARRAY_LOCKFREE'
+    in Definitions.h):
+     - Mutex protected LIFO array
+     - Lock-free LIFO linked list with tagged head (the tag is incremented on each update of
+       the head in order to detect ABA situations)
 
  WARNING: This object cannot be static. It MUST always be allocated by with the construction
           method ('CMemoryBlockArray_New')
 *********************************************************************************************/
-                   
+
+// Private helpers for block flags (used and ready bitmaps)
+//
+// The bitmaps are stored as bytes (bit 7 of first byte is flag of block 0) but the storage
+// is 32 bits aligned. This allows atomic update of flags with 32 bits atomic operations on
+// the word containing the flag byte (i.e. ESP32 'S32C1I' instruction)
+
+#define MEMORYBLOCKARRAY_FLAGSIZE(usBlockNumber)   (((((usBlockNumber) / 8) + 1) + 3) & ~0x03)
+
+#if (MEMORYBLOCKARRAY_LOCKFREE)
+
+// Tagged head of lock-free free block list:
+//  - Bits 0 to 15: index of first free block ('m_usArraySize' when all blocks are used)
+//  - Bits 16 to 31: ABA tag (incremented on each update)
+#define MEMORYBLOCKARRAY_HEAD_INDEX(dwHead)        ((WORD) ((dwHead) & 0x0000FFFF))
+#define MEMORYBLOCKARRAY_HEAD_NEXT(dwHead, wIndex) ((((dwHead) + 0x00010000) & 0xFFFF0000) | (DWORD) (wIndex))
+
+// Note: 'pFlags' is the address of the byte containing the flag of the block
+static inline DWORD * CMemoryBlockArray_FlagWord(BYTE *pFlags, BYTE usBlockIndex, DWORD *pdwMask)
+{
+  // Little endian: byte offset in aligned word gives the shift of the mask
+  *pdwMask = ((DWORD) (0b10000000 >> usBlockIndex % 8)) << ((((uintptr_t) pFlags) & 0x03) * 8);
+  return (DWORD *) (((uintptr_t) pFlags) & ~0x03);
+}
+
+static inline void CMemoryBlockArray_SetFlag(BYTE *pFlags, BYTE usBlockIndex)
+{
+  DWORD dwMask;
+  DWORD *pWord = CMemoryBlockArray_FlagWord(pFlags, usBlockIndex, &dwMask);
+
+  __atomic_fetch_or(pWord, dwMask, __ATOMIC_RELEASE);
+}
+
+// Returns true if the flag was set before clear
+static inline bool CMemoryBlockArray_ClearFlag(BYTE *pFlags, BYTE usBlockIndex)
+{
+  DWORD dwMask;
+  DWORD *pWord = CMemoryBlockArray_FlagWord(pFlags, usBlockIndex, &dwMask);
+
+  return (__atomic_fetch_and(pWord, ~dwMask, __ATOMIC_ACQ_REL) & dwMask) != 0 ? true : false;
+}
+
+#endif
+
 
 CMemoryBlockArray CMemoryBlockArray_New(WORD wBlockSize, BYTE usBlockNumber)
 {
   CMemoryBlockArray this;
+  WORD wFlagSize = MEMORYBLOCKARRAY_FLAGSIZE(usBlockNumber);
+  WORD wFreeListSize = (usBlockNumber + 3) & ~0x03;
 
   // Allocate memoty for the object
   // The memory for 'MemoryBlockData' and 'FreeBlockList' is allocated at the end of the object
-  if ((this = (void *) pvPortMalloc(sizeof(CMemoryBlockArray) + (wBlockSize * usBlockNumber) +
-      usBlockNumber + (((usBlockNumber / 8) + 1) * 2))) != NULL)
+  // Note: Flags, list and data storage start on 32 bits boundaries
+  if ((this = (void *) pvPortMalloc(sizeof(CMemoryBlockArrayOb) + (wFlagSize * 2) + wFreeListSize +
+      (wBlockSize * usBlockNumber))) != NULL)
   {
-    if ((this->m_hMutex = xSemaphoreCreateMutex()) == NULL)
-    {
-      CMemoryBlockArray_Delete(this);
-      return NULL;
-    }
+    #if (MEMORYBLOCKARRAY_LOCKFREE)
+      this->m_hMutex = NULL;
+    #else
+      if ((this->m_hMutex = xSemaphoreCreateMutex()) == NULL)
+      {
+        vPortFree(this);
+        return NULL;
+      }
+    #endif
 
     this->m_usArraySize = usBlockNumber;
     this->m_wMemoryBlockSize = wBlockSize;
 
-    this->m_usFreeBlockListHead = 0;
+    this->m_pUsedBlockFlags = ((BYTE *) this) + sizeof(CMemoryBlockArrayOb);
+    this->m_pReadyBlockFlags = this->m_pUsedBlockFlags + wFlagSize;
+    this->m_pFreeBlockList = this->m_pReadyBlockFlags + wFlagSize;
+    this->m_pMemoryBlockData = this->m_pFreeBlockList + wFreeListSize;
 
-    this->m_pFreeBlockList = ((BYTE *) this) + sizeof(CMemoryBlockArrayOb);
-    this->m_pMemoryBlockData = this->m_pFreeBlockList + usBlockNumber;
-    this->m_pUsedBlockFlags = this->m_pMemoryBlockData + (wBlockSize * usBlockNumber);
-    this->m_pReadyBlockFlags = this->m_pUsedBlockFlags + ((usBlockNumber / 8) + 1);
+    #if (MEMORYBLOCKARRAY_LOCKFREE)
+      // Linked list: each entry contains the index of next free block
+      for (BYTE i = 0; i < usBlockNumber; i++)
+      {
+        this->m_pFreeBlockList[i] = i + 1;
+      }
+      this->m_dwFreeListHead = 0;
+    #else
+      for (BYTE i = 0; i < usBlockNumber; i++)
+      {
+        this->m_pFreeBlockList[i] = i;
+      }
+      this->m_usFreeBlockListHead = 0;
+    #endif
 
-    for (BYTE i = 0; i < usBlockNumber; i++)
-    {
-      this->m_pFreeBlockList[i] = i;
-    }
-    memset(this->m_pUsedBlockFlags, 0, ((usBlockNumber / 8) + 1) * 2);
+    memset(this->m_pUsedBlockFlags, 0, wFlagSize * 2);
   }
 
   #if (UTILITIES_DEBUG_LEVEL2)
@@ -98,6 +163,86 @@ void CMemoryBlockArray_Delete(CMemoryBlockArray this)
 }
 
 
+#if (MEMORYBLOCKARRAY_LOCKFREE)
+
+void * CMemoryBlockArray_GetBlock(CMemoryBlockArray this, CMemoryBlockArrayEntry pEntry)
+{
+  DWORD dwHead;
+  DWORD dwNewHead;
+  WORD wIndex;
+
+  // Pop first entry of free block list
+  // Note: The next index read in list may be obsolete if another task has modified the list
+  //       but in this case the tag of head has changed and the 'CompareExchange' fails
+  dwHead = __atomic_load_n(&this->m_dwFreeListHead, __ATOMIC_ACQUIRE);
+  do
+  {
+    wIndex = MEMORYBLOCKARRAY_HEAD_INDEX(dwHead);
+    if (wIndex >= this->m_usArraySize)
+    {
+      // All entries are used
+      pEntry->m_pDataBlock = NULL;
+      return NULL;
+    }
+    dwNewHead = MEMORYBLOCKARRAY_HEAD_NEXT(dwHead, this->m_pFreeBlockList[wIndex]);
+  }
+  while (__atomic_compare_exchange_n(&this->m_dwFreeListHead, &dwHead, dwNewHead, false,
+                                     __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE) == false);
+
+  // Provide block
+  pEntry->m_usBlockIndex = (BYTE) wIndex;
+  pEntry->m_pDataBlock = this->m_pMemoryBlockData + (this->m_wMemoryBlockSize * pEntry->m_usBlockIndex);
+
+  // Set used block flag
+  CMemoryBlockArray_SetFlag(this->m_pUsedBlockFlags + (pEntry->m_usBlockIndex / 8), pEntry->m_usBlockIndex);
+
+  #if (UTILITIES_DEBUG_LEVEL2)
+    DEBUG_PRINT("[DEBUG] CMemoryBlockArray_GetBlock, index: ");
+    DEBUG_PRINT_HEX((unsigned int) pEntry->m_usBlockIndex);
+    DEBUG_PRINT(", ptr: ");
+    DEBUG_PRINT_PTR(pEntry->m_pDataBlock);
+    DEBUG_PRINT_CR;
+  #endif
+
+  return pEntry->m_pDataBlock;
+}
+
+bool CMemoryBlockArray_ReleaseBlock(CMemoryBlockArray this, BYTE usBlockIndex)
+{
+  DWORD dwHead;
+  DWORD dwNewHead;
+
+  // Clear used and ready flags
+  // The used flag is tested and cleared atomically: a block released more than once is
+  // detected here and never pushed twice in free list
+  // Note: The ready flag is cleared only by the owner of the used flag (i.e. a stray release
+  //       of a block already reused by another task does not modify the new owner's flags)
+  if (CMemoryBlockArray_ClearFlag(this->m_pUsedBlockFlags + (usBlockIndex / 8), usBlockIndex) == false)
+  {
+    // Should never occur. 
+    // Implementation error on collection  usage (typically blocks released more than once)
+    #if (UTILITIES_DEBUG_LEVEL0)
+      DEBUG_PRINT_LN("[ERROR] CMemoryBlockArray_ReleaseBlock - Block already released");
+    #endif
+    return false;
+  }
+  CMemoryBlockArray_ClearFlag(this->m_pReadyBlockFlags + (usBlockIndex / 8), usBlockIndex);
+
+  // Push released block in free list
+  dwHead = __atomic_load_n(&this->m_dwFreeListHead, __ATOMIC_ACQUIRE);
+  do
+  {
+    this->m_pFreeBlockList[usBlockIndex] = (BYTE) MEMORYBLOCKARRAY_HEAD_INDEX(dwHead);
+    dwNewHead = MEMORYBLOCKARRAY_HEAD_NEXT(dwHead, usBlockIndex);
+  }
+  while (__atomic_compare_exchange_n(&this->m_dwFreeListHead, &dwHead, dwNewHead, false,
+                                     __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE) == false);
+
+  return true;
+}
+
+#else
+
 void * CMemoryBlockArray_GetBlock(CMemoryBlockArray this, CMemoryBlockArrayEntry pEntry)
 {
   BYTE *pFlags;
@@ -148,7 +293,7 @@ void * CMemoryBlockArray_GetBlock(CMemoryBlockArray this, CMemoryBlockArrayEntry
     DEBUG_PRINT("[DEBUG] CMemoryBlockArray_GetBlock, index: ");
     DEBUG_PRINT_HEX((unsigned int) pEntry->m_usBlockIndex);
     DEBUG_PRINT(", ptr: ");
-    DEBUG_PRINT_HEX((unsigned int) pEntry->m_pDataBlock);
+    DEBUG_PRINT_PTR(pEntry->m_pDataBlock);
     DEBUG_PRINT_CR;
   #endif
 
@@ -199,6 +344,8 @@ bool CMemoryBlockArray_ReleaseBlock(CMemoryBlockArray this, BYTE usBlockIndex)
   return bResult;
 }
 
+#endif
+
 
 bool CMemoryBlockArray_IsBlockUsed(CMemoryBlockArray this, BYTE usBlockIndex)
 {
@@ -229,7 +376,7 @@ bool CMemoryBlockArray_IsBlockReady(CMemoryBlockArray this, BYTE usBlockIndex)
     DEBUG_PRINT("[DEBUG] CMemoryBlockArray_IsBlockReady BlockIndex: ");
     DEBUG_PRINT_HEX((unsigned int) usBlockIndex);
     DEBUG_PRINT(" , pFlags: ");
-    DEBUG_PRINT_HEX((unsigned int) pFlags);
+    DEBUG_PRINT_PTR(pFlags);
     DEBUG_PRINT(" , Flags value: ");
     DEBUG_PRINT_HEX((unsigned int) *pFlags);
     DEBUG_PRINT_CR;
@@ -244,13 +391,17 @@ void CMemoryBlockArray_SetBlockReady(CMemoryBlockArray this, BYTE usBlockIndex)
 
   // Set ready block flag
   pFlags = this->m_pReadyBlockFlags + (usBlockIndex / 8);
-  *pFlags |= 0b10000000 >> usBlockIndex % 8;
+  #if (MEMORYBLOCKARRAY_LOCKFREE)
+    CMemoryBlockArray_SetFlag(pFlags, usBlockIndex);
+  #else
+    *pFlags |= 0b10000000 >> usBlockIndex % 8;
+  #endif
 
   #if (UTILITIES_DEBUG_LEVEL2)
     DEBUG_PRINT("[DEBUG] CMemoryBlockArray_SetBlockReady BlockIndex: ");
     DEBUG_PRINT_HEX((unsigned int) usBlockIndex);
     DEBUG_PRINT(" , pFlags: ");
-    DEBUG_PRINT_HEX((unsigned int) pFlags);
+    DEBUG_PRINT_PTR(pFlags);
     DEBUG_PRINT(" , Flags value: ");
     DEBUG_PRINT_HEX((unsigned int) *pFlags);
     DEBUG_PRINT_CR;
@@ -276,17 +427,23 @@ bool CMemoryBlockArray_EnumStart(CMemoryBlockArray this, CMemoryBlockArrayEnumIt
 {
   BYTE usBlockIndex;
 
-  if (xSemaphoreTake(this->m_hMutex, pdMS_TO_TICKS(500)) == pdFAIL)
-  {
-    // Should never occur
-    #if (UTILITIES_DEBUG_LEVEL0)
-      DEBUG_PRINT_LN("[ERROR] CMemoryBlockArray_EnumStart - Failed to take mutex");
-    #endif
-    return false;
-  }
+  #if (MEMORYBLOCKARRAY_LOCKFREE == 0)
+    if (xSemaphoreTake(this->m_hMutex, pdMS_TO_TICKS(500)) == pdFAIL)
+    {
+      // Should never occur
+      #if (UTILITIES_DEBUG_LEVEL0)
+        DEBUG_PRINT_LN("[ERROR] CMemoryBlockArray_EnumStart - Failed to take mutex");
+      #endif
+      return false;
+    }
+  #endif
 
   // If array not empty, enumerate entries and provide first used block
+  // Note: The number of used blocks is not maintained by lock-free implementation (i.e. used
+  //       flags are always scanned)
+  #if (MEMORYBLOCKARRAY_LOCKFREE == 0)
   if (this->m_usFreeBlockListHead != 0)
+  #endif
   {
     for (usBlockIndex = 0; usBlockIndex < this->m_usArraySize; usBlockIndex++)
     {
@@ -303,7 +460,9 @@ bool CMemoryBlockArray_EnumStart(CMemoryBlockArray this, CMemoryBlockArrayEnumIt
           {
             pEnumItem->m_pItemData = this->m_pMemoryBlockData + (usBlockIndex * this->m_wMemoryBlockSize);
           }
-          xSemaphoreGive(this->m_hMutex);
+          #if (MEMORYBLOCKARRAY_LOCKFREE == 0)
+            xSemaphoreGive(this->m_hMutex);
+          #endif
           pEnumItem->m_usBlockIndex = usBlockIndex;
           pEnumItem->m_usEnumState = usBlockIndex + 1;
           return true;
@@ -312,7 +471,9 @@ bool CMemoryBlockArray_EnumStart(CMemoryBlockArray this, CMemoryBlockArrayEnumIt
     }
   }
 
-  xSemaphoreGive(this->m_hMutex);
+  #if (MEMORYBLOCKARRAY_LOCKFREE == 0)
+    xSemaphoreGive(this->m_hMutex);
+  #endif
   return false;
 }
 
@@ -327,14 +488,16 @@ bool CMemoryBlockArray_EnumNext(CMemoryBlockArray this, CMemoryBlockArrayEnumIte
     return false;
   }
 
-  if (xSemaphoreTake(this->m_hMutex, pdMS_TO_TICKS(500)) == pdFAIL)
-  {
-    // Should never occur
-    #if (UTILITIES_DEBUG_LEVEL0)
-      DEBUG_PRINT_LN("[ERROR] CMemoryBlockArray_EnumNext - Failed to take mutex");
-    #endif
-    return false;
-  }
+  #if (MEMORYBLOCKARRAY_LOCKFREE == 0)
+    if (xSemaphoreTake(this->m_hMutex, pdMS_TO_TICKS(500)) == pdFAIL)
+    {
+      // Should never occur
+      #if (UTILITIES_DEBUG_LEVEL0)
+        DEBUG_PRINT_LN("[ERROR] CMemoryBlockArray_EnumNext - Failed to take mutex");
+      #endif
+      return false;
+    }
+  #endif
 
   // If array not empty, enumerate entries and provide first used block
   for (usBlockIndex = pEnumItem->m_usEnumState; usBlockIndex < this->m_usArraySize; usBlockIndex++)
@@ -352,7 +515,9 @@ bool CMemoryBlockArray_EnumNext(CMemoryBlockArray this, CMemoryBlockArrayEnumIte
         {
           pEnumItem->m_pItemData = this->m_pMemoryBlockData + (usBlockIndex * this->m_wMemoryBlockSize);
         }
-        xSemaphoreGive(this->m_hMutex);
+        #if (MEMORYBLOCKARRAY_LOCKFREE == 0)
+          xSemaphoreGive(this->m_hMutex);
+        #endif
         pEnumItem->m_usBlockIndex = usBlockIndex;
         pEnumItem->m_usEnumState = usBlockIndex + 1;
         return true;
@@ -360,159 +525,1188 @@ bool CMemoryBlockArray_EnumNext(CMemoryBlockArray this, CMemoryBlockArrayEnumIte
     }
   }
 
-  xSemaphoreGive(this->m_hMutex);
+  #if (MEMORYBLOCKARRAY_LOCKFREE == 0)
+    xSemaphoreGive(this->m_hMutex);
+  #endif
   return false;
 }
 
-/********************************************************************************************* 
- Base64 functions
-
- Utility functions for Base64 encoding and decoding
-*********************************************************************************************/
-
-// Private variables for Base64 functions
-
-static char Base64_code_62 = '+';    // RFC 1421 standard character for code 62 
-static char Base64_code_63 = '/';    // RFC 1421 standard character for code 63 
-static char Base64_code_pad = '=';   // RFC 1421 padding character if padding 
-
-static bool g_bBase64Error;
-
-// Forward declarations
-BYTE Base64_CodeToChar(BYTE x);
-BYTE Base64_CharToCode(BYTE x);
-
 //
-// Private functions
+// Snapshot enumerator methods
+//
+// This implementation is intended for frequent scans of the array:
+//  - The 'used' and 'ready' flags are captured once by 'SnapshotStart' (i.e. the array is
+//    locked only during capture with mutex implementation).
+//  - The blocks are scanned 32 at a time (count leading zeros on captured flags, the flag of
+//    the first block of a word is the most significant bit).
+//  - The entry is returned by reference (i.e. pointer to storage in the array).
+//  - Entries added after 'SnapshotStart' are not enumerated. An entry released after
+//    'SnapshotStart' may still be enumerated, the caller object must be designed in order to 
+//    be sure that retrieved object is still valid (same rule as for 'EnumStart')
 //
 
-BYTE Base64_CodeToChar(BYTE x)
+bool CMemoryBlockArray_SnapshotStart(CMemoryBlockArray this, CMemoryBlockArraySnapshot pSnapshot)
 {
-  if (x <= 25) 
-  {
-    return 'A' + x;
-  } 
-  else if ((x >= 26) && (x <= 51)) 
-  {
-    return 'a' + (x-26);
-  }
-  else if ((x >= 52) && (x <= 61))
-  {
-    return '0' + (x-52);
-  }
-  else if (x == 62)
+  BYTE usWordNumber;
+  BYTE *pUsedFlags;
+  BYTE *pReadyFlags;
+
+  // Flag storage is 32 bits aligned and its size is a multiple of 4 bytes (see 'New' method)
+  usWordNumber = (BYTE) ((this->m_usArraySize / 32) + 1);
+  pUsedFlags = this->m_pUsedBlockFlags;
+  pReadyFlags = this->m_pReadyBlockFlags;
+
+  #if (MEMORYBLOCKARRAY_LOCKFREE == 0)
+    if (xSemaphoreTake(this->m_hMutex, pdMS_TO_TICKS(500)) == pdFAIL)
+    {
+      // Should never occur
+      #if (UTILITIES_DEBUG_LEVEL0)
+        DEBUG_PRINT_LN("[ERROR] CMemoryBlockArray_SnapshotStart - Failed to take mutex");
+      #endif
+      return false;
+    }
+  #endif
+
+  for (BYTE i = 0; i < MEMORYBLOCKARRAY_SNAPSHOT_WORDS; i++)
   {
-    return Base64_code_62;
+    if (i < usWordNumber)
+    {
+      pSnapshot->m_dwFlags[i] = (((DWORD) (pUsedFlags[0] & pReadyFlags[0])) << 24) |
+                                (((DWORD) (pUsedFlags[1] & pReadyFlags[1])) << 16) |
+                                (((DWORD) (pUsedFlags[2] & pReadyFlags[2])) << 8) |
+                                ((DWORD) (pUsedFlags[3] & pReadyFlags[3]));
+      pUsedFlags += 4;
+      pReadyFlags += 4;
+    }
+    else
+    {
+      pSnapshot->m_dwFlags[i] = 0;
+    }
   }
-  else if (x == 63) 
-  {
-    return Base64_code_63;
-  } 
 
-  // Should never occur
-  #if (UTILITIES_DEBUG_LEVEL0)
-    DEBUG_PRINT_LN("[ERROR] Base64_CodeToChar - Byte out of range 0-64 for encoding");
+  #if (MEMORYBLOCKARRAY_LOCKFREE == 0)
+    xSemaphoreGive(this->m_hMutex);
   #endif
 
-  //TODO: improve error management
-  g_bBase64Error = true;
-  
-  return 0x00; 
+  pSnapshot->m_usWordIndex = 0;
+  return CMemoryBlockArray_SnapshotNext(this, pSnapshot);
 }
 
-BYTE Base64_CharToCode(BYTE x)
+bool CMemoryBlockArray_SnapshotNext(CMemoryBlockArray this, CMemoryBlockArraySnapshot pSnapshot)
 {
-  if ((x >= 'A') && (x <= 'Z')) 
-  {
-    return (BYTE)x - (BYTE)'A';
-  } 
-  else if ((x >= 'a') && (x <= 'z'))
-  {
-    return (BYTE)x - (BYTE)'a' + 26;
-  } 
-  else if ((x >= '0') && (x <= '9')) 
-  {
-    return (BYTE)x - (BYTE)'0' + 52;
-  } 
-  else if (x == Base64_code_62) 
+  DWORD dwFlags;
+  BYTE usBit;
+
+  // Skip empty words
+  while (pSnapshot->m_usWordIndex < MEMORYBLOCKARRAY_SNAPSHOT_WORDS)
   {
-    return 62;
+    if ((dwFlags = pSnapshot->m_dwFlags[pSnapshot->m_usWordIndex]) != 0)
+    {
+      // First block flagged in current word, clear its flag for next call
+      usBit = (BYTE) __builtin_clz(dwFlags);
+      pSnapshot->m_dwFlags[pSnapshot->m_usWordIndex] = dwFlags & ~(0x80000000 >> usBit);
+
+      pSnapshot->m_usBlockIndex = (pSnapshot->m_usWordIndex * 32) + usBit;
+      pSnapshot->m_pItemData = this->m_pMemoryBlockData + (pSnapshot->m_usBlockIndex * this->m_wMemoryBlockSize);
+      return true;
+    }
+    ++pSnapshot->m_usWordIndex;
   }
-  else if (x == Base64_code_63)
+
+  // Enumeration terminated
+  return false;
+}
+
+/********************************************************************************************* 
+ WideMemoryBlockArray Class
+
+ Utility class for fixed size data blocks with quick allocation (large collections)
+
+ Notes: 
+  - The maximum size of collection is 65535 memory blocks
+  - The object is thread safe
+  - The free block list is a lock-free LIFO linked list with tagged head (same implementation
+    as lock-free 'CMemoryBlockArray')
+  - The block flags are stored in 32 bits words and updated with 32 bits atomic operations
+    (bit 31 of first word is the flag of block 0)
+
+ WARNING: This object cannot be static. It MUST always be allocated by with the construction
+          method ('CWideMemoryBlockArray_New')
+*********************************************************************************************/
+
+// Private helpers for tagged head of free block list and block flags
+#define WIDEMEMORYBLOCKARRAY_HEAD_INDEX(dwHead)        ((WORD) ((dwHead) & 0x0000FFFF))
+#define WIDEMEMORYBLOCKARRAY_HEAD_NEXT(dwHead, wIndex) ((((dwHead) + 0x00010000) & 0xFFFF0000) | (DWORD) (wIndex))
+#define WIDEMEMORYBLOCKARRAY_FLAG_MASK(wBlockIndex)    (0x80000000 >> ((wBlockIndex) % 32))
+
+
+// Private method (i.e. common constructor of 'New' and 'NewShared')
+static CWideMemoryBlockArray CWideMemoryBlockArray_Create(WORD wBlockSize, WORD wBlockNumber, bool bShared)
+{
+  CWideMemoryBlockArray this;
+  WORD wFlagWordNumber = (WORD) ((((DWORD) wBlockNumber) + 31) / 32);
+  DWORD dwFreeListSize = ((((DWORD) wBlockNumber) * sizeof(WORD)) + 3) & ~0x03;
+  DWORD dwRefCountSize = bShared == true ? ((DWORD) wBlockNumber) * sizeof(DWORD) : 0;
+
+  // Allocate memoty for the object
+  // The memory for 'MemoryBlockData' and 'FreeBlockList' is allocated at the end of the object
+  // Note: Flags, reference counters, list and data storage start on 32 bits boundaries
+  if ((this = (void *) pvPortMalloc(sizeof(CWideMemoryBlockArrayOb) + (wFlagWordNumber * sizeof(DWORD) * 2) +
+      dwRefCountSize + dwFreeListSize + (((DWORD) wBlockSize) * wBlockNumber))) != NULL)
   {
-    return 63;
+    this->m_wArraySize = wBlockNumber;
+    this->m_wMemoryBlockSize = wBlockSize;
+    this->m_wFlagWordNumber = wFlagWordNumber;
+
+    this->m_pUsedBlockFlags = (DWORD *) (((BYTE *) this) + sizeof(CWideMemoryBlockArrayOb));
+    this->m_pReadyBlockFlags = this->m_pUsedBlockFlags + wFlagWordNumber;
+    this->m_pRefCounts = bShared == true ? this->m_pReadyBlockFlags + wFlagWordNumber : NULL;
+    this->m_pFreeBlockList = (WORD *) (((BYTE *) (this->m_pReadyBlockFlags + wFlagWordNumber)) + dwRefCountSize);
+    this->m_pMemoryBlockData = ((BYTE *) this->m_pFreeBlockList) + dwFreeListSize;
+
+    // Linked list: each entry contains the index of next free block
+    for (WORD i = 0; i < wBlockNumber; i++)
+    {
+      this->m_pFreeBlockList[i] = i + 1;
+    }
+    this->m_dwFreeListHead = 0;
+
+    memset(this->m_pUsedBlockFlags, 0, wFlagWordNumber * sizeof(DWORD) * 2);
+
+    #if (UTILITIES_DEBUG_LEVEL2)
+      DEBUG_PRINT("[DEBUG] CWideMemoryBlockArray_New, block size: ");
+      DEBUG_PRINT_DEC((unsigned int) wBlockSize);
+      DEBUG_PRINT(", block num: ");
+      DEBUG_PRINT_DEC((unsigned int) wBlockNumber);
+      DEBUG_PRINT(", data ptr: ");
+      DEBUG_PRINT_PTR(this->m_pMemoryBlockData);
+      DEBUG_PRINT_CR;
+    #endif
   }
 
-  // Should never occur
-  #if (UTILITIES_DEBUG_LEVEL0)
-    DEBUG_PRINT_LN("[ERROR] Base64_CharToCode - Invalid character for decoding");
-  #endif
+  return this;
+}
 
-  //TODO: improve error management
-  g_bBase64Error = true;
-  
-  return 0x00;
+CWideMemoryBlockArray CWideMemoryBlockArray_New(WORD wBlockSize, WORD wBlockNumber)
+{
+  return CWideMemoryBlockArray_Create(wBlockSize, wBlockNumber, false);
 }
 
-//
-// Public functions
-//
+CWideMemoryBlockArray CWideMemoryBlockArray_NewShared(WORD wBlockSize, WORD wBlockNumber)
+{
+  return CWideMemoryBlockArray_Create(wBlockSize, wBlockNumber, true);
+}
 
-WORD Base64_BinToB64Nopad(const BYTE * in, WORD size, BYTE * out, WORD max_len) 
+void CWideMemoryBlockArray_Delete(CWideMemoryBlockArray this)
 {
-  int i;
-  WORD result_len;  // size of the result 
-  int full_blocks;  // number of 3 unsigned chars / 4 characters blocks 
-  int last_bytes;   // number of unsigned chars <3 in the last block
-  int last_chars;   // number of characters <4 in the last block 
-  uint32_t b;
+  vPortFree(this);
+}
 
-  // Check input values
-  if (size == 0) 
+void * CWideMemoryBlockArray_GetBlock(CWideMemoryBlockArray this, CWideMemoryBlockArrayEntry pEntry)
+{
+  DWORD dwHead;
+  DWORD dwNewHead;
+  WORD wIndex;
+
+  // Pop first entry of free block list
+  // Note: The next index read in list may be obsolete if another task has modified the list
+  //       but in this case the tag of head has changed and the 'CompareExchange' fails
+  dwHead = __atomic_load_n(&this->m_dwFreeListHead, __ATOMIC_ACQUIRE);
+  do
   {
-    *out = 0;  // null string 
-    return 0;
+    wIndex = WIDEMEMORYBLOCKARRAY_HEAD_INDEX(dwHead);
+    if (wIndex >= this->m_wArraySize)
+    {
+      // All entries are used
+      pEntry->m_pDataBlock = NULL;
+      return NULL;
+    }
+    dwNewHead = WIDEMEMORYBLOCKARRAY_HEAD_NEXT(dwHead, this->m_pFreeBlockList[wIndex]);
   }
+  while (__atomic_compare_exchange_n(&this->m_dwFreeListHead, &dwHead, dwNewHead, false,
+                                     __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE) == false);
 
-  // Calculate the number of base64 'blocks' 
-  last_chars = 0;
-  full_blocks = size / 3;
-  last_bytes = size % 3;
-  switch (last_bytes) 
+  // Provide block
+  pEntry->m_wBlockIndex = wIndex;
+  pEntry->m_pDataBlock = this->m_pMemoryBlockData + (((DWORD) this->m_wMemoryBlockSize) * wIndex);
+
+  // Shared block: the caller owns the first reference
+  if (this->m_pRefCounts != NULL)
   {
-    case 1: 
-      // 1 byte left to encode -> +2 chars 
-      last_chars = 2;
-      break;
-    case 2:
-      // 2 bytes left to encode -> +3 chars 
-      last_chars = 3;
-      break;
+    __atomic_store_n(&this->m_pRefCounts[wIndex], 1, __ATOMIC_RELAXED);
   }
 
-  // Check if output buffer is big enough 
-  result_len = (4*full_blocks) + last_chars;
+  // Set used block flag
+  __atomic_fetch_or(&this->m_pUsedBlockFlags[wIndex / 32], WIDEMEMORYBLOCKARRAY_FLAG_MASK(wIndex), __ATOMIC_RELEASE);
 
   #if (UTILITIES_DEBUG_LEVEL2)
-    DEBUG_PRINT("[DEBUG] Base64_BinToB64Nopad - Data size: ");
-    DEBUG_PRINT_DEC(size);
-    DEBUG_PRINT(", Encoded size: ");
-    DEBUG_PRINT_DEC(result_len);
-    DEBUG_PRINT(", Available size: ");
-    DEBUG_PRINT_DEC(max_len);
+    DEBUG_PRINT("[DEBUG] CWideMemoryBlockArray_GetBlock, index: ");
+    DEBUG_PRINT_HEX((unsigned int) pEntry->m_wBlockIndex);
+    DEBUG_PRINT(", ptr: ");
+    DEBUG_PRINT_PTR(pEntry->m_pDataBlock);
     DEBUG_PRINT_CR;
   #endif
 
-  if (max_len < (result_len + 1)) 
-  { 
-    // 1 char added for string terminator 
+  return pEntry->m_pDataBlock;
+}
+
+bool CWideMemoryBlockArray_ReleaseBlock(CWideMemoryBlockArray this, WORD wBlockIndex)
+{
+  DWORD dwHead;
+  DWORD dwNewHead;
+  DWORD dwMask = WIDEMEMORYBLOCKARRAY_FLAG_MASK(wBlockIndex);
+
+  // Clear used and ready flags
+  // The used flag is tested and cleared atomically: a block released more than once is
+  // detected here and never pushed twice in free list
+  // Note: The ready flag is cleared only by the owner of the used flag (i.e. a stray release
+  //       of a block already reused by another task does not modify the new owner's flags)
+  if ((__atomic_fetch_and(&this->m_pUsedBlockFlags[wBlockIndex / 32], ~dwMask, __ATOMIC_ACQ_REL) & dwMask) == 0)
+  {
+    // Should never occur. 
+    // Implementation error on collection  usage (typically blocks released more than once)
+    #if (UTILITIES_DEBUG_LEVEL0)
+      DEBUG_PRINT_LN("[ERROR] CWideMemoryBlockArray_ReleaseBlock - Block already released");
+    #endif
+    return false;
+  }
+  __atomic_fetch_and(&this->m_pReadyBlockFlags[wBlockIndex / 32], ~dwMask, __ATOMIC_ACQ_REL);
+
+  // Push released block in free list
+  dwHead = __atomic_load_n(&this->m_dwFreeListHead, __ATOMIC_ACQUIRE);
+  do
+  {
+    this->m_pFreeBlockList[wBlockIndex] = WIDEMEMORYBLOCKARRAY_HEAD_INDEX(dwHead);
+    dwNewHead = WIDEMEMORYBLOCKARRAY_HEAD_NEXT(dwHead, wBlockIndex);
+  }
+  while (__atomic_compare_exchange_n(&this->m_dwFreeListHead, &dwHead, dwNewHead, false,
+                                     __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE) == false);
+
+  return true;
+}
+
+// Adds a reference to a shared block
+// Note: The caller must already own a reference on the block
+void CWideMemoryBlockArray_AddRef(CWideMemoryBlockArray this, WORD wBlockIndex)
+{
+  __atomic_add_fetch(&this->m_pRefCounts[wBlockIndex], 1, __ATOMIC_RELAXED);
+}
+
+// Releases a reference on a shared block
+// The block is released when the last reference is released (returned value is 'true' in
+// this case)
+bool CWideMemoryBlockArray_ReleaseRef(CWideMemoryBlockArray this, WORD wBlockIndex)
+{
+  if (__atomic_sub_fetch(&this->m_pRefCounts[wBlockIndex], 1, __ATOMIC_ACQ_REL) != 0)
+  {
+    return false;
+  }
+  return CWideMemoryBlockArray_ReleaseBlock(this, wBlockIndex);
+}
+
+bool CWideMemoryBlockArray_IsBlockUsed(CWideMemoryBlockArray this, WORD wBlockIndex)
+{
+  // Note: Read operation on atomic variable (i.e. mutex not required)
+  return (this->m_pUsedBlockFlags[wBlockIndex / 32] & WIDEMEMORYBLOCKARRAY_FLAG_MASK(wBlockIndex)) != 0 ? true : false;
+}
+
+WORD CWideMemoryBlockArray_BlockIndexFromPtr(CWideMemoryBlockArray this, void *pBlockPtr)
+{
+  return (WORD)((((BYTE*)pBlockPtr) - this->m_pMemoryBlockData) / this->m_wMemoryBlockSize);
+}
+
+void * CWideMemoryBlockArray_BlockPtrFromIndex(CWideMemoryBlockArray this, WORD wBlockIndex)
+{
+  return this->m_pMemoryBlockData + (((DWORD) wBlockIndex) * this->m_wMemoryBlockSize);
+}
+
+bool CWideMemoryBlockArray_IsBlockReady(CWideMemoryBlockArray this, WORD wBlockIndex)
+{
+  // Note: Read operation on atomic variable (i.e. mutex not required)
+  return (this->m_pReadyBlockFlags[wBlockIndex / 32] & WIDEMEMORYBLOCKARRAY_FLAG_MASK(wBlockIndex)) != 0 ? true : false;
+}
+
+void CWideMemoryBlockArray_SetBlockReady(CWideMemoryBlockArray this, WORD wBlockIndex)
+{
+  __atomic_fetch_or(&this->m_pReadyBlockFlags[wBlockIndex / 32], WIDEMEMORYBLOCKARRAY_FLAG_MASK(wBlockIndex), __ATOMIC_RELEASE);
+
+  #if (UTILITIES_DEBUG_LEVEL2)
+    DEBUG_PRINT("[DEBUG] CWideMemoryBlockArray_SetBlockReady BlockIndex: ");
+    DEBUG_PRINT_HEX((unsigned int) wBlockIndex);
+    DEBUG_PRINT(" , Flags value: ");
+    DEBUG_PRINT_HEX((unsigned int) this->m_pReadyBlockFlags[wBlockIndex / 32]);
+    DEBUG_PRINT_CR;
+  #endif
+}
+
+//
+// Snapshot enumerator methods
+//
+// Same rules as 'CMemoryBlockArray' snapshot enumerator, except that the 'used' and 'ready' 
+// flags are captured one word at a time (i.e. the size of snapshot object does not depend on
+// the size of the array). An entry added after 'SnapshotStart' may be enumerated if its flag
+// word has not yet been reached.
+//
+
+bool CWideMemoryBlockArray_SnapshotStart(CWideMemoryBlockArray this, CWideMemoryBlockArraySnapshot pSnapshot)
+{
+  pSnapshot->m_wWordIndex = 0;
+  pSnapshot->m_dwFlags = 0;
+  if (this->m_wFlagWordNumber > 0)
+  {
+    pSnapshot->m_dwFlags = __atomic_load_n(&this->m_pUsedBlockFlags[0], __ATOMIC_ACQUIRE) & 
+                           __atomic_load_n(&this->m_pReadyBlockFlags[0], __ATOMIC_ACQUIRE);
+  }
+  return CWideMemoryBlockArray_SnapshotNext(this, pSnapshot);
+}
+
+bool CWideMemoryBlockArray_SnapshotNext(CWideMemoryBlockArray this, CWideMemoryBlockArraySnapshot pSnapshot)
+{
+  BYTE usBit;
+
+  // Skip empty words
+  while (pSnapshot->m_dwFlags == 0)
+  {
+    if (++pSnapshot->m_wWordIndex >= this->m_wFlagWordNumber)
+    {
+      // Enumeration terminated
+      pSnapshot->m_wWordIndex = this->m_wFlagWordNumber;
+      return false;
+    }
+    pSnapshot->m_dwFlags = __atomic_load_n(&this->m_pUsedBlockFlags[pSnapshot->m_wWordIndex], __ATOMIC_ACQUIRE) & 
+                           __atomic_load_n(&this->m_pReadyBlockFlags[pSnapshot->m_wWordIndex], __ATOMIC_ACQUIRE);
+  }
+
+  // First block flagged in current word, clear its flag for next call
+  usBit = (BYTE) __builtin_clz(pSnapshot->m_dwFlags);
+  pSnapshot->m_dwFlags &= ~(0x80000000 >> usBit);
+
+  pSnapshot->m_wBlockIndex = (pSnapshot->m_wWordIndex * 32) + usBit;
+  pSnapshot->m_pItemData = this->m_pMemoryBlockData + (((DWORD) pSnapshot->m_wBlockIndex) * this->m_wMemoryBlockSize);
+  return true;
+}
+
+/********************************************************************************************* 
+ SpscRing Class
+
+ Lock-free ring of fixed size slots between one producer task and one consumer task
+
+ Notes: 
+  - The producer writes in slot 'm_dwWriteCount' and publishes it by incrementing the counter
+    (release), the consumer reads slot 'm_dwReadCount' and frees it by incrementing the
+    counter (release)
+  - The ring is full when 'm_dwWriteCount - m_dwReadCount' equals the depth (i.e. unsigned
+    difference valid across counter wrap because the depth is a power of 2)
+
+ WARNING: This object cannot be static. It MUST always be allocated by with the construction
+          method ('CSpscRing_New')
+*********************************************************************************************/
+
+// Private helper for slot address
+#define SPSCRING_SLOT_PTR(pRing, dwCount)   ((pRing)->m_pSlotData + (((dwCount) & ((pRing)->m_wDepth - 1)) * (DWORD) (pRing)->m_wSlotSize))
+
+
+CSpscRing CSpscRing_New(WORD wSlotSize, WORD wDepth)
+{
+  CSpscRing this;
+  WORD wRoundedDepth = 1;
+
+  // Depth rounded up to next power of 2 (maximum 32768 slots)
+  while ((wRoundedDepth < wDepth) && (wRoundedDepth < 0x8000))
+  {
+    wRoundedDepth <<= 1;
+  }
+
+  // Slots start on 32 bits boundaries
+  wSlotSize = (wSlotSize + 3) & ~0x03;
+
+  // Allocate memory for the object and slots
+  if ((this = (void *) pvPortMalloc(sizeof(CSpscRingOb) + (((DWORD) wSlotSize) * wRoundedDepth))) != NULL)
+  {
+    this->m_wSlotSize = wSlotSize;
+    this->m_wDepth = wRoundedDepth;
+    this->m_dwWriteCount = 0;
+    this->m_dwReadCount = 0;
+    this->m_dwDroppedNumber = 0;
+    this->m_wHighWatermark = 0;
+    this->m_pSlotData = ((BYTE *) this) + sizeof(CSpscRingOb);
+  }
+
+  #if (UTILITIES_DEBUG_LEVEL2)
+    DEBUG_PRINT("[DEBUG] CSpscRing_New, slot size: ");
+    DEBUG_PRINT_DEC((unsigned int) wSlotSize);
+    DEBUG_PRINT(", depth: ");
+    DEBUG_PRINT_DEC((unsigned int) wRoundedDepth);
+    DEBUG_PRINT_CR;
+  #endif
+
+  return this;
+}
+
+void CSpscRing_Delete(CSpscRing this)
+{
+  vPortFree(this);
+}
+
+// Producer: slot where next item must be written (NULL and item dropped if ring is full)
+void * CSpscRing_GetWriteSlot(CSpscRing this)
+{
+  DWORD dwWriteCount = this->m_dwWriteCount;
+
+  if (dwWriteCount - __atomic_load_n(&this->m_dwReadCount, __ATOMIC_ACQUIRE) >= this->m_wDepth)
+  {
+    ++this->m_dwDroppedNumber;
+    return NULL;
+  }
+  return SPSCRING_SLOT_PTR(this, dwWriteCount);
+}
+
+// Producer: publish the slot provided by 'GetWriteSlot'
+void CSpscRing_CommitWrite(CSpscRing this)
+{
+  DWORD dwWriteCount = this->m_dwWriteCount + 1;
+  WORD wOccupancy;
+
+  __atomic_store_n(&this->m_dwWriteCount, dwWriteCount, __ATOMIC_RELEASE);
+
+  wOccupancy = (WORD) (dwWriteCount - __atomic_load_n(&this->m_dwReadCount, __ATOMIC_ACQUIRE));
+  if (wOccupancy > this->m_wHighWatermark)
+  {
+    this->m_wHighWatermark = wOccupancy;
+  }
+}
+
+// Consumer: oldest published slot (NULL if ring is empty)
+void * CSpscRing_GetReadSlot(CSpscRing this)
+{
+  DWORD dwReadCount = this->m_dwReadCount;
+
+  if (__atomic_load_n(&this->m_dwWriteCount, __ATOMIC_ACQUIRE) == dwReadCount)
+  {
+    return NULL;
+  }
+  return SPSCRING_SLOT_PTR(this, dwReadCount);
+}
+
+// Consumer: free the slot provided by 'GetReadSlot'
+void CSpscRing_ReleaseRead(CSpscRing this)
+{
+  __atomic_store_n(&this->m_dwReadCount, this->m_dwReadCount + 1, __ATOMIC_RELEASE);
+}
+
+WORD CSpscRing_GetOccupancy(CSpscRing this)
+{
+  DWORD dwReadCount = __atomic_load_n(&this->m_dwReadCount, __ATOMIC_ACQUIRE);
+
+  return (WORD) (__atomic_load_n(&this->m_dwWriteCount, __ATOMIC_ACQUIRE) - dwReadCount);
+}
+
+WORD CSpscRing_GetHighWatermark(CSpscRing this)
+{
+  return this->m_wHighWatermark;
+}
+
+DWORD CSpscRing_GetDroppedNumber(CSpscRing this)
+{
+  return this->m_dwDroppedNumber;
+}
+
+
+/********************************************************************************************* 
+ MpscRing Class
+
+ Lock-free bounded queue of pointers between several producer tasks and one consumer task
+
+ Notes: 
+  - Bounded queue with one sequence number per cell (D. Vyukov's algorithm):
+     - Cell of position 'p' is free for producer when its sequence is 'p' and published for
+       consumer when its sequence is 'p + 1'
+     - The consumer frees the cell for the next round by setting its sequence to 'p + depth'
+  - The consumer stops on the first cell reserved but not yet published (i.e. FIFO order kept)
+  - The 'space available' callback uses a Dekker-like handshake (i.e. producer sets the flag
+    then checks the cell, consumer frees the cells then checks the flag), so the wakeup of a
+    blocked producer cannot be lost
+
+ WARNING: This object cannot be static. It MUST always be allocated by with the construction
+          method ('CMpscRing_New')
+*********************************************************************************************/
+
+// Private helper for cell address
+#define MPSCRING_CELL_PTR(pRing, dwPosition)   (&(pRing)->m_pCells[(dwPosition) & ((pRing)->m_wDepth - 1)])
+
+
+CMpscRing CMpscRing_New(WORD wDepth)
+{
+  CMpscRing this;
+  WORD wRoundedDepth = 1;
+
+  // Depth rounded up to next power of 2 (maximum 32768 cells)
+  while ((wRoundedDepth < wDepth) && (wRoundedDepth < 0x8000))
+  {
+    wRoundedDepth <<= 1;
+  }
+
+  // Allocate memory for the object and cells
+  if ((this = (void *) pvPortMalloc(sizeof(CMpscRingOb) + (((DWORD) sizeof(CMpscRingCellOb)) * wRoundedDepth))) != NULL)
+  {
+    this->m_wDepth = wRoundedDepth;
+    this->m_dwEnqueueCount = 0;
+    this->m_dwDequeueCount = 0;
+    this->m_dwProducerBlocked = 0;
+    this->m_pSpaceAvailable = NULL;
+    this->m_pSpaceContext = NULL;
+    this->m_dwRejectedNumber = 0;
+    this->m_dwFullNumber = 0;
+    this->m_wHighWatermark = 0;
+    this->m_pCells = (CMpscRingCellOb *) (((BYTE *) this) + sizeof(CMpscRingOb));
+
+    for (WORD i = 0; i < wRoundedDepth; i++)
+    {
+      this->m_pCells[i].m_dwSequence = i;
+      this->m_pCells[i].m_pItem = NULL;
+    }
+  }
+
+  #if (UTILITIES_DEBUG_LEVEL2)
+    DEBUG_PRINT("[DEBUG] CMpscRing_New, depth: ");
+    DEBUG_PRINT_DEC((unsigned int) wRoundedDepth);
+    DEBUG_PRINT_CR;
+  #endif
+
+  return this;
+}
+
+void CMpscRing_Delete(CMpscRing this)
+{
+  vPortFree(this);
+}
+
+// Callback invoked by consumer task when cells are freed after the queue was found full
+// Note: Must be set before producers start
+void CMpscRing_SetSpaceCallback(CMpscRing this, void (*pSpaceAvailable)(void *pContext), void *pContext)
+{
+  this->m_pSpaceContext = pContext;
+  this->m_pSpaceAvailable = pSpaceAvailable;
+}
+
+// Producer: append an item (false and item not queued if queue is full)
+bool CMpscRing_Push(CMpscRing this, void *pItem)
+{
+  CMpscRingCellOb *pCell;
+  DWORD dwPosition;
+  DWORD dwSequence;
+  WORD wOccupancy;
+
+  dwPosition = __atomic_load_n(&this->m_dwEnqueueCount, __ATOMIC_RELAXED);
+  while (true)
+  {
+    pCell = MPSCRING_CELL_PTR(this, dwPosition);
+    dwSequence = __atomic_load_n(&pCell->m_dwSequence, __ATOMIC_ACQUIRE);
+
+    if (dwSequence == dwPosition)
+    {
+      // Cell free for this position: reserve it
+      // Note: On failure, 'dwPosition' is updated with the position reserved by another producer
+      if (__atomic_compare_exchange_n(&this->m_dwEnqueueCount, &dwPosition, dwPosition + 1, true,
+                                      __ATOMIC_RELAXED, __ATOMIC_RELAXED) == true)
+      {
+        break;
+      }
+    }
+    else if ((int32_t) (dwSequence - dwPosition) < 0)
+    {
+      // Cell of previous round not yet read (i.e. queue full)
+      if (CMpscRing_SetProducerBlocked(this, dwPosition) == true)
+      {
+        __atomic_fetch_add(&this->m_dwRejectedNumber, 1, __ATOMIC_RELAXED);
+        return false;
+      }
+      dwPosition = __atomic_load_n(&this->m_dwEnqueueCount, __ATOMIC_RELAXED);
+    }
+    else
+    {
+      // Position already reserved by another producer
+      dwPosition = __atomic_load_n(&this->m_dwEnqueueCount, __ATOMIC_RELAXED);
+    }
+  }
+
+  // Publish the item
+  pCell->m_pItem = pItem;
+  __atomic_store_n(&pCell->m_dwSequence, dwPosition + 1, __ATOMIC_RELEASE);
+
+  // Statistics (approximate with concurrent producers)
+  wOccupancy = (WORD) (dwPosition + 1 - __atomic_load_n(&this->m_dwDequeueCount, __ATOMIC_ACQUIRE));
+  if (wOccupancy > this->m_wHighWatermark)
+  {
+    this->m_wHighWatermark = wOccupancy;
+  }
+  return true;
+}
+
+// Producer: check that at least one cell is free (the 'space available' callback is armed if
+// the queue is full)
+// Note: With a single producer, a 'true' result guarantees that next 'Push' succeeds
+bool CMpscRing_HasSpace(CMpscRing this)
+{
+  DWORD dwPosition = __atomic_load_n(&this->m_dwEnqueueCount, __ATOMIC_RELAXED);
+  DWORD dwSequence = __atomic_load_n(&MPSCRING_CELL_PTR(this, dwPosition)->m_dwSequence, __ATOMIC_ACQUIRE);
+
+  if ((int32_t) (dwSequence - dwPosition) >= 0)
+  {
+    return true;
+  }
+  return (CMpscRing_SetProducerBlocked(this, dwPosition) == false);
+}
+
+// Producer: the queue was found full at 'dwPosition'
+// Sets the 'blocked' flag and checks the cell again (i.e. the consumer may have freed it before
+// seeing the flag). Returns false if the cell is now free (i.e. producer must retry)
+bool CMpscRing_SetProducerBlocked(CMpscRing this, DWORD dwPosition)
+{
+  DWORD dwSequence;
+
+  if (__atomic_exchange_n(&this->m_dwProducerBlocked, 1, __ATOMIC_RELAXED) == 0)
+  {
+    __atomic_fetch_add(&this->m_dwFullNumber, 1, __ATOMIC_RELAXED);
+  }
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+  dwSequence = __atomic_load_n(&MPSCRING_CELL_PTR(this, dwPosition)->m_dwSequence, __ATOMIC_ACQUIRE);
+  return ((int32_t) (dwSequence - dwPosition) < 0);
+}
+
+// Consumer: read up to 'wMaxItems' published items in FIFO order (returns number of items)
+// The 'space available' callback is invoked if a producer found the queue full
+WORD CMpscRing_Pop(CMpscRing this, void **ppItems, WORD wMaxItems)
+{
+  CMpscRingCellOb *pCell;
+  DWORD dwPosition = this->m_dwDequeueCount;
+  WORD wItemNumber = 0;
+
+  while (wItemNumber < wMaxItems)
+  {
+    pCell = MPSCRING_CELL_PTR(this, dwPosition);
+    if (__atomic_load_n(&pCell->m_dwSequence, __ATOMIC_ACQUIRE) != dwPosition + 1)
+    {
+      // Queue empty or next item reserved but not yet published
+      break;
+    }
+
+    ppItems[wItemNumber++] = pCell->m_pItem;
+
+    // Free the cell for the next round
+    __atomic_store_n(&pCell->m_dwSequence, dwPosition + this->m_wDepth, __ATOMIC_RELEASE);
+    ++dwPosition;
+  }
+
+  if (wItemNumber > 0)
+  {
+    __atomic_store_n(&this->m_dwDequeueCount, dwPosition, __ATOMIC_RELEASE);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    if ((__atomic_load_n(&this->m_dwProducerBlocked, __ATOMIC_RELAXED) != 0) &&
+        (__atomic_exchange_n(&this->m_dwProducerBlocked, 0, __ATOMIC_ACQUIRE) != 0) &&
+        (this->m_pSpaceAvailable != NULL))
+    {
+      this->m_pSpaceAvailable(this->m_pSpaceContext);
+    }
+  }
+
+  return wItemNumber;
+}
+
+WORD CMpscRing_GetOccupancy(CMpscRing this)
+{
+  DWORD dwDequeueCount = __atomic_load_n(&this->m_dwDequeueCount, __ATOMIC_ACQUIRE);
+
+  return (WORD) (__atomic_load_n(&this->m_dwEnqueueCount, __ATOMIC_ACQUIRE) - dwDequeueCount);
+}
+
+WORD CMpscRing_GetHighWatermark(CMpscRing this)
+{
+  return this->m_wHighWatermark;
+}
+
+DWORD CMpscRing_GetRejectedNumber(CMpscRing this)
+{
+  return this->m_dwRejectedNumber;
+}
+
+DWORD CMpscRing_GetFullNumber(CMpscRing this)
+{
+  return this->m_dwFullNumber;
+}
+
+
+/********************************************************************************************* 
+ MinHeap Class
+
+ Binary min-heap of item indexes ordered by a 64 bits key (typically a timestamp)
+
+ Notes: 
+  - The children of entry at position 'i' are at positions '2i+1' and '2i+2'
+  - The 'm_pPositions' array is updated on each entry move (i.e. an item is located in the
+    heap without search)
+
+ WARNING: This object cannot be static. It MUST always be allocated by with the construction
+          method ('CMinHeap_New')
+*********************************************************************************************/
+
+// Private methods (i.e. entry moved to its position in heap order)
+
+static void CMinHeap_siftUp(CMinHeap this, WORD wPosition)
+{
+  CMinHeapEntryOb Entry = this->m_pEntries[wPosition];
+  WORD wParent;
+
+  while (wPosition > 0)
+  {
+    wParent = (wPosition - 1) / 2;
+    if (this->m_pEntries[wParent].m_qwKey <= Entry.m_qwKey)
+    {
+      break;
+    }
+
+    this->m_pEntries[wPosition] = this->m_pEntries[wParent];
+    this->m_pPositions[this->m_pEntries[wPosition].m_wItem] = wPosition;
+    wPosition = wParent;
+  }
+
+  this->m_pEntries[wPosition] = Entry;
+  this->m_pPositions[Entry.m_wItem] = wPosition;
+}
+
+static void CMinHeap_siftDown(CMinHeap this, WORD wPosition)
+{
+  CMinHeapEntryOb Entry = this->m_pEntries[wPosition];
+  DWORD dwChild;
+
+  while ((dwChild = (2 * (DWORD) wPosition) + 1) < this->m_wCount)
+  {
+    // Smallest child
+    if ((dwChild + 1 < this->m_wCount) && (this->m_pEntries[dwChild + 1].m_qwKey < this->m_pEntries[dwChild].m_qwKey))
+    {
+      ++dwChild;
+    }
+
+    if (Entry.m_qwKey <= this->m_pEntries[dwChild].m_qwKey)
+    {
+      break;
+    }
+
+    this->m_pEntries[wPosition] = this->m_pEntries[dwChild];
+    this->m_pPositions[this->m_pEntries[wPosition].m_wItem] = wPosition;
+    wPosition = (WORD) dwChild;
+  }
+
+  this->m_pEntries[wPosition] = Entry;
+  this->m_pPositions[Entry.m_wItem] = wPosition;
+}
+
+CMinHeap CMinHeap_New(WORD wItemNumber)
+{
+  CMinHeap this;
+
+  // The 'MINHEAP_NONE' value is not a valid item index
+  if (wItemNumber == MINHEAP_NONE)
+  {
+    return NULL;
+  }
+
+  // Allocate memory for the object, entries and positions
+  if ((this = (void *) pvPortMalloc(sizeof(CMinHeapOb) + (((DWORD) sizeof(CMinHeapEntryOb)) * wItemNumber) +
+                                    (((DWORD) sizeof(WORD)) * wItemNumber))) != NULL)
+  {
+    this->m_wItemNumber = wItemNumber;
+    this->m_wCount = 0;
+    this->m_pEntries = (CMinHeapEntryOb *) (((BYTE *) this) + sizeof(CMinHeapOb));
+    this->m_pPositions = (WORD *) (((BYTE *) this->m_pEntries) + (((DWORD) sizeof(CMinHeapEntryOb)) * wItemNumber));
+
+    for (WORD i = 0; i < wItemNumber; i++)
+    {
+      this->m_pPositions[i] = MINHEAP_NONE;
+    }
+  }
+
+  return this;
+}
+
+void CMinHeap_Delete(CMinHeap this)
+{
+  vPortFree(this);
+}
+
+// Inserts an item (or updates its key if the item is already in the heap)
+bool CMinHeap_Insert(CMinHeap this, WORD wItem, QWORD qwKey)
+{
+  WORD wPosition;
+
+  if (wItem >= this->m_wItemNumber)
+  {
+    return false;
+  }
+
+  if ((wPosition = this->m_pPositions[wItem]) == MINHEAP_NONE)
+  {
+    wPosition = this->m_wCount++;
+    this->m_pEntries[wPosition].m_wItem = wItem;
+    this->m_pEntries[wPosition].m_qwKey = qwKey;
+    this->m_pPositions[wItem] = wPosition;
+    CMinHeap_siftUp(this, wPosition);
+  }
+  else
+  {
+    this->m_pEntries[wPosition].m_qwKey = qwKey;
+    CMinHeap_siftUp(this, wPosition);
+    CMinHeap_siftDown(this, this->m_pPositions[wItem]);
+  }
+  return true;
+}
+
+bool CMinHeap_Remove(CMinHeap this, WORD wItem)
+{
+  WORD wPosition;
+
+  if ((wItem >= this->m_wItemNumber) || ((wPosition = this->m_pPositions[wItem]) == MINHEAP_NONE))
+  {
+    return false;
+  }
+
+  // The last entry replaces the removed entry
+  this->m_pPositions[wItem] = MINHEAP_NONE;
+  if (wPosition != --this->m_wCount)
+  {
+    this->m_pEntries[wPosition] = this->m_pEntries[this->m_wCount];
+    this->m_pPositions[this->m_pEntries[wPosition].m_wItem] = wPosition;
+    CMinHeap_siftUp(this, wPosition);
+    CMinHeap_siftDown(this, this->m_pPositions[this->m_pEntries[wPosition].m_wItem]);
+  }
+  return true;
+}
+
+// Item with the smallest key (left in the heap)
+bool CMinHeap_Peek(CMinHeap this, WORD *pItem, QWORD *pKey)
+{
+  if (this->m_wCount == 0)
+  {
+    return false;
+  }
+
+  *pItem = this->m_pEntries[0].m_wItem;
+  *pKey = this->m_pEntries[0].m_qwKey;
+  return true;
+}
+
+// Item with the smallest key (removed from the heap)
+bool CMinHeap_Pop(CMinHeap this, WORD *pItem, QWORD *pKey)
+{
+  if (CMinHeap_Peek(this, pItem, pKey) == false)
+  {
+    return false;
+  }
+
+  return CMinHeap_Remove(this, *pItem);
+}
+
+WORD CMinHeap_GetCount(CMinHeap this)
+{
+  return this->m_wCount;
+}
+
+// Returns the entry at a position of the heap (i.e. enumeration of items in heap order, not
+// sorted by key)
+bool CMinHeap_GetEntry(CMinHeap this, WORD wPosition, WORD *pItem, QWORD *pKey)
+{
+  if (wPosition >= this->m_wCount)
+  {
+    return false;
+  }
+
+  *pItem = this->m_pEntries[wPosition].m_wItem;
+  *pKey = this->m_pEntries[wPosition].m_qwKey;
+  return true;
+}
+
+
+/********************************************************************************************* 
+ HashIndex Class
+
+ Hash index of item indexes by a 32 bits key (typically a LoRa device address)
+
+ Notes: 
+  - Multiplicative hash (i.e. the bucket index is built from the high bits of 'key * 2^32 / 
+    golden ratio', all key bits are used)
+  - The new item is inserted at the head of its bucket list
+
+ WARNING: This object cannot be static. It MUST always be allocated by with the construction
+          method ('CHashIndex_New')
+*********************************************************************************************/
+
+// Private methods
+
+static inline WORD CHashIndex_bucketFromKey(CHashIndex this, DWORD dwKey)
+{
+  if (this->m_usBucketBits == 0)
+  {
+    return 0;
+  }
+  return (WORD) ((dwKey * 2654435769u) >> (32 - this->m_usBucketBits));
+}
+
+CHashIndex CHashIndex_New(WORD wItemNumber)
+{
+  CHashIndex this;
+  WORD wBucketNumber = 1;
+  BYTE usBucketBits = 0;
+
+  // The 'HASHINDEX_NONE' value is not a valid item index
+  if (wItemNumber == HASHINDEX_NONE)
+  {
+    return NULL;
+  }
+
+  // Number of buckets rounded up to next power of 2 (maximum 32768 buckets)
+  while ((wBucketNumber < wItemNumber) && (wBucketNumber < 0x8000))
+  {
+    wBucketNumber <<= 1;
+    ++usBucketBits;
+  }
+
+  // Allocate memory for the object, buckets, item links and keys
+  // Note: Keys first (i.e. 32 bits alignment)
+  if ((this = (void *) pvPortMalloc(sizeof(CHashIndexOb) + (((DWORD) sizeof(DWORD)) * wItemNumber) +
+                                    (((DWORD) sizeof(WORD)) * wItemNumber) + (((DWORD) sizeof(WORD)) * wBucketNumber))) != NULL)
+  {
+    this->m_wItemNumber = wItemNumber;
+    this->m_wBucketNumber = wBucketNumber;
+    this->m_usBucketBits = usBucketBits;
+    this->m_pKeys = (DWORD *) (((BYTE *) this) + sizeof(CHashIndexOb));
+    this->m_pNextItems = (WORD *) (((BYTE *) this->m_pKeys) + (((DWORD) sizeof(DWORD)) * wItemNumber));
+    this->m_pBuckets = this->m_pNextItems + wItemNumber;
+
+    for (WORD i = 0; i < wBucketNumber; i++)
+    {
+      this->m_pBuckets[i] = HASHINDEX_NONE;
+    }
+  }
+
+  #if (UTILITIES_DEBUG_LEVEL2)
+    DEBUG_PRINT("[DEBUG] CHashIndex_New, items: ");
+    DEBUG_PRINT_DEC((unsigned int) wItemNumber);
+    DEBUG_PRINT(", buckets: ");
+    DEBUG_PRINT_DEC((unsigned int) wBucketNumber);
+    DEBUG_PRINT_CR;
+  #endif
+
+  return this;
+}
+
+void CHashIndex_Delete(CHashIndex this)
+{
+  vPortFree(this);
+}
+
+// Inserts an item (the item MUST not be already in the index)
+// The function returns 'false' if the item is outside of the index range
+bool CHashIndex_Insert(CHashIndex this, WORD wItem, DWORD dwKey)
+{
+  WORD wBucket;
+
+  if (wItem >= this->m_wItemNumber)
+  {
+    return false;
+  }
+
+  wBucket = CHashIndex_bucketFromKey(this, dwKey);
+  this->m_pKeys[wItem] = dwKey;
+  this->m_pNextItems[wItem] = this->m_pBuckets[wBucket];
+  this->m_pBuckets[wBucket] = wItem;
+  return true;
+}
+
+bool CHashIndex_Remove(CHashIndex this, WORD wItem)
+{
+  WORD *pLink;
+
+  if (wItem >= this->m_wItemNumber)
+  {
+    return false;
+  }
+
+  // Look for the link to the item in its bucket list
+  pLink = &(this->m_pBuckets[CHashIndex_bucketFromKey(this, this->m_pKeys[wItem])]);
+  while (*pLink != HASHINDEX_NONE)
+  {
+    if (*pLink == wItem)
+    {
+      *pLink = this->m_pNextItems[wItem];
+      return true;
+    }
+    pLink = &(this->m_pNextItems[*pLink]);
+  }
+  return false;
+}
+
+// Last inserted item with the specified key ('HASHINDEX_NONE' if not found)
+WORD CHashIndex_Find(CHashIndex this, DWORD dwKey)
+{
+  WORD wItem = this->m_pBuckets[CHashIndex_bucketFromKey(this, dwKey)];
+
+  while ((wItem != HASHINDEX_NONE) && (this->m_pKeys[wItem] != dwKey))
+  {
+    wItem = this->m_pNextItems[wItem];
+  }
+  return wItem;
+}
+
+/********************************************************************************************* 
+ Base64 functions
+
+ Utility functions for Base64 encoding and decoding
+*********************************************************************************************/
+
+// Private variables for Base64 functions
+
+static char Base64_code_62 = '+';    // RFC 1421 standard character for code 62 
+static char Base64_code_63 = '/';    // RFC 1421 standard character for code 63 
+static char Base64_code_pad = '=';   // RFC 1421 padding character if padding 
+
+// Forward declarations
+// Note: The conversion error is returned in a flag owned by the caller (i.e. encoding and
+//       decoding are executed concurrently by 'ServerManager' and 'Connector' tasks)
+BYTE Base64_CodeToChar(BYTE x, bool *pbError);
+BYTE Base64_CharToCode(BYTE x, bool *pbError);
+
+//
+// Private functions
+//
+
+BYTE Base64_CodeToChar(BYTE x, bool *pbError)
+{
+  if (x <= 25) 
+  {
+    return 'A' + x;
+  } 
+  else if ((x >= 26) && (x <= 51)) 
+  {
+    return 'a' + (x-26);
+  }
+  else if ((x >= 52) && (x <= 61))
+  {
+    return '0' + (x-52);
+  }
+  else if (x == 62)
+  {
+    return Base64_code_62;
+  }
+  else if (x == 63) 
+  {
+    return Base64_code_63;
+  } 
+
+  // Should never occur
+  #if (UTILITIES_DEBUG_LEVEL0)
+    DEBUG_PRINT_LN("[ERROR] Base64_CodeToChar - Byte out of range 0-64 for encoding");
+  #endif
+
+  *pbError = true;
+  
+  return 0x00; 
+}
+
+BYTE Base64_CharToCode(BYTE x, bool *pbError)
+{
+  if ((x >= 'A') && (x <= 'Z')) 
+  {
+    return (BYTE)x - (BYTE)'A';
+  } 
+  else if ((x >= 'a') && (x <= 'z'))
+  {
+    return (BYTE)x - (BYTE)'a' + 26;
+  } 
+  else if ((x >= '0') && (x <= '9')) 
+  {
+    return (BYTE)x - (BYTE)'0' + 52;
+  } 
+  else if (x == Base64_code_62) 
+  {
+    return 62;
+  }
+  else if (x == Base64_code_63)
+  {
+    return 63;
+  }
+
+  // Should never occur
+  #if (UTILITIES_DEBUG_LEVEL0)
+    DEBUG_PRINT_LN("[ERROR] Base64_CharToCode - Invalid character for decoding");
+  #endif
+
+  *pbError = true;
+  
+  return 0x00;
+}
+
+//
+// Public functions
+//
+
+WORD Base64_BinToB64Nopad(const BYTE * in, WORD size, BYTE * out, WORD max_len) 
+{
+  int i;
+  WORD result_len;  // size of the result 
+  int full_blocks;  // number of 3 unsigned chars / 4 characters blocks 
+  int last_bytes;   // number of unsigned chars <3 in the last block
+  int last_chars;   // number of characters <4 in the last block 
+  uint32_t b;
+  bool bError;
+
+  // Check input values
+  if (size == 0) 
+  {
+    *out = 0;  // null string 
+    return 0;
+  }
+
+  // Calculate the number of base64 'blocks' 
+  last_chars = 0;
+  full_blocks = size / 3;
+  last_bytes = size % 3;
+  switch (last_bytes) 
+  {
+    case 1: 
+      // 1 byte left to encode -> +2 chars 
+      last_chars = 2;
+      break;
+    case 2:
+      // 2 bytes left to encode -> +3 chars 
+      last_chars = 3;
+      break;
+  }
+
+  // Check if output buffer is big enough 
+  result_len = (4*full_blocks) + last_chars;
+
+  #if (UTILITIES_DEBUG_LEVEL2)
+    DEBUG_PRINT("[DEBUG] Base64_BinToB64Nopad - Data size: ");
+    DEBUG_PRINT_DEC(size);
+    DEBUG_PRINT(", Encoded size: ");
+    DEBUG_PRINT_DEC(result_len);
+    DEBUG_PRINT(", Available size: ");
+    DEBUG_PRINT_DEC(max_len);
+    DEBUG_PRINT_CR;
+  #endif
+
+  if (max_len < (result_len + 1)) 
+  { 
+    // 1 char added for string terminator 
     #if (UTILITIES_DEBUG_LEVEL0)
       DEBUG_PRINT_LN("[ERROR] Base64_BinToB64Nopad - Output buffer too small");
     #endif
     return 0xFFFF;
   }
 
-  g_bBase64Error = false;
+  bError = false;
 
   // Process all the full blocks
   for (i=0; i < full_blocks; ++i)
@@ -520,10 +1714,10 @@ WORD Base64_BinToB64Nopad(const BYTE * in, WORD size, BYTE * out, WORD max_len)
     b  = (0xFF & in[3*i]) << 16;
     b |= (0xFF & in[3*i + 1]) << 8;
     b |=  0xFF & in[3*i + 2];
-    out[4*i + 0] = Base64_CodeToChar((b >> 18) & 0x3F);
-    out[4*i + 1] = Base64_CodeToChar((b >> 12) & 0x3F);
-    out[4*i + 2] = Base64_CodeToChar((b >> 6 ) & 0x3F);
-    out[4*i + 3] = Base64_CodeToChar( b & 0x3F);
+    out[4*i + 0] = Base64_CodeToChar((b >> 18) & 0x3F, &bError);
+    out[4*i + 1] = Base64_CodeToChar((b >> 12) & 0x3F, &bError);
+    out[4*i + 2] = Base64_CodeToChar((b >> 6 ) & 0x3F, &bError);
+    out[4*i + 3] = Base64_CodeToChar( b & 0x3F, &bError);
   }
 
   // Process the last 'partial' block and terminate string 
@@ -535,20 +1729,20 @@ WORD Base64_BinToB64Nopad(const BYTE * in, WORD size, BYTE * out, WORD max_len)
   else if (last_chars == 2) 
   {
     b = (0xFF & in[3*i]) << 16;
-    out[4*i + 0] = Base64_CodeToChar((b >> 18) & 0x3F);
-    out[4*i + 1] = Base64_CodeToChar((b >> 12) & 0x3F);
+    out[4*i + 0] = Base64_CodeToChar((b >> 18) & 0x3F, &bError);
+    out[4*i + 1] = Base64_CodeToChar((b >> 12) & 0x3F, &bError);
     out[4*i + 2] =  0; // null character to terminate string 
   } 
   else if (last_chars == 3) 
   {
     b = (0xFF & in[3*i]) << 16;
     b |= (0xFF & in[3*i + 1]) << 8;
-    out[4*i + 0] = Base64_CodeToChar((b >> 18) & 0x3F);
-    out[4*i + 1] = Base64_CodeToChar((b >> 12) & 0x3F);
-    out[4*i + 2] = Base64_CodeToChar((b >> 6 ) & 0x3F);
+    out[4*i + 0] = Base64_CodeToChar((b >> 18) & 0x3F, &bError);
+    out[4*i + 1] = Base64_CodeToChar((b >> 12) & 0x3F, &bError);
+    out[4*i + 2] = Base64_CodeToChar((b >> 6 ) & 0x3F, &bError);
     out[4*i + 3] = 0; // null character to terminate string 
   }
-  return g_bBase64Error == true ? 0xFFFF : result_len;
+  return bError == true ? 0xFFFF : result_len;
 }
 
 WORD Base64_B64ToBinNopad(const BYTE * in, WORD size, BYTE * out, WORD max_len)
@@ -559,6 +1753,7 @@ WORD Base64_B64ToBinNopad(const BYTE * in, WORD size, BYTE * out, WORD max_len)
   int last_chars;   // number of characters <4 in the last block 
   int last_bytes;   // number of unsigned chars <3 in the last block 
   uint32_t b;
+  bool bError;
 
   // Check input values
   if (size == 0) 
@@ -598,13 +1793,15 @@ WORD Base64_B64ToBinNopad(const BYTE * in, WORD size, BYTE * out, WORD max_len)
     return 0xFFFF;
   }
 
+  bError = false;
+
   // Process all the full blocks 
   for (i=0; i < full_blocks; ++i) 
   {
-    b = (0x3F & Base64_CharToCode(in[4*i])) << 18;
-    b |= (0x3F & Base64_CharToCode(in[4*i + 1])) << 12;
-    b |= (0x3F & Base64_CharToCode(in[4*i + 2])) << 6;
-    b |=  0x3F & Base64_CharToCode(in[4*i + 3]);
+    b = (0x3F & Base64_CharToCode(in[4*i], &bError)) << 18;
+    b |= (0x3F & Base64_CharToCode(in[4*i + 1], &bError)) << 12;
+    b |= (0x3F & Base64_CharToCode(in[4*i + 2], &bError)) << 6;
+    b |=  0x3F & Base64_CharToCode(in[4*i + 3], &bError);
     out[3*i + 0] = (b >> 16) & 0xFF;
     out[3*i + 1] = (b >> 8 ) & 0xFF;
     out[3*i + 2] =  b & 0xFF;
@@ -614,8 +1811,8 @@ WORD Base64_B64ToBinNopad(const BYTE * in, WORD size, BYTE * out, WORD max_len)
   i = full_blocks;
   if (last_bytes == 1) 
   {
-    b = (0x3F & Base64_CharToCode(in[4*i])) << 18;
-    b |= (0x3F & Base64_CharToCode(in[4*i + 1])) << 12;
+    b = (0x3F & Base64_CharToCode(in[4*i], &bError)) << 18;
+    b |= (0x3F & Base64_CharToCode(in[4*i + 1], &bError)) << 12;
     out[3*i + 0] = (b >> 16) & 0xFF;
     if (((b >> 12) & 0x0F) != 0) 
     {
@@ -626,9 +1823,9 @@ WORD Base64_B64ToBinNopad(const BYTE * in, WORD size, BYTE * out, WORD max_len)
   } 
   else if (last_bytes == 2) 
   {
-    b = (0x3F & Base64_CharToCode(in[4*i])) << 18;
-    b |= (0x3F & Base64_CharToCode(in[4*i + 1])) << 12;
-    b |= (0x3F & Base64_CharToCode(in[4*i + 2])) << 6;
+    b = (0x3F & Base64_CharToCode(in[4*i], &bError)) << 18;
+    b |= (0x3F & Base64_CharToCode(in[4*i + 1], &bError)) << 12;
+    b |= (0x3F & Base64_CharToCode(in[4*i + 2], &bError)) << 6;
     out[3*i + 0] = (b >> 16) & 0xFF;
     out[3*i + 1] = (b >> 8) & 0xFF;
     if (((b >> 6) & 0x03) != 0) 
@@ -638,7 +1835,7 @@ WORD Base64_B64ToBinNopad(const BYTE * in, WORD size, BYTE * out, WORD max_len)
       #endif
     }
   }
-  return g_bBase64Error == true ? 0xFFFF : result_len;
+  return bError == true ? 0xFFFF : result_len;
 }
 
 WORD Base64_BinToB64(const BYTE * in, WORD size, BYTE * out, WORD max_len) 
@@ -716,3 +1913,572 @@ WORD Base64_B64ToBin(const BYTE * in, WORD size, BYTE * out, WORD max_len)
   return Base64_B64ToBinNopad(in, size, out, max_len);
 }
 
+
+
+/********************************************************************************************* 
+ JsonWriter Class
+
+ Bounded writer for JSON streams (integer formatting, no 'sprintf')
+*********************************************************************************************/
+
+
+/*****************************************************************************************//**
+ * @fn         void CJsonWriter_Initialize(CJsonWriter this, BYTE *pStreamData, BYTE *pStreamEnd)
+ * 
+ * @brief      Starts writing a stream in the specified buffer.
+ * 
+ * @param      this
+ *             The pointer to CJsonWriter object (typically allocated on caller's stack).
+ *  
+ * @param      pStreamData
+ *             The position in buffer for first written byte.
+ *  
+ * @param      pStreamEnd
+ *             The end of buffer (i.e. pointer to 'last byte + 1').
+ *  
+ * @return     None.
+*********************************************************************************************/
+void CJsonWriter_Initialize(CJsonWriter this, BYTE *pStreamData, BYTE *pStreamEnd)
+{
+  this->m_pStreamHead = pStreamData;
+  this->m_pStreamEnd = pStreamEnd;
+  this->m_bOverflow = pStreamEnd < pStreamData ? true : false;
+}
+
+/*****************************************************************************************//**
+ * @fn         BYTE * CJsonWriter_End(CJsonWriter this)
+ * 
+ * @brief      Terminates the stream.
+ * 
+ * @param      this
+ *             The pointer to CJsonWriter object.
+ *  
+ * @return     The pointer to 'end of stream + 1' or NULL if the stream did not fit in buffer.
+ *
+ * @note       In case of overflow, the content of buffer is undefined after start position 
+ *             specified in 'CJsonWriter_Initialize'.
+*********************************************************************************************/
+BYTE * CJsonWriter_End(CJsonWriter this)
+{
+  return this->m_bOverflow == true ? NULL : this->m_pStreamHead;
+}
+
+void CJsonWriter_WriteByte(CJsonWriter this, BYTE usValue)
+{
+  if (this->m_pStreamHead < this->m_pStreamEnd)
+  {
+    *(this->m_pStreamHead++) = usValue;
+  }
+  else
+  {
+    this->m_bOverflow = true;
+  }
+}
+
+void CJsonWriter_WriteBytes(CJsonWriter this, const BYTE *pData, WORD wLength)
+{
+  if ((this->m_bOverflow == false) && ((DWORD) (this->m_pStreamEnd - this->m_pStreamHead) >= wLength))
+  {
+    memcpy(this->m_pStreamHead, pData, wLength);
+    this->m_pStreamHead += wLength;
+  }
+  else
+  {
+    this->m_bOverflow = true;
+  }
+}
+
+// Writes a null terminated string (null char not written)
+void CJsonWriter_WriteString(CJsonWriter this, const BYTE *szString)
+{
+  while (*szString != 0)
+  {
+    if (this->m_pStreamHead == this->m_pStreamEnd)
+    {
+      this->m_bOverflow = true;
+      return;
+    }
+    *(this->m_pStreamHead++) = *(szString++);
+  }
+}
+
+// Writes the decimal representation of an unsigned integer value
+void CJsonWriter_WriteUnsigned(CJsonWriter this, DWORD dwValue)
+{
+  BYTE usDigits[10];
+  BYTE usDigitNumber = 0;
+
+  // Digits are generated from lowest to highest
+  do
+  {
+    usDigits[usDigitNumber++] = '0' + (BYTE) (dwValue % 10);
+    dwValue /= 10;
+  } while (dwValue != 0);
+
+  if ((this->m_bOverflow == true) || ((DWORD) (this->m_pStreamEnd - this->m_pStreamHead) < usDigitNumber))
+  {
+    this->m_bOverflow = true;
+    return;
+  }
+
+  while (usDigitNumber > 0)
+  {
+    *(this->m_pStreamHead++) = usDigits[--usDigitNumber];
+  }
+}
+
+// Writes the decimal representation of an unsigned integer value using a fixed number of digits
+// (i.e. leading zeros added, highest digits truncated)
+// Typically used for date and time fields
+void CJsonWriter_WriteDigits(CJsonWriter this, DWORD dwValue, BYTE usDigitNumber)
+{
+  BYTE *pDigit;
+
+  if ((this->m_bOverflow == true) || ((DWORD) (this->m_pStreamEnd - this->m_pStreamHead) < usDigitNumber))
+  {
+    this->m_bOverflow = true;
+    return;
+  }
+
+  this->m_pStreamHead += usDigitNumber;
+  for (pDigit = this->m_pStreamHead - 1; usDigitNumber > 0; usDigitNumber--, pDigit--)
+  {
+    *pDigit = '0' + (BYTE) (dwValue % 10);
+    dwValue /= 10;
+  }
+}
+
+// Writes a fixed point value (i.e. 'dwValue' is the value multiplied by 10 ^ 'usDecimalNumber')
+// Example: value 1005 with 1 decimal is written '100.5'
+void CJsonWriter_WriteFixed(CJsonWriter this, DWORD dwValue, BYTE usDecimalNumber)
+{
+  DWORD dwDivider = 1;
+  BYTE usIndex;
+
+  for (usIndex = 0; usIndex < usDecimalNumber; usIndex++)
+  {
+    dwDivider *= 10;
+  }
+
+  CJsonWriter_WriteUnsigned(this, dwValue / dwDivider);
+  if (usDecimalNumber > 0)
+  {
+    CJsonWriter_WriteByte(this, '.');
+    CJsonWriter_WriteDigits(this, dwValue % dwDivider, usDecimalNumber);
+  }
+}
+
+// Writes binary data encoded in Base64 (with padding)
+void CJsonWriter_WriteBase64(CJsonWriter this, const BYTE *pData, WORD wSize)
+{
+  BYTE *pOut;
+  DWORD dwLength;
+  DWORD dwBlock;
+  WORD wIndex;
+  bool bError = false;
+
+  if (this->m_bOverflow == true)
+  {
+    return;
+  }
+
+  // Padded Base64 is written directly in stream (i.e. no string terminator, the encoded data
+  // may exactly fill the buffer)
+  dwLength = ((((DWORD) wSize) + 2) / 3) * 4;
+  if ((DWORD) (this->m_pStreamEnd - this->m_pStreamHead) < dwLength)
+  {
+    this->m_bOverflow = true;
+    return;
+  }
+
+  pOut = this->m_pStreamHead;
+  for (wIndex = 0; wIndex + 3 <= wSize; wIndex += 3)
+  {
+    dwBlock = (((DWORD) pData[wIndex]) << 16) | (((DWORD) pData[wIndex + 1]) << 8) | pData[wIndex + 2];
+    *(pOut++) = Base64_CodeToChar((dwBlock >> 18) & 0x3F, &bError);
+    *(pOut++) = Base64_CodeToChar((dwBlock >> 12) & 0x3F, &bError);
+    *(pOut++) = Base64_CodeToChar((dwBlock >> 6) & 0x3F, &bError);
+    *(pOut++) = Base64_CodeToChar(dwBlock & 0x3F, &bError);
+  }
+
+  // Last partial block (1 or 2 bytes left)
+  if (wIndex < wSize)
+  {
+    dwBlock = ((DWORD) pData[wIndex]) << 16;
+    if (wIndex + 1 < wSize)
+    {
+      dwBlock |= ((DWORD) pData[wIndex + 1]) << 8;
+    }
+    *(pOut++) = Base64_CodeToChar((dwBlock >> 18) & 0x3F, &bError);
+    *(pOut++) = Base64_CodeToChar((dwBlock >> 12) & 0x3F, &bError);
+    *(pOut++) = wIndex + 1 < wSize ? Base64_CodeToChar((dwBlock >> 6) & 0x3F, &bError) : Base64_code_pad;
+    *(pOut++) = Base64_code_pad;
+  }
+
+  this->m_pStreamHead = pOut;
+}
+
+
+
+/********************************************************************************************* 
+ JsonReader Class
+
+ Zero-copy tokenizer for JSON streams (members of one object enumerated without copy)
+*********************************************************************************************/
+
+// Private helpers
+void CJsonReader_SkipSpaces(CJsonReader this);
+bool CJsonReader_ReadString(CJsonReader this, CJsonToken pToken);
+bool CJsonReader_ReadValue(CJsonReader this, CJsonToken pToken);
+
+
+/*****************************************************************************************//**
+ * @fn         bool CJsonReader_Initialize(CJsonReader this, const BYTE *pStreamData, 
+ *                                         const BYTE *pStreamEnd)
+ * 
+ * @brief      Starts reading the members of the JSON object contained in specified stream.
+ * 
+ * @param      this
+ *             The pointer to CJsonReader object (typically allocated on caller's stack).
+ *  
+ * @param      pStreamData
+ *             The first byte of the stream (i.e. the opening brace of object, possibly 
+ *             preceded by white spaces).
+ *  
+ * @param      pStreamEnd
+ *             The end of stream (i.e. pointer to 'last byte + 1').
+ *  
+ * @return     The function returns 'true' if the stream starts with a JSON object.
+ *
+ * @note       The stream is not modified and must remain available while the reader and 
+ *             the returned tokens are used.
+*********************************************************************************************/
+bool CJsonReader_Initialize(CJsonReader this, const BYTE *pStreamData, const BYTE *pStreamEnd)
+{
+  this->m_pStreamHead = pStreamData;
+  this->m_pStreamEnd = pStreamEnd;
+  this->m_bError = false;
+
+  CJsonReader_SkipSpaces(this);
+  if ((this->m_pStreamHead >= this->m_pStreamEnd) || (*this->m_pStreamHead != '{'))
+  {
+    this->m_bError = true;
+    return false;
+  }
+  ++this->m_pStreamHead;
+  return true;
+}
+
+// Starts reading the members of a nested object (i.e. token returned by 'CJsonReader_NextMember')
+bool CJsonReader_InitializeFromToken(CJsonReader this, CJsonToken pObjectToken)
+{
+  if (pObjectToken->m_usType != JSONREADER_TOKEN_OBJECT)
+  {
+    this->m_bError = true;
+    return false;
+  }
+  return CJsonReader_Initialize(this, pObjectToken->m_pData, pObjectToken->m_pData + pObjectToken->m_wLength);
+}
+
+/*****************************************************************************************//**
+ * @fn         bool CJsonReader_NextMember(CJsonReader this, CJsonToken pName, CJsonToken pValue)
+ * 
+ * @brief      Reads the next member of object.
+ * 
+ * @param      this
+ *             The pointer to CJsonReader object.
+ *  
+ * @param      pName
+ *             The token receiving the name of member.
+ *  
+ * @param      pValue
+ *             The token receiving the value of member.
+ *  
+ * @return     The function returns 'true' if a member is read or 'false' when there is no more
+ *             member in object (or on syntax error).
+ *
+ * @note       The caller must check the 'm_bError' member variable of reader to detect syntax
+ *             errors (i.e. when the function returns 'false').
+*********************************************************************************************/
+bool CJsonReader_NextMember(CJsonReader this, CJsonToken pName, CJsonToken pValue)
+{
+  if (this->m_bError == true)
+  {
+    return false;
+  }
+
+  CJsonReader_SkipSpaces(this);
+  if (this->m_pStreamHead >= this->m_pStreamEnd)
+  {
+    // Object not terminated
+    this->m_bError = true;
+    return false;
+  }
+
+  if (*this->m_pStreamHead == '}')
+  {
+    // End of object (the reader stays on closing brace)
+    return false;
+  }
+
+  // Member name
+  if ((CJsonReader_ReadString(this, pName) == false))
+  {
+    this->m_bError = true;
+    return false;
+  }
+
+  // Name separator
+  CJsonReader_SkipSpaces(this);
+  if ((this->m_pStreamHead >= this->m_pStreamEnd) || (*this->m_pStreamHead != ':'))
+  {
+    this->m_bError = true;
+    return false;
+  }
+  ++this->m_pStreamHead;
+
+  // Member value
+  CJsonReader_SkipSpaces(this);
+  if (CJsonReader_ReadValue(this, pValue) == false)
+  {
+    this->m_bError = true;
+    return false;
+  }
+
+  // Member separator (or end of object, processed on next call)
+  CJsonReader_SkipSpaces(this);
+  if (this->m_pStreamHead >= this->m_pStreamEnd)
+  {
+    this->m_bError = true;
+    return false;
+  }
+  if (*this->m_pStreamHead == ',')
+  {
+    ++this->m_pStreamHead;
+  }
+  else if (*this->m_pStreamHead != '}')
+  {
+    this->m_bError = true;
+    return false;
+  }
+  return true;
+}
+
+void CJsonReader_SkipSpaces(CJsonReader this)
+{
+  while ((this->m_pStreamHead < this->m_pStreamEnd) &&
+         ((*this->m_pStreamHead == ' ') || (*this->m_pStreamHead == '\t') || 
+          (*this->m_pStreamHead == '\r') || (*this->m_pStreamHead == '\n')))
+  {
+    ++this->m_pStreamHead;
+  }
+}
+
+// Reads a string (the reader is on opening quote)
+// The token is the content between quotes (escape sequences are skipped, not decoded)
+bool CJsonReader_ReadString(CJsonReader this, CJsonToken pToken)
+{
+  const BYTE *pStart;
+
+  if ((this->m_pStreamHead >= this->m_pStreamEnd) || (*this->m_pStreamHead != '"'))
+  {
+    return false;
+  }
+  pStart = ++this->m_pStreamHead;
+
+  while (this->m_pStreamHead < this->m_pStreamEnd)
+  {
+    if (*this->m_pStreamHead == '"')
+    {
+      pToken->m_usType = JSONREADER_TOKEN_STRING;
+      pToken->m_pData = pStart;
+      pToken->m_wLength = (WORD) (this->m_pStreamHead - pStart);
+      ++this->m_pStreamHead;
+      return true;
+    }
+    if (*this->m_pStreamHead == '\\')
+    {
+      // Escaped char
+      ++this->m_pStreamHead;
+    }
+    ++this->m_pStreamHead;
+  }
+
+  // String not terminated
+  return false;
+}
+
+// Reads a value (the reader is on first char of value)
+// Objects and arrays are skipped and returned as one token (brackets included)
+bool CJsonReader_ReadValue(CJsonReader this, CJsonToken pToken)
+{
+  const BYTE *pStart = this->m_pStreamHead;
+  BYTE usDepth;
+  CJsonTokenOb StringToken;
+
+  if (pStart >= this->m_pStreamEnd)
+  {
+    return false;
+  }
+
+  if (*pStart == '"')
+  {
+    return CJsonReader_ReadString(this, pToken);
+  }
+
+  if ((*pStart == '{') || (*pStart == '['))
+  {
+    // Skip nested values up to matching closing bracket
+    // Note: Only the depth is counted (i.e. matching of brackets types is not checked)
+    pToken->m_usType = *pStart == '{' ? JSONREADER_TOKEN_OBJECT : JSONREADER_TOKEN_ARRAY;
+    usDepth = 0;
+    while (this->m_pStreamHead < this->m_pStreamEnd)
+    {
+      if (*this->m_pStreamHead == '"')
+      {
+        if (CJsonReader_ReadString(this, &StringToken) == false)
+        {
+          return false;
+        }
+        continue;
+      }
+      if ((*this->m_pStreamHead == '{') || (*this->m_pStreamHead == '['))
+      {
+        if (++usDepth > JSONREADER_MAX_DEPTH)
+        {
+          return false;
+        }
+      }
+      else if ((*this->m_pStreamHead == '}') || (*this->m_pStreamHead == ']'))
+      {
+        if (--usDepth == 0)
+        {
+          ++this->m_pStreamHead;
+          pToken->m_pData = pStart;
+          pToken->m_wLength = (WORD) (this->m_pStreamHead - pStart);
+          return true;
+        }
+      }
+      ++this->m_pStreamHead;
+    }
+    return false;
+  }
+
+  // Number or literal: all chars up to next separator
+  if (((*pStart >= '0') && (*pStart <= '9')) || (*pStart == '-'))
+  {
+    pToken->m_usType = JSONREADER_TOKEN_NUMBER;
+    while ((this->m_pStreamHead < this->m_pStreamEnd) && 
+           (((*this->m_pStreamHead >= '0') && (*this->m_pStreamHead <= '9')) || (*this->m_pStreamHead == '-') ||
+            (*this->m_pStreamHead == '+') || (*this->m_pStreamHead == '.') || 
+            (*this->m_pStreamHead == 'e') || (*this->m_pStreamHead == 'E')))
+    {
+      ++this->m_pStreamHead;
+    }
+  }
+  else
+  {
+    pToken->m_usType = JSONREADER_TOKEN_LITERAL;
+    while ((this->m_pStreamHead < this->m_pStreamEnd) && 
+           (*this->m_pStreamHead >= 'a') && (*this->m_pStreamHead <= 'z'))
+    {
+      ++this->m_pStreamHead;
+    }
+  }
+
+  pToken->m_pData = pStart;
+  pToken->m_wLength = (WORD) (this->m_pStreamHead - pStart);
+  return pToken->m_wLength > 0 ? true : false;
+}
+
+// Converts a 'true' or 'false' literal
+bool CJsonToken_GetBool(CJsonToken this, bool *pbValue)
+{
+  if (this->m_usType == JSONREADER_TOKEN_LITERAL)
+  {
+    if (JSONREADER_TOKEN_EQUALS(this, "true"))
+    {
+      *pbValue = true;
+      return true;
+    }
+    if (JSONREADER_TOKEN_EQUALS(this, "false"))
+    {
+      *pbValue = false;
+      return true;
+    }
+  }
+  return false;
+}
+
+// Converts a positive integer number (32 bits)
+bool CJsonToken_GetUnsigned(CJsonToken this, DWORD *pdwValue)
+{
+  return CJsonToken_GetFixed(this, 0, pdwValue);
+}
+
+// Converts a positive decimal number to fixed point value (i.e. value multiplied by 10 ^ 'usDecimalNumber')
+// Example: '869.525' with 6 decimals is converted to 869525000
+// Note: Additional decimals are truncated, exponent notation is not supported
+bool CJsonToken_GetFixed(CJsonToken this, BYTE usDecimalNumber, DWORD *pdwValue)
+{
+  const BYTE *pChar = this->m_pData;
+  const BYTE *pEnd = this->m_pData + this->m_wLength;
+  uint64_t qwValue = 0;
+  bool bDecimal = false;
+
+  if ((this->m_usType != JSONREADER_TOKEN_NUMBER) || (pChar == pEnd) || (*pChar < '0') || (*pChar > '9'))
+  {
+    return false;
+  }
+
+  for (; pChar < pEnd; pChar++)
+  {
+    if ((*pChar == '.') && (bDecimal == false))
+    {
+      bDecimal = true;
+      continue;
+    }
+    if ((*pChar < '0') || (*pChar > '9'))
+    {
+      return false;
+    }
+    if (bDecimal == true)
+    {
+      if (usDecimalNumber == 0)
+      {
+        // Truncated
+        continue;
+      }
+      --usDecimalNumber;
+    }
+    qwValue = (qwValue * 10) + (*pChar - '0');
+    if (qwValue > 0xFFFFFFFF)
+    {
+      return false;
+    }
+  }
+
+  // Missing decimals
+  for (; usDecimalNumber > 0; usDecimalNumber--)
+  {
+    qwValue *= 10;
+    if (qwValue > 0xFFFFFFFF)
+    {
+      return false;
+    }
+  }
+
+  *pdwValue = (DWORD) qwValue;
+  return true;
+}
+
+// Decodes a Base64 string (padded or not) directly in the specified buffer
+// The function returns the number of decoded bytes or 0xFFFF on error (like 'Base64_B64ToBin')
+WORD CJsonToken_GetBase64(CJsonToken this, BYTE *pData, WORD wMaxLength)
+{
+  if (this->m_usType != JSONREADER_TOKEN_STRING)
+  {
+    return 0xFFFF;
+  }
+  return Base64_B64ToBin(this->m_pData, this->m_wLength, pData, wMaxLength);
+}
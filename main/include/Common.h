@@ -23,14 +23,28 @@ COMMENT : This file must be included in first position in all C source files.
 # include <time.h> 
 # include <sys/time.h> 
 
+#ifdef ESP_PLATFORM
+
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/queue.h"
 #include "freertos/semphr.h"
 #include "freertos/event_groups.h"
 #include "esp_system.h"
+#include "esp_timer.h"
 #include "sdkconfig.h"
 
+#else
+
+// Linux host: FreeRTOS POSIX port (kernel headers without 'freertos/' prefix)
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+#include "event_groups.h"
+
+#endif
+
 #include "Definitions.h"
 
 #endif 
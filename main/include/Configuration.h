@@ -26,11 +26,26 @@ COMMENTS: For the early version configuration is statically defined in software.
 //    configuration file and provided to 'CLoraNodeManager' object
 //  - The operation mode for the gateway is:
 //     .. Each CSX1276 is used for both uplink and downlink on a configured channel frequency
+//        (i.e. one channel per CSX1276, several uplink channels received at the same time)
 //     .. The CSX1276 is waiting for uplink LoRa packets (i.e. continuous receive mode by default)
 //     .. The CSX1276 operation mode is changed to 'Send' mode only when a downlink packet is
 //        received from the Network Server (typically LoRa 'ACK' message)
 //////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+// Number of LoRa transceivers (CSX1276) present in the gateway
+// Notes:
+//  - Maximum value is 'GATEWAY_MAX_LORATRANSCEIVERS'
+//  - The settings below must be defined for each transceiver (the SPI slave ID selects the CS and
+//    IRQ pins, see 'SX1276_DEVICE_PINS')
+//  - The default board has one SX1276 (slave ID 0: CS on GPIO 22, IRQ on GPIO 2)
+//  - To enable a second SX1276 on the shared SPI bus:
+//     .. Wire its CS on GPIO 18 and its DIO0 on GPIO 4 (slave ID 1, or change 'SX1276_DEVICE_PINS')
+//     .. Set 'CONFIG_LORA_TRANSCEIVER_NUMBER' to 2
+//     .. Select in settings [1] a channel not used by another transceiver (typically
+//        'LORATRANSCEIVERITF_FREQUENCY_CHANNEL_01' for 868.3 MHz, two transceivers on the same
+//        channel are rejected by 'CLoraNodeManager')
+#define CONFIG_LORA_TRANSCEIVER_NUMBER   1
+
 #ifdef NODEMANAGERCONFIG_IMPL
 
 CTransceiverManagerItf_InitializeParamsOb g_LoraNodeManagerSettings = 
@@ -69,6 +84,12 @@ CTransceiverManagerItf_InitializeParamsOb g_LoraNodeManagerSettings =
           .m_usFreqChannel = LORATRANSCEIVERITF_FREQUENCY_CHANNEL_18,
           .m_bForce = false
         },
+        .Scan =
+        {
+          .m_usChannelNumber = 0
+        },
+        .m_wReceiveRingDepth = 8,
+        .m_usSpiSlaveID = 0
       },
       [1] =
       {
@@ -99,7 +120,61 @@ CTransceiverManagerItf_InitializeParamsOb g_LoraNodeManagerSettings =
         {
           .m_usFreqChannel = LORATRANSCEIVERITF_FREQUENCY_CHANNEL_17,
           .m_bForce = false
-        }
+        },
+        .Scan =
+        {
+          .m_usChannelNumber = 0
+        },
+        .m_wReceiveRingDepth = 8,
+        .m_usSpiSlaveID = 1
+      },
+      [2] =
+      {
+        .LoraMAC = 
+        {
+          .m_wPreambleLength = LORATRANSCEIVERITF_PREAMBLE_LENGTH_NONE,
+          .m_usSyncWord = LORATRANSCEIVERITF_SYNCWORD_NONE,
+          .m_usHeader = LORATRANSCEIVERITF_HEADER_NONE,
+          .m_usCRC = LORATRANSCEIVERITF_CRC_NONE,
+          .m_bForce = false
+        },
+        .LoraMode =
+        { 
+          .m_usLoraMode = LORATRANSCEIVERITF_LORAMODE_NONE,
+          .m_usCodingRate = LORATRANSCEIVERITF_CR_5,
+          .m_usSpreadingFactor = LORATRANSCEIVERITF_SF_7,
+          .m_usBandwidth = LORATRANSCEIVERITF_BANDWIDTH_125,
+          .m_bForce = false
+        },
+        .PowerMode = 
+        {
+          .m_usPowerMode = LORATRANSCEIVERITF_POWER_MODE_LOW,
+          .m_usPowerLevel = LORATRANSCEIVERITF_POWER_LEVEL_NONE,
+          .m_usOcpRate = LORATRANSCEIVERITF_OCP_NONE,
+          .m_bForce = false
+        },
+        .FreqChannel = 
+        {
+          .m_usFreqChannel = LORATRANSCEIVERITF_FREQUENCY_CHANNEL_02,
+          .m_bForce = false
+        },
+        .Scan =
+        {
+          // Example: channel 02 scanned on SF7 and SF8, channel 01 on SF9 (i.e. shared with 
+          // transceiver 1 in SF7)
+          .m_Channels = 
+          {
+            { .m_usFreqChannel = LORATRANSCEIVERITF_FREQUENCY_CHANNEL_02, .m_usSpreadingFactor = LORATRANSCEIVERITF_SF_7 },
+            { .m_usFreqChannel = LORATRANSCEIVERITF_FREQUENCY_CHANNEL_02, .m_usSpreadingFactor = LORATRANSCEIVERITF_SF_8 },
+            { .m_usFreqChannel = LORATRANSCEIVERITF_FREQUENCY_CHANNEL_01, .m_usSpreadingFactor = LORATRANSCEIVERITF_SF_9 }
+          },
+          .m_usChannelNumber = 3,
+          .m_wHopTime = LORATRANSCEIVERITF_SCAN_HOP_TIME_NONE,
+          .m_bAdaptiveDwell = true,
+          .m_pStatistics = NULL
+        },
+        .m_wReceiveRingDepth = 8,
+        .m_usSpiSlaveID = 2
       }
     }
   };
@@ -116,6 +191,7 @@ CTransceiverManagerItf_InitializeParamsOb g_LoraNodeManagerSettings =
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 // Maximum number of nodes managed by the gateway
+// Note: Maximum value is 65535 (i.e. size of node receive window and realtime packet collections)
 #define CONFIG_NODE_MAX_NUMBER     20
 
 
@@ -138,6 +214,29 @@ CTransceiverManagerItf_InitializeParamsOb g_LoraNodeManagerSettings =
 #define CONFIG_NETWORK_SERVER_TTN      1
 //#define CONFIG_NETWORK_SERVER_LORIOT   1
 
+// Aggregation of uplink LoRa packets in messages sent to Network Server
+//  - CONFIG_UPLINK_AGGREGATION_WINDOW = Maximum delay (milliseconds) for waiting additional LoRa packets before
+//    sending the message. The 0 value disables aggregation (i.e. one message per LoRa packet)
+//  - CONFIG_UPLINK_AGGREGATION_MTU = Maximum size (bytes) of a message containing several LoRa packets
+//    (bounded by 'LORASERVERMANAGER_MAX_UPMESSAGE_LENGTH')
+#define CONFIG_UPLINK_AGGREGATION_WINDOW   0
+#define CONFIG_UPLINK_AGGREGATION_MTU      1400
+
+// Store-and-forward of uplink messages (i.e. messages stored when no 'ServerConnector' can send them and replayed
+// when a 'ServerConnector' is available again)
+//  - CONFIG_UPLINK_LOG_ENABLE = The 0 value disables the store-and-forward log
+//  - CONFIG_UPLINK_LOG_PARTITION = Label of the data partition used for the log (device, see partitions.csv). The log is disabled if
+//    this partition is not defined in the partition table
+//  - CONFIG_UPLINK_LOG_FILE and CONFIG_UPLINK_LOG_FILE_SIZE = File and size (bytes) used for the log (Linux host)
+//  - CONFIG_UPLINK_LOG_REPLAY_PERIOD = Minimum delay (milliseconds) between two replayed messages
+//  - CONFIG_UPLINK_LOG_RETRY_PERIOD = Delay (milliseconds) before next replay attempt when a replayed message fails
+#define CONFIG_UPLINK_LOG_ENABLE           1
+#define CONFIG_UPLINK_LOG_PARTITION        "uplinklog"
+#define CONFIG_UPLINK_LOG_FILE             "uplinklog.bin"
+#define CONFIG_UPLINK_LOG_FILE_SIZE        (64 * 1024)
+#define CONFIG_UPLINK_LOG_REPLAY_PERIOD    200
+#define CONFIG_UPLINK_LOG_RETRY_PERIOD     10000
+
 
 #ifdef SEMTECHPROTOCOLENGINE_IMPL
 
@@ -151,6 +250,10 @@ CTransceiverManagerItf_InitializeParamsOb g_LoraNodeManagerSettings =
 //#define CONFIG_SEMTECH_PULLDATA_PERIOD  25000
 #define CONFIG_SEMTECH_PULLDATA_PERIOD  100000
 
+// Maximum delay (milliseconds) for receiving the ACK (PUSH_ACK or PULL_ACK) of an uplink message
+// The uplink session is reported as failed to 'ServerManager' when this delay is elapsed
+#define CONFIG_SEMTECH_ACK_TIMEOUT  2000
+
 #endif
 
 
@@ -212,5 +315,98 @@ CServerManagerItf_InitializeParamsOb g_LoraServerManagerSettings =
   };
 
 #endif
+
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Placement of gateway tasks on ESP32 cores
+//
+// Note:
+//  - The radio path (SX1276 IRQ, uplink ring and realtime downlink transmission) is isolated on one core and
+//    the encoding / backhaul path (Network Server protocol, WiFi) on the other core
+//  - On ESP32, the WiFi and lwIP tasks of the framework are running on core 0 (i.e. backhaul core)
+//  - The task names must be unique in the first 15 characters (i.e. 'configMAX_TASK_NAME_LEN')
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Cores used for the radio path and for the encoding / backhaul path
+#define CONFIG_TASK_RADIO_CORE             TASKPLACEMENT_CORE_1
+#define CONFIG_TASK_BACKHAUL_CORE          TASKPLACEMENT_CORE_0
+
+// Period (milliseconds) of the utilisation and latency traces (the 0 value disables the monitor task)
+#define CONFIG_TASK_MONITOR_PERIOD         60000
+
+
+#ifdef TASKPLACEMENTCONFIG_IMPL
+
+const CTaskPlacementEntryOb g_TaskPlacementTable[TASKPLACEMENT_TASK_NUMBER] =
+  {
+    // Radio path (priorities ordered by timing constraint)
+    [TASKPLACEMENT_TASK_SX1276] =                     { "SX1276",          CONFIG_TASK_RADIO_CORE,     12, 4096 },
+    [TASKPLACEMENT_TASK_REALTIMESENDER] =             { "RealtimeSender",  CONFIG_TASK_RADIO_CORE,     14, 2048 },
+    [TASKPLACEMENT_TASK_NODEMANAGER_TRANSCEIVER] =    { "NodeMgrXcvr",     CONFIG_TASK_RADIO_CORE,     11, 2048 },
+    [TASKPLACEMENT_TASK_NODEMANAGER_SERVER] =         { "NodeMgrServer",   CONFIG_TASK_RADIO_CORE,     10, 2048 },
+
+    // Encoding and backhaul
+    [TASKPLACEMENT_TASK_NODEMANAGER_SESSION] =        { "NodeMgrSession",  CONFIG_TASK_BACKHAUL_CORE,   6, 2048 },
+    [TASKPLACEMENT_TASK_SERVERMANAGER_NODEMANAGER] =  { "SrvMgrNodeMgr",   CONFIG_TASK_BACKHAUL_CORE,   8, 2048 },
+    [TASKPLACEMENT_TASK_SERVERMANAGER_MAIN] =         { "SrvMgrMain",      CONFIG_TASK_BACKHAUL_CORE,   6, 2048 },
+    [TASKPLACEMENT_TASK_SERVERMANAGER_CONNECTOR] =    { "SrvMgrConnector", CONFIG_TASK_BACKHAUL_CORE,   7, 2048 },
+    [TASKPLACEMENT_TASK_WIFICONNECTOR_MAIN] =         { "WifiConnector",   CONFIG_TASK_BACKHAUL_CORE,   5, 2048 },
+    [TASKPLACEMENT_TASK_WIFICONNECTOR_RECEIVE] =      { "WifiReceive",     CONFIG_TASK_BACKHAUL_CORE,   7, 2048 },
+
+    // Trace of utilisation and latency, drain of binary trace records
+    [TASKPLACEMENT_TASK_MONITOR] =                    { "GwMonitor",       TASKPLACEMENT_CORE_ANY,      1, 3072 },
+    [TASKPLACEMENT_TASK_TRACEDRAIN] =                 { "GwTraceDrain",    TASKPLACEMENT_CORE_ANY,      1, 3072 },
+
+    // Simulated devices (Linux host load generator, replaces the SX1276 task)
+    #ifndef ESP_PLATFORM
+      [TASKPLACEMENT_TASK_NODESWARM] =                { "NodeSwarm",       CONFIG_TASK_RADIO_CORE,     12, 3072 }
+    #endif
+  };
+
+#endif
+
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Simulated LoRaWAN devices (load generator)
+//
+// Note:
+//  - Used when 'CLoraNodeSwarm_CreateInstance' is the transceiver factory of 'CLoraNodeManager' (i.e. Linux
+//    host build, see AppMain.c)
+//  - The devices are distributed over the transceivers (device index modulo 'CONFIG_LORA_TRANSCEIVER_NUMBER')
+//    and the burst size applies to each transceiver
+//  - The frames are not encrypted (i.e. random FRMPayload and MIC, the Network Server must not check the MIC)
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#if defined(LORANODESWARMCONFIG_IMPL) && !defined(ESP_PLATFORM)
+
+const CLoraNodeSwarmConfigOb g_LoraNodeSwarmConfig =
+  {
+    .m_DevAddrRanges = { { .m_dwFirstDevAddr = 0x26011000, .m_wNodeNumber = 100 } },
+    .m_usDevAddrRangeNumber = 1,
+
+    .m_wFirstFCnt = 0,
+    .m_usFCntStep = 1,
+
+    .m_usSFWeights = { 40, 20, 15, 10, 10, 5 },       // SF7 ... SF12
+
+    .m_usMinPayloadLength = 10,
+    .m_usMaxPayloadLength = 30,
+    .m_usFPort = 1,
+
+    .m_usArrivalMode = LORANODESWARM_ARRIVAL_POISSON,
+    .m_dwMeanPeriod = 60000,                           // Poisson: mean interval between uplinks of a device
+    .m_dwBurstPeriod = 30000,                          // Bursty: 'm_wBurstSize' uplinks every 'm_dwBurstPeriod'
+    .m_wBurstSize = 20,                                //         within 'm_dwBurstSpread'
+    .m_dwBurstSpread = 2000,
+
+    .m_usConfirmedPercent = 10,
+    .m_dwRxWindowTolerance = 1000,
+    .m_bResumeReceive = true,                          // The 'false' value reproduces 'CSX1276' (StandBy after send)
+
+    .m_dwReportPeriod = 60000,
+    .m_dwSeed = 1
+  };
+
+#endif
 #endif
 
@@ -26,6 +26,7 @@ COMMENTS: The version string MUST be updated during the build process of a new r
 #define BYTE   uint8_t
 #define WORD   uint16_t
 #define DWORD  uint32_t
+#define QWORD  uint64_t
 
 
 /********************************************************************************************* 
@@ -53,6 +54,30 @@ COMMENTS: The version string MUST be updated during the build process of a new r
 #define bitSet(value, bit) ((value) |= (1UL << (bit)))     // set bit to '1'
 #define bitClear(value, bit) ((value) &= ~(1UL << (bit)))  // set bit to '0'
 
+// Gateway clock: microseconds since boot (64 bits, never wraps)
+// Note: 'esp_timer_get_time' is safe in ISR (i.e. used to timestamp LoRa packets at IRQ edge)
+//       On Linux host, the monotonic clock of the process is used
+//       With 'GATEWAY_CLOCK_VIRTUAL', the clock is provided by a host harness (i.e. simulated
+//       time, see 'sx1276_mock_vclock' in CMakeLists.txt)
+#ifdef ESP_PLATFORM
+  #define GATEWAY_CLOCK_MICROSEC()  ((QWORD) esp_timer_get_time())
+#elif defined(GATEWAY_CLOCK_VIRTUAL)
+  #define GATEWAY_CLOCK_MICROSEC()  (GatewayClock_VirtualMicrosec())
+
+  uint64_t GatewayClock_VirtualMicrosec(void);
+#else
+  #define GATEWAY_CLOCK_MICROSEC()  (GatewayClock_HostMicrosec())
+
+  static inline uint64_t GatewayClock_HostMicrosec(void)
+  {
+    struct timespec tsNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &tsNow);
+    return ((uint64_t) tsNow.tv_sec * 1000000) + (uint64_t) (tsNow.tv_nsec / 1000);
+  }
+#endif
+#define GATEWAY_CLOCK_MS_TO_US(dwMilliSec)  ((QWORD) (dwMilliSec) * 1000)
+
 
 /********************************************************************************************* 
   Helper macros
@@ -74,6 +99,7 @@ COMMENTS: The version string MUST be updated during the build process of a new r
 #define DEBUG_PRINT_DEC(value)  (printf("%d", (DWORD) value))
 #define DEBUG_PRINT_BYTE(value) (printf("0x%.2X", (BYTE) value))
 #define DEBUG_PRINT_WORD(value) (printf("0x%.4X", (WORD) value))
+#define DEBUG_PRINT_PTR(value)  (printf("%p", (void *) (value)))
 
 
 /********************************************************************************************* 
@@ -101,7 +127,9 @@ COMMENTS: The version string MUST be updated during the build process of a new r
 
 
 #define UTILITIES_DEBUG_LEVEL              (DEBUG_LEVEL0)
-#define SX1276_DEBUG_LEVEL                 (DEBUG_LEVEL2 | DEBUG_LEVEL1 | DEBUG_LEVEL0)
+#ifndef SX1276_DEBUG_LEVEL
+  #define SX1276_DEBUG_LEVEL               (DEBUG_LEVEL2 | DEBUG_LEVEL1 | DEBUG_LEVEL0)
+#endif
 #define LORANODEMANAGER_DEBUG_LEVEL        (DEBUG_LEVEL2 | DEBUG_LEVEL1 | DEBUG_LEVEL0)
 #define LORASERVERMANAGER_DEBUG_LEVEL      (DEBUG_LEVEL2 | DEBUG_LEVEL1 | DEBUG_LEVEL0)
 #define ESP32WIFICONNECTOR_DEBUG_LEVEL     (DEBUG_LEVEL2 | DEBUG_LEVEL1 | DEBUG_LEVEL0)
@@ -111,6 +139,21 @@ COMMENTS: The version string MUST be updated during the build process of a new r
 
 #define SEMTECHPROTOCOLENGINE_DEBUG_LEVEL  (DEBUG_LEVEL2 | DEBUG_LEVEL1 | DEBUG_LEVEL0)
 #define LORAREALTIMESENDER_DEBUG_LEVEL  (DEBUG_LEVEL2 | DEBUG_LEVEL1 | DEBUG_LEVEL0)
+#define UPLINKLOG_DEBUG_LEVEL              (DEBUG_LEVEL0)
+#define LORADUTYCYCLE_DEBUG_LEVEL          (DEBUG_LEVEL0)
+#define TASKPLACEMENT_DEBUG_LEVEL          (DEBUG_LEVEL0)
+#define LORANODESWARM_DEBUG_LEVEL          (DEBUG_LEVEL0)
+
+// Binary trace records on hot paths (see TraceRing.h)
+//  - 0 = Trace points removed at compile time
+//  - 1 = Trace points write records in trace rings (rendered by low priority drain task)
+#define TRACERING_ENABLE                   1
+
+
+// Implementation of 'CMemoryBlockArray' allocation of blocks
+//  - 0 = Free block list protected by RTOS mutex
+//  - 1 = Lock-free free block list (atomic compare and exchange on tagged list head)
+#define MEMORYBLOCKARRAY_LOCKFREE          1
 
 
 
@@ -34,6 +34,8 @@
   Includes
 *********************************************************************************************/
 
+#ifdef ESP_PLATFORM
+
 #include "esp_event_loop.h"
 #include "esp_wifi.h"
 #include "nvs_flash.h"
@@ -46,7 +48,22 @@
 
 #include "apps/sntp/sntp.h"
 
-//#include <sys/socket.h>
+#else
+
+// Linux host: POSIX sockets (i.e. the host network is always joined)
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <unistd.h>
+#include <errno.h>
+
+#ifndef BIT0
+  #define BIT0    0x00000001
+  #define BIT1    0x00000002
+#endif
+
+#endif
 
 
 #include "Utilities.h"
@@ -93,8 +110,9 @@ typedef struct _CESP32WifiConnector_Message
 {
   // Public
   WORD m_wMessageType;                            // The message
-  DWORD m_dwMessageData;                          // Depends on message type
-                                                  // Value or pointer to object
+  uintptr_t m_dwMessageData;                      // Depends on message type
+                                                  // Value or pointer to object (i.e. size of
+                                                  // pointer, DWORD on ESP32)
   DWORD m_dwMessageData2;                         // Depends on message type
 } CESP32WifiConnector_MessageOb;
 
@@ -127,7 +145,7 @@ typedef struct _CESP32WifiConnector
 
   // 'WifiConnector' task (main automaton)
   // Used for internal messages and external commands via 'IServerConnector' interface
-  TaskFunction_t m_hWifiConnectorTask;
+  TaskHandle_t m_hWifiConnectorTask;
   QueueHandle_t m_hWifiConnectorQueue;
 
   // For command processing by 'WifiConnector' task
@@ -138,7 +156,7 @@ typedef struct _CESP32WifiConnector
 
 
   // Task used to receive messages from Network Server (downlink)
-  TaskFunction_t m_hReceiveTask;
+  TaskHandle_t m_hReceiveTask;
 
   // Storage of received downlink messages
   CMemoryBlockArray m_pServerMessageArray;
@@ -266,7 +284,9 @@ CESP32WifiConnector * CESP32WifiConnector_New();
 void CESP32WifiConnector_Delete(CESP32WifiConnector *this);
 
 // Wifi event handler
-static esp_err_t CESP32WifiConnector_WifiEventHandler(void *pCtx, system_event_t *pEvent);
+#ifdef ESP_PLATFORM
+  static esp_err_t CESP32WifiConnector_WifiEventHandler(void *pCtx, system_event_t *pEvent);
+#endif
 
 // Low level Wifi
 #define WIFI_EVENT_GROUP_CONNECTED_BIT     BIT0
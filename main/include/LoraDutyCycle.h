@@ -0,0 +1,124 @@
+/*****************************************************************************************//**
+ * @file     LoraDutyCycle.h
+ *
+ * @author   F.Fargon
+ *
+ * @version  V1.0
+ *
+ * @date     16/10/2026
+ *
+ * @brief    Time-on-air and duty-cycle accounting for downlink transmissions.
+ *
+ * @details  This file implements the 'CLoraDutyCycle' class:\n
+ *            - Time-on-air of a LoRa packet for given radio settings
+ *            - Sliding window ledger of transmission time for each EU868 sub-band (i.e.
+ *              duty-cycle limits of ETSI EN 300 220)
+*********************************************************************************************/
+
+#ifndef LORADUTYCYCLE_H_
+#define LORADUTYCYCLE_H_
+
+/*********************************************************************************************
+  Definitions for debug traces
+  The debug level is specified with 'LORADUTYCYCLE_DEBUG_LEVEL' in Definitions.h file
+*********************************************************************************************/
+
+#define LORADUTYCYCLE_DEBUG_LEVEL0 ((LORADUTYCYCLE_DEBUG_LEVEL & 0x01) > 0)
+#define LORADUTYCYCLE_DEBUG_LEVEL1 ((LORADUTYCYCLE_DEBUG_LEVEL & 0x02) > 0)
+#define LORADUTYCYCLE_DEBUG_LEVEL2 ((LORADUTYCYCLE_DEBUG_LEVEL & 0x04) > 0)
+
+
+/*********************************************************************************************
+  Definitions (implementation)
+*********************************************************************************************/
+
+// EU868 sub-bands (ETSI EN 300 220) and their duty-cycle limit
+#define LORADUTYCYCLE_SUBBAND_G           0       // 863.0 - 868.0 MHz, 1%
+#define LORADUTYCYCLE_SUBBAND_G1          1       // 868.0 - 868.6 MHz, 1%
+#define LORADUTYCYCLE_SUBBAND_G2          2       // 868.7 - 869.2 MHz, 0.1%
+#define LORADUTYCYCLE_SUBBAND_G3          3       // 869.4 - 869.65 MHz, 10%
+#define LORADUTYCYCLE_SUBBAND_NUMBER      4
+
+#define LORADUTYCYCLE_SUBBAND_NONE        0xFF    // Frequency channel outside of known sub-bands
+
+// Transmission time allowed in the observation period for each sub-band (microseconds)
+#define LORADUTYCYCLE_SUBBAND_BUDGETS     { 36000000, 36000000, 3600000, 360000000 }
+
+// Observation period of the ledger (1 hour) and duration of a bucket (1 minute)
+// Note: The ledger keeps one more bucket than the observation period (i.e. the current bucket
+//       is partially elapsed). The transmission time is counted in the bucket of its start
+//       time, so the ledger never underestimates the transmission time of the last hour
+#define LORADUTYCYCLE_BUCKET_TIME         60000000
+#define LORADUTYCYCLE_BUCKET_NUMBER       61
+
+
+/*********************************************************************************************
+ LoraDutyCycle Class
+
+ Duty-cycle ledger of a gateway
+
+ For each sub-band, the transmission time is cumulated in buckets of 'LORADUTYCYCLE_BUCKET_TIME'
+ used as a ring:
+  - The buckets older than the observation period are cleared when the ledger is accessed with
+    a more recent timestamp (i.e. sliding window)
+  - The transmission time of the window is maintained with the bucket values (i.e. check of
+    a transmission does not enumerate the buckets)
+
+ Notes:
+  - The transmissions are reserved when scheduled (i.e. timestamps are in the near future and
+    not always in ascending order)
+  - The object is not thread safe (used only by 'ScheduleSendNodePacket' of 'LoraRealtimeSender')
+
+ WARNING: This object cannot be static. It MUST always be allocated by with the construction
+          method ('CLoraDutyCycle_New')
+*********************************************************************************************/
+
+// Ledger of one sub-band
+typedef struct _CLoraDutyCycleSubBand
+{
+  // Transmission time allowed in the observation period (microseconds)
+  DWORD m_dwBudget;
+
+  // Transmission time of the window (i.e. sum of 'm_dwBuckets')
+  DWORD m_dwWindowAirtime;
+
+  // Absolute index of most recent bucket (i.e. timestamp / 'LORADUTYCYCLE_BUCKET_TIME')
+  QWORD m_qwHeadBucket;
+
+  // Transmission time cumulated in each bucket (microseconds)
+  DWORD m_dwBuckets[LORADUTYCYCLE_BUCKET_NUMBER];
+
+} CLoraDutyCycleSubBandOb;
+
+typedef struct _CLoraDutyCycleSubBand * CLoraDutyCycleSubBand;
+
+
+// Class data
+typedef struct _CLoraDutyCycle
+{
+  CLoraDutyCycleSubBandOb m_SubBands[LORADUTYCYCLE_SUBBAND_NUMBER];
+
+  // Number of transmissions rejected because sub-band budget is exhausted
+  DWORD m_dwRejectedNumber;
+
+} CLoraDutyCycleOb;
+
+typedef struct _CLoraDutyCycle * CLoraDutyCycle;
+
+
+// Public methods
+CLoraDutyCycle CLoraDutyCycle_New();
+void CLoraDutyCycle_Delete(CLoraDutyCycle this);
+
+bool CLoraDutyCycle_Check(CLoraDutyCycle this, BYTE usSubBand, QWORD qwTimestamp, DWORD dwAirtime);
+void CLoraDutyCycle_Reserve(CLoraDutyCycle this, BYTE usSubBand, QWORD qwTimestamp, DWORD dwAirtime);
+DWORD CLoraDutyCycle_GetWindowAirtime(CLoraDutyCycle this, BYTE usSubBand);
+DWORD CLoraDutyCycle_GetRejectedNumber(CLoraDutyCycle this);
+
+// Radio helpers
+DWORD CLoraDutyCycle_GetTimeOnAir(BYTE usSpreadingFactor, BYTE usBandwidth, BYTE usCodingRate, WORD wPreambleLength,
+                                  bool bHeader, bool bCRC, DWORD dwPayloadLength);
+BYTE CLoraDutyCycle_GetSubBand(BYTE usFreqChannel);
+
+
+#endif
@@ -49,21 +49,27 @@
 
 // Number of items in memory array for 'CLoraPacketSessionOb' (uplink sessions)
 // Typically, session life time depends on number of nodes (and speed of forwarder)
-// Note: Maximum value is 255
+// Note: Maximum value is 65535
 #define LORANODEMANAGER_MAX_UP_LORASESSIONS (GATEWAY_MAX_LORATRANSCEIVERS * 3)
 
 // Number of items in memory array for 'CLoraDownPacketSessionOb' (downlink sessions)
 // Typically, session life time depends on LoRa configuration for 'receive windows' (Class A)
 // and strategy of Network Server for downlink message
-// Note: Maximum value is 255
+// Note: Maximum value is 65535
 #define LORANODEMANAGER_MAX_DOWN_LORASESSIONS (GATEWAY_MAX_LORATRANSCEIVERS * 5)
 
 // Number of items in memory array for 'CLoraTransceiverItf_LoraPacketOb' (uplink and downlink)
 // Note: Uplink packets have a short life time in this storage area (i.e. time required by
 //       the gateway to transfer packet data from one side to the other)
-// Note: Maximum value is 255
+// Note: Maximum value is 65535
 #define LORANODEMANAGER_MAX_LORAPACKETS (LORANODEMANAGER_MAX_UP_LORASESSIONS + LORANODEMANAGER_MAX_DOWN_LORASESSIONS)
 
+// Size of memory blocks for 'CLoraTransceiverItf_LoraPacketOb' (uplink and downlink)
+// Note: These blocks are shared packet buffers (i.e. uplink packets are directly received in
+//       them by 'LoraTransceivers'). The size is a multiple of 4 bytes in order to keep each
+//       packet on 32 bits boundary (i.e. DMA transfers and DWORD members)
+#define LORANODEMANAGER_LORAPACKET_BLOCK_SIZE ((sizeof(CLoraTransceiverItf_LoraPacketOb) + LORA_MAX_PAYLOAD_LENGTH + 3) & ~0x03)
+
 
 // Constants for 'MessageType' in 'MAC Header' (MHDR field) of Lora packet
 #define LORANODEMANAGER_MSG_TYPE_BASE             0
@@ -135,17 +141,22 @@ typedef struct _CLoraPacketSession
   BYTE m_usMHDR;
   BYTE m_usMessageType;
 
-  // Packet timestamp
-  DWORD m_dwTimestamp;
+  // Packet timestamp (gateway clock in microseconds)
+  QWORD m_qwTimestamp;
 
   // Additional information for received LoRa packet (uplink)
   CLoraTransceiverItf_ReceivedLoraPacketInfoOb m_ReceivedPacketInfo;
 
   // Access to this 'LoraPacketSession' object in 'm_pLoraPacketSessionArray' of parent 'CLoraNodeManager'
-  CMemoryBlockArrayEntryOb m_LoraSessionEntry;
+  CWideMemoryBlockArrayEntryOb m_LoraSessionEntry;
 
   // Access to associated LoRa packet in 'm_pLoraPacketArray' of parent 'CLoraNodeManager'
-  CMemoryBlockArrayEntryOb m_LoraPacketEntry;
+  CWideMemoryBlockArrayEntryOb m_LoraPacketEntry;
+
+  // Exchange object for uplink packet transmitted to 'ServerManager' ('SENDING_UPLINK' state)
+  // Note: The handle pushed in the uplink queue of 'ServerManager'. The object is no more used by
+  //       'ServerManager' when the 'ACCEPTED' or 'REJECTED' session event is received
+  CServerManagerItf_LoraSessionPacketOb m_ForwardedPacket;
 
 
 } CLoraPacketSessionOb;
@@ -180,10 +191,10 @@ typedef struct _CLoraDownPacketSession
   BYTE m_usMessageType;
 
   // Access to this 'LoraDownPacketSession' object in 'm_pLoraDownPacketSessionArray' of parent 'CLoraNodeManager'
-  CMemoryBlockArrayEntryOb m_LoraSessionEntry;
+  CWideMemoryBlockArrayEntryOb m_LoraSessionEntry;
 
   // Access to associated LoRa packet in 'm_pLoraPacketArray' of parent 'CLoraNodeManager'
-  CMemoryBlockArrayEntryOb m_LoraPacketEntry;
+  CWideMemoryBlockArrayEntryOb m_LoraPacketEntry;
 
 
 } CLoraDownPacketSessionOb;
@@ -211,6 +222,19 @@ typedef struct _CTransceiverDescr
   // Interface to associated 'LoraTransceiver'
   ILoraTransceiver m_pLoraTransceiverItf;
 
+  // Receive ring (producer = 'LoraTransceiver', consumer = 'Transceiver' task)
+  // Note: Created on 'Initialize' with 'm_wReceiveRingDepth' of transceiver settings
+  CSpscRing m_pReceiveRing;
+
+  // Scanner mode of transceiver settings and cumulated statistics of scanned channels
+  // Note: Scan parameters provided to 'LoraTransceiver' on each 'Receive' command
+  CLoraTransceiverItf_ScanParamsOb m_ScanParams;
+  CLoraTransceiverItf_ScanStatisticsOb m_ScanStatistics[LORATRANSCEIVERITF_SCAN_MAX_CHANNELS];
+
+  // Radio settings used for downlink packets (i.e. transceiver settings with default values
+  // applied, provided to 'LoraRealtimeSender' for time-on-air and duty-cycle accounting)
+  CLoraRealtimeSenderItf_RadioParamsOb m_DownlinkRadio;
+
 } CTransceiverDescrOb;
 
 typedef struct _CTransceiverDescr * CTransceiverDescr;
@@ -228,8 +252,9 @@ typedef struct _CLoraNodeManager_Message
 {
   // Public
   WORD m_wMessageType;                            // The message
-  DWORD m_dwMessageData;                          // Depends on message type
-                                                  // Value or pointer to object
+  uintptr_t m_dwMessageData;                      // Depends on message type
+                                                  // Value or pointer to object (i.e. size of
+                                                  // pointer, DWORD on ESP32)
   DWORD m_dwMessageData2;                         // Depends on message type
 } CLoraNodeManager_MessageOb;
 
@@ -270,7 +295,7 @@ typedef struct _CLoraNodeManager
 
   // 'SessionManager' task (main automaton)
   // Used for internal messages and external commands via 'ITransceiverManager' interface
-  TaskFunction_t m_hSessionManagerTask;
+  TaskHandle_t m_hSessionManagerTask;
   QueueHandle_t m_hSessionManagerQueue;
 
   // For command processing by 'SessionManager' task
@@ -283,13 +308,13 @@ typedef struct _CLoraNodeManager
   // 'Transceiver' task (automaton for exchange with 'LoraTransceivers')
   // Used to process uplink packets received from 'LoraTransceiver' and notification for downlink packets
   // 'Sent' by 'LoraTransceiver' (i.e. via 'ILoraTransceiverItf')
-  TaskFunction_t m_hTransceiverTask;
+  TaskHandle_t m_hTransceiverTask;
   QueueHandle_t m_hTransceiverNotifQueue;
 
   // 'Server' task (automaton for exchange with 'ServerManager')
   // Used to process downlink packets received from 'ServerManager' and notification for uplink packets
   // 'Sent' by the 'ServerManager' (i.e. via 'IServerManagerItf')
-  TaskFunction_t m_hServerTask;
+  TaskHandle_t m_hServerTask;
   QueueHandle_t m_hServerNotifQueue;
 
   //
@@ -298,13 +323,13 @@ typedef struct _CLoraNodeManager
 
   // Task in 'CServerManager' object to ask for sending (forward) uplink packets to Network Server
   // A NULL value indicates that 'ServerManager' is not attached (see 'IServerManager_Attach' method)
-  TaskFunction_t m_hPacketForwarderTask;
+  TaskHandle_t m_hPacketForwarderTask;
 
-  // Packet currently sent in 'SENDING_UPLINK' 'LoraSession' state
-  // Note: This object is owned by the 'CLoraNodeManager' object. It must be explicitly released by the
-  //       'CServerManager' when it is no more required for the send operation (i.e. 'Send' method on 
-  //       'IServerManager' interface) 
-  CServerManagerItf_LoraSessionPacketOb m_ForwardedUplinkPacket;
+  // Bounded queue of uplink packets owned by 'CServerManager' (i.e. drained by 'm_hPacketForwarderTask')
+  // The queue items are the 'm_ForwardedPacket' objects of 'LoraPacketSessions' in 'SENDING_UPLINK' state
+  // Backpressure: when the queue is full, the received packets are left in the receive rings of
+  // 'LoraTransceivers' until the 'ServerManager' frees space in the queue (see 'UplinkQueueSpaceAvailable')
+  CMpscRing m_pUplinkQueue;
 
   // LoRa Packet Session are uniquely identified
   // Counters for unique ID generation (uplink and downlink sessions)
@@ -318,22 +343,27 @@ typedef struct _CLoraNodeManager
   // Interface to dedicated object used to send LoRa packet just in time
   ILoraRealtimeSender m_pRealtimeSenderItf;
 
+  // Cumulated statistics of downlink transmissions (i.e. accuracy of TX start for each RX window)
+  CLoraRealtimeSenderItf_TxStatisticsOb m_TxStatistics[LORAREALTIMESENDER_RXWINDOW_NUMBER];
+
   //
   // Session management
   //
 
   // Memory block array for LoRa packets (i.e. whole payload used with 'LoraTransceiver')
   // This array contains both uplink and downlink LoRa packets
-  CMemoryBlockArray m_pLoraPacketArray;
+  CWideMemoryBlockArray m_pLoraPacketArray;
 
   // Memory block array for 'LoraPacketSession' (uplink)
-  CMemoryBlockArray m_pLoraPacketSessionArray;
+  CWideMemoryBlockArray m_pLoraPacketSessionArray;
 
   // Memory block array for downlink sessions (items = 'LoraDownPacketSession')
-  CMemoryBlockArray m_pLoraDownPacketSessionArray;
+  CWideMemoryBlockArray m_pLoraDownPacketSessionArray;
 
 
   // Properties
+  //  - Number of uplink packets dropped because the uplink queue was full (i.e. should never occur
+  //    because the queue is checked before reading the receive rings)
   DWORD m_dwMissedUplinkPacketdNumber;
 
 } CLoraNodeManager;
@@ -351,6 +381,7 @@ bool CLoraNodeManager_Attach(void *this, void *pParams);
 bool CLoraNodeManager_Start(void *this, void *pParams);
 bool CLoraNodeManager_Stop(void *this, void *pParams);
 bool CLoraNodeManager_SessionEvent(void *this, void *pEvent);
+bool CLoraNodeManager_SendDownlink(void *this, void *pParams);
 
 
 // Construction
@@ -388,15 +419,19 @@ void CLoraNodeManager_ServerAutomaton(CLoraNodeManager *this);
 #define LORANODEMANAGER_AUTOMATON_CMD_ATTACH       0x00000002
 #define LORANODEMANAGER_AUTOMATON_CMD_START        0x00000003
 #define LORANODEMANAGER_AUTOMATON_CMD_STOP         0x00000004
+#define LORANODEMANAGER_AUTOMATON_CMD_SENDDOWNLINK 0x00000005
 
 
-bool CLoraNodeManager_NotifyAndProcessCommand(CLoraNodeManager *this, DWORD dwCommand, void *pCmdParams);
+bool CLoraNodeManager_NotifyAndProcessCommand(CLoraNodeManager *this, DWORD dwCommand, DWORD dwTimeout, void *pCmdParams);
 bool CLoraNodeManager_ProcessAutomatonNotifyCommand(CLoraNodeManager *this);
 
 bool CLoraNodeManager_ProcessInitialize(CLoraNodeManager *this, CTransceiverManagerItf_InitializeParams pParams);
 bool CLoraNodeManager_ProcessAttach(CLoraNodeManager *this, CTransceiverManagerItf_AttachParams pParams);
 bool CLoraNodeManager_ProcessStart(CLoraNodeManager *this, CTransceiverManagerItf_StartParams pParams);
 bool CLoraNodeManager_ProcessStop(CLoraNodeManager *this, CTransceiverManagerItf_StopParams pParams);
+bool CLoraNodeManager_ProcessSendDownlink(CLoraNodeManager *this, CTransceiverManagerItf_SendDownlinkParams pParams);
+DWORD CLoraNodeManager_GetServerRadio(CLoraNodeManager *this, CTransceiverManagerItf_SendDownlinkParams pParams,
+                                      CLoraRealtimeSenderItf_RadioParams pServerRadio);
 
 void CLoraNodeManager_ProcessSessionEventUplinkAccepted(CLoraNodeManager *this, 
                                                         CTransceiverManagerItf_SessionEvent pEvent);
@@ -434,7 +469,11 @@ void CLoraNodeManager_ProcessSessionEventDownlinkFailed(CLoraNodeManager *this,
 #define LORANODEMANAGER_TRANSCEIVER_MSG_DOWNLINK_SENT    0x00000002
 
 
-bool CLoraNodeManager_ProcessTransceiverUplinkReceived(CLoraNodeManager *this, CLoraTransceiverItf_Event pEvent);
+bool CLoraNodeManager_ProcessTransceiverReceiveRing(CLoraNodeManager *this, CLoraTransceiverItf_Event pEvent);
+bool CLoraNodeManager_ProcessReceiveRing(CLoraNodeManager *this, CTransceiverDescr pTransceiverDescr);
+void CLoraNodeManager_UplinkQueueSpaceAvailable(void *pContext);
+bool CLoraNodeManager_ProcessTransceiverUplinkReceived(CLoraNodeManager *this, CLoraTransceiverItf_Event pEvent,
+                                                       CLoraTransceiverItf_ReceivedLoraPacketInfo pPacketInfo);
 bool CLoraNodeManager_ProcessTransceiverDownlinkSent(CLoraNodeManager *this, CLoraTransceiverItf_Event pEvent);
 
 
@@ -455,11 +494,23 @@ typedef struct _CLoraNodeManager_ProcessServerDownlinkReceivedParams
 {
   // Public
   DWORD m_dwSessionType;
-  DWORD m_dwTimestamp;
+  QWORD m_qwTimestamp;
   DWORD m_dwPayloadSize;
   BYTE *m_pPayload;
   DWORD m_dwDeviceAddr;
   ILoraTransceiver m_pLoraTransceiverItf;
+
+  // Send time requested by Network Server (see 'CLoraRealtimeSenderItf_ScheduleSendNodePacketParamsOb')
+  bool m_bServerTiming;
+  bool m_bImmediate;
+  DWORD m_dwSendTimestamp;
+  CLoraRealtimeSenderItf_RadioParamsOb m_ServerRadio;
+
+  // 'Join Accept' packet (i.e. 'm_dwDeviceAddr' not used)
+  bool m_bJoinAccept;
+
+  // Returned information: schedule result ('LORAREALTIMESENDER_SCHEDULESEND_xxx')
+  DWORD m_dwResult;
 } CLoraNodeManager_ProcessServerDownlinkReceivedParamsOb;
 
 typedef struct _CLoraNodeManager_ProcessServerDownlinkReceivedParams * CLoraNodeManager_ProcessServerDownlinkReceivedParams;
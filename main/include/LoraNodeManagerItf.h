@@ -16,11 +16,19 @@ COMMENTS: The client object must call the 'ReleaseItf' method on 'ITransceiverMa
 #ifndef LORANODEMANAGERITF_H
 #define LORANODEMANAGERITF_H
 
+#include "LoraTransceiverItf.h"
 #include "TransceiverManagerItf.h"
 
 // CLoraNodeManager object factory
 // This method in invoked by client objet to create a new instance of CLoraNodeManager object
-ITransceiverManager CLoraNodeManager_CreateInstance();
+ITransceiverManager CLoraNodeManager_CreateInstance(BYTE usTransceiverNumber);
+
+// Factory of 'LoraTransceiver' objects used by 'CreateInstance'
+// Note: When no factory is set, the 'LoraTransceiver' objects are 'CSX1276' objects (ESP32 only). On
+//       Linux host, a factory of simulated transceivers must be set before calling 'CreateInstance'
+typedef ILoraTransceiver (*CLoraNodeManager_TransceiverFactory)(BYTE usTransceiverIndex);
+
+void CLoraNodeManager_SetTransceiverFactory(CLoraNodeManager_TransceiverFactory pTransceiverFactory);
 
 
 
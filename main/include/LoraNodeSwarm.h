@@ -0,0 +1,309 @@
+/*****************************************************************************************//**
+ * @file     LoraNodeSwarm.h
+ *
+ * @author   F.Fargon
+ *
+ * @version  V1.0
+ *
+ * @date     16/10/2026
+ *
+ * @brief    Simulated LoRaWAN class A devices exposed as a 'LoraTransceiver'.
+ *
+ * @details  This file implements the 'CLoraNodeSwarm' class:\n
+ *            - 'ILoraTransceiver' interface emitting the uplinks of N simulated devices (i.e.
+ *              load generator for sizing of packet and session pools on Linux host)
+ *            - Record of the downlinks sent to simulated devices with their timing error
+ *              relative to the RX windows of the device
+*********************************************************************************************/
+
+#ifndef LORANODESWARM_H_
+#define LORANODESWARM_H_
+
+#ifndef ESP_PLATFORM
+
+/*********************************************************************************************
+  Definitions for debug traces
+  The debug level is specified with 'LORANODESWARM_DEBUG_LEVEL' in Definitions.h file
+*********************************************************************************************/
+
+#define LORANODESWARM_DEBUG_LEVEL0 ((LORANODESWARM_DEBUG_LEVEL & 0x01) > 0)
+#define LORANODESWARM_DEBUG_LEVEL1 ((LORANODESWARM_DEBUG_LEVEL & 0x02) > 0)
+#define LORANODESWARM_DEBUG_LEVEL2 ((LORANODESWARM_DEBUG_LEVEL & 0x04) > 0)
+
+
+/*********************************************************************************************
+  Definitions (implementation)
+*********************************************************************************************/
+
+// Maximum number of DevAddr ranges in swarm configuration
+#define LORANODESWARM_MAX_DEVADDR_RANGES      4
+
+// Spreading factors of simulated devices (i.e. 'm_usSFWeights' index 0 = SF7 ... 5 = SF12)
+#define LORANODESWARM_SF_NUMBER               6
+
+// Arrival of uplinks
+//  - POISSON = Each device transmits independently, exponential interval with mean 'm_dwMeanPeriod'
+//  - BURSTY  = Every 'm_dwBurstPeriod', 'm_wBurstSize' random devices transmit within 'm_dwBurstSpread'
+#define LORANODESWARM_ARRIVAL_POISSON         0
+#define LORANODESWARM_ARRIVAL_BURSTY          1
+
+// Uplink frame (MHDR, DevAddr, FCtrl, FCnt, FPort, FRMPayload, MIC)
+#define LORANODESWARM_FRAME_HEADER_LENGTH     9
+#define LORANODESWARM_FRAME_MIC_LENGTH        4
+#define LORANODESWARM_MAX_FRMPAYLOAD_LENGTH   (LORA_MAX_PAYLOAD_LENGTH - LORANODESWARM_FRAME_HEADER_LENGTH - LORANODESWARM_FRAME_MIC_LENGTH)
+
+// MHDR of data messages (message type in bits 5-7, LoRaWAN R1)
+#define LORANODESWARM_MHDR_UNCONFIRMED_UP     0x40
+#define LORANODESWARM_MHDR_UNCONFIRMED_DOWN   0x60
+#define LORANODESWARM_MHDR_CONFIRMED_UP       0x80
+#define LORANODESWARM_MHDR_CONFIRMED_DOWN     0xA0
+#define LORANODESWARM_MHDR_TYPE_MASK          0xE0
+
+// 'ACK' bit in FCtrl of downlink
+#define LORANODESWARM_FCTRL_ACK               0x20
+
+// Class A RX windows (microseconds after end of uplink, i.e. 'RECEIVE_DELAYx' of LoRaWAN R1)
+#define LORANODESWARM_CLASSA_RECEIVE_DELAY1   GATEWAY_CLOCK_MS_TO_US(1000)
+#define LORANODESWARM_CLASSA_RECEIVE_DELAY2   (LORANODESWARM_CLASSA_RECEIVE_DELAY1 + GATEWAY_CLOCK_MS_TO_US(1000))
+
+// Minimum delay (microseconds) between end of uplink and next uplink of a device (i.e. the
+// device does not transmit before the end of a downlink in RX2 window)
+#define LORANODESWARM_CLASSA_MIN_UPLINK_DELAY (LORANODESWARM_CLASSA_RECEIVE_DELAY2 + GATEWAY_CLOCK_MS_TO_US(1000))
+
+// Maximum wait (milliseconds) of the swarm task (i.e. period of state checks when idle)
+#define LORANODESWARM_MAX_WAIT                100
+
+// Device without scheduled uplink (i.e. waiting for next burst)
+#define LORANODESWARM_TIMESTAMP_NONE          0xFFFFFFFFFFFFFFFFULL
+
+
+/*********************************************************************************************
+ LoraNodeSwarm Class
+
+ Simulated LoRaWAN class A devices on one 'LoraTransceiver'
+
+ Uplinks:
+  - The devices of the swarm configuration ('g_LoraNodeSwarmConfig' in Configuration.h) are
+    shared between the transceivers (i.e. device 'i' is simulated by the 'CLoraNodeSwarm' of
+    transceiver 'i % CONFIG_LORA_TRANSCEIVER_NUMBER')
+  - The swarm task emits the uplink of a device at its 'RxDone' time: the packet is stored in a
+    block of the shared packet pool and notified as a 'CSX1276' (i.e. receive ring and
+    'PACKETRECEIVED' event)
+  - The frame is an unconfirmed or confirmed data message with the DevAddr and FCnt of the
+    device, random FRMPayload and a random MIC (i.e. no keys, the MIC is not checked by the
+    gateway)
+  - The spreading factor of a device is drawn at creation with the configured weights. All
+    spreading factors are received (i.e. as a multi-SF concentrator). The time-on-air is
+    used to detect the uplinks overlapping a transmission of the gateway (half-duplex)
+  - An uplink is lost when the transceiver is not in receive mode or when no packet buffer or
+    ring slot is available (i.e. as for 'CSX1276')
+
+ Downlinks:
+  - 'ArmSend' and 'FireSend' are processed as by 'CSX1276' (i.e. the fire timestamp is the
+    gateway clock when 'FireSend' is called). The 'PACKETSENT' event is notified at the end of
+    the time-on-air computed with current radio settings
+  - The destination device is retrieved with the DevAddr of the downlink. The timing error is
+    the difference between the fire timestamp and the start of nearest RX window (RX1 or RX2
+    of last uplink). The downlink is received by the device if the error is within
+    'm_dwRxWindowTolerance'
+
+ Notes:
+  - The scanner mode is ignored (i.e. same as continuous receive mode)
+  - The object data (state, devices and statistics) is protected by 'm_hMutex'
+  - On real SX1276, the transceiver stays in 'STANDBY' mode after a transmission. The
+    'm_bResumeReceive' setting returns to receive mode (i.e. concentrator behaviour)
+
+ WARNING: This object cannot be static. It MUST always be allocated by with the construction
+          method ('CLoraNodeSwarm_New')
+*********************************************************************************************/
+
+// Automaton states
+#define LORANODESWARM_STATE_CREATED       0x00
+#define LORANODESWARM_STATE_STANDBY       0x01
+#define LORANODESWARM_STATE_RECEIVING     0x02
+#define LORANODESWARM_STATE_ARMED         0x03
+#define LORANODESWARM_STATE_SENDING       0x04
+#define LORANODESWARM_STATE_TERMINATED    0xFF
+
+
+// DevAddr range of swarm configuration
+typedef struct _CLoraNodeSwarmDevAddrRange
+{
+  DWORD m_dwFirstDevAddr;
+  WORD m_wNodeNumber;
+
+} CLoraNodeSwarmDevAddrRangeOb;
+
+
+// Swarm configuration (defined in Configuration.h)
+typedef struct _CLoraNodeSwarmConfig
+{
+  // Simulated devices (consecutive DevAddr in each range)
+  CLoraNodeSwarmDevAddrRangeOb m_DevAddrRanges[LORANODESWARM_MAX_DEVADDR_RANGES];
+  BYTE m_usDevAddrRangeNumber;
+
+  // FCnt of first uplink and increment between uplinks of a device (i.e. values greater than 1
+  // simulate lost uplinks)
+  WORD m_wFirstFCnt;
+  BYTE m_usFCntStep;
+
+  // Relative weights of spreading factors (index 0 = SF7 ... 5 = SF12)
+  BYTE m_usSFWeights[LORANODESWARM_SF_NUMBER];
+
+  // FRMPayload length (uniform between min and max) and FPort
+  BYTE m_usMinPayloadLength;
+  BYTE m_usMaxPayloadLength;
+  BYTE m_usFPort;
+
+  // Arrival of uplinks ('LORANODESWARM_ARRIVAL_xxx', periods in milliseconds)
+  BYTE m_usArrivalMode;
+  DWORD m_dwMeanPeriod;
+  DWORD m_dwBurstPeriod;
+  WORD m_wBurstSize;
+  DWORD m_dwBurstSpread;
+
+  // Percentage of confirmed uplinks
+  BYTE m_usConfirmedPercent;
+
+  // Maximum timing error (microseconds) of a downlink received by device
+  DWORD m_dwRxWindowTolerance;
+
+  // Return to receive mode at the end of a transmission
+  bool m_bResumeReceive;
+
+  // Period (milliseconds) of the statistics trace (the 0 value disables the trace)
+  DWORD m_dwReportPeriod;
+
+  // Seed of the pseudo-random generator (i.e. reproducible load)
+  DWORD m_dwSeed;
+
+} CLoraNodeSwarmConfigOb;
+
+typedef struct _CLoraNodeSwarmConfig * CLoraNodeSwarmConfig;
+
+
+// Simulated device
+typedef struct _CLoraNodeSwarmDevice
+{
+  DWORD m_dwDevAddr;
+  WORD m_wFCnt;
+  BYTE m_usSpreadingFactor;
+
+  // Signal of received uplinks ('m_szSNR' and 'm_szRSSI' of packet information)
+  int8_t m_nSNR;
+  int16_t m_nRSSI;
+
+  // Last uplink: confirmed and acknowledged in RX windows
+  bool m_bConfirmed;
+  bool m_bAcknowledged;
+
+  // Gateway clock for the end of next uplink (i.e. 'RxDone') and RX1 window of last uplink
+  // (0 = no uplink)
+  QWORD m_qwNextUplinkTimestamp;
+  QWORD m_qwRX1Timestamp;
+
+} CLoraNodeSwarmDeviceOb;
+
+typedef struct _CLoraNodeSwarmDevice * CLoraNodeSwarmDevice;
+
+
+// Class data
+typedef struct _CLoraNodeSwarm
+{
+  // Interface and reference count
+  ILoraTransceiver m_pLoraTransceiverItf;
+  uint32_t m_nRefCount;
+
+  BYTE m_usTransceiverIndex;
+  DWORD m_dwCurrentState;
+
+  // Swarm task
+  TaskHandle_t m_hSwarmTask;
+  SemaphoreHandle_t m_hTerminated;
+  SemaphoreHandle_t m_hMutex;
+
+  // Owner object (see 'CLoraTransceiverItf_InitializeParams')
+  QueueHandle_t m_hEventNotifyQueue;
+  CWideMemoryBlockArray m_pLoraPacketPool;
+  CSpscRing m_pReceiveRing;
+
+  // Radio settings
+  BYTE m_usFreqChannel;
+  BYTE m_usSpreadingFactor;
+  BYTE m_usBandwidth;
+  BYTE m_usCodingRate;
+  WORD m_wPreambleLength;
+  bool m_bHeader;
+  bool m_bCRC;
+
+  // Downlink: armed (or sent) packet and end of transmission
+  CLoraTransceiverItf_LoraPacket m_pPacketToSend;
+  QWORD m_qwTxEndTimestamp;
+
+  // Simulated devices (uplinks scheduled when receive mode is entered for the first time)
+  CLoraNodeSwarmDevice m_pDevices;
+  WORD m_wDeviceNumber;
+  bool m_bStarted;
+
+  // Bursty arrival: next burst
+  QWORD m_qwNextBurstTimestamp;
+
+  // Next statistics trace
+  QWORD m_qwNextReportTimestamp;
+
+  // Pseudo-random generator (xorshift32)
+  DWORD m_dwRandomState;
+
+  // Information of last received packet (see 'GetReceivedPacketInfo')
+  CLoraTransceiverItf_ReceivedLoraPacketInfoOb m_ReceivedPacketInfo;
+
+  CLoraNodeSwarmStatisticsOb m_Statistics;
+
+} CLoraNodeSwarmOb;
+
+typedef struct _CLoraNodeSwarm * CLoraNodeSwarm;
+
+
+// Public methods exposed on 'ILoraTransceiver' interface
+uint32_t CLoraNodeSwarm_AddRef(void *this);
+uint32_t CLoraNodeSwarm_ReleaseItf(void *this);
+
+bool CLoraNodeSwarm_Initialize(void *this, void *pParams);
+bool CLoraNodeSwarm_SetLoraMAC(void *this, void *pParams);
+bool CLoraNodeSwarm_SetLoraMode(void *this, void *pParams);
+bool CLoraNodeSwarm_SetPowerMode(void *this, void *pParams);
+bool CLoraNodeSwarm_SetFreqChannel(void *this, void *pParams);
+
+bool CLoraNodeSwarm_StandBy(void *this, void *pParams);
+bool CLoraNodeSwarm_Receive(void *this, void *pParams);
+bool CLoraNodeSwarm_Send(void *this, void *pParams);
+bool CLoraNodeSwarm_ArmSend(void *this, void *pParams);
+bool CLoraNodeSwarm_FireSend(void *this, void *pParams);
+
+bool CLoraNodeSwarm_GetReceivedPacketInfo(void *this, void *pParams);
+
+// Construction
+CLoraNodeSwarm CLoraNodeSwarm_New(BYTE usTransceiverIndex);
+void CLoraNodeSwarm_Delete(CLoraNodeSwarm this);
+
+// Private methods
+void CLoraNodeSwarm_SwarmTask(void *pParams);
+void CLoraNodeSwarm_StartDevices(CLoraNodeSwarm this, QWORD qwNow);
+QWORD CLoraNodeSwarm_ProcessDevices(CLoraNodeSwarm this, QWORD qwNow);
+void CLoraNodeSwarm_StartBurst(CLoraNodeSwarm this, QWORD qwNow);
+void CLoraNodeSwarm_EmitUplink(CLoraNodeSwarm this, CLoraNodeSwarmDevice pDevice, QWORD qwNow);
+bool CLoraNodeSwarm_DeliverUplink(CLoraNodeSwarm this, CLoraNodeSwarmDevice pDevice, QWORD qwNow, BYTE usPayloadLength);
+void CLoraNodeSwarm_ScheduleUplink(CLoraNodeSwarm this, CLoraNodeSwarmDevice pDevice, QWORD qwNow);
+void CLoraNodeSwarm_FireArmedPacket(CLoraNodeSwarm this, QWORD qwNow);
+void CLoraNodeSwarm_RecordDownlink(CLoraNodeSwarm this, CLoraTransceiverItf_LoraPacket pPacket, QWORD qwFireTimestamp);
+void CLoraNodeSwarm_NotifyPacketSent(CLoraNodeSwarm this);
+CLoraNodeSwarmDevice CLoraNodeSwarm_FindDevice(CLoraNodeSwarm this, DWORD dwDevAddr);
+void CLoraNodeSwarm_TraceStatistics(CLoraNodeSwarm this);
+
+DWORD CLoraNodeSwarm_Random(CLoraNodeSwarm this);
+DWORD CLoraNodeSwarm_RandomExponential(CLoraNodeSwarm this, DWORD dwMean);
+
+
+#endif
+
+#endif
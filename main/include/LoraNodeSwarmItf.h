@@ -0,0 +1,74 @@
+/*********************************************************************************************
+MODULE  : LoraNodeSwarmItf
+
+AUTHOR  : F.Fargon
+
+PURPOSE : This file contains the definition of the method used to instantiate a 'CLoraNodeSwarm'
+          object.
+          The 'CLoraNodeSwarm' object implements the generic 'ILoraTransceiver' interface with
+          simulated LoRaWAN class A devices (i.e. load generator for Linux host).
+          Once instantiated the 'CLoraNodeSwarm' object is publicly accessed using the
+          'ILoraTransceiver' interface.
+
+COMMENTS: The client object must call the 'ReleaseItf' method on 'ILoraTransceiver' interface
+          to destroy the 'CLoraNodeSwarm' object created by 'CreateInstance'.
+          The 'CreateInstance' method is a 'CLoraNodeManager_TransceiverFactory' (i.e. set with
+          'CLoraNodeManager_SetTransceiverFactory').
+*********************************************************************************************/
+
+#ifndef LORANODESWARMITF_H
+#define LORANODESWARMITF_H
+
+#ifndef ESP_PLATFORM
+
+#include "LoraTransceiverItf.h"
+
+
+// RX windows of simulated devices (index in 'm_dwRxWindowNumber')
+#define LORANODESWARM_RXWINDOW_RX1      0
+#define LORANODESWARM_RXWINDOW_RX2      1
+#define LORANODESWARM_RXWINDOW_NUMBER   2
+
+
+// Statistics of a 'CLoraNodeSwarm' (i.e. simulated devices of one 'LoraTransceiver')
+typedef struct _CLoraNodeSwarmStatistics
+{
+  // Uplinks
+  DWORD m_dwUplinkNumber;                // Uplinks transmitted by simulated devices
+  DWORD m_dwConfirmedNumber;             // Confirmed uplinks (included in 'm_dwUplinkNumber')
+  DWORD m_dwReceivedNumber;              // Uplinks notified to owner object
+  DWORD m_dwNotListeningNumber;          // Uplinks lost because the transceiver was not receiving (or was sending)
+  DWORD m_dwMissedNumber;                // Uplinks lost because no packet buffer or receive ring slot was available
+
+  // Downlinks
+  DWORD m_dwDownlinkNumber;              // Downlinks sent (i.e. 'FireSend' or 'Send')
+  DWORD m_dwRxWindowNumber[LORANODESWARM_RXWINDOW_NUMBER];  // Downlinks started in an RX window of the device
+  DWORD m_dwOutOfWindowNumber;           // Downlinks outside of RX windows (i.e. device not listening)
+  DWORD m_dwUnknownDeviceNumber;         // Downlinks for a device not simulated by this object (or not a data message)
+  DWORD m_dwAckNumber;                   // Confirmed uplinks acknowledged in RX windows
+  DWORD m_dwMissedAckNumber;             // Confirmed uplinks not acknowledged (evaluated at next uplink of device)
+
+  // Timing error of downlinks relative to start of nearest RX window (microseconds, positive
+  // when late)
+  int32_t m_nMinTimingError;
+  int32_t m_nMaxTimingError;
+  QWORD m_qwAbsTimingErrorSum;
+
+} CLoraNodeSwarmStatisticsOb;
+
+typedef struct _CLoraNodeSwarmStatistics * CLoraNodeSwarmStatistics;
+
+
+// CLoraNodeSwarm object factory
+// This method in invoked by client objet to create a new instance of CLoraNodeSwarm object
+// The simulated devices of the 'usTransceiverIndex' transceiver are the devices of the swarm
+// configuration with 'index % CONFIG_LORA_TRANSCEIVER_NUMBER == usTransceiverIndex'
+ILoraTransceiver CLoraNodeSwarm_CreateInstance(BYTE usTransceiverIndex);
+
+// Statistics of the simulated devices of a 'LoraTransceiver' (i.e. copy of current values)
+bool CLoraNodeSwarm_GetStatistics(BYTE usTransceiverIndex, CLoraNodeSwarmStatistics pStatistics);
+
+
+#endif
+
+#endif
@@ -34,6 +34,7 @@
 *********************************************************************************************/
 
 #include "Utilities.h"
+#include "LoraDutyCycle.h"
 
 
 /********************************************************************************************* 
@@ -52,15 +53,19 @@
 
 
 // Time constants for LoRaWAN protocol for CLASS A devices (LoRaWAN specification for EU863-870)
-// Values are in milliseconds
+// Values are in microseconds (i.e. gateway clock unit, see 'GATEWAY_CLOCK_MICROSEC')
 
 // Constants for standard RX Windows ('RECEIVE_DELAYx') 
 // Note: 
 //   Current version does not support device configuration by LoRa MAC commands.
 //   It is assumed that devices use the standard timings for RX windows.
 //   Even with MAC command configuration, the RX2 windows always starts 1000 ms after RX1 window.
-#define LORAREALTIMESENDER_CLASSA_RECEIVE_DELAY1   1000
-#define LORAREALTIMESENDER_CLASSA_RECEIVE_DELAY2   (LORAREALTIMESENDER_CLASSA_RECEIVE_DELAY1 + 1000)
+#define LORAREALTIMESENDER_CLASSA_RECEIVE_DELAY1   GATEWAY_CLOCK_MS_TO_US(1000)
+#define LORAREALTIMESENDER_CLASSA_RECEIVE_DELAY2   (LORAREALTIMESENDER_CLASSA_RECEIVE_DELAY1 + GATEWAY_CLOCK_MS_TO_US(1000))
+
+// Constants for RX Windows of 'Join Accept' ('JOIN_ACCEPT_DELAYx')
+#define LORAREALTIMESENDER_CLASSA_JOIN_ACCEPT_DELAY1   GATEWAY_CLOCK_MS_TO_US(5000)
+#define LORAREALTIMESENDER_CLASSA_JOIN_ACCEPT_DELAY2   (LORAREALTIMESENDER_CLASSA_JOIN_ACCEPT_DELAY1 + GATEWAY_CLOCK_MS_TO_US(1000))
 
 // Percentage of receive delay duration allowed to detect downlink packet preamble on device
 #define LORAREALTIMESENDER_CLASSA_RX_PREAMBLE_RATIO   90
@@ -71,7 +76,29 @@
 #define LORAREALTIMESENDER_LORAWAN_RX_WINDOW_LENGTH  (((LORAREALTIMESENDER_CLASSA_RECEIVE_DELAY2 - LORAREALTIMESENDER_CLASSA_RECEIVE_DELAY1) *  LORAREALTIMESENDER_CLASSA_RX_PREAMBLE_RATIO) / 100)
 
 // Delay required by gateway ('SenderTask' and transceiver') to start data transmission
-#define LORAREALTIMESENDER_GATEWAY_TX_DELAY    100
+// Note: Minimum delay between the scheduling of a downlink packet and the start of RX window
+//       (i.e. 'SenderTask' wake up and 'LORAREALTIMESENDER_ARM_LEAD')
+#define LORAREALTIMESENDER_GATEWAY_TX_DELAY    GATEWAY_CLOCK_MS_TO_US(8)
+
+// Two-phase send of downlink packet (see 'ArmSend' and 'FireSend' on 'ILoraTransceiver'):
+//  - The packet is loaded in transceiver 'LORAREALTIMESENDER_ARM_LEAD' before the start of RX
+//    window (i.e. FIFO loaded and frequency synthesizer locked)
+//  - The transmission is fired at the start of RX window by the 'SenderTask', woken by a one-shot
+//    high resolution timer (i.e. not subject to RTOS tick granularity). The 'SenderTask' is the
+//    highest priority task on radio core and 'FireSend' is not executed in the shared 'esp_timer'
+//    task (i.e. not delayed by other timer callbacks)
+//  - The packet is not sent if the timer expires more than 'LORAREALTIMESENDER_TX_LATE_LIMIT'
+//    after the start of RX window (i.e. node no more listening for preamble) or if the transceiver
+//    cannot start the transmission before this limit (i.e. SPI bus busy)
+#define LORAREALTIMESENDER_ARM_LEAD            GATEWAY_CLOCK_MS_TO_US(5)
+#define LORAREALTIMESENDER_TX_LATE_LIMIT       GATEWAY_CLOCK_MS_TO_US(1)
+
+// Maximum delay of timer expiration after the fire time (milliseconds)
+#define LORAREALTIMESENDER_FIRE_TIMEOUT        50
+
+// Minimum time between the end of a transmission and the start of next transmission on the same
+// transceiver (i.e. the next packet is armed 'LORAREALTIMESENDER_ARM_LEAD' before its start)
+#define LORAREALTIMESENDER_TX_SEPARATION       LORAREALTIMESENDER_ARM_LEAD
 
 
 /********************************************************************************************* 
@@ -86,13 +113,16 @@
  This class maintains the start time of active receive windows for a node:
   - This object is exclusively used by 'LoraRealtimeSender' (private).
     The 'LoraRealtimeSender' maintains these objects in the 'm_pNodeReceiveWindowArray'
-    'MemoryBlockArray'.
+    'MemoryBlockArray', indexed by device address ('m_pNodeReceiveWindowIndex') and by
+    expiration time ('m_pNodeReceiveWindowExpiryHeap').
   - For Class A nodes:
      .. This object is instancied when an 'uplink' LoRa packet is received.
      .. The start times of receive windows are computed and the 'NodeReceiveWindow' is inserted
         in the 'm_pNodeReceiveWindowArray' array.
      .. The object is removed from 'm_pNodeReceiveWindowArray' if a downlink packet is processed
         or when RX2 window is closed (i.e. periodically checked by 'SenderTask').
+  - For 'Join Request' uplink packets, the object is not indexed by device address (i.e. the
+    'Join Accept' packet is matched by its send time in the RX windows of 'Join Request').
 *********************************************************************************************/
 
 typedef struct _CNodeReceiveWindow
@@ -101,10 +131,14 @@ typedef struct _CNodeReceiveWindow
   BYTE m_usDeviceClass;
   DWORD m_dwDeviceAddr;
   ILoraTransceiver m_pLoraTransceiverItf;
+  bool m_bJoinRequest;
+
+  // Start timestamps for RX windows (gateway clock in microseconds)
+  QWORD m_qwRX1WindowTimestamp;
+  QWORD m_qwRX2WindowTimestamp;
 
-  // Start timestamps for RX windows
-  DWORD m_dwRX1WindowTimestamp;
-  DWORD m_dwRX2WindowTimestamp;
+  // Radio settings for send in each RX window (i.e. index is 'REALTIMELORAPACKET_RXWINDOW_xxx')
+  CLoraRealtimeSenderItf_RadioParamsOb m_RxRadio[LORAREALTIMESENDER_RXWINDOW_NUMBER];
 
 } CNodeReceiveWindowOb;
 
@@ -129,15 +163,18 @@ typedef struct _CNodeReceiveWindow * CNodeReceiveWindow;
   - The 'SenderTask' of 'LoraRealtimeSender' object retrieves the 'CRealtimeLoraPacket' object
     just in time and asks the 'LoraTransceiver' to send it. During this process, the 'SenderTask'
     also removes the object from 'm_pRealtimeLoraPacketArray' array.
+  - The objects waiting for send are ordered by 'm_qwSendTimestamp' in the 'm_pRealtimeLoraPacketHeap'
+    min-heap (i.e. next packet to send retrieved without enumeration of the array).
 *********************************************************************************************/
 
 typedef struct _CRealtimeLoraPacket
 {
-  // Transceiver to use to send LoRa packet to node
-  // Note: In current version, the transceiver settings are statically defined by configuration
-  //       (i.e. the gateway does not use radio parameters specified by Network Server with
-  //       downlink message)
+  // Transceiver to use to send LoRa packet to node and radio settings of the transmission
+  // Note: The radio settings are the settings of the RX window, replaced by the settings
+  //       requested by Network Server with downlink message (i.e. applied by 'ArmSend' only for
+  //       this packet)
   ILoraTransceiver m_pLoraTransceiverItf;
+  CLoraRealtimeSenderItf_RadioParamsOb m_Radio;
 
   // Identifiers of session defined in parent object for management of the downlink LoRa packet
   // Note: These identifiers are used by 'LoraRealtimeSender' to send notifications to parent object
@@ -145,12 +182,19 @@ typedef struct _CRealtimeLoraPacket
   void *m_pDownlinkSession;
 
   // Timestamp indicating when LoRa packet must be sent:
-  //  - If 'm_bASAP' is true, the 'm_dwSendTimestamp' value is the time limit to send the packet.
-  //    Note: The packet with ASAP are sent according to ascending value of 'm_dwSendTimestamp'
-  //  - If 'm_bASAP', the 'm_dwSendTimestamp' value is the absolute time value when packet
+  //  - If 'm_bASAP' is true, the 'm_qwSendTimestamp' value is the time limit to send the packet.
+  //    Note: The packet with ASAP are sent according to ascending value of 'm_qwSendTimestamp'
+  //  - If 'm_bASAP', the 'm_qwSendTimestamp' value is the absolute time value when packet
   //    must be transmitted to transceiver for send.
   bool m_bASAP;
-  DWORD m_dwSendTimestamp;
+  QWORD m_qwSendTimestamp;
+
+  // Expected end of transmission (i.e. 'm_qwSendTimestamp' + time-on-air)
+  // Note: Used to detect transmissions overlapping on the same transceiver
+  QWORD m_qwEndTimestamp;
+
+  // RX window of destination node (= 'REALTIMELORAPACKET_RXWINDOW_xxx')
+  BYTE m_usRxWindow;
 
   // Downlink Lora packet to send
   CLoraTransceiverItf_LoraPacket m_pPacketToSend;
@@ -159,6 +203,37 @@ typedef struct _CRealtimeLoraPacket
 
 typedef struct _CRealtimeLoraPacket * CRealtimeLoraPacket;
 
+// Class constants and definitions
+
+// RX window used to send the downlink packet (i.e. allowed values for 'm_usRxWindow' variable)
+// Note: Use values defined on 'LoraRealtimeSenderItf' interface
+#define REALTIMELORAPACKET_RXWINDOW_RX1      LORAREALTIMESENDER_RXWINDOW_RX1
+#define REALTIMELORAPACKET_RXWINDOW_RX2      LORAREALTIMESENDER_RXWINDOW_RX2
+
+
+
+
+/********************************************************************************************* 
+ RealtimeTransceiver Class
+
+ This class maintains the end of the last transmission started by a 'LoraTransceiver':
+  - This object is exclusively used by 'LoraRealtimeSender' (private).
+  - The 'SenderTask' records the end of transmission when the packet is fired (i.e. the packet
+    is no more in 'm_pRealtimeLoraPacketHeap' while it is transmitted).
+*********************************************************************************************/
+
+typedef struct _CRealtimeTransceiver
+{
+  // Transceiver (NULL for a free entry)
+  ILoraTransceiver m_pLoraTransceiverItf;
+
+  // Expected end of last transmission (gateway clock in microseconds)
+  QWORD m_qwTxEndTimestamp;
+
+} CRealtimeTransceiverOb;
+
+typedef struct _CRealtimeTransceiver * CRealtimeTransceiver;
+
 
 
 /********************************************************************************************* 
@@ -179,19 +254,38 @@ typedef struct _CLoraRealtimeSender
 
   // Collection of 'NodeReceiveWindow' currently active
   // Memory block array for 'CNodeReceiveWindowOb' objects
-  CMemoryBlockArray m_pNodeReceiveWindowArray;
+  CWideMemoryBlockArray m_pNodeReceiveWindowArray;
+
+  // Indexes of 'm_pNodeReceiveWindowArray' (block indexes):
+  //  - By device address (i.e. lookup for downlink packet)
+  //  - By expiration time (i.e. cleanup of expired RX windows)
+  CHashIndex m_pNodeReceiveWindowIndex;
+  CMinHeap m_pNodeReceiveWindowExpiryHeap;
+
+  // Mutex for access to 'm_pNodeReceiveWindowArray' indexes
+  SemaphoreHandle_t m_hReceiveWindowMutex;
 
   // Collection of 'RealtimeLoraPacket' currently waiting for send
   // Memory block array for 'CRealtimeLoraPacketOb' objects
-  CMemoryBlockArray m_pRealtimeLoraPacketArray;
+  CWideMemoryBlockArray m_pRealtimeLoraPacketArray;
+
+  // Index of 'm_pRealtimeLoraPacketArray' by send time (block indexes)
+  CMinHeap m_pRealtimeLoraPacketHeap;
 
   // Next downlink LoRa packet to send
   // Note: A NULL value indicates that no LoRa packet is waiting in queue
   CRealtimeLoraPacket m_pNextRealtimeLoraPacket;
 
-  // Mutex for access to 'm_pRealtimeLoraPacketArray'
+  // End of last transmission for each transceiver
+  CRealtimeTransceiverOb m_RealtimeTransceiverArray[GATEWAY_MAX_LORATRANSCEIVERS];
+
+  // Mutex for access to 'm_pRealtimeLoraPacketHeap' and 'm_RealtimeTransceiverArray'
   SemaphoreHandle_t m_hPacketArrayMutex;
 
+  // Duty-cycle ledger of scheduled transmissions
+  // Note: Only accessed by 'ScheduleSendNodePacket' (i.e. not reentrant method)
+  CLoraDutyCycle m_pDutyCycle;
+
   // Semaphore for a LoRa packet waiting for send
   SemaphoreHandle_t m_hPacketWaiting;
 
@@ -200,8 +294,23 @@ typedef struct _CLoraRealtimeSender
   //
 
   // 'PacketSender' task (automaton for sending LoRa packets just in time)
-  TaskFunction_t m_hPacketSenderTask;
+  TaskHandle_t m_hPacketSenderTask;
+
+  // One-shot timer for the start of transmission ('FireSend' of 'm_pNextRealtimeLoraPacket')
+  //  - The timer callback gives 'm_hFireWake' to wake up the 'SenderTask' at the fire time
+  //  - The 'SenderTask' executes 'FireSend', the result is 'LORAREALTIMESENDER_FIRE_xxx' and the
+  //    'FireSend' output is 'm_FireSendParams'
+  #ifdef ESP_PLATFORM
+    esp_timer_handle_t m_hFireTimer;
+  #endif
+  SemaphoreHandle_t m_hFireWake;
+  BYTE m_usFireResult;
+  CLoraTransceiverItf_FireSendParamsOb m_FireSendParams;
 
+  // Statistics for the start of downlink transmissions (one entry per RX window type)
+  // Note: 'm_pTxStatistics' is the array provided by parent object or 'm_TxStatistics'
+  CLoraRealtimeSenderItf_TxStatisticsOb m_TxStatistics[LORAREALTIMESENDER_RXWINDOW_NUMBER];
+  CLoraRealtimeSenderItf_TxStatistics m_pTxStatistics;
 
 
   // Interface to 'LoraNodeManager' 
@@ -225,6 +334,11 @@ typedef struct _CLoraRealtimeSender
 #define LORAREALTIMESENDER_AUTOMATON_STATE_TERMINATED    6
 #define LORAREALTIMESENDER_AUTOMATON_STATE_ERROR         7
 
+// Result of 'FireSend' executed when one-shot timer expires (i.e. allowed values for 'm_usFireResult')
+#define LORAREALTIMESENDER_FIRE_SENDING      0
+#define LORAREALTIMESENDER_FIRE_LATE         1
+#define LORAREALTIMESENDER_FIRE_FAILED       2
+
 
 // Methods for 'ILoraRealtimeSender' interface implementation on 'LoraRealtimeSender' object
 // The 'CNerworkServerProtocolItfImpl' structure provided by 'LoraRealtimeSender' object contains pointers to these methods 
@@ -252,8 +366,23 @@ void CLoraRealtimeSender_PacketSenderAutomaton(CLoraRealtimeSender *this);
 
 // Class private methods (implementation helpers)
 CNodeReceiveWindow CLoraRealtimeSender_FindNodeReceiveWindow(CLoraRealtimeSender *this, DWORD dwDeviceAddr, bool bCheckExpired);
+CNodeReceiveWindow CLoraRealtimeSender_FindJoinReceiveWindow(CLoraRealtimeSender *this, bool bImmediate, DWORD dwSendTimestamp);
+void CLoraRealtimeSender_ApplyServerRadio(CLoraRealtimeSenderItf_RadioParams pRadio, CLoraRealtimeSenderItf_RadioParams pServerRadio);
 CRealtimeLoraPacket CLoraRealtimeSender_GetNextRealtimePacket(CLoraRealtimeSender *this);
+void CLoraRealtimeSender_RemoveRealtimePacket(CLoraRealtimeSender *this, CRealtimeLoraPacket pRealtimeLoraPacket);
+void CLoraRealtimeSender_RemoveNodeReceiveWindow(CLoraRealtimeSender *this, WORD wBlockIndex);
 void CLoraRealtimeSender_RemoveExpiredNodeReceiveWindows(CLoraRealtimeSender *this);
+void CLoraRealtimeSender_StartFireTimer(CLoraRealtimeSender *this, QWORD qwFireTimestamp);
+void CLoraRealtimeSender_FireTimerCallback(void *pArg);
+void CLoraRealtimeSender_FireSend(CLoraRealtimeSender *this);
+DWORD CLoraRealtimeSender_CheckTransmission(CLoraRealtimeSender *this, ILoraTransceiver pLoraTransceiverItf,
+                                           CLoraRealtimeSenderItf_RadioParams pRadio, QWORD qwSendTimestamp,
+                                           DWORD dwPayloadLength, DWORD *pAirtime);
+bool CLoraRealtimeSender_IsTransceiverBusy(CLoraRealtimeSender *this, ILoraTransceiver pLoraTransceiverItf,
+                                           QWORD qwStartTimestamp, QWORD qwEndTimestamp);
+void CLoraRealtimeSender_SetTransceiverTxEnd(CLoraRealtimeSender *this, ILoraTransceiver pLoraTransceiverItf,
+                                             QWORD qwTxEndTimestamp);
+void CLoraRealtimeSender_UpdateTxStats(CLoraRealtimeSender *this, BYTE usRxWindow, QWORD qwSendTimestamp, QWORD qwFireTimestamp);
 
 
 #endif
@@ -36,12 +36,18 @@ typedef struct _CLoraRealtimeSenderItf_StartParams * CLoraRealtimeSenderItf_Star
 typedef struct _CLoraRealtimeSenderItf_StopParams * CLoraRealtimeSenderItf_StopParams;
 typedef struct _CLoraRealtimeSenderItf_RegisterNodeRxWindowsParams * CLoraRealtimeSenderItf_RegisterNodeRxWindowsParams;
 typedef struct _CLoraRealtimeSenderItf_ScheduleSendNodePacketParams * CLoraRealtimeSenderItf_ScheduleSendNodePacketParams;
+typedef struct _CLoraRealtimeSenderItf_TxStatistics * CLoraRealtimeSenderItf_TxStatistics;
 
 
 /********************************************************************************************* 
   Public definitions used by methods of 'ILoraRealtimeSender' interface
 *********************************************************************************************/
 
+// RX windows of Class A devices (i.e. index of 'CLoraRealtimeSenderItf_TxStatisticsOb' items)
+#define LORAREALTIMESENDER_RXWINDOW_RX1          0
+#define LORAREALTIMESENDER_RXWINDOW_RX2          1
+#define LORAREALTIMESENDER_RXWINDOW_NUMBER       2
+
 
 
 /********************************************************************************************* 
@@ -57,9 +63,32 @@ typedef struct _CLoraRealtimeSenderItf_InitializeParams
   // manage the downlink session)
   void * m_pTransceiverManagerItf; 
 
+  // Statistics for the start of downlink transmissions ('LORAREALTIMESENDER_RXWINDOW_NUMBER'
+  // items, optional)
+  // Note: The statistics are updated by 'LoraRealtimeSender' and may be read at any time by
+  //       parent object
+  CLoraRealtimeSenderItf_TxStatistics m_pTxStatistics;
+
 } CLoraRealtimeSenderItf_InitializeParamsOb;
 
 
+// Statistics for the start of downlink transmissions in one RX window type:
+//  - The TX start error is the difference between the transmission timestamp provided by the
+//    transceiver and the start of RX window (microseconds, always positive by design)
+//  - The late transmissions are not sent (i.e. RX window missed)
+typedef struct _CLoraRealtimeSenderItf_TxStatistics
+{
+  DWORD m_dwFireNumber;
+  DWORD m_dwLateNumber;
+  DWORD m_dwFailedNumber;
+
+  QWORD m_qwErrorSum;
+  DWORD m_dwErrorMin;
+  DWORD m_dwErrorMax;
+
+} CLoraRealtimeSenderItf_TxStatisticsOb;
+
+
 typedef struct _CLoraRealtimeSenderItf_StartParams
 {
   // Public
@@ -67,7 +96,7 @@ typedef struct _CLoraRealtimeSenderItf_StartParams
 } CLoraRealtimeSenderItf_StartParamsOb;
 
 
-typedef struct _CLoraRealtimeSenderItf_StoptParams
+typedef struct _CLoraRealtimeSenderItf_StopParams
 {
   // Public
   bool m_bForce;
@@ -77,6 +106,25 @@ typedef struct _CLoraRealtimeSenderItf_StoptParams
 // Parameters and definitions for 'RegisterNodeRxWindows' method
 //
 
+// Radio settings of a downlink transmission (i.e. for time-on-air and duty-cycle accounting)
+// Note: Values defined by 'ILoraTransceiver' interface (i.e. 'LORATRANSCEIVERITF_xxx', default
+//       values of transceiver applied by caller for 'NONE' settings, except 'm_usPowerLevel'
+//       where 'NONE' is the power mode of transceiver settings)
+typedef struct _CLoraRealtimeSenderItf_RadioParams
+{
+  BYTE m_usFreqChannel;
+  BYTE m_usSpreadingFactor;
+  BYTE m_usBandwidth;
+  BYTE m_usCodingRate;
+  WORD m_wPreambleLength;
+  BYTE m_usHeader;
+  BYTE m_usCRC;
+  BYTE m_usPowerLevel;
+} CLoraRealtimeSenderItf_RadioParamsOb;
+
+typedef struct _CLoraRealtimeSenderItf_RadioParams * CLoraRealtimeSenderItf_RadioParams;
+
+
 typedef struct _CLoraRealtimeSenderItf_RegisterNodeRxWindowsParams
 {
   // Public
@@ -92,8 +140,18 @@ typedef struct _CLoraRealtimeSenderItf_RegisterNodeRxWindowsParams
   ILoraTransceiver m_pLoraTransceiverItf;
 
   // Timestamp for end of transmission of uplink packet
-  // Value in milliseconds
-  DWORD m_dwRXTimestamp;
+  // Value in microseconds (i.e. 'm_qwTimestamp' of received LoRa packet)
+  QWORD m_qwRXTimestamp;
+
+  // Uplink packet is a 'Join Request'
+  // Note: The RX windows start after 'JOIN_ACCEPT_DELAYx' and the 'Join Accept' packet is
+  //       matched by its send time ('m_dwDeviceAddr' is not used because the 'Join Accept' does 
+  //       not contain a device address)
+  bool m_bJoinRequest;
+
+  // Radio settings used by 'm_pLoraTransceiverItf' to send in each RX window (i.e. index is
+  // 'LORAREALTIMESENDER_RXWINDOW_xxx')
+  CLoraRealtimeSenderItf_RadioParamsOb m_RxRadio[LORAREALTIMESENDER_RXWINDOW_NUMBER];
 
 } CLoraRealtimeSenderItf_RegisterNodeRxWindowsParamsOb;
 
@@ -123,6 +181,26 @@ typedef struct _CLoraRealtimeSenderItf_ScheduleSendNodePacketParams
   // Downlink Lora packet to send
   CLoraTransceiverItf_LoraPacket m_pPacketToSend;
 
+  // Send time requested by Network Server
+  // Note: If 'm_bServerTiming' is false, the packet is sent at the beginning of the first RX
+  //       window available on node. Otherwise:
+  //        - If 'm_bImmediate' is true, the packet is sent as soon as possible
+  //        - If 'm_bImmediate' is false, the packet is sent when the gateway clock reaches
+  //          'm_dwSendTimestamp' (i.e. 32 low bits of gateway clock in microseconds, must be
+  //          inside one RX window of node)
+  bool m_bServerTiming;
+  bool m_bImmediate;
+  DWORD m_dwSendTimestamp;
+
+  // Radio settings requested by Network Server (i.e. only used if 'm_bServerTiming' is true)
+  // Note: The settings of the RX window are used for 'NONE' values (i.e. 'm_wPreambleLength',
+  //       'm_usHeader' and 'm_usCRC' are always the settings of the RX window)
+  CLoraRealtimeSenderItf_RadioParamsOb m_ServerRadio;
+
+  // Packet is a 'Join Accept' (i.e. 'm_dwDeviceAddr' not used, the RX windows of 'Join Request'
+  // including 'm_dwSendTimestamp' are used)
+  bool m_bJoinAccept;
+
 } CLoraRealtimeSenderItf_ScheduleSendNodePacketParamsOb;
 
 
@@ -134,8 +212,11 @@ typedef struct _CLoraRealtimeSenderItf_ScheduleSendNodePacketParams
 //  - TOO_LATE         = Rejected because it was already too late to program this packet for downlink
 //  - TOO_EARLY        = Rejected because downlink packet timestamp is too much in advance
 //  - COLLISION_PACKET = Rejected because there was already a packet programmed in requested timeframe
+//                       (i.e. transceiver busy) or because the duty-cycle budget of the sub-band
+//                       is exhausted for requested timeframe
 //  - COLLISION_BEACON = Rejected because there was already a beacon planned in requested timeframe
-//  - TX_FREQ          = Rejected because requested frequency is not supported by TX RF chain
+//  - TX_FREQ          = Rejected because requested frequency is not supported by TX RF chain (i.e.
+//                       outside of known sub-bands or invalid radio settings)
 //  - TX_POWER         = Rejected because requested power is not supported by gateway
 //  - GPS_UNLOCKED     = Rejected because GPS is unlocked, so GPS timestamp cannot be used
 
@@ -38,7 +38,7 @@ typedef bool (*Initialize)(void *pOwnerObject, CLoraRealtimeSenderItf_Initialize
 typedef bool (*Start)(void *pOwnerObject, CLoraRealtimeSenderItf_StartParams pParams);
 typedef bool (*Stop)(void *pOwnerObject, CLoraRealtimeSenderItf_StopParams pParams);
 
-typedef DWORD (*RegisterNodeRxWindows)(void *pOwnerObject, CLoraRealtimeSenderItf_RegisterNodeRxWindowsParams pParams);
+typedef bool (*RegisterNodeRxWindows)(void *pOwnerObject, CLoraRealtimeSenderItf_RegisterNodeRxWindowsParams pParams);
 typedef DWORD (*ScheduleSendNodePacket)(void *pOwnerObject, CLoraRealtimeSenderItf_ScheduleSendNodePacketParams pParams);
 
                                                   
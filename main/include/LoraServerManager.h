@@ -39,6 +39,7 @@
 *********************************************************************************************/
 
 #include "Utilities.h"
+#include "UplinkLog.h"
 
 
 /********************************************************************************************* 
@@ -63,11 +64,32 @@
 #define LORASERVERMANAGER_MAX_UPMESSAGE_LENGTH    ((LORA_MAX_PAYLOAD_LENGTH * 2) + 1024)
 
 
-// Number of items in memory array for 'CLoraServerUpMessageOb' (uplink)
+// Number of items in memory array for uplink message streams (i.e. encoded data sent to Network Server)
 // Typically, messages should be transmitted to Network Server quite quickly.
 // This small buffer is only in case of the reception of another LoRa packet before previous
-// packet is forwarded to Network Server
-#define LORASERVERMANAGER_MAX_SERVERUPMESSAGES     3
+// message is forwarded to Network Server
+#define LORASERVERMANAGER_MAX_UPMESSAGESTREAMS     3
+
+// Maximum length for messages containing several LoRa packets (i.e. uplink aggregation)
+// The configured MTU is bounded by size of message buffer
+#define LORASERVERMANAGER_AGGREGATION_MTU   (CONFIG_UPLINK_AGGREGATION_MTU < LORASERVERMANAGER_MAX_UPMESSAGE_LENGTH ? \
+                                             CONFIG_UPLINK_AGGREGATION_MTU : LORASERVERMANAGER_MAX_UPMESSAGE_LENGTH)
+
+// Minimum length of one LoRa packet in an encoded message stream
+// Note: The Semtech 'rxpk' object of a LoRa packet with 1 byte payload is about 200 bytes
+#define LORASERVERMANAGER_MIN_UPPACKET_LENGTH      192
+
+// Number of items in memory array for 'CLoraServerUpMessageOb' (uplink)
+// A 'LoraServerUpMessage' is a small descriptor of one LoRa packet session (i.e. message stream
+// referenced only by first 'LoraServerUpMessage' of a message). With uplink aggregation, there are
+// enough items to fill all message streams up to 'LORASERVERMANAGER_AGGREGATION_MTU'
+// Note: The identifiers 0xFE and 0xFF are reserved ('heartbeat' and replayed messages)
+#if (CONFIG_UPLINK_AGGREGATION_WINDOW > 0)
+  #define LORASERVERMANAGER_MAX_SERVERUPMESSAGES   (LORASERVERMANAGER_MAX_UPMESSAGESTREAMS * \
+                                                    ((LORASERVERMANAGER_AGGREGATION_MTU / LORASERVERMANAGER_MIN_UPPACKET_LENGTH) + 1))
+#else
+  #define LORASERVERMANAGER_MAX_SERVERUPMESSAGES   LORASERVERMANAGER_MAX_UPMESSAGESTREAMS
+#endif
 
 // Number of items in memory array for 'CLoraServerDownMessageOb' (downlink)
 // Typically, messages should be transmitted to NodeManager quite quickly.
@@ -75,6 +97,16 @@
 // before previous packet is forwarded to Node
 #define LORASERVERMANAGER_MAX_SERVERDOWNMESSAGES     3
 
+// Maximum length of acknowledge message sent to Network Server for a downlink message (i.e. 
+// Semtech 'TX_ACK' message)
+#define LORASERVERMANAGER_MAX_DOWNLINKACK_LENGTH     64
+
+// Number of items in the uplink queue (i.e. uplink packets forwarded by 'LoraNodeManager' and not
+// yet processed by 'NodeManager' task)
+// When the queue is full, the 'LoraNodeManager' leaves the received packets in the receive rings
+// of 'LoraTransceivers' (i.e. backpressure up to the radios)
+#define LORASERVERMANAGER_UPLINK_QUEUE_DEPTH         16
+
 
 
 
@@ -128,13 +160,23 @@ typedef struct _CLoraServerUpMessage
   // Identifier of last 'ServerConnector' used to send the message
   BYTE m_usLastConnectorId;
 
+  // Identifier of next 'LoraServerUpMessage' aggregated in this message (0xFF if none)
+  // Note: When uplink aggregation is enabled, the first 'LoraServerUpMessage' contains the message stream
+  //       for all aggregated LoRa packets. The other 'LoraServerUpMessages' are chained to it and share its
+  //       'm_dwProtocolMessageId' (i.e. they are terminated with the first message)
+  // Note: Before encoding, the same identifier chains the 'LoraServerUpMessages' waiting for a message
+  //       stream (see 'm_usPendingMessageId' in 'CLoraServerManager')
+  BYTE m_usNextMessageId;
+
   // 'LoraPacketSession' data (received via 'ServerManagerItf_LoraSessionPacket' object)
   // Note: These objects live in 'CLoraNodeManager'
-  // Note: The 'm_pLoraPacket' object is not valid anymore as soon as the 'ACCEPTED' event
-  //       is sent to the owner ('CLoraNodeManager' via 'ITransceiverManager' interface)
+  // Note: The 'm_pLoraPacket' object is a shared packet buffer of 'm_pLoraPacketPool'. The
+  //       'CLoraServerManager' owns a reference on it until the packet is encoded (then
+  //       'm_pLoraPacket' is set to NULL)
   // Note: The following variables are not used for 'heartbeat' messages
   void *m_pSession;
   void *m_pLoraPacket;
+  void *m_pLoraPacketPool;
   void *m_pLoraPacketInfo;
   DWORD m_dwSessionId;
   
@@ -145,8 +187,10 @@ typedef struct _CLoraServerUpMessage
   // Stream length
   WORD m_wDataLength;
 
-  // Data bytes
-  BYTE m_usData[LORASERVERMANAGER_MAX_UPMESSAGE_LENGTH];
+  // Data bytes (NULL if no message stream)
+  // Note: Memory block of 'm_pUplinkMessageStreamArray' for LoRa packets (i.e. only for the first
+  //       'LoraServerUpMessage' of a message). Dedicated buffers for 'heartbeat' and replayed messages
+  BYTE *m_pData;
 
 } CLoraServerUpMessageOb;
 
@@ -229,6 +273,7 @@ typedef struct _CLoraServerDownMessage * CLoraServerDownMessage;
 #define LORASERVERMANAGER_SERVERMANAGER_MESSAGEID(id)  (id >> 16)
 
 #define LORASERVERMANAGER_SERVERMANAGER_IS_HEARTBEAT(BlockIdx)  (BlockIdx == 0xFF)
+#define LORASERVERMANAGER_SERVERMANAGER_IS_REPLAY(BlockIdx)     (BlockIdx == 0xFE)
 
 
 /********************************************************************************************* 
@@ -261,8 +306,9 @@ typedef struct _CLoraServerManager_Message
 {
   // Public
   WORD m_wMessageType;                            // The message
-  DWORD m_dwMessageData;                          // Depends on message type
-                                                  // Value or pointer to object
+  uintptr_t m_dwMessageData;                      // Depends on message type
+                                                  // Value or pointer to object (i.e. size of
+                                                  // pointer, DWORD on ESP32)
   DWORD m_dwMessageData2;                         // Depends on message type
 } CLoraServerManager_MessageOb;
 
@@ -303,7 +349,7 @@ typedef struct _CLoraServerManager
 
   // 'ServerManager' task (main automaton)
   // Used for internal messages and external commands via 'IServerManager' interface
-  TaskFunction_t m_hServerManagerTask;
+  TaskHandle_t m_hServerManagerTask;
   QueueHandle_t m_hServerManagerQueue;
 
   // For command processing by 'ServerManager' task
@@ -316,11 +362,15 @@ typedef struct _CLoraServerManager
   // 'NodeManager' task (automaton for exchange with 'LoraNodeManager')
   // Used to process uplink packets received from 'LoraNodeManager'
   // This 'Task' is known by the 'LoraNodeManager' (i.e. attached) and is direcly notified
-  TaskFunction_t m_hNodeManagerTask;
+  TaskHandle_t m_hNodeManagerTask;
+
+  // Bounded queue of uplink packets forwarded by 'LoraNodeManager' ('CServerManagerItf_LoraSessionPacket'
+  // handles). The 'NodeManager' task is notified when items are pushed and drains the queue in batches
+  CMpscRing m_pUplinkQueue;
 
   // 'Connector' task (automaton for exchange with 'ServerConnector' objects)
   // Used to process notifications for downlink packet received from 'NetworkServer (by 'ServerConnectors')
-  TaskFunction_t m_hConnectorTask;
+  TaskHandle_t m_hConnectorTask;
   QueueHandle_t m_hConnectorNotifQueue;
 
   //
@@ -334,7 +384,7 @@ typedef struct _CLoraServerManager
 
   // Task in 'CLoraNodeManager' object to ask for sending (transmit) downlink packet to node device
   // A NULL value indicates that 'LoraNodeManager' is not attached (see 'ILoraNodeManager_Attach' method)
-  TaskFunction_t m_hTransceiverManagerTask;
+  TaskHandle_t m_hTransceiverManagerTask;
 
 
   //
@@ -344,6 +394,16 @@ typedef struct _CLoraServerManager
   // Memory block array for 'LoraServerUpMessages' (i.e. uplink messages for Network Server)
   CMemoryBlockArray m_pLoraServerUpMessageArray;
 
+  // Memory block array for uplink Network Server message streams (i.e. encoded data of 'LoraServerUpMessages')
+  CMemoryBlockArray m_pUplinkMessageStreamArray;
+
+  // 'LoraServerUpMessages' waiting for a message stream (i.e. chained by 'm_usNextMessageId')
+  // The LoRa packets are encoded in received order when a message stream is released
+  // Note: The 0xFF value for 'm_usPendingMessageId' indicates that no 'LoraServerUpMessage' is waiting
+  BYTE m_usPendingMessageId;                      // First waiting 'LoraServerUpMessage'
+  BYTE m_usPendingLastMessageId;                  // Last waiting 'LoraServerUpMessage'
+  bool m_bPendingInProgress;                      // Waiting 'LoraServerUpMessages' are being processed
+
   // Memory for 'heartbeat' last uplink message
   // Note: 
   //  - The 'heartbeat' messages are periodically sent by main task (i.e. serialized)
@@ -351,6 +411,28 @@ typedef struct _CLoraServerManager
   //    process associated 'ack')
   // TO CHECK -> may be required to use a MessageOb from Array (and keep it locked)
   CLoraServerUpMessageOb m_HeartbeatMessageOb;
+  BYTE m_usHeartbeatData[LORASERVERMANAGER_MAX_UPMESSAGE_LENGTH];
+
+  // Uplink aggregation (i.e. several LoRa packets sent in one Network Server message)
+  // The aggregated message is sent when 'CONFIG_UPLINK_AGGREGATION_WINDOW' is elapsed, when the next LoRa
+  // packet exceeds 'LORASERVERMANAGER_AGGREGATION_MTU' (i.e. no limit on number of LoRa packets)
+  // Note: The 0xFF value for 'm_usAggregateMessageId' indicates that no aggregated message is open
+  BYTE m_usAggregateMessageId;                    // First 'LoraServerUpMessage' (contains message stream)
+  BYTE m_usAggregateLastMessageId;                // Last 'LoraServerUpMessage' in chain
+  BYTE m_usAggregatePacketNumber;                 // Number of LoRa packets in message
+  TickType_t m_dwAggregateStartTicks;             // Tick count when first LoRa packet added
+
+  // Store-and-forward log (i.e. uplink messages stored when no 'ServerConnector' can send them)
+  // A NULL value indicates that the log is disabled (see 'CONFIG_UPLINK_LOG_ENABLE')
+  CUplinkLog m_pUplinkLog;
+
+  // Memory for stored uplink message currently replayed (i.e. one message at a time)
+  // Note: The 'm_usMessageId' of this message is 0xFE (see 'LORASERVERMANAGER_SERVERMANAGER_IS_REPLAY')
+  CLoraServerUpMessageOb m_ReplayMessageOb;
+  BYTE m_usReplayData[LORASERVERMANAGER_MAX_UPMESSAGE_LENGTH];
+  bool m_bReplayInProgress;                       // Replayed message is being sent
+  TickType_t m_dwReplayTicks;                     // Tick count when last replayed message started
+  TickType_t m_dwReplayDelay;                     // Delay before next replayed message
 
 
   //
@@ -450,12 +532,29 @@ bool CLoraServerManager_ProcessAttach(CLoraServerManager *this, CServerManagerIt
 bool CLoraServerManager_ProcessStart(CLoraServerManager *this, CServerManagerItf_StartParams pParams);
 bool CLoraServerManager_ProcessStop(CLoraServerManager *this, CServerManagerItf_StopParams pParams);
 
+WORD CLoraServerManager_ProcessUplinkQueue(CLoraServerManager *this);
+void CLoraServerManager_ProcessUplinkSessionPacket(CLoraServerManager *this, CServerManagerItf_LoraSessionPacket pLoraSessionPacket,
+                                                   CLoraServerUpMessage pLoraServerMessage, BYTE usMessageId);
+
 void CLoraServerManager_ProcessServerMessageEventUplinkReceived(CLoraServerManager *this, CLoraServerUpMessage pLoraServerMessage);
+void CLoraServerManager_ProcessPendingMessages(CLoraServerManager *this);
+bool CLoraServerManager_BuildServerMessage(CLoraServerManager *this, CLoraServerUpMessage pLoraServerMessage);
 void CLoraServerManager_ProcessServerMessageEventUplinkPrepared(CLoraServerManager *this, CLoraServerUpMessage pLoraServerMessage); 
 void CLoraServerManager_ProcessServerMessageEventUplinkSent(CLoraServerManager *this, CLoraServerUpMessage pLoraServerMessage);
 void CLoraServerManager_ProcessServerMessageEventUplinkSendFailed(CLoraServerManager *this, CLoraServerUpMessage pLoraServerMessage);
 void CLoraServerManager_ProcessServerMessageEventUplinkFailed(CLoraServerManager *this, CLoraServerUpMessage pLoraServerMessage);
+void CLoraServerManager_ReleaseLoraPacket(CLoraServerManager *this, CLoraServerUpMessage pLoraServerMessage);
 void CLoraServerManager_ProcessServerMessageEventUplinkTerminated(CLoraServerManager *this, CLoraServerUpMessage pLoraServerMessage, DWORD dwProtocolState);
+void CLoraServerManager_TerminateLoraPacketSession(CLoraServerManager *this, CLoraServerUpMessage pLoraServerMessage, DWORD dwProtocolState);
+
+bool CLoraServerManager_AggregateServerMessage(CLoraServerManager *this, CLoraServerUpMessage pLoraServerMessage);
+void CLoraServerManager_FlushAggregatedMessage(CLoraServerManager *this);
+TickType_t CLoraServerManager_CheckAggregatedMessage(CLoraServerManager *this);
+void CLoraServerManager_CheckExpiredSessions(CLoraServerManager *this);
+CLoraServerUpMessage CLoraServerManager_GetUpMessage(CLoraServerManager *this, BYTE usMessageId);
+
+void CLoraServerManager_StoreServerMessage(CLoraServerManager *this, CLoraServerUpMessage pLoraServerMessage);
+TickType_t CLoraServerManager_ReplayStoredMessage(CLoraServerManager *this);
 
 bool CLoraServerManager_SendServerMessage(CLoraServerManager *this, CLoraServerUpMessage pLoraServerMessage, bool bFirstConnector);
 
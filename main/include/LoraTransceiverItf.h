@@ -139,6 +139,7 @@ typedef struct _ILoraTransceiver * ILoraTransceiver;
 
 
 // LoRa radio Power Level (values 0 to 14dBm)
+#define LORATRANSCEIVERITF_POWER_LEVEL_MAX       14      // Maximum value (14dBm)
 #define LORATRANSCEIVERITF_POWER_LEVEL_NONE      0xFF    // Ignore parameter
 
 // Output Current Protection
@@ -149,6 +150,10 @@ typedef struct _ILoraTransceiver * ILoraTransceiver;
 // Maximum values
 #define LORATRANSCEIVERITF_MAX_SEND_RETRIES      0x03    // Maximum number of 'Send' retries
 
+// Scanner mode (see 'CLoraTransceiverItf_ScanParams')
+#define LORATRANSCEIVERITF_SCAN_MAX_CHANNELS     8       // Maximum number of scanned channel/SF pairs
+#define LORATRANSCEIVERITF_SCAN_HOP_TIME_NONE    0       // Use default hop time of transceiver
+
 
 /********************************************************************************************* 
   Objects and definitions used for event notifications
@@ -203,7 +208,11 @@ typedef struct _CLoraTransceiverItf_SetFreqChannelParams * CLoraTransceiverItf_S
 typedef struct _CLoraTransceiverItf_StandByParams * CLoraTransceiverItf_StandByParams;
 typedef struct _CLoraTransceiverItf_ReceiveParams * CLoraTransceiverItf_ReceiveParams;
 typedef struct _CLoraTransceiverItf_SendParams * CLoraTransceiverItf_SendParams;
+typedef struct _CLoraTransceiverItf_ArmSendParams * CLoraTransceiverItf_ArmSendParams;
+typedef struct _CLoraTransceiverItf_FireSendParams * CLoraTransceiverItf_FireSendParams;
 typedef struct _CLoraTransceiverItf_GetReceivedPacketInfoParams * CLoraTransceiverItf_GetReceivedPacketInfoParams;
+typedef struct _CLoraTransceiverItf_ScanParams * CLoraTransceiverItf_ScanParams;
+typedef struct _CLoraTransceiverItf_ScanStatistics * CLoraTransceiverItf_ScanStatistics;
 
 typedef struct _CLoraTransceiverItf_LoraPacket * CLoraTransceiverItf_LoraPacket;
 typedef struct _CLoraTransceiverItf_ReceivedLoraPacketInfo * CLoraTransceiverItf_ReceivedLoraPacketInfo;
@@ -212,6 +221,29 @@ typedef struct _CLoraTransceiverItf_InitializeParams
 {
   // Public
   QueueHandle_t m_hEventNotifyQueue;
+
+  // Pool of shared packet buffers ('CWideMemoryBlockArray' created with 'NewShared')
+  // When provided, received packets are stored directly in a block of this pool and the 
+  // reference on the block is transfered to the owner object with the 'PACKETRECEIVED' event
+  // (i.e. the owner object must release it with 'CWideMemoryBlockArray_ReleaseRef').
+  // The block size must be at least 'sizeof(CLoraTransceiverItf_LoraPacketOb) + LORA_MAX_PAYLOAD_LENGTH'
+  // When NULL, the received packet is stored in the single buffer of the transceiver and must
+  // be released by setting its 'm_dwDataSize' to 0
+  void *m_pLoraPacketPool;
+
+  // Receive ring ('CSpscRing' with 'CLoraTransceiverItf_ReceiveSlotOb' slots, optional)
+  // When provided with 'm_pLoraPacketPool', each received packet and its additional information
+  // are written in a slot of this ring (i.e. several packets may wait for owner object).
+  // The 'PACKETRECEIVED' event only signals that the ring contains packets: the owner object
+  // reads all available slots (i.e. a slot is never lost if event queue is full) and owns the
+  // reference on the packet block.
+  // When the ring is full, the new packet is dropped (see 'CSpscRing_GetDroppedNumber')
+  void *m_pReceiveRing;
+
+  // Identifier of LoRa transceiver on the shared SPI bus (i.e. index in hardware pin table of
+  // transceiver implementation, see 'SX1276_DEVICE_PINS' for CSX1276)
+  BYTE m_usSpiSlaveID;
+
   CLoraTransceiverItf_SetLoraMACParams pLoraMAC;
   CLoraTransceiverItf_SetLoraModeParams pLoraMode;
   CLoraTransceiverItf_SetPowerModeParams pPowerMode;
@@ -270,9 +302,63 @@ typedef struct _CLoraTransceiverItf_ReceiveParams
 {
   // Public
   bool m_bForce;
+
+  // Scanner mode (optional)
+  // When NULL, the transceiver receives continuously on configured channel and spreading factor
+  // (see 'SetFreqChannel' and 'SetLoraMode')
+  CLoraTransceiverItf_ScanParams m_pScanParams;
 } CLoraTransceiverItf_ReceiveParamsOb;
 
 
+// Channel/SF pair of scanner mode
+typedef struct _CLoraTransceiverItf_ScanChannel
+{
+  BYTE m_usFreqChannel;
+  BYTE m_usSpreadingFactor;
+} CLoraTransceiverItf_ScanChannelOb;
+
+
+// Statistics of one channel/SF pair of scanner mode
+// Note: Written by transceiver, may be read at any time by owner object (values are not
+//       consistent together)
+typedef struct _CLoraTransceiverItf_ScanStatistics
+{
+  DWORD m_dwCadNumber;                  // Channel activity detections performed
+  DWORD m_dwDetectedNumber;             // Channel activity detected (i.e. RX locked on channel)
+  DWORD m_dwReceivedNumber;             // Packets received after activity detected
+  DWORD m_dwFalseDetectedNumber;        // RX lock released without packet
+  WORD m_wWeight;                       // Current weight in adaptive dwell schedule
+} CLoraTransceiverItf_ScanStatisticsOb;
+
+
+// Scanner mode
+// The transceiver cycles channel activity detection (CAD) on the channel/SF pairs and locks
+// into receive mode on the pair where activity is detected. The channels are revisited before
+// the end of LoRa preamble when the time budget allows it (i.e. hop time and CAD duration of
+// all pairs). Otherwise, the adaptive dwell schedule gives more CAD to busy channels.
+// Notes:
+//  - The bandwidth and other LoRa settings are the configured ones (i.e. 'SetLoraMode')
+//  - The configured channel and spreading factor are restored when scanner mode ends (i.e.
+//    'StandBy', 'Send' or 'Receive' without scanner)
+typedef struct _CLoraTransceiverItf_ScanParams
+{
+  // Public
+  CLoraTransceiverItf_ScanChannelOb m_Channels[LORATRANSCEIVERITF_SCAN_MAX_CHANNELS];
+  BYTE m_usChannelNumber;
+
+  // Time to change channel/SF and start a CAD (microseconds), see 'LORATRANSCEIVERITF_SCAN_HOP_TIME_NONE'
+  WORD m_wHopTime;
+
+  // Busy channels scanned more often than idle channels when all channels cannot be revisited
+  // in time (i.e. 'false' = same share for each channel)
+  bool m_bAdaptiveDwell;
+
+  // Statistics for each channel/SF pair ('m_usChannelNumber' items, optional)
+  // Note: Owned by owner object, updated by transceiver while scanner mode is active
+  CLoraTransceiverItf_ScanStatistics m_pStatistics;
+} CLoraTransceiverItf_ScanParamsOb;
+
+
 typedef struct _CLoraTransceiverItf_SendParams
 {
   // Public
@@ -280,6 +366,46 @@ typedef struct _CLoraTransceiverItf_SendParams
 } CLoraTransceiverItf_SendParamsOb;
 
 
+// Two-phase send (i.e. packet transmitted at a precise time)
+//  - 'ArmSend' transfers the packet and the radio settings in transceiver ahead of time (the
+//    transceiver is ready to transmit and does not receive anymore)
+//  - 'FireSend' starts the transmission (minimal and constant latency, the method is not 
+//    processed by transceiver automaton)
+// Notes:
+//  - 'ArmSend' replaces the previous armed packet if not fired
+//  - 'StandBy', 'Receive' and 'Send' methods cancel the armed packet
+//  - The 'PACKETSENT' event is notified as with 'Send' method
+//  - The radio settings apply only to the armed packet, the configured settings are restored
+//    when the packet is sent or cancelled ('NONE' value = configured setting)
+typedef struct _CLoraTransceiverItf_ArmSendParams
+{
+  // Public
+  CLoraTransceiverItf_LoraPacket m_pPacketToSend;
+
+  BYTE m_usFreqChannel;
+  BYTE m_usSpreadingFactor;
+  BYTE m_usBandwidth;
+  BYTE m_usCodingRate;
+  BYTE m_usPowerLevel;
+} CLoraTransceiverItf_ArmSendParamsOb;
+
+
+typedef struct _CLoraTransceiverItf_FireSendParams
+{
+  // Public
+  // Transmission not started if it cannot begin before this gateway clock value (i.e. transceiver
+  // resources busy, 0 = no limit)
+  QWORD m_qwLateTimestamp;
+
+  // Public (output)
+  // Gateway clock when transmission is started (i.e. same value as 'm_qwTimestamp' of packet)
+  QWORD m_qwFireTimestamp;
+
+  // Transmission not started because 'm_qwLateTimestamp' was reached (i.e. the packet remains armed)
+  bool m_bLate;
+} CLoraTransceiverItf_FireSendParamsOb;
+
+
 typedef struct _CLoraTransceiverItf_GetReceivedPacketInfoParams
 {
   // Public
@@ -293,10 +419,11 @@ typedef struct _CLoraTransceiverItf_GetReceivedPacketInfoParams
 // implement a 'writer/reader' pattern (synchronized access).
 typedef struct _CLoraTransceiverItf_LoraPacket
 {
-  // System tick count for LoRaWAN protocol time rules (i.e. uplink RX windows)
-  // Received packet = when packet is received
+  // Gateway clock in microseconds for LoRaWAN protocol time rules (i.e. uplink RX windows)
+  // Received packet = IRQ edge of 'RxDone' (latched in transceiver ISR)
   // Packet to send  = when sending packet bytes begins
-  DWORD m_dwTimestamp;
+  // Note: See 'GATEWAY_CLOCK_MICROSEC' in Definitions.h
+  QWORD m_qwTimestamp;
 
   // Packet payload size (= size of 'm_usData' array)
   // Note: This member variable is used as synchronization flag for packet transmission between
@@ -305,6 +432,8 @@ typedef struct _CLoraTransceiverItf_LoraPacket
   //       DWORD (i.e. size for atomic access by ESP32 = no MUTEX required)
   //       - For received packets : the reader object must set this variable with 0 to allow the
   //         writer object to store a new received packet (i.e. read confirmation)
+  //         Not used when the packet is received in a shared buffer (see 'm_pLoraPacketPool'
+  //         in 'CLoraTransceiverItf_InitializeParams')
   //  
   DWORD m_dwDataSize;
 
@@ -330,7 +459,7 @@ typedef struct _CLoraTransceiverItf_ReceivedLoraPacketInfo
   BYTE m_szFrequency[8];
 
   // LoRa datarate identifier (eg. SF12BW500) 
-  BYTE m_szDataRate[10];
+  BYTE m_szDataRate[12];
 
   // LoRa coding rate identifier (eg. 4/5) 
   BYTE m_szCodingRate[4];
@@ -339,10 +468,23 @@ typedef struct _CLoraTransceiverItf_ReceivedLoraPacketInfo
   BYTE m_szSNR[7];
 
   // RSSI in dBm (signed integer, 1 dB precision)
-  BYTE m_szRSSI[5];
+  BYTE m_szRSSI[7];
 } CLoraTransceiverItf_ReceivedLoraPacketInfoOb;
 
 
+// Slot of receive ring (see 'm_pReceiveRing' in 'CLoraTransceiverItf_InitializeParams')
+typedef struct _CLoraTransceiverItf_ReceiveSlot
+{
+  // Received packet (block of 'm_pLoraPacketPool')
+  CLoraTransceiverItf_LoraPacket m_pPacket;
+
+  // Additional information for received packet
+  CLoraTransceiverItf_ReceivedLoraPacketInfoOb m_PacketInfo;
+} CLoraTransceiverItf_ReceiveSlotOb;
+
+typedef struct _CLoraTransceiverItf_ReceiveSlot * CLoraTransceiverItf_ReceiveSlot;
+
+
 
 /********************************************************************************************* 
   Public methods of 'ILoraTransceiver' interface
@@ -363,6 +505,8 @@ bool ILoraTransceiver_SetFreqChannel(ILoraTransceiver this, CLoraTransceiverItf_
 bool ILoraTransceiver_StandBy(ILoraTransceiver this, CLoraTransceiverItf_StandByParams pParams);
 bool ILoraTransceiver_Receive(ILoraTransceiver this, CLoraTransceiverItf_ReceiveParams pParams);
 bool ILoraTransceiver_Send(ILoraTransceiver this, CLoraTransceiverItf_SendParams pParams);
+bool ILoraTransceiver_ArmSend(ILoraTransceiver this, CLoraTransceiverItf_ArmSendParams pParams);
+bool ILoraTransceiver_FireSend(ILoraTransceiver this, CLoraTransceiverItf_FireSendParams pParams);
 
 bool ILoraTransceiver_GetReceivedPacketInfo(ILoraTransceiver this, CLoraTransceiverItf_GetReceivedPacketInfoParams pParams);
 
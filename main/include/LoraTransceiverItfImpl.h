@@ -45,6 +45,8 @@ typedef bool (*SetFreqChannel)(void *pOwnerObject, void *pParams);
 typedef bool (*StandBy)(void *pOwnerObject, void *pParams);
 typedef bool (*Receive)(void *pOwnerObject, void *pParams);
 typedef bool (*Send)(void *pOwnerObject, void *pParams);
+typedef bool (*ArmSend)(void *pOwnerObject, void *pParams);
+typedef bool (*FireSend)(void *pOwnerObject, void *pParams);
 
 typedef bool (*GetReceivedPacketInfo)(void *pOwnerObject, void *pParams);
                                                   
@@ -69,6 +71,8 @@ typedef struct _CLoraTransceiverItfImpl
   StandBy m_pStandBy;
   Receive m_pReceive;
   Send m_pSend;
+  ArmSend m_pArmSend;
+  FireSend m_pFireSend;
   GetReceivedPacketInfo m_pGetReceivedPacketInfo;
 } CLoraTransceiverItfImplOb;
 
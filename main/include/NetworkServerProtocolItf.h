@@ -43,11 +43,16 @@ typedef struct _INetworkServerProtocol * INetworkServerProtocol;
 typedef struct _CNetworkServerProtocol_BuildUplinkMessageParams * CNetworkServerProtocolItf_BuildUplinkMessageParams;
 typedef struct _CNetworkServerProtocol_ProcessServerMessageParams * CNetworkServerProtocolItf_ProcessServerMessageParams;
 typedef struct _CNetworkServerProtocol_ProcessSessionEventParams * CNetworkServerProtocolItf_ProcessSessionEventParams;
+typedef struct _CNetworkServerProtocol_DownlinkPacketInfo * CNetworkServerProtocolItf_DownlinkPacketInfo;
+typedef struct _CNetworkServerProtocol_GetExpiredSessionParams * CNetworkServerProtocolItf_GetExpiredSessionParams;
+typedef struct _CNetworkServerProtocol_BuildDownlinkAckParams * CNetworkServerProtocolItf_BuildDownlinkAckParams;
 
 
 // Types for protocol Uplink messages (generic: protocol independent) 
 #define NETWORKSERVERPROTOCOL_UPLINKMSG_HEARTBEAT  0x0001
 #define NETWORKSERVERPROTOCOL_UPLINKMSG_LORADATA   0x0002
+#define NETWORKSERVERPROTOCOL_UPLINKMSG_LORADATA_APPEND   0x0003
+#define NETWORKSERVERPROTOCOL_UPLINKMSG_REPLAY     0x0004
 
 typedef struct _CNetworkServerProtocol_BuildUplinkMessageParams
 {
@@ -56,6 +61,14 @@ typedef struct _CNetworkServerProtocol_BuildUplinkMessageParams
   // Type of Uplink message to generate
   //  - NETWORKSERVERPROTOCOL_UPLINKMSG_HEARTBEAT = Asks the 'ProtocolEngine' if it has a 'heartbeat' message to send
   //  - NETWORKSERVERPROTOCOL_UPLINKMSG_LORADATA = Asks the protocolEngine to build the message for sending LoRa data
+  //  - NETWORKSERVERPROTOCOL_UPLINKMSG_LORADATA_APPEND = Asks the protocolEngine to add LoRa data to a message
+  //    previously built with 'NETWORKSERVERPROTOCOL_UPLINKMSG_LORADATA' (i.e. several LoRa packets in one message).
+  //    The message is specified with 'm_pMessageData', 'm_wMessageLength' and 'm_dwProtocolMessageId'. The 
+  //    'ProtocolEngine' returns 'false' if the LoRa packet cannot be added (typically 'm_wMaxMessageLength' reached)
+  //  - NETWORKSERVERPROTOCOL_UPLINKMSG_REPLAY = Asks the protocolEngine to send again a message previously built
+  //    with 'NETWORKSERVERPROTOCOL_UPLINKMSG_LORADATA' (typically stored when Network Server was unreachable).
+  //    The message is specified with 'm_pMessageData' and 'm_wMessageLength'. The 'ProtocolEngine' creates a new
+  //    transaction and updates the message stream in place (i.e. protocol identifiers)
   WORD m_wMessageType;
 
   // Message identifier in caller 'ServerManager' (used to build 'm_dwProtocolMessageId')
@@ -72,6 +85,8 @@ typedef struct _CNetworkServerProtocol_BuildUplinkMessageParams
   CLoraTransceiverItf_ReceivedLoraPacketInfo m_pLoraPacketInfo;
 
   // Buffer where generate the message stream for Network Server
+  // Note: For 'NETWORKSERVERPROTOCOL_UPLINKMSG_LORADATA_APPEND' the 'm_wMessageLength' is the current length of
+  //       message stream (i.e. updated when LoRa packet is added)
   WORD m_wMaxMessageLength;
   WORD m_wMessageLength;
   BYTE *m_pMessageData;
@@ -87,10 +102,36 @@ typedef struct _CNetworkServerProtocol_BuildUplinkMessageParams
   //             This identifier is the provide 'm_wServerManagerMessageId' (see above)
   //
   // NOTE: This identifier MUST be provided in 'INetworkServerProtocol_ProcessSessionEvent' method's parameters  
+  // NOTE: For 'NETWORKSERVERPROTOCOL_UPLINKMSG_LORADATA_APPEND' this identifier is provided by the caller (i.e.
+  //       identifier returned when the message was built for the first LoRa packet)
   DWORD m_dwProtocolMessageId;
 
 } CNetworkServerProtocol_BuildUplinkMessageParamsOb;
 
+// Transmission parameters for LoRa packet to send to node (i.e. downlink data provided by Network Server)
+// Note: Values are protocol independent (i.e. converted by 'ProtocolEngine' from received message)
+typedef struct _CNetworkServerProtocol_DownlinkPacketInfo
+{
+  // Send packet immediately (i.e. 'm_dwTimestamp' not used)
+  bool m_bImmediate;
+
+  // Send packet when the internal timestamp of gateway reaches this value
+  // Note: Typically 'm_dwTimestamp' of uplink LoRa packet + delay of node's RX window
+  DWORD m_dwTimestamp;
+
+  // TX central frequency in Hz
+  DWORD m_dwFrequency;
+
+  // TX output power in dBm
+  BYTE m_usPower;
+
+  // LoRa modulation
+  BYTE m_usSpreadingFactor;        // Spreading factor (7 to 12)
+  WORD m_wBandwidth;               // Bandwidth in kHz (125, 250 or 500)
+  BYTE m_usCodingRate;             // Denominator of coding rate (5 to 8 for '4/5' to '4/8')
+
+} CNetworkServerProtocol_DownlinkPacketInfoOb;
+
 // Message received from Network Server
 typedef struct _CNetworkServerProtocol_ProcessServerMessageParams
 {
@@ -107,6 +148,12 @@ typedef struct _CNetworkServerProtocol_ProcessServerMessageParams
   WORD m_wLoraPacketLength;
   BYTE *m_pData;
 
+  // RETURNED INFORMATION
+  //
+  // Transmission parameters for the LoRa packet stored in 'm_pData'
+  // Note: Only valid when the method returns 'NETWORKSERVERPROTOCOL_DOWNLINKSESSIONEVENT_PREPARED'
+  CNetworkServerProtocol_DownlinkPacketInfoOb m_DownlinkPacketInfo;
+
   // RETURNED INFORMATION
   //
   // Identifier of message in both 'CLoraServerManager' and associated 'ProtocolEngine'
@@ -116,6 +163,9 @@ typedef struct _CNetworkServerProtocol_ProcessServerMessageParams
   //             retrieve the protocol session associated to the message.
   //  - HIWORD = Identifier in 'CLoraServerManager'.
   //             This identifier is the provide 'm_wServerManagerMessageId' (see above)
+  // Note: When the method returns 'NETWORKSERVERPROTOCOL_DOWNLINKSESSIONEVENT_PREPARED', the
+  //       identifier is the downlink message identifier in 'ProtocolEngine' (i.e. to provide in
+  //       'INetworkServerProtocol_BuildDownlinkAck' method's parameters)
   DWORD m_dwProtocolMessageId; 
 
 } CNetworkServerProtocol_ProcessServerMessageParamsOb;
@@ -146,7 +196,9 @@ typedef struct _CNetworkServerProtocol_ProcessServerMessageParams
 //  - NETWORKSERVERPROTOCOL_UPLINKSESSIONEVENT_FAILED      = A fatal error occured on 'ProtocolEngine' session. 
 //                                                           The session is terminated (no more event/message expected)
 //
-//  - NETWORKSERVERPROTOCOL_DOWNLINKSESSIONEVENT_PREPARED  = 
+//  - NETWORKSERVERPROTOCOL_DOWNLINKSESSIONEVENT_PREPARED  = A LoRa packet to send to node is ready in the caller's buffer
+//                                                           (i.e. payload in 'm_pData' and transmission parameters in
+//                                                           'm_DownlinkPacketInfo')
 //
 //  - NETWORKSERVERPROTOCOL_SESSIONERROR_MESSAGE           = The header of received message is invalid (probably UDP corrupted)
 //                                                           The associated Transaction cannot be found (will be deleted by
@@ -183,6 +235,46 @@ typedef struct _CNetworkServerProtocol_ProcessSessionEventParams
 } CNetworkServerProtocol_ProcessSessionEventParamsOb;
 
 
+// Uplink session expired in 'ProtocolEngine' (i.e. no reply received from Network Server in time)
+// The owner object must terminate the session as 'NETWORKSERVERPROTOCOL_UPLINKSESSIONEVENT_FAILED' and
+// confirm with 'NETWORKSERVERPROTOCOL_SESSIONEVENT_RELEASED'
+typedef struct _CNetworkServerProtocol_GetExpiredSessionParams
+{
+  // Public
+
+  // RETURNED INFORMATION
+  //
+  // Identifier of message in both 'CLoraServerManager' and associated 'ProtocolEngine'
+  // Note: This identifier is provided when uplink message is generated by 'BuildUplinkMessage' method
+  DWORD m_dwProtocolMessageId; 
+
+} CNetworkServerProtocol_GetExpiredSessionParamsOb;
+
+
+// Acknowledge of downlink message received from Network Server (i.e. reply sent to Network Server 
+// when the LoRa packet is scheduled or rejected by the gateway)
+typedef struct _CNetworkServerProtocol_BuildDownlinkAckParams
+{
+  // Public
+
+  // Identifier of downlink message returned by 'ProcessServerMessage' method
+  DWORD m_dwProtocolMessageId;
+
+  // Result of the schedule of LoRa packet ('TRANSCEIVERMANAGER_SENDDOWNLINK_xxx')
+  DWORD m_dwDownlinkResult;
+
+  // Buffer where generate the message stream to send to Network Server
+  WORD m_wMaxMessageLength;
+  BYTE *m_pMessageData;
+
+  // RETURNED INFORMATION
+  //
+  // Length of message stream built in 'm_pMessageData'
+  WORD m_wMessageLength;
+
+} CNetworkServerProtocol_BuildDownlinkAckParamsOb;
+
+
 /********************************************************************************************* 
   Public methods of 'INetworkServerProtocol' interface
  
@@ -196,6 +288,8 @@ uint32_t INetworkServerProtocol_ReleaseItf(INetworkServerProtocol this);
 bool INetworkServerProtocol_BuildUplinkMessage(INetworkServerProtocol this, CNetworkServerProtocolItf_BuildUplinkMessageParams pParams);
 DWORD INetworkServerProtocol_ProcessServerMessage(INetworkServerProtocol this, CNetworkServerProtocolItf_ProcessServerMessageParams pParams);
 DWORD INetworkServerProtocol_ProcessSessionEvent(INetworkServerProtocol this, CNetworkServerProtocolItf_ProcessSessionEventParams pParams);
+bool INetworkServerProtocol_GetExpiredSession(INetworkServerProtocol this, CNetworkServerProtocolItf_GetExpiredSessionParams pParams);
+bool INetworkServerProtocol_BuildDownlinkAck(INetworkServerProtocol this, CNetworkServerProtocolItf_BuildDownlinkAckParams pParams);
 
 #endif
 
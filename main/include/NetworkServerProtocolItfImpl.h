@@ -37,6 +37,8 @@ typedef uint32_t (*ReleaseItf)(void *pOwnerObject);
 typedef bool (*BuildUplinkMessage)(void *pOwnerObject, CNetworkServerProtocolItf_BuildUplinkMessageParams pParams);
 typedef DWORD (*ProcessServerMessage)(void *pOwnerObject, CNetworkServerProtocolItf_ProcessServerMessageParams pParams);
 typedef DWORD (*ProcessSessionEvent)(void *pOwnerObject, CNetworkServerProtocolItf_ProcessSessionEventParams pParams);
+typedef bool (*GetExpiredSession)(void *pOwnerObject, CNetworkServerProtocolItf_GetExpiredSessionParams pParams);
+typedef bool (*BuildDownlinkAck)(void *pOwnerObject, CNetworkServerProtocolItf_BuildDownlinkAckParams pParams);
                                                   
 
 /********************************************************************************************* 
@@ -54,6 +56,8 @@ typedef struct _CNetworkServerProtocolItfImpl
   BuildUplinkMessage m_pBuildUplinkMessage;
   ProcessServerMessage m_pProcessServerMessage;
   ProcessSessionEvent m_pProcessSessionEvent;
+  GetExpiredSession m_pGetExpiredSession;
+  BuildDownlinkAck m_pBuildDownlinkAck;
 } CNetworkServerProtocolItfImplOb;
 
 typedef struct _CNetworkServerProtocolItfImpl * CNetworkServerProtocolItfImpl;
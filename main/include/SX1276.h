@@ -20,6 +20,7 @@ COMMENTS: This program is designed for execution on ESP32 Module (Dev.C kit).
 *********************************************************************************************/
 
 #include "driver/spi_master.h"
+#include "Utilities.h"
 
 
 /********************************************************************************************* 
@@ -36,13 +37,24 @@ COMMENTS: This program is designed for execution on ESP32 Module (Dev.C kit).
   Definitions for ESP32 PIN used for SPI with Semtech SX1276 chip
 *********************************************************************************************/
 
+// Shared SPI bus (all SX1276 devices)
 #define PIN_NUM_MISO       25
 #define PIN_NUM_MOSI       23
 #define PIN_NUM_CLK        19
-#define PIN_NUM_CS         22       // TO DO : Single SX1276 
-#define PIN_NUM_RX_TX_IRQ  02       // Receive and sent IRQ on same PIN (i.e. software configuration
-                                    // of DIO mapping on SX1276)
-                                    // TO DO : Single SX1276 
+
+// Pins of each SX1276 on the shared SPI bus (indexed by SPI slave ID, see 'm_usSpiSlaveID' in
+// 'CLoraTransceiverItf_InitializeParams')
+//  - m_nPinCS  = Chip select
+//  - m_nPinIrq = Receive and sent IRQ on same PIN (i.e. software configuration of DIO mapping
+//                on SX1276)
+#define SX1276_MAX_DEVICES        3
+#define SX1276_DEVICE_PINS        { { .m_nPinCS = 22, .m_nPinIrq = 2 },   \
+                                    { .m_nPinCS = 18, .m_nPinIrq = 4 },   \
+                                    { .m_nPinCS = 5,  .m_nPinIrq = 26 } }
+
+// Depth of SPI transaction queue (i.e. maximum number of pipelined transactions, see 
+// 'CSX1276SpiBatchOb')
+#define SX1276_SPI_QUEUE_SIZE   7
 
 
 /********************************************************************************************* 
@@ -156,11 +168,25 @@ COMMENTS: This program is designed for execution on ESP32 Module (Dev.C kit).
 #define REG_FORMER_TEMP             0x6C
 #define REG_BIT_RATE_FRAC           0x70
 
+// Register shadow (CSX1276 object)
+// Notes:
+//  - The shadow covers registers 0x00 to 0x7F
+//  - Cached registers are configuration registers only written by the host in LoRa mode
+//    (i.e. never status, IRQ or FIFO pointer registers updated by the chip)
+//  - The flags are 32 bits words (bit 31 of first word is the flag of register 0)
+#define SX1276_SHADOW_SIZE          0x80
+#define SX1276_SHADOW_FLAG_MASK(address)  (0x80000000 >> ((address) % 32))
+// Cached registers: 0x01-0x0C, 0x0E, 0x0F, 0x11, 0x1D-0x24, 0x26, 0x31, 0x33, 0x37, 0x39, 0x40-0x42,
+//                   0x4B, 0x5A
+#define SX1276_SHADOW_CACHED_REGS   { 0x7FFB4007, 0xFA005140, 0xE0100020, 0x00000000 }
+
 // SX1276 LoRa Modes
 #define LORA_SLEEP_MODE             0x80
 #define LORA_STANDBY_MODE           0x81
+#define LORA_FSTX_MODE              0x82
 #define LORA_TX_MODE                0x83
 #define LORA_RX_MODE                0x85
+#define LORA_CAD_MODE               0x87
 #define LORA_STANDBY_FSK_REGS_MODE  0xC1
 
 #define FSK_SLEEP_MODE              0x00        // Sleep mode for FSK modulation
@@ -316,10 +342,11 @@ COMMENTS: This program is designed for execution on ESP32 Module (Dev.C kit).
 // structure (i.e. storage optimization when owner object copies received packet) 
 typedef struct _LoraPacket
 {
-  // System tick count for LoRaWAN protocol time rules (i.e. uplink RX windows)
-  // Received packet = when packet is received
+  // Gateway clock in microseconds for LoRaWAN protocol time rules (i.e. uplink RX windows)
+  // Received packet = IRQ edge of 'RxDone' (latched in transceiver ISR)
   // Packet to send  = when sending packet bytes begins
-  DWORD m_dwTimestamp;
+  // Note: See 'GATEWAY_CLOCK_MICROSEC' in Definitions.h
+  QWORD m_qwTimestamp;
 
   // Packet payload size
   // Note: This member variable is used as synchronization flag for packet transmission to other
@@ -353,7 +380,7 @@ typedef struct _ReceivedLoraPacketInfo
   BYTE m_szFrequency[8];
 
   // LoRa datarate identifier (eg. SF12BW500) 
-  BYTE m_szDataRate[10];
+  BYTE m_szDataRate[12];
 
   // LoRa coding rate identifier (eg. 4/5) 
   BYTE m_szCodingRate[4];
@@ -362,10 +389,196 @@ typedef struct _ReceivedLoraPacketInfo
   BYTE m_szSNR[7];
 
   // RSSI in dBm (signed integer, 1 dB precision)
-  BYTE m_szRSSI[5];
+  BYTE m_szRSSI[7];
 } CReceivedLoraPacketInfo;
 
 
+/********************************************************************************************* 
+ Scanner mode
+*********************************************************************************************/
+
+// Phases of scanner mode
+//  - CAD    = Channel activity detection in progress ('CadDone' IRQ expected)
+//  - LOCKED = Activity detected, receiving on channel ('RxDone' IRQ or lock timeout expected)
+#define SX1276_SCAN_PHASE_OFF         0
+#define SX1276_SCAN_PHASE_CAD         1
+#define SX1276_SCAN_PHASE_LOCKED      2
+
+// Time budget of scanner mode
+//  - SX1276_SCAN_HOP_TIME        = Default time to change channel/SF and start CAD (microseconds)
+//  - SX1276_SCAN_CAD_SYMBOLS     = Duration of CAD (symbols)
+//  - SX1276_SCAN_SYNC_SYMBOLS    = Preamble symbols still required after CAD to synchronize RX
+//  - SX1276_SCAN_LOCK_SYMBOLS    = Sync word and margin after preamble (i.e. RX lock released
+//                                  at this point if modem is not synchronized)
+//  - SX1276_SCAN_MAX_WAIT        = Watchdog for a lost 'CadDone' IRQ (milliseconds)
+#define SX1276_SCAN_HOP_TIME          300
+#define SX1276_SCAN_CAD_SYMBOLS       2
+#define SX1276_SCAN_SYNC_SYMBOLS      2
+#define SX1276_SCAN_LOCK_SYMBOLS      5
+#define SX1276_SCAN_MAX_WAIT          100
+
+// Adaptive dwell schedule
+//  - SX1276_SCAN_HIT_SCORE       = Score added to a channel for each received packet (also base
+//                                  weight of a channel without received packet)
+//  - SX1276_SCAN_MAX_SCORE       = Maximum score of a channel
+//  - SX1276_SCAN_DECAY_CAD       = Number of CAD before scores are halved
+#define SX1276_SCAN_HIT_SCORE         8
+#define SX1276_SCAN_MAX_SCORE         1024
+#define SX1276_SCAN_DECAY_CAD         4096
+
+
+// Channel/SF pair of scanner mode
+// Notes:
+//  - The window is the maximum interval between two CAD on the channel for detecting the LoRa
+//    preamble early enough to receive the packet
+//  - The revisit interval is the interval scheduled by the adaptive dwell schedule (i.e. equal
+//    to window if the time budget allows it)
+typedef struct _CSX1276ScanChannel
+{
+  BYTE m_usFreqChannel;
+  BYTE m_usSpreadingFactor;
+
+  // Timing (microseconds)
+  //  - m_dwSymbolTime = LoRa symbol duration
+  //  - m_dwCadTime    = CAD duration (i.e. cost of a visit is 'm_dwHopTime' + 'm_dwCadTime')
+  DWORD m_dwSymbolTime;
+  DWORD m_dwCadTime;
+  DWORD m_dwWindow;
+  DWORD m_dwRevisit;
+  QWORD m_qwLastVisit;
+
+  // Activity score (decayed)
+  WORD m_wScore;
+
+} CSX1276ScanChannelOb;
+
+
+// Scanner mode (CSX1276 object)
+// Notes:
+//  - The next channel is the one with the earliest revisit time (i.e. last CAD + revisit)
+//  - The hop time is measured on each 'CadDone' IRQ (i.e. averaged value used for budget)
+//  - The statistics are written in the array provided by owner object or in 'm_Statistics'
+typedef struct _CSX1276Scanner
+{
+  CSX1276ScanChannelOb m_Channels[LORATRANSCEIVERITF_SCAN_MAX_CHANNELS];
+  BYTE m_usChannelNumber;
+  BYTE m_usCurrent;
+
+  // Read by ISR to identify the IRQ (see 'SX1276_SCAN_PHASE_xxx')
+  volatile BYTE m_usPhase;
+
+  bool m_bAdaptiveDwell;
+  bool m_bLockExtended;
+
+  // Hop time (microseconds) and load of time budget (per mille, > 1000 if all channels cannot
+  // be revisited within their window)
+  DWORD m_dwHopTime;
+  DWORD m_dwLoad;
+
+  QWORD m_qwHopStart;
+  QWORD m_qwLockDeadline;
+
+  // Number of CAD since last score decay
+  DWORD m_dwCadNumber;
+
+  // Configured channel and SF restored at end of scanner mode ('REG_FRF_MSB', 'REG_FRF_MID',
+  // 'REG_FRF_LSB', 'REG_MODEM_CONFIG2' and 'REG_MODEM_CONFIG3')
+  BYTE m_usSavedRegs[5];
+
+  CLoraTransceiverItf_ScanStatistics m_pStatistics;
+  CLoraTransceiverItf_ScanStatisticsOb m_Statistics[LORATRANSCEIVERITF_SCAN_MAX_CHANNELS];
+
+} CSX1276ScannerOb;
+
+
+// Radio settings of the armed packet (CSX1276 object)
+// Notes:
+//  - The settings requested by 'ArmSend' are applied only for the transmission of this packet
+//    (i.e. downlink on frequency, SF, BW, CR and power requested by Network Server)
+//  - The configured settings ('SetFreqChannel', 'SetLoraMode' and 'SetPowerMode') are restored
+//    when the SX1276 leaves the 'ARMED' or 'SENDING' automaton state
+typedef struct _CSX1276TxRadio
+{
+  bool m_bActive;
+
+  // Configured settings ('REG_FRF_MSB', 'REG_FRF_MID', 'REG_FRF_LSB', 'REG_MODEM_CONFIG1',
+  // 'REG_MODEM_CONFIG2', 'REG_MODEM_CONFIG3' and 'REG_PA_CONFIG')
+  BYTE m_usSavedRegs[7];
+
+} CSX1276TxRadioOb;
+
+
+/********************************************************************************************* 
+ SPI bus
+*********************************************************************************************/
+
+// Pins of one SX1276 (see 'SX1276_DEVICE_PINS')
+typedef struct _CSX1276DevicePins
+{
+  int m_nPinCS;
+  int m_nPinIrq;
+
+} CSX1276DevicePinsOb;
+
+
+// Arbiter of the SPI bus shared by all SX1276 (one global object)
+// Notes:
+//  - The bus is owned for one SPI transaction or one batch of pipelined transactions (i.e. the
+//    configuration traffic of one SX1276 is interleaved with RX servicing of other SX1276)
+//  - The RX servicing has priority: a SX1276 signals a received packet in its ISR and the other
+//    SX1276 defer their configuration traffic until the packet is read (see 'CSX1276_busAcquire')
+//  - The bus is initialized when the first SX1276 is attached (i.e. 'Initialize' commands
+//    are serialized by owner object)
+typedef struct _CSX1276SpiBus
+{
+  // Ownership of the bus
+  SemaphoreHandle_t m_hMutex;
+
+  // Number of SX1276 waiting for RX servicing
+  volatile DWORD m_dwRxPendingNumber;
+
+  // Number of SX1276 attached to the bus
+  BYTE m_usDeviceNumber;
+
+} CSX1276SpiBusOb;
+
+
+/********************************************************************************************* 
+ SPI backend
+*********************************************************************************************/
+
+// Access methods to the SPI device of SX1276
+// Notes:
+//  - The methods have the prototypes of ESP-IDF 'spi_device_transmit', 'spi_device_queue_trans'
+//    and 'spi_device_get_trans_result' (i.e. ESP-IDF driver used without wrapper on device)
+//  - A mock SX1276 device is provided for Linux host (see 'SX1276MockSpi.h')
+typedef struct _CSX1276SpiBackend
+{
+  esp_err_t (*m_pTransmit)(spi_device_handle_t hDevice, spi_transaction_t *pTrans);
+  esp_err_t (*m_pQueueTrans)(spi_device_handle_t hDevice, spi_transaction_t *pTrans, TickType_t dwTicksToWait);
+  esp_err_t (*m_pGetTransResult)(spi_device_handle_t hDevice, spi_transaction_t **ppTrans, TickType_t dwTicksToWait);
+
+} CSX1276SpiBackendOb;
+
+typedef struct _CSX1276SpiBackend * CSX1276SpiBackend;
+
+
+// Batch of pipelined SPI transactions
+// Notes:
+//  - Transactions are queued in SPI driver when added to the batch and executed in order
+//    (i.e. the automaton task does not wait for each transfer)
+//  - The results are collected by 'CSX1276_batchWait'. The value of a register read is copied
+//    to the location specified when the transaction was added (i.e. 'spi_transaction_t.user')
+typedef struct _CSX1276SpiBatch
+{
+  spi_transaction_t m_Trans[SX1276_SPI_QUEUE_SIZE];
+
+  // Number of transactions queued and not yet collected
+  BYTE m_usCount;
+
+} CSX1276SpiBatchOb;
+
+
 /********************************************************************************************* 
  SX1276 Class
 *********************************************************************************************/
@@ -497,6 +710,10 @@ typedef struct _CSX1276
   // Indicates FSK or LoRa modem.
   uint8_t m_usModemMode;
 
+  // Gateway clock latched at last RX_DONE/TX_DONE IRQ edge (microseconds)
+  // Note: Written by 'CSX1276_PacketRxTxIntHandler' before task notification
+  volatile QWORD m_qwIrqTimestamp;
+
   // Number of received packets successfully transmited to owner
   DWORD m_dwPacketReceivedNumber;
 
@@ -511,9 +728,23 @@ typedef struct _CSX1276
   //       (i.e. 'Send' method on ILoraTransceiver' interface) 
   CLoraTransceiverItf_LoraPacket m_pPacketToSend;
 
+  // SPI transaction starting TX mode (i.e. prepared when packet is preloaded, see 
+  // 'CSX1276_armSend')
+  spi_transaction_t m_FireTrans;
+
   // Data block containing the last received received packet
+  // Note: With shared packet buffers, this is the block of 'm_pLoraPacketPool' where next
+  //       packet will be received (NULL if the pool was exhausted when previous packet was 
+  //       provided to owner object)
   CLoraPacket *m_pPacketReceived;
 
+  // Pool of shared packet buffers provided by owner object (NULL if not used)
+  CWideMemoryBlockArray m_pLoraPacketPool;
+
+  // Receive ring provided by owner object (NULL if not used)
+  // Note: The CSX1276 automaton is the producer ('CLoraTransceiverItf_ReceiveSlotOb' slots)
+  CSpscRing m_pReceiveRing;
+
   // Additional information associated to last received packet:
   //  - The radio setting information is updated when settings are changed
   //  - The information about packet reception are recorded when packet is received
@@ -524,10 +755,50 @@ typedef struct _CSX1276
   // Module temperature.
   int m_nTemp;
 
-  // ID of SX1276 on SPI bus
+  // ID of SX1276 on SPI bus and associated pins (see 'SX1276_DEVICE_PINS')
   BYTE m_usSpiSlaveID;
+  int m_nPinCS;
+  int m_nPinIrq;
   spi_device_handle_t m_SpiDeviceHandle;
 
+  // Priority of RX servicing on shared SPI bus (see 'CSX1276SpiBusOb')
+  // Packet received signaled by ISR and counted in 'm_dwRxPendingNumber' of bus (i.e. accesses
+  // of this SX1276 are never deferred until the packet is read)
+  volatile bool m_bRxPending;
+
+  // Scanner mode (see 'CLoraTransceiverItf_ScanParams')
+  CSX1276ScannerOb m_Scanner;
+
+  // Radio settings of the armed packet (see 'CLoraTransceiverItf_ArmSendParams')
+  CSX1276TxRadioOb m_TxRadio;
+
+  // SPI device access methods (see 'CSX1276_SetSpiBackend') and batch of pipelined transactions
+  const CSX1276SpiBackendOb *m_pSpiBackend;
+  CSX1276SpiBatchOb m_SpiBatch;
+
+  // Shadow of SX1276 registers (write-back cache for configuration registers)
+  // Notes:
+  //  - Only registers of 'SX1276_SHADOW_CACHED_REGS' are cached, and only when LoRa registers
+  //    are mapped (i.e. see 'CSX1276_isCachedRegister')
+  //  - Bit 31 of first word is the flag of register 0
+  //  - The dirty registers are written on next SPI access or by 'CSX1276_flushRegisters'
+  //    (contiguous dirty registers are written with one SPI burst)
+  BYTE m_usRegShadow[SX1276_SHADOW_SIZE];
+  DWORD m_dwRegValidFlags[SX1276_SHADOW_SIZE / 32];
+  DWORD m_dwRegDirtyFlags[SX1276_SHADOW_SIZE / 32];
+
+  // SPI statistics
+  //  - Total number of SPI transactions and of transactions saved by register shadow
+  //  - Transactions saved during last command (i.e. reconfiguration) and last packet event
+  //  - Number of batches (i.e. waits for a group of pipelined transactions)
+  //  - Number of accesses deferred for RX servicing of another SX1276
+  DWORD m_dwSpiTransactionNumber;
+  DWORD m_dwSpiBatchNumber;
+  DWORD m_dwSpiDeferredNumber;
+  DWORD m_dwSpiSavedNumber;
+  DWORD m_dwSpiSavedLastCommand;
+  DWORD m_dwSpiSavedLastPacket;
+
   // Interrupt ESP objects
   intr_handle_t m_hPacketReceivedIntOb;
 
@@ -549,6 +820,8 @@ bool CSX1276_SetFreqChannel(void *this, void *pParams);
 bool CSX1276_StandBy(void *this, void *pParams);
 bool CSX1276_Receive(void *this, void *pParams);
 bool CSX1276_Send(void *this, void *pParams);
+bool CSX1276_ArmSend(void *this, void *pParams);
+bool CSX1276_FireSend(void *this, void *pParams);
 
 bool CSX1276_GetReceivedPacketInfo(void *this, void *pParams);
 
@@ -557,6 +830,8 @@ bool CSX1276_GetReceivedPacketInfo(void *this, void *pParams);
 CSX1276 * CSX1276_New();
 void CSX1276_Delete(CSX1276 *this);
 
+void CSX1276_SetSpiBackend(CSX1276 *this, const CSX1276SpiBackendOb *pBackend, spi_device_handle_t hDevice);
+
 
 // Automaton
 #define SX1276_AUTOMATON_STATE_CREATED         0
@@ -566,15 +841,21 @@ void CSX1276_Delete(CSX1276 *this);
 #define SX1276_AUTOMATON_STATE_SENDING         4
 #define SX1276_AUTOMATON_STATE_TERMINATED      5
 #define SX1276_AUTOMATON_STATE_ERROR           6
+#define SX1276_AUTOMATON_STATE_ARMED           7      // Packet preloaded, waiting for 'FireSend'
 
 
 #define SX1276_AUTOMATON_NOTIFY_NONE              0x00000000
 #define SX1276_AUTOMATON_NOTIFY_COMMAND           0x00000001
 #define SX1276_AUTOMATON_NOTIFY_PACKET_RECEIVED   0x00000002
 #define SX1276_AUTOMATON_NOTIFY_PACKET_SENT       0x00000004
+#define SX1276_AUTOMATON_NOTIFY_CAD_DONE          0x00000008
 
 #define SX1276_AUTOMATON_MAX_CMD_DURATION         2000
 
+// Maximum wait for the SPI bus when a transmission is fired (RTOS ticks)
+// Note: The transmission is cancelled if the late limit is reached when the bus is obtained
+#define SX1276_FIRE_BUS_MAX_WAIT                  1
+
 #define SX1276_AUTOMATON_CMD_NONE                 0x00000000
 #define SX1276_AUTOMATON_CMD_INITIALIZE           0x00000001
 #define SX1276_AUTOMATON_CMD_SETLORAMAC           0x00000002
@@ -584,6 +865,7 @@ void CSX1276_Delete(CSX1276 *this);
 #define SX1276_AUTOMATON_CMD_STANDBY              0x00000006
 #define SX1276_AUTOMATON_CMD_RECEIVE              0x00000007
 #define SX1276_AUTOMATON_CMD_SEND                 0x00000008
+#define SX1276_AUTOMATON_CMD_ARMSEND              0x00000009
 
 
 void CSX1276_PacketRxTxIntHandler(CSX1276 *this);
@@ -594,6 +876,8 @@ bool CSX1276_NotifyAndProcessCommand(CSX1276 *this, DWORD dwCommand, void *pCmdP
 bool CSX1276_ProcessAutomatonNotifyCommand(CSX1276 *this);
 bool CSX1276_ProcessAutomatonNotifyPacketReceived(CSX1276 *this);
 bool CSX1276_ProcessAutomatonNotifyPacketSent(CSX1276 *this);
+bool CSX1276_ProcessAutomatonNotifyCadDone(CSX1276 *this);
+bool CSX1276_ProcessAutomatonScanTimeout(CSX1276 *this);
 
 
 bool CSX1276_ProcessInitialize(CSX1276 *this, CLoraTransceiverItf_InitializeParams pParams);
@@ -604,6 +888,7 @@ bool CSX1276_ProcessSetFreqChannel(CSX1276 *this, CLoraTransceiverItf_SetFreqCha
 bool CSX1276_ProcessStandBy(CSX1276 *this, CLoraTransceiverItf_StandByParams pParams);
 bool CSX1276_ProcessReceive(CSX1276 *this, CLoraTransceiverItf_ReceiveParams pParams);
 bool CSX1276_ProcessSend(CSX1276 *this, CLoraTransceiverItf_SendParams pParams);
+bool CSX1276_ProcessArmSend(CSX1276 *this, CLoraTransceiverItf_ArmSendParams pParams);
 
 // Private methods (implementation)
 
@@ -638,8 +923,11 @@ uint8_t CSX1276_setPreambleLength(CSX1276 *this, uint16_t PreambleLength);
 uint8_t CSX1276_getSNR(CSX1276 *this);
 uint8_t CSX1276_getRSSI(CSX1276 *this);
 uint8_t CSX1276_getRSSIpacket(CSX1276 *this);
+void CSX1276_setPacketSignal(CSX1276 *this, BYTE usSnrValue, BYTE usRssiValue);
 uint8_t CSX1276_getSF(CSX1276 *this);
 uint8_t CSX1276_getBW(CSX1276 *this);
+DWORD CSX1276_getSymbolTime(CSX1276 *this, BYTE usSpreadingFactor);
+void CSX1276_setDataRateText(CSX1276 *this, BYTE usSpreadingFactor);
 
 uint8_t CSX1276_setRetries(CSX1276 *this, uint8_t RetryNumber);
 
@@ -652,7 +940,22 @@ uint8_t CSX1276_getRegs(CSX1276 *this);
 uint8_t CSX1276_startStandBy(CSX1276 *this);
 uint8_t CSX1276_startReceive(CSX1276 *this);
 uint8_t CSX1276_getPacket(CSX1276 *this);
+CLoraPacket * CSX1276_getReceiveBuffer(CSX1276 *this);
 uint8_t CSX1276_startSend(CSX1276 *this, CLoraTransceiverItf_LoraPacket pLoraPacket);
+uint8_t CSX1276_armSend(CSX1276 *this, CLoraTransceiverItf_LoraPacket pLoraPacket);
+bool CSX1276_fireSend(CSX1276 *this, QWORD qwLateTimestamp);
+uint8_t CSX1276_setTxRadio(CSX1276 *this, CLoraTransceiverItf_ArmSendParams pParams);
+void CSX1276_restoreTxRadio(CSX1276 *this);
+
+uint8_t CSX1276_startScan(CSX1276 *this, CLoraTransceiverItf_ScanParams pParams);
+void CSX1276_stopScan(CSX1276 *this);
+void CSX1276_scanHop(CSX1276 *this);
+void CSX1276_scanLock(CSX1276 *this);
+void CSX1276_scanPacketReceived(CSX1276 *this, bool bReceived);
+void CSX1276_scanUpdateSchedule(CSX1276 *this);
+BYTE CSX1276_scanSelectChannel(CSX1276 *this);
+void CSX1276_scanSetRadio(CSX1276 *this, BYTE usFreqChannel, BYTE usSpreadingFactor);
+TickType_t CSX1276_scanGetWaitTicks(CSX1276 *this);
 
 uint8_t CSX1276_getTemp(CSX1276 *this);
 
@@ -662,8 +965,30 @@ bool CSX1276_IsDeviceConfigured(CSX1276 *this);
 
 // Private methods static (implementation)
 
-BYTE CSX1276_readRegister(spi_device_handle_t SPIDeviceHandle, BYTE address);
-void CSX1276_writeRegister(spi_device_handle_t SPIDeviceHandle, BYTE address, BYTE data);
+BYTE CSX1276_readRegister(CSX1276 *this, BYTE address);
+void CSX1276_writeRegister(CSX1276 *this, BYTE address, BYTE data);
+void CSX1276_readBurst(CSX1276 *this, BYTE address, BYTE *pBuffer, WORD wLength);
+void CSX1276_writeBurst(CSX1276 *this, BYTE address, BYTE *pBuffer, WORD wLength);
+void CSX1276_flushRegisters(CSX1276 *this);
+void CSX1276_invalidateRegisters(CSX1276 *this);
+bool CSX1276_isCachedRegister(CSX1276 *this, BYTE address);
+
+void CSX1276_busAcquire(CSX1276 *this);
+void CSX1276_busRelease(CSX1276 *this);
+
+void CSX1276_batchBegin(CSX1276 *this);
+void CSX1276_batchReadRegister(CSX1276 *this, BYTE address, BYTE *pusValue);
+void CSX1276_batchWriteRegister(CSX1276 *this, BYTE address, BYTE data);
+void CSX1276_batchReadBurst(CSX1276 *this, BYTE address, BYTE *pBuffer, WORD wLength);
+void CSX1276_batchWriteBurst(CSX1276 *this, BYTE address, BYTE *pBuffer, WORD wLength);
+void CSX1276_batchWait(CSX1276 *this);
+void CSX1276_batchQueue(CSX1276 *this, spi_transaction_t *pTrans);
+void CSX1276_batchClearFlags(CSX1276 *this);
+
+BYTE CSX1276_spiReadRegister(CSX1276 *this, BYTE address);
+void CSX1276_spiWriteRegister(CSX1276 *this, BYTE address, BYTE data);
+void CSX1276_spiReadBurst(CSX1276 *this, BYTE address, BYTE *pBuffer, WORD wLength);
+void CSX1276_spiWriteBurst(CSX1276 *this, BYTE address, BYTE *pBuffer, WORD wLength);
 
 bool CSX1276_isSF(uint8_t SpreadingFactor);
 bool CSX1276_isBW(uint16_t Bandwidth);
@@ -0,0 +1,122 @@
+/*****************************************************************************************//**
+ * @file     SX1276MockSpi.h
+ *
+ * @author   F.Fargon
+ *
+ * @version  V1.0
+ *
+ * @date     16/10/2026
+ *
+ * @brief    Mock SX1276 device for Linux host.
+ *
+ * @details  This file implements the 'CSX1276MockSpi' class:\n
+ *            - Simulated SX1276 registers and FIFO accessed through the 'CSX1276SpiBackendOb'
+ *              methods (i.e. the CSX1276 driver runs unmodified on Linux host)
+ *            - Simulated SPI transaction queue (i.e. pipeline depth and latency of
+ *              'CSX1276SpiBatchOb' can be measured)
+*********************************************************************************************/
+
+#ifndef SX1276MOCKSPI_H_
+#define SX1276MOCKSPI_H_
+
+#ifndef ESP_PLATFORM
+
+#include <pthread.h>
+
+#include "SX1276.h"
+
+
+/*********************************************************************************************
+ SX1276MockSpi Class
+
+ Mock SX1276 device on a simulated SPI bus
+
+ The transactions are executed in order by a worker thread:
+  - Each transaction lasts 'm_dwTransferLatency' (i.e. bus transfer time)
+  - The simulated SPI bus is shared by all 'CSX1276MockSpi' objects (i.e. transfers of several
+    mock devices are serialized)
+  - A caller waiting for a transaction result is delayed by 'm_dwWakeupLatency' (i.e. task
+    switch when the SPI driver releases the caller)
+  - A blocking transaction (i.e. 'm_pTransmit' method) is queued and waited for
+
+ Simulated device:
+  - Register 0x00 ('REG_FIFO') accesses the FIFO data buffer at 'REG_FIFO_ADDR_PTR'
+  - Bits written to 1 in 'REG_IRQ_FLAGS' are cleared
+  - 'TX' mode immediately sets the 'TxDone' IRQ flag and returns to 'StandBy' mode
+  - 'CAD' mode immediately sets the 'CadDone' IRQ flag (and 'CadDetected' if the callback set
+    with 'CSX1276MockSpi_SetCadActivity' reports activity) and returns to 'StandBy' mode
+  - Received packets are injected with 'CSX1276MockSpi_InjectPacket'
+
+ Notes:
+  - The 'spi_device_handle_t' passed to the backend methods is the 'CSX1276MockSpi' object
+  - The object is used by a single CSX1276 object (i.e. one client task)
+
+ WARNING: This object cannot be static. It MUST always be allocated by with the construction
+          method ('CSX1276MockSpi_New')
+*********************************************************************************************/
+
+// Class data
+typedef struct _CSX1276MockSpi
+{
+  // Simulated SX1276
+  BYTE m_usRegisters[SX1276_SHADOW_SIZE];
+  BYTE m_usFifo[256];
+
+  // Simulated latencies (microseconds)
+  DWORD m_dwTransferLatency;
+  DWORD m_dwWakeupLatency;
+
+  // Transaction queue (i.e. queued and not yet executed) and completed transactions (i.e. not
+  // yet collected by client)
+  spi_transaction_t *m_pQueuedTrans[SX1276_SPI_QUEUE_SIZE];
+  spi_transaction_t *m_pCompletedTrans[SX1276_SPI_QUEUE_SIZE];
+  BYTE m_usQueuedIndex;
+  BYTE m_usQueuedCount;
+  BYTE m_usCompletedIndex;
+  BYTE m_usCompletedCount;
+
+  // Worker thread
+  pthread_t m_hWorkerThread;
+  pthread_mutex_t m_hMutex;
+  pthread_cond_t m_hCondition;
+  bool m_bTerminate;
+
+  // Channel activity callback (CAD mode)
+  bool (*m_pCadActivity)(void *pContext, DWORD dwRegFreq, BYTE usSpreadingFactor);
+  void *m_pCadContext;
+
+  // Statistics
+  //  - Number of executed transactions
+  //  - Maximum number of transactions in flight (i.e. pipeline depth)
+  DWORD m_dwTransactionNumber;
+  BYTE m_usMaxPipelineDepth;
+
+} CSX1276MockSpiOb;
+
+typedef struct _CSX1276MockSpi * CSX1276MockSpi;
+
+
+// SPI backend methods (see 'g_SX1276MockSpiBackendOb')
+extern const CSX1276SpiBackendOb g_SX1276MockSpiBackendOb;
+
+
+// Public methods
+CSX1276MockSpi CSX1276MockSpi_New(DWORD dwTransferLatency, DWORD dwWakeupLatency);
+void CSX1276MockSpi_Delete(CSX1276MockSpi this);
+
+void CSX1276MockSpi_InjectPacket(CSX1276MockSpi this, const BYTE *pData, BYTE usLength, BYTE usSnrValue, BYTE usRssiValue);
+void CSX1276MockSpi_SetCadActivity(CSX1276MockSpi this, 
+                                   bool (*pCadActivity)(void *pContext, DWORD dwRegFreq, BYTE usSpreadingFactor),
+                                   void *pContext);
+
+DWORD CSX1276MockSpi_GetTransactionNumber(CSX1276MockSpi this);
+BYTE CSX1276MockSpi_GetMaxPipelineDepth(CSX1276MockSpi this);
+
+esp_err_t CSX1276MockSpi_Transmit(spi_device_handle_t hDevice, spi_transaction_t *pTrans);
+esp_err_t CSX1276MockSpi_QueueTrans(spi_device_handle_t hDevice, spi_transaction_t *pTrans, TickType_t dwTicksToWait);
+esp_err_t CSX1276MockSpi_GetTransResult(spi_device_handle_t hDevice, spi_transaction_t **ppTrans, TickType_t dwTicksToWait);
+
+
+#endif
+
+#endif
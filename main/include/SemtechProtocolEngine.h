@@ -54,8 +54,11 @@
 //  - For optimization, allowed values are a power of 2 (2, 4, 8, 16 ...)
 //  - For details, see how Semtech Message identifier is generated
 //  - The Semtech Mesage identified is a WORD (16 bits)
-#define SEMTECHPROTOCOLENGINE_MAX_TRANSACTION_BITS   3
-#define SEMTECHPROTOCOLENGINE_MAX_TRANSACTIONS       ((0x01 << SEMTECHPROTOCOLENGINE_MAX_TRANSACTION_BITS) * 2)
+//  - The transaction identifier is stored in the low bits of message identifier. Therefore
+//    the collection size cannot exceed the range of 'SEMTECHPROTOCOLENGINE_TRANSACTION_ID_MASK'
+//    (maximum 12 bits, at least 4 bits are required for the message counter)
+#define SEMTECHPROTOCOLENGINE_MAX_TRANSACTION_BITS   4
+#define SEMTECHPROTOCOLENGINE_MAX_TRANSACTIONS       (0x01 << SEMTECHPROTOCOLENGINE_MAX_TRANSACTION_BITS)
 #define SEMTECHPROTOCOLENGINE_TRANSACTION_ID_MASK    (0xFFFF >> (16 - SEMTECHPROTOCOLENGINE_MAX_TRANSACTION_BITS))
 
 
@@ -64,10 +67,33 @@
 //  - For uplink messages: 
 //     .. SENDING = The message will be transmited to the transport layer
 //     .. SENT = The message has been sent to NetworkServer. Waiting for 'ACK'
+//     .. ACKNOWLEDGED = The 'ACK' message has been received (waiting for release by owner object)
+//     .. EXPIRED = No 'ACK' message received before timeout (waiting for release by owner object)
 //     .. The 'Transaction' object is deleted when send failed, 'ACK' received or timeout
-#define SEMTECHPROTOCOLENGINE_TRANSACTION_STATE_UNKNOWN    0
-#define SEMTECHPROTOCOLENGINE_TRANSACTION_STATE_SENDING    0x0001
-#define SEMTECHPROTOCOLENGINE_TRANSACTION_STATE_SENT       0x0002
+#define SEMTECHPROTOCOLENGINE_TRANSACTION_STATE_UNKNOWN       0
+#define SEMTECHPROTOCOLENGINE_TRANSACTION_STATE_SENDING       0x0001
+#define SEMTECHPROTOCOLENGINE_TRANSACTION_STATE_SENT          0x0002
+#define SEMTECHPROTOCOLENGINE_TRANSACTION_STATE_ACKNOWLEDGED  0x0003
+#define SEMTECHPROTOCOLENGINE_TRANSACTION_STATE_EXPIRED       0x0004
+
+
+// Timer wheel for expiry of transactions waiting for 'ACK' (i.e. in 'SENT' state)
+//  - The wheel is an array of slots, each slot covers 'SEMTECHPROTOCOLENGINE_TIMERWHEEL_SLOT_DURATION'
+//    milliseconds and contains the list of transactions expiring in this period (modulo the wheel 
+//    duration)
+//  - The number of slots must be a power of 2
+//  - For efficiency the wheel duration should be greater than 'CONFIG_SEMTECH_ACK_TIMEOUT' (i.e. the
+//    transactions are expired on first visit of their slot)
+#define SEMTECHPROTOCOLENGINE_TIMERWHEEL_SLOT_BITS       4
+#define SEMTECHPROTOCOLENGINE_TIMERWHEEL_SLOTS           (0x01 << SEMTECHPROTOCOLENGINE_TIMERWHEEL_SLOT_BITS)
+#define SEMTECHPROTOCOLENGINE_TIMERWHEEL_SLOT_MASK       (SEMTECHPROTOCOLENGINE_TIMERWHEEL_SLOTS - 1)
+#define SEMTECHPROTOCOLENGINE_TIMERWHEEL_SLOT_DURATION   250
+
+// Slot number for a tick count (i.e. not masked with 'SEMTECHPROTOCOLENGINE_TIMERWHEEL_SLOT_MASK')
+#define SEMTECHPROTOCOLENGINE_TIMERWHEEL_SLOT(ticks)     ((ticks) / pdMS_TO_TICKS(SEMTECHPROTOCOLENGINE_TIMERWHEEL_SLOT_DURATION))
+
+// End of list in timer wheel slots (i.e. invalid transaction identifier)
+#define SEMTECHPROTOCOLENGINE_TIMERWHEEL_NONE            0xFFFF
 
 
 // Constants for Semtech protocol
@@ -83,6 +109,16 @@
 #define SEMTECHPROTOCOLENGINE_SEMTECH_MESSAGE_PULL_ACK    4
 #define SEMTECHPROTOCOLENGINE_SEMTECH_MESSAGE_TX_ACK      5
 
+// Fields of 'txpk' object in PULL_RESP message (i.e. flags used to check that required fields are present)
+#define SEMTECHPROTOCOLENGINE_TXPK_FIELD_TIME     0x01    // 'tmst' or 'imme'
+#define SEMTECHPROTOCOLENGINE_TXPK_FIELD_FREQ     0x02
+#define SEMTECHPROTOCOLENGINE_TXPK_FIELD_DATR     0x04
+#define SEMTECHPROTOCOLENGINE_TXPK_FIELD_CODR     0x08
+#define SEMTECHPROTOCOLENGINE_TXPK_FIELD_DATA     0x10
+#define SEMTECHPROTOCOLENGINE_TXPK_FIELDS_REQUIRED  0x1F
+
+// TX output power (in dBm) when not specified in 'txpk' object
+#define SEMTECHPROTOCOLENGINE_TXPK_DEFAULT_POWER  14
 
 
 /********************************************************************************************* 
@@ -115,7 +151,7 @@ typedef struct _CSemtechMessageTransaction
   // Idenfifier of the 'SemtechMessageTransaction'
   // Note: This identifier is the index in the 'MemoryBlockArray' used to maintain the
   //       'SemtechMessageTransaction' collection (i.e. Semtech Protocol messages)
-  BYTE m_usTransactionId;
+  WORD m_wTransactionId;
 
   // Type of Semtech protocol transaction
   // Values are 'SEMTECHMESSAGETRANSACTION_TYPE_xxx'
@@ -125,7 +161,7 @@ typedef struct _CSemtechMessageTransaction
   // Random identifier used for the associated Semtech Protocol message
   // Used to retrieve the transaction associated to a Semtech message (i.e. this identifier is
   // part of Semtech protocol)
-  // Note: This identifer is optimized in order to contain the 'm_usTransactionId' for quick
+  // Note: This identifer is optimized in order to contain the 'm_wTransactionId' for quick
   //       retrieval of transaction in 'MemoryBlockArray' 
   WORD m_wMessageId;
 
@@ -148,6 +184,10 @@ typedef struct _CSemtechMessageTransaction
   // Message is heartbeat (i.e. not a forwarded LoRa packet)
   bool m_bHeartbeat;
 
+  // Number of LoRa packets in the 'rxpk' array of PUSH_DATA message (0 for heartbeat)
+  // Note: Several LoRa packets are sent in the same message when 'ServerManager' aggregates uplink packets
+  BYTE m_usLoraPacketNumber;
+
   // State of Semtech message transaction ('SEMTECHPROTOCOLENGINE_TRANSACTION_STATE_xxx')
   WORD m_wTransactionState;
 
@@ -157,6 +197,15 @@ typedef struct _CSemtechMessageTransaction
   // Tick count for last event
   TickType_t m_dwLastEventTicks;
 
+  // Tick count when the transaction expires (i.e. in 'SENT' state)
+  TickType_t m_dwExpiryTicks;
+
+  // Links in the timer wheel slot list (i.e. identifiers of previous and next transactions)
+  // Note: The 'm_wTimerSlot' is 'SEMTECHPROTOCOLENGINE_TIMERWHEEL_NONE' when not in timer wheel
+  WORD m_wTimerSlot;
+  WORD m_wPrevTimerId;
+  WORD m_wNextTimerId;
+
 } CSemtechMessageTransactionOb;
 
 typedef struct _CSemtechMessageTransaction * CSemtechMessageTransaction;
@@ -197,7 +246,7 @@ typedef struct _CSemtechProtocolEngine
 
   // Collection of 'SemtechMessageTransaction' currently active
   // Memory block array for 'CSemtechMessageTransactionOb' objects
-  CMemoryBlockArray m_pTransactionArray;
+  CWideMemoryBlockArray m_pTransactionArray;
 
   // Counter for generation of message identifier
   // Note: To avoid identifier with a zero value, the first value for this counter is 1
@@ -221,15 +270,31 @@ typedef struct _CSemtechProtocolEngine
   //  - These counters are used to build the 'stat' block in PUSH_DATA messages
   DWORD m_dwRxnbCount;             // Number of LoRa packets received by gateway
   DWORD m_dwRxokCount;             // Number of LoRa packets received by gateway with valid CRC
-  DWORD m_dwRxfwCount;             // Number of LoRa packets forwarded to Network Server
+  DWORD m_dwRxfwCount;             // Number of LoRa packets forwarded to Network Server (atomic, 'SENT' event or ACK)
   DWORD m_dwDwnbCount;             // Number of PULL_RESP received by gateway (from Network Server)
   DWORD m_dwTxnbCount;             // Number of packets transmited to LoRa nodes by gateway
 
   DWORD m_dwUpnbCount;             // Number of uplink messages sent by gateway to Network Server 
                                    // for any kinds of messages (i.e. not only for Lora packets)
+                                   // (atomic, 'SENT' event or ACK received first)
   DWORD m_dwAckrCount;             // Number of ACK received by gateway (from Network Server) 
                                    // for any kinds of messages (i.e. not only for Lora packets)
 
+  // Counters for uplink messages not acknowledged by Network Server
+  DWORD m_dwAckLostCount;          // Number of transactions expired before reception of ACK
+  DWORD m_dwAckLateCount;          // Number of ACK received after expiry of transaction (atomic, 'Connector' task)
+
+  // Timer wheel for transactions waiting for ACK
+  // Each entry is the identifier of first transaction in slot list
+  // Note: Only accessed by the task invoking 'ProcessSessionEvent' and 'GetExpiredSession' methods
+  WORD m_wTimerWheel[SEMTECHPROTOCOLENGINE_TIMERWHEEL_SLOTS];
+  TickType_t m_dwTimerWheelTicks;  // Tick count of last timer wheel processing
+
+  // Cached ISO 8601 date and time (i.e. 'YYYY-MM-DDTHH:MM:SS', not null terminated)
+  // Calendar conversion is executed only once per second for 'time' fields in PUSH_DATA messages
+  DWORD m_dwIsoTimeSec;            // UTC time (in seconds) of the cached string
+  BYTE m_strIsoTime[19];
+
   // Gateway GPS coordinates
   // Typically provided during initialization (from configuration or GPS data)
   // Optimized for execution time in message formating functions 
@@ -263,7 +328,7 @@ typedef struct _CSemtechProtocolEngine
 
   // 'ServerManager' task (main automaton)
   // Used for internal messages and external commands via 'IServerManager' interface
-  TaskFunction_t m_hServerManagerTask;
+  TaskHandle_t m_hServerManagerTask;
   QueueHandle_t m_hServerManagerQueue;
 
   // For command processing by 'ServerManager' task
@@ -276,11 +341,11 @@ typedef struct _CSemtechProtocolEngine
   // 'NodeManager' task (automaton for exchange with 'LoraNodeManager')
   // Used to process uplink packets received from 'LoraNodeManager'
   // This 'Task' is known by the 'LoraNodeManager' (i.e. attached) and is direcly notified
-  TaskFunction_t m_hNodeManagerTask;
+  TaskHandle_t m_hNodeManagerTask;
 
   // 'Connector' task (automaton for exchange with 'ServerConnector' objects)
   // Used to process notifications for downlink packet received from 'NetworkServer (by 'ServerConnectors')
-  TaskFunction_t m_hConnectorTask;
+  TaskHandle_t m_hConnectorTask;
   QueueHandle_t m_hConnectorNotifQueue;
 
   //
@@ -289,7 +354,7 @@ typedef struct _CSemtechProtocolEngine
 
   // Task in 'CLoraNodeManager' object to ask for sending (forward) downlink packet to node device
   // A NULL value indicates that 'LoraNodeManager' is not attached (see 'ILoraNodeManager_Attach' method)
-//TaskFunction_t m_hPacketForwarderTask;
+//TaskHandle_t m_hPacketForwarderTask;
 
   // Uplink packet currently sent to the 'LoraNodeManager'
   // Note: This object is owned by the 'CSemtechProtocolEngine' object. It must be explicitly released by the
@@ -325,6 +390,8 @@ uint32_t CSemtechProtocolEngine_ReleaseItf(void *this);
 bool CSemtechProtocolEngine_BuildUplinkMessage(void *this, CNetworkServerProtocolItf_BuildUplinkMessageParams pParams);
 DWORD CSemtechProtocolEngine_ProcessServerMessage(void *this, CNetworkServerProtocolItf_ProcessServerMessageParams pParams);
 DWORD CSemtechProtocolEngine_ProcessSessionEvent(void *this, CNetworkServerProtocolItf_ProcessSessionEventParams pParams);
+bool CSemtechProtocolEngine_GetExpiredSession(void *this, CNetworkServerProtocolItf_GetExpiredSessionParams pParams);
+bool CSemtechProtocolEngine_BuildDownlinkAck(void *this, CNetworkServerProtocolItf_BuildDownlinkAckParams pParams);
 
 
 // Construction
@@ -338,8 +405,19 @@ void CSemtechProtocolEngine_Delete(CSemtechProtocolEngine *this);
 
 
 // Class private methods (implementation helpers)
-WORD CSemtechProtocolEngine_GetNewMessageId(CSemtechProtocolEngine *this, BYTE usTransactionId);
-BYTE * CSemtechProtocolEngine_GetStatStream(CSemtechProtocolEngine *this, BYTE *pStreamData);
+WORD CSemtechProtocolEngine_GetNewMessageId(CSemtechProtocolEngine *this, WORD wTransactionId);
+bool CSemtechProtocolEngine_AppendUplinkPacket(CSemtechProtocolEngine *this, CNetworkServerProtocolItf_BuildUplinkMessageParams pParams);
+BYTE * CSemtechProtocolEngine_GetStatStream(CSemtechProtocolEngine *this, BYTE *pStreamData, BYTE *pStreamEnd);
+BYTE * CSemtechProtocolEngine_GetRxpkStream(CSemtechProtocolEngine *this, BYTE *pStreamData, BYTE *pStreamEnd,
+                                            CLoraTransceiverItf_LoraPacket pLoraPacket, 
+                                            CLoraTransceiverItf_ReceivedLoraPacketInfo pPacketInfo);
+BYTE * CSemtechProtocolEngine_GetIsoTime(CSemtechProtocolEngine *this, DWORD dwUTCSec);
+bool CSemtechProtocolEngine_ParseTxpkStream(CSemtechProtocolEngine *this, const BYTE *pStreamData, const BYTE *pStreamEnd,
+                                            CNetworkServerProtocolItf_ProcessServerMessageParams pParams);
+bool CSemtechProtocolEngine_ParseDataRate(CJsonToken pToken, BYTE *pusSpreadingFactor, WORD *pwBandwidth);
+bool CSemtechProtocolEngine_SwitchTransactionState(CSemtechMessageTransaction pMessageTransaction, WORD wFromState, WORD wToState);
+void CSemtechProtocolEngine_StartTransactionTimer(CSemtechProtocolEngine *this, CSemtechMessageTransaction pMessageTransaction);
+void CSemtechProtocolEngine_StopTransactionTimer(CSemtechProtocolEngine *this, CSemtechMessageTransaction pMessageTransaction);
 DWORD CSemtechProtocolEngine_GetElapsedTicks(DWORD dwCurrentTicks, DWORD dwPreviousTicks);
 
 
@@ -103,7 +103,7 @@ typedef struct _CServerConnectorItf_StartParams
 } CServerConnectorItf_StartParamsOb;
 
 
-typedef struct _CServerConnectorItf_StoptParams
+typedef struct _CServerConnectorItf_StopParams
 {
   // Public
   bool m_bForce;
@@ -127,7 +127,7 @@ typedef struct _CServerManagerItf_InitializeParams
 typedef struct _CServerManagerItf_AttachParams
 {
   // Public
-  TaskFunction_t m_hNodeManagerTask;
+  TaskHandle_t m_hNodeManagerTask;
 } CServerManagerItf_AttachParamsOb;
 
 
@@ -138,20 +138,26 @@ typedef struct _CServerManagerItf_StartParams
 } CServerManagerItf_StartParamsOb;
 
 
-typedef struct _CServerManagerItf_StoptParams
+typedef struct _CServerManagerItf_StopParams
 {
   // Public
   bool m_bForce;
 } CServerManagerItf_StopParamsOb;
 
 
-// Uplink packets are transmitted using direct RTOS notification (see 'Attach' method)
-// The notification variable is a pointer to 'CServerManagerItf_LoraSessionPacket' object
+// Uplink packets are transmitted in a bounded queue provided by the 'ServerManager' (see 'Attach'
+// method). The queue items are pointers to 'CServerManagerItf_LoraSessionPacket' objects and the
+// 'ServerManager' task is woken with a direct RTOS notification (i.e. no notification value)
+// Note: The 'CServerManagerItf_LoraSessionPacket' object is owned by the session and remains valid
+//       until the 'ServerManager' sends the 'ACCEPTED' or 'REJECTED' session event
 
 typedef struct _CServerManagerItf_LoraSessionPacket
 {
   // Public
   void *m_pLoraPacket;                // 'CLoraTransceiverItf_LoraPacket' object
+  void *m_pLoraPacketPool;            // 'CWideMemoryBlockArray' containing 'm_pLoraPacket' (shared
+                                      // packet buffers, a reference must be added by 'ServerManager' 
+                                      // to use the packet after the 'ACCEPTED' session event)
   void *m_pLoraPacketInfo;            // 'CLoraTransceiverItf_ReceivedLoraPacketInfo' object                    
   void *m_pSession;                   // Associated session for LoraPacket 
                                       // Significant only for calling object
@@ -0,0 +1,151 @@
+/*****************************************************************************************//**
+ * @file     TaskPlacement.h
+ *
+ * @author   F.Fargon
+ *
+ * @version  V1.0
+ *
+ * @date     16/10/2026
+ *
+ * @brief    Placement of gateway RTOS tasks on ESP32 cores.
+ *
+ * @details  This file implements the 'CTaskPlacement' functions:\n
+ *            - Creation of gateway tasks with core, priority and stack size defined in the
+ *              central placement table ('g_TaskPlacementTable' in Configuration.h)
+ *            - Monitor task tracing per-core utilisation and latency of tasks on radio path
+*********************************************************************************************/
+
+#ifndef TASKPLACEMENT_H_
+#define TASKPLACEMENT_H_
+
+/*********************************************************************************************
+  Definitions for debug traces
+  The debug level is specified with 'TASKPLACEMENT_DEBUG_LEVEL' in Definitions.h file
+*********************************************************************************************/
+
+#define TASKPLACEMENT_DEBUG_LEVEL0 ((TASKPLACEMENT_DEBUG_LEVEL & 0x01) > 0)
+#define TASKPLACEMENT_DEBUG_LEVEL1 ((TASKPLACEMENT_DEBUG_LEVEL & 0x02) > 0)
+#define TASKPLACEMENT_DEBUG_LEVEL2 ((TASKPLACEMENT_DEBUG_LEVEL & 0x04) > 0)
+
+
+/*********************************************************************************************
+  Definitions (implementation)
+*********************************************************************************************/
+
+// Identifiers of gateway tasks (i.e. index in 'g_TaskPlacementTable')
+// Radio path (uplink reception and realtime downlink transmission)
+#define TASKPLACEMENT_TASK_SX1276                     0     // One task per 'CSX1276' object
+#define TASKPLACEMENT_TASK_REALTIMESENDER             1
+#define TASKPLACEMENT_TASK_NODEMANAGER_TRANSCEIVER    2
+#define TASKPLACEMENT_TASK_NODEMANAGER_SERVER         3
+#define TASKPLACEMENT_TASK_NODEMANAGER_SESSION        4
+// Encoding and backhaul (exchange with Network Server)
+#define TASKPLACEMENT_TASK_SERVERMANAGER_NODEMANAGER  5
+#define TASKPLACEMENT_TASK_SERVERMANAGER_MAIN         6
+#define TASKPLACEMENT_TASK_SERVERMANAGER_CONNECTOR    7
+#define TASKPLACEMENT_TASK_WIFICONNECTOR_MAIN         8
+#define TASKPLACEMENT_TASK_WIFICONNECTOR_RECEIVE      9
+// Trace of utilisation and latency, drain of binary trace records
+#define TASKPLACEMENT_TASK_MONITOR                    10
+#define TASKPLACEMENT_TASK_TRACEDRAIN                 11
+// Simulated devices (one task per 'CLoraNodeSwarm' object, Linux host load generator)
+#ifndef ESP_PLATFORM
+  #define TASKPLACEMENT_TASK_NODESWARM                12
+
+  #define TASKPLACEMENT_TASK_NUMBER                   13
+#else
+  #define TASKPLACEMENT_TASK_NUMBER                   12
+#endif
+
+// Core of a task ('m_usCore')
+// Note: On ESP32, WiFi and lwIP tasks are running on core 0 (PRO_CPU)
+#define TASKPLACEMENT_CORE_0                          0
+#define TASKPLACEMENT_CORE_1                          1
+#define TASKPLACEMENT_CORE_ANY                        0xFF
+
+#define TASKPLACEMENT_CORE_NUMBER                     2
+
+// Maximum number of RTOS tasks in utilisation trace (i.e. gateway, framework and idle tasks)
+#define TASKPLACEMENT_MAX_TRACED_TASKS                32
+
+
+/*********************************************************************************************
+ TaskPlacement functions
+
+ Central placement of the gateway tasks
+
+ Each gateway task is created with 'CTaskPlacement_CreateTask' using its entry in the
+ placement table (i.e. name, core, priority and stack size defined in Configuration.h).
+ The default placement puts the radio path on one core and the encoding / backhaul path on
+ the other core (see 'CONFIG_TASK_RADIO_CORE' and 'CONFIG_TASK_BACKHAUL_CORE').
+
+ The monitor task periodically traces:
+  - The utilisation of each core (i.e. time not spent in idle task of the core, requires
+    'configGENERATE_RUN_TIME_STATS' in RTOS configuration)
+  - The CPU time used by gateway tasks
+  - The latency of tasks on radio path (i.e. delay between the IRQ timestamp of a received
+    packet and its processing by the task, see 'CTaskPlacement_RecordLatency')
+
+ Notes:
+  - The latency statistics of a task are updated with atomic operations (i.e. no lock, the
+    SX1276 entry is shared by the tasks of all transceivers) and read by the monitor task
+  - The RTOS task names are used to match the run time counters with the table entries (i.e.
+    names must be unique in the first 'configMAX_TASK_NAME_LEN - 1' characters)
+  - On Linux host, the core affinity is ignored (i.e. tasks created with 'xTaskCreate')
+*********************************************************************************************/
+
+// Placement of a task (entry of 'g_TaskPlacementTable')
+typedef struct _CTaskPlacementEntry
+{
+  // RTOS task name
+  const char *m_pszName;
+
+  // Core ('TASKPLACEMENT_CORE_xxx')
+  BYTE m_usCore;
+
+  // RTOS priority
+  BYTE m_usPriority;
+
+  // Stack size (bytes)
+  WORD m_wStackSize;
+
+} CTaskPlacementEntryOb;
+
+typedef struct _CTaskPlacementEntry * CTaskPlacementEntry;
+
+
+// Statistics of a task (monitor)
+typedef struct _CTaskPlacementStat
+{
+  // Latency of events processed by task (microseconds)
+  // Note: 'm_dwLatencySum' wraps (i.e. the monitor uses the difference between two traces)
+  volatile DWORD m_dwEventNumber;
+  volatile DWORD m_dwLatencySum;
+  volatile DWORD m_dwLatencyMax;
+
+  // Values at previous trace
+  DWORD m_dwPrevEventNumber;
+  DWORD m_dwPrevLatencySum;
+  DWORD m_dwPrevRunTime;
+
+} CTaskPlacementStatOb;
+
+typedef struct _CTaskPlacementStat * CTaskPlacementStat;
+
+
+// Placement table (defined in Configuration.h)
+extern const CTaskPlacementEntryOb g_TaskPlacementTable[TASKPLACEMENT_TASK_NUMBER];
+
+
+// Public functions
+bool CTaskPlacement_CreateTask(BYTE usTaskId, TaskFunction_t pTaskFunction, void *pParams, TaskHandle_t *pTaskHandle);
+void CTaskPlacement_RecordLatency(BYTE usTaskId, QWORD qwEventTimestamp);
+bool CTaskPlacement_StartMonitor(DWORD dwPeriod);
+
+// Private functions
+void CTaskPlacement_MonitorTask(void *pParams);
+void CTaskPlacement_TraceUtilisation(DWORD dwPeriod);
+void CTaskPlacement_TraceLatency();
+
+
+#endif
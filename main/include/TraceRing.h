@@ -0,0 +1,143 @@
+/*****************************************************************************************//**
+ * @file     TraceRing.h
+ *
+ * @author   F.Fargon
+ *
+ * @version  V1.0
+ *
+ * @date     16/10/2026
+ *
+ * @brief    Binary trace records for hot paths.
+ *
+ * @details  This file implements the 'CTraceRing' functions:\n
+ *            - Fixed-size binary trace records written in a lock-free ring per core (i.e. no
+ *              formatting and no UART output in the traced task)
+ *            - Drain task rendering the records as text
+*********************************************************************************************/
+
+#ifndef TRACERING_H_
+#define TRACERING_H_
+
+
+/*********************************************************************************************
+  Definitions (implementation)
+*********************************************************************************************/
+
+// Number of records in the ring of each core (power of 2)
+#define TRACERING_RECORD_NUMBER           128
+
+// Number of rings (one per ESP32 core)
+#define TRACERING_CORE_NUMBER             2
+
+// Period (milliseconds) of the drain task
+#define TRACERING_DRAIN_PERIOD            100
+
+// Maximum number of arguments of a record
+#define TRACERING_MAX_ARGS                4
+
+// Identifiers of trace events (i.e. index in 'g_TraceRingEventFormats')
+#define TRACERING_ID_SX1276_RX_PACKET             0     // Length, SNR, RSSI, IRQ flags
+#define TRACERING_ID_SX1276_RX_PAYLOAD            1     // Length, bytes 0-3, 4-7, 8-11
+#define TRACERING_ID_SX1276_TX_ARM                2     // Length, bytes 0-3, 4-7, 8-11
+#define TRACERING_ID_SX1276_TX_FIRE               3     // Transmission timestamp
+#define TRACERING_ID_NODEMANAGER_SESSION          4     // Session id, DevAddr, FCnt, message type
+#define TRACERING_ID_SERVERMANAGER_UPLINK         5     // Session id, message id, length, timestamp
+#define TRACERING_ID_SERVERMANAGER_ACCEPTED       6     // Session id, message id
+#define TRACERING_ID_SEMTECH_RXPK                 7     // Length, bytes 0-3, 4-7, 8-11
+#define TRACERING_ID_SEMTECH_UPLINK_MESSAGE       8     // Length, pending transactions, bytes 0-3, 4-7
+
+#define TRACERING_ID_NUMBER                       9
+
+
+/*********************************************************************************************
+ TraceRing functions
+
+ Binary trace of the gateway
+
+ A trace point writes a fixed-size record (event id, microsecond timestamp and up to four
+ arguments) in the ring of the current core:
+  - A position is reserved with an atomic increment of ring head (i.e. several tasks and ISRs
+    of the same core can write without lock)
+  - The record is committed by writing its sequence number (i.e. position + 1) after the data
+  - The oldest records are overwritten when the ring is full (i.e. the trace point never
+    waits)
+
+ The drain task (low priority) periodically renders the committed records with the format
+ string of their event id ('g_TraceRingEventFormats') and reports the number of records lost
+ (i.e. overwritten before drain).
+
+ Trace points are filtered at compile time:
+  - 'TRACERING_ENABLE' in Definitions.h (i.e. 'TRACERING_EVENT' expands to nothing when 0)
+  - The debug level of the module (i.e. trace points are placed in the same '#if' blocks as
+    the 'DEBUG_PRINT' traces they replace), trace points without 'DEBUG_PRINT' equivalent
+    (e.g. SX1276 TX arm/fire) depend on 'TRACERING_ENABLE' only
+
+ Notes:
+  - A task may be migrated between the reservation of a position and the commit (i.e. the
+    rings are per core for locality, the reservation is atomic on both cores)
+  - A record not yet committed stops the drain until the writer commits it or the ring wraps
+*********************************************************************************************/
+
+#if (TRACERING_ENABLE)
+  #define TRACERING_EVENT(wEventId, dwArg0, dwArg1, dwArg2, dwArg3) \
+    (CTraceRing_Write((wEventId), (DWORD) (dwArg0), (DWORD) (dwArg1), (DWORD) (dwArg2), (DWORD) (dwArg3)))
+#else
+  #define TRACERING_EVENT(wEventId, dwArg0, dwArg1, dwArg2, dwArg3)   ((void) 0)
+#endif
+
+// Packs 4 bytes of a buffer in a trace argument (i.e. rendered in buffer order with '%08X')
+#define TRACERING_BYTES(pData, dwLength, dwOffset)   (CTraceRing_PackBytes((const BYTE *) (pData), (DWORD) (dwLength), (dwOffset)))
+
+
+// Trace record
+typedef struct _CTraceRecord
+{
+  // Sequence number (i.e. ring position + 1 when record is committed, 0 while written)
+  volatile DWORD m_dwSequence;
+
+  // Timestamp (low part of 'GATEWAY_CLOCK_MICROSEC')
+  DWORD m_dwTimestamp;
+
+  WORD m_wEventId;
+  WORD m_wReserved;
+
+  DWORD m_dwArgs[TRACERING_MAX_ARGS];
+
+} CTraceRecordOb;
+
+typedef struct _CTraceRecord * CTraceRecord;
+
+
+// Ring of one core
+typedef struct _CTraceRing
+{
+  // Next position to write (i.e. reserved by trace points)
+  volatile DWORD m_dwHead;
+
+  // Next position to render (drain task only)
+  DWORD m_dwTail;
+
+  // Number of records lost (drain task only)
+  DWORD m_dwLostNumber;
+  DWORD m_dwReportedLostNumber;
+
+  CTraceRecordOb m_Records[TRACERING_RECORD_NUMBER];
+
+} CTraceRingOb;
+
+typedef struct _CTraceRing * CTraceRing;
+
+
+// Public functions
+void CTraceRing_Write(WORD wEventId, DWORD dwArg0, DWORD dwArg1, DWORD dwArg2, DWORD dwArg3);
+DWORD CTraceRing_PackBytes(const BYTE *pData, DWORD dwLength, DWORD dwOffset);
+bool CTraceRing_StartDrain();
+DWORD CTraceRing_Drain();
+
+// Private functions
+void CTraceRing_DrainTask(void *pParams);
+DWORD CTraceRing_DrainRing(CTraceRing pRing, BYTE usCore);
+void CTraceRing_RenderRecord(CTraceRecord pRecord, BYTE usCore);
+
+
+#endif
@@ -58,6 +58,16 @@ typedef struct _CTransceiverManagerItf_LoraTransceiverSettings
   CLoraTransceiverItf_SetLoraModeParamsOb LoraMode;
   CLoraTransceiverItf_SetPowerModeParamsOb PowerMode;
   CLoraTransceiverItf_SetFreqChannelParamsOb FreqChannel;
+
+  // Scanner mode used in receive mode (i.e. no scan if 'm_usChannelNumber' is 0)
+  // Note: 'm_pStatistics' is ignored (i.e. statistics provided by 'TransceiverManager')
+  CLoraTransceiverItf_ScanParamsOb Scan;
+
+  // Number of slots in receive ring (i.e. received packets waiting for processing)
+  WORD m_wReceiveRingDepth;
+
+  // Identifier of the transceiver on the shared SPI bus (i.e. CS and IRQ pins)
+  BYTE m_usSpiSlaveID;
 } CTransceiverManagerItf_LoraTransceiverSettingsOb;
 
 typedef struct _CTransceiverManagerItf_LoraTransceiverSettings * CTransceiverManagerItf_LoraTransceiverSettings;
@@ -83,7 +93,11 @@ typedef CTransceiverManagerItf_InitializeParamsOb * CTransceiverManagerItf_Initi
 typedef struct _CTransceiverManagerItf_AttachParams
 {
   // Public
-  TaskFunction_t m_hPacketForwarderTask;
+  TaskHandle_t m_hPacketForwarderTask;
+
+  // Bounded queue of uplink packets ('CMpscRing' of 'CServerManagerItf_LoraSessionPacket' handles)
+  // drained by the 'm_hPacketForwarderTask' task (i.e. owned by the 'ServerManager')
+  void *m_pUplinkQueue;
 } CTransceiverManagerItf_AttachParamsOb;
 
 typedef CTransceiverManagerItf_AttachParamsOb * CTransceiverManagerItf_AttachParams;
@@ -98,7 +112,7 @@ typedef struct _CTransceiverManagerItf_StartParams
 typedef CTransceiverManagerItf_StartParamsOb * CTransceiverManagerItf_StartParams;
 
 
-typedef struct _CTransceiverManagerItf_StoptParams
+typedef struct _CTransceiverManagerItf_StopParams
 {
   // Public
   bool m_bForce;
@@ -139,6 +153,68 @@ typedef CTransceiverManagerItf_SessionEventOb * CTransceiverManagerItf_SessionEv
 #define TRANSCEIVERMANAGER_SESSIONEVENT_DOWNLINK_FAILED     (TRANSCEIVERMANAGER_SESSIONEVENT_BASE + 8)
 
 
+/********************************************************************************************* 
+  CTransceiverManagerItf_SendDownlinkParams object
+
+  Used by the 'ServerManager' to transmit a downlink LoRa packet provided by the Network Server
+  (i.e. packet to send to a node at the time requested by the Network Server).
+  The 'TransceiverManager' copies the payload and schedules the transmission before returning
+  (i.e. the caller gets the result required by the protocol, typically Semtech 'TX_ACK').
+  The method returns within 'TRANSCEIVERMANAGER_SENDDOWNLINK_MAX_DURATION' (i.e. result 
+  'TOO_LATE' if the packet cannot be scheduled in this delay), the caller is typically the 
+  'Connector' task which must also process the acknowledges of Network Server in time.
+*********************************************************************************************/
+
+typedef struct _CTransceiverManagerItf_SendDownlinkParams
+{
+  // Public
+
+  // LoRa packet payload (i.e. LoRaWAN PHYPayload)
+  WORD m_wPayloadSize;
+  BYTE *m_pPayload;
+
+  // Send packet immediately (i.e. 'm_dwTimestamp' not used)
+  bool m_bImmediate;
+
+  // Send packet when the gateway clock reaches this value (i.e. 32 low bits of gateway clock in
+  // microseconds, same as timestamp reported for uplink packets)
+  DWORD m_dwTimestamp;
+
+  // Radio settings requested by the Network Server (i.e. Semtech 'txpk' units)
+  // Note: A zero value means setting of the node RX window
+  DWORD m_dwFrequency;                // Frequency in Hz
+  BYTE m_usPower;                     // Output power in dBm
+  BYTE m_usSpreadingFactor;           // 7 to 12
+  WORD m_wBandwidth;                  // Bandwidth in kHz (125, 250 or 500)
+  BYTE m_usCodingRate;                // 5 to 8 (i.e. 4/5 to 4/8)
+
+  // RETURNED INFORMATION
+  //
+  // Result of the schedule ('TRANSCEIVERMANAGER_SENDDOWNLINK_xxx')
+  DWORD m_dwResult;
+
+} CTransceiverManagerItf_SendDownlinkParamsOb;
+
+typedef CTransceiverManagerItf_SendDownlinkParamsOb * CTransceiverManagerItf_SendDownlinkParams;
+
+// Result codes for 'SendDownlink' method
+// Note: The codes are the Semtech protocol errors for 'TX_ACK' message (i.e. same values as 
+//       'LORAREALTIMESENDER_SCHEDULESEND_xxx' codes)
+#define TRANSCEIVERMANAGER_SENDDOWNLINK_NONE                0
+#define TRANSCEIVERMANAGER_SENDDOWNLINK_TOO_LATE            1
+#define TRANSCEIVERMANAGER_SENDDOWNLINK_TOO_EARLY           2
+#define TRANSCEIVERMANAGER_SENDDOWNLINK_COLLISION_PACKET    3
+#define TRANSCEIVERMANAGER_SENDDOWNLINK_COLLISION_BEACON    4
+#define TRANSCEIVERMANAGER_SENDDOWNLINK_TX_FREQ             5
+#define TRANSCEIVERMANAGER_SENDDOWNLINK_TX_POWER            6
+#define TRANSCEIVERMANAGER_SENDDOWNLINK_GPS_UNLOCKED        7
+
+// Maximum duration of 'SendDownlink' method in milliseconds
+// Note: Much shorter than the acknowledge timeout of Network Server protocol (i.e. 2 seconds
+//       for 'PUSH_ACK' and 'PULL_ACK' of Semtech protocol)
+#define TRANSCEIVERMANAGER_SENDDOWNLINK_MAX_DURATION        400
+
+
 /********************************************************************************************* 
   Public methods of 'ITransceiverManager' interface
  
@@ -155,6 +231,7 @@ bool ITransceiverManager_Start(ITransceiverManager this, CTransceiverManagerItf_
 bool ITransceiverManager_Stop(ITransceiverManager this, CTransceiverManagerItf_StopParams pParams);
 
 bool ITransceiverManager_SessionEvent(ITransceiverManager this, CTransceiverManagerItf_SessionEvent pEvent);
+bool ITransceiverManager_SendDownlink(ITransceiverManager this, CTransceiverManagerItf_SendDownlinkParams pParams);
 
 
 
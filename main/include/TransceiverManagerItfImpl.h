@@ -41,6 +41,7 @@ typedef bool (*Attach)(void *pOwnerObject, void *pParams);
 typedef bool (*Start)(void *pOwnerObject, void *pParams);
 typedef bool (*Stop)(void *pOwnerObject, void *pParams);
 typedef bool (*SessionEvent)(void *pOwnerObject, void *pEvent);
+typedef bool (*SendDownlink)(void *pOwnerObject, void *pParams);
 
 
 
@@ -61,6 +62,7 @@ typedef struct _CTransceiverManagerItfImpl
   Start m_pStart;
   Stop m_pStop;
   SessionEvent m_pSessionEvent;
+  SendDownlink m_pSendDownlink;
 
 } CTransceiverManagerItfImplOb;
 
@@ -0,0 +1,190 @@
+/*****************************************************************************************//**
+ * @file     UplinkLog.h
+ *
+ * @author   F.Fargon
+ *
+ * @version  V1.0
+ *
+ * @date     16/10/2026
+ *
+ * @brief    Store-and-forward log for uplink messages.
+ *
+ * @details  This file implements the 'CUplinkLog' class:\n
+ *            - Append-only ring log of encoded uplink messages (i.e. messages that cannot be
+ *              sent to the Network Server when no 'ServerConnector' is available)
+ *            - Storage is provided by a pluggable backend (flash partition on the device, file
+ *              on Linux host)
+*********************************************************************************************/
+
+#ifndef UPLINKLOG_H_
+#define UPLINKLOG_H_
+
+/*********************************************************************************************
+  Definitions for debug traces
+  The debug level is specified with 'UPLINKLOG_DEBUG_LEVEL' in Definitions.h file
+*********************************************************************************************/
+
+#define UPLINKLOG_DEBUG_LEVEL0 ((UPLINKLOG_DEBUG_LEVEL & 0x01) > 0)
+#define UPLINKLOG_DEBUG_LEVEL1 ((UPLINKLOG_DEBUG_LEVEL & 0x02) > 0)
+#define UPLINKLOG_DEBUG_LEVEL2 ((UPLINKLOG_DEBUG_LEVEL & 0x04) > 0)
+
+
+/*********************************************************************************************
+  Definitions (implementation)
+*********************************************************************************************/
+
+// Signature of a log record (i.e. first WORD of record header)
+// Note: An erased header (0xFFFF) indicates the end of records in a sector
+#define UPLINKLOG_RECORD_MAGIC            0x4C55
+
+// Values of 'm_wFlags' in record header
+// Note: The 'CONSUMED' value is written over the 'PENDING' value (i.e. only '1' to '0' bit
+//       transitions, compatible with NOR flash without erase)
+#define UPLINKLOG_RECORD_FLAGS_PENDING    0xFFFF
+#define UPLINKLOG_RECORD_FLAGS_CONSUMED   0x0000
+
+// Records start on 32 bits boundaries
+#define UPLINKLOG_RECORD_SIZE(wLength)    ((sizeof(CUplinkLogRecordHeaderOb) + (wLength) + 3) & ~0x03)
+
+
+/*********************************************************************************************
+ UplinkLogBackend Class
+
+ Storage device used by 'CUplinkLog'
+
+ The storage is addressed by byte offsets and is organized in sectors:
+  - The 'Erase' method sets all bytes of a sector to 0xFF
+  - The 'Write' method is only used on erased bytes, except for record flags (see
+    'UPLINKLOG_RECORD_FLAGS_CONSUMED')
+
+ Notes:
+  - The 'm_dwSize' must be a multiple of 'm_dwSectorSize'
+  - The backend is initialized by the owner of 'CUplinkLog' object (see
+    'CUplinkLog_InitPartitionBackend' and 'CUplinkLog_InitFileBackend') and copied in the
+    'CUplinkLog' object
+*********************************************************************************************/
+
+typedef bool (*CUplinkLogBackend_Read)(void *pContext, DWORD dwOffset, void *pData, DWORD dwLength);
+typedef bool (*CUplinkLogBackend_Write)(void *pContext, DWORD dwOffset, const void *pData, DWORD dwLength);
+typedef bool (*CUplinkLogBackend_Erase)(void *pContext, DWORD dwOffset, DWORD dwLength);
+
+// Class data
+typedef struct _CUplinkLogBackend
+{
+  // Storage device (i.e. partition or file descriptor)
+  void *m_pContext;
+
+  // Size of storage and of erase unit (bytes)
+  DWORD m_dwSize;
+  DWORD m_dwSectorSize;
+
+  // Access methods
+  CUplinkLogBackend_Read m_pRead;
+  CUplinkLogBackend_Write m_pWrite;
+  CUplinkLogBackend_Erase m_pErase;
+
+} CUplinkLogBackendOb;
+
+typedef struct _CUplinkLogBackend * CUplinkLogBackend;
+
+
+/*********************************************************************************************
+ UplinkLog Class
+
+ Append-only ring log for encoded uplink messages
+
+ The log is a sequence of records written in storage sectors used as a ring:
+  - A record never straddles two sectors (i.e. end of sector is left erased)
+  - A sector is erased when the head (i.e. write position) enters it. If the oldest pending
+    records are in this sector, they are dropped (log full = oldest records are lost)
+  - The record is read and consumed at the tail (i.e. FIFO order)
+
+ Crash safety:
+  - The record data is written before the record header. An interrupted append leaves an
+    erased header (i.e. end of records) or a header with wrong CRC (i.e. ignored)
+  - On construction, the log is rebuilt by scanning all sectors. The next record is appended
+    in the sector following the newest record (i.e. a sector partially written before the
+    reboot is never written again)
+
+ Notes:
+  - The object is not thread safe (used only by 'ServerManager' task)
+  - The size of a record is limited to the sector size
+
+ WARNING: This object cannot be static. It MUST always be allocated by with the construction
+          method ('CUplinkLog_New')
+*********************************************************************************************/
+
+// Header of log record (followed by record data)
+typedef struct _CUplinkLogRecordHeader
+{
+  // 'UPLINKLOG_RECORD_MAGIC' for a written record
+  WORD m_wMagic;
+
+  // Length of record data (bytes)
+  WORD m_wLength;
+
+  // Sequence number (incremented for each appended record)
+  DWORD m_dwSequence;
+
+  // CRC16 (CCITT) of 'm_wLength', 'm_dwSequence' and record data
+  WORD m_wCrc;
+
+  // State of record ('UPLINKLOG_RECORD_FLAGS_PENDING' or 'UPLINKLOG_RECORD_FLAGS_CONSUMED')
+  WORD m_wFlags;
+
+} CUplinkLogRecordHeaderOb;
+
+typedef struct _CUplinkLogRecordHeader * CUplinkLogRecordHeader;
+
+
+// Class data
+typedef struct _CUplinkLog
+{
+  // Storage device
+  CUplinkLogBackendOb m_Backend;
+
+  // Number of sectors in storage
+  DWORD m_dwSectorNumber;
+
+  // Write position (offset of next appended record)
+  // Note: A zero offset in sector indicates that the sector must be erased before writing
+  DWORD m_dwHeadOffset;
+
+  // Read position (offset of oldest pending record, meaningless if 'm_dwRecordNumber' is 0)
+  DWORD m_dwTailOffset;
+
+  // Sequence number of next appended record
+  DWORD m_dwSequence;
+
+  // Number of pending records (i.e. appended and not yet consumed)
+  DWORD m_dwRecordNumber;
+
+  // Number of records lost (i.e. overwritten when log is full or found corrupted)
+  DWORD m_dwDroppedNumber;
+
+} CUplinkLogOb;
+
+typedef struct _CUplinkLog * CUplinkLog;
+
+
+// Public methods
+CUplinkLog CUplinkLog_New(CUplinkLogBackend pBackend);
+void CUplinkLog_Delete(CUplinkLog this);
+
+bool CUplinkLog_Append(CUplinkLog this, const BYTE *pData, WORD wLength);
+WORD CUplinkLog_Peek(CUplinkLog this, BYTE *pData, WORD wMaxLength);
+void CUplinkLog_Consume(CUplinkLog this);
+
+DWORD CUplinkLog_GetRecordNumber(CUplinkLog this);
+DWORD CUplinkLog_GetDroppedNumber(CUplinkLog this);
+
+// Storage backends
+#ifdef ESP_PLATFORM
+  bool CUplinkLog_InitPartitionBackend(CUplinkLogBackend pBackend, const char *szPartitionLabel);
+#else
+  bool CUplinkLog_InitFileBackend(CUplinkLogBackend pBackend, const char *szFileName, DWORD dwSize);
+  void CUplinkLog_CloseFileBackend(CUplinkLogBackend pBackend);
+#endif
+
+
+#endif
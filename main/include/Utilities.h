@@ -11,6 +11,9 @@
  *
  * @details  This file implements the following utility classes:\n
  *            - CMemoryBlockArray = Fixed size data blocks with quick allocation
+ *            - CWideMemoryBlockArray = Same as 'CMemoryBlockArray' for large collections
+ *            - CSpscRing = Lock-free single producer / single consumer ring of fixed size slots
+ *            - CMpscRing = Lock-free bounded multi producer / single consumer queue of pointers
 *********************************************************************************************/
 
 #ifndef UTILITIES_H_
@@ -30,6 +33,9 @@
   Definitions (implementation)
 *********************************************************************************************/
 
+// Number of 32 bits words for flags captured by 'CMemoryBlockArray' snapshot enumerator
+// (i.e. maximum array size is 255 blocks)
+#define MEMORYBLOCKARRAY_SNAPSHOT_WORDS   8
 
 
 /********************************************************************************************* 
@@ -39,7 +45,8 @@
 
  Notes: 
   - The maximum size of collection is 255 memory blocks
-  - The object is thread safe
+  - The object is thread safe (mutex or lock-free implementation according to 
+    'MEMORYBLOCKARRAY_LOCKFREE' in Definitions.h)
 
  WARNING: This object cannot be static. It MUST always be allocated by with the construction
           method ('CMemoryBlockArray_New')
@@ -49,6 +56,7 @@
 typedef struct _CMemoryBlockArray
 {
   // This collection is thread safe
+  // Note: The mutex is not created with lock-free implementation
   SemaphoreHandle_t m_hMutex;
 
   // Size of a single memory block 
@@ -57,16 +65,25 @@ typedef struct _CMemoryBlockArray
   // Maximumn number of fixed size memory blocks
   BYTE m_usArraySize;
 
-  // Head of free block list (LIFO, start index 0)
-  // This is the index of the next free block
-  // When head is equal to array size, all blocks are used
-  // When head is 0, the array is empty (i.e. no memory block stored)
-  BYTE m_usFreeBlockListHead;
+  #if (MEMORYBLOCKARRAY_LOCKFREE)
+    // Tagged head of free block list (lock-free LIFO linked list)
+    //  - Bits 0 to 15 are the index of the next free block (array size when all blocks are used)
+    //  - Bits 16 to 31 are a tag incremented on each update (i.e. ABA protection)
+    volatile DWORD m_dwFreeListHead;
+  #else
+    // Head of free block list (LIFO, start index 0)
+    // This is the index of the next free block
+    // When head is equal to array size, all blocks are used
+    // When head is 0, the array is empty (i.e. no memory block stored)
+    BYTE m_usFreeBlockListHead;
+  #endif
 
   // Note: Keep the following member variables at the end of structure
 
   // Free memory block list (LIFO)
   // The list entry contains the index of free memory block in 'm_pMemoryBlockData'
+  // Note: With lock-free implementation, the entry of a free block contains the index of
+  //       next free block (linked list)
   BYTE *m_pFreeBlockList;
 
   // Memory for data blocks
@@ -127,6 +144,33 @@ typedef struct _CMemoryBlockArrayEnumItem
 
 typedef struct _CMemoryBlockArrayEnumItem * CMemoryBlockArrayEnumItem;
 
+
+// Utility structure for snapshot enumerator (parameter for 'SnapshotStart' and 'SnapshotNext'
+// methods)
+// The 'used and ready' block flags are captured once when enumeration starts and the blocks
+// are provided by reference (i.e. no copy of block data)
+typedef struct _CMemoryBlockArraySnapshot
+{
+  // Index of retrieved block in the array
+  BYTE m_usBlockIndex;
+
+  // Pointer to storage buffer of retrieved block in the array
+  // Note: The caller may directly read the fields it needs in the block
+  BYTE *m_pItemData;
+
+  // Private members
+  // Note: These variables are used by the enumerator methods and caller must not modify them
+
+  // Captured 'used and ready' flags (bit 31 of first word is the flag of block 0)
+  DWORD m_dwFlags[MEMORYBLOCKARRAY_SNAPSHOT_WORDS];
+
+  // Current word in 'm_dwFlags'
+  BYTE m_usWordIndex;
+
+} CMemoryBlockArraySnapshotOb;
+
+typedef struct _CMemoryBlockArraySnapshot * CMemoryBlockArraySnapshot;
+
 // Class constants and definitions
 
 
@@ -144,10 +188,415 @@ bool CMemoryBlockArray_IsBlockReady(CMemoryBlockArray this, BYTE usBlockIndex);
 void CMemoryBlockArray_SetBlockReady(CMemoryBlockArray this, BYTE usBlockIndex);
 bool CMemoryBlockArray_EnumStart(CMemoryBlockArray this, CMemoryBlockArrayEnumItem pEnumItem);
 bool CMemoryBlockArray_EnumNext(CMemoryBlockArray this, CMemoryBlockArrayEnumItem pEnumItem);
+bool CMemoryBlockArray_SnapshotStart(CMemoryBlockArray this, CMemoryBlockArraySnapshot pSnapshot);
+bool CMemoryBlockArray_SnapshotNext(CMemoryBlockArray this, CMemoryBlockArraySnapshot pSnapshot);
+
+
+// Class private methods
+
+
+
+/********************************************************************************************* 
+ WideMemoryBlockArray Class
+
+ Utility class for fixed size data blocks with quick allocation (large collections)
+
+ Notes: 
+  - Same services as 'CMemoryBlockArray' but block indexes are 16 bits values and block flags
+    are stored in 32 bits words (i.e. the maximum size of collection is 65535 memory blocks)
+  - The object is thread safe (lock-free implementation only, 'MEMORYBLOCKARRAY_LOCKFREE' is
+    not used by this class)
+  - The enumeration is only available with the snapshot enumerator
+  - Blocks can be shared by several objects when the array is created with 'NewShared'
+    method. In this case, a reference counter is maintained for each block ('GetBlock'
+    provides a block with one reference, 'AddRef' adds a reference and 'ReleaseRef' releases
+    the block when the last reference is released)
+
+ WARNING: This object cannot be static. It MUST always be allocated by with the construction
+          method ('CWideMemoryBlockArray_New')
+*********************************************************************************************/
+
+// Class data
+typedef struct _CWideMemoryBlockArray
+{
+  // Size of a single memory block 
+  WORD m_wMemoryBlockSize;
+
+  // Maximumn number of fixed size memory blocks
+  WORD m_wArraySize;
+
+  // Number of 32 bits words in block flags bitmaps
+  WORD m_wFlagWordNumber;
+
+  // Tagged head of free block list (lock-free LIFO linked list)
+  //  - Bits 0 to 15 are the index of the next free block (array size when all blocks are used)
+  //  - Bits 16 to 31 are a tag incremented on each update (i.e. ABA protection)
+  volatile DWORD m_dwFreeListHead;
+
+  // Note: Keep the following member variables at the end of structure
+
+  // Free memory block list (linked list, the entry of a free block contains the index of
+  // next free block)
+  WORD *m_pFreeBlockList;
+
+  // Memory for data blocks
+  BYTE *m_pMemoryBlockData;
+
+  // Memory used block flags (bit 31 of first word is the flag of block 0)
+  DWORD *m_pUsedBlockFlags;
+
+  // Memory ready block flags (bit 31 of first word is the flag of block 0)
+  DWORD *m_pReadyBlockFlags;
+
+  // Reference counters of blocks
+  // Note: NULL if array is not created with 'NewShared' method
+  DWORD *m_pRefCounts;
+
+  // Note: Here is the beginning of storage space for data, list, used flags, ready flags and
+  //       reference counters (i.e. allocated within the 'CWideMemoryBlockArray' object)
+
+} CWideMemoryBlockArrayOb;
+
+typedef struct _CWideMemoryBlockArray * CWideMemoryBlockArray;
+
+
+// Utility structure describing one entry in 'CWideMemoryBlockArray'
+typedef struct _CWideMemoryBlockArrayEntry
+{
+  // Pointer to data block (i.e. allocated storage for entry)
+  BYTE *m_pDataBlock;
+
+  // Index of block in the array
+  WORD m_wBlockIndex;
+
+} CWideMemoryBlockArrayEntryOb;
+
+typedef struct _CWideMemoryBlockArrayEntry * CWideMemoryBlockArrayEntry;
+
+
+// Utility structure for snapshot enumerator (parameter for 'SnapshotStart' and 'SnapshotNext'
+// methods)
+// The 'used and ready' block flags are captured 32 blocks at a time (i.e. when enumeration
+// reaches a new word of the bitmaps) and the blocks are provided by reference
+typedef struct _CWideMemoryBlockArraySnapshot
+{
+  // Index of retrieved block in the array
+  WORD m_wBlockIndex;
+
+  // Pointer to storage buffer of retrieved block in the array
+  // Note: The caller may directly read the fields it needs in the block
+  BYTE *m_pItemData;
+
+  // Private members
+  // Note: These variables are used by the enumerator methods and caller must not modify them
+
+  // Captured 'used and ready' flags of current word (bit 31 is the flag of first block)
+  DWORD m_dwFlags;
+
+  // Current word in bitmaps
+  WORD m_wWordIndex;
+
+} CWideMemoryBlockArraySnapshotOb;
+
+typedef struct _CWideMemoryBlockArraySnapshot * CWideMemoryBlockArraySnapshot;
+
+// Class constants and definitions
+
+
+// Class public methods
+
+CWideMemoryBlockArray CWideMemoryBlockArray_New(WORD wBlockSize, WORD wBlockNumber);
+CWideMemoryBlockArray CWideMemoryBlockArray_NewShared(WORD wBlockSize, WORD wBlockNumber);
+void CWideMemoryBlockArray_Delete(CWideMemoryBlockArray this);
+
+void * CWideMemoryBlockArray_GetBlock(CWideMemoryBlockArray this, CWideMemoryBlockArrayEntry pEntry);
+bool CWideMemoryBlockArray_ReleaseBlock(CWideMemoryBlockArray this, WORD wBlockIndex);
+void CWideMemoryBlockArray_AddRef(CWideMemoryBlockArray this, WORD wBlockIndex);
+bool CWideMemoryBlockArray_ReleaseRef(CWideMemoryBlockArray this, WORD wBlockIndex);
+bool CWideMemoryBlockArray_IsBlockUsed(CWideMemoryBlockArray this, WORD wBlockIndex);
+WORD CWideMemoryBlockArray_BlockIndexFromPtr(CWideMemoryBlockArray this, void *pBlockPtr);
+void * CWideMemoryBlockArray_BlockPtrFromIndex(CWideMemoryBlockArray this, WORD wBlockIndex);
+bool CWideMemoryBlockArray_IsBlockReady(CWideMemoryBlockArray this, WORD wBlockIndex);
+void CWideMemoryBlockArray_SetBlockReady(CWideMemoryBlockArray this, WORD wBlockIndex);
+bool CWideMemoryBlockArray_SnapshotStart(CWideMemoryBlockArray this, CWideMemoryBlockArraySnapshot pSnapshot);
+bool CWideMemoryBlockArray_SnapshotNext(CWideMemoryBlockArray this, CWideMemoryBlockArraySnapshot pSnapshot);
+
+
+
+
+/********************************************************************************************* 
+ SpscRing Class
+
+ Lock-free ring of fixed size slots between one producer task and one consumer task
+
+ Notes: 
+  - The slots are filled and read in place (i.e. 'GetWriteSlot' / 'CommitWrite' for producer
+    and 'GetReadSlot' / 'ReleaseRead' for consumer)
+  - The number of slots is rounded up to a power of 2 (i.e. free running 32 bits counters)
+  - The statistics counters are maintained by the producer and may be read by any task
+
+ WARNING: This object cannot be static. It MUST always be allocated by with the construction
+          method ('CSpscRing_New')
+*********************************************************************************************/
+
+// Class data
+typedef struct _CSpscRing
+{
+  // Size of a single slot 
+  WORD m_wSlotSize;
+
+  // Number of slots (power of 2)
+  WORD m_wDepth;
+
+  // Number of slots written and read since creation (slot index = counter modulo depth)
+  // Note: 'm_dwWriteCount' is only updated by producer and 'm_dwReadCount' only by consumer
+  volatile DWORD m_dwWriteCount;
+  volatile DWORD m_dwReadCount;
+
+  // Statistics
+  //  - Number of items dropped because the ring was full ('GetWriteSlot' failed)
+  //  - Maximum number of slots simultaneously used since creation
+  volatile DWORD m_dwDroppedNumber;
+  volatile WORD m_wHighWatermark;
+
+  // Memory for slots
+  // Note: Allocated within the 'CSpscRing' object
+  BYTE *m_pSlotData;
+
+} CSpscRingOb;
+
+typedef struct _CSpscRing * CSpscRing;
+
+
+// Class public methods
+
+CSpscRing CSpscRing_New(WORD wSlotSize, WORD wDepth);
+void CSpscRing_Delete(CSpscRing this);
+
+void * CSpscRing_GetWriteSlot(CSpscRing this);
+void CSpscRing_CommitWrite(CSpscRing this);
+void * CSpscRing_GetReadSlot(CSpscRing this);
+void CSpscRing_ReleaseRead(CSpscRing this);
+WORD CSpscRing_GetOccupancy(CSpscRing this);
+WORD CSpscRing_GetHighWatermark(CSpscRing this);
+DWORD CSpscRing_GetDroppedNumber(CSpscRing this);
+
+
+
+/********************************************************************************************* 
+ MpscRing Class
+
+ Lock-free bounded queue of pointers (handles) between several producer tasks and one consumer
+ task
+
+ Notes: 
+  - Each cell has a sequence number indicating whether it is free for the producer of a given
+    position or published for the consumer (i.e. producers reserve a position with a
+    'CompareExchange' on 'm_dwEnqueueCount' and never wait for each other)
+  - The number of cells is rounded up to a power of 2 (i.e. free running 32 bits counters)
+  - The consumer drains the published items in batches ('Pop' method)
+  - Backpressure: a producer finding the queue full (or checking for space with 'HasSpace')
+    arms the 'space available' callback. The callback is invoked once by the consumer task
+    when it frees cells (i.e. the producer can stop feeding the queue and resume on callback)
+
+ WARNING: This object cannot be static. It MUST always be allocated by with the construction
+          method ('CMpscRing_New')
+*********************************************************************************************/
+
+// One cell of the queue
+typedef struct _CMpscRingCell
+{
+  // Position in queue when cell is free (i.e. 'position') or published ('position + 1')
+  volatile DWORD m_dwSequence;
+
+  // Item (handle provided by producer)
+  void *m_pItem;
+
+} CMpscRingCellOb;
+
+// Class data
+typedef struct _CMpscRing
+{
+  // Number of cells (power of 2)
+  WORD m_wDepth;
+
+  // Number of positions reserved by producers and read by consumer since creation
+  // Note: 'm_dwEnqueueCount' is updated by producers with 'CompareExchange' and 'm_dwDequeueCount'
+  //       only by consumer
+  volatile DWORD m_dwEnqueueCount;
+  volatile DWORD m_dwDequeueCount;
+
+  // Backpressure
+  //  - Set by a producer when the queue was found full, cleared by the consumer when it calls
+  //    the 'space available' callback
+  //  - Callback invoked in the context of the consumer task
+  volatile DWORD m_dwProducerBlocked;
+  void (*m_pSpaceAvailable)(void *pContext);
+  void *m_pSpaceContext;
+
+  // Statistics
+  //  - Number of items rejected because the queue was full ('Push' failed)
+  //  - Number of times the queue was found full (i.e. backpressure episodes)
+  //  - Maximum number of cells simultaneously used since creation
+  volatile DWORD m_dwRejectedNumber;
+  volatile DWORD m_dwFullNumber;
+  volatile WORD m_wHighWatermark;
+
+  // Memory for cells
+  // Note: Allocated within the 'CMpscRing' object
+  CMpscRingCellOb *m_pCells;
+
+} CMpscRingOb;
+
+typedef struct _CMpscRing * CMpscRing;
+
+
+// Class public methods
+
+CMpscRing CMpscRing_New(WORD wDepth);
+void CMpscRing_Delete(CMpscRing this);
+
+void CMpscRing_SetSpaceCallback(CMpscRing this, void (*pSpaceAvailable)(void *pContext), void *pContext);
+bool CMpscRing_Push(CMpscRing this, void *pItem);
+bool CMpscRing_HasSpace(CMpscRing this);
+WORD CMpscRing_Pop(CMpscRing this, void **ppItems, WORD wMaxItems);
+WORD CMpscRing_GetOccupancy(CMpscRing this);
+WORD CMpscRing_GetHighWatermark(CMpscRing this);
+DWORD CMpscRing_GetRejectedNumber(CMpscRing this);
+DWORD CMpscRing_GetFullNumber(CMpscRing this);
 
 
 // Class private methods
 
+bool CMpscRing_SetProducerBlocked(CMpscRing this, DWORD dwPosition);
+
+
+
+/********************************************************************************************* 
+ MinHeap Class
+
+ Binary min-heap of item indexes ordered by a 64 bits key (typically a timestamp)
+
+ Notes: 
+  - The items are identified by an index in range [0, item number[ (typically the block index
+    of an item stored in a 'CWideMemoryBlockArray')
+  - The position of each item in the heap is maintained (i.e. 'Remove' and key update of a 
+    given item in O(log n))
+  - The object is not thread safe (i.e. accesses serialized by owner object)
+
+ WARNING: This object cannot be static. It MUST always be allocated by with the construction
+          method ('CMinHeap_New')
+*********************************************************************************************/
+
+// Utility structure for one entry in the heap
+typedef struct _CMinHeapEntry
+{
+  QWORD m_qwKey;
+  WORD m_wItem;
+
+} CMinHeapEntryOb;
+
+typedef struct _CMinHeapEntry * CMinHeapEntry;
+
+
+// Class data
+typedef struct _CMinHeap
+{
+  // Maximum number of items
+  WORD m_wItemNumber;
+
+  // Number of items currently in the heap
+  WORD m_wCount;
+
+  // Heap entries (entry 0 has the smallest key)
+  CMinHeapEntryOb *m_pEntries;
+
+  // Position of each item in 'm_pEntries' ('MINHEAP_NONE' if item not in the heap)
+  WORD *m_pPositions;
+
+  // Note: Here is the beginning of storage space for entries and positions (i.e. allocated 
+  //       within the 'CMinHeap' object)
+
+} CMinHeapOb;
+
+typedef struct _CMinHeap * CMinHeap;
+
+// Class constants and definitions
+#define MINHEAP_NONE      0xFFFF
+
+
+// Class public methods
+
+CMinHeap CMinHeap_New(WORD wItemNumber);
+void CMinHeap_Delete(CMinHeap this);
+
+bool CMinHeap_Insert(CMinHeap this, WORD wItem, QWORD qwKey);
+bool CMinHeap_Remove(CMinHeap this, WORD wItem);
+bool CMinHeap_Peek(CMinHeap this, WORD *pItem, QWORD *pKey);
+bool CMinHeap_Pop(CMinHeap this, WORD *pItem, QWORD *pKey);
+WORD CMinHeap_GetCount(CMinHeap this);
+bool CMinHeap_GetEntry(CMinHeap this, WORD wPosition, WORD *pItem, QWORD *pKey);
+
+
+
+
+/********************************************************************************************* 
+ HashIndex Class
+
+ Hash index of item indexes by a 32 bits key (typically a LoRa device address)
+
+ Notes: 
+  - The items are identified by an index in range [0, item number[ (typically the block index
+    of an item stored in a 'CWideMemoryBlockArray')
+  - Each bucket is a linked list of items, the number of buckets is the item number rounded up
+    to a power of 2 (i.e. average list length lower than 1)
+  - Several items may have the same key, 'Find' provides the last inserted item
+  - The object is not thread safe (i.e. accesses serialized by owner object)
+
+ WARNING: This object cannot be static. It MUST always be allocated by with the construction
+          method ('CHashIndex_New')
+*********************************************************************************************/
+
+// Class data
+typedef struct _CHashIndex
+{
+  // Maximum number of items
+  WORD m_wItemNumber;
+
+  // Number of buckets (power of 2) and number of bits of bucket index
+  WORD m_wBucketNumber;
+  BYTE m_usBucketBits;
+
+  // First item of each bucket ('HASHINDEX_NONE' for empty bucket)
+  WORD *m_pBuckets;
+
+  // Next item in bucket of each item ('HASHINDEX_NONE' for last item)
+  WORD *m_pNextItems;
+
+  // Key of each item
+  DWORD *m_pKeys;
+
+  // Note: Here is the beginning of storage space for buckets, item links and keys (i.e. 
+  //       allocated within the 'CHashIndex' object)
+
+} CHashIndexOb;
+
+typedef struct _CHashIndex * CHashIndex;
+
+// Class constants and definitions
+#define HASHINDEX_NONE      0xFFFF
+
+
+// Class public methods
+
+CHashIndex CHashIndex_New(WORD wItemNumber);
+void CHashIndex_Delete(CHashIndex this);
+
+bool CHashIndex_Insert(CHashIndex this, WORD wItem, DWORD dwKey);
+bool CHashIndex_Remove(CHashIndex this, WORD wItem);
+WORD CHashIndex_Find(CHashIndex this, DWORD dwKey);
+
+
 
 
 /********************************************************************************************* 
@@ -163,5 +612,131 @@ WORD Base64_B64ToBin(const BYTE * in, WORD size, BYTE * out, WORD max_len);
 
 
 
+/********************************************************************************************* 
+ JsonWriter Class
+
+ Bounded writer used to emit JSON streams directly in a buffer owned by the caller.
+ The values are formatted with integer arithmetic (i.e. no 'sprintf', no temporary buffer and 
+ no dynamic allocation).
+ The writer never writes beyond the end of buffer. When a value does not fit in buffer, the
+ writer enters the 'overflow' state and ignores next write operations (i.e. the caller checks
+ the result only once with the 'End' method).
+
+ Note: The 'CJsonWriterOb' object is typically allocated on the stack of caller function
+*********************************************************************************************/
+
+// Class data
+typedef struct _CJsonWriter
+{
+  // Next byte to write in buffer
+  BYTE *m_pStreamHead;
+
+  // End of buffer (i.e. pointer to 'last byte + 1')
+  BYTE *m_pStreamEnd;
+
+  // Last write operation exceeded buffer capacity
+  bool m_bOverflow;
+
+} CJsonWriterOb;
+
+typedef struct _CJsonWriter * CJsonWriter;
+
+// Class constants and definitions
+
+// Writes a string literal (i.e. length known at compilation time)
+#define JSONWRITER_WRITE_LITERAL(pWriter, szLiteral)  CJsonWriter_WriteBytes(pWriter, (const BYTE *) szLiteral, sizeof(szLiteral) - 1)
+
+// Class public methods
+
+void CJsonWriter_Initialize(CJsonWriter this, BYTE *pStreamData, BYTE *pStreamEnd);
+BYTE * CJsonWriter_End(CJsonWriter this);
+
+void CJsonWriter_WriteByte(CJsonWriter this, BYTE usValue);
+void CJsonWriter_WriteBytes(CJsonWriter this, const BYTE *pData, WORD wLength);
+void CJsonWriter_WriteString(CJsonWriter this, const BYTE *szString);
+void CJsonWriter_WriteUnsigned(CJsonWriter this, DWORD dwValue);
+void CJsonWriter_WriteDigits(CJsonWriter this, DWORD dwValue, BYTE usDigitNumber);
+void CJsonWriter_WriteFixed(CJsonWriter this, DWORD dwValue, BYTE usDecimalNumber);
+void CJsonWriter_WriteBase64(CJsonWriter this, const BYTE *pData, WORD wSize);
+
+
+
+/********************************************************************************************* 
+ JsonReader Class
+
+ Zero-copy tokenizer used to read JSON streams received in a buffer owned by the caller.
+ The reader enumerates the members of one object without building any tree: the name and
+ the value of each member are returned as tokens pointing into the original stream (i.e. no
+ copy, no dynamic allocation). Nested objects and arrays are returned as one token, the
+ caller can read their content with a new reader initialized on this token.
+ The value of a token is converted only when required by the caller ('CJsonToken_Getxxx'
+ functions).
+
+ Note: The 'CJsonReaderOb' and 'CJsonTokenOb' objects are typically allocated on the stack 
+       of caller function
+ Note: Escape sequences in strings are not decoded (i.e. the string token is the raw content
+       between quotes)
+*********************************************************************************************/
+
+// Class data
+typedef struct _CJsonReader
+{
+  // Next byte to read in stream
+  const BYTE *m_pStreamHead;
+
+  // End of stream (i.e. pointer to 'last byte + 1')
+  const BYTE *m_pStreamEnd;
+
+  // Syntax error found in stream (or stream truncated)
+  bool m_bError;
+
+} CJsonReaderOb;
+
+typedef struct _CJsonReader * CJsonReader;
+
+// Token (i.e. part of stream containing one JSON name or value)
+typedef struct _CJsonToken
+{
+  // Type of value
+  BYTE m_usType;
+
+  // Token content in stream
+  // Note: For strings the quotes are excluded, for objects and arrays the brackets are included
+  const BYTE *m_pData;
+  WORD m_wLength;
+
+} CJsonTokenOb;
+
+typedef struct _CJsonToken * CJsonToken;
+
+// Class constants and definitions
+
+// Token types
+#define JSONREADER_TOKEN_STRING       0x01
+#define JSONREADER_TOKEN_NUMBER       0x02
+#define JSONREADER_TOKEN_LITERAL      0x03    // 'true', 'false' or 'null'
+#define JSONREADER_TOKEN_OBJECT       0x04
+#define JSONREADER_TOKEN_ARRAY        0x05
+
+// Maximum depth of nested objects and arrays in skipped values
+#define JSONREADER_MAX_DEPTH          16
+
+// Compares a token with a string literal (i.e. length known at compilation time)
+#define JSONREADER_TOKEN_EQUALS(pToken, szLiteral)  (((pToken)->m_wLength == sizeof(szLiteral) - 1) && \
+                                                     (memcmp((pToken)->m_pData, szLiteral, sizeof(szLiteral) - 1) == 0))
+
+// Class public methods
+
+bool CJsonReader_Initialize(CJsonReader this, const BYTE *pStreamData, const BYTE *pStreamEnd);
+bool CJsonReader_InitializeFromToken(CJsonReader this, CJsonToken pObjectToken);
+bool CJsonReader_NextMember(CJsonReader this, CJsonToken pName, CJsonToken pValue);
+
+bool CJsonToken_GetBool(CJsonToken this, bool *pbValue);
+bool CJsonToken_GetUnsigned(CJsonToken this, DWORD *pdwValue);
+bool CJsonToken_GetFixed(CJsonToken this, BYTE usDecimalNumber, DWORD *pdwValue);
+WORD CJsonToken_GetBase64(CJsonToken this, BYTE *pData, WORD wMaxLength);
+
+
+
 #endif
 
@@ -0,0 +1,113 @@
+/*****************************************************************************************//**
+ * @file     HostTest.c
+ *
+ * @author   F.Fargon
+ *
+ * @version  V1.0
+ *
+ * @date     16/10/2026
+ *
+ * @brief    Helpers for host tests and benchmarks.
+ *
+ * @details  This file implements the execution of a test function in an RTOS task and the
+ *           check of test conditions (see HostTest.h).
+*********************************************************************************************/
+
+#include <Common.h>
+
+#include "HostTest.h"
+
+
+/*********************************************************************************************
+  Instantiate global static objects used by module implementation
+*********************************************************************************************/
+
+static const char *g_pszHostTestName = NULL;
+static void (*g_pHostTestFunction)(void) = NULL;
+
+static DWORD g_dwHostTestCheckNumber = 0;
+static DWORD g_dwHostTestFailureNumber = 0;
+
+static void HostTest_Task(void *pParams);
+
+
+/*****************************************************************************************//**
+ * @fn         int HostTest_Run(const char *pszName, void (*pTestFunction)(void))
+ *
+ * @brief      Executes a test function in an RTOS task.
+ *
+ * @details    The function creates the test task and starts the RTOS scheduler. The process
+ *             exits when the test function returns.
+ *
+ * @param      pszName
+ *             The name of the test (traces).
+ *
+ * @param      pTestFunction
+ *             The test function.
+ *
+ * @return     The function returns 1 if the test task cannot be created. Otherwise, it never
+ *             returns (i.e. exit code is 0 if all checks succeeded, 1 if not).
+*********************************************************************************************/
+int HostTest_Run(const char *pszName, void (*pTestFunction)(void))
+{
+  g_pszHostTestName = pszName;
+  g_pHostTestFunction = pTestFunction;
+
+  if (xTaskCreate(HostTest_Task, "HostTest", HOSTTEST_TASK_STACK_SIZE, NULL, HOSTTEST_TASK_PRIORITY, NULL) != pdPASS)
+  {
+    printf("[ERROR] %s: failed to create test task\n", pszName);
+    return 1;
+  }
+
+  vTaskStartScheduler();
+  return 1;
+}
+
+
+/*****************************************************************************************//**
+ * @fn         bool HostTest_Check(bool bCondition, const char *pszCondition, const char *pszFile,
+ *                                 int nLine)
+ *
+ * @brief      Checks a test condition.
+ *
+ * @details    A failed condition is traced and counted (see 'HOSTTEST_CHECK').
+ *
+ * @return     The function returns the value of the condition.
+*********************************************************************************************/
+bool HostTest_Check(bool bCondition, const char *pszCondition, const char *pszFile, int nLine)
+{
+  __atomic_add_fetch(&g_dwHostTestCheckNumber, 1, __ATOMIC_RELAXED);
+
+  if (!bCondition)
+  {
+    __atomic_add_fetch(&g_dwHostTestFailureNumber, 1, __ATOMIC_RELAXED);
+    printf("[FAILED] %s:%d: %s\n", pszFile, nLine, pszCondition);
+  }
+  return bCondition;
+}
+
+
+// Fills a buffer with pseudo-random bytes (reproducible sequence for a given seed)
+void HostTest_FillRandom(BYTE *pBuffer, WORD wLength, DWORD *pdwSeed)
+{
+  for (WORD i = 0; i < wLength; i++)
+  {
+    *pdwSeed = (*pdwSeed * 1103515245) + 12345;
+    pBuffer[i] = (BYTE) (*pdwSeed >> 16);
+  }
+}
+
+
+// Task executing the test function
+static void HostTest_Task(void *pParams)
+{
+  printf("[INFO] %s: started\n", g_pszHostTestName);
+
+  g_pHostTestFunction();
+
+  printf("[%s] %s: %u checks, %u failed\n", (g_dwHostTestFailureNumber == 0) ? "PASSED" : "FAILED",
+         g_pszHostTestName, (unsigned int) g_dwHostTestCheckNumber, (unsigned int) g_dwHostTestFailureNumber);
+  fflush(stdout);
+
+  exit((g_dwHostTestFailureNumber == 0) ? 0 : 1);
+}
@@ -0,0 +1,47 @@
+/*********************************************************************************************
+PROJECT : LoRaWAN ESP32 Gateway V1.x
+
+FILE    : HostTest.h
+
+AUTHOR  : F.Fargon
+
+PURPOSE : Helpers for host tests and benchmarks (Linux host build, FreeRTOS POSIX port).
+
+COMMENTS: A harness defines its test function and calls 'HostTest_Run' from 'main':
+           - The test function is executed by an RTOS task (i.e. gateway objects used from a
+             task, as on ESP32)
+           - Each condition is checked with 'HOSTTEST_CHECK' (failure traced with location)
+           - The process exit code is 0 if all checks succeeded
+*********************************************************************************************/
+
+#ifndef HOSTTEST_H_
+#define HOSTTEST_H_
+
+#include <Common.h>
+
+
+/*********************************************************************************************
+  Definitions
+*********************************************************************************************/
+
+// Priority of task executing the test function (i.e. below tasks of radio path)
+#define HOSTTEST_TASK_PRIORITY       5
+
+// Stack of task executing the test function (words)
+#define HOSTTEST_TASK_STACK_SIZE     (configMINIMAL_STACK_SIZE * 4)
+
+// Checks a condition (the test continues on failure)
+#define HOSTTEST_CHECK(bCondition)   HostTest_Check((bCondition), #bCondition, __FILE__, __LINE__)
+
+
+/*********************************************************************************************
+  Functions
+*********************************************************************************************/
+
+int HostTest_Run(const char *pszName, void (*pTestFunction)(void));
+bool HostTest_Check(bool bCondition, const char *pszCondition, const char *pszFile, int nLine);
+
+void HostTest_FillRandom(BYTE *pBuffer, WORD wLength, DWORD *pdwSeed);
+
+
+#endif
@@ -0,0 +1,608 @@
+/*****************************************************************************************//**
+ * @file     test_lora_dutycycle.c
+ *
+ * @author   F.Fargon
+ *
+ * @version  V1.0
+ *
+ * @date     16/10/2026
+ *
+ * @brief    Time-on-air, duty-cycle ledger and RX window selection for downlinks.
+ *
+ * @details  The test checks the 'CLoraDutyCycle' class and its use by
+ *           'CLoraRealtimeSender_ScheduleSendNodePacket':\n
+ *            - Time-on-air of a table of radio settings (values of SX1276 datasheet formula)
+ *              and of all SF, BW and CR against the floating point formula
+ *            - Sliding window of the sub-band ledger (limits of observation period, budget
+ *              exhausted, transmissions older than the window)
+ *            - Selection of RX1 or RX2 window and rejection codes of Semtech TX_ACK
+ *              ('TOO_LATE', 'COLLISION_PACKET', 'TX_FREQ')
+ *            - Benchmark of scheduling decisions per second ('CheckTransmission' with packets
+ *              waiting in the realtime queue)
+*********************************************************************************************/
+
+#include <Common.h>
+
+#define TRANSCEIVERMANAGERITF_IMPL
+
+#include "LoraTransceiverItf.h"
+#include "TransceiverManagerItf.h"
+#include "LoraRealtimeSenderItf.h"
+#include "Configuration.h"
+#include "LoraRealtimeSender.h"
+
+#include "HostTest.h"
+
+
+/*********************************************************************************************
+  Definitions
+*********************************************************************************************/
+
+// Number of scheduling decisions for benchmark
+#define TEST_BENCH_DECISIONS     1000000
+
+// Packets waiting in realtime queue for benchmark
+#define TEST_BENCH_QUEUED        10
+
+// Time-on-air of SX1276 datasheet formula (section 4.1.1.7) for a table of radio settings
+typedef struct _TestTimeOnAir
+{
+  BYTE m_usSpreadingFactor;
+  BYTE m_usBandwidth;
+  BYTE m_usCodingRate;
+  WORD m_wPreambleLength;
+  bool m_bHeader;
+  bool m_bCRC;
+  DWORD m_dwPayloadLength;
+  DWORD m_dwTimeOnAir;
+} TestTimeOnAirOb;
+
+static const TestTimeOnAirOb g_TestTimeOnAirTable[] =
+{
+  { LORATRANSCEIVERITF_SF_7,  LORATRANSCEIVERITF_BANDWIDTH_125, LORATRANSCEIVERITF_CR_5, 8,  true,  true,  13,  46336 },
+  { LORATRANSCEIVERITF_SF_12, LORATRANSCEIVERITF_BANDWIDTH_125, LORATRANSCEIVERITF_CR_5, 8,  true,  true,  51,  2465792 },
+  { LORATRANSCEIVERITF_SF_9,  LORATRANSCEIVERITF_BANDWIDTH_125, LORATRANSCEIVERITF_CR_5, 8,  true,  true,  0,   103424 },
+  { LORATRANSCEIVERITF_SF_6,  LORATRANSCEIVERITF_BANDWIDTH_500, LORATRANSCEIVERITF_CR_8, 6,  false, false, 1,   2336 },
+  { LORATRANSCEIVERITF_SF_11, LORATRANSCEIVERITF_BANDWIDTH_125, LORATRANSCEIVERITF_CR_5, 8,  true,  true,  20,  741376 },
+  { LORATRANSCEIVERITF_SF_10, LORATRANSCEIVERITF_BANDWIDTH_250, LORATRANSCEIVERITF_CR_6, 8,  true,  true,  255, 1360896 },
+  { LORATRANSCEIVERITF_SF_12, LORATRANSCEIVERITF_BANDWIDTH_7_8, LORATRANSCEIVERITF_CR_8, 8,  true,  true,  255, 224526336 },
+  { LORATRANSCEIVERITF_SF_8,  LORATRANSCEIVERITF_BANDWIDTH_125, LORATRANSCEIVERITF_CR_7, 12, true,  false, 64,  279040 },
+
+  // Invalid radio settings
+  { LORATRANSCEIVERITF_SF_NONE, LORATRANSCEIVERITF_BANDWIDTH_125, LORATRANSCEIVERITF_CR_5, 8, true, true, 13, 0 },
+  { LORATRANSCEIVERITF_SF_7, LORATRANSCEIVERITF_BANDWIDTH_125, LORATRANSCEIVERITF_CR_NONE, 8, true, true, 13, 0 },
+};
+#define TEST_TIMEONAIR_NUMBER    (sizeof(g_TestTimeOnAirTable) / sizeof(g_TestTimeOnAirTable[0]))
+
+// Bandwidth of each 'LORATRANSCEIVERITF_BANDWIDTH_xxx' (Hz)
+static const double g_dTestBandwidths[LORATRANSCEIVERITF_BANDWIDTH_500 + 1] =
+  { 7812.5, 125000.0 / 12, 15625.0, 125000.0 / 6, 31250.0, 125000.0 / 3, 62500.0, 125000.0, 250000.0, 500000.0 };
+
+// Frequency channel outside of EU868 sub-bands
+#define TEST_FREQUENCY_UNKNOWN   0xFE
+
+
+/*********************************************************************************************
+  Helpers
+*********************************************************************************************/
+
+// Session events of 'LoraRealtimeSender' (no 'LoraNodeManager')
+static DWORD g_dwTestSessionEventNumber = 0;
+
+static bool Test_SessionEvent(void *pOwnerObject, void *pEvent)
+{
+  (void) pOwnerObject;
+  (void) pEvent;
+  ++g_dwTestSessionEventNumber;
+  return true;
+}
+
+static struct _CTransceiverManagerItfImpl g_TestTransceiverManagerItfImplOb = { .m_pSessionEvent = Test_SessionEvent };
+
+
+// Time-on-air computed with the floating point formula (microseconds)
+static double Test_ReferenceTimeOnAir(const TestTimeOnAirOb *pRow)
+{
+  double dSymbolTime;
+  double dPayloadSymbols;
+  int nLowDataRate;
+  int nNumerator;
+
+  dSymbolTime = ((double) (1 << pRow->m_usSpreadingFactor) * 1000000.0) / g_dTestBandwidths[pRow->m_usBandwidth];
+  nLowDataRate = dSymbolTime >= 16000.0 ? 1 : 0;
+  nNumerator = (int) (8 * pRow->m_dwPayloadLength) - (4 * pRow->m_usSpreadingFactor) + 28 + (pRow->m_bCRC ? 16 : 0) -
+               (pRow->m_bHeader ? 0 : 20);
+  dPayloadSymbols = 8 + fmax(ceil((double) nNumerator / (4 * (pRow->m_usSpreadingFactor - 2 * nLowDataRate))) *
+                             (pRow->m_usCodingRate + 4), 0);
+
+  return (pRow->m_wPreambleLength + 4.25) * dSymbolTime + dPayloadSymbols * dSymbolTime;
+}
+
+
+// Registers the RX windows of a node for an uplink received at 'qwRXTimestamp'
+// Note: The RX2 window uses SF12 (i.e. LoRaWAN EU868 default)
+static void Test_RegisterRxWindows(CLoraRealtimeSender *pSender, DWORD dwDeviceAddr, bool bJoinRequest, ILoraTransceiver pTransceiver,
+                                   QWORD qwRXTimestamp, BYTE usRX1FreqChannel, BYTE usRX1SpreadingFactor, BYTE usRX2FreqChannel)
+{
+  CLoraRealtimeSenderItf_RegisterNodeRxWindowsParamsOb Params;
+
+  Params.m_usDeviceClass = LORAREALTIMESENDER_DEVICECLASS_A;
+  Params.m_dwDeviceAddr = dwDeviceAddr;
+  Params.m_bJoinRequest = bJoinRequest;
+  Params.m_pLoraTransceiverItf = pTransceiver;
+  Params.m_qwRXTimestamp = qwRXTimestamp;
+  for (BYTE i = 0; i < LORAREALTIMESENDER_RXWINDOW_NUMBER; i++)
+  {
+    Params.m_RxRadio[i].m_usFreqChannel = i == LORAREALTIMESENDER_RXWINDOW_RX1 ? usRX1FreqChannel : usRX2FreqChannel;
+    Params.m_RxRadio[i].m_usSpreadingFactor = i == LORAREALTIMESENDER_RXWINDOW_RX1 ? usRX1SpreadingFactor : LORATRANSCEIVERITF_SF_12;
+    Params.m_RxRadio[i].m_usBandwidth = LORATRANSCEIVERITF_BANDWIDTH_125;
+    Params.m_RxRadio[i].m_usCodingRate = LORATRANSCEIVERITF_CR_5;
+    Params.m_RxRadio[i].m_wPreambleLength = 8;
+    Params.m_RxRadio[i].m_usHeader = LORATRANSCEIVERITF_HEADER_ON;
+    Params.m_RxRadio[i].m_usCRC = LORATRANSCEIVERITF_CRC_ON;
+    Params.m_RxRadio[i].m_usPowerLevel = LORATRANSCEIVERITF_POWER_LEVEL_NONE;
+  }
+
+  HOSTTEST_CHECK(CLoraRealtimeSender_RegisterNodeRxWindows(pSender, &Params) == true);
+}
+
+
+// Registers the RX windows of a data uplink (i.e. indexed by device address)
+static void Test_RegisterNode(CLoraRealtimeSender *pSender, DWORD dwDeviceAddr, ILoraTransceiver pTransceiver,
+                              QWORD qwRXTimestamp, BYTE usRX1FreqChannel, BYTE usRX1SpreadingFactor, BYTE usRX2FreqChannel)
+{
+  Test_RegisterRxWindows(pSender, dwDeviceAddr, false, pTransceiver, qwRXTimestamp, usRX1FreqChannel, usRX1SpreadingFactor,
+                         usRX2FreqChannel);
+}
+
+
+// Schedules a downlink packet for a node (session identifier = device address)
+static DWORD Test_ScheduleSend(CLoraRealtimeSender *pSender, DWORD dwDeviceAddr, CLoraTransceiverItf_LoraPacket pPacket)
+{
+  CLoraRealtimeSenderItf_ScheduleSendNodePacketParamsOb Params;
+
+  memset(&Params, 0, sizeof(Params));
+  Params.m_dwDeviceAddr = dwDeviceAddr;
+  Params.m_dwDownlinkSessionId = dwDeviceAddr;
+  Params.m_pPacketToSend = pPacket;
+  return CLoraRealtimeSender_ScheduleSendNodePacket(pSender, &Params);
+}
+
+
+// Schedules a downlink packet at the time and with the radio settings requested by Network Server
+// Note: For a 'Join Accept', the device address is only used as session identifier
+static DWORD Test_ScheduleServerSend(CLoraRealtimeSender *pSender, DWORD dwDeviceAddr, bool bJoinAccept, DWORD dwSendTimestamp,
+                                     CLoraRealtimeSenderItf_RadioParams pServerRadio, CLoraTransceiverItf_LoraPacket pPacket)
+{
+  CLoraRealtimeSenderItf_ScheduleSendNodePacketParamsOb Params;
+
+  memset(&Params, 0, sizeof(Params));
+  Params.m_dwDeviceAddr = bJoinAccept == true ? 0 : dwDeviceAddr;
+  Params.m_dwDownlinkSessionId = dwDeviceAddr;
+  Params.m_pPacketToSend = pPacket;
+  Params.m_bServerTiming = true;
+  Params.m_dwSendTimestamp = dwSendTimestamp;
+  Params.m_ServerRadio = *pServerRadio;
+  Params.m_bJoinAccept = bJoinAccept;
+  return CLoraRealtimeSender_ScheduleSendNodePacket(pSender, &Params);
+}
+
+
+// Returns the packet scheduled for a node in the realtime queue (NULL if not found)
+static CRealtimeLoraPacket Test_FindScheduledPacket(CLoraRealtimeSender *pSender, DWORD dwDeviceAddr)
+{
+  CRealtimeLoraPacket pRealtimeLoraPacket;
+  WORD wEntryIndex;
+  QWORD qwSendTimestamp;
+
+  for (WORD i = 0; CMinHeap_GetEntry(pSender->m_pRealtimeLoraPacketHeap, i, &wEntryIndex, &qwSendTimestamp) == true; i++)
+  {
+    pRealtimeLoraPacket = (CRealtimeLoraPacket) CWideMemoryBlockArray_BlockPtrFromIndex(pSender->m_pRealtimeLoraPacketArray, wEntryIndex);
+    if (pRealtimeLoraPacket->m_dwDownlinkSessionId == dwDeviceAddr)
+    {
+      return pRealtimeLoraPacket;
+    }
+  }
+  return NULL;
+}
+
+
+/*********************************************************************************************
+  Tests
+*********************************************************************************************/
+
+static void Test_TimeOnAir(void)
+{
+  TestTimeOnAirOb Row;
+  DWORD dwTimeOnAir;
+  DWORD dwMismatchNumber = 0;
+  static const DWORD dwLengths[] = { 0, 1, 13, 51, 115, 222, 255 };
+
+  for (BYTE i = 0; i < TEST_TIMEONAIR_NUMBER; i++)
+  {
+    const TestTimeOnAirOb *pRow = &(g_TestTimeOnAirTable[i]);
+
+    dwTimeOnAir = CLoraDutyCycle_GetTimeOnAir(pRow->m_usSpreadingFactor, pRow->m_usBandwidth, pRow->m_usCodingRate,
+                                              pRow->m_wPreambleLength, pRow->m_bHeader, pRow->m_bCRC, pRow->m_dwPayloadLength);
+    if (!HOSTTEST_CHECK(dwTimeOnAir == pRow->m_dwTimeOnAir))
+    {
+      printf("[INFO] Row %u: time-on-air = %u us, expected = %u us\n", i, (unsigned int) dwTimeOnAir,
+             (unsigned int) pRow->m_dwTimeOnAir);
+    }
+  }
+
+  // All radio settings against floating point formula
+  // Note: The symbol times are exact in microseconds (i.e. only rounding of result)
+  Row.m_wPreambleLength = 8;
+  for (Row.m_usSpreadingFactor = LORATRANSCEIVERITF_SF_6; Row.m_usSpreadingFactor <= LORATRANSCEIVERITF_SF_12; Row.m_usSpreadingFactor++)
+  {
+    for (Row.m_usBandwidth = LORATRANSCEIVERITF_BANDWIDTH_7_8; Row.m_usBandwidth <= LORATRANSCEIVERITF_BANDWIDTH_500; Row.m_usBandwidth++)
+    {
+      for (Row.m_usCodingRate = LORATRANSCEIVERITF_CR_5; Row.m_usCodingRate <= LORATRANSCEIVERITF_CR_8; Row.m_usCodingRate++)
+      {
+        for (BYTE j = 0; j < sizeof(dwLengths) / sizeof(dwLengths[0]); j++)
+        {
+          Row.m_dwPayloadLength = dwLengths[j];
+          Row.m_bHeader = (j & 0x01) == 0;
+          Row.m_bCRC = (j & 0x02) == 0;
+          dwTimeOnAir = CLoraDutyCycle_GetTimeOnAir(Row.m_usSpreadingFactor, Row.m_usBandwidth, Row.m_usCodingRate,
+                                                    Row.m_wPreambleLength, Row.m_bHeader, Row.m_bCRC, Row.m_dwPayloadLength);
+          if (fabs((double) dwTimeOnAir - Test_ReferenceTimeOnAir(&Row)) >= 1.0)
+          {
+            ++dwMismatchNumber;
+          }
+        }
+      }
+    }
+  }
+  HOSTTEST_CHECK(dwMismatchNumber == 0);
+}
+
+
+static void Test_Ledger(void)
+{
+  CLoraDutyCycle pDutyCycle;
+  QWORD qwStart;
+  QWORD qwBucketStart;
+
+  HOSTTEST_CHECK((pDutyCycle = CLoraDutyCycle_New()) != NULL);
+  if (pDutyCycle == NULL)
+  {
+    return;
+  }
+
+  // Sub-band g2 (0.1% = 3.6 seconds per hour)
+  qwStart = (QWORD) 10 * LORADUTYCYCLE_BUCKET_TIME + 1234;
+  qwBucketStart = (qwStart / LORADUTYCYCLE_BUCKET_TIME) * LORADUTYCYCLE_BUCKET_TIME;
+
+  for (BYTE i = 0; i < 3; i++)
+  {
+    HOSTTEST_CHECK(CLoraDutyCycle_Check(pDutyCycle, LORADUTYCYCLE_SUBBAND_G2, qwStart + i * 1000000, 1000000) == true);
+    CLoraDutyCycle_Reserve(pDutyCycle, LORADUTYCYCLE_SUBBAND_G2, qwStart + i * 1000000, 1000000);
+  }
+  HOSTTEST_CHECK(CLoraDutyCycle_GetWindowAirtime(pDutyCycle, LORADUTYCYCLE_SUBBAND_G2) == 3000000);
+
+  // Budget exhausted (other sub-bands not affected)
+  HOSTTEST_CHECK(CLoraDutyCycle_Check(pDutyCycle, LORADUTYCYCLE_SUBBAND_G2, qwStart + 5000000, 600000) == true);
+  HOSTTEST_CHECK(CLoraDutyCycle_Check(pDutyCycle, LORADUTYCYCLE_SUBBAND_G2, qwStart + 5000000, 600001) == false);
+  HOSTTEST_CHECK(CLoraDutyCycle_GetRejectedNumber(pDutyCycle) == 1);
+  HOSTTEST_CHECK(CLoraDutyCycle_Check(pDutyCycle, LORADUTYCYCLE_SUBBAND_G1, qwStart + 5000000, 600001) == true);
+  HOSTTEST_CHECK(CLoraDutyCycle_Check(pDutyCycle, LORADUTYCYCLE_SUBBAND_NONE, qwStart, 1) == false);
+
+  // The transmissions are counted until the end of the observation period
+  // Note: The transmission time is counted in the bucket of its start time (i.e. the window
+  //       includes the current bucket and the 60 previous buckets)
+  HOSTTEST_CHECK(CLoraDutyCycle_Check(pDutyCycle, LORADUTYCYCLE_SUBBAND_G2,
+                                      qwBucketStart + (QWORD) (LORADUTYCYCLE_BUCKET_NUMBER - 1) * LORADUTYCYCLE_BUCKET_TIME, 1000000) == false);
+  HOSTTEST_CHECK(CLoraDutyCycle_GetWindowAirtime(pDutyCycle, LORADUTYCYCLE_SUBBAND_G2) == 3000000);
+
+  // Transmission older than the window ignored, transmission in the window counted (i.e. not in
+  // ascending order)
+  CLoraDutyCycle_Reserve(pDutyCycle, LORADUTYCYCLE_SUBBAND_G2, qwStart - LORADUTYCYCLE_BUCKET_TIME, 500000);
+  HOSTTEST_CHECK(CLoraDutyCycle_GetWindowAirtime(pDutyCycle, LORADUTYCYCLE_SUBBAND_G2) == 3000000);
+  CLoraDutyCycle_Reserve(pDutyCycle, LORADUTYCYCLE_SUBBAND_G2, qwStart + LORADUTYCYCLE_BUCKET_TIME, 500000);
+  HOSTTEST_CHECK(CLoraDutyCycle_GetWindowAirtime(pDutyCycle, LORADUTYCYCLE_SUBBAND_G2) == 3500000);
+
+  // First transmissions leave the window
+  HOSTTEST_CHECK(CLoraDutyCycle_Check(pDutyCycle, LORADUTYCYCLE_SUBBAND_G2,
+                                      qwBucketStart + (QWORD) LORADUTYCYCLE_BUCKET_NUMBER * LORADUTYCYCLE_BUCKET_TIME, 3000000) == true);
+  HOSTTEST_CHECK(CLoraDutyCycle_GetWindowAirtime(pDutyCycle, LORADUTYCYCLE_SUBBAND_G2) == 500000);
+
+  // No transmission in the new window
+  HOSTTEST_CHECK(CLoraDutyCycle_Check(pDutyCycle, LORADUTYCYCLE_SUBBAND_G2, qwStart + (QWORD) 1000 * LORADUTYCYCLE_BUCKET_TIME, 3600000) == true);
+  HOSTTEST_CHECK(CLoraDutyCycle_GetWindowAirtime(pDutyCycle, LORADUTYCYCLE_SUBBAND_G2) == 0);
+
+  CLoraDutyCycle_Delete(pDutyCycle);
+}
+
+
+static void Test_Schedule(CLoraRealtimeSender *pSender, CLoraTransceiverItf_LoraPacket pPacket)
+{
+  CRealtimeLoraPacket pScheduled;
+  QWORD qwNow;
+  DWORD dwRX1Airtime;
+  DWORD dwRX2Airtime;
+  DWORD dwG3Airtime;
+  BYTE usTransceiver[4];
+
+  // Transceiver interfaces are only compared by 'LoraRealtimeSender' (i.e. never invoked here)
+  #define TEST_TRANSCEIVER(i)  ((ILoraTransceiver) &(usTransceiver[i]))
+
+  pPacket->m_dwDataSize = 20;
+  dwRX1Airtime = CLoraDutyCycle_GetTimeOnAir(LORATRANSCEIVERITF_SF_7, LORATRANSCEIVERITF_BANDWIDTH_125, LORATRANSCEIVERITF_CR_5,
+                                             8, true, true, pPacket->m_dwDataSize);
+  dwRX2Airtime = CLoraDutyCycle_GetTimeOnAir(LORATRANSCEIVERITF_SF_12, LORATRANSCEIVERITF_BANDWIDTH_125, LORATRANSCEIVERITF_CR_5,
+                                             8, true, true, pPacket->m_dwDataSize);
+  qwNow = GATEWAY_CLOCK_MICROSEC();
+
+  // RX1 window free
+  Test_RegisterNode(pSender, 0x1001, TEST_TRANSCEIVER(0), qwNow, LORATRANSCEIVERITF_FREQUENCY_CHANNEL_00, LORATRANSCEIVERITF_SF_7,
+                    LORATRANSCEIVERITF_FREQUENCY_RX2);
+  HOSTTEST_CHECK(Test_ScheduleSend(pSender, 0x1001, pPacket) == LORAREALTIMESENDER_SCHEDULESEND_NONE);
+  HOSTTEST_CHECK(((pScheduled = Test_FindScheduledPacket(pSender, 0x1001)) != NULL) &&
+                 (pScheduled->m_usRxWindow == LORAREALTIMESENDER_RXWINDOW_RX1) &&
+                 (pScheduled->m_qwSendTimestamp == qwNow + LORAREALTIMESENDER_CLASSA_RECEIVE_DELAY1) &&
+                 (pScheduled->m_qwEndTimestamp == pScheduled->m_qwSendTimestamp + dwRX1Airtime));
+  HOSTTEST_CHECK(CLoraDutyCycle_GetWindowAirtime(pSender->m_pDutyCycle, LORADUTYCYCLE_SUBBAND_G1) == dwRX1Airtime);
+
+  // RX1 window used by previous packet on the same transceiver, RX2 window used
+  Test_RegisterNode(pSender, 0x1002, TEST_TRANSCEIVER(0), qwNow, LORATRANSCEIVERITF_FREQUENCY_CHANNEL_00, LORATRANSCEIVERITF_SF_7,
+                    LORATRANSCEIVERITF_FREQUENCY_RX2);
+  HOSTTEST_CHECK(Test_ScheduleSend(pSender, 0x1002, pPacket) == LORAREALTIMESENDER_SCHEDULESEND_NONE);
+  HOSTTEST_CHECK(((pScheduled = Test_FindScheduledPacket(pSender, 0x1002)) != NULL) &&
+                 (pScheduled->m_usRxWindow == LORAREALTIMESENDER_RXWINDOW_RX2) &&
+                 (pScheduled->m_qwSendTimestamp == qwNow + LORAREALTIMESENDER_CLASSA_RECEIVE_DELAY2));
+  HOSTTEST_CHECK(CLoraDutyCycle_GetWindowAirtime(pSender->m_pDutyCycle, LORADUTYCYCLE_SUBBAND_G3) == dwRX2Airtime);
+
+  // Both windows used on the same transceiver
+  Test_RegisterNode(pSender, 0x1003, TEST_TRANSCEIVER(0), qwNow, LORATRANSCEIVERITF_FREQUENCY_CHANNEL_00, LORATRANSCEIVERITF_SF_7,
+                    LORATRANSCEIVERITF_FREQUENCY_RX2);
+  HOSTTEST_CHECK(Test_ScheduleSend(pSender, 0x1003, pPacket) == LORAREALTIMESENDER_SCHEDULESEND_COLLISION_PACKET);
+  HOSTTEST_CHECK(Test_FindScheduledPacket(pSender, 0x1003) == NULL);
+
+  // Same windows free on another transceiver
+  Test_RegisterNode(pSender, 0x1004, TEST_TRANSCEIVER(1), qwNow, LORATRANSCEIVERITF_FREQUENCY_CHANNEL_00, LORATRANSCEIVERITF_SF_7,
+                    LORATRANSCEIVERITF_FREQUENCY_RX2);
+  HOSTTEST_CHECK(Test_ScheduleSend(pSender, 0x1004, pPacket) == LORAREALTIMESENDER_SCHEDULESEND_NONE);
+  HOSTTEST_CHECK(((pScheduled = Test_FindScheduledPacket(pSender, 0x1004)) != NULL) &&
+                 (pScheduled->m_usRxWindow == LORAREALTIMESENDER_RXWINDOW_RX1));
+
+  // RX1 window too late, RX2 window used
+  Test_RegisterNode(pSender, 0x1005, TEST_TRANSCEIVER(2), qwNow - GATEWAY_CLOCK_MS_TO_US(1500),
+                    LORATRANSCEIVERITF_FREQUENCY_CHANNEL_00, LORATRANSCEIVERITF_SF_7, LORATRANSCEIVERITF_FREQUENCY_RX2);
+  HOSTTEST_CHECK(Test_ScheduleSend(pSender, 0x1005, pPacket) == LORAREALTIMESENDER_SCHEDULESEND_NONE);
+  HOSTTEST_CHECK(((pScheduled = Test_FindScheduledPacket(pSender, 0x1005)) != NULL) &&
+                 (pScheduled->m_usRxWindow == LORAREALTIMESENDER_RXWINDOW_RX2));
+
+  // Both windows too late (RX windows not expired)
+  Test_RegisterNode(pSender, 0x1006, TEST_TRANSCEIVER(3), qwNow - GATEWAY_CLOCK_MS_TO_US(2100),
+                    LORATRANSCEIVERITF_FREQUENCY_CHANNEL_00, LORATRANSCEIVERITF_SF_7, LORATRANSCEIVERITF_FREQUENCY_RX2);
+  HOSTTEST_CHECK(Test_ScheduleSend(pSender, 0x1006, pPacket) == LORAREALTIMESENDER_SCHEDULESEND_TOO_LATE);
+
+  // No RX window registered
+  HOSTTEST_CHECK(Test_ScheduleSend(pSender, 0x1007, pPacket) == LORAREALTIMESENDER_SCHEDULESEND_TOO_LATE);
+
+  // Frequency channel of RX1 outside of sub-bands, RX2 window used
+  Test_RegisterNode(pSender, 0x1008, TEST_TRANSCEIVER(3), qwNow, TEST_FREQUENCY_UNKNOWN, LORATRANSCEIVERITF_SF_7,
+                    LORATRANSCEIVERITF_FREQUENCY_RX2);
+  HOSTTEST_CHECK(Test_ScheduleSend(pSender, 0x1008, pPacket) == LORAREALTIMESENDER_SCHEDULESEND_NONE);
+  HOSTTEST_CHECK(((pScheduled = Test_FindScheduledPacket(pSender, 0x1008)) != NULL) &&
+                 (pScheduled->m_usRxWindow == LORAREALTIMESENDER_RXWINDOW_RX2));
+
+  // Frequency channel of both windows outside of sub-bands
+  Test_RegisterNode(pSender, 0x1009, TEST_TRANSCEIVER(3), qwNow, TEST_FREQUENCY_UNKNOWN, LORATRANSCEIVERITF_SF_7,
+                    TEST_FREQUENCY_UNKNOWN);
+  HOSTTEST_CHECK(Test_ScheduleSend(pSender, 0x1009, pPacket) == LORAREALTIMESENDER_SCHEDULESEND_TX_FREQ);
+
+  // Duty-cycle of RX1 sub-band exhausted (g2 = 3.6 seconds per hour), RX2 window used
+  pPacket->m_dwDataSize = 255;
+  dwRX2Airtime = CLoraDutyCycle_GetTimeOnAir(LORATRANSCEIVERITF_SF_12, LORATRANSCEIVERITF_BANDWIDTH_125, LORATRANSCEIVERITF_CR_5,
+                                             8, true, true, pPacket->m_dwDataSize);
+  HOSTTEST_CHECK(dwRX2Airtime > 3600000);
+  dwG3Airtime = CLoraDutyCycle_GetWindowAirtime(pSender->m_pDutyCycle, LORADUTYCYCLE_SUBBAND_G3);
+
+  Test_RegisterNode(pSender, 0x100A, TEST_TRANSCEIVER(2), qwNow + GATEWAY_CLOCK_MS_TO_US(3000),
+                    LORATRANSCEIVERITF_FREQUENCY_CHANNEL_03, LORATRANSCEIVERITF_SF_12, LORATRANSCEIVERITF_FREQUENCY_RX2);
+  HOSTTEST_CHECK(Test_ScheduleSend(pSender, 0x100A, pPacket) == LORAREALTIMESENDER_SCHEDULESEND_NONE);
+  HOSTTEST_CHECK(((pScheduled = Test_FindScheduledPacket(pSender, 0x100A)) != NULL) &&
+                 (pScheduled->m_usRxWindow == LORAREALTIMESENDER_RXWINDOW_RX2));
+  HOSTTEST_CHECK(CLoraDutyCycle_GetWindowAirtime(pSender->m_pDutyCycle, LORADUTYCYCLE_SUBBAND_G2) == 0);
+  HOSTTEST_CHECK(CLoraDutyCycle_GetWindowAirtime(pSender->m_pDutyCycle, LORADUTYCYCLE_SUBBAND_G3) == dwG3Airtime + dwRX2Airtime);
+
+  // Duty-cycle of both sub-bands exhausted
+  Test_RegisterNode(pSender, 0x100B, TEST_TRANSCEIVER(1), qwNow + GATEWAY_CLOCK_MS_TO_US(30000),
+                    LORATRANSCEIVERITF_FREQUENCY_CHANNEL_03, LORATRANSCEIVERITF_SF_12, LORATRANSCEIVERITF_FREQUENCY_CHANNEL_04);
+  HOSTTEST_CHECK(Test_ScheduleSend(pSender, 0x100B, pPacket) == LORAREALTIMESENDER_SCHEDULESEND_COLLISION_PACKET);
+
+  // One session event for each scheduled packet
+  HOSTTEST_CHECK(g_dwTestSessionEventNumber == 6);
+
+  #undef TEST_TRANSCEIVER
+}
+
+
+static void Test_ServerSchedule(CLoraRealtimeSender *pSender, CLoraTransceiverItf_LoraPacket pPacket)
+{
+  CLoraRealtimeSenderItf_RadioParamsOb ServerRadio;
+  CRealtimeLoraPacket pScheduled;
+  QWORD qwNow;
+  DWORD dwAirtime;
+  DWORD dwG2Airtime;
+  DWORD dwSessionEventNumber;
+  static BYTE usTransceiver[3];
+
+  // Not the transceivers of 'Test_Schedule' (i.e. packets still in realtime queue)
+  #define TEST_TRANSCEIVER(i)  ((ILoraTransceiver) &(usTransceiver[i]))
+
+  pPacket->m_dwDataSize = 17;
+  qwNow = GATEWAY_CLOCK_MICROSEC();
+  dwSessionEventNumber = g_dwTestSessionEventNumber;
+  dwG2Airtime = CLoraDutyCycle_GetWindowAirtime(pSender->m_pDutyCycle, LORADUTYCYCLE_SUBBAND_G2);
+
+  // Radio settings of Network Server replace the settings of RX window ('NONE' = RX window setting)
+  ServerRadio.m_usFreqChannel = LORATRANSCEIVERITF_FREQUENCY_CHANNEL_03;
+  ServerRadio.m_usSpreadingFactor = LORATRANSCEIVERITF_SF_9;
+  ServerRadio.m_usBandwidth = LORATRANSCEIVERITF_BANDWIDTH_NONE;
+  ServerRadio.m_usCodingRate = LORATRANSCEIVERITF_CR_NONE;
+  ServerRadio.m_usPowerLevel = 10;
+  dwAirtime = CLoraDutyCycle_GetTimeOnAir(LORATRANSCEIVERITF_SF_9, LORATRANSCEIVERITF_BANDWIDTH_125, LORATRANSCEIVERITF_CR_5,
+                                          8, true, true, pPacket->m_dwDataSize);
+
+  Test_RegisterNode(pSender, 0x3001, TEST_TRANSCEIVER(0), qwNow, LORATRANSCEIVERITF_FREQUENCY_CHANNEL_00, LORATRANSCEIVERITF_SF_7,
+                    LORATRANSCEIVERITF_FREQUENCY_RX2);
+  HOSTTEST_CHECK(Test_ScheduleServerSend(pSender, 0x3001, false, (DWORD) (qwNow + LORAREALTIMESENDER_CLASSA_RECEIVE_DELAY1),
+                                         &ServerRadio, pPacket) == LORAREALTIMESENDER_SCHEDULESEND_NONE);
+  HOSTTEST_CHECK(((pScheduled = Test_FindScheduledPacket(pSender, 0x3001)) != NULL) &&
+                 (pScheduled->m_usRxWindow == LORAREALTIMESENDER_RXWINDOW_RX1) &&
+                 (pScheduled->m_Radio.m_usFreqChannel == LORATRANSCEIVERITF_FREQUENCY_CHANNEL_03) &&
+                 (pScheduled->m_Radio.m_usSpreadingFactor == LORATRANSCEIVERITF_SF_9) &&
+                 (pScheduled->m_Radio.m_usBandwidth == LORATRANSCEIVERITF_BANDWIDTH_125) &&
+                 (pScheduled->m_Radio.m_usCodingRate == LORATRANSCEIVERITF_CR_5) &&
+                 (pScheduled->m_Radio.m_usPowerLevel == 10) &&
+                 (pScheduled->m_qwEndTimestamp == pScheduled->m_qwSendTimestamp + dwAirtime));
+  HOSTTEST_CHECK(CLoraDutyCycle_GetWindowAirtime(pSender->m_pDutyCycle, LORADUTYCYCLE_SUBBAND_G2) == dwG2Airtime + dwAirtime);
+
+  // 'Join Request' not indexed by device address, 'Join Accept' scheduled in RX1 window matching
+  // the send time (i.e. JOIN_ACCEPT_DELAY1)
+  ServerRadio.m_usFreqChannel = LORATRANSCEIVERITF_FREQUENCY_CHANNEL_NONE;
+  ServerRadio.m_usSpreadingFactor = LORATRANSCEIVERITF_SF_NONE;
+  ServerRadio.m_usPowerLevel = LORATRANSCEIVERITF_POWER_LEVEL_NONE;
+
+  Test_RegisterRxWindows(pSender, 0x3002, true, TEST_TRANSCEIVER(1), qwNow, LORATRANSCEIVERITF_FREQUENCY_CHANNEL_01,
+                         LORATRANSCEIVERITF_SF_7, LORATRANSCEIVERITF_FREQUENCY_RX2);
+  HOSTTEST_CHECK(CLoraRealtimeSender_FindNodeReceiveWindow(pSender, 0x3002, false) == NULL);
+  HOSTTEST_CHECK(Test_ScheduleServerSend(pSender, 0x3002, true, (DWORD) (qwNow + LORAREALTIMESENDER_CLASSA_JOIN_ACCEPT_DELAY1),
+                                         &ServerRadio, pPacket) == LORAREALTIMESENDER_SCHEDULESEND_NONE);
+  HOSTTEST_CHECK(((pScheduled = Test_FindScheduledPacket(pSender, 0x3002)) != NULL) &&
+                 (pScheduled->m_pLoraTransceiverItf == TEST_TRANSCEIVER(1)) &&
+                 (pScheduled->m_usRxWindow == LORAREALTIMESENDER_RXWINDOW_RX1) &&
+                 (pScheduled->m_qwSendTimestamp == qwNow + LORAREALTIMESENDER_CLASSA_JOIN_ACCEPT_DELAY1) &&
+                 (pScheduled->m_Radio.m_usFreqChannel == LORATRANSCEIVERITF_FREQUENCY_CHANNEL_01) &&
+                 (pScheduled->m_Radio.m_usPowerLevel == LORATRANSCEIVERITF_POWER_LEVEL_NONE));
+
+  // No 'Join Request' RX window including the send time
+  HOSTTEST_CHECK(Test_ScheduleServerSend(pSender, 0x3003, true, (DWORD) (qwNow + LORAREALTIMESENDER_CLASSA_RECEIVE_DELAY1),
+                                         &ServerRadio, pPacket) == LORAREALTIMESENDER_SCHEDULESEND_TOO_LATE);
+  HOSTTEST_CHECK(Test_FindScheduledPacket(pSender, 0x3003) == NULL);
+
+  // Send time outside RX windows: 'TOO_EARLY' before RX1 window, 'TOO_LATE' after (i.e. including
+  // the time between RX1 and RX2 windows), RX2 window accepted up to its last microsecond
+  Test_RegisterNode(pSender, 0x3004, TEST_TRANSCEIVER(2), qwNow, LORATRANSCEIVERITF_FREQUENCY_CHANNEL_00, LORATRANSCEIVERITF_SF_7,
+                    LORATRANSCEIVERITF_FREQUENCY_RX2);
+  HOSTTEST_CHECK(Test_ScheduleServerSend(pSender, 0x3004, false, (DWORD) (qwNow + LORAREALTIMESENDER_CLASSA_RECEIVE_DELAY1 - 1),
+                                         &ServerRadio, pPacket) == LORAREALTIMESENDER_SCHEDULESEND_TOO_EARLY);
+  HOSTTEST_CHECK(Test_ScheduleServerSend(pSender, 0x3004, false, (DWORD) (qwNow + LORAREALTIMESENDER_CLASSA_RECEIVE_DELAY1 +
+                                         LORAREALTIMESENDER_LORAWAN_RX_WINDOW_LENGTH + 1), &ServerRadio, pPacket) ==
+                 LORAREALTIMESENDER_SCHEDULESEND_TOO_LATE);
+  HOSTTEST_CHECK(Test_ScheduleServerSend(pSender, 0x3004, false, (DWORD) (qwNow + LORAREALTIMESENDER_CLASSA_RECEIVE_DELAY2 - 1),
+                                         &ServerRadio, pPacket) == LORAREALTIMESENDER_SCHEDULESEND_TOO_LATE);
+  HOSTTEST_CHECK(Test_ScheduleServerSend(pSender, 0x3004, false, (DWORD) (qwNow + LORAREALTIMESENDER_CLASSA_RECEIVE_DELAY2 +
+                                         LORAREALTIMESENDER_LORAWAN_RX_WINDOW_LENGTH + 1), &ServerRadio, pPacket) ==
+                 LORAREALTIMESENDER_SCHEDULESEND_TOO_LATE);
+  HOSTTEST_CHECK(Test_FindScheduledPacket(pSender, 0x3004) == NULL);
+  HOSTTEST_CHECK(Test_ScheduleServerSend(pSender, 0x3004, false, (DWORD) (qwNow + LORAREALTIMESENDER_CLASSA_RECEIVE_DELAY2 +
+                                         LORAREALTIMESENDER_LORAWAN_RX_WINDOW_LENGTH), &ServerRadio, pPacket) ==
+                 LORAREALTIMESENDER_SCHEDULESEND_NONE);
+  HOSTTEST_CHECK(((pScheduled = Test_FindScheduledPacket(pSender, 0x3004)) != NULL) &&
+                 (pScheduled->m_usRxWindow == LORAREALTIMESENDER_RXWINDOW_RX2) &&
+                 (pScheduled->m_qwSendTimestamp == qwNow + LORAREALTIMESENDER_CLASSA_RECEIVE_DELAY2 +
+                                                   LORAREALTIMESENDER_LORAWAN_RX_WINDOW_LENGTH));
+
+  HOSTTEST_CHECK(g_dwTestSessionEventNumber == dwSessionEventNumber + 3);
+
+  #undef TEST_TRANSCEIVER
+}
+
+
+static void Test_Benchmark(CLoraRealtimeSender *pSender, CLoraTransceiverItf_LoraPacket pPacket)
+{
+  CLoraRealtimeSenderItf_RadioParamsOb Radio;
+  QWORD qwStart;
+  QWORD qwDuration;
+  QWORD qwNow;
+  DWORD dwAirtime;
+  DWORD dwAcceptedNumber = 0;
+  BYTE usTransceiver;
+
+  // Packets waiting in the realtime queue (i.e. enumerated by 'IsTransceiverBusy')
+  qwNow = GATEWAY_CLOCK_MICROSEC();
+  pPacket->m_dwDataSize = 20;
+  for (DWORD i = 0; i < TEST_BENCH_QUEUED; i++)
+  {
+    Test_RegisterNode(pSender, 0x2000 + i, (ILoraTransceiver) &usTransceiver, qwNow + i * GATEWAY_CLOCK_MS_TO_US(4000),
+                      LORATRANSCEIVERITF_FREQUENCY_CHANNEL_00, LORATRANSCEIVERITF_SF_12, LORATRANSCEIVERITF_FREQUENCY_RX2);
+    HOSTTEST_CHECK(Test_ScheduleSend(pSender, 0x2000 + i, pPacket) == LORAREALTIMESENDER_SCHEDULESEND_NONE);
+  }
+
+  Radio.m_usFreqChannel = LORATRANSCEIVERITF_FREQUENCY_CHANNEL_01;
+  Radio.m_usSpreadingFactor = LORATRANSCEIVERITF_SF_7;
+  Radio.m_usBandwidth = LORATRANSCEIVERITF_BANDWIDTH_125;
+  Radio.m_usCodingRate = LORATRANSCEIVERITF_CR_5;
+  Radio.m_wPreambleLength = 8;
+  Radio.m_usHeader = LORATRANSCEIVERITF_HEADER_ON;
+  Radio.m_usCRC = LORATRANSCEIVERITF_CRC_ON;
+
+  // Half of the decisions collide with a waiting packet
+  qwStart = GATEWAY_CLOCK_MICROSEC();
+  for (DWORD i = 0; i < TEST_BENCH_DECISIONS; i++)
+  {
+    if (CLoraRealtimeSender_CheckTransmission(pSender, (ILoraTransceiver) &usTransceiver, &Radio,
+          qwNow + GATEWAY_CLOCK_MS_TO_US(1000) + (i % (2 * TEST_BENCH_QUEUED)) * GATEWAY_CLOCK_MS_TO_US(2000),
+          (i % LORA_MAX_PAYLOAD_LENGTH) + 1, &dwAirtime) == LORAREALTIMESENDER_SCHEDULESEND_NONE)
+    {
+      ++dwAcceptedNumber;
+    }
+  }
+  qwDuration = GATEWAY_CLOCK_MICROSEC() - qwStart;
+
+  HOSTTEST_CHECK((dwAcceptedNumber > 0) && (dwAcceptedNumber < TEST_BENCH_DECISIONS));
+
+  printf("[INFO] Scheduling decisions: %u in %u us (%u accepted, %u packets queued) = %u decisions/s\n",
+         TEST_BENCH_DECISIONS, (unsigned int) qwDuration, (unsigned int) dwAcceptedNumber, TEST_BENCH_QUEUED,
+         (unsigned int) ((QWORD) TEST_BENCH_DECISIONS * 1000000 / (qwDuration > 0 ? qwDuration : 1)));
+}
+
+
+static void Test_LoraDutyCycle(void)
+{
+  CLoraRealtimeSender *pSender;
+  CLoraRealtimeSenderItf_InitializeParamsOb InitializeParams;
+  CLoraTransceiverItf_LoraPacket pPacket;
+  ITransceiverManager pTransceiverManagerItf;
+
+  Test_TimeOnAir();
+  Test_Ledger();
+
+  // 'LoraRealtimeSender' not started (i.e. packets stay in realtime queue)
+  HOSTTEST_CHECK((pSender = CLoraRealtimeSender_New()) != NULL);
+  HOSTTEST_CHECK((pTransceiverManagerItf = ITransceiverManager_New(NULL, &g_TestTransceiverManagerItfImplOb)) != NULL);
+  HOSTTEST_CHECK((pPacket = pvPortMalloc(sizeof(CLoraTransceiverItf_LoraPacketOb) + LORA_MAX_PAYLOAD_LENGTH)) != NULL);
+  if ((pSender == NULL) || (pTransceiverManagerItf == NULL) || (pPacket == NULL))
+  {
+    return;
+  }
+
+  InitializeParams.m_pTransceiverManagerItf = pTransceiverManagerItf;
+  InitializeParams.m_pTxStatistics = NULL;
+  HOSTTEST_CHECK(CLoraRealtimeSender_Initialize(pSender, &InitializeParams) == true);
+
+  Test_Schedule(pSender, pPacket);
+  Test_ServerSchedule(pSender, pPacket);
+
+  // Benchmark on a new realtime queue and ledger
+  // Note: The previous object is not deleted (i.e. 'PacketSender' task not terminated)
+  HOSTTEST_CHECK((pSender = CLoraRealtimeSender_New()) != NULL);
+  if (pSender == NULL)
+  {
+    return;
+  }
+  HOSTTEST_CHECK(CLoraRealtimeSender_Initialize(pSender, &InitializeParams) == true);
+
+  Test_Benchmark(pSender, pPacket);
+}
+
+
+int main(void)
+{
+  return HostTest_Run("test_lora_dutycycle", Test_LoraDutyCycle);
+}
@@ -0,0 +1,431 @@
+/*****************************************************************************************//**
+ * @file     test_memory_block_array.c
+ *
+ * @author   F.Fargon
+ *
+ * @version  V1.0
+ *
+ * @date     16/10/2026
+ *
+ * @brief    Lock-free 'CMemoryBlockArray' and 'CWideMemoryBlockArray' collections.
+ *
+ * @details  The test checks the free block list of both collections:\n
+ *            - Allocation of all blocks (distinct blocks, used and ready flags, index and
+ *              pointer conversions) and shared blocks with reference counters
+ *            - Detection of blocks released more than once (free list not corrupted)
+ *            - Wrap of the ABA tag of the free list head (16 bits counter)
+ *            - Concurrent get and release by several tasks (each block owned by one task
+ *              only, all blocks free at the end)
+ *            - Benchmark of get/release pairs per second with 1 task and with contention
+*********************************************************************************************/
+
+#include <Common.h>
+
+#include "Utilities.h"
+
+#include "HostTest.h"
+
+
+/*********************************************************************************************
+  Definitions
+*********************************************************************************************/
+
+// Size of collections (i.e. maximum for 'CMemoryBlockArray')
+#define TEST_BLOCK_SIZE          16
+#define TEST_ARRAY_BLOCKS        255
+#define TEST_WIDE_BLOCKS         1000
+
+// Concurrent tasks, get/release cycles of each task and blocks held during a cycle
+#define TEST_TASKS               4
+#define TEST_CYCLES              200000
+#define TEST_HOLD                4
+
+// Get/release pairs for benchmark (each task)
+#define TEST_BENCH_PAIRS         1000000
+
+// Free list operations while crossing the wrap of ABA tag
+#define TEST_TAG_OPERATIONS      64
+
+// Task of concurrent test
+typedef struct _TestTask
+{
+  CMemoryBlockArray m_pArray;
+  CWideMemoryBlockArray m_pWideArray;
+  DWORD m_dwIndex;
+  DWORD m_dwCycles;
+  bool m_bCheck;
+
+  // Results
+  DWORD m_dwGetNumber;
+  DWORD m_dwEmptyNumber;
+  DWORD m_dwCorruptedNumber;
+  DWORD m_dwReleaseErrorNumber;
+
+  SemaphoreHandle_t m_hDone;
+} TestTaskOb;
+
+
+/*********************************************************************************************
+  Helpers
+*********************************************************************************************/
+
+// Gets all blocks of a 'CMemoryBlockArray' and checks that they are distinct
+// Returns the number of blocks
+static DWORD Test_GetAllBlocks(CMemoryBlockArray pArray, BYTE *pusIndexes)
+{
+  CMemoryBlockArrayEntryOb Entry;
+  bool bUsed[TEST_ARRAY_BLOCKS] = { false };
+  DWORD dwBlockNumber = 0;
+
+  while (CMemoryBlockArray_GetBlock(pArray, &Entry) != NULL)
+  {
+    if ((HOSTTEST_CHECK(Entry.m_usBlockIndex < TEST_ARRAY_BLOCKS) == false) ||
+        (HOSTTEST_CHECK(bUsed[Entry.m_usBlockIndex] == false) == false))
+    {
+      break;
+    }
+    bUsed[Entry.m_usBlockIndex] = true;
+    HOSTTEST_CHECK(CMemoryBlockArray_IsBlockUsed(pArray, Entry.m_usBlockIndex) == true);
+    HOSTTEST_CHECK(CMemoryBlockArray_BlockPtrFromIndex(pArray, Entry.m_usBlockIndex) == Entry.m_pDataBlock);
+    HOSTTEST_CHECK(CMemoryBlockArray_BlockIndexFromPtr(pArray, Entry.m_pDataBlock) == Entry.m_usBlockIndex);
+    pusIndexes[dwBlockNumber++] = Entry.m_usBlockIndex;
+  }
+  return dwBlockNumber;
+}
+
+// Gets all blocks of a 'CWideMemoryBlockArray' and checks that they are distinct
+// Returns the number of blocks
+static DWORD Test_GetAllWideBlocks(CWideMemoryBlockArray pArray, WORD *pwIndexes)
+{
+  CWideMemoryBlockArrayEntryOb Entry;
+  static bool s_bUsed[TEST_WIDE_BLOCKS];
+  DWORD dwBlockNumber = 0;
+
+  memset(s_bUsed, 0, sizeof(s_bUsed));
+  while (CWideMemoryBlockArray_GetBlock(pArray, &Entry) != NULL)
+  {
+    if ((HOSTTEST_CHECK(Entry.m_wBlockIndex < TEST_WIDE_BLOCKS) == false) ||
+        (HOSTTEST_CHECK(s_bUsed[Entry.m_wBlockIndex] == false) == false))
+    {
+      break;
+    }
+    s_bUsed[Entry.m_wBlockIndex] = true;
+    HOSTTEST_CHECK(CWideMemoryBlockArray_IsBlockUsed(pArray, Entry.m_wBlockIndex) == true);
+    HOSTTEST_CHECK(CWideMemoryBlockArray_BlockPtrFromIndex(pArray, Entry.m_wBlockIndex) == Entry.m_pDataBlock);
+    HOSTTEST_CHECK(CWideMemoryBlockArray_BlockIndexFromPtr(pArray, Entry.m_pDataBlock) == Entry.m_wBlockIndex);
+    pwIndexes[dwBlockNumber++] = Entry.m_wBlockIndex;
+  }
+  return dwBlockNumber;
+}
+
+
+// Task of concurrent test and benchmark: each cycle gets up to 'TEST_HOLD' blocks, writes its
+// signature in the blocks and releases them after checking the signature (i.e. block not
+// provided to another task while owned)
+static void Test_Task(void *pParams)
+{
+  TestTaskOb *pTask = (TestTaskOb *) pParams;
+  CMemoryBlockArrayEntryOb Entries[TEST_HOLD];
+  CWideMemoryBlockArrayEntryOb WideEntries[TEST_HOLD];
+  DWORD *pBlock;
+  DWORD dwSignature;
+  DWORD dwHeld;
+
+  for (DWORD dwCycle = 0; dwCycle < pTask->m_dwCycles; dwCycle++)
+  {
+    dwSignature = (pTask->m_dwIndex << 24) | (dwCycle & 0x00FFFFFF);
+
+    // Get the blocks
+    for (dwHeld = 0; dwHeld < (pTask->m_bCheck == true ? TEST_HOLD : 1); dwHeld++)
+    {
+      pBlock = pTask->m_pArray != NULL ? CMemoryBlockArray_GetBlock(pTask->m_pArray, &Entries[dwHeld]) :
+                                         CWideMemoryBlockArray_GetBlock(pTask->m_pWideArray, &WideEntries[dwHeld]);
+      if (pBlock == NULL)
+      {
+        ++pTask->m_dwEmptyNumber;
+        break;
+      }
+      ++pTask->m_dwGetNumber;
+      if (pTask->m_bCheck == true)
+      {
+        pBlock[0] = dwSignature;
+        pBlock[TEST_BLOCK_SIZE / sizeof(DWORD) - 1] = dwSignature;
+      }
+    }
+
+    // Let other tasks access the collection while blocks are owned
+    if ((pTask->m_bCheck == true) && ((dwCycle & 0x0F) == 0))
+    {
+      taskYIELD();
+    }
+
+    // Check and release the blocks
+    while (dwHeld > 0)
+    {
+      --dwHeld;
+      if (pTask->m_bCheck == true)
+      {
+        pBlock = pTask->m_pArray != NULL ? (DWORD *) Entries[dwHeld].m_pDataBlock : (DWORD *) WideEntries[dwHeld].m_pDataBlock;
+        if ((pBlock[0] != dwSignature) || (pBlock[TEST_BLOCK_SIZE / sizeof(DWORD) - 1] != dwSignature))
+        {
+          ++pTask->m_dwCorruptedNumber;
+        }
+      }
+      if ((pTask->m_pArray != NULL ? CMemoryBlockArray_ReleaseBlock(pTask->m_pArray, Entries[dwHeld].m_usBlockIndex) :
+           CWideMemoryBlockArray_ReleaseBlock(pTask->m_pWideArray, WideEntries[dwHeld].m_wBlockIndex)) == false)
+      {
+        ++pTask->m_dwReleaseErrorNumber;
+      }
+    }
+  }
+
+  xSemaphoreGive(pTask->m_hDone);
+  vTaskDelete(NULL);
+}
+
+// Runs 'dwTaskNumber' tasks on one collection ('pArray' or 'pWideArray')
+// Returns the duration in microseconds
+static QWORD Test_RunTasks(CMemoryBlockArray pArray, CWideMemoryBlockArray pWideArray, DWORD dwTaskNumber, DWORD dwCycles,
+                           bool bCheck, TestTaskOb *pTasks)
+{
+  SemaphoreHandle_t hDone;
+  QWORD qwStart;
+
+  HOSTTEST_CHECK((hDone = xSemaphoreCreateCounting(dwTaskNumber, 0)) != NULL);
+  if (hDone == NULL)
+  {
+    return 0;
+  }
+
+  qwStart = GATEWAY_CLOCK_MICROSEC();
+  for (DWORD t = 0; t < dwTaskNumber; t++)
+  {
+    memset(&pTasks[t], 0, sizeof(TestTaskOb));
+    pTasks[t].m_pArray = pArray;
+    pTasks[t].m_pWideArray = pWideArray;
+    pTasks[t].m_dwIndex = t + 1;
+    pTasks[t].m_dwCycles = dwCycles;
+    pTasks[t].m_bCheck = bCheck;
+    pTasks[t].m_hDone = hDone;
+    HOSTTEST_CHECK(xTaskCreate(Test_Task, "BlockArrayTask", HOSTTEST_TASK_STACK_SIZE, &pTasks[t],
+                               HOSTTEST_TASK_PRIORITY, NULL) == pdPASS);
+  }
+  for (DWORD t = 0; t < dwTaskNumber; t++)
+  {
+    xSemaphoreTake(hDone, portMAX_DELAY);
+  }
+
+  vSemaphoreDelete(hDone);
+  return GATEWAY_CLOCK_MICROSEC() - qwStart;
+}
+
+
+/*********************************************************************************************
+  Test
+*********************************************************************************************/
+
+static void Test_Allocation(CMemoryBlockArray pArray, CWideMemoryBlockArray pWideArray, CWideMemoryBlockArray pSharedArray)
+{
+  CWideMemoryBlockArrayEntryOb WideEntry;
+  BYTE usIndexes[TEST_ARRAY_BLOCKS];
+  static WORD s_wIndexes[TEST_WIDE_BLOCKS];
+  DWORD dwBlockNumber;
+
+  // 'CMemoryBlockArray': all blocks, ready flag cleared by release, double release detected
+  HOSTTEST_CHECK((dwBlockNumber = Test_GetAllBlocks(pArray, usIndexes)) == TEST_ARRAY_BLOCKS);
+  CMemoryBlockArray_SetBlockReady(pArray, usIndexes[0]);
+  HOSTTEST_CHECK(CMemoryBlockArray_IsBlockReady(pArray, usIndexes[0]) == true);
+  for (DWORD i = 0; i < dwBlockNumber; i++)
+  {
+    HOSTTEST_CHECK(CMemoryBlockArray_ReleaseBlock(pArray, usIndexes[i]) == true);
+  }
+  HOSTTEST_CHECK(CMemoryBlockArray_IsBlockReady(pArray, usIndexes[0]) == false);
+  for (DWORD i = 0; i < dwBlockNumber; i++)
+  {
+    HOSTTEST_CHECK(CMemoryBlockArray_ReleaseBlock(pArray, usIndexes[i]) == false);
+    HOSTTEST_CHECK(CMemoryBlockArray_IsBlockUsed(pArray, usIndexes[i]) == false);
+  }
+
+  // Free list not corrupted by the rejected releases (i.e. each block provided once)
+  HOSTTEST_CHECK((dwBlockNumber = Test_GetAllBlocks(pArray, usIndexes)) == TEST_ARRAY_BLOCKS);
+  for (DWORD i = 0; i < dwBlockNumber; i++)
+  {
+    CMemoryBlockArray_ReleaseBlock(pArray, usIndexes[i]);
+  }
+
+  // 'CWideMemoryBlockArray': same checks
+  HOSTTEST_CHECK((dwBlockNumber = Test_GetAllWideBlocks(pWideArray, s_wIndexes)) == TEST_WIDE_BLOCKS);
+  CWideMemoryBlockArray_SetBlockReady(pWideArray, s_wIndexes[TEST_WIDE_BLOCKS - 1]);
+  HOSTTEST_CHECK(CWideMemoryBlockArray_IsBlockReady(pWideArray, s_wIndexes[TEST_WIDE_BLOCKS - 1]) == true);
+  for (DWORD i = 0; i < dwBlockNumber; i++)
+  {
+    HOSTTEST_CHECK(CWideMemoryBlockArray_ReleaseBlock(pWideArray, s_wIndexes[i]) == true);
+  }
+  HOSTTEST_CHECK(CWideMemoryBlockArray_IsBlockReady(pWideArray, s_wIndexes[TEST_WIDE_BLOCKS - 1]) == false);
+  for (DWORD i = 0; i < dwBlockNumber; i++)
+  {
+    HOSTTEST_CHECK(CWideMemoryBlockArray_ReleaseBlock(pWideArray, s_wIndexes[i]) == false);
+  }
+  HOSTTEST_CHECK((dwBlockNumber = Test_GetAllWideBlocks(pWideArray, s_wIndexes)) == TEST_WIDE_BLOCKS);
+  for (DWORD i = 0; i < dwBlockNumber; i++)
+  {
+    CWideMemoryBlockArray_ReleaseBlock(pWideArray, s_wIndexes[i]);
+  }
+
+  // Shared blocks: released with the last reference, then detected as already released
+  HOSTTEST_CHECK(CWideMemoryBlockArray_GetBlock(pSharedArray, &WideEntry) != NULL);
+  CWideMemoryBlockArray_AddRef(pSharedArray, WideEntry.m_wBlockIndex);
+  CWideMemoryBlockArray_AddRef(pSharedArray, WideEntry.m_wBlockIndex);
+  HOSTTEST_CHECK(CWideMemoryBlockArray_ReleaseRef(pSharedArray, WideEntry.m_wBlockIndex) == false);
+  HOSTTEST_CHECK(CWideMemoryBlockArray_ReleaseRef(pSharedArray, WideEntry.m_wBlockIndex) == false);
+  HOSTTEST_CHECK(CWideMemoryBlockArray_IsBlockUsed(pSharedArray, WideEntry.m_wBlockIndex) == true);
+  HOSTTEST_CHECK(CWideMemoryBlockArray_ReleaseRef(pSharedArray, WideEntry.m_wBlockIndex) == true);
+  HOSTTEST_CHECK(CWideMemoryBlockArray_IsBlockUsed(pSharedArray, WideEntry.m_wBlockIndex) == false);
+  HOSTTEST_CHECK(CWideMemoryBlockArray_ReleaseBlock(pSharedArray, WideEntry.m_wBlockIndex) == false);
+  HOSTTEST_CHECK((dwBlockNumber = Test_GetAllWideBlocks(pSharedArray, s_wIndexes)) == TEST_WIDE_BLOCKS);
+  for (DWORD i = 0; i < dwBlockNumber; i++)
+  {
+    HOSTTEST_CHECK(CWideMemoryBlockArray_ReleaseRef(pSharedArray, s_wIndexes[i]) == true);
+  }
+}
+
+
+#if (MEMORYBLOCKARRAY_LOCKFREE)
+static void Test_TagWrap(CMemoryBlockArray pArray, CWideMemoryBlockArray pWideArray)
+{
+  CMemoryBlockArrayEntryOb Entries[TEST_TAG_OPERATIONS / 2];
+  CWideMemoryBlockArrayEntryOb WideEntries[TEST_TAG_OPERATIONS / 2];
+  BYTE usIndexes[TEST_ARRAY_BLOCKS];
+  static WORD s_wIndexes[TEST_WIDE_BLOCKS];
+  DWORD dwBlockNumber;
+
+  // Tag of free list head just before the wrap (i.e. each get or release increments the tag)
+  pArray->m_dwFreeListHead = (0xFFF0 << 16) | (pArray->m_dwFreeListHead & 0x0000FFFF);
+  pWideArray->m_dwFreeListHead = (0xFFF0 << 16) | (pWideArray->m_dwFreeListHead & 0x0000FFFF);
+
+  for (DWORD i = 0; i < TEST_TAG_OPERATIONS / 2; i++)
+  {
+    HOSTTEST_CHECK(CMemoryBlockArray_GetBlock(pArray, &Entries[i]) != NULL);
+    HOSTTEST_CHECK(CWideMemoryBlockArray_GetBlock(pWideArray, &WideEntries[i]) != NULL);
+  }
+  for (DWORD i = 0; i < TEST_TAG_OPERATIONS / 2; i++)
+  {
+    HOSTTEST_CHECK(CMemoryBlockArray_ReleaseBlock(pArray, Entries[i].m_usBlockIndex) == true);
+    HOSTTEST_CHECK(CWideMemoryBlockArray_ReleaseBlock(pWideArray, WideEntries[i].m_wBlockIndex) == true);
+  }
+
+  // Tag wrapped to 0, index of head unchanged
+  HOSTTEST_CHECK((pArray->m_dwFreeListHead >> 16) == ((0xFFF0 + TEST_TAG_OPERATIONS) & 0xFFFF));
+  HOSTTEST_CHECK((pWideArray->m_dwFreeListHead >> 16) == ((0xFFF0 + TEST_TAG_OPERATIONS) & 0xFFFF));
+
+  // All blocks still provided once
+  HOSTTEST_CHECK((dwBlockNumber = Test_GetAllBlocks(pArray, usIndexes)) == TEST_ARRAY_BLOCKS);
+  for (DWORD i = 0; i < dwBlockNumber; i++)
+  {
+    CMemoryBlockArray_ReleaseBlock(pArray, usIndexes[i]);
+  }
+  HOSTTEST_CHECK((dwBlockNumber = Test_GetAllWideBlocks(pWideArray, s_wIndexes)) == TEST_WIDE_BLOCKS);
+  for (DWORD i = 0; i < dwBlockNumber; i++)
+  {
+    CWideMemoryBlockArray_ReleaseBlock(pWideArray, s_wIndexes[i]);
+  }
+}
+#endif
+
+
+static void Test_Concurrent(CMemoryBlockArray pArray, CWideMemoryBlockArray pWideArray)
+{
+  TestTaskOb Tasks[TEST_TASKS];
+  BYTE usIndexes[TEST_ARRAY_BLOCKS];
+  static WORD s_wIndexes[TEST_WIDE_BLOCKS];
+  DWORD dwGetNumber;
+
+  for (DWORD i = 0; i < 2; i++)
+  {
+    Test_RunTasks(i == 0 ? pArray : NULL, i == 0 ? NULL : pWideArray, TEST_TASKS, TEST_CYCLES, true, Tasks);
+
+    dwGetNumber = 0;
+    for (DWORD t = 0; t < TEST_TASKS; t++)
+    {
+      HOSTTEST_CHECK(Tasks[t].m_dwCorruptedNumber == 0);
+      HOSTTEST_CHECK(Tasks[t].m_dwReleaseErrorNumber == 0);
+      dwGetNumber += Tasks[t].m_dwGetNumber;
+    }
+    HOSTTEST_CHECK(dwGetNumber > TEST_TASKS * TEST_CYCLES);
+
+    printf("[INFO] %s concurrent: %u tasks, %u blocks provided, corrupted: %u, release errors: %u\n",
+           i == 0 ? "CMemoryBlockArray" : "CWideMemoryBlockArray", TEST_TASKS, (unsigned int) dwGetNumber,
+           (unsigned int) (Tasks[0].m_dwCorruptedNumber + Tasks[1].m_dwCorruptedNumber + Tasks[2].m_dwCorruptedNumber + Tasks[3].m_dwCorruptedNumber),
+           (unsigned int) (Tasks[0].m_dwReleaseErrorNumber + Tasks[1].m_dwReleaseErrorNumber + Tasks[2].m_dwReleaseErrorNumber + Tasks[3].m_dwReleaseErrorNumber));
+  }
+
+  // All blocks free at the end
+  HOSTTEST_CHECK(Test_GetAllBlocks(pArray, usIndexes) == TEST_ARRAY_BLOCKS);
+  for (DWORD i = 0; i < TEST_ARRAY_BLOCKS; i++)
+  {
+    CMemoryBlockArray_ReleaseBlock(pArray, usIndexes[i]);
+  }
+  HOSTTEST_CHECK(Test_GetAllWideBlocks(pWideArray, s_wIndexes) == TEST_WIDE_BLOCKS);
+  for (DWORD i = 0; i < TEST_WIDE_BLOCKS; i++)
+  {
+    CWideMemoryBlockArray_ReleaseBlock(pWideArray, s_wIndexes[i]);
+  }
+}
+
+
+static void Test_Benchmark(CMemoryBlockArray pArray, CWideMemoryBlockArray pWideArray)
+{
+  TestTaskOb Tasks[TEST_TASKS];
+  QWORD qwDuration;
+  DWORD dwTaskNumber;
+
+  for (DWORD i = 0; i < 4; i++)
+  {
+    dwTaskNumber = (i & 1) == 0 ? 1 : TEST_TASKS;
+    qwDuration = Test_RunTasks(i < 2 ? pArray : NULL, i < 2 ? NULL : pWideArray, dwTaskNumber, TEST_BENCH_PAIRS, false, Tasks);
+
+    for (DWORD t = 0; t < dwTaskNumber; t++)
+    {
+      HOSTTEST_CHECK(Tasks[t].m_dwReleaseErrorNumber == 0);
+      HOSTTEST_CHECK(Tasks[t].m_dwGetNumber == TEST_BENCH_PAIRS);
+    }
+
+    printf("[INFO] %s get/release: %u task(s), %u pairs in %u us = %u pairs/s\n",
+           i < 2 ? "CMemoryBlockArray" : "CWideMemoryBlockArray", (unsigned int) dwTaskNumber,
+           (unsigned int) (dwTaskNumber * TEST_BENCH_PAIRS), (unsigned int) qwDuration,
+           (unsigned int) ((QWORD) dwTaskNumber * TEST_BENCH_PAIRS * 1000000 / (qwDuration > 0 ? qwDuration : 1)));
+  }
+}
+
+
+static void Test_MemoryBlockArray(void)
+{
+  CMemoryBlockArray pArray;
+  CWideMemoryBlockArray pWideArray;
+  CWideMemoryBlockArray pSharedArray;
+
+  HOSTTEST_CHECK((pArray = CMemoryBlockArray_New(TEST_BLOCK_SIZE, TEST_ARRAY_BLOCKS)) != NULL);
+  HOSTTEST_CHECK((pWideArray = CWideMemoryBlockArray_New(TEST_BLOCK_SIZE, TEST_WIDE_BLOCKS)) != NULL);
+  HOSTTEST_CHECK((pSharedArray = CWideMemoryBlockArray_NewShared(TEST_BLOCK_SIZE, TEST_WIDE_BLOCKS)) != NULL);
+  if ((pArray == NULL) || (pWideArray == NULL) || (pSharedArray == NULL))
+  {
+    return;
+  }
+
+  Test_Allocation(pArray, pWideArray, pSharedArray);
+  #if (MEMORYBLOCKARRAY_LOCKFREE)
+    Test_TagWrap(pArray, pWideArray);
+  #endif
+  Test_Concurrent(pArray, pWideArray);
+  Test_Benchmark(pArray, pWideArray);
+
+  CMemoryBlockArray_Delete(pArray);
+  CWideMemoryBlockArray_Delete(pWideArray);
+  CWideMemoryBlockArray_Delete(pSharedArray);
+}
+
+
+int main(void)
+{
+  return HostTest_Run("test_memory_block_array", Test_MemoryBlockArray);
+}
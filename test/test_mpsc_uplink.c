@@ -0,0 +1,437 @@
+/*****************************************************************************************//**
+ * @file     test_mpsc_uplink.c
+ *
+ * @author   F.Fargon
+ *
+ * @version  V1.0
+ *
+ * @date     16/10/2026
+ *
+ * @brief    Bounded MPSC uplink queue between 'LoraNodeManager' and 'LoraServerManager'.
+ *
+ * @details  The test checks the 'CMpscRing' class and the backpressure of the uplink path:\n
+ *            - Stress with several producer tasks pushing into a small queue: no item lost
+ *              or duplicated, FIFO order of each producer, one 'space available' callback
+ *              for each full episode
+ *            - Loss versus offered load of several simulated radios ('CLoraNodeSwarm'
+ *              objects with their receive ring) feeding the uplink queue drained by a
+ *              consumer of limited capacity (i.e. 'LoraServerManager'). The model runs in
+ *              virtual time and the packets are only lost at the radio rings
+*********************************************************************************************/
+
+#include <Common.h>
+
+#include "LoraTransceiverItf.h"
+#include "LoraNodeSwarmItf.h"
+#include "LoraRealtimeSenderItf.h"
+#include "TransceiverManagerItf.h"
+#include "ServerManagerItf.h"
+#include "ServerConnectorItf.h"
+#include "NetworkServerProtocolItf.h"
+#include "Utilities.h"
+#include "LoraNodeSwarm.h"
+#include "LoraNodeManager.h"
+#include "LoraServerManager.h"
+
+#include "HostTest.h"
+
+
+/*********************************************************************************************
+  Definitions
+*********************************************************************************************/
+
+// Stress: producer tasks, items pushed by each producer, queue depth and batch of consumer
+#define TEST_STRESS_PRODUCERS    4
+#define TEST_STRESS_ITEMS        200000
+#define TEST_STRESS_DEPTH        64
+#define TEST_STRESS_BATCH        8
+
+// Item of stress test: producer index (bits 24-31) and sequence number (bits 0-23, from 1)
+#define TEST_STRESS_ITEM(p, s)   ((void *) (uintptr_t) (((DWORD) (p) << 24) | (DWORD) (s)))
+#define TEST_STRESS_PRODUCER(i)  ((BYTE) ((uintptr_t) (i) >> 24))
+#define TEST_STRESS_SEQUENCE(i)  ((DWORD) ((uintptr_t) (i) & 0x00FFFFFF))
+
+// Model: simulated radios and depth of their receive ring (as configured for 'LoraNodeManager')
+#define TEST_MODEL_RADIOS        4
+#define TEST_MODEL_RING_DEPTH    8
+
+// Model: packet pool large enough for all rings and the uplink queue (i.e. uplinks only lost by
+// backpressure at the rings, never for lack of packet buffer)
+#define TEST_MODEL_PACKETS       (TEST_MODEL_RADIOS * TEST_MODEL_RING_DEPTH + LORASERVERMANAGER_UPLINK_QUEUE_DEPTH + 1)
+#define TEST_MODEL_EVENTS        32
+
+// Model: duration of each run in virtual time (microseconds)
+#define TEST_MODEL_DURATION      GATEWAY_CLOCK_MS_TO_US(3600000ULL)
+
+// Model: offered load (percent of consumer capacity)
+static const WORD g_wTestModelLoads[] = { 50, 90, 100, 125, 200 };
+#define TEST_MODEL_LOAD_NUMBER   (sizeof(g_wTestModelLoads) / sizeof(g_wTestModelLoads[0]))
+
+// Producer task of stress test
+typedef struct _TestProducer
+{
+  CMpscRing m_pQueue;
+  BYTE m_usIndex;
+  DWORD m_dwRejectedNumber;
+  SemaphoreHandle_t m_hDone;
+} TestProducerOb;
+
+// Result of a model run
+typedef struct _TestModelResult
+{
+  DWORD m_dwUplinkNumber;
+  DWORD m_dwReceivedNumber;
+  DWORD m_dwMissedNumber;
+  DWORD m_dwNotListeningNumber;
+  DWORD m_dwRingDroppedNumber;
+  DWORD m_dwConsumedNumber;
+  DWORD m_dwPendingNumber;
+  WORD m_wQueueHighWatermark;
+  DWORD m_dwQueueFullNumber;
+} TestModelResultOb;
+
+// Number of 'space available' callbacks
+static DWORD g_dwTestSpaceCallbackNumber = 0;
+
+
+/*********************************************************************************************
+  Helpers
+*********************************************************************************************/
+
+// Space available callback (context = counter of callbacks)
+static void Test_SpaceAvailable(void *pContext)
+{
+  __atomic_fetch_add((DWORD *) pContext, 1, __ATOMIC_RELAXED);
+}
+
+
+// Producer task: pushes its items in sequence order (retry while the queue is full)
+static void Test_ProducerTask(void *pParams)
+{
+  TestProducerOb *pProducer = (TestProducerOb *) pParams;
+
+  for (DWORD dwSequence = 1; dwSequence <= TEST_STRESS_ITEMS; dwSequence++)
+  {
+    while (CMpscRing_Push(pProducer->m_pQueue, TEST_STRESS_ITEM(pProducer->m_usIndex, dwSequence)) == false)
+    {
+      ++pProducer->m_dwRejectedNumber;
+      taskYIELD();
+    }
+  }
+
+  xSemaphoreGive(pProducer->m_hDone);
+  vTaskDelete(NULL);
+}
+
+
+// 'LoraNodeManager' transceiver task: moves the packets of receive rings to the uplink queue
+// The packets are left in the rings when the queue is full (see 'CLoraNodeManager_ProcessReceiveRing')
+static void Test_ProcessReceiveRings(CSpscRing *pReceiveRings, CMpscRing pUplinkQueue)
+{
+  CLoraTransceiverItf_ReceiveSlot pReceiveSlot;
+
+  for (BYTE r = 0; r < TEST_MODEL_RADIOS; r++)
+  {
+    while ((pReceiveSlot = (CLoraTransceiverItf_ReceiveSlot) CSpscRing_GetReadSlot(pReceiveRings[r])) != NULL)
+    {
+      if (CMpscRing_HasSpace(pUplinkQueue) == false)
+      {
+        return;
+      }
+      HOSTTEST_CHECK(CMpscRing_Push(pUplinkQueue, pReceiveSlot->m_pPacket) == true);
+      CSpscRing_ReleaseRead(pReceiveRings[r]);
+    }
+  }
+}
+
+
+// Runs the model for a consumer capacity (one packet every 'qwServiceInterval' microseconds, the
+// 0 value is an unlimited capacity)
+static void Test_RunModel(QWORD qwServiceInterval, TestModelResultOb *pResult)
+{
+  CLoraNodeSwarm pSwarms[TEST_MODEL_RADIOS];
+  CSpscRing pReceiveRings[TEST_MODEL_RADIOS];
+  QWORD qwNextUplinks[TEST_MODEL_RADIOS];
+  CLoraTransceiverItf_InitializeParamsOb InitializeParams;
+  CWideMemoryBlockArray pLoraPacketPool;
+  CMpscRing pUplinkQueue;
+  QueueHandle_t hEventQueue;
+  CLoraTransceiverItf_EventOb Event;
+  void *pPacket;
+  QWORD qwStart;
+  QWORD qwNow;
+  QWORD qwNextService;
+
+  memset(pResult, 0, sizeof(TestModelResultOb));
+
+  HOSTTEST_CHECK((pLoraPacketPool = CWideMemoryBlockArray_NewShared(LORANODEMANAGER_LORAPACKET_BLOCK_SIZE, TEST_MODEL_PACKETS)) != NULL);
+  HOSTTEST_CHECK((pUplinkQueue = CMpscRing_New(LORASERVERMANAGER_UPLINK_QUEUE_DEPTH)) != NULL);
+  HOSTTEST_CHECK((hEventQueue = xQueueCreate(TEST_MODEL_EVENTS, sizeof(CLoraTransceiverItf_EventOb))) != NULL);
+  if ((pLoraPacketPool == NULL) || (pUplinkQueue == NULL) || (hEventQueue == NULL))
+  {
+    return;
+  }
+
+  // Simulated radios
+  // Note: The swarm task stays idle ('m_bStarted' = false), the uplinks are emitted by the model in
+  //       virtual time with 'CLoraNodeSwarm_ProcessDevices'
+  qwStart = GATEWAY_CLOCK_MS_TO_US(1000);
+  for (BYTE r = 0; r < TEST_MODEL_RADIOS; r++)
+  {
+    HOSTTEST_CHECK((pReceiveRings[r] = CSpscRing_New(sizeof(CLoraTransceiverItf_ReceiveSlotOb), TEST_MODEL_RING_DEPTH)) != NULL);
+    HOSTTEST_CHECK((pSwarms[r] = CLoraNodeSwarm_New(0)) != NULL);
+    if ((pReceiveRings[r] == NULL) || (pSwarms[r] == NULL))
+    {
+      return;
+    }
+
+    memset(&InitializeParams, 0, sizeof(CLoraTransceiverItf_InitializeParamsOb));
+    InitializeParams.m_hEventNotifyQueue = hEventQueue;
+    InitializeParams.m_pLoraPacketPool = pLoraPacketPool;
+    InitializeParams.m_pReceiveRing = pReceiveRings[r];
+    HOSTTEST_CHECK(CLoraNodeSwarm_Initialize(pSwarms[r], &InitializeParams) == true);
+
+    xSemaphoreTake(pSwarms[r]->m_hMutex, portMAX_DELAY);
+    pSwarms[r]->m_dwRandomState = (0x9E3779B9 * (r + 1)) | 1;
+    pSwarms[r]->m_dwCurrentState = LORANODESWARM_STATE_RECEIVING;
+    CLoraNodeSwarm_StartDevices(pSwarms[r], qwStart);
+    pSwarms[r]->m_bStarted = false;
+    qwNextUplinks[r] = CLoraNodeSwarm_ProcessDevices(pSwarms[r], qwStart);
+    xSemaphoreGive(pSwarms[r]->m_hMutex);
+  }
+
+  // Events: uplinks of simulated devices and service of consumer
+  qwNextService = qwStart + qwServiceInterval;
+  for (qwNow = qwStart; qwNow < qwStart + TEST_MODEL_DURATION; )
+  {
+    for (BYTE r = 0; r < TEST_MODEL_RADIOS; r++)
+    {
+      if (qwNextUplinks[r] <= qwNow)
+      {
+        xSemaphoreTake(pSwarms[r]->m_hMutex, portMAX_DELAY);
+        qwNextUplinks[r] = CLoraNodeSwarm_ProcessDevices(pSwarms[r], qwNow);
+        xSemaphoreGive(pSwarms[r]->m_hMutex);
+      }
+    }
+
+    // The events only signal the rings (i.e. all rings processed below)
+    while (xQueueReceive(hEventQueue, &Event, 0) == pdPASS)
+    {
+    }
+    Test_ProcessReceiveRings(pReceiveRings, pUplinkQueue);
+
+    // Consumer ('LoraServerManager'): the packets are forwarded and their blocks released
+    if ((qwServiceInterval == 0) || (qwNow >= qwNextService))
+    {
+      while (CMpscRing_Pop(pUplinkQueue, &pPacket, 1) == 1)
+      {
+        CWideMemoryBlockArray_ReleaseRef(pLoraPacketPool, CWideMemoryBlockArray_BlockIndexFromPtr(pLoraPacketPool, pPacket));
+        ++pResult->m_dwConsumedNumber;
+        if (qwServiceInterval != 0)
+        {
+          break;
+        }
+      }
+      qwNextService += qwServiceInterval;
+
+      // Space available: the rings are processed again
+      Test_ProcessReceiveRings(pReceiveRings, pUplinkQueue);
+    }
+
+    // Next event
+    qwNow = qwServiceInterval != 0 ? qwNextService : LORANODESWARM_TIMESTAMP_NONE;
+    for (BYTE r = 0; r < TEST_MODEL_RADIOS; r++)
+    {
+      qwNow = qwNextUplinks[r] < qwNow ? qwNextUplinks[r] : qwNow;
+    }
+  }
+
+  // Statistics
+  for (BYTE r = 0; r < TEST_MODEL_RADIOS; r++)
+  {
+    xSemaphoreTake(pSwarms[r]->m_hMutex, portMAX_DELAY);
+    pResult->m_dwUplinkNumber += pSwarms[r]->m_Statistics.m_dwUplinkNumber;
+    pResult->m_dwReceivedNumber += pSwarms[r]->m_Statistics.m_dwReceivedNumber;
+    pResult->m_dwMissedNumber += pSwarms[r]->m_Statistics.m_dwMissedNumber;
+    pResult->m_dwNotListeningNumber += pSwarms[r]->m_Statistics.m_dwNotListeningNumber;
+    xSemaphoreGive(pSwarms[r]->m_hMutex);
+
+    pResult->m_dwRingDroppedNumber += CSpscRing_GetDroppedNumber(pReceiveRings[r]);
+    pResult->m_dwPendingNumber += CSpscRing_GetOccupancy(pReceiveRings[r]);
+  }
+  pResult->m_dwPendingNumber += CMpscRing_GetOccupancy(pUplinkQueue);
+  pResult->m_wQueueHighWatermark = CMpscRing_GetHighWatermark(pUplinkQueue);
+  pResult->m_dwQueueFullNumber = CMpscRing_GetFullNumber(pUplinkQueue);
+
+  for (BYTE r = 0; r < TEST_MODEL_RADIOS; r++)
+  {
+    CLoraNodeSwarm_Delete(pSwarms[r]);
+    CSpscRing_Delete(pReceiveRings[r]);
+  }
+  vQueueDelete(hEventQueue);
+  CMpscRing_Delete(pUplinkQueue);
+  CWideMemoryBlockArray_Delete(pLoraPacketPool);
+}
+
+
+/*********************************************************************************************
+  Test
+*********************************************************************************************/
+
+static void Test_Stress(void)
+{
+  TestProducerOb Producers[TEST_STRESS_PRODUCERS];
+  DWORD dwLastSequence[TEST_STRESS_PRODUCERS];
+  void *pItems[TEST_STRESS_BATCH];
+  CMpscRing pQueue;
+  SemaphoreHandle_t hDone;
+  DWORD dwRejectedNumber = 0;
+  DWORD dwReceivedNumber = 0;
+  DWORD dwOrderErrorNumber = 0;
+  QWORD qwStart;
+  QWORD qwDuration;
+  WORD wItemNumber;
+  BYTE usProducer;
+
+  HOSTTEST_CHECK((pQueue = CMpscRing_New(TEST_STRESS_DEPTH)) != NULL);
+  HOSTTEST_CHECK((hDone = xSemaphoreCreateCounting(TEST_STRESS_PRODUCERS, 0)) != NULL);
+  if ((pQueue == NULL) || (hDone == NULL))
+  {
+    return;
+  }
+  CMpscRing_SetSpaceCallback(pQueue, Test_SpaceAvailable, &g_dwTestSpaceCallbackNumber);
+
+  qwStart = GATEWAY_CLOCK_MICROSEC();
+  for (BYTE p = 0; p < TEST_STRESS_PRODUCERS; p++)
+  {
+    Producers[p].m_pQueue = pQueue;
+    Producers[p].m_usIndex = p;
+    Producers[p].m_dwRejectedNumber = 0;
+    Producers[p].m_hDone = hDone;
+    dwLastSequence[p] = 0;
+    HOSTTEST_CHECK(xTaskCreate(Test_ProducerTask, "MpscProducer", HOSTTEST_TASK_STACK_SIZE, &Producers[p],
+                               HOSTTEST_TASK_PRIORITY, NULL) == pdPASS);
+  }
+
+  // Consumer: batches in FIFO order for each producer
+  while (dwReceivedNumber < TEST_STRESS_PRODUCERS * TEST_STRESS_ITEMS)
+  {
+    if ((wItemNumber = CMpscRing_Pop(pQueue, pItems, TEST_STRESS_BATCH)) == 0)
+    {
+      taskYIELD();
+      continue;
+    }
+
+    for (WORD i = 0; i < wItemNumber; i++)
+    {
+      usProducer = TEST_STRESS_PRODUCER(pItems[i]);
+      if ((usProducer >= TEST_STRESS_PRODUCERS) || (TEST_STRESS_SEQUENCE(pItems[i]) != dwLastSequence[usProducer] + 1))
+      {
+        ++dwOrderErrorNumber;
+        continue;
+      }
+      dwLastSequence[usProducer] = TEST_STRESS_SEQUENCE(pItems[i]);
+    }
+    dwReceivedNumber += wItemNumber;
+  }
+  qwDuration = GATEWAY_CLOCK_MICROSEC() - qwStart;
+
+  for (BYTE p = 0; p < TEST_STRESS_PRODUCERS; p++)
+  {
+    xSemaphoreTake(hDone, portMAX_DELAY);
+  }
+  for (BYTE p = 0; p < TEST_STRESS_PRODUCERS; p++)
+  {
+    HOSTTEST_CHECK(dwLastSequence[p] == TEST_STRESS_ITEMS);
+    dwRejectedNumber += Producers[p].m_dwRejectedNumber;
+  }
+
+  HOSTTEST_CHECK(dwOrderErrorNumber == 0);
+  HOSTTEST_CHECK(dwReceivedNumber == TEST_STRESS_PRODUCERS * TEST_STRESS_ITEMS);
+  HOSTTEST_CHECK(CMpscRing_Pop(pQueue, pItems, TEST_STRESS_BATCH) == 0);
+  HOSTTEST_CHECK(CMpscRing_GetOccupancy(pQueue) == 0);
+  HOSTTEST_CHECK(CMpscRing_GetHighWatermark(pQueue) <= TEST_STRESS_DEPTH);
+  HOSTTEST_CHECK(CMpscRing_GetRejectedNumber(pQueue) == dwRejectedNumber);
+  HOSTTEST_CHECK(g_dwTestSpaceCallbackNumber == CMpscRing_GetFullNumber(pQueue));
+
+  printf("[INFO] MPSC stress: %u producers, %u items in %u us = %u items/s, high watermark: %u/%u, rejected: %u, full episodes: %u\n",
+         TEST_STRESS_PRODUCERS, (unsigned int) dwReceivedNumber, (unsigned int) qwDuration,
+         (unsigned int) ((QWORD) dwReceivedNumber * 1000000 / (qwDuration > 0 ? qwDuration : 1)),
+         (unsigned int) CMpscRing_GetHighWatermark(pQueue), TEST_STRESS_DEPTH, (unsigned int) dwRejectedNumber,
+         (unsigned int) CMpscRing_GetFullNumber(pQueue));
+
+  vSemaphoreDelete(hDone);
+  CMpscRing_Delete(pQueue);
+}
+
+
+static void Test_LossVersusLoad(void)
+{
+  TestModelResultOb Result;
+  QWORD qwServiceInterval;
+  DWORD dwOfferedNumber;
+  DWORD dwLoss;
+  DWORD dwPreviousLoss = 0;
+  DWORD dwExcess;
+
+  // Offered load: consumer without capacity limit (i.e. no loss)
+  Test_RunModel(0, &Result);
+  HOSTTEST_CHECK((Result.m_dwUplinkNumber > 0) && (Result.m_dwMissedNumber == 0) && (Result.m_dwNotListeningNumber == 0));
+  HOSTTEST_CHECK(Result.m_dwConsumedNumber == Result.m_dwReceivedNumber);
+  dwOfferedNumber = Result.m_dwUplinkNumber;
+  if (dwOfferedNumber == 0)
+  {
+    return;
+  }
+
+  printf("[INFO] Model: %u radios, ring depth: %u, queue depth: %u, offered: %u uplinks in %u s\n",
+         TEST_MODEL_RADIOS, TEST_MODEL_RING_DEPTH, LORASERVERMANAGER_UPLINK_QUEUE_DEPTH, (unsigned int) dwOfferedNumber,
+         (unsigned int) (TEST_MODEL_DURATION / 1000000));
+
+  for (DWORD i = 0; i < TEST_MODEL_LOAD_NUMBER; i++)
+  {
+    // Consumer capacity for the offered load
+    qwServiceInterval = TEST_MODEL_DURATION * g_wTestModelLoads[i] / 100 / dwOfferedNumber;
+    Test_RunModel(qwServiceInterval, &Result);
+
+    // Same arrival rate as first run (i.e. random sequence changed by the payloads of lost uplinks)
+    // The uplinks are only lost at the radio rings (i.e. never between the rings and the consumer)
+    HOSTTEST_CHECK((Result.m_dwUplinkNumber * 20 > dwOfferedNumber * 19) && (Result.m_dwUplinkNumber * 20 < dwOfferedNumber * 21));
+    HOSTTEST_CHECK(Result.m_dwNotListeningNumber == 0);
+    HOSTTEST_CHECK(Result.m_dwMissedNumber == Result.m_dwRingDroppedNumber);
+    HOSTTEST_CHECK(Result.m_dwReceivedNumber + Result.m_dwMissedNumber == Result.m_dwUplinkNumber);
+    HOSTTEST_CHECK(Result.m_dwConsumedNumber + Result.m_dwPendingNumber == Result.m_dwReceivedNumber);
+    HOSTTEST_CHECK(Result.m_wQueueHighWatermark <= LORASERVERMANAGER_UPLINK_QUEUE_DEPTH);
+
+    // Loss in 0.1 percent: null below capacity, then close to the excess over capacity
+    dwLoss = (DWORD) ((QWORD) Result.m_dwMissedNumber * 1000 / Result.m_dwUplinkNumber);
+    dwExcess = g_wTestModelLoads[i] > 100 ? 1000 - (100000 / g_wTestModelLoads[i]) : 0;
+    if (g_wTestModelLoads[i] <= 50)
+    {
+      HOSTTEST_CHECK(dwLoss == 0);
+    }
+    HOSTTEST_CHECK(dwLoss >= dwPreviousLoss);
+    HOSTTEST_CHECK(dwLoss + 10 >= dwExcess);
+    HOSTTEST_CHECK(dwLoss <= dwExcess + 30);
+    dwPreviousLoss = dwLoss;
+
+    printf("[INFO] Load %3u%%: capacity %u.%02u packets/s, loss %u.%u%% (excess %u.%u%%), queue high watermark %u, full episodes %u\n",
+           (unsigned int) g_wTestModelLoads[i], (unsigned int) (100000000 / qwServiceInterval / 100),
+           (unsigned int) (100000000 / qwServiceInterval % 100), (unsigned int) (dwLoss / 10), (unsigned int) (dwLoss % 10),
+           (unsigned int) (dwExcess / 10), (unsigned int) (dwExcess % 10), (unsigned int) Result.m_wQueueHighWatermark,
+           (unsigned int) Result.m_dwQueueFullNumber);
+  }
+}
+
+
+static void Test_MpscUplink(void)
+{
+  Test_Stress();
+  Test_LossVersusLoad();
+}
+
+
+int main(void)
+{
+  return HostTest_Run("test_mpsc_uplink", Test_MpscUplink);
+}
@@ -0,0 +1,476 @@
+/*****************************************************************************************//**
+ * @file     test_realtime_sender_index.c
+ *
+ * @author   F.Fargon
+ *
+ * @version  V1.0
+ *
+ * @date     16/10/2026
+ *
+ * @brief    'CMinHeap' and 'CHashIndex' used by 'CLoraRealtimeSender' for its queues.
+ *
+ * @details  The TX queue of 'CLoraRealtimeSender' is a 'CMinHeap' keyed by send time and its
+ *           RX windows are found with a 'CHashIndex' keyed by DevAddr. For queue sizes from 64
+ *           to 16384 items:\n
+ *            - Random insert, key update, remove and pop checked against a reference model
+ *              (i.e. smallest key found by linear scan, heap order of all entries)
+ *            - Random insert, remove and find of DevAddr checked against a reference model
+ *            - Length of bucket lists for random and consecutive DevAddr (i.e. constant time
+ *              lookup at any queue size)
+ *            - Benchmark of 'next packet' (pop and insert) and 'find RX window' versus linear
+ *              scans of the queue
+*********************************************************************************************/
+
+#include <Common.h>
+
+#include "Utilities.h"
+
+#include "HostTest.h"
+
+
+/*********************************************************************************************
+  Definitions
+*********************************************************************************************/
+
+// Queue sizes of the sweep
+static const WORD g_wTestQueueSizes[] = { 64, 256, 1024, 4096, 16384 };
+#define TEST_QUEUE_SIZE_NUMBER   (sizeof(g_wTestQueueSizes) / sizeof(WORD))
+#define TEST_MAX_QUEUE_SIZE      16384
+
+// Random operations checked against reference model (each queue size)
+#define TEST_MODEL_OPERATIONS    20000
+
+// Operations of benchmark (each queue size)
+#define TEST_BENCH_OPERATIONS    200000
+
+// Maximum length of a bucket list of 'CHashIndex'
+// Note: With random keys and one bucket per item, the longest list of 16384 buckets is about 7
+#define TEST_MAX_BUCKET_LENGTH   10
+
+// First DevAddr of consecutive addresses (i.e. same NetID, as allocated by a Network Server)
+#define TEST_DEVADDR_BASE        0x26011000
+
+// Reference model: key of each item and presence in the collection
+typedef struct _TestModel
+{
+  QWORD m_qwKeys[TEST_MAX_QUEUE_SIZE];
+  DWORD m_dwDevAddrs[TEST_MAX_QUEUE_SIZE];
+  bool m_bPresent[TEST_MAX_QUEUE_SIZE];
+  WORD m_wCount;
+} TestModelOb;
+
+static TestModelOb g_TestModel;
+
+// Result of benchmarks, prevents removal of linear scans by compiler
+static volatile DWORD g_dwTestSink;
+
+
+/*********************************************************************************************
+  Helpers
+*********************************************************************************************/
+
+// Xorshift generator (i.e. no value repeated before 2^32 - 1 values, seed MUST not be 0)
+static DWORD Test_Random(DWORD *pdwSeed)
+{
+  *pdwSeed ^= *pdwSeed << 13;
+  *pdwSeed ^= *pdwSeed >> 17;
+  *pdwSeed ^= *pdwSeed << 5;
+  return *pdwSeed;
+}
+
+
+// Send time of a downlink packet (microseconds, up to about one hour ahead)
+static QWORD Test_RandomSendTime(DWORD *pdwSeed)
+{
+  return 1000000000ULL + (Test_Random(pdwSeed) % 3600000000UL);
+}
+
+
+// Checks heap order of all entries and position of each item
+static bool Test_CheckHeapOrder(CMinHeap pHeap)
+{
+  WORD wItem;
+  WORD wParentItem;
+  QWORD qwKey;
+  QWORD qwParentKey;
+
+  for (WORD wPosition = 0; wPosition < CMinHeap_GetCount(pHeap); wPosition++)
+  {
+    CMinHeap_GetEntry(pHeap, wPosition, &wItem, &qwKey);
+    if ((pHeap->m_pPositions[wItem] != wPosition) || (qwKey != g_TestModel.m_qwKeys[wItem]))
+    {
+      return false;
+    }
+    if (wPosition > 0)
+    {
+      CMinHeap_GetEntry(pHeap, (wPosition - 1) / 2, &wParentItem, &qwParentKey);
+      if (qwParentKey > qwKey)
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+
+// Smallest key of reference model (linear scan)
+static QWORD Test_ModelMinKey(WORD wQueueSize)
+{
+  QWORD qwMinKey = 0xFFFFFFFFFFFFFFFFULL;
+
+  for (WORD i = 0; i < wQueueSize; i++)
+  {
+    if ((g_TestModel.m_bPresent[i] == true) && (g_TestModel.m_qwKeys[i] < qwMinKey))
+    {
+      qwMinKey = g_TestModel.m_qwKeys[i];
+    }
+  }
+  return qwMinKey;
+}
+
+
+// Length of longest bucket list
+static WORD Test_MaxBucketLength(CHashIndex pIndex)
+{
+  WORD wMaxLength = 0;
+  WORD wLength;
+  WORD wItem;
+
+  for (WORD wBucket = 0; wBucket < pIndex->m_wBucketNumber; wBucket++)
+  {
+    wLength = 0;
+    for (wItem = pIndex->m_pBuckets[wBucket]; wItem != HASHINDEX_NONE; wItem = pIndex->m_pNextItems[wItem])
+    {
+      ++wLength;
+    }
+    wMaxLength = MAX(wMaxLength, wLength);
+  }
+  return wMaxLength;
+}
+
+
+/*********************************************************************************************
+  Test
+*********************************************************************************************/
+
+// TX queue: random operations on a 'CMinHeap' checked against reference model
+static void Test_MinHeapModel(WORD wQueueSize)
+{
+  CMinHeap pHeap;
+  DWORD dwSeed = 0x5EED0000 + wQueueSize;
+  DWORD dwErrorNumber = 0;
+  WORD wItem;
+  QWORD qwKey;
+
+  if (HOSTTEST_CHECK((pHeap = CMinHeap_New(wQueueSize)) != NULL) == false)
+  {
+    return;
+  }
+  memset(&g_TestModel, 0, sizeof(g_TestModel));
+
+  for (DWORD dwOperation = 0; dwOperation < TEST_MODEL_OPERATIONS; dwOperation++)
+  {
+    wItem = (WORD) (Test_Random(&dwSeed) % wQueueSize);
+
+    switch (Test_Random(&dwSeed) % 4)
+    {
+      case 0:
+      case 1:
+        // Packet scheduled (or rescheduled if already in queue)
+        qwKey = Test_RandomSendTime(&dwSeed);
+        if (CMinHeap_Insert(pHeap, wItem, qwKey) == false)
+        {
+          ++dwErrorNumber;
+        }
+        g_TestModel.m_wCount += (g_TestModel.m_bPresent[wItem] == true) ? 0 : 1;
+        g_TestModel.m_bPresent[wItem] = true;
+        g_TestModel.m_qwKeys[wItem] = qwKey;
+        break;
+
+      case 2:
+        // Packet cancelled
+        if (CMinHeap_Remove(pHeap, wItem) != g_TestModel.m_bPresent[wItem])
+        {
+          ++dwErrorNumber;
+        }
+        g_TestModel.m_wCount -= (g_TestModel.m_bPresent[wItem] == true) ? 1 : 0;
+        g_TestModel.m_bPresent[wItem] = false;
+        break;
+
+      default:
+        // Next packet sent
+        if (CMinHeap_Pop(pHeap, &wItem, &qwKey) == true)
+        {
+          if ((g_TestModel.m_bPresent[wItem] == false) || (qwKey != Test_ModelMinKey(wQueueSize)))
+          {
+            ++dwErrorNumber;
+          }
+          g_TestModel.m_bPresent[wItem] = false;
+          --g_TestModel.m_wCount;
+        }
+        else if (g_TestModel.m_wCount != 0)
+        {
+          ++dwErrorNumber;
+        }
+        break;
+    }
+
+    if (CMinHeap_GetCount(pHeap) != g_TestModel.m_wCount)
+    {
+      ++dwErrorNumber;
+    }
+    if ((CMinHeap_Peek(pHeap, &wItem, &qwKey) == true) && (qwKey != Test_ModelMinKey(wQueueSize)))
+    {
+      ++dwErrorNumber;
+    }
+  }
+
+  HOSTTEST_CHECK(dwErrorNumber == 0);
+  HOSTTEST_CHECK(Test_CheckHeapOrder(pHeap) == true);
+  HOSTTEST_CHECK(CMinHeap_Insert(pHeap, wQueueSize, 0) == false);
+
+  // Queue full, then emptied in send time order
+  for (WORD i = 0; i < wQueueSize; i++)
+  {
+    g_TestModel.m_qwKeys[i] = Test_RandomSendTime(&dwSeed);
+    CMinHeap_Insert(pHeap, i, g_TestModel.m_qwKeys[i]);
+  }
+  HOSTTEST_CHECK(CMinHeap_GetCount(pHeap) == wQueueSize);
+  HOSTTEST_CHECK(Test_CheckHeapOrder(pHeap) == true);
+  qwKey = 0;
+  dwErrorNumber = 0;
+  for (WORD i = 0; i < wQueueSize; i++)
+  {
+    QWORD qwPreviousKey = qwKey;
+
+    if ((CMinHeap_Pop(pHeap, &wItem, &qwKey) == false) || (qwKey < qwPreviousKey) ||
+        (qwKey != g_TestModel.m_qwKeys[wItem]))
+    {
+      ++dwErrorNumber;
+    }
+  }
+  HOSTTEST_CHECK(dwErrorNumber == 0);
+  HOSTTEST_CHECK(CMinHeap_Peek(pHeap, &wItem, &qwKey) == false);
+
+  CMinHeap_Delete(pHeap);
+}
+
+
+// RX windows: random operations on a 'CHashIndex' checked against reference model
+static void Test_HashIndexModel(WORD wQueueSize)
+{
+  CHashIndex pIndex;
+  DWORD dwSeed = 0xADD00000 + wQueueSize;
+  DWORD dwErrorNumber = 0;
+  DWORD dwDevAddr;
+  WORD wItem;
+  WORD wMaxLength;
+
+  if (HOSTTEST_CHECK((pIndex = CHashIndex_New(wQueueSize)) != NULL) == false)
+  {
+    return;
+  }
+  memset(&g_TestModel, 0, sizeof(g_TestModel));
+
+  for (DWORD dwOperation = 0; dwOperation < TEST_MODEL_OPERATIONS; dwOperation++)
+  {
+    wItem = (WORD) (Test_Random(&dwSeed) % wQueueSize);
+
+    if (g_TestModel.m_bPresent[wItem] == false)
+    {
+      // RX windows of a node registered (DevAddr unique in model)
+      dwDevAddr = TEST_DEVADDR_BASE + (Test_Random(&dwSeed) % (4 * TEST_MAX_QUEUE_SIZE));
+      if (CHashIndex_Find(pIndex, dwDevAddr) != HASHINDEX_NONE)
+      {
+        continue;
+      }
+      if (CHashIndex_Insert(pIndex, wItem, dwDevAddr) == false)
+      {
+        ++dwErrorNumber;
+      }
+      g_TestModel.m_dwDevAddrs[wItem] = dwDevAddr;
+      g_TestModel.m_bPresent[wItem] = true;
+    }
+    else if ((Test_Random(&dwSeed) % 2) == 0)
+    {
+      // RX windows expired
+      if (CHashIndex_Remove(pIndex, wItem) == false)
+      {
+        ++dwErrorNumber;
+      }
+      if (CHashIndex_Find(pIndex, g_TestModel.m_dwDevAddrs[wItem]) != HASHINDEX_NONE)
+      {
+        ++dwErrorNumber;
+      }
+      g_TestModel.m_bPresent[wItem] = false;
+    }
+    else if (CHashIndex_Find(pIndex, g_TestModel.m_dwDevAddrs[wItem]) != wItem)
+    {
+      // Downlink for a registered node
+      ++dwErrorNumber;
+    }
+  }
+  HOSTTEST_CHECK(dwErrorNumber == 0);
+
+  // All nodes registered: random and consecutive DevAddr
+  for (WORD n = 0; n < 2; n++)
+  {
+    for (WORD i = 0; i < wQueueSize; i++)
+    {
+      if (g_TestModel.m_bPresent[i] == true)
+      {
+        CHashIndex_Remove(pIndex, i);
+      }
+    }
+    for (WORD i = 0; i < wQueueSize; i++)
+    {
+      g_TestModel.m_dwDevAddrs[i] = (n == 0) ? Test_Random(&dwSeed) : (DWORD) (TEST_DEVADDR_BASE + i);
+      CHashIndex_Insert(pIndex, i, g_TestModel.m_dwDevAddrs[i]);
+      g_TestModel.m_bPresent[i] = true;
+    }
+
+    dwErrorNumber = 0;
+    for (WORD i = 0; i < wQueueSize; i++)
+    {
+      if (CHashIndex_Find(pIndex, g_TestModel.m_dwDevAddrs[i]) != i)
+      {
+        ++dwErrorNumber;
+      }
+    }
+    HOSTTEST_CHECK(dwErrorNumber == 0);
+    HOSTTEST_CHECK((wMaxLength = Test_MaxBucketLength(pIndex)) <= TEST_MAX_BUCKET_LENGTH);
+    if (wQueueSize == TEST_MAX_QUEUE_SIZE)
+    {
+      printf("[INFO] CHashIndex %u %s DevAddr: %u buckets, longest bucket list: %u\n", (unsigned int) wQueueSize,
+             n == 0 ? "random" : "consecutive", (unsigned int) pIndex->m_wBucketNumber, (unsigned int) wMaxLength);
+    }
+  }
+
+  // Items outside of the index range rejected
+  HOSTTEST_CHECK(CHashIndex_Insert(pIndex, wQueueSize, 0xFFFFFFFF) == false);
+  HOSTTEST_CHECK(CHashIndex_Insert(pIndex, HASHINDEX_NONE, 0xFFFFFFFF) == false);
+
+  HOSTTEST_CHECK(CHashIndex_Find(pIndex, 0xFFFFFFFF) == HASHINDEX_NONE);
+  CHashIndex_Delete(pIndex);
+}
+
+
+// Time of 'next packet' and 'find RX window' with full queues, indexed versus linear scan
+static void Test_Benchmark(WORD wQueueSize)
+{
+  CMinHeap pHeap;
+  CHashIndex pIndex;
+  DWORD dwSeed = 0xBE0C0000 + wQueueSize;
+  DWORD dwOperations;
+  DWORD dwErrorNumber = 0;
+  QWORD qwStart;
+  QWORD qwHeapDuration;
+  QWORD qwHashDuration;
+  QWORD qwScanDuration;
+  QWORD qwSearchDuration;
+  QWORD qwKey;
+  WORD wItem;
+  WORD wMinItem;
+  DWORD dwDevAddr;
+
+  HOSTTEST_CHECK((pHeap = CMinHeap_New(wQueueSize)) != NULL);
+  HOSTTEST_CHECK((pIndex = CHashIndex_New(wQueueSize)) != NULL);
+  if ((pHeap == NULL) || (pIndex == NULL))
+  {
+    return;
+  }
+
+  for (WORD i = 0; i < wQueueSize; i++)
+  {
+    g_TestModel.m_qwKeys[i] = Test_RandomSendTime(&dwSeed);
+    g_TestModel.m_dwDevAddrs[i] = TEST_DEVADDR_BASE + i;
+    CMinHeap_Insert(pHeap, i, g_TestModel.m_qwKeys[i]);
+    CHashIndex_Insert(pIndex, i, g_TestModel.m_dwDevAddrs[i]);
+  }
+
+  // Linear scans are limited to keep the duration of the test short at large queue sizes
+  dwOperations = TEST_BENCH_OPERATIONS / MAX(1, wQueueSize / 64);
+
+  // Next packet: pop the earliest packet and schedule another one
+  qwStart = GATEWAY_CLOCK_MICROSEC();
+  for (DWORD i = 0; i < TEST_BENCH_OPERATIONS; i++)
+  {
+    if (CMinHeap_Pop(pHeap, &wItem, &qwKey) == false)
+    {
+      ++dwErrorNumber;
+      break;
+    }
+    CMinHeap_Insert(pHeap, wItem, qwKey + 1000000 + (i & 0xFFFF));
+  }
+  qwHeapDuration = GATEWAY_CLOCK_MICROSEC() - qwStart;
+
+  qwStart = GATEWAY_CLOCK_MICROSEC();
+  for (DWORD i = 0; i < dwOperations; i++)
+  {
+    wMinItem = 0;
+    for (WORD j = 1; j < wQueueSize; j++)
+    {
+      wMinItem = (g_TestModel.m_qwKeys[j] < g_TestModel.m_qwKeys[wMinItem]) ? j : wMinItem;
+    }
+    g_TestModel.m_qwKeys[wMinItem] += 1000000 + (i & 0xFFFF);
+  }
+  qwScanDuration = GATEWAY_CLOCK_MICROSEC() - qwStart;
+
+  // Find RX window of a node
+  qwStart = GATEWAY_CLOCK_MICROSEC();
+  for (DWORD i = 0; i < TEST_BENCH_OPERATIONS; i++)
+  {
+    dwDevAddr = TEST_DEVADDR_BASE + (Test_Random(&dwSeed) % wQueueSize);
+    if (CHashIndex_Find(pIndex, dwDevAddr) != dwDevAddr - TEST_DEVADDR_BASE)
+    {
+      ++dwErrorNumber;
+    }
+  }
+  qwHashDuration = GATEWAY_CLOCK_MICROSEC() - qwStart;
+
+  qwStart = GATEWAY_CLOCK_MICROSEC();
+  for (DWORD i = 0; i < dwOperations; i++)
+  {
+    dwDevAddr = TEST_DEVADDR_BASE + (Test_Random(&dwSeed) % wQueueSize);
+    for (wItem = 0; (wItem < wQueueSize) && (g_TestModel.m_dwDevAddrs[wItem] != dwDevAddr); wItem++)
+    {
+    }
+    g_dwTestSink += wItem;
+  }
+  qwSearchDuration = GATEWAY_CLOCK_MICROSEC() - qwStart;
+
+  HOSTTEST_CHECK(dwErrorNumber == 0);
+  HOSTTEST_CHECK(CMinHeap_GetCount(pHeap) == wQueueSize);
+
+  printf("[INFO] %5u items | next packet: heap %6u ns, scan %8u ns | find RX window: hash %6u ns, scan %8u ns\n",
+         (unsigned int) wQueueSize,
+         (unsigned int) (qwHeapDuration * 1000 / TEST_BENCH_OPERATIONS),
+         (unsigned int) (qwScanDuration * 1000 / dwOperations),
+         (unsigned int) (qwHashDuration * 1000 / TEST_BENCH_OPERATIONS),
+         (unsigned int) (qwSearchDuration * 1000 / dwOperations));
+
+  CMinHeap_Delete(pHeap);
+  CHashIndex_Delete(pIndex);
+}
+
+
+static void Test_RealtimeSenderIndex(void)
+{
+  for (DWORD i = 0; i < TEST_QUEUE_SIZE_NUMBER; i++)
+  {
+    Test_MinHeapModel(g_wTestQueueSizes[i]);
+    Test_HashIndexModel(g_wTestQueueSizes[i]);
+  }
+
+  for (DWORD i = 0; i < TEST_QUEUE_SIZE_NUMBER; i++)
+  {
+    Test_Benchmark(g_wTestQueueSizes[i]);
+  }
+}
+
+
+int main(void)
+{
+  return HostTest_Run("test_realtime_sender_index", Test_RealtimeSenderIndex);
+}
@@ -0,0 +1,458 @@
+/*****************************************************************************************//**
+ * @file     test_semtech_rxpk_stat.c
+ *
+ * @author   F.Fargon
+ *
+ * @version  V1.0
+ *
+ * @date     16/10/2026
+ *
+ * @brief    Encoding of PUSH_DATA 'rxpk' and 'stat' objects of Semtech protocol.
+ *
+ * @details  The 'rxpk' and 'stat' objects are built with 'CJsonWriter'. The test compares them
+ *           with a reference encoder using 'sprintf' (i.e. the encoding of the previous
+ *           implementation) and checks:\n
+ *            - Byte identity of 'rxpk' for all payload sizes (0 to 255 bytes), UTC times
+ *              from 1970 to 2106 and limits of 'tmst' and microseconds
+ *            - Byte identity of 'stat' for limits of counters and all ACK ratios up to 200
+ *              uplink messages (i.e. rounding of 'ackr' to one decimal)
+ *            - Halfway cases of 'ackr' rounded to even digit with the exact ratio (i.e. not
+ *              the binary value of 'double' used by the reference encoder)
+ *            - Streams rejected when the buffer is one byte too short, accepted when the
+ *              buffer has the exact length
+ *            - Benchmark of encoded objects per second versus reference encoder
+*********************************************************************************************/
+
+#include <Common.h>
+
+#include "NetworkServerProtocolItf.h"
+#include "TransceiverManagerItf.h"
+#include "SemtechProtocolEngine.h"
+
+#include "HostTest.h"
+
+
+/*********************************************************************************************
+  Definitions
+*********************************************************************************************/
+
+// Size of stream buffers
+#define TEST_STREAM_SIZE         1024
+
+// Number of random UTC times for 'rxpk'
+#define TEST_RXPK_TIMES          2000
+
+// Highest number of uplink messages for 'ackr' sweep
+#define TEST_STAT_MAX_UPNB       200
+
+// Encoded objects for benchmark
+#define TEST_BENCH_OBJECTS       200000
+
+// Payload size of 'rxpk' for benchmark
+#define TEST_BENCH_PAYLOAD_SIZE  51
+
+// Received packet (payload of maximum size)
+typedef struct _TestLoraPacket
+{
+  CLoraTransceiverItf_LoraPacketOb m_Packet;
+  BYTE m_usData[LORA_MAX_PAYLOAD_LENGTH];
+} TestLoraPacketOb;
+
+// Text fields of received packet information
+typedef struct _TestPacketInfo
+{
+  const char *m_pszFrequency;
+  const char *m_pszDataRate;
+  const char *m_pszCodingRate;
+  const char *m_pszSNR;
+  const char *m_pszRSSI;
+} TestPacketInfoOb;
+
+static const TestPacketInfoOb g_TestPacketInfoTable[] =
+{
+  { "868.1",   "SF7BW125",  "4/5", "9.5",    "-35" },
+  { "868.525", "SF12BW125", "4/8", "-20.0",  "-128" },
+  { "867.9",   "SF9BW250",  "4/6", "0.0",    "0" },
+  { "869.525", "SF12BW500", "4/7", "-7.25",  "-100" },
+};
+#define TEST_PACKETINFO_NUMBER   (sizeof(g_TestPacketInfoTable) / sizeof(TestPacketInfoOb))
+
+// Stream buffers
+static BYTE g_usTestStream[TEST_STREAM_SIZE];
+static BYTE g_usTestReference[TEST_STREAM_SIZE];
+
+
+/*********************************************************************************************
+  Helpers
+*********************************************************************************************/
+
+// Reference 'rxpk' encoder (sprintf implementation)
+// Returns the length of the stream
+static WORD Test_ReferenceRxpk(BYTE *pStreamData, CLoraTransceiverItf_LoraPacket pLoraPacket,
+                               CLoraTransceiverItf_ReceivedLoraPacketInfo pPacketInfo)
+{
+  struct tm *tmTime;
+  time_t timePacket = pPacketInfo->m_dwUTCSec;
+  int nLength;
+  WORD wBase64Length;
+
+  tmTime = gmtime(&timePacket);
+  nLength = sprintf((char *) pStreamData, "{\"tmst\":%u,\"time\":\"%04i-%02i-%02iT%02i:%02i:%02i.%06liZ\","
+                    "\"freq\":%s,\"modu\":\"LORA\",\"datr\":\"%s\",\"codr\":\"%s\",\"lsnr\":%s,\"rssi\":%s,"
+                    "\"size\":%u,\"chan\":0,\"rfch\":0,\"stat\":1,\"data\":\"",
+                    (unsigned int) (DWORD) pLoraPacket->m_qwTimestamp, (tmTime->tm_year) + 1900, (tmTime->tm_mon) + 1,
+                    tmTime->tm_mday, tmTime->tm_hour, tmTime->tm_min, tmTime->tm_sec,
+                    (long int) pPacketInfo->m_dwUTCMicroSec, (char *) pPacketInfo->m_szFrequency,
+                    (char *) pPacketInfo->m_szDataRate, (char *) pPacketInfo->m_szCodingRate,
+                    (char *) pPacketInfo->m_szSNR, (char *) pPacketInfo->m_szRSSI,
+                    (unsigned int) pLoraPacket->m_dwDataSize);
+
+  wBase64Length = Base64_BinToB64(pLoraPacket->m_usData, pLoraPacket->m_dwDataSize, pStreamData + nLength,
+                                  (WORD) (TEST_STREAM_SIZE - nLength));
+  nLength += wBase64Length;
+  pStreamData[nLength++] = '"';
+  pStreamData[nLength++] = '}';
+  return (WORD) nLength;
+}
+
+
+// Reference 'stat' encoder (sprintf implementation)
+// Returns the length of the stream
+static WORD Test_ReferenceStat(CSemtechProtocolEngine *pEngine, BYTE *pStreamData, time_t timeNow)
+{
+  struct tm *tmTime;
+  double dAckRatio;
+
+  if (pEngine->m_dwUpnbCount == 0)
+  {
+    dAckRatio = 100;
+  }
+  else
+  {
+    dAckRatio = ((double) pEngine->m_dwAckrCount * 100) / pEngine->m_dwUpnbCount;
+  }
+
+  tmTime = gmtime(&timeNow);
+  return (WORD) sprintf((char *) pStreamData, "{\"stat\":{\"time\":\"%04i-%02i-%02i %02i:%02i:%02i GMT\","
+                        "\"lati\":%.*s,\"long\":%.*s,\"alti\":%.*s,\"rxnb\":%u,\"rxok\":%u,\"rxfw\":%u,"
+                        "\"ackr\":%.1f,\"dwnb\":%u,\"txnb\":%u}}",
+                        (tmTime->tm_year) + 1900, (tmTime->tm_mon) + 1, tmTime->tm_mday, tmTime->tm_hour,
+                        tmTime->tm_min, tmTime->tm_sec,
+                        (int) pEngine->m_wGatewayLatitudeLength, (char *) pEngine->m_strGatewayLatitude,
+                        (int) pEngine->m_wGatewayLongitudeLength, (char *) pEngine->m_strGatewayLongitude,
+                        (int) pEngine->m_wGatewayAltitudeLength, (char *) pEngine->m_strGatewayAltitude,
+                        (unsigned int) pEngine->m_dwRxnbCount, (unsigned int) pEngine->m_dwRxokCount,
+                        (unsigned int) pEngine->m_dwRxfwCount, dAckRatio, (unsigned int) pEngine->m_dwDwnbCount,
+                        (unsigned int) pEngine->m_dwTxnbCount);
+}
+
+
+static void Test_SetPacketInfo(CLoraTransceiverItf_ReceivedLoraPacketInfo pPacketInfo, const TestPacketInfoOb *pText)
+{
+  strcpy((char *) pPacketInfo->m_szFrequency, pText->m_pszFrequency);
+  strcpy((char *) pPacketInfo->m_szDataRate, pText->m_pszDataRate);
+  strcpy((char *) pPacketInfo->m_szCodingRate, pText->m_pszCodingRate);
+  strcpy((char *) pPacketInfo->m_szSNR, pText->m_pszSNR);
+  strcpy((char *) pPacketInfo->m_szRSSI, pText->m_pszRSSI);
+}
+
+
+// Encodes one 'stat' object and checks the 'ackr' field
+static bool Test_CheckAckr(CSemtechProtocolEngine *pEngine, DWORD dwUpnb, DWORD dwAckr, const char *pszExpected)
+{
+  BYTE *pEnd;
+  char szExpected[32];
+
+  pEngine->m_dwUpnbCount = dwUpnb;
+  pEngine->m_dwAckrCount = dwAckr;
+  if ((pEnd = CSemtechProtocolEngine_GetStatStream(pEngine, g_usTestStream, g_usTestStream + TEST_STREAM_SIZE)) == NULL)
+  {
+    return false;
+  }
+  *pEnd = 0;
+  sprintf(szExpected, "\"ackr\":%s,", pszExpected);
+  if (strstr((char *) g_usTestStream, szExpected) == NULL)
+  {
+    printf("[ERROR] ackr differs for %u/%u, expected %s:\n  %s\n", (unsigned int) dwAckr, (unsigned int) dwUpnb,
+           pszExpected, (char *) g_usTestStream);
+    return false;
+  }
+  return true;
+}
+
+
+// Encodes one 'rxpk' object and compares it with the reference encoding
+// The object is also encoded in a buffer of exact length and in a buffer one byte too short
+static bool Test_CheckRxpk(CSemtechProtocolEngine *pEngine, CLoraTransceiverItf_LoraPacket pLoraPacket,
+                           CLoraTransceiverItf_ReceivedLoraPacketInfo pPacketInfo)
+{
+  WORD wLength = Test_ReferenceRxpk(g_usTestReference, pLoraPacket, pPacketInfo);
+  BYTE *pEnd;
+
+  pEnd = CSemtechProtocolEngine_GetRxpkStream(pEngine, g_usTestStream, g_usTestStream + TEST_STREAM_SIZE,
+                                              pLoraPacket, pPacketInfo);
+  if ((pEnd != g_usTestStream + wLength) || (memcmp(g_usTestStream, g_usTestReference, wLength) != 0))
+  {
+    printf("[ERROR] rxpk differs from reference:\n  %.*s\n  %.*s\n", (int) wLength, (char *) g_usTestReference,
+           pEnd == NULL ? 0 : (int) (pEnd - g_usTestStream), (char *) g_usTestStream);
+    return false;
+  }
+
+  return (CSemtechProtocolEngine_GetRxpkStream(pEngine, g_usTestStream, g_usTestStream + wLength, pLoraPacket,
+                                               pPacketInfo) == g_usTestStream + wLength) &&
+         (CSemtechProtocolEngine_GetRxpkStream(pEngine, g_usTestStream, g_usTestStream + wLength - 1, pLoraPacket,
+                                               pPacketInfo) == NULL);
+}
+
+
+// Encodes the 'stat' object and compares it with the reference encoding
+// Note: The reference encoding is retried when the second of 'time' changes during the check
+static bool Test_CheckStat(CSemtechProtocolEngine *pEngine)
+{
+  time_t timeBefore;
+  time_t timeAfter;
+  WORD wLength;
+  BYTE *pEnd;
+
+  do
+  {
+    timeBefore = time(NULL);
+    pEnd = CSemtechProtocolEngine_GetStatStream(pEngine, g_usTestStream, g_usTestStream + TEST_STREAM_SIZE);
+    wLength = Test_ReferenceStat(pEngine, g_usTestReference, timeBefore);
+    timeAfter = time(NULL);
+  } while (timeAfter != timeBefore);
+
+  if ((pEnd != g_usTestStream + wLength) || (memcmp(g_usTestStream, g_usTestReference, wLength) != 0))
+  {
+    printf("[ERROR] stat differs from reference:\n  %.*s\n  %.*s\n", (int) wLength, (char *) g_usTestReference,
+           pEnd == NULL ? 0 : (int) (pEnd - g_usTestStream), (char *) g_usTestStream);
+    return false;
+  }
+
+  return (CSemtechProtocolEngine_GetStatStream(pEngine, g_usTestStream, g_usTestStream + wLength) ==
+          g_usTestStream + wLength) &&
+         (CSemtechProtocolEngine_GetStatStream(pEngine, g_usTestStream, g_usTestStream + wLength - 1) == NULL);
+}
+
+
+/*********************************************************************************************
+  Test
+*********************************************************************************************/
+
+static void Test_Rxpk(CSemtechProtocolEngine *pEngine, TestLoraPacketOb *pPacket)
+{
+  CLoraTransceiverItf_ReceivedLoraPacketInfoOb PacketInfo;
+  DWORD dwSeed = 0x52584B;
+  DWORD dwErrorNumber = 0;
+  DWORD dwTimeErrorNumber = 0;
+
+  // All payload sizes
+  for (WORD wSize = 0; wSize <= LORA_MAX_PAYLOAD_LENGTH; wSize++)
+  {
+    Test_SetPacketInfo(&PacketInfo, &g_TestPacketInfoTable[wSize % TEST_PACKETINFO_NUMBER]);
+    PacketInfo.m_dwUTCSec = 1792108800 + wSize;
+    PacketInfo.m_dwUTCMicroSec = (wSize * 3907) % 1000000;
+    pPacket->m_Packet.m_qwTimestamp = 0x100000000ULL * wSize + wSize * 16843009U;
+    pPacket->m_Packet.m_dwDataSize = wSize;
+    HostTest_FillRandom(pPacket->m_usData, wSize, &dwSeed);
+
+    if (Test_CheckRxpk(pEngine, &pPacket->m_Packet, &PacketInfo) == false)
+    {
+      ++dwErrorNumber;
+    }
+  }
+  HOSTTEST_CHECK(dwErrorNumber == 0);
+
+  // UTC times from 1970 to 2106, limits of 'tmst' and microseconds
+  pPacket->m_Packet.m_dwDataSize = 13;
+  for (DWORD i = 0; i < TEST_RXPK_TIMES + 4; i++)
+  {
+    Test_SetPacketInfo(&PacketInfo, &g_TestPacketInfoTable[i % TEST_PACKETINFO_NUMBER]);
+    switch (i)
+    {
+      case 0:
+        PacketInfo.m_dwUTCSec = 0;
+        PacketInfo.m_dwUTCMicroSec = 0;
+        pPacket->m_Packet.m_qwTimestamp = 0;
+        break;
+
+      case 1:
+        PacketInfo.m_dwUTCSec = 0xFFFFFFFF;
+        PacketInfo.m_dwUTCMicroSec = 999999;
+        pPacket->m_Packet.m_qwTimestamp = 0xFFFFFFFF;
+        break;
+
+      case 2:
+        // Leap day
+        PacketInfo.m_dwUTCSec = 1709164799;
+        PacketInfo.m_dwUTCMicroSec = 1;
+        pPacket->m_Packet.m_qwTimestamp = 0xFFFFFFFFFFFFFFFFULL;
+        break;
+
+      case 3:
+        // Same second as previous packet (i.e. cached date and time)
+        PacketInfo.m_dwUTCSec = 1709164799;
+        PacketInfo.m_dwUTCMicroSec = 500000;
+        break;
+
+      default:
+        HostTest_FillRandom((BYTE *) &PacketInfo.m_dwUTCSec, sizeof(DWORD), &dwSeed);
+        HostTest_FillRandom((BYTE *) &pPacket->m_Packet.m_qwTimestamp, sizeof(QWORD), &dwSeed);
+        PacketInfo.m_dwUTCMicroSec = (i * 7919) % 1000000;
+        break;
+    }
+
+    if (Test_CheckRxpk(pEngine, &pPacket->m_Packet, &PacketInfo) == false)
+    {
+      ++dwTimeErrorNumber;
+    }
+  }
+  HOSTTEST_CHECK(dwTimeErrorNumber == 0);
+}
+
+
+static void Test_Stat(CSemtechProtocolEngine *pEngine)
+{
+  DWORD dwErrorNumber = 0;
+  DWORD dwAckrErrorNumber = 0;
+
+  // Limits of counters
+  for (DWORD i = 0; i < 3; i++)
+  {
+    pEngine->m_dwRxnbCount = (i == 0) ? 0 : (i == 1) ? 0xFFFFFFFF : 1234567;
+    pEngine->m_dwRxokCount = (i == 0) ? 0 : (i == 1) ? 0xFFFFFFFF : 1234560;
+    pEngine->m_dwRxfwCount = (i == 0) ? 0 : (i == 1) ? 0xFFFFFFFF : 1234000;
+    pEngine->m_dwDwnbCount = (i == 0) ? 0 : (i == 1) ? 0xFFFFFFFF : 10;
+    pEngine->m_dwTxnbCount = (i == 0) ? 0 : (i == 1) ? 0xFFFFFFFF : 9;
+    pEngine->m_dwUpnbCount = (i == 0) ? 0 : (i == 1) ? 0xFFFFFFFF : 4000000000U;
+    pEngine->m_dwAckrCount = (i == 0) ? 0 : (i == 1) ? 0xFFFFFFFF : 3999999999U;
+
+    if (Test_CheckStat(pEngine) == false)
+    {
+      ++dwErrorNumber;
+    }
+  }
+  HOSTTEST_CHECK(dwErrorNumber == 0);
+
+  // All ACK ratios (i.e. halfway cases of rounding to one decimal)
+  // Note: Up to 200 uplink messages, the halfway ratios are exact in binary (i.e. 'x.x25' or
+  //       'x.x75'), the reference encoder rounds them to even digit too
+  for (DWORD dwUpnb = 1; dwUpnb <= TEST_STAT_MAX_UPNB; dwUpnb++)
+  {
+    for (DWORD dwAckr = 0; dwAckr <= dwUpnb; dwAckr++)
+    {
+      pEngine->m_dwUpnbCount = dwUpnb;
+      pEngine->m_dwAckrCount = dwAckr;
+      if (Test_CheckStat(pEngine) == false)
+      {
+        ++dwAckrErrorNumber;
+      }
+    }
+  }
+  HOSTTEST_CHECK(dwAckrErrorNumber == 0);
+
+  // Halfway ratios not exact in binary (i.e. '%.1f' of 'double' rounds 0.05 up and 0.15 down)
+  HOSTTEST_CHECK(Test_CheckAckr(pEngine, 2000, 1, "0.0"));
+  HOSTTEST_CHECK(Test_CheckAckr(pEngine, 2000, 3, "0.2"));
+  HOSTTEST_CHECK(Test_CheckAckr(pEngine, 2000, 1997, "99.8"));
+  HOSTTEST_CHECK(Test_CheckAckr(pEngine, 2000, 1999, "100.0"));
+  HOSTTEST_CHECK(Test_CheckAckr(pEngine, 4000000000U, 2000000, "0.0"));
+  HOSTTEST_CHECK(Test_CheckAckr(pEngine, 4000000000U, 6000000, "0.2"));
+}
+
+
+static void Test_Benchmark(CSemtechProtocolEngine *pEngine, TestLoraPacketOb *pPacket)
+{
+  CLoraTransceiverItf_ReceivedLoraPacketInfoOb PacketInfo;
+  DWORD dwSeed = 0xBE4C;
+  DWORD dwErrorNumber = 0;
+  QWORD qwStart;
+  QWORD qwDurations[4];
+
+  Test_SetPacketInfo(&PacketInfo, &g_TestPacketInfoTable[0]);
+  PacketInfo.m_dwUTCSec = 1792108800;
+  PacketInfo.m_dwUTCMicroSec = 0;
+  pPacket->m_Packet.m_qwTimestamp = 0;
+  pPacket->m_Packet.m_dwDataSize = TEST_BENCH_PAYLOAD_SIZE;
+  HostTest_FillRandom(pPacket->m_usData, TEST_BENCH_PAYLOAD_SIZE, &dwSeed);
+  pEngine->m_dwUpnbCount = 1234;
+  pEngine->m_dwAckrCount = 1200;
+
+  // 'rxpk' of packets received at 10 ms intervals (i.e. same UTC second for 100 packets)
+  qwStart = GATEWAY_CLOCK_MICROSEC();
+  for (DWORD i = 0; i < TEST_BENCH_OBJECTS; i++)
+  {
+    PacketInfo.m_dwUTCSec = 1792108800 + (i / 100);
+    PacketInfo.m_dwUTCMicroSec = (i % 100) * 10000;
+    pPacket->m_Packet.m_qwTimestamp += 10000;
+    if (CSemtechProtocolEngine_GetRxpkStream(pEngine, g_usTestStream, g_usTestStream + TEST_STREAM_SIZE,
+                                             &pPacket->m_Packet, &PacketInfo) == NULL)
+    {
+      ++dwErrorNumber;
+    }
+  }
+  qwDurations[0] = GATEWAY_CLOCK_MICROSEC() - qwStart;
+
+  qwStart = GATEWAY_CLOCK_MICROSEC();
+  for (DWORD i = 0; i < TEST_BENCH_OBJECTS; i++)
+  {
+    PacketInfo.m_dwUTCSec = 1792108800 + (i / 100);
+    PacketInfo.m_dwUTCMicroSec = (i % 100) * 10000;
+    pPacket->m_Packet.m_qwTimestamp += 10000;
+    Test_ReferenceRxpk(g_usTestReference, &pPacket->m_Packet, &PacketInfo);
+  }
+  qwDurations[1] = GATEWAY_CLOCK_MICROSEC() - qwStart;
+
+  // 'stat'
+  qwStart = GATEWAY_CLOCK_MICROSEC();
+  for (DWORD i = 0; i < TEST_BENCH_OBJECTS; i++)
+  {
+    ++pEngine->m_dwRxnbCount;
+    if (CSemtechProtocolEngine_GetStatStream(pEngine, g_usTestStream, g_usTestStream + TEST_STREAM_SIZE) == NULL)
+    {
+      ++dwErrorNumber;
+    }
+  }
+  qwDurations[2] = GATEWAY_CLOCK_MICROSEC() - qwStart;
+
+  qwStart = GATEWAY_CLOCK_MICROSEC();
+  for (DWORD i = 0; i < TEST_BENCH_OBJECTS; i++)
+  {
+    ++pEngine->m_dwRxnbCount;
+    Test_ReferenceStat(pEngine, g_usTestReference, time(NULL));
+  }
+  qwDurations[3] = GATEWAY_CLOCK_MICROSEC() - qwStart;
+
+  HOSTTEST_CHECK(dwErrorNumber == 0);
+
+  printf("[INFO] rxpk (%u bytes payload): CJsonWriter %u ns, sprintf %u ns\n", TEST_BENCH_PAYLOAD_SIZE,
+         (unsigned int) (qwDurations[0] * 1000 / TEST_BENCH_OBJECTS),
+         (unsigned int) (qwDurations[1] * 1000 / TEST_BENCH_OBJECTS));
+  printf("[INFO] stat: CJsonWriter %u ns, sprintf %u ns\n",
+         (unsigned int) (qwDurations[2] * 1000 / TEST_BENCH_OBJECTS),
+         (unsigned int) (qwDurations[3] * 1000 / TEST_BENCH_OBJECTS));
+}
+
+
+static void Test_SemtechRxpkStat(void)
+{
+  CSemtechProtocolEngine *pEngine;
+  static TestLoraPacketOb s_Packet;
+
+  if (HOSTTEST_CHECK((pEngine = CSemtechProtocolEngine_New()) != NULL) == false)
+  {
+    return;
+  }
+
+  Test_Rxpk(pEngine, &s_Packet);
+  Test_Stat(pEngine);
+  Test_Benchmark(pEngine, &s_Packet);
+
+  CSemtechProtocolEngine_Delete(pEngine);
+}
+
+
+int main(void)
+{
+  return HostTest_Run("test_semtech_rxpk_stat", Test_SemtechRxpkStat);
+}
@@ -0,0 +1,284 @@
+/*****************************************************************************************//**
+ * @file     test_semtech_timer_wheel.c
+ *
+ * @author   F.Fargon
+ *
+ * @version  V1.0
+ *
+ * @date     16/10/2026
+ *
+ * @brief    ACK timeout of uplink transactions in 'CSemtechProtocolEngine' (timer wheel).
+ *
+ * @details  The test drives 'CSemtechProtocolEngine_ProcessServerMessage' and
+ *           'CSemtechProtocolEngine_GetExpiredSession' like 'CLoraServerManager' while the
+ *           RTOS tick counter wraps (i.e. 'configINITIAL_TICK_COUNT' in host FreeRTOSConfig.h):\n
+ *            - PUSH_DATA transactions sent before the wrap with ACK timeouts before and after
+ *              the wrap
+ *            - ACK received in time (no expiry), ACK dropped (one expiry) and ACK received
+ *              after expiry (one expiry and one late ACK)
+ *            - Expiry reported in the timer wheel slot of the timeout (i.e. not delayed by the
+ *              wrap)
+ *            - 'm_dwAckLostCount' and 'm_dwAckLateCount' counters
+*********************************************************************************************/
+
+#include <Common.h>
+
+#include "NetworkServerProtocolItf.h"
+#include "TransceiverManagerItf.h"
+#include "SemtechProtocolEngine.h"
+
+// Configuration of engine (i.e. 'CONFIG_SEMTECH_ACK_TIMEOUT')
+#define SEMTECHPROTOCOLENGINE_IMPL
+#include "Configuration.h"
+
+#include "HostTest.h"
+
+
+/*********************************************************************************************
+  Definitions
+*********************************************************************************************/
+
+// Size of buffer for PUSH_DATA message
+#define TEST_MESSAGE_SIZE        512
+
+// Transactions (i.e. all transactions of the engine), first one sent 3 seconds before the wrap
+#define TEST_TRANSACTIONS        SEMTECHPROTOCOLENGINE_MAX_TRANSACTIONS
+#define TEST_FIRST_SEND          3000
+#define TEST_SEND_PERIOD         100
+
+// End of test (after the first send)
+#define TEST_DURATION            6000
+
+// ACK of transactions (delay after send)
+//  - TEST_ACK_IN_TIME and TEST_ACK_LAST_MOMENT = received before 'CONFIG_SEMTECH_ACK_TIMEOUT'
+//  - TEST_ACK_DROPPED = never received
+//  - TEST_ACK_LATE = received after expiry of transaction
+#define TEST_ACK_IN_TIME         0
+#define TEST_ACK_DROPPED         1
+#define TEST_ACK_LATE            2
+#define TEST_ACK_LAST_MOMENT     3
+
+static const DWORD g_TestAckDelay[] = { 500, 0xFFFFFFFF, CONFIG_SEMTECH_ACK_TIMEOUT + 1000, CONFIG_SEMTECH_ACK_TIMEOUT - 500 };
+
+// Transaction of the test (i.e. session of 'CLoraServerManager')
+typedef struct _TestTransaction
+{
+  DWORD m_dwAck;
+  TickType_t m_dwSendTicks;
+  DWORD m_dwProtocolMessageId;
+  WORD m_wToken;
+  bool m_bSent;
+  bool m_bAckSent;
+  DWORD m_dwExpiredNumber;
+  TickType_t m_dwExpiredTicks;
+  DWORD m_dwAckResult;
+} TestTransactionOb;
+
+
+/*********************************************************************************************
+  Helpers
+*********************************************************************************************/
+
+// Builds and sends the PUSH_DATA message of a transaction ('stat' message)
+static void Test_SendMessage(CSemtechProtocolEngine *pEngine, TestTransactionOb *pTransaction, WORD wIndex, BYTE *pMessage)
+{
+  CNetworkServerProtocol_BuildUplinkMessageParamsOb BuildParams;
+  CNetworkServerProtocol_ProcessSessionEventParamsOb EventParams;
+
+  memset(&BuildParams, 0, sizeof(BuildParams));
+  BuildParams.m_wMessageType = NETWORKSERVERPROTOCOL_UPLINKMSG_HEARTBEAT;
+  BuildParams.m_wServerManagerMessageId = wIndex;
+  BuildParams.m_bForceHeartbeat = true;
+  BuildParams.m_wMaxMessageLength = TEST_MESSAGE_SIZE;
+  BuildParams.m_pMessageData = pMessage;
+  if (HOSTTEST_CHECK(CSemtechProtocolEngine_BuildUplinkMessage(pEngine, &BuildParams) == true) == false)
+  {
+    return;
+  }
+  HOSTTEST_CHECK((BuildParams.m_dwProtocolMessageId >> 16) == wIndex);
+
+  pTransaction->m_dwProtocolMessageId = BuildParams.m_dwProtocolMessageId;
+  pTransaction->m_wToken = *((WORD *) (pMessage + 1));
+  pTransaction->m_dwSendTicks = xTaskGetTickCount();
+  pTransaction->m_bSent = true;
+
+  // Message sent by 'ServerConnector' (i.e. timer started)
+  EventParams.m_wSessionEvent = NETWORKSERVERPROTOCOL_SESSIONEVENT_SENT;
+  EventParams.m_dwProtocolMessageId = pTransaction->m_dwProtocolMessageId;
+  HOSTTEST_CHECK(CSemtechProtocolEngine_ProcessSessionEvent(pEngine, &EventParams) == NETWORKSERVERPROTOCOL_UPLINKSESSIONEVENT_PROGRESSING);
+}
+
+// Processes the PUSH_ACK message of a transaction (released by owner when terminated)
+static void Test_ReceiveAck(CSemtechProtocolEngine *pEngine, TestTransactionOb *pTransaction)
+{
+  CNetworkServerProtocol_ProcessServerMessageParamsOb Params;
+  CNetworkServerProtocol_ProcessSessionEventParamsOb EventParams;
+  BYTE Message[4];
+
+  Message[0] = SEMTECHPROTOCOLENGINE_SEMTECH_PROTOCOL_VERSION;
+  memcpy(Message + 1, &pTransaction->m_wToken, 2);
+  Message[3] = SEMTECHPROTOCOLENGINE_SEMTECH_MESSAGE_PUSH_ACK;
+
+  memset(&Params, 0, sizeof(Params));
+  Params.m_pMessageData = Message;
+  Params.m_wMessageLength = sizeof(Message);
+  pTransaction->m_dwAckResult = CSemtechProtocolEngine_ProcessServerMessage(pEngine, &Params);
+  pTransaction->m_bAckSent = true;
+
+  if (pTransaction->m_dwAckResult == NETWORKSERVERPROTOCOL_UPLINKSESSIONEVENT_TERMINATED)
+  {
+    HOSTTEST_CHECK(Params.m_dwProtocolMessageId == pTransaction->m_dwProtocolMessageId);
+    EventParams.m_wSessionEvent = NETWORKSERVERPROTOCOL_SESSIONEVENT_RELEASED;
+    EventParams.m_dwProtocolMessageId = pTransaction->m_dwProtocolMessageId;
+    CSemtechProtocolEngine_ProcessSessionEvent(pEngine, &EventParams);
+  }
+}
+
+// Terminates the expired sessions (released by owner)
+static void Test_ProcessExpiredSessions(CSemtechProtocolEngine *pEngine, TestTransactionOb *pTransactions)
+{
+  CNetworkServerProtocol_GetExpiredSessionParamsOb Params;
+  CNetworkServerProtocol_ProcessSessionEventParamsOb EventParams;
+  TestTransactionOb *pTransaction;
+  WORD wIndex;
+
+  while (CSemtechProtocolEngine_GetExpiredSession(pEngine, &Params) == true)
+  {
+    wIndex = (WORD) (Params.m_dwProtocolMessageId >> 16);
+    if (HOSTTEST_CHECK(wIndex < TEST_TRANSACTIONS) == false)
+    {
+      return;
+    }
+    pTransaction = &pTransactions[wIndex];
+    HOSTTEST_CHECK(pTransaction->m_dwProtocolMessageId == Params.m_dwProtocolMessageId);
+    if (++pTransaction->m_dwExpiredNumber == 1)
+    {
+      pTransaction->m_dwExpiredTicks = xTaskGetTickCount();
+    }
+
+    EventParams.m_wSessionEvent = NETWORKSERVERPROTOCOL_SESSIONEVENT_RELEASED;
+    EventParams.m_dwProtocolMessageId = Params.m_dwProtocolMessageId;
+    CSemtechProtocolEngine_ProcessSessionEvent(pEngine, &EventParams);
+  }
+}
+
+
+/*********************************************************************************************
+  Test
+*********************************************************************************************/
+
+static void Test_SemtechTimerWheel(void)
+{
+  static TestTransactionOb s_Transactions[TEST_TRANSACTIONS];
+  CSemtechProtocolEngine *pEngine;
+  TestTransactionOb *pTransaction;
+  BYTE *pMessage;
+  TickType_t dwStartTicks;
+  TickType_t dwElapsedTicks;
+  DWORD dwExpiryDelay;
+  DWORD dwLostNumber = 0;
+  DWORD dwLateNumber = 0;
+  bool bWrapped = false;
+
+  // The first message is sent 'TEST_FIRST_SEND' before the wrap of tick counter
+  dwStartTicks = (TickType_t) (0 - pdMS_TO_TICKS(TEST_FIRST_SEND));
+  if (HOSTTEST_CHECK((int32_t) (dwStartTicks - xTaskGetTickCount()) > 0) == false)
+  {
+    printf("[ERROR] Test started after the tick wrap (check 'configINITIAL_TICK_COUNT'), ticks: %u\n",
+           (unsigned int) xTaskGetTickCount());
+    return;
+  }
+
+  HOSTTEST_CHECK((pEngine = CSemtechProtocolEngine_New()) != NULL);
+  HOSTTEST_CHECK((pMessage = pvPortMalloc(TEST_MESSAGE_SIZE)) != NULL);
+  if ((pEngine == NULL) || (pMessage == NULL))
+  {
+    return;
+  }
+
+  for (WORD i = 0; i < TEST_TRANSACTIONS; i++)
+  {
+    memset(&s_Transactions[i], 0, sizeof(TestTransactionOb));
+    s_Transactions[i].m_dwAck = i % (sizeof(g_TestAckDelay) / sizeof(g_TestAckDelay[0]));
+  }
+
+  while ((int32_t) (xTaskGetTickCount() - dwStartTicks) < 0)
+  {
+    Test_ProcessExpiredSessions(pEngine, s_Transactions);
+    vTaskDelay(1);
+  }
+
+  // Transactions, ACK and expiry (checked each tick)
+  while ((dwElapsedTicks = xTaskGetTickCount() - dwStartTicks) < pdMS_TO_TICKS(TEST_DURATION))
+  {
+    bWrapped = bWrapped || (xTaskGetTickCount() < dwStartTicks);
+
+    for (WORD i = 0; i < TEST_TRANSACTIONS; i++)
+    {
+      pTransaction = &s_Transactions[i];
+      if ((pTransaction->m_bSent == false) && (dwElapsedTicks >= pdMS_TO_TICKS(i * TEST_SEND_PERIOD)))
+      {
+        Test_SendMessage(pEngine, pTransaction, i, pMessage);
+      }
+      else if ((pTransaction->m_bSent == true) && (pTransaction->m_bAckSent == false) &&
+               (pTransaction->m_dwAck != TEST_ACK_DROPPED) &&
+               (xTaskGetTickCount() - pTransaction->m_dwSendTicks >= pdMS_TO_TICKS(g_TestAckDelay[pTransaction->m_dwAck])))
+      {
+        Test_ReceiveAck(pEngine, pTransaction);
+      }
+    }
+
+    Test_ProcessExpiredSessions(pEngine, s_Transactions);
+    vTaskDelay(1);
+  }
+
+  HOSTTEST_CHECK(bWrapped == true);
+
+  // Results
+  for (WORD i = 0; i < TEST_TRANSACTIONS; i++)
+  {
+    pTransaction = &s_Transactions[i];
+    HOSTTEST_CHECK(pTransaction->m_bSent == true);
+
+    if ((pTransaction->m_dwAck == TEST_ACK_IN_TIME) || (pTransaction->m_dwAck == TEST_ACK_LAST_MOMENT))
+    {
+      HOSTTEST_CHECK(pTransaction->m_dwExpiredNumber == 0);
+      HOSTTEST_CHECK(pTransaction->m_dwAckResult == NETWORKSERVERPROTOCOL_UPLINKSESSIONEVENT_TERMINATED);
+      continue;
+    }
+
+    // Lost ACK (i.e. late ACK received after expiry)
+    HOSTTEST_CHECK(pTransaction->m_dwExpiredNumber == 1);
+    ++dwLostNumber;
+    if (pTransaction->m_dwAck == TEST_ACK_LATE)
+    {
+      HOSTTEST_CHECK(pTransaction->m_dwAckResult == NETWORKSERVERPROTOCOL_SESSIONERROR_TRANSACTION);
+      ++dwLateNumber;
+    }
+
+    // Expiry in the timer wheel slot of the timeout (i.e. ticks of transaction before and after the wrap)
+    dwExpiryDelay = pTransaction->m_dwExpiredTicks - pTransaction->m_dwSendTicks;
+    if ((HOSTTEST_CHECK(dwExpiryDelay >= pdMS_TO_TICKS(CONFIG_SEMTECH_ACK_TIMEOUT)) == false) ||
+        (HOSTTEST_CHECK(dwExpiryDelay <= pdMS_TO_TICKS(CONFIG_SEMTECH_ACK_TIMEOUT + 2 * SEMTECHPROTOCOLENGINE_TIMERWHEEL_SLOT_DURATION)) == false))
+    {
+      printf("[ERROR] Transaction %u: sent at tick %u, expired at tick %u\n", (unsigned int) i,
+             (unsigned int) pTransaction->m_dwSendTicks, (unsigned int) pTransaction->m_dwExpiredTicks);
+    }
+  }
+
+  HOSTTEST_CHECK(pEngine->m_dwAckLostCount == dwLostNumber);
+  HOSTTEST_CHECK(pEngine->m_dwAckLateCount == dwLateNumber);
+  HOSTTEST_CHECK(pEngine->m_wPendingUpTransactionCount == 0);
+
+  printf("[INFO] Timer wheel across tick wrap: %u transactions, lost ACK: %u, late ACK: %u\n",
+         (unsigned int) TEST_TRANSACTIONS, (unsigned int) pEngine->m_dwAckLostCount, (unsigned int) pEngine->m_dwAckLateCount);
+
+  vPortFree(pMessage);
+  CSemtechProtocolEngine_Delete(pEngine);
+}
+
+
+int main(void)
+{
+  return HostTest_Run("test_semtech_timer_wheel", Test_SemtechTimerWheel);
+}
@@ -0,0 +1,367 @@
+/*****************************************************************************************//**
+ * @file     test_semtech_txpk.c
+ *
+ * @author   F.Fargon
+ *
+ * @version  V1.0
+ *
+ * @date     16/10/2026
+ *
+ * @brief    Decoding of PULL_RESP 'txpk' objects and TX_ACK reply of Semtech protocol.
+ *
+ * @details  The test drives 'CSemtechProtocolEngine_ProcessServerMessage' with PULL_RESP
+ *           messages and checks:\n
+ *            - Transmission parameters and payload of valid 'txpk' objects (fields in any
+ *              order, unused fields ignored)
+ *            - Rejection of malformed objects (missing fields, invalid values, truncated
+ *              stream, invalid header)
+ *            - Limits of 32 bits 'freq' and 'tmst' values (overflow rejected)
+ *            - Rejection of invalid Base64 payloads and of payloads larger than the buffer
+ *            - Stream of '{"txpk_ack":{"error":...}}' built by 'CSemtechProtocolEngine_BuildDownlinkAck'
+ *            - Benchmark of decoded messages per second on a corpus of PULL_RESP messages
+*********************************************************************************************/
+
+#include <Common.h>
+
+#include "NetworkServerProtocolItf.h"
+#include "TransceiverManagerItf.h"
+#include "SemtechProtocolEngine.h"
+
+#include "HostTest.h"
+
+
+/*********************************************************************************************
+  Definitions
+*********************************************************************************************/
+
+// Size of buffer for PULL_RESP message
+#define TEST_MESSAGE_SIZE        1024
+
+// Token of PULL_RESP messages (i.e. bytes 1-2 of message)
+#define TEST_TOKEN               0x1234
+
+// Number of messages in corpus for benchmark
+#define TEST_CORPUS_NUMBER       16
+
+// Number of decoded messages for benchmark
+#define TEST_BENCH_MESSAGES      200000
+
+// Payload of valid 'txpk' objects ('YAQDAgEAAQAKCwwNDg==' in Base64)
+static const BYTE g_TestPayload[] = { 0x60, 0x04, 0x03, 0x02, 0x01, 0x00, 0x01, 0x00, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E };
+
+// 'txpk' object and expected decoding result
+typedef struct _TestTxpk
+{
+  const char *m_pszJson;
+  bool m_bValid;
+  bool m_bImmediate;
+  DWORD m_dwTimestamp;
+  DWORD m_dwFrequency;
+  BYTE m_usPower;
+  BYTE m_usSpreadingFactor;
+  WORD m_wBandwidth;
+  BYTE m_usCodingRate;
+} TestTxpkOb;
+
+// Expected result of rejected objects
+#define TEST_TXPK_REJECTED       false, false, 0, 0, 0, 0, 0, 0
+
+static const TestTxpkOb g_TestTxpkTable[] =
+{
+  // Valid objects (as sent by Network Servers)
+  { "{\"txpk\":{\"imme\":false,\"tmst\":3512348611,\"freq\":869.525,\"rfch\":0,\"powe\":14,\"modu\":\"LORA\","
+    "\"datr\":\"SF9BW125\",\"codr\":\"4/5\",\"ipol\":true,\"size\":13,\"data\":\"YAQDAgEAAQAKCwwNDg==\"}}",
+    true, false, 3512348611U, 869525000, 14, 9, 125, 5 },
+  { "{\"txpk\":{\"data\":\"YAQDAgEAAQAKCwwNDg\",\"codr\":\"4/8\",\"datr\":\"SF12BW500\",\"modu\":\"LORA\",\"imme\":true,"
+    "\"ipol\":false,\"prea\":8,\"freq\":868.1}}",
+    true, true, 0, 868100000, SEMTECHPROTOCOLENGINE_TXPK_DEFAULT_POWER, 12, 500, 8 },
+  { " { \"txpk\" : { \"size\" : 13 , \"freq\" : 867.8999999 , \"tmst\" : 0 , \"powe\" : 27 ,"
+    " \"datr\" : \"SF7BW250\" , \"codr\" : \"4/6\" , \"data\" : \"YAQDAgEAAQAKCwwNDg==\" } } ",
+    true, false, 0, 867899999, 27, 7, 250, 6 },
+
+  // Limits of 32 bits values
+  { "{\"txpk\":{\"tmst\":4294967295,\"freq\":4294.967295,\"datr\":\"SF7BW125\",\"codr\":\"4/5\",\"data\":\"YAQDAgEAAQAKCwwNDg==\"}}",
+    true, false, 0xFFFFFFFF, 0xFFFFFFFF, SEMTECHPROTOCOLENGINE_TXPK_DEFAULT_POWER, 7, 125, 5 },
+  { "{\"txpk\":{\"tmst\":4294967296,\"freq\":868.1,\"datr\":\"SF7BW125\",\"codr\":\"4/5\",\"data\":\"YAQDAgEAAQAKCwwNDg==\"}}",
+    TEST_TXPK_REJECTED },
+  { "{\"txpk\":{\"tmst\":1000,\"freq\":4294.967296,\"datr\":\"SF7BW125\",\"codr\":\"4/5\",\"data\":\"YAQDAgEAAQAKCwwNDg==\"}}",
+    TEST_TXPK_REJECTED },
+  { "{\"txpk\":{\"tmst\":1000,\"freq\":99999999999.1,\"datr\":\"SF7BW125\",\"codr\":\"4/5\",\"data\":\"YAQDAgEAAQAKCwwNDg==\"}}",
+    TEST_TXPK_REJECTED },
+  { "{\"txpk\":{\"tmst\":1000,\"freq\":868.1,\"powe\":256,\"datr\":\"SF7BW125\",\"codr\":\"4/5\",\"data\":\"YAQDAgEAAQAKCwwNDg==\"}}",
+    TEST_TXPK_REJECTED },
+
+  // Malformed objects
+  { "{\"txpk\":{\"freq\":868.1,\"datr\":\"SF7BW125\",\"codr\":\"4/5\",\"data\":\"YAQDAgEAAQAKCwwNDg==\"}}", TEST_TXPK_REJECTED },
+  { "{\"txpk\":{\"imme\":false,\"freq\":868.1,\"datr\":\"SF7BW125\",\"codr\":\"4/5\",\"data\":\"YAQDAgEAAQAKCwwNDg==\"}}", TEST_TXPK_REJECTED },
+  { "{\"txpk\":{\"imme\":true,\"datr\":\"SF7BW125\",\"codr\":\"4/5\",\"data\":\"YAQDAgEAAQAKCwwNDg==\"}}", TEST_TXPK_REJECTED },
+  { "{\"txpk\":{\"imme\":true,\"freq\":868.1,\"codr\":\"4/5\",\"data\":\"YAQDAgEAAQAKCwwNDg==\"}}", TEST_TXPK_REJECTED },
+  { "{\"txpk\":{\"imme\":true,\"freq\":868.1,\"datr\":\"SF7BW125\",\"data\":\"YAQDAgEAAQAKCwwNDg==\"}}", TEST_TXPK_REJECTED },
+  { "{\"txpk\":{\"imme\":true,\"freq\":868.1,\"datr\":\"SF7BW125\",\"codr\":\"4/5\"}}", TEST_TXPK_REJECTED },
+  { "{\"txpk\":{\"imme\":1,\"freq\":868.1,\"datr\":\"SF7BW125\",\"codr\":\"4/5\",\"data\":\"YAQDAgEAAQAKCwwNDg==\"}}", TEST_TXPK_REJECTED },
+  { "{\"txpk\":{\"imme\":true,\"freq\":\"868.1\",\"datr\":\"SF7BW125\",\"codr\":\"4/5\",\"data\":\"YAQDAgEAAQAKCwwNDg==\"}}", TEST_TXPK_REJECTED },
+  { "{\"txpk\":{\"imme\":true,\"freq\":-868.1,\"datr\":\"SF7BW125\",\"codr\":\"4/5\",\"data\":\"YAQDAgEAAQAKCwwNDg==\"}}", TEST_TXPK_REJECTED },
+  { "{\"txpk\":{\"imme\":true,\"freq\":868.1,\"modu\":\"FSK\",\"datr\":\"SF7BW125\",\"codr\":\"4/5\",\"data\":\"YAQDAgEAAQAKCwwNDg==\"}}", TEST_TXPK_REJECTED },
+  { "{\"txpk\":{\"imme\":true,\"freq\":868.1,\"datr\":\"SF13BW125\",\"codr\":\"4/5\",\"data\":\"YAQDAgEAAQAKCwwNDg==\"}}", TEST_TXPK_REJECTED },
+  { "{\"txpk\":{\"imme\":true,\"freq\":868.1,\"datr\":\"SF7BW126\",\"codr\":\"4/5\",\"data\":\"YAQDAgEAAQAKCwwNDg==\"}}", TEST_TXPK_REJECTED },
+  { "{\"txpk\":{\"imme\":true,\"freq\":868.1,\"datr\":\"SF7BW\",\"codr\":\"4/5\",\"data\":\"YAQDAgEAAQAKCwwNDg==\"}}", TEST_TXPK_REJECTED },
+  { "{\"txpk\":{\"imme\":true,\"freq\":868.1,\"datr\":\"SFBW125\",\"codr\":\"4/5\",\"data\":\"YAQDAgEAAQAKCwwNDg==\"}}", TEST_TXPK_REJECTED },
+  { "{\"txpk\":{\"imme\":true,\"freq\":868.1,\"datr\":\"SF7BW125\",\"codr\":\"4/9\",\"data\":\"YAQDAgEAAQAKCwwNDg==\"}}", TEST_TXPK_REJECTED },
+  { "{\"txpk\":{\"imme\":true,\"freq\":868.1,\"datr\":\"SF7BW125\",\"codr\":\"4/50\",\"data\":\"YAQDAgEAAQAKCwwNDg==\"}}", TEST_TXPK_REJECTED },
+  { "{\"txpk\":{\"imme\":true,\"freq\":868.1,\"datr\":\"SF7BW125\",\"codr\":\"4/5\",\"size\":12,\"data\":\"YAQDAgEAAQAKCwwNDg==\"}}", TEST_TXPK_REJECTED },
+  { "{\"txpk\":{\"imme\":true,\"freq\":868.1,\"datr\":\"SF7BW125\",\"codr\":\"4/5\",\"data\":\"YAQDAgEAAQAKCwwNDg==\"}", TEST_TXPK_REJECTED },
+  { "{\"txpk\":{\"imme\":true,\"freq\":868.1,\"datr\":\"SF7BW125\",\"codr\":\"4/5\",\"data\":\"YAQDAgEAAQAKCwwNDg==", TEST_TXPK_REJECTED },
+  { "{\"txpk\":{\"imme\":true \"freq\":868.1,\"datr\":\"SF7BW125\",\"codr\":\"4/5\",\"data\":\"YAQDAgEAAQAKCwwNDg==\"}}", TEST_TXPK_REJECTED },
+  { "{\"rxpk\":{\"imme\":true,\"freq\":868.1,\"datr\":\"SF7BW125\",\"codr\":\"4/5\",\"data\":\"YAQDAgEAAQAKCwwNDg==\"}}", TEST_TXPK_REJECTED },
+  { "{\"txpk\":[868.1]}", TEST_TXPK_REJECTED },
+  { "", TEST_TXPK_REJECTED },
+
+  // Invalid Base64 payloads
+  { "{\"txpk\":{\"imme\":true,\"freq\":868.1,\"datr\":\"SF7BW125\",\"codr\":\"4/5\",\"data\":\"YAQD!gEAAQAKCwwNDg==\"}}", TEST_TXPK_REJECTED },
+  { "{\"txpk\":{\"imme\":true,\"freq\":868.1,\"datr\":\"SF7BW125\",\"codr\":\"4/5\",\"data\":\"YAQDA\"}}", TEST_TXPK_REJECTED },
+  { "{\"txpk\":{\"imme\":true,\"freq\":868.1,\"datr\":\"SF7BW125\",\"codr\":\"4/5\",\"data\":\"YAQ=AgEAAQAKCwwNDg==\"}}", TEST_TXPK_REJECTED },
+  { "{\"txpk\":{\"imme\":true,\"freq\":868.1,\"datr\":\"SF7BW125\",\"codr\":\"4/5\",\"data\":13}}", TEST_TXPK_REJECTED },
+};
+#define TEST_TXPK_NUMBER         (sizeof(g_TestTxpkTable) / sizeof(g_TestTxpkTable[0]))
+
+
+/*********************************************************************************************
+  Helpers
+*********************************************************************************************/
+
+// Builds a PULL_RESP message for the specified 'txpk' JSON stream
+// The function returns the message length
+static WORD Test_BuildPullResp(BYTE *pMessage, const char *pszJson)
+{
+  WORD wLength = (WORD) strlen(pszJson);
+
+  pMessage[0] = SEMTECHPROTOCOLENGINE_SEMTECH_PROTOCOL_VERSION;
+  pMessage[1] = (BYTE) TEST_TOKEN;
+  pMessage[2] = (BYTE) (TEST_TOKEN >> 8);
+  pMessage[3] = SEMTECHPROTOCOLENGINE_SEMTECH_MESSAGE_PULL_RESP;
+  memcpy(pMessage + 4, pszJson, wLength);
+  return wLength + 4;
+}
+
+// Decodes a PULL_RESP message with 'CSemtechProtocolEngine_ProcessServerMessage'
+static DWORD Test_ProcessMessage(CSemtechProtocolEngine *pEngine, BYTE *pMessage, WORD wMessageLength,
+                                 BYTE *pData, WORD wMaxLength, CNetworkServerProtocolItf_ProcessServerMessageParams pParams)
+{
+  pParams->m_pMessageData = pMessage;
+  pParams->m_wMessageLength = wMessageLength;
+  pParams->m_pData = pData;
+  pParams->m_wMaxLoraPacketLength = wMaxLength;
+  pParams->m_wLoraPacketLength = 0;
+  pParams->m_dwProtocolMessageId = 0;
+  return CSemtechProtocolEngine_ProcessServerMessage(pEngine, pParams);
+}
+
+
+/*********************************************************************************************
+  Test
+*********************************************************************************************/
+
+static void Test_Txpk(CSemtechProtocolEngine *pEngine, BYTE *pMessage, BYTE *pData)
+{
+  CNetworkServerProtocol_ProcessServerMessageParamsOb Params;
+  CNetworkServerProtocolItf_DownlinkPacketInfo pInfo = &Params.m_DownlinkPacketInfo;
+  const TestTxpkOb *pTxpk;
+  DWORD dwResult;
+  WORD wLength;
+
+  for (DWORD i = 0; i < TEST_TXPK_NUMBER; i++)
+  {
+    pTxpk = &g_TestTxpkTable[i];
+    wLength = Test_BuildPullResp(pMessage, pTxpk->m_pszJson);
+    dwResult = Test_ProcessMessage(pEngine, pMessage, wLength, pData, LORA_MAX_PAYLOAD_LENGTH, &Params);
+
+    if (pTxpk->m_bValid == false)
+    {
+      if (HOSTTEST_CHECK(dwResult == NETWORKSERVERPROTOCOL_SESSIONERROR_MESSAGE) == false)
+      {
+        printf("[INFO] Row %u accepted: %s\n", (unsigned int) i, pTxpk->m_pszJson);
+      }
+      continue;
+    }
+
+    if ((HOSTTEST_CHECK(dwResult == NETWORKSERVERPROTOCOL_DOWNLINKSESSIONEVENT_PREPARED) == false) ||
+        (HOSTTEST_CHECK(pInfo->m_bImmediate == pTxpk->m_bImmediate) == false) ||
+        (HOSTTEST_CHECK(pInfo->m_dwTimestamp == pTxpk->m_dwTimestamp) == false) ||
+        (HOSTTEST_CHECK(pInfo->m_dwFrequency == pTxpk->m_dwFrequency) == false) ||
+        (HOSTTEST_CHECK(pInfo->m_usPower == pTxpk->m_usPower) == false) ||
+        (HOSTTEST_CHECK(pInfo->m_usSpreadingFactor == pTxpk->m_usSpreadingFactor) == false) ||
+        (HOSTTEST_CHECK(pInfo->m_wBandwidth == pTxpk->m_wBandwidth) == false) ||
+        (HOSTTEST_CHECK(pInfo->m_usCodingRate == pTxpk->m_usCodingRate) == false))
+    {
+      printf("[INFO] Row %u rejected or wrongly decoded: %s\n", (unsigned int) i, pTxpk->m_pszJson);
+      continue;
+    }
+
+    HOSTTEST_CHECK(Params.m_dwProtocolMessageId == TEST_TOKEN);
+    HOSTTEST_CHECK((Params.m_wLoraPacketLength == sizeof(g_TestPayload)) &&
+                   (memcmp(pData, g_TestPayload, sizeof(g_TestPayload)) == 0));
+  }
+
+  // Payload larger than the memory block provided by caller
+  wLength = Test_BuildPullResp(pMessage, g_TestTxpkTable[0].m_pszJson);
+  HOSTTEST_CHECK(Test_ProcessMessage(pEngine, pMessage, wLength, pData, sizeof(g_TestPayload), &Params) ==
+                 NETWORKSERVERPROTOCOL_DOWNLINKSESSIONEVENT_PREPARED);
+  HOSTTEST_CHECK(Test_ProcessMessage(pEngine, pMessage, wLength, pData, sizeof(g_TestPayload) - 1, &Params) ==
+                 NETWORKSERVERPROTOCOL_SESSIONERROR_MESSAGE);
+  HOSTTEST_CHECK(Test_ProcessMessage(pEngine, pMessage, wLength, NULL, LORA_MAX_PAYLOAD_LENGTH, &Params) ==
+                 NETWORKSERVERPROTOCOL_SESSIONERROR_MESSAGE);
+
+  // Invalid header (protocol version, length, message type)
+  pMessage[0] = SEMTECHPROTOCOLENGINE_SEMTECH_PROTOCOL_VERSION + 1;
+  HOSTTEST_CHECK(Test_ProcessMessage(pEngine, pMessage, wLength, pData, LORA_MAX_PAYLOAD_LENGTH, &Params) ==
+                 NETWORKSERVERPROTOCOL_SESSIONERROR_MESSAGE);
+  pMessage[0] = SEMTECHPROTOCOLENGINE_SEMTECH_PROTOCOL_VERSION;
+  HOSTTEST_CHECK(Test_ProcessMessage(pEngine, pMessage, 3, pData, LORA_MAX_PAYLOAD_LENGTH, &Params) ==
+                 NETWORKSERVERPROTOCOL_SESSIONERROR_MESSAGE);
+  pMessage[3] = SEMTECHPROTOCOLENGINE_SEMTECH_MESSAGE_TX_ACK;
+  HOSTTEST_CHECK(Test_ProcessMessage(pEngine, pMessage, wLength, pData, LORA_MAX_PAYLOAD_LENGTH, &Params) ==
+                 NETWORKSERVERPROTOCOL_UPLINKSESSIONEVENT_FAILED);
+}
+
+
+static void Test_DownlinkAck(CSemtechProtocolEngine *pEngine, BYTE *pMessage)
+{
+  static const char * const s_pszError[] = { "NONE", "TOO_LATE", "TOO_EARLY", "COLLISION_PACKET",
+                                             "COLLISION_BEACON", "TX_FREQ", "TX_POWER", "GPS_UNLOCKED" };
+  CNetworkServerProtocol_BuildDownlinkAckParamsOb Params;
+  char szExpected[64];
+  WORD wJsonLength;
+
+  for (DWORD dwResult = TRANSCEIVERMANAGER_SENDDOWNLINK_NONE; dwResult <= TRANSCEIVERMANAGER_SENDDOWNLINK_GPS_UNLOCKED + 1; dwResult++)
+  {
+    // Unknown result codes are reported as 'TOO_LATE'
+    wJsonLength = (WORD) sprintf(szExpected, "{\"txpk_ack\":{\"error\":\"%s\"}}",
+                                 s_pszError[dwResult <= TRANSCEIVERMANAGER_SENDDOWNLINK_GPS_UNLOCKED ?
+                                            dwResult : TRANSCEIVERMANAGER_SENDDOWNLINK_TOO_LATE]);
+
+    memset(pMessage, 0xEE, TEST_MESSAGE_SIZE);
+    Params.m_dwProtocolMessageId = TEST_TOKEN;
+    Params.m_dwDownlinkResult = dwResult;
+    Params.m_pMessageData = pMessage;
+    Params.m_wMaxMessageLength = TEST_MESSAGE_SIZE;
+    Params.m_wMessageLength = 0;
+
+    if (HOSTTEST_CHECK(CSemtechProtocolEngine_BuildDownlinkAck(pEngine, &Params) == true) == false)
+    {
+      continue;
+    }
+    HOSTTEST_CHECK(Params.m_wMessageLength == 12 + wJsonLength);
+    HOSTTEST_CHECK((pMessage[0] == SEMTECHPROTOCOLENGINE_SEMTECH_PROTOCOL_VERSION) &&
+                   (pMessage[1] == (BYTE) TEST_TOKEN) && (pMessage[2] == (BYTE) (TEST_TOKEN >> 8)) &&
+                   (pMessage[3] == SEMTECHPROTOCOLENGINE_SEMTECH_MESSAGE_TX_ACK));
+    HOSTTEST_CHECK(memcmp(pMessage + 4, pEngine->m_GatewayMACAddr, 8) == 0);
+    HOSTTEST_CHECK(memcmp(pMessage + 12, szExpected, wJsonLength) == 0);
+    HOSTTEST_CHECK(pMessage[12 + wJsonLength] == 0xEE);
+  }
+
+  // Buffer too small for the longest reply
+  wJsonLength = (WORD) strlen("{\"txpk_ack\":{\"error\":\"COLLISION_BEACON\"}}");
+  Params.m_dwDownlinkResult = TRANSCEIVERMANAGER_SENDDOWNLINK_COLLISION_BEACON;
+  Params.m_wMaxMessageLength = 12 + wJsonLength;
+  HOSTTEST_CHECK(CSemtechProtocolEngine_BuildDownlinkAck(pEngine, &Params) == true);
+  Params.m_wMaxMessageLength = 12 + wJsonLength - 1;
+  HOSTTEST_CHECK(CSemtechProtocolEngine_BuildDownlinkAck(pEngine, &Params) == false);
+  HOSTTEST_CHECK(Params.m_wMessageLength == 0);
+}
+
+
+static void Test_Benchmark(CSemtechProtocolEngine *pEngine, BYTE *pData)
+{
+  static const char * const s_pszDataRate[] = { "SF7BW125", "SF8BW125", "SF9BW125", "SF10BW125",
+                                                "SF11BW125", "SF12BW125", "SF7BW250", "SF9BW500" };
+  CNetworkServerProtocol_ProcessServerMessageParamsOb Params;
+  BYTE *pCorpus;
+  WORD wLength[TEST_CORPUS_NUMBER];
+  BYTE Payload[LORA_MAX_PAYLOAD_LENGTH];
+  char szBase64[((LORA_MAX_PAYLOAD_LENGTH + 2) / 3) * 4 + 1];
+  char szJson[TEST_MESSAGE_SIZE - 4];
+  DWORD dwSeed = 0x5EED;
+  DWORD dwDecodedNumber = 0;
+  QWORD qwByteNumber = 0;
+  QWORD qwStart;
+  QWORD qwDuration;
+  WORD wPayloadLength;
+  WORD wBase64Length;
+
+  HOSTTEST_CHECK((pCorpus = pvPortMalloc(TEST_CORPUS_NUMBER * TEST_MESSAGE_SIZE)) != NULL);
+  if (pCorpus == NULL)
+  {
+    return;
+  }
+
+  // Corpus of PULL_RESP messages (payload of 1 to 'LORA_MAX_PAYLOAD_LENGTH' bytes, RX1 and RX2 settings)
+  for (DWORD i = 0; i < TEST_CORPUS_NUMBER; i++)
+  {
+    wPayloadLength = (WORD) (1 + (i * 37) % LORA_MAX_PAYLOAD_LENGTH);
+    HostTest_FillRandom(Payload, wPayloadLength, &dwSeed);
+    wBase64Length = Base64_BinToB64(Payload, wPayloadLength, (BYTE *) szBase64, sizeof(szBase64));
+    HOSTTEST_CHECK(wBase64Length < sizeof(szBase64));
+    szBase64[wBase64Length] = 0;
+
+    snprintf(szJson, sizeof(szJson), "{\"txpk\":{\"imme\":false,\"tmst\":%u,\"freq\":%s,\"rfch\":0,\"powe\":14,"
+             "\"modu\":\"LORA\",\"datr\":\"%s\",\"codr\":\"4/5\",\"ipol\":true,\"size\":%u,\"data\":\"%s\"}}",
+             (unsigned int) (dwSeed & 0x7FFFFFFF), (i & 1) ? "869.525" : "868.1",
+             s_pszDataRate[i % (sizeof(s_pszDataRate) / sizeof(s_pszDataRate[0]))], (unsigned int) wPayloadLength, szBase64);
+    wLength[i] = Test_BuildPullResp(pCorpus + i * TEST_MESSAGE_SIZE, szJson);
+  }
+
+  qwStart = GATEWAY_CLOCK_MICROSEC();
+  for (DWORD i = 0; i < TEST_BENCH_MESSAGES; i++)
+  {
+    if (Test_ProcessMessage(pEngine, pCorpus + (i % TEST_CORPUS_NUMBER) * TEST_MESSAGE_SIZE, wLength[i % TEST_CORPUS_NUMBER],
+        pData, LORA_MAX_PAYLOAD_LENGTH, &Params) == NETWORKSERVERPROTOCOL_DOWNLINKSESSIONEVENT_PREPARED)
+    {
+      ++dwDecodedNumber;
+    }
+    qwByteNumber += wLength[i % TEST_CORPUS_NUMBER];
+  }
+  qwDuration = GATEWAY_CLOCK_MICROSEC() - qwStart;
+
+  HOSTTEST_CHECK(dwDecodedNumber == TEST_BENCH_MESSAGES);
+
+  printf("[INFO] PULL_RESP decoding: %u messages (%u bytes) in %u us = %u messages/s, %u KB/s\n",
+         TEST_BENCH_MESSAGES, (unsigned int) qwByteNumber, (unsigned int) qwDuration,
+         (unsigned int) ((QWORD) TEST_BENCH_MESSAGES * 1000000 / (qwDuration > 0 ? qwDuration : 1)),
+         (unsigned int) (qwByteNumber * 1000000 / 1024 / (qwDuration > 0 ? qwDuration : 1)));
+
+  vPortFree(pCorpus);
+}
+
+
+static void Test_SemtechTxpk(void)
+{
+  CSemtechProtocolEngine *pEngine;
+  BYTE *pMessage;
+  BYTE *pData;
+  DWORD dwDownlinkNumber;
+
+  HOSTTEST_CHECK((pEngine = CSemtechProtocolEngine_New()) != NULL);
+  HOSTTEST_CHECK((pMessage = pvPortMalloc(TEST_MESSAGE_SIZE)) != NULL);
+  HOSTTEST_CHECK((pData = pvPortMalloc(LORA_MAX_PAYLOAD_LENGTH)) != NULL);
+  if ((pEngine == NULL) || (pMessage == NULL) || (pData == NULL))
+  {
+    return;
+  }
+
+  dwDownlinkNumber = pEngine->m_dwDwnbCount;
+  Test_Txpk(pEngine, pMessage, pData);
+  HOSTTEST_CHECK(pEngine->m_dwDwnbCount > dwDownlinkNumber);
+
+  Test_DownlinkAck(pEngine, pMessage);
+  Test_Benchmark(pEngine, pData);
+
+  vPortFree(pData);
+  vPortFree(pMessage);
+  CSemtechProtocolEngine_Delete(pEngine);
+}
+
+
+int main(void)
+{
+  return HostTest_Run("test_semtech_txpk", Test_SemtechTxpk);
+}
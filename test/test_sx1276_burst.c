@@ -0,0 +1,206 @@
+/*****************************************************************************************//**
+ * @file     test_sx1276_burst.c
+ *
+ * @author   F.Fargon
+ *
+ * @version  V1.0
+ *
+ * @date     16/10/2026
+ *
+ * @brief    SPI cost of SX1276 FIFO payload transfers (burst access).
+ *
+ * @details  The 'CSX1276' object is attached to the mock SX1276 ('CSX1276MockSpi'):\n
+ *            - Received payloads ('CSX1276_getPacket') and payloads to send
+ *              ('CSX1276_startSend') are transferred intact
+ *            - The number of SPI transactions per packet does not depend on payload length
+ *              (i.e. one burst transaction for the payload)
+ *            - Benchmark of per-packet SPI cost versus one transaction per payload byte (i.e.
+ *              'CSX1276_readRegister(REG_FIFO)' for each byte, previous implementation)
+*********************************************************************************************/
+
+#include <Common.h>
+
+#include "LoraTransceiverItf.h"
+#include "SX1276.h"
+#include "SX1276MockSpi.h"
+
+#include "HostTest.h"
+
+
+/*********************************************************************************************
+  Definitions
+*********************************************************************************************/
+
+// Simulated SPI latencies for benchmark (microseconds)
+#define TEST_TRANSFER_LATENCY    10
+#define TEST_WAKEUP_LATENCY      20
+
+// Number of packets for benchmark
+#define TEST_BENCH_PACKETS       50
+
+// Payload lengths tested
+static const WORD g_wTestLengths[] = { 1, 13, 64, 200, LORA_MAX_PAYLOAD_LENGTH };
+#define TEST_LENGTH_NUMBER       (sizeof(g_wTestLengths) / sizeof(g_wTestLengths[0]))
+
+
+/*********************************************************************************************
+  Helpers
+*********************************************************************************************/
+
+// Reads a received packet with one SPI transaction per payload byte (previous implementation)
+static void Test_GetPacketPerByte(CSX1276 *pSX1276, BYTE *pBuffer)
+{
+  BYTE usLength;
+
+  CSX1276_readRegister(pSX1276, REG_IRQ_FLAGS);
+  usLength = CSX1276_readRegister(pSX1276, REG_RX_NB_BYTES);
+  CSX1276_readRegister(pSX1276, REG_PKT_SNR_VALUE);
+  CSX1276_readRegister(pSX1276, REG_PKT_RSSI_VALUE);
+  CSX1276_writeRegister(pSX1276, REG_FIFO_ADDR_PTR, 0x00);
+  for (WORD i = 0; i < usLength; i++)
+  {
+    pBuffer[i] = CSX1276_readRegister(pSX1276, REG_FIFO);
+  }
+  CSX1276_writeRegister(pSX1276, REG_FIFO_ADDR_PTR, 0x00);
+  CSX1276_writeRegister(pSX1276, REG_IRQ_FLAGS, 0xFF);
+}
+
+
+// Payload received by 'CSX1276_getPacket' for a packet injected in mock device
+// Returns the number of SPI transactions
+static DWORD Test_ReceivePacket(CSX1276 *pSX1276, CSX1276MockSpi pMockSpi, const BYTE *pPayload, WORD wLength)
+{
+  DWORD dwTransactionNumber;
+
+  CSX1276MockSpi_InjectPacket(pMockSpi, pPayload, (BYTE) wLength, 0x20, 0x40);
+  pSX1276->m_pPacketReceived->m_dwDataSize = 0;
+
+  dwTransactionNumber = CSX1276MockSpi_GetTransactionNumber(pMockSpi);
+  HOSTTEST_CHECK(CSX1276_getPacket(pSX1276) == LORATRANSCEIVERITF_RESULT_SUCCESS);
+  return CSX1276MockSpi_GetTransactionNumber(pMockSpi) - dwTransactionNumber;
+}
+
+
+// Payload sent by 'CSX1276_startSend' (i.e. written in FIFO of mock device)
+// Returns the number of SPI transactions
+static DWORD Test_SendPacket(CSX1276 *pSX1276, CSX1276MockSpi pMockSpi, CLoraTransceiverItf_LoraPacket pPacket)
+{
+  DWORD dwTransactionNumber;
+
+  dwTransactionNumber = CSX1276MockSpi_GetTransactionNumber(pMockSpi);
+  HOSTTEST_CHECK(CSX1276_startSend(pSX1276, pPacket) == LORATRANSCEIVERITF_RESULT_SUCCESS);
+  return CSX1276MockSpi_GetTransactionNumber(pMockSpi) - dwTransactionNumber;
+}
+
+
+/*********************************************************************************************
+  Test
+*********************************************************************************************/
+
+static void Test_Sx1276Burst(void)
+{
+  CSX1276 *pSX1276;
+  CSX1276MockSpi pMockSpi;
+  CLoraPacket *pPacket;
+  BYTE usPayload[LORA_MAX_PAYLOAD_LENGTH];
+  BYTE usBuffer[LORA_MAX_PAYLOAD_LENGTH];
+  DWORD dwSeed = 0x1276;
+  DWORD dwTransactionNumber;
+  DWORD dwReceiveTransactions = 0;
+  DWORD dwSendTransactions = 0;
+  QWORD qwStart;
+  QWORD qwBurstDuration;
+  QWORD qwPerByteDuration;
+
+  HOSTTEST_CHECK((pMockSpi = CSX1276MockSpi_New(0, 0)) != NULL);
+  HOSTTEST_CHECK((pSX1276 = CSX1276_New()) != NULL);
+  HOSTTEST_CHECK((pPacket = (CLoraPacket *) pvPortMalloc(sizeof(CLoraPacket))) != NULL);
+  if ((pMockSpi == NULL) || (pSX1276 == NULL) || (pPacket == NULL))
+  {
+    return;
+  }
+
+  CSX1276_SetSpiBackend(pSX1276, &g_SX1276MockSpiBackendOb, (spi_device_handle_t) pMockSpi);
+  pMockSpi->m_usRegisters[REG_OP_MODE] = LORA_STANDBY_MODE;
+
+  // Received and sent payloads
+  // The SPI cost is the same for all lengths
+  for (BYTE i = 0; i < TEST_LENGTH_NUMBER; i++)
+  {
+    HostTest_FillRandom(usPayload, g_wTestLengths[i], &dwSeed);
+
+    dwTransactionNumber = Test_ReceivePacket(pSX1276, pMockSpi, usPayload, g_wTestLengths[i]);
+    HOSTTEST_CHECK(pSX1276->m_pPacketReceived->m_dwDataSize == g_wTestLengths[i]);
+    HOSTTEST_CHECK(memcmp(pSX1276->m_pPacketReceived->m_usData, usPayload, g_wTestLengths[i]) == 0);
+    HOSTTEST_CHECK((pMockSpi->m_usRegisters[REG_IRQ_FLAGS] & 0x40) == 0);
+    if (i == 0)
+    {
+      dwReceiveTransactions = dwTransactionNumber;
+    }
+    HOSTTEST_CHECK(dwTransactionNumber == dwReceiveTransactions);
+
+    memcpy(pPacket->m_usData, usPayload, g_wTestLengths[i]);
+    pPacket->m_dwDataSize = g_wTestLengths[i];
+    memset(pMockSpi->m_usFifo, 0, sizeof(pMockSpi->m_usFifo));
+
+    dwTransactionNumber = Test_SendPacket(pSX1276, pMockSpi, (CLoraTransceiverItf_LoraPacket) pPacket);
+    HOSTTEST_CHECK(memcmp(pMockSpi->m_usFifo, usPayload, g_wTestLengths[i]) == 0);
+    HOSTTEST_CHECK(pMockSpi->m_usRegisters[REG_PAYLOAD_LENGTH_LORA] == g_wTestLengths[i]);
+    HOSTTEST_CHECK((pMockSpi->m_usRegisters[REG_IRQ_FLAGS] & 0x08) != 0);
+    if (i == 0)
+    {
+      dwSendTransactions = dwTransactionNumber;
+    }
+    HOSTTEST_CHECK(dwTransactionNumber == dwSendTransactions);
+
+    // Back to 'StandBy' mode for next packet (i.e. 'TxDone' processed)
+    CSX1276_writeRegister(pSX1276, REG_IRQ_FLAGS, 0xFF);
+    CSX1276_invalidateRegisters(pSX1276);
+  }
+
+  printf("[INFO] SPI transactions per packet (burst): receive = %u, send = %u\n",
+         (unsigned int) dwReceiveTransactions, (unsigned int) dwSendTransactions);
+
+  // Same payload read with one transaction per byte
+  HostTest_FillRandom(usPayload, LORA_MAX_PAYLOAD_LENGTH, &dwSeed);
+  CSX1276MockSpi_InjectPacket(pMockSpi, usPayload, LORA_MAX_PAYLOAD_LENGTH, 0x20, 0x40);
+  CSX1276_invalidateRegisters(pSX1276);
+  dwTransactionNumber = CSX1276MockSpi_GetTransactionNumber(pMockSpi);
+  Test_GetPacketPerByte(pSX1276, usBuffer);
+  dwTransactionNumber = CSX1276MockSpi_GetTransactionNumber(pMockSpi) - dwTransactionNumber;
+  HOSTTEST_CHECK(memcmp(usBuffer, usPayload, LORA_MAX_PAYLOAD_LENGTH) == 0);
+  HOSTTEST_CHECK(dwTransactionNumber >= LORA_MAX_PAYLOAD_LENGTH);
+
+  printf("[INFO] SPI transactions per %u bytes packet (per byte): receive = %u\n",
+         (unsigned int) LORA_MAX_PAYLOAD_LENGTH, (unsigned int) dwTransactionNumber);
+
+  // Benchmark with simulated SPI latencies
+  pMockSpi->m_dwTransferLatency = TEST_TRANSFER_LATENCY;
+  pMockSpi->m_dwWakeupLatency = TEST_WAKEUP_LATENCY;
+
+  qwStart = GATEWAY_CLOCK_MICROSEC();
+  for (WORD i = 0; i < TEST_BENCH_PACKETS; i++)
+  {
+    Test_ReceivePacket(pSX1276, pMockSpi, usPayload, LORA_MAX_PAYLOAD_LENGTH);
+  }
+  qwBurstDuration = GATEWAY_CLOCK_MICROSEC() - qwStart;
+
+  qwStart = GATEWAY_CLOCK_MICROSEC();
+  for (WORD i = 0; i < TEST_BENCH_PACKETS; i++)
+  {
+    CSX1276MockSpi_InjectPacket(pMockSpi, usPayload, LORA_MAX_PAYLOAD_LENGTH, 0x20, 0x40);
+    CSX1276_invalidateRegisters(pSX1276);
+    Test_GetPacketPerByte(pSX1276, usBuffer);
+  }
+  qwPerByteDuration = GATEWAY_CLOCK_MICROSEC() - qwStart;
+
+  printf("[INFO] Receive %u bytes packet (transfer %u us, wakeup %u us): burst = %u us, per byte = %u us\n",
+         (unsigned int) LORA_MAX_PAYLOAD_LENGTH, TEST_TRANSFER_LATENCY, TEST_WAKEUP_LATENCY,
+         (unsigned int) (qwBurstDuration / TEST_BENCH_PACKETS), (unsigned int) (qwPerByteDuration / TEST_BENCH_PACKETS));
+}
+
+
+int main(void)
+{
+  return HostTest_Run("test_sx1276_burst", Test_Sx1276Burst);
+}
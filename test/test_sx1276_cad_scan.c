@@ -0,0 +1,394 @@
+/*****************************************************************************************//**
+ * @file     test_sx1276_cad_scan.c
+ *
+ * @author   F.Fargon
+ *
+ * @version  V1.0
+ *
+ * @date     16/10/2026
+ *
+ * @brief    Capture rate of SX1276 scanner mode (CAD) against synthetic traffic mixes.
+ *
+ * @details  The 'CSX1276' object runs the scanner mode on the mock SX1276 with a virtual clock
+ *           ('GATEWAY_CLOCK_VIRTUAL'). The harness plays the role of the SX1276 automaton
+ *           ('CadDone', lock timeout and 'RxDone' processed at their simulated time) and of the
+ *           air interface (Poisson traffic on each channel/SF pair, CAD activity reported by
+ *           the mock device callback):\n
+ *            - Capture rate of fixed radio (i.e. dominant pair only), uniform and adaptive
+ *              dwell schedules, for several traffic mixes
+ *            - One pair within time budget: all preambles detected (except lock on false CAD)
+ *            - Spread traffic: the scanner captures more than a fixed radio
+ *            - Skewed traffic: the adaptive dwell captures more than the uniform schedule
+ *            - Scanner statistics consistent with the simulated traffic
+*********************************************************************************************/
+
+#include <Common.h>
+
+#include <math.h>
+
+#include "LoraTransceiverItf.h"
+#include "SX1276.h"
+#include "SX1276MockSpi.h"
+
+#include "HostTest.h"
+
+
+/*********************************************************************************************
+  Definitions
+*********************************************************************************************/
+
+// Radio settings (LoRaWAN uplinks: 8 preamble symbols, BW125, CR 4/5, 20 bytes payload)
+#define TEST_PREAMBLE_SYMBOLS    8
+#define TEST_PAYLOAD_LENGTH      20
+#define TEST_HOP_TIME            300
+
+// Probability of false CAD detection (per mille)
+#define TEST_FALSE_CAD           20
+
+// Duration of each run in virtual time (microseconds)
+#define TEST_DURATION            GATEWAY_CLOCK_MS_TO_US(300000ULL)
+
+// Minimum capture rate for one pair within time budget (per mille)
+// Note: The RX lock on a false CAD lasts the remaining preamble (i.e. about 10% of time lost)
+#define TEST_MIN_SINGLE_CAPTURE  900
+
+// Channel/SF pair with its traffic (packets per minute)
+typedef struct _TestPair
+{
+  BYTE m_usFreqChannel;
+  BYTE m_usSpreadingFactor;
+  DWORD m_dwRate;
+} TestPairOb;
+
+// Traffic mix
+typedef struct _TestMix
+{
+  const char *m_pszName;
+  BYTE m_usPairNumber;
+  TestPairOb m_Pairs[4];
+} TestMixOb;
+
+static const TestMixOb g_TestMixes[] =
+{
+  { "1 pair SF9",          1, { { 1, 9, 60 } } },
+  { "2 pairs SF7/8",       2, { { 1, 7, 60 }, { 2, 8, 60 } } },
+  { "4 pairs skewed 7-10", 4, { { 1, 7, 240 }, { 2, 8, 60 }, { 3, 9, 30 }, { 4, 10, 15 } } },
+  { "4 pairs even 7-10",   4, { { 1, 7, 60 }, { 2, 8, 60 }, { 3, 9, 60 }, { 4, 10, 60 } } },
+};
+#define TEST_MIX_NUMBER          (sizeof(g_TestMixes) / sizeof(g_TestMixes[0]))
+
+// Packet on air for one pair (virtual time, microseconds)
+// Note: The packets of one pair never overlap (i.e. next packet after end of current one)
+typedef struct _TestPacket
+{
+  QWORD m_qwStart;
+  QWORD m_qwPreambleEnd;
+  QWORD m_qwEnd;
+  bool m_bCaptured;
+} TestPacketOb;
+
+// Simulated air interface and radio state
+typedef struct _TestAir
+{
+  const TestMixOb *m_pMix;
+  DWORD m_dwRegFreq[4];
+  DWORD m_dwSymbolTime[4];
+  TestPacketOb m_Packets[4];
+  DWORD m_dwSeed;
+
+  // Result of last CAD (see 'Test_CadActivity')
+  BYTE m_usCadPair;
+  bool m_bCadPacket;
+  bool m_bCadSync;
+  DWORD m_dwCadNumber;
+  DWORD m_dwFalseCadNumber;
+
+  // Packets ended and captured for each pair
+  DWORD m_dwOfferedNumber[4];
+  DWORD m_dwCapturedNumber[4];
+} TestAirOb;
+
+// Virtual clock (see 'GATEWAY_CLOCK_VIRTUAL')
+static volatile QWORD g_qwTestClock = 0;
+
+
+/*********************************************************************************************
+  Helpers
+*********************************************************************************************/
+
+// Gateway clock of harness
+uint64_t GatewayClock_VirtualMicrosec(void)
+{
+  return g_qwTestClock;
+}
+
+
+// Uniform random value in ]0, 1]
+static double Test_Random(DWORD *pdwSeed)
+{
+  *pdwSeed = (*pdwSeed * 1103515245) + 12345;
+  return (double) (((*pdwSeed >> 8) & 0x00FFFFFF) + 1) / (double) 0x01000000;
+}
+
+
+// Airtime of packet after the preamble (symbols, explicit header and CRC)
+static DWORD Test_PayloadSymbols(BYTE usSpreadingFactor, DWORD dwSymbolTime)
+{
+  DWORD dwLowDataRate = (dwSymbolTime >= 16000) ? 1 : 0;
+  DWORD dwDivider = 4 * (usSpreadingFactor - (2 * dwLowDataRate));
+
+  return 8 + (((8 * TEST_PAYLOAD_LENGTH) - (4 * usSpreadingFactor) + 28 + 16 + dwDivider - 1) / dwDivider) *
+             (LORATRANSCEIVERITF_CR_5 + 4);
+}
+
+
+// Next packet of the pair (Poisson arrivals, after end of current packet)
+static void Test_NextPacket(TestAirOb *pAir, BYTE usPair)
+{
+  TestPacketOb *pPacket = &(pAir->m_Packets[usPair]);
+  DWORD dwSymbolTime = pAir->m_dwSymbolTime[usPair];
+  double dGap = -log(Test_Random(&(pAir->m_dwSeed))) * 60000000.0 / (double) pAir->m_pMix->m_Pairs[usPair].m_dwRate;
+
+  pPacket->m_qwStart = pPacket->m_qwEnd + (QWORD) dGap;
+  pPacket->m_qwPreambleEnd = pPacket->m_qwStart + (QWORD) TEST_PREAMBLE_SYMBOLS * dwSymbolTime;
+
+  // Preamble (including sync word) and payload
+  pPacket->m_qwEnd = pPacket->m_qwStart + (QWORD) (TEST_PREAMBLE_SYMBOLS * 4 + 17) * dwSymbolTime / 4 +
+                     (QWORD) Test_PayloadSymbols(pAir->m_pMix->m_Pairs[usPair].m_usSpreadingFactor, dwSymbolTime) * dwSymbolTime;
+  pPacket->m_bCaptured = false;
+}
+
+
+// Packets ended before the specified time (i.e. offered traffic counted)
+static void Test_UpdateAir(TestAirOb *pAir, QWORD qwTime)
+{
+  for (BYTE p = 0; p < pAir->m_pMix->m_usPairNumber; p++)
+  {
+    while (pAir->m_Packets[p].m_qwEnd <= qwTime)
+    {
+      ++pAir->m_dwOfferedNumber[p];
+      if (pAir->m_Packets[p].m_bCaptured)
+      {
+        ++pAir->m_dwCapturedNumber[p];
+      }
+      Test_NextPacket(pAir, p);
+    }
+  }
+}
+
+
+// Channel activity of mock device (CAD started after the hop time, i.e. when mode is written)
+//  - Activity: the preamble covers the CAD
+//  - Synchronization: enough preamble left after the CAD
+static bool Test_CadActivity(void *pContext, DWORD dwRegFreq, BYTE usSpreadingFactor)
+{
+  TestAirOb *pAir = (TestAirOb *) pContext;
+  TestPacketOb *pPacket;
+  QWORD qwCadStart = g_qwTestClock + TEST_HOP_TIME;
+  QWORD qwCadEnd;
+  BYTE p;
+
+  for (p = 0; p < pAir->m_pMix->m_usPairNumber; p++)
+  {
+    if ((pAir->m_dwRegFreq[p] == dwRegFreq) && (pAir->m_pMix->m_Pairs[p].m_usSpreadingFactor == usSpreadingFactor))
+    {
+      break;
+    }
+  }
+  if (HOSTTEST_CHECK(p < pAir->m_pMix->m_usPairNumber) == false)
+  {
+    return false;
+  }
+
+  Test_UpdateAir(pAir, qwCadStart);
+  pPacket = &(pAir->m_Packets[p]);
+  qwCadEnd = qwCadStart + (QWORD) SX1276_SCAN_CAD_SYMBOLS * pAir->m_dwSymbolTime[p];
+
+  ++pAir->m_dwCadNumber;
+  pAir->m_usCadPair = p;
+  pAir->m_bCadPacket = (pPacket->m_qwStart <= qwCadStart) && (qwCadEnd <= pPacket->m_qwPreambleEnd);
+  pAir->m_bCadSync = pAir->m_bCadPacket &&
+                     (qwCadEnd + (QWORD) SX1276_SCAN_SYNC_SYMBOLS * pAir->m_dwSymbolTime[p] <= pPacket->m_qwPreambleEnd);
+
+  if (pAir->m_bCadPacket)
+  {
+    return true;
+  }
+  if (Test_Random(&(pAir->m_dwSeed)) * 1000.0 <= TEST_FALSE_CAD)
+  {
+    ++pAir->m_dwFalseCadNumber;
+    return true;
+  }
+  return false;
+}
+
+
+// Scanner mode for the traffic mix (automaton of SX1276 simulated in virtual time)
+// Returns the capture rate (per mille)
+static DWORD Test_RunScanner(CSX1276 *pSX1276, CSX1276MockSpi pMockSpi, const TestMixOb *pMix, bool bAdaptiveDwell,
+                             DWORD *pdwFixedCapture)
+{
+  CLoraTransceiverItf_ScanParamsOb ScanParams;
+  CLoraTransceiverItf_ScanStatisticsOb Statistics[LORATRANSCEIVERITF_SCAN_MAX_CHANNELS];
+  TestAirOb Air;
+  TestPacketOb *pPacket;
+  DWORD dwOfferedNumber = 0;
+  DWORD dwCapturedNumber = 0;
+  DWORD dwDetectedNumber = 0;
+  DWORD dwReceivedNumber = 0;
+  DWORD dwFalseNumber = 0;
+  DWORD dwCadNumber = 0;
+  bool bLocked;
+
+  memset(&Air, 0, sizeof(Air));
+  memset(Statistics, 0, sizeof(Statistics));
+  Air.m_pMix = pMix;
+  Air.m_dwSeed = 0xCAD0 + pMix->m_usPairNumber;
+
+  ScanParams.m_usChannelNumber = pMix->m_usPairNumber;
+  ScanParams.m_wHopTime = TEST_HOP_TIME;
+  ScanParams.m_bAdaptiveDwell = bAdaptiveDwell;
+  ScanParams.m_pStatistics = Statistics;
+
+  g_qwTestClock = GATEWAY_CLOCK_MS_TO_US(1000);
+  for (BYTE p = 0; p < pMix->m_usPairNumber; p++)
+  {
+    ScanParams.m_Channels[p].m_usFreqChannel = pMix->m_Pairs[p].m_usFreqChannel;
+    ScanParams.m_Channels[p].m_usSpreadingFactor = pMix->m_Pairs[p].m_usSpreadingFactor;
+    Air.m_dwRegFreq[p] = CSX1276_getFreqRegValue(pMix->m_Pairs[p].m_usFreqChannel);
+    Air.m_dwSymbolTime[p] = CSX1276_getSymbolTime(pSX1276, pMix->m_Pairs[p].m_usSpreadingFactor);
+    Air.m_Packets[p].m_qwEnd = g_qwTestClock;
+    Test_NextPacket(&Air, p);
+  }
+  CSX1276MockSpi_SetCadActivity(pMockSpi, Test_CadActivity, &Air);
+
+  // 'Receive' command with scanner mode
+  HOSTTEST_CHECK(CSX1276_startScan(pSX1276, &ScanParams) == LORATRANSCEIVERITF_RESULT_SUCCESS);
+  pSX1276->m_dwCurrentState = SX1276_AUTOMATON_STATE_RECEIVING;
+  CSX1276_scanHop(pSX1276);
+
+  while (g_qwTestClock < GATEWAY_CLOCK_MS_TO_US(1000) + TEST_DURATION)
+  {
+    // 'CadDone' IRQ at end of CAD
+    g_qwTestClock = pSX1276->m_Scanner.m_qwHopStart + TEST_HOP_TIME +
+                    pSX1276->m_Scanner.m_Channels[pSX1276->m_Scanner.m_usCurrent].m_dwCadTime;
+    pSX1276->m_qwIrqTimestamp = g_qwTestClock;
+    bLocked = CSX1276_ProcessAutomatonNotifyCadDone(pSX1276);
+
+    // RX lock: 'RxDone' IRQ at end of packet or lock timeout
+    pPacket = &(Air.m_Packets[Air.m_usCadPair]);
+    while (bLocked)
+    {
+      if (Air.m_bCadSync && (pPacket->m_qwEnd <= pSX1276->m_Scanner.m_qwLockDeadline))
+      {
+        g_qwTestClock = pPacket->m_qwEnd;
+        pPacket->m_bCaptured = true;
+        CSX1276_scanPacketReceived(pSX1276, true);
+        break;
+      }
+
+      g_qwTestClock = pSX1276->m_Scanner.m_qwLockDeadline;
+      pMockSpi->m_usRegisters[REG_MODEM_STAT] = Air.m_bCadSync ? 0x0B : 0x00;
+      bLocked = !CSX1276_ProcessAutomatonScanTimeout(pSX1276);
+    }
+  }
+
+  pSX1276->m_dwCurrentState = SX1276_AUTOMATON_STATE_STANDBY;
+  CSX1276_stopScan(pSX1276);
+  CSX1276MockSpi_SetCadActivity(pMockSpi, NULL, NULL);
+  Test_UpdateAir(&Air, g_qwTestClock);
+
+  for (BYTE p = 0; p < pMix->m_usPairNumber; p++)
+  {
+    dwOfferedNumber += Air.m_dwOfferedNumber[p];
+    dwCapturedNumber += Air.m_dwCapturedNumber[p];
+    dwCadNumber += Statistics[p].m_dwCadNumber;
+    dwDetectedNumber += Statistics[p].m_dwDetectedNumber;
+    dwReceivedNumber += Statistics[p].m_dwReceivedNumber;
+    dwFalseNumber += Statistics[p].m_dwFalseDetectedNumber;
+  }
+
+  // Statistics of scanner versus simulated traffic
+  // Note: The last CAD or lock may be in progress at end of run
+  HOSTTEST_CHECK(dwOfferedNumber > 0);
+  HOSTTEST_CHECK(dwCadNumber == Air.m_dwCadNumber);
+  HOSTTEST_CHECK((dwDetectedNumber - dwReceivedNumber - dwFalseNumber) <= 1);
+  HOSTTEST_CHECK((dwReceivedNumber - dwCapturedNumber) <= 1);
+  HOSTTEST_CHECK(dwFalseNumber >= Air.m_dwFalseCadNumber - 1);
+
+  *pdwFixedCapture = (Air.m_dwOfferedNumber[0] * 1000) / dwOfferedNumber;
+  return (dwCapturedNumber * 1000) / dwOfferedNumber;
+}
+
+
+/*********************************************************************************************
+  Test
+*********************************************************************************************/
+
+static void Test_Sx1276CadScan(void)
+{
+  CSX1276 *pSX1276;
+  CSX1276MockSpi pMockSpi;
+  DWORD dwFixedCapture;
+  DWORD dwUniformCapture;
+  DWORD dwAdaptiveCapture;
+  DWORD dwLoad;
+
+  HOSTTEST_CHECK((pMockSpi = CSX1276MockSpi_New(0, 0)) != NULL);
+  HOSTTEST_CHECK((pSX1276 = CSX1276_New()) != NULL);
+  if ((pMockSpi == NULL) || (pSX1276 == NULL))
+  {
+    return;
+  }
+
+  // Automaton task of CSX1276 terminated (i.e. scanner timeouts processed by harness only)
+  pSX1276->m_dwCurrentState = SX1276_AUTOMATON_STATE_TERMINATED;
+  vTaskDelay(2 * pdMS_TO_TICKS(SX1276_SCAN_MAX_WAIT));
+
+  CSX1276_SetSpiBackend(pSX1276, &g_SX1276MockSpiBackendOb, (spi_device_handle_t) pMockSpi);
+  pMockSpi->m_usRegisters[REG_OP_MODE] = LORA_STANDBY_MODE;
+  pSX1276->m_usBandwidth = LORATRANSCEIVERITF_BANDWIDTH_125;
+  pSX1276->m_wPreambleLength = TEST_PREAMBLE_SYMBOLS;
+
+  printf("[INFO] Capture rate (virtual time: %u s, preamble: %u symbols, false CAD: %u per mille)\n",
+         (unsigned int) (TEST_DURATION / 1000000), TEST_PREAMBLE_SYMBOLS, TEST_FALSE_CAD);
+  printf("[INFO] %-20s %6s %7s %8s %8s\n", "mix", "load", "fixed", "uniform", "adaptive");
+
+  for (BYTE m = 0; m < TEST_MIX_NUMBER; m++)
+  {
+    dwUniformCapture = Test_RunScanner(pSX1276, pMockSpi, &g_TestMixes[m], false, &dwFixedCapture);
+    dwLoad = pSX1276->m_Scanner.m_dwLoad;
+    dwAdaptiveCapture = Test_RunScanner(pSX1276, pMockSpi, &g_TestMixes[m], true, &dwFixedCapture);
+
+    printf("[INFO] %-20s %6u %6u%% %7u%% %7u%%\n", g_TestMixes[m].m_pszName, (unsigned int) dwLoad,
+           (unsigned int) (dwFixedCapture / 10), (unsigned int) (dwUniformCapture / 10),
+           (unsigned int) (dwAdaptiveCapture / 10));
+
+    if (g_TestMixes[m].m_usPairNumber == 1)
+    {
+      // Within time budget: every preamble detected
+      HOSTTEST_CHECK(dwLoad <= 1000);
+      HOSTTEST_CHECK(dwUniformCapture >= TEST_MIN_SINGLE_CAPTURE);
+      HOSTTEST_CHECK(dwAdaptiveCapture >= TEST_MIN_SINGLE_CAPTURE);
+    }
+    else if (g_TestMixes[m].m_Pairs[0].m_dwRate == g_TestMixes[m].m_Pairs[1].m_dwRate)
+    {
+      // Spread traffic: scanning pays off
+      HOSTTEST_CHECK(dwUniformCapture > dwFixedCapture);
+      HOSTTEST_CHECK(dwAdaptiveCapture > dwFixedCapture);
+    }
+    else
+    {
+      // Skewed traffic: busy pair scanned more often
+      HOSTTEST_CHECK(dwAdaptiveCapture > dwUniformCapture);
+    }
+  }
+
+  CSX1276MockSpi_Delete(pMockSpi);
+}
+
+
+int main(void)
+{
+  return HostTest_Run("test_sx1276_cad_scan", Test_Sx1276CadScan);
+}
@@ -0,0 +1,225 @@
+/*****************************************************************************************//**
+ * @file     test_sx1276_irq_timestamp.c
+ *
+ * @author   F.Fargon
+ *
+ * @version  V1.0
+ *
+ * @date     16/10/2026
+ *
+ * @brief    Jitter of LoRa packet timestamps latched by the SX1276 ISR.
+ *
+ * @details  The 'CSX1276' automaton receives packets from the mock SX1276. The 'RX_DONE' IRQ
+ *           edges are simulated on the IRQ pin ('HostGpio_RaiseInterrupt') at known times,
+ *           while a load task competes with the automaton task:\n
+ *            - Timestamp of each packet latched between the IRQ edge and the return of the ISR
+ *              (i.e. not sampled later by the automaton task)
+ *            - Error of ISR timestamp versus delay of packet processing by the automaton task
+ *              (i.e. jitter of a timestamp sampled in task)
+ *            - Packets notified to owner object with intact payloads
+*********************************************************************************************/
+
+#include <Common.h>
+
+#include <math.h>
+
+#include "LoraTransceiverItf.h"
+#include "SX1276.h"
+#include "SX1276MockSpi.h"
+
+#include "HostTest.h"
+
+
+/*********************************************************************************************
+  Definitions
+*********************************************************************************************/
+
+// Arbiter of shared SPI bus (i.e. RX pending counter updated by ISR)
+extern CSX1276SpiBusOb g_SX1276SpiBusOb;
+
+// CS and IRQ pins of SX1276 devices
+extern const CSX1276DevicePinsOb g_SX1276DevicePins[SX1276_MAX_DEVICES];
+
+// Simulated SPI latencies (microseconds)
+#define TEST_TRANSFER_LATENCY    50
+#define TEST_WAKEUP_LATENCY      20
+
+// Number of packets (one IRQ each tick)
+#define TEST_PACKETS             200
+
+// Busy period of load task (microseconds)
+#define TEST_LOAD_PERIOD         500
+
+// Timing statistics (microseconds)
+typedef struct _TestJitter
+{
+  DWORD m_dwNumber;
+  QWORD m_qwSum;
+  QWORD m_qwSquareSum;
+  DWORD m_dwMin;
+  DWORD m_dwMax;
+} TestJitterOb;
+
+// Load task stopped by test function
+static volatile bool g_bTestLoadStop = false;
+
+
+/*********************************************************************************************
+  Helpers
+*********************************************************************************************/
+
+static void Test_AddSample(TestJitterOb *pJitter, DWORD dwValue)
+{
+  ++pJitter->m_dwNumber;
+  pJitter->m_qwSum += dwValue;
+  pJitter->m_qwSquareSum += (QWORD) dwValue * dwValue;
+  pJitter->m_dwMin = (dwValue < pJitter->m_dwMin) ? dwValue : pJitter->m_dwMin;
+  pJitter->m_dwMax = (dwValue > pJitter->m_dwMax) ? dwValue : pJitter->m_dwMax;
+}
+
+
+static void Test_PrintJitter(const char *pszName, TestJitterOb *pJitter)
+{
+  double dMean;
+  double dVariance;
+
+  if (pJitter->m_dwNumber == 0)
+  {
+    return;
+  }
+  dMean = (double) pJitter->m_qwSum / pJitter->m_dwNumber;
+  dVariance = ((double) pJitter->m_qwSquareSum / pJitter->m_dwNumber) - (dMean * dMean);
+
+  printf("[INFO] %-24s min: %6u us, mean: %8.1f us, max: %6u us, jitter (std dev): %8.1f us\n", pszName,
+         (unsigned int) pJitter->m_dwMin, dMean, (unsigned int) pJitter->m_dwMax, sqrt(dVariance > 0 ? dVariance : 0));
+}
+
+
+// Load task: busy periods competing with automaton task of CSX1276
+static void Test_LoadTask(void *pParams)
+{
+  SemaphoreHandle_t hDone = (SemaphoreHandle_t) pParams;
+  QWORD qwStart;
+
+  while (!g_bTestLoadStop)
+  {
+    qwStart = GATEWAY_CLOCK_MICROSEC();
+    while (GATEWAY_CLOCK_MICROSEC() - qwStart < TEST_LOAD_PERIOD)
+    {
+    }
+    taskYIELD();
+  }
+
+  xSemaphoreGive(hDone);
+  vTaskDelete(NULL);
+}
+
+
+/*********************************************************************************************
+  Test
+*********************************************************************************************/
+
+static void Test_Sx1276IrqTimestamp(void)
+{
+  CSX1276 *pSX1276;
+  CSX1276MockSpi pMockSpi;
+  QueueHandle_t hEventQueue;
+  SemaphoreHandle_t hLoadDone;
+  CLoraTransceiverItf_EventOb Event;
+  CLoraTransceiverItf_LoraPacket pPacket;
+  TestJitterOb IsrJitter = { 0, 0, 0, 0xFFFFFFFF, 0 };
+  TestJitterOb TaskJitter = { 0, 0, 0, 0xFFFFFFFF, 0 };
+  BYTE usPayload[LORA_MAX_PAYLOAD_LENGTH];
+  DWORD dwSeed = 0x1276;
+  DWORD dwLatchErrorNumber = 0;
+  DWORD dwPayloadErrorNumber = 0;
+  QWORD qwEdge;
+  QWORD qwIsrReturn;
+  QWORD qwProcessed;
+  QWORD qwTimestamp;
+  WORD wLength;
+
+  HOSTTEST_CHECK((pMockSpi = CSX1276MockSpi_New(TEST_TRANSFER_LATENCY, TEST_WAKEUP_LATENCY)) != NULL);
+  HOSTTEST_CHECK((pSX1276 = CSX1276_New()) != NULL);
+  HOSTTEST_CHECK((hEventQueue = xQueueCreate(4, sizeof(CLoraTransceiverItf_EventOb))) != NULL);
+  HOSTTEST_CHECK((hLoadDone = xSemaphoreCreateBinary()) != NULL);
+  if ((pMockSpi == NULL) || (pSX1276 == NULL) || (hEventQueue == NULL) || (hLoadDone == NULL))
+  {
+    return;
+  }
+
+  // SX1276 in 'RECEIVING' state, 'RX_DONE' IRQ on pin of first SX1276
+  CSX1276_SetSpiBackend(pSX1276, &g_SX1276MockSpiBackendOb, (spi_device_handle_t) pMockSpi);
+  pMockSpi->m_usRegisters[REG_OP_MODE] = LORA_RX_MODE;
+  pSX1276->m_hEventNotifyQueue = hEventQueue;
+  pSX1276->m_nPinIrq = g_SX1276DevicePins[0].m_nPinIrq;
+  pSX1276->m_dwCurrentState = SX1276_AUTOMATON_STATE_RECEIVING;
+  HOSTTEST_CHECK(gpio_isr_handler_add(pSX1276->m_nPinIrq, (gpio_isr_t) CSX1276_PacketRxTxIntHandler, pSX1276) == ESP_OK);
+  HOSTTEST_CHECK(gpio_intr_enable(pSX1276->m_nPinIrq) == ESP_OK);
+
+  HOSTTEST_CHECK(xTaskCreate(Test_LoadTask, "Load", HOSTTEST_TASK_STACK_SIZE, hLoadDone, HOSTTEST_TASK_PRIORITY,
+                             NULL) == pdPASS);
+
+  for (WORD i = 0; i < TEST_PACKETS; i++)
+  {
+    // Packet on air
+    vTaskDelay(1);
+    wLength = (WORD) (1 + (i * 29) % LORA_MAX_PAYLOAD_LENGTH);
+    HostTest_FillRandom(usPayload, wLength, &dwSeed);
+    CSX1276MockSpi_InjectPacket(pMockSpi, usPayload, (BYTE) wLength, 0x20, 0x40);
+
+    // 'RX_DONE' IRQ edge
+    qwEdge = GATEWAY_CLOCK_MICROSEC();
+    HostGpio_RaiseInterrupt(pSX1276->m_nPinIrq);
+    qwIsrReturn = GATEWAY_CLOCK_MICROSEC();
+
+    // Packet processed by automaton task (i.e. time of a timestamp sampled in task)
+    if (HOSTTEST_CHECK(xQueueReceive(hEventQueue, &Event, pdMS_TO_TICKS(1000)) == pdTRUE) == false)
+    {
+      break;
+    }
+    qwProcessed = GATEWAY_CLOCK_MICROSEC();
+    pPacket = (CLoraTransceiverItf_LoraPacket) Event.m_pEventData;
+
+    HOSTTEST_CHECK(Event.m_wEventType == LORATRANSCEIVERITF_EVENT_PACKETRECEIVED);
+    if ((pPacket->m_dwDataSize != wLength) || (memcmp(pPacket->m_usData, usPayload, wLength) != 0))
+    {
+      ++dwPayloadErrorNumber;
+    }
+
+    // Packet released by owner object (i.e. receive buffer of CSX1276 reused)
+    qwTimestamp = pPacket->m_qwTimestamp;
+    pPacket->m_dwDataSize = 0;
+
+    // Timestamp latched by ISR
+    if ((qwTimestamp < qwEdge) || (qwTimestamp > qwIsrReturn))
+    {
+      ++dwLatchErrorNumber;
+      continue;
+    }
+    Test_AddSample(&IsrJitter, (DWORD) (qwTimestamp - qwEdge));
+    Test_AddSample(&TaskJitter, (DWORD) (qwProcessed - qwEdge));
+  }
+
+  g_bTestLoadStop = true;
+  xSemaphoreTake(hLoadDone, portMAX_DELAY);
+  gpio_intr_disable(pSX1276->m_nPinIrq);
+  gpio_isr_handler_remove(pSX1276->m_nPinIrq);
+
+  HOSTTEST_CHECK(pSX1276->m_dwPacketReceivedNumber == TEST_PACKETS);
+  HOSTTEST_CHECK(dwPayloadErrorNumber == 0);
+  HOSTTEST_CHECK(dwLatchErrorNumber == 0);
+  HOSTTEST_CHECK(IsrJitter.m_dwMax <= TaskJitter.m_dwMin);
+  HOSTTEST_CHECK(g_SX1276SpiBusOb.m_dwRxPendingNumber == 0);
+
+  Test_PrintJitter("ISR timestamp error", &IsrJitter);
+  Test_PrintJitter("Task processing delay", &TaskJitter);
+
+  CSX1276MockSpi_Delete(pMockSpi);
+}
+
+
+int main(void)
+{
+  return HostTest_Run("test_sx1276_irq_timestamp", Test_Sx1276IrqTimestamp);
+}
@@ -0,0 +1,263 @@
+/*****************************************************************************************//**
+ * @file     test_sx1276_multiradio.c
+ *
+ * @author   F.Fargon
+ *
+ * @version  V1.0
+ *
+ * @date     16/10/2026
+ *
+ * @brief    Aggregate RX throughput of several SX1276 on the shared SPI bus.
+ *
+ * @details  Each radio is a 'CSX1276' object attached to its own mock SX1276, all mock devices
+ *           sharing one simulated SPI bus. A task per radio receives packets at a fixed airtime
+ *           (packet injected, ISR signalling simulated, packet read by 'CSX1276_getPacket'):\n
+ *            - Aggregate RX throughput for 1 to 'GATEWAY_MAX_LORATRANSCEIVERS' radios (i.e. the
+ *              SPI bus is not the bottleneck)
+ *            - Payloads intact on all radios (i.e. no crossed transactions on shared bus)
+ *            - Configuration traffic of a further radio deferred while a received packet is
+ *              pending (see 'CSX1276_busAcquire')
+*********************************************************************************************/
+
+#include <Common.h>
+
+#include "LoraTransceiverItf.h"
+#include "SX1276.h"
+#include "SX1276MockSpi.h"
+
+#include "HostTest.h"
+
+
+/*********************************************************************************************
+  Definitions
+*********************************************************************************************/
+
+// Arbiter of shared SPI bus (created by first 'Initialize' command on ESP32)
+extern CSX1276SpiBusOb g_SX1276SpiBusOb;
+
+// Simulated SPI latencies (microseconds)
+#define TEST_TRANSFER_LATENCY    50
+#define TEST_WAKEUP_LATENCY      20
+
+// Airtime of received packets (ticks) and number of packets for each radio
+#define TEST_AIRTIME             2
+#define TEST_PACKETS             40
+
+// Minimum aggregate throughput versus single radio throughput multiplied by radio number (percent)
+#define TEST_MIN_SCALING         75
+
+// Radio task
+typedef struct _TestRadio
+{
+  CSX1276 *m_pSX1276;
+  CSX1276MockSpi m_pMockSpi;
+  BYTE m_usIndex;
+  DWORD m_dwReceivedNumber;
+  DWORD m_dwCorruptedNumber;
+  SemaphoreHandle_t m_hDone;
+} TestRadioOb;
+
+// Radio with configuration traffic (i.e. not receiving)
+typedef struct _TestConfigRadio
+{
+  CSX1276 *m_pSX1276;
+  volatile bool m_bStop;
+  DWORD m_dwAccessNumber;
+  SemaphoreHandle_t m_hDone;
+} TestConfigRadioOb;
+
+
+/*********************************************************************************************
+  Helpers
+*********************************************************************************************/
+
+// Radio task: receives 'TEST_PACKETS' packets
+static void Test_RadioTask(void *pParams)
+{
+  TestRadioOb *pRadio = (TestRadioOb *) pParams;
+  CSX1276 *pSX1276 = pRadio->m_pSX1276;
+  BYTE usPayload[LORA_MAX_PAYLOAD_LENGTH];
+  DWORD dwSeed = 0x1000 + pRadio->m_usIndex;
+  WORD wLength;
+
+  for (WORD i = 0; i < TEST_PACKETS; i++)
+  {
+    // Packet on air
+    vTaskDelay(TEST_AIRTIME);
+    wLength = (WORD) (1 + ((i + pRadio->m_usIndex) * 61) % LORA_MAX_PAYLOAD_LENGTH);
+    HostTest_FillRandom(usPayload, wLength, &dwSeed);
+    CSX1276MockSpi_InjectPacket(pRadio->m_pMockSpi, usPayload, (BYTE) wLength, 0x20, 0x40);
+
+    // 'PACKET_RECEIVED' signalled by ISR (see 'CSX1276_PacketRxTxIntHandler')
+    __atomic_store_n(&(pSX1276->m_bRxPending), true, __ATOMIC_RELEASE);
+    __atomic_add_fetch(&(g_SX1276SpiBusOb.m_dwRxPendingNumber), 1, __ATOMIC_RELEASE);
+
+    // Packet read by automaton
+    pSX1276->m_pPacketReceived->m_dwDataSize = 0;
+    if ((CSX1276_getPacket(pSX1276) != LORATRANSCEIVERITF_RESULT_SUCCESS) ||
+        (pSX1276->m_pPacketReceived->m_dwDataSize != wLength) ||
+        (memcmp(pSX1276->m_pPacketReceived->m_usData, usPayload, wLength) != 0))
+    {
+      ++pRadio->m_dwCorruptedNumber;
+    }
+    ++pRadio->m_dwReceivedNumber;
+
+    __atomic_store_n(&(pSX1276->m_bRxPending), false, __ATOMIC_RELEASE);
+    __atomic_sub_fetch(&(g_SX1276SpiBusOb.m_dwRxPendingNumber), 1, __ATOMIC_RELEASE);
+  }
+
+  xSemaphoreGive(pRadio->m_hDone);
+  vTaskDelete(NULL);
+}
+
+
+// Configuration task: register accesses on SPI bus (i.e. register shadow invalidated) until
+// stopped
+static void Test_ConfigTask(void *pParams)
+{
+  TestConfigRadioOb *pConfigRadio = (TestConfigRadioOb *) pParams;
+
+  while (!pConfigRadio->m_bStop)
+  {
+    CSX1276_invalidateRegisters(pConfigRadio->m_pSX1276);
+    CSX1276_readRegister(pConfigRadio->m_pSX1276, REG_OP_MODE);
+    ++pConfigRadio->m_dwAccessNumber;
+    taskYIELD();
+  }
+
+  xSemaphoreGive(pConfigRadio->m_hDone);
+  vTaskDelete(NULL);
+}
+
+
+// Runs the radio tasks (and the configuration task) for the specified number of radios
+// Returns the aggregate throughput (packets per second)
+static DWORD Test_RunRadios(TestRadioOb *pRadios, BYTE usRadioNumber, TestConfigRadioOb *pConfigRadio)
+{
+  QWORD qwStart;
+  QWORD qwDuration;
+  DWORD dwCorruptedNumber = 0;
+  DWORD dwDeferredNumber;
+
+  pConfigRadio->m_bStop = false;
+  pConfigRadio->m_dwAccessNumber = 0;
+  dwDeferredNumber = pConfigRadio->m_pSX1276->m_dwSpiDeferredNumber;
+  HOSTTEST_CHECK(xTaskCreate(Test_ConfigTask, "ConfigRadio", HOSTTEST_TASK_STACK_SIZE, pConfigRadio,
+                             HOSTTEST_TASK_PRIORITY, NULL) == pdPASS);
+
+  qwStart = GATEWAY_CLOCK_MICROSEC();
+  for (BYTE r = 0; r < usRadioNumber; r++)
+  {
+    pRadios[r].m_dwReceivedNumber = 0;
+    pRadios[r].m_dwCorruptedNumber = 0;
+    HOSTTEST_CHECK(xTaskCreate(Test_RadioTask, "Radio", HOSTTEST_TASK_STACK_SIZE, &pRadios[r],
+                               HOSTTEST_TASK_PRIORITY + 1, NULL) == pdPASS);
+  }
+  for (BYTE r = 0; r < usRadioNumber; r++)
+  {
+    xSemaphoreTake(pRadios[r].m_hDone, portMAX_DELAY);
+  }
+  qwDuration = GATEWAY_CLOCK_MICROSEC() - qwStart;
+
+  pConfigRadio->m_bStop = true;
+  xSemaphoreTake(pConfigRadio->m_hDone, portMAX_DELAY);
+  dwDeferredNumber = pConfigRadio->m_pSX1276->m_dwSpiDeferredNumber - dwDeferredNumber;
+
+  for (BYTE r = 0; r < usRadioNumber; r++)
+  {
+    HOSTTEST_CHECK(pRadios[r].m_dwReceivedNumber == TEST_PACKETS);
+    dwCorruptedNumber += pRadios[r].m_dwCorruptedNumber;
+  }
+  HOSTTEST_CHECK(dwCorruptedNumber == 0);
+  HOSTTEST_CHECK(pConfigRadio->m_dwAccessNumber > 0);
+  HOSTTEST_CHECK(dwDeferredNumber > 0);
+  HOSTTEST_CHECK(g_SX1276SpiBusOb.m_dwRxPendingNumber == 0);
+
+  printf("[INFO] %u radios: %u packets/s, %u corrupted, %u configuration accesses (%u deferred)\n",
+         (unsigned int) usRadioNumber, (unsigned int) ((usRadioNumber * TEST_PACKETS * 1000000ULL) / qwDuration),
+         (unsigned int) dwCorruptedNumber, (unsigned int) pConfigRadio->m_dwAccessNumber,
+         (unsigned int) dwDeferredNumber);
+
+  return (DWORD) ((usRadioNumber * TEST_PACKETS * 1000000ULL) / qwDuration);
+}
+
+
+// New SX1276 attached to a new mock device (in 'STANDBY' mode)
+static CSX1276 *Test_NewRadio(CSX1276MockSpi *ppMockSpi)
+{
+  CSX1276 *pSX1276;
+
+  if ((*ppMockSpi = CSX1276MockSpi_New(TEST_TRANSFER_LATENCY, TEST_WAKEUP_LATENCY)) == NULL)
+  {
+    return NULL;
+  }
+  if ((pSX1276 = CSX1276_New()) == NULL)
+  {
+    return NULL;
+  }
+
+  CSX1276_SetSpiBackend(pSX1276, &g_SX1276MockSpiBackendOb, (spi_device_handle_t) *ppMockSpi);
+  (*ppMockSpi)->m_usRegisters[REG_OP_MODE] = LORA_STANDBY_MODE;
+  return pSX1276;
+}
+
+
+/*********************************************************************************************
+  Test
+*********************************************************************************************/
+
+static void Test_Sx1276MultiRadio(void)
+{
+  TestRadioOb Radios[GATEWAY_MAX_LORATRANSCEIVERS];
+  TestConfigRadioOb ConfigRadio;
+  CSX1276MockSpi pConfigMockSpi;
+  DWORD dwSingleThroughput = 0;
+  DWORD dwThroughput;
+
+  // Arbiter of shared SPI bus
+  HOSTTEST_CHECK((g_SX1276SpiBusOb.m_hMutex = xSemaphoreCreateMutex()) != NULL);
+  HOSTTEST_CHECK((ConfigRadio.m_hDone = xSemaphoreCreateBinary()) != NULL);
+  HOSTTEST_CHECK((ConfigRadio.m_pSX1276 = Test_NewRadio(&pConfigMockSpi)) != NULL);
+  if ((g_SX1276SpiBusOb.m_hMutex == NULL) || (ConfigRadio.m_hDone == NULL) || (ConfigRadio.m_pSX1276 == NULL))
+  {
+    return;
+  }
+
+  for (BYTE r = 0; r < GATEWAY_MAX_LORATRANSCEIVERS; r++)
+  {
+    Radios[r].m_usIndex = r;
+    HOSTTEST_CHECK((Radios[r].m_hDone = xSemaphoreCreateBinary()) != NULL);
+    HOSTTEST_CHECK((Radios[r].m_pSX1276 = Test_NewRadio(&(Radios[r].m_pMockSpi))) != NULL);
+    if ((Radios[r].m_hDone == NULL) || (Radios[r].m_pSX1276 == NULL))
+    {
+      return;
+    }
+  }
+
+  // Aggregate throughput proportional to radio number
+  for (BYTE n = 1; n <= GATEWAY_MAX_LORATRANSCEIVERS; n++)
+  {
+    dwThroughput = Test_RunRadios(Radios, n, &ConfigRadio);
+    if (n == 1)
+    {
+      dwSingleThroughput = dwThroughput;
+    }
+    else if (HOSTTEST_CHECK(dwThroughput * 100 >= dwSingleThroughput * n * TEST_MIN_SCALING) == false)
+    {
+      printf("[ERROR] %u radios: %u packets/s (single radio: %u packets/s)\n", (unsigned int) n,
+             (unsigned int) dwThroughput, (unsigned int) dwSingleThroughput);
+    }
+  }
+
+  for (BYTE r = 0; r < GATEWAY_MAX_LORATRANSCEIVERS; r++)
+  {
+    CSX1276MockSpi_Delete(Radios[r].m_pMockSpi);
+  }
+  CSX1276MockSpi_Delete(pConfigMockSpi);
+}
+
+
+int main(void)
+{
+  return HostTest_Run("test_sx1276_multiradio", Test_Sx1276MultiRadio);
+}
@@ -0,0 +1,236 @@
+/*****************************************************************************************//**
+ * @file     test_sx1276_pipeline.c
+ *
+ * @author   F.Fargon
+ *
+ * @version  V1.0
+ *
+ * @date     16/10/2026
+ *
+ * @brief    Pipelined SPI transactions of SX1276 RX completion and TX preload.
+ *
+ * @details  The 'CSX1276' object is attached to the mock SX1276 ('CSX1276MockSpi') with a
+ *           simulated transfer latency (i.e. queued transactions stay in flight):\n
+ *            - RX completion ('CSX1276_getPacket') is done in two batches (status registers,
+ *              then payload burst and flags)
+ *            - TX preload ('CSX1276_armSend') is done in one batch and the switch to TX mode
+ *              ('CSX1276_fireSend') in one transaction
+ *            - Pipeline depth of the batches (i.e. transactions queued before the first result
+ *              is collected), never above 'SX1276_SPI_QUEUE_SIZE'
+ *            - Duration of pipelined sequences versus the same transactions waited one by one
+*********************************************************************************************/
+
+#include <Common.h>
+
+#include "LoraTransceiverItf.h"
+#include "SX1276.h"
+#include "SX1276MockSpi.h"
+
+#include "HostTest.h"
+
+
+/*********************************************************************************************
+  Definitions
+*********************************************************************************************/
+
+// Simulated SPI latencies (microseconds)
+// Note: The transfer latency is long compared to queuing of a transaction (i.e. all transactions of
+//       a batch are in flight before the first one is executed)
+#define TEST_TRANSFER_LATENCY    200
+#define TEST_WAKEUP_LATENCY      50
+
+// Number of packets for each sequence
+#define TEST_PACKETS             20
+
+// Batches and transactions of RX completion
+//  - Batch 1: 'REG_IRQ_FLAGS', 'REG_RX_NB_BYTES', 'REG_PKT_SNR_VALUE', 'REG_PKT_RSSI_VALUE' and
+//             'REG_FIFO_ADDR_PTR' (5 transactions)
+//  - Batch 2: payload burst, 'REG_FIFO_ADDR_PTR' and 'REG_IRQ_FLAGS' (3 transactions)
+//  - 'REG_OP_MODE' known by register shadow (i.e. no read before clearing of flags)
+#define TEST_RX_BATCHES          2
+#define TEST_RX_DEPTH            5
+#define TEST_RX_TRANSACTIONS     8
+
+// Batch and transactions of TX preload
+//  - 'REG_FIFO_TX_BASE_ADDR', 'REG_FIFO_ADDR_PTR', payload burst, 'REG_PAYLOAD_LENGTH_LORA',
+//    'REG_IRQ_FLAGS' and 'REG_DIO_MAPPING1' (6 transactions)
+//  - Register shadow invalidated by the end of transmission, except 'REG_OP_MODE' (i.e. all
+//    registers written again, no read of mode)
+#define TEST_TX_BATCHES          1
+#define TEST_TX_DEPTH            6
+#define TEST_TX_TRANSACTIONS     6
+
+
+/*********************************************************************************************
+  Helpers
+*********************************************************************************************/
+
+// Statistics of one SX1276 sequence
+typedef struct _TestSequence
+{
+  DWORD m_dwBatchNumber;
+  DWORD m_dwTransactionNumber;
+  BYTE m_usDepth;
+  QWORD m_qwDuration;
+} TestSequenceOb;
+
+static void Test_SequenceStart(CSX1276 *pSX1276, CSX1276MockSpi pMockSpi, TestSequenceOb *pSequence)
+{
+  pSequence->m_dwBatchNumber = pSX1276->m_dwSpiBatchNumber;
+  pSequence->m_dwTransactionNumber = CSX1276MockSpi_GetTransactionNumber(pMockSpi);
+  pMockSpi->m_usMaxPipelineDepth = 0;
+  pSequence->m_qwDuration = GATEWAY_CLOCK_MICROSEC();
+}
+
+static void Test_SequenceEnd(CSX1276 *pSX1276, CSX1276MockSpi pMockSpi, TestSequenceOb *pSequence)
+{
+  pSequence->m_qwDuration = GATEWAY_CLOCK_MICROSEC() - pSequence->m_qwDuration;
+  pSequence->m_dwBatchNumber = pSX1276->m_dwSpiBatchNumber - pSequence->m_dwBatchNumber;
+  pSequence->m_dwTransactionNumber = CSX1276MockSpi_GetTransactionNumber(pMockSpi) - pSequence->m_dwTransactionNumber;
+  pSequence->m_usDepth = CSX1276MockSpi_GetMaxPipelineDepth(pMockSpi);
+}
+
+// Register shadow invalidated, 'REG_OP_MODE' read again (i.e. as after initialization)
+static void Test_InvalidateRegisters(CSX1276 *pSX1276)
+{
+  CSX1276_invalidateRegisters(pSX1276);
+  HOSTTEST_CHECK(CSX1276_readRegister(pSX1276, REG_OP_MODE) == LORA_STANDBY_MODE);
+}
+
+// Average duration of pipelined sequence versus simulated latencies
+//  - One by one: transfer and wakeup latencies for each transaction
+//  - Pipelined: transfer latency for each transaction, wakeup latency for each batch
+static void Test_PrintDuration(const char *pszSequence, DWORD dwBatchNumber, DWORD dwTransactionNumber, BYTE usDepth,
+                               QWORD qwDuration)
+{
+  printf("[INFO] %s: %u batches, %u transactions, depth %u, %u us (pipelined: %u us, one by one: %u us)\n",
+         pszSequence, (unsigned int) dwBatchNumber, (unsigned int) dwTransactionNumber, (unsigned int) usDepth,
+         (unsigned int) qwDuration,
+         (unsigned int) ((dwTransactionNumber * TEST_TRANSFER_LATENCY) + (dwBatchNumber * TEST_WAKEUP_LATENCY)),
+         (unsigned int) (dwTransactionNumber * (TEST_TRANSFER_LATENCY + TEST_WAKEUP_LATENCY)));
+}
+
+
+/*********************************************************************************************
+  Test
+*********************************************************************************************/
+
+static void Test_RxCompletion(CSX1276 *pSX1276, CSX1276MockSpi pMockSpi)
+{
+  TestSequenceOb Sequence;
+  BYTE usPayload[LORA_MAX_PAYLOAD_LENGTH];
+  DWORD dwSeed = 0x1276;
+  QWORD qwDuration = 0;
+  WORD wLength;
+
+  for (WORD i = 0; i < TEST_PACKETS; i++)
+  {
+    wLength = (WORD) (1 + (i * 37) % LORA_MAX_PAYLOAD_LENGTH);
+    HostTest_FillRandom(usPayload, wLength, &dwSeed);
+    CSX1276MockSpi_InjectPacket(pMockSpi, usPayload, (BYTE) wLength, 0x20, 0x40);
+    pSX1276->m_pPacketReceived->m_dwDataSize = 0;
+
+    Test_SequenceStart(pSX1276, pMockSpi, &Sequence);
+    HOSTTEST_CHECK(CSX1276_getPacket(pSX1276) == LORATRANSCEIVERITF_RESULT_SUCCESS);
+    Test_SequenceEnd(pSX1276, pMockSpi, &Sequence);
+    qwDuration += Sequence.m_qwDuration;
+
+    HOSTTEST_CHECK(pSX1276->m_pPacketReceived->m_dwDataSize == wLength);
+    HOSTTEST_CHECK(memcmp(pSX1276->m_pPacketReceived->m_usData, usPayload, wLength) == 0);
+    HOSTTEST_CHECK((pMockSpi->m_usRegisters[REG_IRQ_FLAGS] & 0x40) == 0);
+
+    HOSTTEST_CHECK(Sequence.m_dwBatchNumber == TEST_RX_BATCHES);
+    HOSTTEST_CHECK(Sequence.m_dwTransactionNumber == TEST_RX_TRANSACTIONS);
+    if (HOSTTEST_CHECK(Sequence.m_usDepth == TEST_RX_DEPTH) == false)
+    {
+      printf("[ERROR] RX completion of packet %u: %u batches, %u transactions, depth %u\n", (unsigned int) i,
+             (unsigned int) Sequence.m_dwBatchNumber, (unsigned int) Sequence.m_dwTransactionNumber,
+             (unsigned int) Sequence.m_usDepth);
+    }
+  }
+
+  Test_PrintDuration("RX completion", TEST_RX_BATCHES, TEST_RX_TRANSACTIONS, TEST_RX_DEPTH, qwDuration / TEST_PACKETS);
+}
+
+
+static void Test_TxPreload(CSX1276 *pSX1276, CSX1276MockSpi pMockSpi, CLoraPacket *pPacket)
+{
+  TestSequenceOb Sequence;
+  DWORD dwSeed = 0x5555;
+  QWORD qwDuration = 0;
+
+  for (WORD i = 0; i < TEST_PACKETS; i++)
+  {
+    pPacket->m_dwDataSize = (DWORD) (1 + (i * 53) % LORA_MAX_PAYLOAD_LENGTH);
+    HostTest_FillRandom(pPacket->m_usData, (WORD) pPacket->m_dwDataSize, &dwSeed);
+    memset(pMockSpi->m_usFifo, 0, sizeof(pMockSpi->m_usFifo));
+
+    Test_SequenceStart(pSX1276, pMockSpi, &Sequence);
+    HOSTTEST_CHECK(CSX1276_armSend(pSX1276, (CLoraTransceiverItf_LoraPacket) pPacket) == LORATRANSCEIVERITF_RESULT_SUCCESS);
+    Test_SequenceEnd(pSX1276, pMockSpi, &Sequence);
+    qwDuration += Sequence.m_qwDuration;
+
+    // Packet preloaded, not sent
+    HOSTTEST_CHECK(memcmp(pMockSpi->m_usFifo, pPacket->m_usData, pPacket->m_dwDataSize) == 0);
+    HOSTTEST_CHECK(pMockSpi->m_usRegisters[REG_PAYLOAD_LENGTH_LORA] == pPacket->m_dwDataSize);
+    HOSTTEST_CHECK(pMockSpi->m_usRegisters[REG_OP_MODE] == LORA_STANDBY_MODE);
+
+    HOSTTEST_CHECK(Sequence.m_dwBatchNumber == TEST_TX_BATCHES);
+    HOSTTEST_CHECK(Sequence.m_dwTransactionNumber == TEST_TX_TRANSACTIONS);
+    if (HOSTTEST_CHECK(Sequence.m_usDepth == TEST_TX_DEPTH) == false)
+    {
+      printf("[ERROR] TX preload of packet %u: %u batches, %u transactions, depth %u\n", (unsigned int) i,
+             (unsigned int) Sequence.m_dwBatchNumber, (unsigned int) Sequence.m_dwTransactionNumber,
+             (unsigned int) Sequence.m_usDepth);
+    }
+
+    // Switch to TX mode: one transaction, out of batch
+    Test_SequenceStart(pSX1276, pMockSpi, &Sequence);
+    HOSTTEST_CHECK(CSX1276_fireSend(pSX1276, 0) == true);
+    Test_SequenceEnd(pSX1276, pMockSpi, &Sequence);
+    HOSTTEST_CHECK(Sequence.m_dwBatchNumber == 0);
+    HOSTTEST_CHECK(Sequence.m_dwTransactionNumber == 1);
+    HOSTTEST_CHECK((pMockSpi->m_usRegisters[REG_IRQ_FLAGS] & 0x08) != 0);
+
+    // End of transmission (mock device back to 'STANDBY' mode)
+    CSX1276_writeRegister(pSX1276, REG_IRQ_FLAGS, 0xFF);
+    Test_InvalidateRegisters(pSX1276);
+  }
+
+  Test_PrintDuration("TX preload", TEST_TX_BATCHES, TEST_TX_TRANSACTIONS, TEST_TX_DEPTH, qwDuration / TEST_PACKETS);
+}
+
+
+static void Test_Sx1276Pipeline(void)
+{
+  CSX1276 *pSX1276;
+  CSX1276MockSpi pMockSpi;
+  CLoraPacket *pPacket;
+
+  HOSTTEST_CHECK((pMockSpi = CSX1276MockSpi_New(TEST_TRANSFER_LATENCY, TEST_WAKEUP_LATENCY)) != NULL);
+  HOSTTEST_CHECK((pSX1276 = CSX1276_New()) != NULL);
+  HOSTTEST_CHECK((pPacket = (CLoraPacket *) pvPortMalloc(sizeof(CLoraPacket))) != NULL);
+  if ((pMockSpi == NULL) || (pSX1276 == NULL) || (pPacket == NULL))
+  {
+    return;
+  }
+
+  CSX1276_SetSpiBackend(pSX1276, &g_SX1276MockSpiBackendOb, (spi_device_handle_t) pMockSpi);
+  pMockSpi->m_usRegisters[REG_OP_MODE] = LORA_STANDBY_MODE;
+
+  Test_InvalidateRegisters(pSX1276);
+  Test_RxCompletion(pSX1276, pMockSpi);
+  Test_InvalidateRegisters(pSX1276);
+  Test_TxPreload(pSX1276, pMockSpi, pPacket);
+
+  HOSTTEST_CHECK(CSX1276MockSpi_GetMaxPipelineDepth(pMockSpi) <= SX1276_SPI_QUEUE_SIZE);
+
+  vPortFree(pPacket);
+  CSX1276MockSpi_Delete(pMockSpi);
+}
+
+
+int main(void)
+{
+  return HostTest_Run("test_sx1276_pipeline", Test_Sx1276Pipeline);
+}
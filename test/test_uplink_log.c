@@ -0,0 +1,398 @@
+/*****************************************************************************************//**
+ * @file     test_uplink_log.c
+ *
+ * @author   F.Fargon
+ *
+ * @version  V1.0
+ *
+ * @date     16/10/2026
+ *
+ * @brief    Store-and-forward 'CUplinkLog' on the file backend.
+ *
+ * @details  The test uses a log file created with 'CUplinkLog_InitFileBackend' in the test
+ *           directory:\n
+ *            - Append, peek and consume in FIFO order (records of variable length)
+ *            - Wrap-around when the log is full (oldest records dropped, newest kept)
+ *            - Recovery of pending records when the log is reopened (consumed records not
+ *              replayed, sequence continued)
+ *            - Corrupted record skipped by 'CUplinkLog_Peek' and interrupted append (erased
+ *              header) ignored on reopen
+ *            - Benchmark of sustained append and replay (peek and consume) throughput
+*********************************************************************************************/
+
+#include <Common.h>
+
+#include "UplinkLog.h"
+
+#include "HostTest.h"
+
+
+/*********************************************************************************************
+  Definitions
+*********************************************************************************************/
+
+// Log file (in test directory) and size (file backend sectors are 4 KB)
+#define TEST_LOG_FILE            "test_uplink_log.bin"
+#define TEST_LOG_SIZE            (4 * 4096)
+
+// Maximum record length (i.e. encoded PUSH_DATA message)
+#define TEST_MAX_RECORD_LENGTH   300
+
+// Benchmark (log size, record length and number of appended records)
+#define TEST_BENCH_LOG_SIZE      (64 * 4096)
+#define TEST_BENCH_RECORD_LENGTH 240
+#define TEST_BENCH_RECORDS       2000
+
+
+/*********************************************************************************************
+  Helpers
+*********************************************************************************************/
+
+// Builds the data of record 'dwIndex' (length and content depend on index)
+static WORD Test_BuildRecord(DWORD dwIndex, BYTE *pData)
+{
+  WORD wLength = (WORD) (1 + (dwIndex * 53) % TEST_MAX_RECORD_LENGTH);
+  DWORD dwSeed = dwIndex + 1;
+
+  HostTest_FillRandom(pData, wLength, &dwSeed);
+  return wLength;
+}
+
+// Checks that the oldest pending record is the record 'dwIndex' and consumes it
+static bool Test_ConsumeRecord(CUplinkLog pLog, DWORD dwIndex)
+{
+  BYTE Expected[TEST_MAX_RECORD_LENGTH];
+  BYTE Data[TEST_MAX_RECORD_LENGTH];
+  WORD wLength;
+
+  wLength = Test_BuildRecord(dwIndex, Expected);
+  if ((HOSTTEST_CHECK(CUplinkLog_Peek(pLog, Data, sizeof(Data)) == wLength) == false) ||
+      (HOSTTEST_CHECK(memcmp(Data, Expected, wLength) == 0) == false))
+  {
+    printf("[ERROR] Record %u not found at tail of log\n", (unsigned int) dwIndex);
+    return false;
+  }
+  CUplinkLog_Consume(pLog);
+  return true;
+}
+
+// Opens the log file (created with erased sectors if not existing)
+static CUplinkLog Test_OpenLog(const char *pszFileName, DWORD dwSize)
+{
+  CUplinkLogBackendOb Backend;
+  CUplinkLog pLog;
+
+  if (HOSTTEST_CHECK(CUplinkLog_InitFileBackend(&Backend, pszFileName, dwSize) == true) == false)
+  {
+    return NULL;
+  }
+  if (HOSTTEST_CHECK((pLog = CUplinkLog_New(&Backend)) != NULL) == false)
+  {
+    CUplinkLog_CloseFileBackend(&Backend);
+  }
+  return pLog;
+}
+
+// Closes the log file (i.e. same as gateway stop or reboot)
+static void Test_CloseLog(CUplinkLog pLog)
+{
+  CUplinkLog_CloseFileBackend(&pLog->m_Backend);
+  CUplinkLog_Delete(pLog);
+}
+
+// Overwrites bytes of the log file (i.e. corruption or interrupted write)
+static void Test_WriteFile(DWORD dwOffset, const void *pData, DWORD dwLength)
+{
+  FILE *pFile;
+
+  if (HOSTTEST_CHECK((pFile = fopen(TEST_LOG_FILE, "r+b")) != NULL) == true)
+  {
+    HOSTTEST_CHECK(fseek(pFile, dwOffset, SEEK_SET) == 0);
+    HOSTTEST_CHECK(fwrite(pData, 1, dwLength, pFile) == dwLength);
+    fclose(pFile);
+  }
+}
+
+
+/*********************************************************************************************
+  Test
+*********************************************************************************************/
+
+static void Test_Append(void)
+{
+  BYTE Data[TEST_MAX_RECORD_LENGTH];
+  CUplinkLog pLog;
+  DWORD dwIndex;
+
+  remove(TEST_LOG_FILE);
+  if ((pLog = Test_OpenLog(TEST_LOG_FILE, TEST_LOG_SIZE)) == NULL)
+  {
+    return;
+  }
+  HOSTTEST_CHECK(CUplinkLog_GetRecordNumber(pLog) == 0);
+  HOSTTEST_CHECK(CUplinkLog_Peek(pLog, Data, sizeof(Data)) == 0);
+
+  // Records larger than a sector are rejected
+  HOSTTEST_CHECK(CUplinkLog_Append(pLog, Data, (WORD) pLog->m_Backend.m_dwSectorSize) == false);
+
+  // FIFO order, interleaved append and consume (records straddling end of sectors moved to next sector)
+  for (dwIndex = 0; dwIndex < 20; dwIndex++)
+  {
+    HOSTTEST_CHECK(CUplinkLog_Append(pLog, Data, Test_BuildRecord(dwIndex, Data)) == true);
+  }
+  for (dwIndex = 0; dwIndex < 10; dwIndex++)
+  {
+    Test_ConsumeRecord(pLog, dwIndex);
+  }
+  for (dwIndex = 20; dwIndex < 40; dwIndex++)
+  {
+    HOSTTEST_CHECK(CUplinkLog_Append(pLog, Data, Test_BuildRecord(dwIndex, Data)) == true);
+  }
+  HOSTTEST_CHECK(CUplinkLog_GetRecordNumber(pLog) == 30);
+  for (dwIndex = 10; dwIndex < 40; dwIndex++)
+  {
+    Test_ConsumeRecord(pLog, dwIndex);
+  }
+
+  HOSTTEST_CHECK(CUplinkLog_GetRecordNumber(pLog) == 0);
+  HOSTTEST_CHECK(CUplinkLog_GetDroppedNumber(pLog) == 0);
+  HOSTTEST_CHECK(CUplinkLog_Peek(pLog, Data, sizeof(Data)) == 0);
+
+  Test_CloseLog(pLog);
+}
+
+
+static void Test_WrapAround(void)
+{
+  BYTE Data[TEST_MAX_RECORD_LENGTH];
+  CUplinkLog pLog;
+  DWORD dwRecordNumber;
+  DWORD dwIndex;
+
+  remove(TEST_LOG_FILE);
+  if ((pLog = Test_OpenLog(TEST_LOG_FILE, TEST_LOG_SIZE)) == NULL)
+  {
+    return;
+  }
+
+  // About three times the capacity of the log (i.e. several turns of the sector ring)
+  for (dwIndex = 0; dwIndex < 300; dwIndex++)
+  {
+    HOSTTEST_CHECK(CUplinkLog_Append(pLog, Data, Test_BuildRecord(dwIndex, Data)) == true);
+    HOSTTEST_CHECK(CUplinkLog_GetRecordNumber(pLog) + CUplinkLog_GetDroppedNumber(pLog) == dwIndex + 1);
+  }
+
+  // The oldest records are dropped, the kept records are the newest ones (at least the sectors not
+  // being erased by the head)
+  dwRecordNumber = CUplinkLog_GetRecordNumber(pLog);
+  HOSTTEST_CHECK(CUplinkLog_GetDroppedNumber(pLog) > 0);
+  HOSTTEST_CHECK(dwRecordNumber * (sizeof(CUplinkLogRecordHeaderOb) + TEST_MAX_RECORD_LENGTH) >
+                 TEST_LOG_SIZE - 2 * pLog->m_Backend.m_dwSectorSize);
+
+  printf("[INFO] Wrap-around: %u records appended, %u pending, %u dropped\n", (unsigned int) dwIndex,
+         (unsigned int) dwRecordNumber, (unsigned int) CUplinkLog_GetDroppedNumber(pLog));
+
+  for (dwIndex = 300 - dwRecordNumber; dwIndex < 300; dwIndex++)
+  {
+    if (Test_ConsumeRecord(pLog, dwIndex) == false)
+    {
+      break;
+    }
+  }
+  HOSTTEST_CHECK(CUplinkLog_GetRecordNumber(pLog) == 0);
+
+  Test_CloseLog(pLog);
+}
+
+
+static void Test_Reopen(void)
+{
+  BYTE Data[TEST_MAX_RECORD_LENGTH];
+  CUplinkLogRecordHeaderOb Header;
+  CUplinkLog pLog;
+  DWORD dwOffset;
+  DWORD dwIndex;
+
+  remove(TEST_LOG_FILE);
+  if ((pLog = Test_OpenLog(TEST_LOG_FILE, TEST_LOG_SIZE)) == NULL)
+  {
+    return;
+  }
+
+  // Reopen after wrap of the log: consumed records are not replayed
+  for (dwIndex = 0; dwIndex < 200; dwIndex++)
+  {
+    CUplinkLog_Append(pLog, Data, Test_BuildRecord(dwIndex, Data));
+  }
+  for (dwIndex = 200 - CUplinkLog_GetRecordNumber(pLog); dwIndex < 180; dwIndex++)
+  {
+    Test_ConsumeRecord(pLog, dwIndex);
+  }
+  HOSTTEST_CHECK(CUplinkLog_GetRecordNumber(pLog) == 20);
+  Test_CloseLog(pLog);
+
+  if ((pLog = Test_OpenLog(TEST_LOG_FILE, TEST_LOG_SIZE)) == NULL)
+  {
+    return;
+  }
+  HOSTTEST_CHECK(CUplinkLog_GetRecordNumber(pLog) == 20);
+  HOSTTEST_CHECK(pLog->m_dwSequence == 200);
+  for (dwIndex = 180; dwIndex < 190; dwIndex++)
+  {
+    Test_ConsumeRecord(pLog, dwIndex);
+  }
+
+  // Records appended after reopen follow the recovered records
+  for (dwIndex = 200; dwIndex < 205; dwIndex++)
+  {
+    HOSTTEST_CHECK(CUplinkLog_Append(pLog, Data, Test_BuildRecord(dwIndex, Data)) == true);
+  }
+  Test_CloseLog(pLog);
+
+  if ((pLog = Test_OpenLog(TEST_LOG_FILE, TEST_LOG_SIZE)) == NULL)
+  {
+    return;
+  }
+  HOSTTEST_CHECK(CUplinkLog_GetRecordNumber(pLog) == 15);
+  for (dwIndex = 190; dwIndex < 205; dwIndex++)
+  {
+    Test_ConsumeRecord(pLog, dwIndex);
+  }
+  Test_CloseLog(pLog);
+
+  // Interrupted append (i.e. data written, header still erased): the record is ignored on reopen
+  remove(TEST_LOG_FILE);
+  if ((pLog = Test_OpenLog(TEST_LOG_FILE, TEST_LOG_SIZE)) == NULL)
+  {
+    return;
+  }
+  for (dwIndex = 0; dwIndex < 3; dwIndex++)
+  {
+    CUplinkLog_Append(pLog, Data, Test_BuildRecord(dwIndex, Data));
+  }
+  dwOffset = pLog->m_dwHeadOffset - UPLINKLOG_RECORD_SIZE(Test_BuildRecord(2, Data));
+  Test_CloseLog(pLog);
+
+  memset(&Header, 0xFF, sizeof(Header));
+  Test_WriteFile(dwOffset, &Header, sizeof(Header));
+
+  if ((pLog = Test_OpenLog(TEST_LOG_FILE, TEST_LOG_SIZE)) == NULL)
+  {
+    return;
+  }
+  HOSTTEST_CHECK(CUplinkLog_GetRecordNumber(pLog) == 2);
+  Test_ConsumeRecord(pLog, 0);
+  Test_ConsumeRecord(pLog, 1);
+  HOSTTEST_CHECK(CUplinkLog_Peek(pLog, Data, sizeof(Data)) == 0);
+  Test_CloseLog(pLog);
+}
+
+
+static void Test_CorruptRecord(void)
+{
+  BYTE Data[TEST_MAX_RECORD_LENGTH];
+  CUplinkLog pLog;
+  DWORD dwOffset;
+  DWORD dwIndex;
+
+  remove(TEST_LOG_FILE);
+  if ((pLog = Test_OpenLog(TEST_LOG_FILE, TEST_LOG_SIZE)) == NULL)
+  {
+    return;
+  }
+  for (dwIndex = 0; dwIndex < 5; dwIndex++)
+  {
+    CUplinkLog_Append(pLog, Data, Test_BuildRecord(dwIndex, Data));
+  }
+  Test_CloseLog(pLog);
+
+  // Data of record 2 modified (i.e. wrong CRC)
+  dwOffset = UPLINKLOG_RECORD_SIZE(Test_BuildRecord(0, Data)) + UPLINKLOG_RECORD_SIZE(Test_BuildRecord(1, Data));
+  Test_BuildRecord(2, Data);
+  Data[0] ^= 0x5A;
+  Test_WriteFile(dwOffset + sizeof(CUplinkLogRecordHeaderOb), Data, 1);
+
+  if ((pLog = Test_OpenLog(TEST_LOG_FILE, TEST_LOG_SIZE)) == NULL)
+  {
+    return;
+  }
+  Test_ConsumeRecord(pLog, 0);
+  Test_ConsumeRecord(pLog, 1);
+  Test_ConsumeRecord(pLog, 3);
+  Test_ConsumeRecord(pLog, 4);
+  HOSTTEST_CHECK(CUplinkLog_GetDroppedNumber(pLog) == 1);
+  HOSTTEST_CHECK(CUplinkLog_GetRecordNumber(pLog) == 0);
+
+  // Record larger than the reader buffer is also dropped
+  CUplinkLog_Append(pLog, Data, Test_BuildRecord(TEST_MAX_RECORD_LENGTH - 1, Data));
+  HOSTTEST_CHECK(CUplinkLog_Peek(pLog, Data, TEST_MAX_RECORD_LENGTH / 2) == 0);
+  HOSTTEST_CHECK(CUplinkLog_GetDroppedNumber(pLog) == 2);
+  Test_CloseLog(pLog);
+}
+
+
+static void Test_Benchmark(void)
+{
+  BYTE Data[TEST_BENCH_RECORD_LENGTH];
+  CUplinkLog pLog;
+  QWORD qwStart;
+  QWORD qwAppendDuration;
+  QWORD qwReplayDuration;
+  DWORD dwReplayNumber = 0;
+  DWORD dwSeed = 1;
+
+  remove(TEST_LOG_FILE);
+  if ((pLog = Test_OpenLog(TEST_LOG_FILE, TEST_BENCH_LOG_SIZE)) == NULL)
+  {
+    return;
+  }
+
+  // Sustained append (i.e. Network Server unreachable, log wraps and drops the oldest records)
+  qwStart = GATEWAY_CLOCK_MICROSEC();
+  for (DWORD i = 0; i < TEST_BENCH_RECORDS; i++)
+  {
+    HostTest_FillRandom(Data, sizeof(Data), &dwSeed);
+    HOSTTEST_CHECK(CUplinkLog_Append(pLog, Data, sizeof(Data)) == true);
+  }
+  qwAppendDuration = GATEWAY_CLOCK_MICROSEC() - qwStart;
+
+  // Replay of pending records (i.e. Network Server reachable again)
+  qwStart = GATEWAY_CLOCK_MICROSEC();
+  while (CUplinkLog_Peek(pLog, Data, sizeof(Data)) == sizeof(Data))
+  {
+    CUplinkLog_Consume(pLog);
+    ++dwReplayNumber;
+  }
+  qwReplayDuration = GATEWAY_CLOCK_MICROSEC() - qwStart;
+
+  HOSTTEST_CHECK(dwReplayNumber + CUplinkLog_GetDroppedNumber(pLog) == TEST_BENCH_RECORDS);
+  HOSTTEST_CHECK(CUplinkLog_GetRecordNumber(pLog) == 0);
+
+  printf("[INFO] Sustained append: %u records of %u bytes in %u us = %u records/s, %u KB/s\n",
+         TEST_BENCH_RECORDS, TEST_BENCH_RECORD_LENGTH, (unsigned int) qwAppendDuration,
+         (unsigned int) ((QWORD) TEST_BENCH_RECORDS * 1000000 / (qwAppendDuration > 0 ? qwAppendDuration : 1)),
+         (unsigned int) ((QWORD) TEST_BENCH_RECORDS * TEST_BENCH_RECORD_LENGTH * 1000000 / 1024 / (qwAppendDuration > 0 ? qwAppendDuration : 1)));
+  printf("[INFO] Replay: %u records in %u us = %u records/s (dropped when log full: %u)\n",
+         (unsigned int) dwReplayNumber, (unsigned int) qwReplayDuration,
+         (unsigned int) ((QWORD) dwReplayNumber * 1000000 / (qwReplayDuration > 0 ? qwReplayDuration : 1)),
+         (unsigned int) CUplinkLog_GetDroppedNumber(pLog));
+
+  Test_CloseLog(pLog);
+  remove(TEST_LOG_FILE);
+}
+
+
+static void Test_UplinkLog(void)
+{
+  Test_Append();
+  Test_WrapAround();
+  Test_Reopen();
+  Test_CorruptRecord();
+  Test_Benchmark();
+}
+
+
+int main(void)
+{
+  return HostTest_Run("test_uplink_log", Test_UplinkLog);
+}